@@ -20,6 +20,7 @@
 
 #include <commands/icd/ICDCommand.h>
 #include <controller/CHIPDeviceControllerFactory.h>
+#include <credentials/attestation_verifier/BundledAttestationTrustStore.h>
 #include <credentials/attestation_verifier/FileAttestationTrustStore.h>
 #include <credentials/attestation_verifier/TestDACRevocationDelegateImpl.h>
 #include <lib/core/CHIPConfig.h>
@@ -30,6 +31,7 @@
 #include <platform/LockTracker.h>
 
 #include <string>
+#include <sys/stat.h>
 
 #if CHIP_CONFIG_TRANSPORT_TRACE_ENABLED
 #include "TraceDecoder.h"
@@ -73,6 +75,22 @@ CHIP_ERROR GetAttestationTrustStore(const char * paaTrustStorePath, const chip::
         return CHIP_NO_ERROR;
     }
 
+    // A regular file is a PAA bundle generated by `chip-cert gen-paa-bundle`, which is much cheaper to load than a
+    // directory of individual certificates.
+    struct stat pathStat;
+    if (stat(paaTrustStorePath, &pathStat) == 0 && S_ISREG(pathStat.st_mode))
+    {
+        static chip::Credentials::BundledAttestationTrustStore bundledTrustStore{ paaTrustStorePath };
+        if (bundledTrustStore.paaCount() == 0)
+        {
+            ChipLogError(chipTool, "No PAAs found in bundle: %s", paaTrustStorePath);
+            return CHIP_ERROR_INVALID_ARGUMENT;
+        }
+
+        *trustStore = &bundledTrustStore;
+        return CHIP_NO_ERROR;
+    }
+
     static chip::Credentials::FileAttestationTrustStore attestationTrustStore{ paaTrustStorePath };
 
     if (paaTrustStorePath != nullptr && attestationTrustStore.paaCount() == 0)
@@ -158,6 +176,10 @@ CHIP_ERROR CHIPCommand::MaybeSetUpStack()
     factoryInitParams.listenPort = port;
     ReturnLogErrorOnFailure(DeviceControllerFactory::GetInstance().Init(factoryInitParams));
 
+    // Lets the commissioner derive PASE w0s/w1s off the Matter thread when CHIP_DEVICE_CONFIG_ENABLE_BG_EVENT_PROCESSING
+    // is set, does nothing otherwise. Stopped when the factory shuts the platform manager down.
+    ReturnLogErrorOnFailure(chip::DeviceLayer::PlatformMgr().StartBackgroundEventLoopTask());
+
     auto systemState = chip::Controller::DeviceControllerFactory::GetInstance().GetSystemState();
     VerifyOrReturnError(nullptr != systemState, CHIP_ERROR_INCORRECT_STATE);
 
@@ -70,8 +70,8 @@ public:
         Command(commandName, helpText), mCredIssuerCmds(credIssuerCmds)
     {
         AddArgument("paa-trust-store-path", &mPaaTrustStorePath,
-                    "Path to directory holding PAA certificate information.  Can be absolute or relative to the current working "
-                    "directory.");
+                    "Path to directory holding PAA certificate information, or to a PAA bundle file generated by "
+                    "`chip-cert gen-paa-bundle`.  Can be absolute or relative to the current working directory.");
         AddArgument("cd-trust-store-path", &mCDTrustStorePath,
                     "Path to directory holding CD certificate information.  Can be absolute or relative to the current working "
                     "directory.");
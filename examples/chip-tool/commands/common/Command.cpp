@@ -282,7 +282,8 @@ bool Command::InitArgument(size_t argIndex, char * argValue)
     }
 
     case ArgumentType::Vector16:
-    case ArgumentType::Vector32: {
+    case ArgumentType::Vector32:
+    case ArgumentType::Vector64: {
         std::vector<uint64_t> values;
         uint64_t min = chip::CanCastTo<uint64_t>(arg.min) ? static_cast<uint64_t>(arg.min) : 0;
         uint64_t max = arg.max;
@@ -319,6 +320,11 @@ bool Command::InitArgument(size_t argIndex, char * argValue)
                 vectorArgument->push_back(static_cast<uint32_t>(v));
             }
         }
+        else if (arg.type == ArgumentType::Vector64)
+        {
+            auto vectorArgument = static_cast<std::vector<uint64_t> *>(arg.value);
+            vectorArgument->insert(vectorArgument->end(), values.begin(), values.end());
+        }
         else if (arg.type == ArgumentType::Vector32 && arg.flags == Argument::kOptional)
         {
             std::vector<uint32_t> vectorArgument;
@@ -705,6 +711,20 @@ size_t Command::AddArgument(const char * name, int64_t min, uint64_t max, std::v
     return AddArgumentToList(std::move(arg));
 }
 
+size_t Command::AddArgument(const char * name, int64_t min, uint64_t max, std::vector<uint64_t> * value, const char * desc)
+{
+    Argument arg;
+    arg.type  = ArgumentType::Vector64;
+    arg.name  = name;
+    arg.value = static_cast<void *>(value);
+    arg.min   = min;
+    arg.max   = max;
+    arg.flags = 0;
+    arg.desc  = desc;
+
+    return AddArgumentToList(std::move(arg));
+}
+
 size_t Command::AddArgument(const char * name, int64_t min, uint64_t max, chip::Optional<std::vector<uint32_t>> * value,
                             const char * desc)
 {
@@ -988,6 +1008,11 @@ void Command::ResetArguments()
                 ResetOptionalArg<std::vector<uint32_t>>(arg);
                 break;
             }
+            case ArgumentType::Vector64: {
+                // No optional Vector64 arguments so far.
+                VerifyOrDie(false);
+                break;
+            }
             case ArgumentType::VectorCustom: {
                 // No optional VectorCustom arguments so far.
                 VerifyOrDie(false);
@@ -1069,6 +1094,11 @@ void Command::ResetArguments()
                 auto vectorArgument = static_cast<std::vector<uint32_t> *>(arg.value);
                 vectorArgument->clear();
             }
+            else if (type == ArgumentType::Vector64)
+            {
+                auto vectorArgument = static_cast<std::vector<uint64_t> *>(arg.value);
+                vectorArgument->clear();
+            }
             else if (type == ArgumentType::Custom)
             {
                 auto argument = static_cast<CustomArgument *>(arg.value);
@@ -434,6 +434,20 @@ void PairingCommand::OnCommissioningComplete(NodeId nodeId, CHIP_ERROR err)
     SetCommandExitStatus(err);
 }
 
+void PairingCommand::OnCommissioningStageLatencies(PeerId peerId, const CommissioningStageLatencies & latencies)
+{
+    ChipLogProgress(chipTool, "Commissioning stage latencies for " ChipLogFormatX64 " (total %" PRIu32 " ms):",
+                    ChipLogValueX64(peerId.GetNodeId()), latencies.total.count());
+    for (size_t i = 0; i < kCommissioningStageCount; i++)
+    {
+        if (latencies.stageDuration[i] != System::Clock::kZero)
+        {
+            auto stage = static_cast<CommissioningStage>(i);
+            ChipLogProgress(chipTool, "    %s: %" PRIu32 " ms", StageToString(stage), latencies.stageDuration[i].count());
+        }
+    }
+}
+
 void PairingCommand::OnReadCommissioningInfo(const Controller::ReadCommissioningInfo & info)
 {
     ChipLogProgress(AppServer, "OnReadCommissioningInfo - vendorId=0x%04X productId=0x%04X", info.basic.vendorId,
@@ -20,6 +20,7 @@
 
 #include "commands/common/Commands.h"
 #include "commands/session-management/CloseSessionCommand.h"
+#include "commands/session-management/EstablishSessionsCommand.h"
 
 void registerCommandsSessionManagement(Commands & commands, CredentialIssuerCommands * credsIssuerConfig)
 {
@@ -28,6 +29,7 @@ void registerCommandsSessionManagement(Commands & commands, CredentialIssuerComm
     commands_list clusterCommands = {
         make_unique<SendCloseSessionCommand>(credsIssuerConfig),
         make_unique<EvictLocalCASESessionsCommand>(credsIssuerConfig),
+        make_unique<EstablishSessionsCommand>(credsIssuerConfig),
     };
 
     commands.RegisterCommandSet(clusterName, clusterCommands, "Commands for managing CASE and PASE session state.");
@@ -0,0 +1,138 @@
+/*
+ *   Copyright (c) 2024 Project CHIP Authors
+ *   All rights reserved.
+ *
+ *   Licensed under the Apache License, Version 2.0 (the "License");
+ *   you may not use this file except in compliance with the License.
+ *   You may obtain a copy of the License at
+ *
+ *       http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *   Unless required by applicable law or agreed to in writing, software
+ *   distributed under the License is distributed on an "AS IS" BASIS,
+ *   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *   See the License for the specific language governing permissions and
+ *   limitations under the License.
+ *
+ */
+
+#include "EstablishSessionsCommand.h"
+
+#include <controller/CHIPDeviceControllerFactory.h>
+#include <lib/support/BufferReader.h>
+#include <lib/support/BufferWriter.h>
+#include <platform/CHIPDeviceLayer.h>
+
+using namespace chip;
+
+#ifdef CONFIG_USE_LOCAL_STORAGE
+namespace {
+
+// A node address, as IPv6 address bytes followed by the little-endian UDP port.
+constexpr uint16_t kStoredAddressSize = 16 + sizeof(uint16_t);
+
+void GetLastKnownAddressKey(const ScopedNodeId & peerId, char (&key)[64])
+{
+    snprintf(key, sizeof(key), "LastKnownAddress/%u/" ChipLogFormatX64, peerId.GetFabricIndex(),
+             ChipLogValueX64(peerId.GetNodeId()));
+}
+
+} // namespace
+
+Transport::PeerAddress EstablishSessionsCommand::LoadLastKnownAddress(const ScopedNodeId & peerId)
+{
+    char key[64];
+    GetLastKnownAddressKey(peerId, key);
+
+    uint8_t buffer[kStoredAddressSize];
+    uint16_t size = sizeof(buffer);
+    VerifyOrReturnValue(mDefaultStorage.SyncGetKeyValue(key, buffer, size) == CHIP_NO_ERROR && size == sizeof(buffer),
+                        Transport::PeerAddress());
+
+    const uint8_t * p = buffer;
+    Inet::IPAddress address;
+    Inet::IPAddress::ReadAddress(p, address);
+
+    uint16_t port;
+    Encoding::LittleEndian::Reader reader(p, sizeof(uint16_t));
+    VerifyOrReturnValue(reader.Read16(&port).IsSuccess(), Transport::PeerAddress());
+    return Transport::PeerAddress::UDP(address, port);
+}
+
+void EstablishSessionsCommand::StoreLastKnownAddress(const ScopedNodeId & peerId, const Transport::PeerAddress & address)
+{
+    // Link-local addresses are only usable along with their interface, whose id is not stable across runs.
+    VerifyOrReturn(address.GetTransportType() == Transport::Type::kUdp && !address.GetIPAddress().IsIPv6LinkLocal());
+
+    uint8_t buffer[kStoredAddressSize];
+    uint8_t * p = buffer;
+    address.GetIPAddress().WriteAddress(p);
+
+    Encoding::LittleEndian::BufferWriter writer(p, sizeof(uint16_t));
+    writer.Put16(address.GetPort());
+    VerifyOrReturn(writer.Fit());
+
+    char key[64];
+    GetLastKnownAddressKey(peerId, key);
+    CHIP_ERROR err = mDefaultStorage.SyncSetKeyValue(key, buffer, sizeof(buffer));
+    if (err != CHIP_NO_ERROR)
+    {
+        ChipLogError(chipTool, "Failed to store the address of " ChipLogFormatScopedNodeId ": %" CHIP_ERROR_FORMAT,
+                     ChipLogValueScopedNodeId(peerId), err.Format());
+    }
+}
+#endif // CONFIG_USE_LOCAL_STORAGE
+
+CHIP_ERROR EstablishSessionsCommand::RunCommand()
+{
+    VerifyOrReturnError(!mNodeIds.empty(), CHIP_ERROR_INVALID_ARGUMENT);
+
+    auto * sessionManager = Controller::DeviceControllerFactory::GetInstance().GetSystemState()->CASESessionMgr();
+    ReturnErrorOnFailure(mConnector.Init(sessionManager, &DeviceLayer::SystemLayer()));
+
+    // All nodes have the same priority, so they are connected in list order.
+    std::vector<CASESessionBulkConnector::Peer> peers(mNodeIds.size());
+    for (size_t i = 0; i < mNodeIds.size(); i++)
+    {
+        peers[i].peerId = CurrentCommissioner().GetPeerScopedId(mNodeIds[i]);
+#ifdef CONFIG_USE_LOCAL_STORAGE
+        // Nodes reached by an earlier run are primed from their last address instead of through DNS-SD.
+        peers[i].lastKnownAddress = LoadLastKnownAddress(peers[i].peerId);
+#endif // CONFIG_USE_LOCAL_STORAGE
+    }
+
+    CASESessionBulkConnector::Params params;
+    params.maxConcurrent  = mMaxConcurrent.ValueOr(params.maxConcurrent);
+    params.pacingInterval = System::Clock::Milliseconds32(mPacingIntervalMs.ValueOr(0));
+    params.primeAhead     = mPrimeAhead.ValueOr(params.primeAhead);
+
+    return mConnector.Start(Span<const CASESessionBulkConnector::Peer>(peers.data(), peers.size()), params, this);
+}
+
+void EstablishSessionsCommand::Shutdown()
+{
+    mConnector.Cancel();
+    CHIPCommand::Shutdown();
+}
+
+void EstablishSessionsCommand::OnPeerConnected(const ScopedNodeId & peerId, Messaging::ExchangeManager & exchangeMgr,
+                                               const SessionHandle & sessionHandle)
+{
+#ifdef CONFIG_USE_LOCAL_STORAGE
+    StoreLastKnownAddress(peerId, sessionHandle->AsSecureSession()->GetPeerAddress());
+#endif // CONFIG_USE_LOCAL_STORAGE
+}
+
+void EstablishSessionsCommand::OnPeerConnectionFailure(const ScopedNodeId & peerId, CHIP_ERROR error)
+{
+    ChipLogError(chipTool, "Failed to establish a session with " ChipLogFormatScopedNodeId ": %" CHIP_ERROR_FORMAT,
+                 ChipLogValueScopedNodeId(peerId), error.Format());
+}
+
+void EstablishSessionsCommand::OnBulkConnectComplete(size_t connectedCount, size_t failedCount,
+                                                     System::Clock::Milliseconds32 elapsed)
+{
+    ChipLogProgress(chipTool, "Established %u of %u sessions in %" PRIu32 " ms", static_cast<unsigned>(connectedCount),
+                    static_cast<unsigned>(connectedCount + failedCount), elapsed.count());
+    SetCommandExitStatus(failedCount == 0 ? CHIP_NO_ERROR : CHIP_ERROR_NOT_CONNECTED);
+}
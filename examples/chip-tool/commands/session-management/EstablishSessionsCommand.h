@@ -0,0 +1,72 @@
+/*
+ *   Copyright (c) 2024 Project CHIP Authors
+ *   All rights reserved.
+ *
+ *   Licensed under the Apache License, Version 2.0 (the "License");
+ *   you may not use this file except in compliance with the License.
+ *   You may obtain a copy of the License at
+ *
+ *       http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *   Unless required by applicable law or agreed to in writing, software
+ *   distributed under the License is distributed on an "AS IS" BASIS,
+ *   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *   See the License for the specific language governing permissions and
+ *   limitations under the License.
+ *
+ */
+
+#pragma once
+
+#include "../common/CHIPCommand.h"
+#include <app/CASESessionBulkConnector.h>
+
+#include <vector>
+
+class EstablishSessionsCommand : public CHIPCommand, public chip::CASESessionBulkConnector::Delegate
+{
+public:
+    EstablishSessionsCommand(CredentialIssuerCommands * credIssuerCommands) :
+        CHIPCommand("establish-sessions", credIssuerCommands,
+                    "Establishes CASE sessions with many nodes, a bounded number at a time, and reports how long it took.")
+    {
+        AddArgument("node-ids", 0, UINT64_MAX, &mNodeIds, "Comma-separated list of node ids, in the order to connect to them.");
+        AddArgument("max-concurrent", 1, CHIP_CONFIG_CASE_BULK_CONNECT_MAX_CONCURRENCY, &mMaxConcurrent,
+                    "Maximum number of session establishments in flight at once.");
+        AddArgument("pacing-interval-ms", 0, UINT32_MAX, &mPacingIntervalMs,
+                    "Minimum time, in milliseconds, between starting two session establishments. Defaults to 0.");
+        AddArgument("prime-ahead", 0, UINT8_MAX, &mPrimeAhead,
+                    "Number of upcoming nodes whose address is resolved ahead of their session establishment.");
+        AddArgument("timeout", 0, UINT16_MAX, &mTimeoutSecs,
+                    "Time, in seconds, before this command is considered to have timed out. Defaults to 60.");
+    }
+
+    /////////// CHIPCommand Interface /////////
+    CHIP_ERROR RunCommand() override;
+    chip::System::Clock::Timeout GetWaitDuration() const override
+    {
+        return chip::System::Clock::Seconds16(mTimeoutSecs.ValueOr(60));
+    }
+    void Shutdown() override;
+
+    /////////// CASESessionBulkConnector::Delegate Interface /////////
+    void OnPeerConnected(const chip::ScopedNodeId & peerId, chip::Messaging::ExchangeManager & exchangeMgr,
+                         const chip::SessionHandle & sessionHandle) override;
+    void OnPeerConnectionFailure(const chip::ScopedNodeId & peerId, CHIP_ERROR error) override;
+    void OnBulkConnectComplete(size_t connectedCount, size_t failedCount, chip::System::Clock::Milliseconds32 elapsed) override;
+
+private:
+#ifdef CONFIG_USE_LOCAL_STORAGE
+    // The address each node was last reached at is kept in the chip-tool storage for the next run.
+    chip::Transport::PeerAddress LoadLastKnownAddress(const chip::ScopedNodeId & peerId);
+    void StoreLastKnownAddress(const chip::ScopedNodeId & peerId, const chip::Transport::PeerAddress & address);
+#endif // CONFIG_USE_LOCAL_STORAGE
+
+    std::vector<uint64_t> mNodeIds;
+    chip::Optional<uint8_t> mMaxConcurrent;
+    chip::Optional<uint32_t> mPacingIntervalMs;
+    chip::Optional<uint8_t> mPrimeAhead;
+    chip::Optional<uint16_t> mTimeoutSecs;
+
+    chip::CASESessionBulkConnector mConnector;
+};
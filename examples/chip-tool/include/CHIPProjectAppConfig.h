@@ -64,4 +64,9 @@
 // Allow us, for test purposes, to encode invalid enum values.
 #define CHIP_CONFIG_IM_ENABLE_ENCODING_SENTINEL_ENUM_VALUES 1
 
+// establish-sessions resolves addresses of upcoming nodes while others are being connected: leave
+// room for the default concurrency and prime-ahead in the DNS-SD retry queue and the address cache.
+#define CHIP_CONFIG_MINMDNS_RETRY_QUEUE_SIZE 16
+#define CHIP_CONFIG_ADDRESS_RESOLVE_CACHE_SIZE 16
+
 #endif /* CHIPPROJECTCONFIG_H */
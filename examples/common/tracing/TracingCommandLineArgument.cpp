@@ -19,7 +19,10 @@
 
 #include <lib/support/StringSplitter.h>
 #include <lib/support/logging/CHIPLogging.h>
+#include <tracing/binary/binary_tracing.h>
 #include <tracing/json/json_tracing.h>
+#include <tracing/metrics/metrics_backend.h>
+#include <tracing/metrics/prometheus_exporter.h>
 #include <tracing/registry.h>
 
 #if ENABLE_PERFETTO_TRACING
@@ -74,6 +77,39 @@ void TracingSetup::EnableTracingFor(const char * cliArg)
             }
             chip::Tracing::Register(mJsonBackend);
         }
+        else if (StartsWith(value, "binary:"))
+        {
+            std::string fileName(value.data() + 7, value.size() - 7);
+
+            CHIP_ERROR err = mBinaryBackend.OpenFile(fileName.c_str());
+            if (err != CHIP_NO_ERROR)
+            {
+                ChipLogError(AppServer, "Failed to open binary trace output: %" CHIP_ERROR_FORMAT, err.Format());
+            }
+            chip::Tracing::Register(mBinaryBackend);
+        }
+        else if (StartsWith(value, "metrics:"))
+        {
+            std::string fileName(value.data() + 8, value.size() - 8);
+
+            CHIP_ERROR err = mMetricsExporter.StartFile(fileName.c_str());
+            if (err != CHIP_NO_ERROR)
+            {
+                ChipLogError(AppServer, "Failed to open metrics output: %" CHIP_ERROR_FORMAT, err.Format());
+            }
+            chip::Tracing::Register(mMetricsBackend);
+        }
+        else if (StartsWith(value, "metrics-socket:"))
+        {
+            std::string socketPath(value.data() + 15, value.size() - 15);
+
+            CHIP_ERROR err = mMetricsExporter.StartUnixSocket(socketPath.c_str());
+            if (err != CHIP_NO_ERROR)
+            {
+                ChipLogError(AppServer, "Failed to open metrics socket: %" CHIP_ERROR_FORMAT, err.Format());
+            }
+            chip::Tracing::Register(mMetricsBackend);
+        }
 #if ENABLE_PERFETTO_TRACING
         else if (value.data_equal(CharSpan::fromCharString("perfetto")))
         {
@@ -113,6 +149,9 @@ void TracingSetup::StopTracing()
 #endif
 
     chip::Tracing::Unregister(mJsonBackend);
+    chip::Tracing::Unregister(mBinaryBackend);
+    chip::Tracing::Unregister(mMetricsBackend);
+    mMetricsExporter.Stop();
 }
 
 } // namespace CommandLineApp
@@ -19,7 +19,10 @@
 
 #include "tracing/enabled_features.h"
 
+#include <tracing/binary/binary_tracing.h>
 #include <tracing/json/json_tracing.h>
+#include <tracing/metrics/metrics_backend.h>
+#include <tracing/metrics/prometheus_exporter.h>
 
 #if ENABLE_PERFETTO_TRACING
 #include <tracing/perfetto/file_output.h>      // nogncheck
@@ -29,9 +32,10 @@
 /// A string with supported command line tracing targets
 /// to be pretty-printed in help strings if needed
 #if ENABLE_PERFETTO_TRACING
-#define SUPPORTED_COMMAND_LINE_TRACING_TARGETS "json:log, json:<path>, perfetto, perfetto:<path>"
+#define SUPPORTED_COMMAND_LINE_TRACING_TARGETS                                                                                     \
+    "json:log, json:<path>, binary:<path>, metrics:<path>, metrics-socket:<path>, perfetto, perfetto:<path>"
 #else
-#define SUPPORTED_COMMAND_LINE_TRACING_TARGETS "json:log, json:<path>"
+#define SUPPORTED_COMMAND_LINE_TRACING_TARGETS "json:log, json:<path>, binary:<path>, metrics:<path>, metrics-socket:<path>"
 #endif
 
 namespace chip {
@@ -58,6 +62,9 @@ public:
 
 private:
     ::chip::Tracing::Json::JsonBackend mJsonBackend;
+    ::chip::Tracing::Binary::BinaryBackend mBinaryBackend;
+    ::chip::Tracing::Metrics::MetricsBackend mMetricsBackend;
+    ::chip::Tracing::Metrics::PrometheusExporter mMetricsExporter{ mMetricsBackend };
 
 #if ENABLE_PERFETTO_TRACING
     chip::Tracing::Perfetto::FileTraceOutput mPerfettoFileOutput;
@@ -50,11 +50,13 @@ constexpr uint16_t kOptionImageUri                  = 'i';
 constexpr uint16_t kOptionOtaImageList              = 'o';
 constexpr uint16_t kOptionDelayedApplyActionTimeSec = 'p';
 constexpr uint16_t kOptionQueryImageStatus          = 'q';
+constexpr uint16_t kOptionTransferRateLimit         = 'r';
 constexpr uint16_t kOptionDelayedQueryActionTimeSec = 't';
 constexpr uint16_t kOptionUserConsentState          = 'u';
 constexpr uint16_t kOptionIgnoreQueryImage          = 'x';
 constexpr uint16_t kOptionIgnoreApplyUpdate         = 'y';
 constexpr uint16_t kOptionPollInterval              = 'P';
+constexpr uint16_t kOptionTotalRateLimit            = 'R';
 
 OTAProviderExample gOtaProvider;
 chip::ota::DefaultOTAProviderUserConsent gUserConsentProvider;
@@ -72,6 +74,8 @@ static bool gUserConsentNeeded                       = false;
 static uint32_t gIgnoreQueryImageCount               = 0;
 static uint32_t gIgnoreApplyUpdateCount              = 0;
 static uint32_t gPollInterval                        = 0;
+static uint32_t gTransferRateLimit                   = 0;
+static uint32_t gTotalRateLimit                      = 0;
 
 // Parses the JSON filepath and extracts DeviceSoftwareVersionModel parameters
 static bool ParseJsonFileAndPopulateCandidates(const char * filepath,
@@ -245,6 +249,12 @@ bool HandleOptions(const char * aProgram, OptionSet * aOptions, int aIdentifier,
     case kOptionPollInterval:
         gPollInterval = static_cast<uint32_t>(strtoul(aValue, NULL, 0));
         break;
+    case kOptionTransferRateLimit:
+        gTransferRateLimit = static_cast<uint32_t>(strtoul(aValue, NULL, 0));
+        break;
+    case kOptionTotalRateLimit:
+        gTotalRateLimit = static_cast<uint32_t>(strtoul(aValue, NULL, 0));
+        break;
 
     default:
         PrintArgError("%s: INTERNAL ERROR: Unhandled option: %s\n", aProgram, aName);
@@ -268,6 +278,8 @@ OptionDef cmdLineOptionsDef[] = {
     { "ignoreQueryImage", chip::ArgParser::kArgumentRequired, kOptionIgnoreQueryImage },
     { "ignoreApplyUpdate", chip::ArgParser::kArgumentRequired, kOptionIgnoreApplyUpdate },
     { "pollInterval", chip::ArgParser::kArgumentRequired, kOptionPollInterval },
+    { "transferRateLimit", chip::ArgParser::kArgumentRequired, kOptionTransferRateLimit },
+    { "totalRateLimit", chip::ArgParser::kArgumentRequired, kOptionTotalRateLimit },
     {},
 };
 
@@ -308,7 +320,11 @@ OptionSet cmdLineOptions = { HandleOptions, cmdLineOptionsDef, "PROGRAM OPTIONS"
                              "  -y, --ignoreApplyUpdate <ignore count>\n"
                              "        The number of times to ignore the ApplyUpdateRequest Command and not send a response.\n"
                              "  -P, --pollInterval <time in milliseconds>\n"
-                             "        Poll interval for the BDX transfer \n" };
+                             "        Poll interval for the BDX transfer \n"
+                             "  -r, --transferRateLimit <bytes per second>\n"
+                             "        Maximum throughput of each BDX transfer. No limit by default.\n"
+                             "  -R, --totalRateLimit <bytes per second>\n"
+                             "        Maximum throughput of all concurrent BDX transfers together. No limit by default.\n" };
 
 OptionSet * allOptions[] = { &cmdLineOptions, nullptr };
 
@@ -318,6 +334,7 @@ void ApplicationInit()
 
     BdxOtaSender * bdxOtaSender = gOtaProvider.GetBdxOtaSender();
     VerifyOrReturn(bdxOtaSender != nullptr);
+    bdxOtaSender->SetRateLimits(gTotalRateLimit, gTransferRateLimit);
     err = chip::Server::GetInstance().GetExchangeManager().RegisterUnsolicitedMessageHandlerForProtocol(chip::Protocols::BDX::Id,
                                                                                                         bdxOtaSender);
     if (err != CHIP_NO_ERROR)
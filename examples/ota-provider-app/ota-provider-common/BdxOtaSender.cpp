@@ -23,45 +23,169 @@
 #include <messaging/ExchangeContext.h>
 #include <messaging/Flags.h>
 #include <protocols/bdx/BdxTransferSession.h>
+#include <transport/Session.h>
 
-#include <fstream>
+#include <algorithm>
+#include <chrono>
 
 using chip::bdx::StatusCode;
 using chip::bdx::TransferControlFlags;
 using chip::bdx::TransferSession;
+using chip::System::Clock::Timestamp;
 
 BdxOtaSender::BdxOtaSender()
 {
-    memset(mFileDesignator, 0, chip::bdx::kMaxFileDesignatorLen);
+    for (auto & transfer : mTransfers)
+    {
+        transfer.Init(this);
+    }
+}
+
+BdxOtaSender::~BdxOtaSender()
+{
+    if (mSystemLayer != nullptr)
+    {
+        mSystemLayer->CancelTimer(ServeBlocksTimerHandler, this);
+    }
 }
 
 CHIP_ERROR BdxOtaSender::InitializeTransfer(chip::FabricIndex fabricIndex, chip::NodeId nodeId)
 {
-    if (mInitialized)
+    Transfer * freeTransfer = nullptr;
+    for (auto & transfer : mTransfers)
     {
         // Reset stale connection from the Same Node if exists
-        if ((mFabricIndex.HasValue() && mFabricIndex.Value() == fabricIndex) && (mNodeId.HasValue() && mNodeId.Value() == nodeId))
+        if (transfer.IsFor(fabricIndex, nodeId))
         {
-            Reset();
+            transfer.Reset();
         }
-        // Prevent a new node connection since another is active
-        else if ((mFabricIndex.HasValue() && mFabricIndex.Value() != fabricIndex) ||
-                 (mNodeId.HasValue() && mNodeId.Value() != nodeId))
+
+        if (!transfer.IsInUse() && freeTransfer == nullptr)
         {
-            return CHIP_ERROR_BUSY;
+            freeTransfer = &transfer;
         }
-        else
+    }
+
+    // Prevent a new node connection when all transfers are active
+    VerifyOrReturnError(freeTransfer != nullptr, CHIP_ERROR_BUSY);
+
+    freeTransfer->Reserve(fabricIndex, nodeId);
+    mReservedTransfer = freeTransfer;
+    return CHIP_NO_ERROR;
+}
+
+CHIP_ERROR BdxOtaSender::PrepareForTransfer(chip::System::Layer * layer, chip::bdx::TransferRole role,
+                                            chip::BitFlags<TransferControlFlags> xferControlOpts, uint16_t maxBlockSize,
+                                            chip::System::Clock::Timeout timeout, chip::System::Clock::Timeout pollFreq)
+{
+    VerifyOrReturnError(mReservedTransfer != nullptr, CHIP_ERROR_INCORRECT_STATE);
+
+    Transfer * transfer = mReservedTransfer;
+    mReservedTransfer   = nullptr;
+    mSystemLayer        = layer;
+
+    CHIP_ERROR err = transfer->PrepareForTransfer(layer, role, xferControlOpts, maxBlockSize, timeout, pollFreq);
+    if (err != CHIP_NO_ERROR)
+    {
+        transfer->Reset();
+    }
+    return err;
+}
+
+CHIP_ERROR BdxOtaSender::OnUnsolicitedMessageReceived(const chip::PayloadHeader & payloadHeader,
+                                                      const chip::SessionHandle & session,
+                                                      chip::Messaging::ExchangeDelegate *& newDelegate)
+{
+    const chip::ScopedNodeId peer = session->GetPeer();
+    for (auto & transfer : mTransfers)
+    {
+        if (transfer.IsFor(peer.GetFabricIndex(), peer.GetNodeId()))
         {
-            return CHIP_ERROR_INTERNAL;
+            newDelegate = &transfer;
+            return CHIP_NO_ERROR;
         }
     }
-    mFabricIndex.SetValue(fabricIndex);
-    mNodeId.SetValue(nodeId);
-    mInitialized = true;
-    return CHIP_NO_ERROR;
+
+    ChipLogError(BDX, "No OTA transfer prepared for " ChipLogFormatScopedNodeId, ChipLogValueScopedNodeId(peer));
+    return CHIP_ERROR_INCORRECT_STATE;
+}
+
+void BdxOtaSender::ServeBlocks()
+{
+    VerifyOrReturn(mSystemLayer != nullptr);
+    mSystemLayer->CancelTimer(ServeBlocksTimerHandler, this);
+
+    const Timestamp now = chip::System::SystemClock().GetMonotonicTimestamp();
+    while (now >= mNextSendTime)
+    {
+        // Answer the oldest query whose transfer is not over its own limit, so that one slow transfer does not hold back
+        // the others.
+        Transfer * next = nullptr;
+        for (auto & transfer : mTransfers)
+        {
+            if (transfer.IsBlockRequested() && now >= transfer.mNextSendTime &&
+                (next == nullptr || transfer.mQuerySequence < next->mQuerySequence))
+            {
+                next = &transfer;
+            }
+        }
+        if (next == nullptr)
+        {
+            break;
+        }
+
+        size_t bytesSent = next->SendBlock();
+        Pace(mNextSendTime, mTotalBytesPerSecond, bytesSent, now);
+        Pace(next->mNextSendTime, mPerTransferBytesPerSecond, bytesSent, now);
+    }
+
+    // Come back when the next pending query may be answered
+    bool queriesPending = false;
+    Timestamp wakeUp    = chip::System::Clock::kZero;
+    for (auto & transfer : mTransfers)
+    {
+        if (transfer.IsBlockRequested())
+        {
+            Timestamp sendTime = std::max(transfer.mNextSendTime, mNextSendTime);
+            wakeUp             = queriesPending ? std::min(wakeUp, sendTime) : sendTime;
+            queriesPending     = true;
+        }
+    }
+
+    if (queriesPending)
+    {
+        chip::System::Clock::Milliseconds32 delay = chip::System::Clock::kZero;
+        if (wakeUp > now)
+        {
+            delay = std::chrono::duration_cast<chip::System::Clock::Milliseconds32>(wakeUp - now);
+        }
+        mSystemLayer->StartTimer(delay, ServeBlocksTimerHandler, this);
+    }
+}
+
+void BdxOtaSender::ServeBlocksTimerHandler(chip::System::Layer * systemLayer, void * appState)
+{
+    VerifyOrReturn(appState != nullptr);
+    static_cast<BdxOtaSender *>(appState)->ServeBlocks();
+}
+
+void BdxOtaSender::Pace(Timestamp & nextSendTime, uint32_t bytesPerSecond, size_t bytesSent, Timestamp now)
+{
+    VerifyOrReturn(bytesPerSecond > 0);
+
+    // Time it takes to send bytesSent at the given rate, rounded up
+    const uint64_t sendTimeMs = (static_cast<uint64_t>(bytesSent) * 1000 + bytesPerSecond - 1) / bytesPerSecond;
+    nextSendTime              = std::max(nextSendTime, now) + chip::System::Clock::Milliseconds64(sendTimeMs);
+}
+
+void BdxOtaSender::Transfer::Reserve(chip::FabricIndex fabricIndex, chip::NodeId nodeId)
+{
+    mFabricIndex = fabricIndex;
+    mNodeId      = nodeId;
+    mInUse       = true;
 }
 
-void BdxOtaSender::HandleTransferSessionOutput(TransferSession::OutputEvent & event)
+void BdxOtaSender::Transfer::HandleTransferSessionOutput(TransferSession::OutputEvent & event)
 {
     CHIP_ERROR err = CHIP_NO_ERROR;
 
@@ -103,17 +227,6 @@ void BdxOtaSender::HandleTransferSessionOutput(TransferSession::OutputEvent & ev
         break;
     }
     case TransferSession::OutputEventType::kInitReceived: {
-        // TransferSession will automatically reject a transfer if there are no
-        // common supported control modes. It will also default to the smaller
-        // block size.
-        TransferSession::TransferAcceptData acceptData;
-        acceptData.ControlMode  = TransferControlFlags::kReceiverDrive; // OTA must use receiver drive
-        acceptData.MaxBlockSize = mTransfer.GetTransferBlockSize();
-        acceptData.StartOffset  = mTransfer.GetStartOffset();
-        acceptData.Length       = mTransfer.GetTransferLength();
-        VerifyOrReturn(mTransfer.AcceptTransfer(acceptData) == CHIP_NO_ERROR,
-                       ChipLogError(BDX, "AcceptTransfer failed: %" CHIP_ERROR_FORMAT, err.Format()));
-
         // Store the file designator used during block query
         uint16_t fdl       = 0;
         const uint8_t * fd = mTransfer.GetFileDesignator(fdl);
@@ -122,60 +235,32 @@ void BdxOtaSender::HandleTransferSessionOutput(TransferSession::OutputEvent & ev
         memcpy(mFileDesignator, fd, fdl);
         mFileDesignator[fdl] = 0;
 
-        break;
-    }
-    case TransferSession::OutputEventType::kQueryReceived: {
-        TransferSession::BlockData blockData;
-        uint16_t blockSize   = mTransfer.GetTransferBlockSize();
-        uint16_t bytesToRead = blockSize;
-
-        // TODO: This should be a utility function in TransferSession
-        if (mTransfer.GetTransferLength() > 0 && mNumBytesSent + blockSize > mTransfer.GetTransferLength())
-        {
-            // cast should be safe because of condition above
-            bytesToRead = static_cast<uint16_t>(mTransfer.GetTransferLength() - mNumBytesSent);
-        }
-
-        chip::System::PacketBufferHandle blockBuf = chip::System::PacketBufferHandle::New(bytesToRead);
-        if (blockBuf.IsNull())
-        {
-            // TODO(#13981): AbortTransfer() needs to support GeneralStatusCode failures as well as BDX specific errors.
-            mTransfer.AbortTransfer(StatusCode::kUnknown);
-            return;
-        }
-
-        std::ifstream otaFile(mFileDesignator, std::ifstream::in);
-        if (!otaFile.good())
-        {
-            ChipLogError(BDX, "OTA file open failed");
-            mTransfer.AbortTransfer(StatusCode::kFileDesignatorUnknown);
-            return;
-        }
-
-        otaFile.seekg(mNumBytesSent);
-        otaFile.read(reinterpret_cast<char *>(blockBuf->Start()), bytesToRead);
-        if (!(otaFile.good() || otaFile.eof()))
+        err = OpenImage();
+        if (err != CHIP_NO_ERROR)
         {
-            ChipLogError(BDX, "OTA file read failed");
-            mTransfer.AbortTransfer(StatusCode::kFileDesignatorUnknown);
+            mTransfer.AbortTransfer(err == CHIP_ERROR_INVALID_ARGUMENT ? StatusCode::kStartOffsetNotSupported
+                                                                       : StatusCode::kFileDesignatorUnknown);
             return;
         }
 
-        blockData.Data   = blockBuf->Start();
-        blockData.Length = static_cast<size_t>(otaFile.gcount());
-        blockData.IsEof  = (blockData.Length < blockSize) ||
-            (mNumBytesSent + static_cast<uint64_t>(blockData.Length) == mTransfer.GetTransferLength() || (otaFile.peek() == EOF));
-        mNumBytesSent = static_cast<uint32_t>(mNumBytesSent + blockData.Length);
-        otaFile.close();
-
-        err = mTransfer.PrepareBlock(blockData);
-        if (err != CHIP_NO_ERROR)
-        {
-            ChipLogError(BDX, "PrepareBlock failed: %" CHIP_ERROR_FORMAT, err.Format());
-            mTransfer.AbortTransfer(StatusCode::kUnknown);
-        }
+        // TransferSession will automatically reject a transfer if there are no
+        // common supported control modes. It will also default to the smaller
+        // block size.
+        TransferSession::TransferAcceptData acceptData;
+        acceptData.ControlMode  = TransferControlFlags::kReceiverDrive; // OTA must use receiver drive
+        acceptData.MaxBlockSize = mTransfer.GetTransferBlockSize();
+        acceptData.StartOffset  = mTransfer.GetStartOffset();
+        acceptData.Length       = mTransfer.GetTransferLength();
+        err                     = mTransfer.AcceptTransfer(acceptData);
+        VerifyOrReturn(err == CHIP_NO_ERROR, ChipLogError(BDX, "AcceptTransfer failed: %" CHIP_ERROR_FORMAT, err.Format()));
         break;
     }
+    case TransferSession::OutputEventType::kQueryReceived:
+        // The block is sent once the rate limits allow it
+        mBlockRequested = true;
+        mQuerySequence  = mSender->mNextQuerySequence++;
+        mSender->ServeBlocks();
+        break;
     case TransferSession::OutputEventType::kAckReceived:
         break;
     case TransferSession::OutputEventType::kAckEOFReceived:
@@ -203,15 +288,61 @@ void BdxOtaSender::HandleTransferSessionOutput(TransferSession::OutputEvent & ev
     }
 }
 
+CHIP_ERROR BdxOtaSender::Transfer::OpenImage()
+{
+    ReturnErrorOnFailure(mSender->mImageCache.Acquire(mFileDesignator, mImage));
+
+    const uint64_t startOffset = mTransfer.GetStartOffset();
+    const uint64_t length      = mTransfer.GetTransferLength();
+    VerifyOrReturnError(startOffset <= mImage.size(), CHIP_ERROR_INVALID_ARGUMENT,
+                        ChipLogError(BDX, "Start offset 0x" ChipLogFormatX64 " is past the end of the image",
+                                     ChipLogValueX64(startOffset)));
+
+    // A length of 0 means the rest of the image
+    mNextOffset = startOffset;
+    mEndOffset  = mImage.size();
+    if (length > 0 && length < mEndOffset - startOffset)
+    {
+        mEndOffset = startOffset + length;
+    }
+    return CHIP_NO_ERROR;
+}
+
+size_t BdxOtaSender::Transfer::SendBlock()
+{
+    mBlockRequested = false;
+
+    // The block is encoded straight from the mapped image into the message buffer
+    const size_t blockSize = static_cast<size_t>(std::min<uint64_t>(mTransfer.GetTransferBlockSize(), mEndOffset - mNextOffset));
+    TransferSession::BlockData blockData;
+    blockData.Data   = mImage.data() + mNextOffset;
+    blockData.Length = blockSize;
+    blockData.IsEof  = (mNextOffset + blockSize == mEndOffset);
+
+    CHIP_ERROR err = mTransfer.PrepareBlock(blockData);
+    if (err != CHIP_NO_ERROR)
+    {
+        ChipLogError(BDX, "PrepareBlock failed: %" CHIP_ERROR_FORMAT, err.Format());
+        mTransfer.AbortTransfer(StatusCode::kUnknown);
+        return 0;
+    }
+
+    mNextOffset += blockSize;
+
+    // Blocks held back by the rate limits are not sent from a poll, so do not wait for the next one.
+    ScheduleImmediatePoll();
+    return blockSize;
+}
+
 /* Reset() calls bdx::TransferSession::Reset() which sets the output event type to
  * TransferSession::OutputEventType::kNone. So, bdx::TransferFacilitator::PollForOutput()
  * will call HandleTransferSessionOutput() with event TransferSession::OutputEventType::kNone.
  * Since we are ignoring kNone events so, it is okay HandleTransferSessionOutput() being called with event kNone
  */
-void BdxOtaSender::Reset()
+void BdxOtaSender::Transfer::Reset()
 {
-    mFabricIndex.ClearValue();
-    mNodeId.ClearValue();
+    mFabricIndex = chip::kUndefinedFabricIndex;
+    mNodeId      = chip::kUndefinedNodeId;
     Responder::ResetTransfer();
     if (mExchangeCtx != nullptr)
     {
@@ -219,7 +350,15 @@ void BdxOtaSender::Reset()
         mExchangeCtx = nullptr;
     }
 
-    mInitialized  = false;
-    mNumBytesSent = 0;
+    if (mImage.data() != nullptr)
+    {
+        mSender->mImageCache.Release(mImage);
+        mImage = chip::ByteSpan();
+    }
+
+    mInUse          = false;
+    mBlockRequested = false;
+    mNextOffset     = 0;
+    mEndOffset      = 0;
     memset(mFileDesignator, 0, chip::bdx::kMaxFileDesignatorLen);
 }
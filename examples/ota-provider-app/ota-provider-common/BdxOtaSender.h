@@ -15,33 +15,112 @@
  *    limitations under the License.
  */
 
+#include <messaging/ExchangeDelegate.h>
+#include <ota-provider-common/OTAImageCache.h>
 #include <protocols/bdx/BdxTransferSession.h>
 #include <protocols/bdx/TransferFacilitator.h>
+#include <system/SystemClock.h>
+#include <system/SystemLayer.h>
 
 #pragma once
 
-class BdxOtaSender : public chip::bdx::Responder
+/**
+ * Serves OTA images over BDX to several requestors at the same time.
+ *
+ * Each requestor gets its own transfer, and all transfers read their image from a shared OTAImageCache. Block queries
+ * are answered in the order they arrive, within optional limits on the throughput of all transfers together and of each
+ * transfer, so that one fast requestor cannot starve the others.
+ */
+class BdxOtaSender : public chip::Messaging::UnsolicitedMessageHandler
 {
 public:
+    static constexpr size_t kMaxConcurrentTransfers = 8;
+
     BdxOtaSender();
+    ~BdxOtaSender() override;
 
-    // Initializes BDX transfer-related metadata. Should always be called first.
+    // Reserves a transfer for the given requestor, replacing a stale transfer of the same requestor if there is one.
+    // Should always be called first. Returns CHIP_ERROR_BUSY when all transfers are in use.
     CHIP_ERROR InitializeTransfer(chip::FabricIndex fabricIndex, chip::NodeId nodeId);
 
+    // Prepares the transfer reserved by the last InitializeTransfer() call to accept the BDX request of its requestor.
+    // See bdx::Responder::PrepareForTransfer() for the arguments.
+    CHIP_ERROR PrepareForTransfer(chip::System::Layer * layer, chip::bdx::TransferRole role,
+                                  chip::BitFlags<chip::bdx::TransferControlFlags> xferControlOpts, uint16_t maxBlockSize,
+                                  chip::System::Clock::Timeout timeout, chip::System::Clock::Timeout pollFreq);
+
+    // Limits the throughput of all transfers together and of each single transfer, in bytes per second. 0 means no limit.
+    void SetRateLimits(uint32_t totalBytesPerSecond, uint32_t perTransferBytesPerSecond)
+    {
+        mTotalBytesPerSecond       = totalBytesPerSecond;
+        mPerTransferBytesPerSecond = perTransferBytesPerSecond;
+    }
+
 private:
-    // Inherited from bdx::TransferFacilitator
-    void HandleTransferSessionOutput(chip::bdx::TransferSession::OutputEvent & event) override;
+    class Transfer : public chip::bdx::Responder
+    {
+    public:
+        void Init(BdxOtaSender * sender) { mSender = sender; }
+
+        void Reserve(chip::FabricIndex fabricIndex, chip::NodeId nodeId);
+        void Reset();
+
+        bool IsInUse() const { return mInUse; }
+        bool IsFor(chip::FabricIndex fabricIndex, chip::NodeId nodeId) const
+        {
+            return mInUse && mFabricIndex == fabricIndex && mNodeId == nodeId;
+        }
+        bool IsBlockRequested() const { return mBlockRequested; }
+
+        // Sends the requested block and returns its size.
+        size_t SendBlock();
+
+        // Order in which the pending block queries arrived
+        uint64_t mQuerySequence = 0;
+
+        // Earliest time the next block may be sent within the per-transfer rate limit
+        chip::System::Clock::Timestamp mNextSendTime = chip::System::Clock::kZero;
+
+    private:
+        // Inherited from bdx::TransferFacilitator
+        void HandleTransferSessionOutput(chip::bdx::TransferSession::OutputEvent & event) override;
+
+        CHIP_ERROR OpenImage();
+
+        BdxOtaSender * mSender = nullptr;
+
+        // Null-terminated string representing file designator
+        char mFileDesignator[chip::bdx::kMaxFileDesignatorLen];
+
+        chip::ByteSpan mImage;
+        uint64_t mNextOffset = 0;
+        uint64_t mEndOffset  = 0;
+
+        bool mInUse          = false;
+        bool mBlockRequested = false;
 
-    void Reset();
+        chip::FabricIndex mFabricIndex = chip::kUndefinedFabricIndex;
+        chip::NodeId mNodeId           = chip::kUndefinedNodeId;
+    };
 
-    // Null-terminated string representing file designator
-    char mFileDesignator[chip::bdx::kMaxFileDesignatorLen];
+    //// UnsolicitedMessageHandler Implementation ////
+    CHIP_ERROR OnUnsolicitedMessageReceived(const chip::PayloadHeader & payloadHeader, const chip::SessionHandle & session,
+                                            chip::Messaging::ExchangeDelegate *& newDelegate) override;
 
-    uint32_t mNumBytesSent = 0;
+    // Answers the pending block queries that the rate limits allow, oldest first, and schedules the next round.
+    void ServeBlocks();
+    static void ServeBlocksTimerHandler(chip::System::Layer * systemLayer, void * appState);
 
-    bool mInitialized = false;
+    static void Pace(chip::System::Clock::Timestamp & nextSendTime, uint32_t bytesPerSecond, size_t bytesSent,
+                     chip::System::Clock::Timestamp now);
 
-    chip::Optional<chip::FabricIndex> mFabricIndex;
+    Transfer mTransfers[kMaxConcurrentTransfers];
+    Transfer * mReservedTransfer = nullptr;
+    OTAImageCache mImageCache;
 
-    chip::Optional<chip::NodeId> mNodeId;
+    chip::System::Layer * mSystemLayer           = nullptr;
+    uint64_t mNextQuerySequence                  = 0;
+    uint32_t mTotalBytesPerSecond                = 0;
+    uint32_t mPerTransferBytesPerSecond          = 0;
+    chip::System::Clock::Timestamp mNextSendTime = chip::System::Clock::kZero;
 };
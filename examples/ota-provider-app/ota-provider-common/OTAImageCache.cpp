@@ -0,0 +1,121 @@
+/*
+ *
+ *    Copyright (c) 2024 Project CHIP Authors
+ *
+ *    Licensed under the Apache License, Version 2.0 (the "License");
+ *    you may not use this file except in compliance with the License.
+ *    You may obtain a copy of the License at
+ *
+ *        http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *    Unless required by applicable law or agreed to in writing, software
+ *    distributed under the License is distributed on an "AS IS" BASIS,
+ *    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *    See the License for the specific language governing permissions and
+ *    limitations under the License.
+ */
+
+#include <ota-provider-common/OTAImageCache.h>
+
+#include <lib/support/CodeUtils.h>
+#include <lib/support/logging/CHIPLogging.h>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+OTAImageCache::~OTAImageCache()
+{
+    for (auto & entry : mEntries)
+    {
+        if (entry.IsInUse())
+        {
+            munmap(entry.data, entry.size);
+            entry = Entry();
+        }
+    }
+}
+
+CHIP_ERROR OTAImageCache::Acquire(const char * path, chip::ByteSpan & image)
+{
+    int fd = open(path, O_RDONLY | O_CLOEXEC);
+    VerifyOrReturnError(fd >= 0, CHIP_ERROR_OPEN_FAILED, ChipLogError(BDX, "Cannot open OTA image %s", path));
+
+    struct stat st;
+    if (fstat(fd, &st) != 0 || st.st_size <= 0)
+    {
+        close(fd);
+        ChipLogError(BDX, "OTA image %s is empty or cannot be read", path);
+        return CHIP_ERROR_READ_FAILED;
+    }
+
+    Entry * freeEntry = nullptr;
+    for (auto & entry : mEntries)
+    {
+        if (!entry.IsInUse())
+        {
+            freeEntry = (freeEntry == nullptr) ? &entry : freeEntry;
+            continue;
+        }
+
+        // The same path could name a different file by now, so compare the file itself.
+        if (entry.device != st.st_dev || entry.inode != st.st_ino)
+        {
+            continue;
+        }
+
+        if (entry.size != static_cast<size_t>(st.st_size) || entry.mtime.tv_sec != st.st_mtim.tv_sec ||
+            entry.mtime.tv_nsec != st.st_mtim.tv_nsec)
+        {
+            // Running transfers may already have sent a mix of the old and new contents.
+            close(fd);
+            ChipLogError(BDX, "OTA image %s was modified in place while being served, replace images with rename()", path);
+            return CHIP_ERROR_INCORRECT_STATE;
+        }
+
+        close(fd);
+        entry.refCount++;
+        image = chip::ByteSpan(static_cast<const uint8_t *>(entry.data), entry.size);
+        return CHIP_NO_ERROR;
+    }
+
+    if (freeEntry == nullptr)
+    {
+        close(fd);
+        return CHIP_ERROR_NO_MEMORY;
+    }
+
+    void * data = mmap(nullptr, static_cast<size_t>(st.st_size), PROT_READ, MAP_SHARED, fd, 0);
+    close(fd);
+    VerifyOrReturnError(data != MAP_FAILED, CHIP_ERROR_READ_FAILED, ChipLogError(BDX, "Cannot map OTA image %s", path));
+
+    // Each transfer reads its image front to back
+    madvise(data, static_cast<size_t>(st.st_size), MADV_SEQUENTIAL);
+
+    freeEntry->data     = data;
+    freeEntry->size     = static_cast<size_t>(st.st_size);
+    freeEntry->device   = st.st_dev;
+    freeEntry->inode    = st.st_ino;
+    freeEntry->mtime    = st.st_mtim;
+    freeEntry->refCount = 1;
+
+    image = chip::ByteSpan(static_cast<const uint8_t *>(data), freeEntry->size);
+    return CHIP_NO_ERROR;
+}
+
+void OTAImageCache::Release(const chip::ByteSpan & image)
+{
+    for (auto & entry : mEntries)
+    {
+        if (entry.IsInUse() && entry.data == image.data())
+        {
+            if (--entry.refCount == 0)
+            {
+                munmap(entry.data, entry.size);
+                entry = Entry();
+            }
+            return;
+        }
+    }
+}
@@ -0,0 +1,69 @@
+/*
+ *
+ *    Copyright (c) 2024 Project CHIP Authors
+ *
+ *    Licensed under the Apache License, Version 2.0 (the "License");
+ *    you may not use this file except in compliance with the License.
+ *    You may obtain a copy of the License at
+ *
+ *        http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *    Unless required by applicable law or agreed to in writing, software
+ *    distributed under the License is distributed on an "AS IS" BASIS,
+ *    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *    See the License for the specific language governing permissions and
+ *    limitations under the License.
+ */
+
+#pragma once
+
+#include <lib/core/CHIPError.h>
+#include <lib/support/Span.h>
+
+#include <sys/types.h>
+#include <time.h>
+
+/**
+ * Memory-maps OTA image files, so that concurrent transfers of the same image share a single read-only mapping and
+ * blocks are handed to the BDX layer straight from the page cache instead of being read into a buffer for every block.
+ *
+ * The mappings share the file's pages, so an image must never be modified in place while it is being served: writes
+ * would change the bytes under transfers that are running, and truncating the file makes reading the lost pages raise
+ * SIGBUS. Replace an image by writing the new one to a temporary file and rename()-ing it over the old path. New transfers
+ * then map the new file, while transfers that already started keep reading the old one until they release it.
+ *
+ * Acquire() refuses an image that was modified in place while a transfer still holds it.
+ */
+class OTAImageCache
+{
+public:
+    static constexpr size_t kMaxImages = 8;
+
+    ~OTAImageCache();
+
+    /**
+     * Map the image at `path`, or take another reference to it if it is already mapped. On success `image` covers the
+     * whole file and stays valid until it is passed to Release().
+     */
+    CHIP_ERROR Acquire(const char * path, chip::ByteSpan & image);
+
+    /**
+     * Drop a reference taken by Acquire(). The image is unmapped once its last reference is gone.
+     */
+    void Release(const chip::ByteSpan & image);
+
+private:
+    struct Entry
+    {
+        void * data     = nullptr;
+        size_t size     = 0;
+        dev_t device    = 0;
+        ino_t inode     = 0;
+        timespec mtime  = {};
+        size_t refCount = 0;
+
+        bool IsInUse() const { return data != nullptr; }
+    };
+
+    Entry mEntries[kMaxImages];
+};
@@ -0,0 +1,161 @@
+/*
+ *
+ *    Copyright (c) 2024 Project CHIP Authors
+ *    All rights reserved.
+ *
+ *    Licensed under the Apache License, Version 2.0 (the "License");
+ *    you may not use this file except in compliance with the License.
+ *    You may obtain a copy of the License at
+ *
+ *        http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *    Unless required by applicable law or agreed to in writing, software
+ *    distributed under the License is distributed on an "AS IS" BASIS,
+ *    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *    See the License for the specific language governing permissions and
+ *    limitations under the License.
+ */
+
+#include <pw_unit_test/framework.h>
+
+#include <lib/core/StringBuilderAdapters.h>
+#include <lib/support/Span.h>
+#include <ota-provider-common/OTAImageCache.h>
+
+#include <cstdio>
+#include <cstring>
+#include <unistd.h>
+
+using namespace chip;
+
+namespace {
+
+constexpr char kImagePath[]     = "/tmp/TestOTAImageCache.ota";
+constexpr char kImagePathTemp[] = "/tmp/TestOTAImageCache.ota.tmp";
+
+bool WriteFile(const char * path, const char * mode, const char * contents)
+{
+    FILE * file = fopen(path, mode);
+    if (file == nullptr)
+    {
+        return false;
+    }
+    bool written = fwrite(contents, 1, strlen(contents), file) == strlen(contents);
+    return (fclose(file) == 0) && written;
+}
+
+bool SpanEquals(const ByteSpan & span, const char * contents)
+{
+    return span.data_equal(ByteSpan(reinterpret_cast<const uint8_t *>(contents), strlen(contents)));
+}
+
+class TestOTAImageCache : public ::testing::Test
+{
+public:
+    void TearDown() override
+    {
+        unlink(kImagePath);
+        unlink(kImagePathTemp);
+    }
+};
+
+TEST_F(TestOTAImageCache, TestSharedMapping)
+{
+    ASSERT_TRUE(WriteFile(kImagePath, "w", "image one"));
+
+    OTAImageCache cache;
+    ByteSpan first;
+    ByteSpan second;
+    EXPECT_EQ(cache.Acquire(kImagePath, first), CHIP_NO_ERROR);
+    EXPECT_EQ(cache.Acquire(kImagePath, second), CHIP_NO_ERROR);
+
+    // Both transfers read from the same mapping.
+    EXPECT_TRUE(SpanEquals(first, "image one"));
+    EXPECT_EQ(first.data(), second.data());
+    EXPECT_EQ(first.size(), second.size());
+
+    cache.Release(first);
+    EXPECT_TRUE(SpanEquals(second, "image one"));
+    cache.Release(second);
+}
+
+TEST_F(TestOTAImageCache, TestRenameReplacesImage)
+{
+    ASSERT_TRUE(WriteFile(kImagePath, "w", "image one"));
+
+    OTAImageCache cache;
+    ByteSpan running;
+    EXPECT_EQ(cache.Acquire(kImagePath, running), CHIP_NO_ERROR);
+
+    // Atomic replacement: new transfers get the new image, the running one keeps the old.
+    ASSERT_TRUE(WriteFile(kImagePathTemp, "w", "image number two"));
+    ASSERT_EQ(rename(kImagePathTemp, kImagePath), 0);
+
+    ByteSpan next;
+    EXPECT_EQ(cache.Acquire(kImagePath, next), CHIP_NO_ERROR);
+    EXPECT_NE(next.data(), running.data());
+    EXPECT_TRUE(SpanEquals(next, "image number two"));
+    EXPECT_TRUE(SpanEquals(running, "image one"));
+
+    cache.Release(running);
+    cache.Release(next);
+}
+
+TEST_F(TestOTAImageCache, TestInPlaceModificationIsRefused)
+{
+    ASSERT_TRUE(WriteFile(kImagePath, "w", "image one"));
+
+    OTAImageCache cache;
+    ByteSpan running;
+    EXPECT_EQ(cache.Acquire(kImagePath, running), CHIP_NO_ERROR);
+
+    // Growing the file keeps the mapped pages valid, but the image no longer matches what is being served.
+    ASSERT_TRUE(WriteFile(kImagePath, "a", " and more"));
+
+    ByteSpan next;
+    EXPECT_EQ(cache.Acquire(kImagePath, next), CHIP_ERROR_INCORRECT_STATE);
+
+    // Once no transfer holds the old mapping, the file can be served again.
+    cache.Release(running);
+    EXPECT_EQ(cache.Acquire(kImagePath, next), CHIP_NO_ERROR);
+    EXPECT_TRUE(SpanEquals(next, "image one and more"));
+    cache.Release(next);
+}
+
+TEST_F(TestOTAImageCache, TestMissingOrEmptyImage)
+{
+    OTAImageCache cache;
+    ByteSpan image;
+
+    EXPECT_EQ(cache.Acquire(kImagePath, image), CHIP_ERROR_OPEN_FAILED);
+
+    ASSERT_TRUE(WriteFile(kImagePath, "w", ""));
+    EXPECT_EQ(cache.Acquire(kImagePath, image), CHIP_ERROR_READ_FAILED);
+}
+
+TEST_F(TestOTAImageCache, TestCapacity)
+{
+    char path[64];
+    ByteSpan images[OTAImageCache::kMaxImages];
+
+    OTAImageCache cache;
+    for (size_t i = 0; i < OTAImageCache::kMaxImages; i++)
+    {
+        snprintf(path, sizeof(path), "%s.%u", kImagePath, static_cast<unsigned>(i));
+        ASSERT_TRUE(WriteFile(path, "w", "image"));
+        EXPECT_EQ(cache.Acquire(path, images[i]), CHIP_NO_ERROR);
+    }
+
+    ByteSpan extra;
+    ASSERT_TRUE(WriteFile(kImagePath, "w", "one too many"));
+    EXPECT_EQ(cache.Acquire(kImagePath, extra), CHIP_ERROR_NO_MEMORY);
+
+    for (size_t i = 0; i < OTAImageCache::kMaxImages; i++)
+    {
+        cache.Release(images[i]);
+        snprintf(path, sizeof(path), "%s.%u", kImagePath, static_cast<unsigned>(i));
+        unlink(path);
+    }
+}
+
+} // namespace
@@ -111,6 +111,7 @@
 #endif // CHIP_DEVICE_LAYER_TARGET_DARWIN
 
 #if CHIP_DEVICE_LAYER_TARGET_LINUX
+#include <platform/Linux/AsyncLogging.h>
 #include <platform/Linux/NetworkCommissioningDriver.h>
 #endif // CHIP_DEVICE_LAYER_TARGET_LINUX
 
@@ -383,6 +384,14 @@ int ChipLinuxAppInit(int argc, char * const argv[], OptionSet * customOptions,
     err = ParseArguments(argc, argv, customOptions);
     SuccessOrExit(err);
 
+#if CHIP_DEVICE_LAYER_TARGET_LINUX
+    if (LinuxDeviceOptions::GetInstance().mAsyncLogging)
+    {
+        err = Logging::Platform::StartAsyncLogging();
+        SuccessOrExit(err);
+    }
+#endif // CHIP_DEVICE_LAYER_TARGET_LINUX
+
     sSecondaryNetworkCommissioningEndpoint = secondaryNetworkCommissioningEndpoint;
 
 #ifdef CHIP_CONFIG_KVS_PATH
@@ -400,6 +409,11 @@ int ChipLinuxAppInit(int argc, char * const argv[], OptionSet * customOptions,
     err = DeviceLayer::PlatformMgr().InitChipStack();
     SuccessOrExit(err);
 
+    // Runs work such as PBKDF2 off the Matter thread when CHIP_DEVICE_CONFIG_ENABLE_BG_EVENT_PROCESSING is set, does
+    // nothing otherwise. Stopped by PlatformMgr().Shutdown().
+    err = DeviceLayer::PlatformMgr().StartBackgroundEventLoopTask();
+    SuccessOrExit(err);
+
     // Init the commissionable data provider based on command line options
     // to handle custom verifiers, discriminators, etc.
     err = chip::examples::InitCommissionableDataProvider(gCommissionableDataProvider, LinuxDeviceOptions::GetInstance());
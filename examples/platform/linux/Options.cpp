@@ -93,6 +93,9 @@ enum
     kDeviceOption_TestEventTriggerEnableKey,
     kTraceTo,
     kOptionSimulateNoInternalTime,
+#if CHIP_DEVICE_LAYER_TARGET_LINUX
+    kDeviceOption_AsyncLogging,
+#endif
 #if defined(PW_RPC_ENABLED)
     kOptionRpcServerPort,
 #endif
@@ -167,6 +170,9 @@ OptionDef sDeviceOptionDefs[] = {
     { "trace-to", kArgumentRequired, kTraceTo },
 #endif
     { "simulate-no-internal-time", kNoArgument, kOptionSimulateNoInternalTime },
+#if CHIP_DEVICE_LAYER_TARGET_LINUX
+    { "async-logging", kNoArgument, kDeviceOption_AsyncLogging },
+#endif
 #if defined(PW_RPC_ENABLED)
     { "rpc-server-port", kArgumentRequired, kOptionRpcServerPort },
 #endif
@@ -304,6 +310,11 @@ const char * sDeviceOptionHelp =
 #endif
     "  --simulate-no-internal-time\n"
     "       Time cluster does not use internal platform time\n"
+#if CHIP_DEVICE_LAYER_TARGET_LINUX
+    "  --async-logging\n"
+    "       Write log lines from a dedicated thread instead of the thread that emits them.\n"
+    "       Lines are dropped (and counted) rather than blocking when output cannot keep up.\n"
+#endif
 #if defined(PW_RPC_ENABLED)
     "  --rpc-server-port\n"
     "       Start RPC server on specified port\n"
@@ -574,6 +585,11 @@ bool HandleOption(const char * aProgram, OptionSet * aOptions, int aIdentifier,
     case kOptionSimulateNoInternalTime:
         LinuxDeviceOptions::GetInstance().mSimulateNoInternalTime = true;
         break;
+#if CHIP_DEVICE_LAYER_TARGET_LINUX
+    case kDeviceOption_AsyncLogging:
+        LinuxDeviceOptions::GetInstance().mAsyncLogging = true;
+        break;
+#endif
 #if defined(PW_RPC_ENABLED)
     case kOptionRpcServerPort:
         LinuxDeviceOptions::GetInstance().rpcServerPort = static_cast<uint16_t>(atoi(aValue));
@@ -75,6 +75,9 @@ struct LinuxDeviceOptions
     uint8_t testEventTriggerEnableKey[16] = { 0 };
     std::vector<std::string> traceTo;
     bool mSimulateNoInternalTime = false;
+#if CHIP_DEVICE_LAYER_TARGET_LINUX
+    bool mAsyncLogging = false;
+#endif
 #if defined(PW_RPC_ENABLED)
     uint16_t rpcServerPort = 33000;
 #endif
@@ -31,6 +31,9 @@ namespace app {
 ///   - CurrentEncodingListIndex representing the list index that is next
 ///     to be encoded in the output. kInvalidListIndex means that a new list
 ///     encoding has been started.
+///   - An optional ListResumeCursor, an opaque producer-defined position
+///     matching CurrentEncodingListIndex, that lets list producers which
+///     can seek resume a chunked list without replaying earlier items.
 class AttributeEncodeState
 {
 public:
@@ -48,13 +51,14 @@ public:
         }
         else
         {
-            mCurrentEncodingListIndex = kInvalidListIndex;
-            mAllowPartialData         = false;
+            Reset();
         }
     }
 
     bool AllowPartialData() const { return mAllowPartialData; }
     ListIndex CurrentEncodingListIndex() const { return mCurrentEncodingListIndex; }
+    bool HasListResumeCursor() const { return mHasListResumeCursor; }
+    uint32_t ListResumeCursor() const { return mListResumeCursor; }
 
     AttributeEncodeState & SetAllowPartialData(bool allow)
     {
@@ -68,10 +72,25 @@ public:
         return *this;
     }
 
+    AttributeEncodeState & SetListResumeCursor(uint32_t cursor)
+    {
+        mListResumeCursor    = cursor;
+        mHasListResumeCursor = true;
+        return *this;
+    }
+
+    AttributeEncodeState & ClearListResumeCursor()
+    {
+        mListResumeCursor    = 0;
+        mHasListResumeCursor = false;
+        return *this;
+    }
+
     void Reset()
     {
         mCurrentEncodingListIndex = kInvalidListIndex;
         mAllowPartialData         = false;
+        ClearListResumeCursor();
     }
 
 private:
@@ -97,6 +116,15 @@ private:
      * TODO: There might be a better name for this variable.
      */
     bool mAllowPartialData = false;
+
+    /**
+     * Set when every list item encoded so far was produced through a cursor-aware encode (see
+     * AttributeValueEncoder::ListEncodeHelper::EncodeAt). mListResumeCursor is then the producer's
+     * position of the first item that still needs to be encoded, i.e. the position that corresponds to
+     * mCurrentEncodingListIndex.
+     */
+    bool mHasListResumeCursor  = false;
+    uint32_t mListResumeCursor = 0;
 };
 
 } // namespace app
@@ -60,6 +60,7 @@ CHIP_ERROR AttributeValueEncoder::EnsureListStarted()
             mAttributeReportIBsBuilder.GetWriter()->ReserveBuffer(kEndOfAttributeReportIBByteCount + kEndOfListByteCount));
 
         mEncodeState.SetCurrentEncodingListIndex(0);
+        mEncodeState.ClearListResumeCursor();
     }
     else
     {
@@ -77,6 +78,24 @@ CHIP_ERROR AttributeValueEncoder::EnsureListStarted()
     return CHIP_NO_ERROR;
 }
 
+CHIP_ERROR AttributeValueEncoder::ResumeListCursor(uint32_t & aCursor)
+{
+    aCursor = 0;
+
+    // Only valid from within EncodeList, before any item was produced.
+    VerifyOrReturnError(mCurrentEncodingListIndex == 0, CHIP_ERROR_INCORRECT_STATE);
+
+    if (mEncodingInitialList || !mEncodeState.HasListResumeCursor())
+    {
+        return CHIP_NO_ERROR;
+    }
+
+    // Everything before the cursor went out in previous chunks.
+    mCurrentEncodingListIndex = mEncodeState.CurrentEncodingListIndex();
+    aCursor                   = mEncodeState.ListResumeCursor();
+    return CHIP_NO_ERROR;
+}
+
 void AttributeValueEncoder::EnsureListEnded()
 {
     if (!mEncodingInitialList)
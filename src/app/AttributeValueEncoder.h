@@ -64,6 +64,33 @@ public:
             return mAttributeValueEncoder.EncodeListItem(std::forward<T>(aArg));
         }
 
+        /**
+         * Opt-in support for producers that can seek in their backing storage (e.g. by table index).
+         *
+         * Returns the producer-defined cursor of the first item that still needs to be encoded. When a
+         * chunked list is resumed and every item encoded so far went through EncodeAt(), the encoder
+         * fast-forwards past the already-encoded items, so the producer can start at the returned
+         * cursor instead of replaying (and skipping) all earlier items.  Returns 0 otherwise, in which
+         * case the producer must start from the beginning and earlier items are skipped as usual.
+         *
+         * Must be called before any item is encoded, and returns CHIP_ERROR_INCORRECT_STATE otherwise.
+         */
+        CHIP_ERROR ResumeCursor(uint32_t & aCursor) const { return mAttributeValueEncoder.ResumeListCursor(aCursor); }
+
+        /**
+         * Same as Encode(), but records aNextCursor as the position of the item following aArg, so a
+         * later chunk can resume there (see ResumeCursor()).
+         */
+        template <typename T>
+        CHIP_ERROR EncodeAt(uint32_t aNextCursor, T && aArg) const
+        {
+            mAttributeValueEncoder.mPendingListCursor    = aNextCursor;
+            mAttributeValueEncoder.mHasPendingListCursor = true;
+            CHIP_ERROR err                               = Encode(std::forward<T>(aArg));
+            mAttributeValueEncoder.mHasPendingListCursor = false;
+            return err;
+        }
+
     private:
         AttributeValueEncoder & mAttributeValueEncoder;
     };
@@ -201,6 +228,15 @@ private:
 
         mCurrentEncodingListIndex++;
         mEncodeState.SetCurrentEncodingListIndex(mCurrentEncodingListIndex);
+        if (mHasPendingListCursor)
+        {
+            mEncodeState.SetListResumeCursor(mPendingListCursor);
+        }
+        else
+        {
+            // Cursors are only meaningful if every encoded item carried one.
+            mEncodeState.ClearListResumeCursor();
+        }
         mEncodedAtLeastOneListItem = true;
         return CHIP_NO_ERROR;
     }
@@ -240,6 +276,14 @@ private:
      */
     void EnsureListEnded();
 
+    /**
+     * Outputs the saved list resume cursor, and skips mCurrentEncodingListIndex ahead to the matching
+     * list index, if the current state has a valid cursor.  Outputs 0 otherwise.
+     *
+     * Fails with CHIP_ERROR_INCORRECT_STATE if not called from EncodeList before any item was produced.
+     */
+    CHIP_ERROR ResumeListCursor(uint32_t & aCursor);
+
     AttributeReportIBs::Builder & mAttributeReportIBsBuilder;
     const Access::SubjectDescriptor mSubjectDescriptor;
     ConcreteDataAttributePath mPath;
@@ -253,6 +297,9 @@ private:
     // mEncodedAtLeastOneListItem becomes true once we successfully encode a list item.
     bool mEncodedAtLeastOneListItem     = false;
     ListIndex mCurrentEncodingListIndex = kInvalidListIndex;
+    // Cursor supplied by ListEncodeHelper::EncodeAt for the item currently being encoded.
+    bool mHasPendingListCursor  = false;
+    uint32_t mPendingListCursor = 0;
     AttributeEncodeState mEncodeState;
 };
 
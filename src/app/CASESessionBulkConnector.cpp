@@ -0,0 +1,293 @@
+/*
+ *
+ *    Copyright (c) 2024 Project CHIP Authors
+ *    All rights reserved.
+ *
+ *    Licensed under the Apache License, Version 2.0 (the "License");
+ *    you may not use this file except in compliance with the License.
+ *    You may obtain a copy of the License at
+ *
+ *        http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *    Unless required by applicable law or agreed to in writing, software
+ *    distributed under the License is distributed on an "AS IS" BASIS,
+ *    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *    See the License for the specific language governing permissions and
+ *    limitations under the License.
+ */
+
+#include <app/CASESessionBulkConnector.h>
+
+#include <lib/support/CodeUtils.h>
+#include <lib/support/logging/CHIPLogging.h>
+#include <tracing/metric_event.h>
+
+#include <algorithm>
+
+namespace chip {
+
+using namespace System::Clock;
+
+CASESessionBulkConnector::Slot::Slot() : onConnected(HandleConnected, this), onFailure(HandleFailure, this) {}
+
+void CASESessionBulkConnector::Slot::HandleConnected(void * context, Messaging::ExchangeManager & exchangeMgr,
+                                                     const SessionHandle & sessionHandle)
+{
+    auto * slot = static_cast<Slot *>(context);
+    slot->connector->OnSlotComplete(*slot, CHIP_NO_ERROR, &exchangeMgr, &sessionHandle);
+}
+
+void CASESessionBulkConnector::Slot::HandleFailure(void * context, const ScopedNodeId & peerId, CHIP_ERROR error)
+{
+    auto * slot = static_cast<Slot *>(context);
+    slot->connector->OnSlotComplete(*slot, error, nullptr, nullptr);
+}
+
+CHIP_ERROR CASESessionBulkConnector::Init(CASESessionManager * sessionManager, System::Layer * systemLayer)
+{
+    VerifyOrReturnError(sessionManager != nullptr && systemLayer != nullptr, CHIP_ERROR_INVALID_ARGUMENT);
+    VerifyOrReturnError(!IsActive(), CHIP_ERROR_INCORRECT_STATE);
+
+    mSessionManager = sessionManager;
+    mSystemLayer    = systemLayer;
+    for (auto & slot : mSlots)
+    {
+        slot.connector = this;
+    }
+    return CHIP_NO_ERROR;
+}
+
+CHIP_ERROR CASESessionBulkConnector::Start(Span<const Peer> peers, const Params & params, Delegate * delegate)
+{
+    VerifyOrReturnError(mSessionManager != nullptr && !IsActive(), CHIP_ERROR_INCORRECT_STATE);
+    VerifyOrReturnError(delegate != nullptr && !peers.empty() && params.maxConcurrent > 0, CHIP_ERROR_INVALID_ARGUMENT);
+
+    VerifyOrReturnError(mPeers.Alloc(peers.size()), CHIP_ERROR_NO_MEMORY);
+    std::copy(peers.begin(), peers.end(), mPeers.Get());
+    std::stable_sort(mPeers.Get(), mPeers.Get() + peers.size(),
+                     [](const Peer & a, const Peer & b) { return a.priority > b.priority; });
+
+    mParams               = params;
+    mParams.maxConcurrent = std::min<uint8_t>(params.maxConcurrent, CHIP_CONFIG_CASE_BULK_CONNECT_MAX_CONCURRENCY);
+    mDelegate             = delegate;
+
+    // Priming more peers than the resolver can track would only drop the oldest lookups, including the ones of the
+    // establishments in flight.
+    const size_t maxPrimeAhead = kMaxAddressLookups - std::min<size_t>(kMaxAddressLookups, mParams.maxConcurrent);
+    if (mParams.primeAhead > maxPrimeAhead)
+    {
+        ChipLogProgress(CASESessionManager, "Bulk connect: resolving %u peers ahead instead of %u",
+                        static_cast<unsigned>(maxPrimeAhead), mParams.primeAhead);
+        mParams.primeAhead = static_cast<uint8_t>(maxPrimeAhead);
+    }
+
+    mPeerCount            = peers.size();
+    mNextPeer             = 0;
+    mPrimedEnd            = 0;
+    mInFlightCount        = 0;
+    mConnectedCount       = 0;
+    mFailedCount          = 0;
+    mStartTime            = System::SystemClock().GetMonotonicTimestamp();
+
+    ChipLogProgress(CASESessionManager, "Bulk connect: connecting to %u peers, %u at a time",
+                    static_cast<unsigned>(mPeerCount), mParams.maxConcurrent);
+    MATTER_LOG_METRIC_BEGIN(Tracing::kMetricCASESessionBulkConnect);
+
+    ScheduleLaunch(kZero);
+    return CHIP_NO_ERROR;
+}
+
+void CASESessionBulkConnector::Cancel()
+{
+    VerifyOrReturn(IsActive());
+
+    if (mLaunchScheduled)
+    {
+        mSystemLayer->CancelTimer(HandleLaunchTimer, this);
+        mLaunchScheduled = false;
+    }
+
+    for (auto & slot : mSlots)
+    {
+        slot.onConnected.Cancel();
+        slot.onFailure.Cancel();
+        slot.inUse = false;
+    }
+
+    CancelUpcomingPeerPriming();
+
+    MATTER_LOG_METRIC_END(Tracing::kMetricCASESessionBulkConnect, CHIP_ERROR_CANCELLED);
+
+    mPeers.Free();
+    mPeerCount     = 0;
+    mNextPeer      = 0;
+    mPrimedEnd     = 0;
+    mInFlightCount = 0;
+    mDelegate      = nullptr;
+}
+
+void CASESessionBulkConnector::HandleLaunchTimer(System::Layer * systemLayer, void * context)
+{
+    auto * self            = static_cast<CASESessionBulkConnector *>(context);
+    self->mLaunchScheduled = false;
+    self->LaunchNext();
+}
+
+void CASESessionBulkConnector::ScheduleLaunch(Timeout delay)
+{
+    VerifyOrReturn(!mLaunchScheduled);
+
+    // Going through the timer, even with no delay, keeps FindOrEstablishSession (which can complete synchronously)
+    // off the stack of the delegate callbacks.
+    CHIP_ERROR err = mSystemLayer->StartTimer(delay, HandleLaunchTimer, this);
+    if (err != CHIP_NO_ERROR)
+    {
+        ChipLogError(CASESessionManager, "Bulk connect: failed to schedule session establishment: %" CHIP_ERROR_FORMAT,
+                     err.Format());
+        // Fail the remaining peers rather than stalling forever.
+        CancelUpcomingPeerPriming();
+        mFailedCount += mPeerCount - mNextPeer;
+        mNextPeer = mPeerCount;
+        CheckComplete();
+        return;
+    }
+    mLaunchScheduled = true;
+}
+
+void CASESessionBulkConnector::LaunchNext()
+{
+    while (IsActive() && mNextPeer < mPeerCount && mInFlightCount < mParams.maxConcurrent)
+    {
+        Slot * slot = std::find_if(std::begin(mSlots), std::end(mSlots), [](const Slot & s) { return !s.inUse; });
+        VerifyOrDie(slot != std::end(mSlots));
+
+        slot->peerId = mPeers[mNextPeer++].peerId;
+        slot->inUse  = true;
+        mInFlightCount++;
+
+        EstablishSession(slot->peerId, &slot->onConnected, &slot->onFailure);
+
+        if (mParams.pacingInterval != kZero)
+        {
+            if (IsActive() && mNextPeer < mPeerCount && mInFlightCount < mParams.maxConcurrent)
+            {
+                ScheduleLaunch(mParams.pacingInterval);
+            }
+            break;
+        }
+    }
+
+    if (IsActive())
+    {
+        PrimeUpcomingPeers();
+    }
+    CheckComplete();
+}
+
+void CASESessionBulkConnector::PrimeUpcomingPeers()
+{
+    // Peers that were already started look up their address themselves.
+    mPrimedEnd       = std::max(mPrimedEnd, mNextPeer);
+    const size_t end = std::min(mPeerCount, mNextPeer + mParams.primeAhead);
+    for (; mPrimedEnd < end; mPrimedEnd++)
+    {
+        PrimeAddress(mPeers[mPrimedEnd]);
+    }
+}
+
+void CASESessionBulkConnector::CancelUpcomingPeerPriming()
+{
+    // Only peers that were never started; the address lookup of a started one takes over its resolution. Peers
+    // primed from their last known address have no resolution to stop.
+    for (size_t i = mNextPeer; i < mPrimedEnd; i++)
+    {
+        if (!mPeers[i].lastKnownAddress.IsInitialized())
+        {
+            CancelAddressPriming(mPeers[i].peerId);
+        }
+    }
+    mPrimedEnd = mNextPeer;
+}
+
+void CASESessionBulkConnector::EstablishSession(const ScopedNodeId & peerId, Callback::Callback<OnDeviceConnected> * onConnected,
+                                                Callback::Callback<OnDeviceConnectionFailure> * onFailure)
+{
+    mSessionManager->FindOrEstablishSession(peerId, onConnected, onFailure,
+#if CHIP_DEVICE_CONFIG_ENABLE_AUTOMATIC_CASE_RETRIES
+                                            mParams.attemptCount, nullptr,
+#endif // CHIP_DEVICE_CONFIG_ENABLE_AUTOMATIC_CASE_RETRIES
+                                            TransportPayloadCapability::kMRPPayload);
+}
+
+void CASESessionBulkConnector::PrimeAddress(const Peer & peer)
+{
+    CHIP_ERROR err = mSessionManager->PrimePeerAddress(peer.peerId, peer.lastKnownAddress);
+    if (err != CHIP_NO_ERROR)
+    {
+        // Not fatal: the session establishment looks the address up itself.
+        ChipLogDetail(CASESessionManager, "Bulk connect: cannot resolve " ChipLogFormatScopedNodeId " ahead: %" CHIP_ERROR_FORMAT,
+                      ChipLogValueScopedNodeId(peer.peerId), err.Format());
+    }
+}
+
+void CASESessionBulkConnector::CancelAddressPriming(const ScopedNodeId & peerId)
+{
+    mSessionManager->CancelPeerAddressPriming(peerId);
+}
+
+void CASESessionBulkConnector::OnSlotComplete(Slot & slot, CHIP_ERROR error, Messaging::ExchangeManager * exchangeMgr,
+                                              const SessionHandle * sessionHandle)
+{
+    VerifyOrReturn(IsActive() && slot.inUse);
+
+    slot.inUse = false;
+    mInFlightCount--;
+
+    if (error == CHIP_NO_ERROR)
+    {
+        mConnectedCount++;
+        mDelegate->OnPeerConnected(slot.peerId, *exchangeMgr, *sessionHandle);
+    }
+    else
+    {
+        mFailedCount++;
+        mDelegate->OnPeerConnectionFailure(slot.peerId, error);
+    }
+
+    // The delegate may have cancelled us.
+    VerifyOrReturn(IsActive());
+
+    if (mNextPeer < mPeerCount)
+    {
+        // Refill the freed slot, still honouring the pacing interval. This is a no-op if a launch is already pending.
+        ScheduleLaunch(mParams.pacingInterval);
+    }
+    else
+    {
+        CheckComplete();
+    }
+}
+
+void CASESessionBulkConnector::CheckComplete()
+{
+    VerifyOrReturn(IsActive() && mNextPeer == mPeerCount && mInFlightCount == 0);
+
+    auto elapsed = std::chrono::duration_cast<Milliseconds32>(System::SystemClock().GetMonotonicTimestamp() - mStartTime);
+    ChipLogProgress(CASESessionManager, "Bulk connect: %u connected, %u failed in %" PRIu32 " ms",
+                    static_cast<unsigned>(mConnectedCount), static_cast<unsigned>(mFailedCount), elapsed.count());
+    MATTER_LOG_METRIC_END(Tracing::kMetricCASESessionBulkConnect, mFailedCount == 0 ? CHIP_NO_ERROR : CHIP_ERROR_NOT_CONNECTED);
+
+    Delegate * delegate = mDelegate;
+    size_t connected    = mConnectedCount;
+    size_t failed       = mFailedCount;
+
+    mPeers.Free();
+    mPeerCount = 0;
+    mNextPeer  = 0;
+    mPrimedEnd = 0;
+    mDelegate  = nullptr;
+
+    delegate->OnBulkConnectComplete(connected, failed, elapsed);
+}
+
+} // namespace chip
@@ -0,0 +1,183 @@
+/*
+ *
+ *    Copyright (c) 2024 Project CHIP Authors
+ *    All rights reserved.
+ *
+ *    Licensed under the Apache License, Version 2.0 (the "License");
+ *    you may not use this file except in compliance with the License.
+ *    You may obtain a copy of the License at
+ *
+ *        http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *    Unless required by applicable law or agreed to in writing, software
+ *    distributed under the License is distributed on an "AS IS" BASIS,
+ *    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *    See the License for the specific language governing permissions and
+ *    limitations under the License.
+ */
+
+#pragma once
+
+#include <algorithm>
+
+#include <app/CASESessionManager.h>
+#include <lib/core/CHIPConfig.h>
+#include <lib/core/CHIPError.h>
+#include <lib/core/ScopedNodeId.h>
+#include <lib/support/ScopedBuffer.h>
+#include <lib/support/Span.h>
+#include <system/SystemClock.h>
+#include <system/SystemLayer.h>
+#include <transport/raw/PeerAddress.h>
+
+namespace chip {
+
+/**
+ * Establishes CASE sessions with a large set of peers through a CASESessionManager, e.g. when a controller
+ * restarts and needs to reconnect to every node it manages.
+ *
+ * Instead of calling FindOrEstablishSession for every peer at once, which exhausts the OperationalSessionSetup
+ * pool and floods the network with operational discovery queries, the connector:
+ *
+ *   - keeps at most `maxConcurrent` session establishments in flight,
+ *   - starts higher-priority peers first (peers of equal priority keep their relative order),
+ *   - waits at least `pacingInterval` between starting two establishments,
+ *   - resolves the operational addresses of the next `primeAhead` peers while earlier ones are being connected, so
+ *     that their establishment finds the address in the address resolver cache instead of waiting on DNS-SD.
+ *     Peers given with the address they were last reached at skip DNS-SD and have that address cached instead.
+ *
+ * Sessions that already exist complete immediately. CASE session resumption is used automatically when the
+ * CASESessionManager was configured with session resumption storage.
+ *
+ * The time until every peer has either connected or failed is reported to the delegate and as the
+ * kMetricCASESessionBulkConnect metric.
+ */
+class CASESessionBulkConnector
+{
+public:
+    struct Peer
+    {
+        ScopedNodeId peerId;
+        // Peers with a higher priority are connected first.
+        uint8_t priority = 0;
+        // Address the peer was last reached at, e.g. persisted by the caller from an earlier session, used to prime
+        // the address resolver cache without DNS-SD. Left uninitialized when unknown.
+        Transport::PeerAddress lastKnownAddress;
+    };
+
+    struct Params
+    {
+        // Upper bound on concurrent establishments; clamped to CHIP_CONFIG_CASE_BULK_CONNECT_MAX_CONCURRENCY.
+        uint8_t maxConcurrent                        = CHIP_CONFIG_CASE_BULK_CONNECT_MAX_CONCURRENCY;
+        System::Clock::Milliseconds32 pacingInterval = System::Clock::kZero;
+        // Number of peers, past the ones already started, whose address is resolved ahead of time; 0 disables it.
+        // Clamped so that in-flight and primed lookups fit in kMaxAddressLookups.
+        uint8_t primeAhead = CHIP_CONFIG_CASE_BULK_CONNECT_PRIME_AHEAD;
+#if CHIP_DEVICE_CONFIG_ENABLE_AUTOMATIC_CASE_RETRIES
+        uint8_t attemptCount = 1;
+#endif // CHIP_DEVICE_CONFIG_ENABLE_AUTOMATIC_CASE_RETRIES
+    };
+
+    class Delegate
+    {
+    public:
+        virtual ~Delegate() = default;
+
+        virtual void OnPeerConnected(const ScopedNodeId & peerId, Messaging::ExchangeManager & exchangeMgr,
+                                     const SessionHandle & sessionHandle)
+        {}
+        virtual void OnPeerConnectionFailure(const ScopedNodeId & peerId, CHIP_ERROR error) {}
+
+        /**
+         * Called once every peer has either connected or failed. The connector is idle again when this is called,
+         * so it may be restarted from within the callback.
+         */
+        virtual void OnBulkConnectComplete(size_t connectedCount, size_t failedCount, System::Clock::Milliseconds32 elapsed) = 0;
+    };
+
+    /**
+     * Number of address lookups that can be pending at once without the minmdns retry queue dropping queries, or the
+     * address resolver cache evicting primed addresses before they are used.
+     */
+    static constexpr size_t kMaxAddressLookups =
+        std::min<size_t>(CHIP_CONFIG_ADDRESS_RESOLVE_CACHE_SIZE, CHIP_CONFIG_MINMDNS_RETRY_QUEUE_SIZE);
+
+    CASESessionBulkConnector() = default;
+    virtual ~CASESessionBulkConnector() { Cancel(); }
+
+    CASESessionBulkConnector(const CASESessionBulkConnector &)             = delete;
+    CASESessionBulkConnector & operator=(const CASESessionBulkConnector &) = delete;
+
+    CHIP_ERROR Init(CASESessionManager * sessionManager, System::Layer * systemLayer);
+
+    /**
+     * Start connecting to the given peers. The peer list is copied.
+     *
+     * @retval CHIP_ERROR_INCORRECT_STATE if not initialized or a bulk connect is already in progress.
+     * @retval CHIP_ERROR_INVALID_ARGUMENT if the peer list is empty or the parameters are invalid.
+     */
+    CHIP_ERROR Start(Span<const Peer> peers, const Params & params, Delegate * delegate);
+
+    /**
+     * Stop starting new establishments and drop the callbacks of the ones in flight. Those establishments still
+     * run to completion in the CASESessionManager. The delegate is not called.
+     */
+    void Cancel();
+
+    bool IsActive() const { return mDelegate != nullptr; }
+
+    size_t PendingCount() const { return mPeerCount - mNextPeer; }
+    size_t InFlightCount() const { return mInFlightCount; }
+
+protected:
+    // Session establishment and address priming go through the CASESessionManager; tests substitute them.
+    virtual void EstablishSession(const ScopedNodeId & peerId, Callback::Callback<OnDeviceConnected> * onConnected,
+                                  Callback::Callback<OnDeviceConnectionFailure> * onFailure);
+    virtual void PrimeAddress(const Peer & peer);
+    virtual void CancelAddressPriming(const ScopedNodeId & peerId);
+
+private:
+    struct Slot
+    {
+        Slot();
+
+        static void HandleConnected(void * context, Messaging::ExchangeManager & exchangeMgr, const SessionHandle & sessionHandle);
+        static void HandleFailure(void * context, const ScopedNodeId & peerId, CHIP_ERROR error);
+
+        Callback::Callback<OnDeviceConnected> onConnected;
+        Callback::Callback<OnDeviceConnectionFailure> onFailure;
+        CASESessionBulkConnector * connector = nullptr;
+        ScopedNodeId peerId;
+        bool inUse = false;
+    };
+
+    static void HandleLaunchTimer(System::Layer * systemLayer, void * context);
+
+    void ScheduleLaunch(System::Clock::Timeout delay);
+    void LaunchNext();
+    void PrimeUpcomingPeers();
+    void CancelUpcomingPeerPriming();
+    void OnSlotComplete(Slot & slot, CHIP_ERROR error, Messaging::ExchangeManager * exchangeMgr,
+                        const SessionHandle * sessionHandle);
+    void CheckComplete();
+
+    CASESessionManager * mSessionManager = nullptr;
+    System::Layer * mSystemLayer         = nullptr;
+    Delegate * mDelegate                 = nullptr;
+    Params mParams;
+
+    Platform::ScopedMemoryBuffer<Peer> mPeers;
+    size_t mPeerCount      = 0;
+    size_t mNextPeer       = 0;
+    size_t mPrimedEnd      = 0;
+    size_t mInFlightCount  = 0;
+    size_t mConnectedCount = 0;
+    size_t mFailedCount    = 0;
+    bool mLaunchScheduled  = false;
+
+    System::Clock::Timestamp mStartTime = System::Clock::kZero;
+
+    Slot mSlots[CHIP_CONFIG_CASE_BULK_CONNECT_MAX_CONCURRENCY];
+};
+
+} // namespace chip
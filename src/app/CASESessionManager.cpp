@@ -18,6 +18,7 @@
 
 #include <app/CASESessionManager.h>
 #include <lib/address_resolve/AddressResolve.h>
+#include <lib/dnssd/Resolver.h>
 
 namespace chip {
 
@@ -151,6 +152,38 @@ CHIP_ERROR CASESessionManager::GetPeerAddress(const ScopedNodeId & peerId, Trans
     return CHIP_NO_ERROR;
 }
 
+CHIP_ERROR CASESessionManager::PrimePeerAddress(const ScopedNodeId & peerId, const Transport::PeerAddress & lastKnownAddress)
+{
+    ReturnErrorOnFailure(mConfig.sessionInitParams.Validate());
+    VerifyOrReturnError(!FindExistingSession(peerId).HasValue() && FindExistingSessionSetup(peerId) == nullptr, CHIP_NO_ERROR);
+
+    const auto * fabricInfo = mConfig.sessionInitParams.fabricTable->FindFabricWithIndex(peerId.GetFabricIndex());
+    VerifyOrReturnError(fabricInfo != nullptr, CHIP_ERROR_INVALID_FABRIC_INDEX);
+
+    const PeerId operationalId(fabricInfo->GetCompressedFabricId(), peerId.GetNodeId());
+    if (lastKnownAddress.IsInitialized())
+    {
+        AddressResolve::ResolveResult result;
+        result.address = lastKnownAddress;
+
+        CHIP_ERROR err = AddressResolve::Resolver::Instance().AddKnownAddress(operationalId, result);
+        VerifyOrReturnError(err == CHIP_ERROR_NOT_IMPLEMENTED, err);
+    }
+
+    // The address resolver caches every operational DNS-SD answer, including ones no lookup is waiting for.
+    return Dnssd::Resolver::Instance().ResolveNodeId(operationalId);
+}
+
+void CASESessionManager::CancelPeerAddressPriming(const ScopedNodeId & peerId)
+{
+    VerifyOrReturn(mConfig.sessionInitParams.Validate() == CHIP_NO_ERROR);
+
+    const auto * fabricInfo = mConfig.sessionInitParams.fabricTable->FindFabricWithIndex(peerId.GetFabricIndex());
+    VerifyOrReturn(fabricInfo != nullptr);
+
+    Dnssd::Resolver::Instance().NodeIdResolutionNoLongerNeeded(PeerId(fabricInfo->GetCompressedFabricId(), peerId.GetNodeId()));
+}
+
 void CASESessionManager::UpdatePeerAddress(ScopedNodeId peerId)
 {
     bool forAddressUpdate             = true;
@@ -142,6 +142,27 @@ public:
 #endif // CHIP_DEVICE_CONFIG_ENABLE_AUTOMATIC_CASE_RETRIES
                                 TransportPayloadCapability transportPayloadCapability = TransportPayloadCapability::kMRPPayload);
 
+    /**
+     * Start resolving the operational address of the given peer before a session with it is needed, so that the
+     * address lookup of a later FindOrEstablishSession can be answered from the address resolver cache instead of
+     * waiting on DNS-SD.
+     *
+     * If the address the peer was last reached at is known, e.g. persisted from GetPeerAddress by the caller, it is
+     * handed to the address resolver cache instead and no DNS-SD query is sent. The resolver refreshes it through
+     * DNS-SD when it is used, so a stale address costs one failed attempt.
+     *
+     * Does nothing if there already is a session, or a session being established, with the peer.
+     */
+    CHIP_ERROR PrimePeerAddress(const ScopedNodeId & peerId,
+                                const Transport::PeerAddress & lastKnownAddress = Transport::PeerAddress());
+
+    /**
+     * Stop a DNS-SD resolution started by PrimePeerAddress for a peer that no session will be established with.
+     *
+     * Must not be called while a session with the peer is being established, since that shares the resolution.
+     */
+    void CancelPeerAddressPriming(const ScopedNodeId & peerId);
+
     void ReleaseSessionsForFabric(FabricIndex fabricIndex);
 
     void ReleaseAllSessions();
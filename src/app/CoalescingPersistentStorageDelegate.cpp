@@ -0,0 +1,338 @@
+/*
+ *
+ *    Copyright (c) 2024 Project CHIP Authors
+ *
+ *    Licensed under the Apache License, Version 2.0 (the "License");
+ *    you may not use this file except in compliance with the License.
+ *    You may obtain a copy of the License at
+ *
+ *        http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *    Unless required by applicable law or agreed to in writing, software
+ *    distributed under the License is distributed on an "AS IS" BASIS,
+ *    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *    See the License for the specific language governing permissions and
+ *    limitations under the License.
+ */
+
+#include <app/CoalescingPersistentStorageDelegate.h>
+
+#include <lib/support/CHIPMemString.h>
+#include <lib/support/CodeUtils.h>
+#include <lib/support/logging/CHIPLogging.h>
+
+#include <algorithm>
+#include <cctype>
+#include <cstring>
+#include <utility>
+
+namespace chip {
+namespace app {
+
+CoalescingPersistentStorageDelegate::~CoalescingPersistentStorageDelegate()
+{
+    LogErrorOnFailure(Flush());
+    mSystemLayer.CancelTimer(OnFlushTimer, this);
+}
+
+CHIP_ERROR CoalescingPersistentStorageDelegate::SyncGetKeyValue(const char * key, void * buffer, uint16_t & size)
+{
+    PendingWrite * entry = FindPendingWrite(key);
+    if (entry == nullptr)
+    {
+        return mStorage.SyncGetKeyValue(key, buffer, size);
+    }
+
+    ReturnErrorCodeIf(((buffer == nullptr) && (size != 0)), CHIP_ERROR_INVALID_ARGUMENT);
+    VerifyOrReturnError(entry->state == EntryState::kSet, CHIP_ERROR_PERSISTED_STORAGE_VALUE_NOT_FOUND);
+
+    const size_t valueSize = entry->value.AllocatedSize();
+    ReturnErrorCodeIf(size == 0 && valueSize == 0, CHIP_NO_ERROR);
+    ReturnErrorCodeIf(buffer == nullptr, CHIP_ERROR_BUFFER_TOO_SMALL);
+
+    const uint16_t sizeToCopy = static_cast<uint16_t>(std::min<size_t>(size, valueSize));
+    memcpy(buffer, entry->value.Get(), sizeToCopy);
+    size = sizeToCopy;
+    return sizeToCopy < valueSize ? CHIP_ERROR_BUFFER_TOO_SMALL : CHIP_NO_ERROR;
+}
+
+CHIP_ERROR CoalescingPersistentStorageDelegate::SyncSetKeyValue(const char * key, const void * value, uint16_t size)
+{
+    VerifyOrReturnError(value != nullptr || size == 0, CHIP_ERROR_INVALID_ARGUMENT);
+
+    if (!IsCoalescedKey(key))
+    {
+        // Keep the order of writes as seen by the decorated storage.
+        FlushBeforeBarrier(key);
+        return mStorage.SyncSetKeyValue(key, value, size);
+    }
+
+    Platform::ScopedMemoryBufferWithSize<uint8_t> buffer;
+    if (size > 0)
+    {
+        buffer.Alloc(size);
+        ReturnErrorCodeIf(!buffer, CHIP_ERROR_NO_MEMORY);
+        memcpy(buffer.Get(), value, size);
+    }
+
+    PendingWrite * entry = FindPendingWrite(key);
+    if (entry == nullptr)
+    {
+        entry = AllocatePendingWrite(key);
+    }
+    if (entry == nullptr)
+    {
+        LogErrorOnFailure(Flush());
+        entry = AllocatePendingWrite(key);
+    }
+    if (entry == nullptr)
+    {
+        // Every pending write failed to be flushed and is waiting for a retry.
+        return mStorage.SyncSetKeyValue(key, value, size);
+    }
+
+    entry->value = std::move(buffer);
+    entry->state = EntryState::kSet;
+    MarkWritten(*entry);
+    ScheduleFlush();
+    return CHIP_NO_ERROR;
+}
+
+CHIP_ERROR CoalescingPersistentStorageDelegate::SyncDeleteKeyValue(const char * key)
+{
+    if (!IsCoalescedKey(key))
+    {
+        FlushBeforeBarrier(key);
+        return mStorage.SyncDeleteKeyValue(key);
+    }
+
+    PendingWrite * entry = FindPendingWrite(key);
+    if (entry != nullptr)
+    {
+        VerifyOrReturnError(entry->state == EntryState::kSet, CHIP_ERROR_PERSISTED_STORAGE_VALUE_NOT_FOUND);
+        // A key that was created and deleted between two flushes never reaches the decorated storage.
+        if (mStorage.SyncDoesKeyExist(key))
+        {
+            entry->value.Free();
+            entry->state = EntryState::kDelete;
+            MarkWritten(*entry);
+        }
+        else
+        {
+            FreePendingWrite(*entry);
+        }
+        return CHIP_NO_ERROR;
+    }
+
+    VerifyOrReturnError(mStorage.SyncDoesKeyExist(key), CHIP_ERROR_PERSISTED_STORAGE_VALUE_NOT_FOUND);
+
+    entry = AllocatePendingWrite(key);
+    if (entry == nullptr)
+    {
+        LogErrorOnFailure(Flush());
+        entry = AllocatePendingWrite(key);
+    }
+    if (entry == nullptr)
+    {
+        return mStorage.SyncDeleteKeyValue(key);
+    }
+
+    entry->state = EntryState::kDelete;
+    MarkWritten(*entry);
+    ScheduleFlush();
+    return CHIP_NO_ERROR;
+}
+
+bool CoalescingPersistentStorageDelegate::SyncDoesKeyExist(const char * key)
+{
+    PendingWrite * entry = FindPendingWrite(key);
+    if (entry == nullptr)
+    {
+        return mStorage.SyncDoesKeyExist(key);
+    }
+    return entry->state == EntryState::kSet;
+}
+
+CHIP_ERROR CoalescingPersistentStorageDelegate::Flush()
+{
+    CHIP_ERROR firstError = CHIP_NO_ERROR;
+
+    // Write the entries in the order the keys were last written, not in the order of their slots.
+    PendingWrite * ordered[kMaxPendingWrites];
+    size_t count = 0;
+    for (PendingWrite & entry : mPendingWrites)
+    {
+        if (entry.state != EntryState::kFree)
+        {
+            ordered[count++] = &entry;
+        }
+    }
+    std::sort(ordered, ordered + count,
+              [](const PendingWrite * a, const PendingWrite * b) { return static_cast<int32_t>(a->sequence - b->sequence) < 0; });
+
+    for (size_t i = 0; i < count; i++)
+    {
+        PendingWrite & entry = *ordered[i];
+        CHIP_ERROR err       = CHIP_NO_ERROR;
+
+        switch (entry.state)
+        {
+        case EntryState::kFree:
+            continue;
+        case EntryState::kSet:
+            err = mStorage.SyncSetKeyValue(entry.key, entry.value.Get(), static_cast<uint16_t>(entry.value.AllocatedSize()));
+            break;
+        case EntryState::kDelete:
+            err = mStorage.SyncDeleteKeyValue(entry.key);
+            if (err == CHIP_ERROR_PERSISTED_STORAGE_VALUE_NOT_FOUND)
+            {
+                err = CHIP_NO_ERROR;
+            }
+            break;
+        }
+
+        if (err != CHIP_NO_ERROR)
+        {
+            ChipLogError(AppServer, "Failed to flush pending write of key '%s': %" CHIP_ERROR_FORMAT, entry.key, err.Format());
+            if (firstError == CHIP_NO_ERROR)
+            {
+                firstError = err;
+            }
+            if (++entry.failedFlushes < kMaxFlushAttempts)
+            {
+                continue;
+            }
+            ChipLogError(AppServer, "Dropping pending write of key '%s' after %u failed flushes", entry.key,
+                         static_cast<unsigned>(entry.failedFlushes));
+        }
+
+        FreePendingWrite(entry);
+    }
+
+    mSystemLayer.CancelTimer(OnFlushTimer, this);
+    if (GetPendingWriteCount() > 0)
+    {
+        ScheduleFlush();
+    }
+
+    return firstError;
+}
+
+size_t CoalescingPersistentStorageDelegate::GetPendingWriteCount() const
+{
+    size_t count = 0;
+    for (const PendingWrite & entry : mPendingWrites)
+    {
+        if (entry.state != EntryState::kFree)
+        {
+            count++;
+        }
+    }
+    return count;
+}
+
+bool CoalescingPersistentStorageDelegate::IsResumptionKey(const char * key)
+{
+    // Session resumption: "g/sri", "g/s/<resumption id>" and "f/<fabric>/s/<node id>".
+    // Subscription resumption: "g/sut/<shard>", and "g/sum" and "g/su/<index>" of older releases.
+    if ((strcmp(key, "g/sri") == 0) || (strcmp(key, "g/sum") == 0) || (strncmp(key, "g/s/", 4) == 0) ||
+        (strncmp(key, "g/sut/", 6) == 0) || (strncmp(key, "g/su/", 5) == 0))
+    {
+        return true;
+    }
+
+    VerifyOrReturnValue(strncmp(key, "f/", 2) == 0, false);
+
+    const char * cursor = key + 2;
+    while (isxdigit(static_cast<unsigned char>(*cursor)))
+    {
+        cursor++;
+    }
+    return (cursor != key + 2) && (strncmp(cursor, "/s/", 3) == 0);
+}
+
+CoalescingPersistentStorageDelegate::PendingWrite * CoalescingPersistentStorageDelegate::FindPendingWrite(const char * key)
+{
+    VerifyOrReturnValue(key != nullptr, nullptr);
+
+    for (PendingWrite & entry : mPendingWrites)
+    {
+        if (entry.state != EntryState::kFree && strcmp(entry.key, key) == 0)
+        {
+            return &entry;
+        }
+    }
+    return nullptr;
+}
+
+CoalescingPersistentStorageDelegate::PendingWrite * CoalescingPersistentStorageDelegate::AllocatePendingWrite(const char * key)
+{
+    for (PendingWrite & entry : mPendingWrites)
+    {
+        if (entry.state == EntryState::kFree)
+        {
+            // IsCoalescedKey() has checked that the key fits.
+            Platform::CopyString(entry.key, key);
+            return &entry;
+        }
+    }
+    return nullptr;
+}
+
+void CoalescingPersistentStorageDelegate::MarkWritten(PendingWrite & entry)
+{
+    entry.sequence      = mNextSequence++;
+    entry.failedFlushes = 0;
+}
+
+void CoalescingPersistentStorageDelegate::FreePendingWrite(PendingWrite & entry)
+{
+    entry.value.Free();
+    entry.state         = EntryState::kFree;
+    entry.failedFlushes = 0;
+}
+
+void CoalescingPersistentStorageDelegate::FlushBeforeBarrier(const char * key)
+{
+    CHIP_ERROR err = Flush();
+    VerifyOrReturn(err != CHIP_NO_ERROR);
+
+    // The write of `key` goes ahead regardless. Writing the failed entries after it would reorder them, so drop them:
+    // coalesced keys only hold state that can be recreated.
+    ChipLogError(AppServer, "Dropping %u pending writes that could not be flushed before '%s'",
+                 static_cast<unsigned>(GetPendingWriteCount()), StringOrNullMarker(key));
+    for (PendingWrite & entry : mPendingWrites)
+    {
+        if (entry.state != EntryState::kFree)
+        {
+            FreePendingWrite(entry);
+        }
+    }
+    mSystemLayer.CancelTimer(OnFlushTimer, this);
+}
+
+bool CoalescingPersistentStorageDelegate::IsCoalescedKey(const char * key) const
+{
+    return (key != nullptr) && (strnlen(key, kKeyLengthMax + 1) <= kKeyLengthMax) && mIsCoalescedKey(key);
+}
+
+void CoalescingPersistentStorageDelegate::ScheduleFlush()
+{
+    // The interval starts with the first pending write and is not postponed by later writes, so that
+    // frequently written keys still reach the decorated storage regularly.
+    VerifyOrReturn(!mSystemLayer.IsTimerActive(OnFlushTimer, this));
+
+    CHIP_ERROR err = mSystemLayer.StartTimer(mFlushInterval, OnFlushTimer, this);
+    if (err != CHIP_NO_ERROR)
+    {
+        ChipLogError(AppServer, "Failed to schedule flush of pending writes: %" CHIP_ERROR_FORMAT, err.Format());
+    }
+}
+
+void CoalescingPersistentStorageDelegate::OnFlushTimer(System::Layer *, void * me)
+{
+    LogErrorOnFailure(static_cast<CoalescingPersistentStorageDelegate *>(me)->Flush());
+}
+
+} // namespace app
+} // namespace chip
@@ -0,0 +1,128 @@
+/*
+ *
+ *    Copyright (c) 2024 Project CHIP Authors
+ *
+ *    Licensed under the Apache License, Version 2.0 (the "License");
+ *    you may not use this file except in compliance with the License.
+ *    You may obtain a copy of the License at
+ *
+ *        http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *    Unless required by applicable law or agreed to in writing, software
+ *    distributed under the License is distributed on an "AS IS" BASIS,
+ *    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *    See the License for the specific language governing permissions and
+ *    limitations under the License.
+ */
+
+#pragma once
+
+#include <lib/core/CHIPConfig.h>
+#include <lib/core/CHIPPersistentStorageDelegate.h>
+#include <lib/support/ScopedBuffer.h>
+#include <system/SystemClock.h>
+#include <system/SystemLayer.h>
+
+namespace chip {
+namespace app {
+
+/**
+ * Decorator class for the PersistentStorageDelegate implementation that
+ * coalesces writes of selected keys.
+ *
+ * Writes and deletes of coalesced keys are kept in memory and written to the
+ * decorated storage, in the order of their latest write, when the flush
+ * interval, started by the first pending write, expires. A key that is written
+ * several times within the interval is therefore written to flash only once.
+ * Reads of pending keys are served from memory.
+ *
+ * Writes and deletes of any other key act as a barrier: all pending writes
+ * are flushed first, and the operation is then passed to the decorated
+ * storage immediately. A pending write that fails to be flushed at a barrier
+ * is dropped rather than written after the barrier, and never holds back the
+ * barrier's own write. By default only session and subscription resumption
+ * keys are coalesced, so that fabric data, counters and other security
+ * critical keys are never held back. Flush() can be used as an explicit
+ * barrier, e.g. before a shutdown or factory reset.
+ *
+ * Pending writes are lost if the device loses power before they are flushed,
+ * or dropped if the decorated storage keeps failing to write them. This is
+ * only acceptable for data that can be recreated, such as resumption state,
+ * which at worst costs a full CASE handshake or a new subscription.
+ */
+class CoalescingPersistentStorageDelegate : public PersistentStorageDelegate
+{
+public:
+    using KeyPredicate = bool (*)(const char * key);
+
+    static constexpr size_t kMaxPendingWrites = CHIP_CONFIG_PERSISTENT_STORAGE_MAX_PENDING_WRITES;
+
+    /// Number of flushes a pending write may fail before it is dropped.
+    static constexpr uint8_t kMaxFlushAttempts = 3;
+
+    CoalescingPersistentStorageDelegate(PersistentStorageDelegate & storage, System::Layer & systemLayer,
+                                        System::Clock::Milliseconds32 flushInterval,
+                                        KeyPredicate isCoalescedKey = IsResumptionKey) :
+        mStorage(storage),
+        mSystemLayer(systemLayer), mFlushInterval(flushInterval), mIsCoalescedKey(isCoalescedKey)
+    {}
+    ~CoalescingPersistentStorageDelegate() override;
+
+    CHIP_ERROR SyncGetKeyValue(const char * key, void * buffer, uint16_t & size) override;
+    CHIP_ERROR SyncSetKeyValue(const char * key, const void * value, uint16_t size) override;
+    CHIP_ERROR SyncDeleteKeyValue(const char * key) override;
+    bool SyncDoesKeyExist(const char * key) override;
+
+    /**
+     * Write all pending writes and deletes to the decorated storage.
+     *
+     * Entries are written in the order of their latest write. Entries that
+     * fail to be written are kept pending and retried on the next flush,
+     * until they have failed kMaxFlushAttempts times and are dropped.
+     * Returns the first error encountered.
+     */
+    CHIP_ERROR Flush();
+
+    /// Number of keys with a write or delete that has not been flushed yet.
+    size_t GetPendingWriteCount() const;
+
+    /// Matches the keys of DefaultSessionResumptionStorage and SimpleSubscriptionResumptionStorage.
+    static bool IsResumptionKey(const char * key);
+
+private:
+    enum class EntryState : uint8_t
+    {
+        kFree,
+        kSet,
+        kDelete,
+    };
+
+    struct PendingWrite
+    {
+        char key[kKeyLengthMax + 1];
+        Platform::ScopedMemoryBufferWithSize<uint8_t> value;
+        EntryState state      = EntryState::kFree;
+        uint32_t sequence     = 0; // Order of the latest write or delete of the key
+        uint8_t failedFlushes = 0;
+    };
+
+    PendingWrite * FindPendingWrite(const char * key);
+    PendingWrite * AllocatePendingWrite(const char * key);
+    void MarkWritten(PendingWrite & entry);
+    void FreePendingWrite(PendingWrite & entry);
+    void FlushBeforeBarrier(const char * key);
+    bool IsCoalescedKey(const char * key) const;
+    void ScheduleFlush();
+
+    static void OnFlushTimer(System::Layer * layer, void * me);
+
+    PersistentStorageDelegate & mStorage;
+    System::Layer & mSystemLayer;
+    const System::Clock::Milliseconds32 mFlushInterval;
+    const KeyPredicate mIsCoalescedKey;
+    PendingWrite mPendingWrites[kMaxPendingWrites];
+    uint32_t mNextSequence = 0;
+};
+
+} // namespace app
+} // namespace chip
@@ -525,7 +525,7 @@ Status CommandHandlerImpl::ProcessGroupCommandDataIB(CommandDataIB::Parser & aCo
     // always have an accessing fabric, by definition.
 
     // Find which endpoints can process the command, and dispatch to them.
-    iterator = groupDataProvider->IterateEndpoints(fabric);
+    iterator = groupDataProvider->IterateEndpoints(fabric, std::make_optional(groupId));
     VerifyOrReturnError(iterator != nullptr, Status::Failure);
 
     while (iterator->Next(mapping))
@@ -191,6 +191,13 @@ public:
 
     reporting::Engine & GetReportingEngine() { return mReportingEngine; }
 
+#if CHIP_CONFIG_IM_REPORTING_STATISTICS
+    /**
+     * Returns a snapshot of the reporting engine counters and timings, e.g. to export them as telemetry.
+     */
+    reporting::ReportingStatistics GetReportingStatistics() const { return mReportingEngine.GetStatistics(); }
+#endif // CHIP_CONFIG_IM_REPORTING_STATISTICS
+
     reporting::ReportScheduler * GetReportScheduler() { return mReportScheduler; }
 
     void ReleaseAttributePathList(SingleLinkedListNode<AttributePathParams> *& aAttributePathList);
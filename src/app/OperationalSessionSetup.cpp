@@ -608,6 +608,8 @@ CHIP_ERROR OperationalSessionSetup::LookupPeerAddress()
     PeerId peerId(fabricInfo->GetCompressedFabricId(), mPeerId.GetNodeId());
 
     NodeLookupRequest request(peerId);
+    request.SetAllowCachedResult(!mPerformingAddressUpdate && !mHasLookedUpAddress);
+    mHasLookedUpAddress = true;
 
     return Resolver::Instance().LookupNode(request, mAddressLookupHandle);
 }
@@ -322,6 +322,10 @@ private:
 
     bool mPerformingAddressUpdate = false;
 
+    // Only the first address lookup may be answered from the resolver's cache:
+    // any later lookup happens because the address we have did not work.
+    bool mHasLookedUpAddress = false;
+
 #if CHIP_DEVICE_CONFIG_ENABLE_AUTOMATIC_CASE_RETRIES || CHIP_CONFIG_ENABLE_BUSY_HANDLING_FOR_OPERATIONAL_SESSION_SETUP
     System::Clock::Milliseconds16 mRequestedBusyDelay = System::Clock::kZero;
 #endif // CHIP_DEVICE_CONFIG_ENABLE_AUTOMATIC_CASE_RETRIES || CHIP_CONFIG_ENABLE_BUSY_HANDLING_FOR_OPERATIONAL_SESSION_SETUP
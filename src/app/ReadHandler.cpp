@@ -335,6 +335,19 @@ CHIP_ERROR ReadHandler::SendReportData(System::PacketBufferHandle && aPayload, b
     {
         mCurrentReportsBeginGeneration =
             mManagementCallback.GetInteractionModelEngine()->GetReportingEngine().GetDirtySetGeneration();
+
+#if CHIP_CONFIG_IM_REPORTING_STATISTICS
+        if (mFlags.Has(ReadHandlerFlags::AttributeChangePending))
+        {
+            // Reads and priming reports do not wait for changes, so only other subscription reports have a meaningful latency.
+            if (IsType(InteractionType::Subscribe) && !IsPriming())
+            {
+                mManagementCallback.GetInteractionModelEngine()->GetReportingEngine().RecordReportLatency(
+                    System::SystemClock().GetMonotonicTimestamp() - mFirstAttributeChangeTimestamp);
+            }
+            mFlags.Clear(ReadHandlerFlags::AttributeChangePending);
+        }
+#endif // CHIP_CONFIG_IM_REPORTING_STATISTICS
     }
     SetStateFlag(ReadHandlerFlags::ChunkedReport, aMoreChunks);
     bool responseExpected = IsType(InteractionType::Subscribe) || aMoreChunks;
@@ -861,6 +874,14 @@ void ReadHandler::AttributePathIsDirty(const AttributePathParams & aAttributeCha
 
     mDirtyGeneration = mManagementCallback.GetInteractionModelEngine()->GetReportingEngine().GetDirtySetGeneration();
 
+#if CHIP_CONFIG_IM_REPORTING_STATISTICS
+    if (!mFlags.Has(ReadHandlerFlags::AttributeChangePending))
+    {
+        mFlags.Set(ReadHandlerFlags::AttributeChangePending);
+        mFirstAttributeChangeTimestamp = System::SystemClock().GetMonotonicTimestamp();
+    }
+#endif // CHIP_CONFIG_IM_REPORTING_STATISTICS
+
     // We won't reset the path iterator for every AttributePathIsDirty call to reduce the number of full data reports.
     // The iterator will be reset after finishing each report session.
     //
@@ -306,6 +306,9 @@ private:
 
         // Don't need the response for report data if true
         SuppressResponse = (1 << 5),
+
+        // An attribute we're interested in changed since we started the last report, at mFirstAttributeChangeTimestamp
+        AttributeChangePending = (1 << 6),
     };
 
     /**
@@ -569,6 +572,11 @@ private:
 
     uint32_t mLastWrittenEventsBytes = 0;
 
+#if CHIP_CONFIG_IM_REPORTING_STATISTICS
+    // Time of the first AttributePathIsDirty call since we started the last report, used to measure the report latency.
+    System::Clock::Timestamp mFirstAttributeChangeTimestamp = System::Clock::kZero;
+#endif
+
     // The detailed encoding state for a single attribute, used by list chunking feature.
     // The size of AttributeEncoderState is 2 bytes for now.
     AttributeEncodeState mAttributeEncoderState;
@@ -18,16 +18,19 @@
 /**
  *    @file
  *      This file defines a basic implementation of SubscriptionResumptionStorage that
- *      persists subscriptions in a flat list in TLV.
+ *      persists all subscriptions in a single compact table.
  */
 
 #include <app/SimpleSubscriptionResumptionStorage.h>
 
-#include <lib/support/Base64.h>
+#include <lib/support/BufferWriter.h>
 #include <lib/support/CodeUtils.h>
 #include <lib/support/SafeInt.h>
 #include <lib/support/logging/CHIPLogging.h>
 
+#include <algorithm>
+#include <cstring>
+
 namespace chip {
 namespace app {
 
@@ -48,39 +51,688 @@ constexpr TLV::Tag SimpleSubscriptionResumptionStorage::kEventIdTag;
 constexpr TLV::Tag SimpleSubscriptionResumptionStorage::kEventPathTypeTag;
 constexpr TLV::Tag SimpleSubscriptionResumptionStorage::kResumptionRetriesTag;
 
-SimpleSubscriptionResumptionStorage::SimpleSubscriptionInfoIterator::SimpleSubscriptionInfoIterator(
-    SimpleSubscriptionResumptionStorage & storage) :
-    mStorage(storage)
+namespace {
+
+using Encoding::LittleEndian::BufferWriter;
+
+// Entry flags
+constexpr uint8_t kFabricFilteredFlag = 0x01;
+
+// Path flags
+constexpr uint8_t kEndpointWildcardFlag = 0x01;
+constexpr uint8_t kEndpointRepeatedFlag = 0x02;
+constexpr uint8_t kClusterWildcardFlag  = 0x04;
+constexpr uint8_t kClusterRepeatedFlag  = 0x08;
+constexpr uint8_t kIdWildcardFlag       = 0x10;
+constexpr uint8_t kIdDeltaFlag          = 0x20;
+constexpr uint8_t kUrgentFlag           = 0x40;
+constexpr uint8_t kAllPathFlags         = 0x7F;
+
+// Largest zigzag encoded difference between two 32-bit IDs.
+constexpr uint64_t kMaxIdDelta = (static_cast<uint64_t>(UINT32_MAX) << 1);
+
+static_assert(kInvalidEventId == kInvalidAttributeId, "Attribute and event paths share the ID wildcard");
+constexpr uint32_t kWildcardId = kInvalidAttributeId;
+
+using SubscriptionInfo = SubscriptionResumptionStorage::SubscriptionInfo;
+
+void WriteVarint(BufferWriter & writer, uint64_t value)
 {
-    mNextIndex = 0;
+    while (value >= 0x80)
+    {
+        writer.Put8(static_cast<uint8_t>(value | 0x80));
+        value >>= 7;
+    }
+    writer.Put8(static_cast<uint8_t>(value));
 }
 
-size_t SimpleSubscriptionResumptionStorage::SimpleSubscriptionInfoIterator::Count()
+// Readers provide Read8(), Skip() and Remaining(), the latter being an upper bound.
+template <typename Reader>
+CHIP_ERROR ReadRawVarint(Reader & reader, uint64_t & value)
 {
-    return static_cast<size_t>(mStorage.Count());
+    value = 0;
+    for (unsigned shift = 0; shift < 64; shift += 7)
+    {
+        uint8_t byte;
+        ReturnErrorOnFailure(reader.Read8(byte));
+        value |= static_cast<uint64_t>(byte & 0x7F) << shift;
+        VerifyOrReturnError((byte & 0x80) != 0, CHIP_NO_ERROR);
+    }
+    return CHIP_ERROR_DECODE_FAILED;
 }
 
-bool SimpleSubscriptionResumptionStorage::SimpleSubscriptionInfoIterator::Next(SubscriptionInfo & output)
+template <typename Reader, typename T>
+CHIP_ERROR ReadVarint(Reader & reader, T & value)
+{
+    uint64_t rawValue;
+    ReturnErrorOnFailure(ReadRawVarint(reader, rawValue));
+    VerifyOrReturnError(CanCastTo<T>(rawValue), CHIP_ERROR_DECODE_FAILED);
+    value = static_cast<T>(rawValue);
+    return CHIP_NO_ERROR;
+}
+
+/**
+ * Encodes a list of paths, each relative to the previous one.
+ */
+class PathEncoder
 {
-    for (; mNextIndex < CHIP_IM_MAX_NUM_SUBSCRIPTIONS; mNextIndex++)
+public:
+    void Encode(BufferWriter & writer, EndpointId endpoint, ClusterId cluster, uint32_t id, bool isUrgent)
     {
-        CHIP_ERROR err = mStorage.Load(mNextIndex, output);
-        if (err == CHIP_NO_ERROR)
+        uint8_t flags = isUrgent ? kUrgentFlag : 0;
+
+        if (endpoint == kInvalidEndpointId)
+        {
+            flags |= kEndpointWildcardFlag;
+        }
+        else if (mHasPrevious && endpoint == mEndpoint)
+        {
+            flags |= kEndpointRepeatedFlag;
+        }
+
+        if (cluster == kInvalidClusterId)
+        {
+            flags |= kClusterWildcardFlag;
+        }
+        else if (mHasPrevious && cluster == mCluster)
+        {
+            flags |= kClusterRepeatedFlag;
+        }
+
+        if (id == kWildcardId)
+        {
+            flags |= kIdWildcardFlag;
+        }
+        else if (mHasPrevious && cluster == mCluster && mId != kWildcardId)
+        {
+            flags |= kIdDeltaFlag;
+        }
+
+        writer.Put8(flags);
+        if ((flags & (kEndpointWildcardFlag | kEndpointRepeatedFlag)) == 0)
+        {
+            WriteVarint(writer, endpoint);
+        }
+        if ((flags & (kClusterWildcardFlag | kClusterRepeatedFlag)) == 0)
+        {
+            WriteVarint(writer, cluster);
+        }
+        if ((flags & kIdDeltaFlag) != 0)
+        {
+            // Zigzag encoding, so that small negative differences are small too.
+            WriteVarint(writer,
+                        (id >= mId) ? (static_cast<uint64_t>(id - mId) << 1) : ((static_cast<uint64_t>(mId - id) << 1) - 1));
+        }
+        else if ((flags & kIdWildcardFlag) == 0)
+        {
+            WriteVarint(writer, id);
+        }
+
+        mHasPrevious = true;
+        mEndpoint    = endpoint;
+        mCluster     = cluster;
+        mId          = id;
+    }
+
+private:
+    bool mHasPrevious = false;
+    EndpointId mEndpoint;
+    ClusterId mCluster;
+    uint32_t mId;
+};
+
+/**
+ * Decodes a list of paths written by PathEncoder.
+ */
+class PathDecoder
+{
+public:
+    template <typename Reader>
+    CHIP_ERROR Decode(Reader & reader, EndpointId & endpoint, ClusterId & cluster, uint32_t & id, bool & isUrgent)
+    {
+        uint8_t flags;
+        ReturnErrorOnFailure(reader.Read8(flags));
+        VerifyOrReturnError((flags & ~kAllPathFlags) == 0, CHIP_ERROR_DECODE_FAILED);
+        VerifyOrReturnError(mHasPrevious || (flags & (kEndpointRepeatedFlag | kClusterRepeatedFlag | kIdDeltaFlag)) == 0,
+                            CHIP_ERROR_DECODE_FAILED);
+
+        if ((flags & kEndpointWildcardFlag) != 0)
+        {
+            endpoint = kInvalidEndpointId;
+        }
+        else if ((flags & kEndpointRepeatedFlag) != 0)
+        {
+            endpoint = mEndpoint;
+        }
+        else
+        {
+            ReturnErrorOnFailure(ReadVarint(reader, endpoint));
+        }
+
+        if ((flags & kClusterWildcardFlag) != 0)
+        {
+            cluster = kInvalidClusterId;
+        }
+        else if ((flags & kClusterRepeatedFlag) != 0)
+        {
+            cluster = mCluster;
+        }
+        else
+        {
+            ReturnErrorOnFailure(ReadVarint(reader, cluster));
+        }
+
+        if ((flags & kIdWildcardFlag) != 0)
+        {
+            id = kWildcardId;
+        }
+        else if ((flags & kIdDeltaFlag) != 0)
+        {
+            VerifyOrReturnError(mId != kWildcardId, CHIP_ERROR_DECODE_FAILED);
+            uint64_t delta;
+            ReturnErrorOnFailure(ReadRawVarint(reader, delta));
+            VerifyOrReturnError(delta <= kMaxIdDelta, CHIP_ERROR_DECODE_FAILED);
+            const int64_t value = static_cast<int64_t>(mId) +
+                (((delta & 1) != 0) ? -static_cast<int64_t>((delta >> 1) + 1) : static_cast<int64_t>(delta >> 1));
+            VerifyOrReturnError(CanCastTo<uint32_t>(value), CHIP_ERROR_DECODE_FAILED);
+            id = static_cast<uint32_t>(value);
+        }
+        else
+        {
+            ReturnErrorOnFailure(ReadVarint(reader, id));
+        }
+
+        isUrgent = (flags & kUrgentFlag) != 0;
+
+        mHasPrevious = true;
+        mEndpoint    = endpoint;
+        mCluster     = cluster;
+        mId          = id;
+        return CHIP_NO_ERROR;
+    }
+
+private:
+    bool mHasPrevious = false;
+    EndpointId mEndpoint;
+    ClusterId mCluster;
+    uint32_t mId;
+};
+
+void EncodeEntryBody(BufferWriter & writer, const SubscriptionInfo & subscriptionInfo)
+{
+    WriteVarint(writer, subscriptionInfo.mNodeId);
+    WriteVarint(writer, subscriptionInfo.mFabricIndex);
+    WriteVarint(writer, subscriptionInfo.mSubscriptionId);
+    WriteVarint(writer, subscriptionInfo.mMinInterval);
+    WriteVarint(writer, subscriptionInfo.mMaxInterval);
+    writer.Put8(subscriptionInfo.mFabricFiltered ? kFabricFilteredFlag : 0);
+#if CHIP_CONFIG_SUBSCRIPTION_TIMEOUT_RESUMPTION
+    WriteVarint(writer, subscriptionInfo.mResumptionRetries);
+#else
+    WriteVarint(writer, 0);
+#endif // CHIP_CONFIG_SUBSCRIPTION_TIMEOUT_RESUMPTION
+
+    WriteVarint(writer, subscriptionInfo.mAttributePaths.AllocatedSize());
+    PathEncoder attributePathEncoder;
+    for (size_t pathIndex = 0; pathIndex < subscriptionInfo.mAttributePaths.AllocatedSize(); pathIndex++)
+    {
+        const auto & path = subscriptionInfo.mAttributePaths[pathIndex];
+        attributePathEncoder.Encode(writer, path.mEndpointId, path.mClusterId, path.mAttributeId, false);
+    }
+
+    WriteVarint(writer, subscriptionInfo.mEventPaths.AllocatedSize());
+    PathEncoder eventPathEncoder;
+    for (size_t pathIndex = 0; pathIndex < subscriptionInfo.mEventPaths.AllocatedSize(); pathIndex++)
+    {
+        const auto & path = subscriptionInfo.mEventPaths[pathIndex];
+        eventPathEncoder.Encode(writer, path.mEndpointId, path.mClusterId, path.mEventId, path.mIsUrgentEvent);
+    }
+}
+
+// Keeps the buffer of the previous entry when iterating with the same SubscriptionInfo.
+template <typename T>
+CHIP_ERROR AllocatePaths(Platform::ScopedMemoryBufferWithSize<T> & paths, size_t count)
+{
+    VerifyOrReturnError(paths.AllocatedSize() != count, CHIP_NO_ERROR);
+
+    paths.Free();
+    VerifyOrReturnError(count > 0, CHIP_NO_ERROR);
+
+    paths.Calloc(count);
+    VerifyOrReturnError(paths.Get() != nullptr, CHIP_ERROR_NO_MEMORY);
+    return CHIP_NO_ERROR;
+}
+
+bool IsSameSubscription(const SubscriptionInfo & subscriptionInfo, NodeId nodeId, FabricIndex fabricIndex,
+                        SubscriptionId subscriptionId)
+{
+    return (subscriptionInfo.mNodeId == nodeId) && (subscriptionInfo.mFabricIndex == fabricIndex) &&
+        (subscriptionInfo.mSubscriptionId == subscriptionId);
+}
+
+/**
+ * Reads entries from the in-memory copy of the table.
+ */
+class MemoryReader
+{
+public:
+    MemoryReader(const uint8_t * buffer, size_t length) : mBuffer(buffer), mLength(length) {}
+
+    CHIP_ERROR Read8(uint8_t & value)
+    {
+        VerifyOrReturnError(mOffset < mLength, CHIP_ERROR_DECODE_FAILED);
+        value = mBuffer[mOffset++];
+        return CHIP_NO_ERROR;
+    }
+
+    CHIP_ERROR Skip(size_t size)
+    {
+        VerifyOrReturnError(size <= Remaining(), CHIP_ERROR_DECODE_FAILED);
+        mOffset += size;
+        return CHIP_NO_ERROR;
+    }
+
+    size_t Remaining() const { return mLength - mOffset; }
+    size_t GetOffset() const { return mOffset; }
+
+private:
+    const uint8_t * mBuffer;
+    size_t mLength;
+    size_t mOffset = 0;
+};
+
+/**
+ * Reads the body of an entry, which ends before the underlying reader does.
+ */
+template <typename Reader>
+class EntryBodyReader
+{
+public:
+    EntryBodyReader(Reader & reader, size_t size) : mReader(reader), mRemaining(size) {}
+
+    CHIP_ERROR Read8(uint8_t & value)
+    {
+        VerifyOrReturnError(mRemaining > 0, CHIP_ERROR_DECODE_FAILED);
+        mRemaining--;
+        return mReader.Read8(value);
+    }
+
+    size_t Remaining() const { return mRemaining; }
+
+private:
+    Reader & mReader;
+    size_t mRemaining;
+};
+
+/**
+ * Decode the next entry of `entries`. Path buffers of `subscriptionInfo` are only reallocated
+ * if the path counts differ.
+ */
+template <typename Reader>
+CHIP_ERROR DecodeEntry(Reader & entries, SubscriptionInfo & subscriptionInfo, bool decodePaths)
+{
+    size_t bodySize;
+    ReturnErrorOnFailure(ReadVarint(entries, bodySize));
+    VerifyOrReturnError(bodySize <= entries.Remaining(), CHIP_ERROR_DECODE_FAILED);
+
+    EntryBodyReader<Reader> reader(entries, bodySize);
+    ReturnErrorOnFailure(ReadVarint(reader, subscriptionInfo.mNodeId));
+    ReturnErrorOnFailure(ReadVarint(reader, subscriptionInfo.mFabricIndex));
+    ReturnErrorOnFailure(ReadVarint(reader, subscriptionInfo.mSubscriptionId));
+    ReturnErrorOnFailure(ReadVarint(reader, subscriptionInfo.mMinInterval));
+    ReturnErrorOnFailure(ReadVarint(reader, subscriptionInfo.mMaxInterval));
+
+    uint8_t flags;
+    ReturnErrorOnFailure(reader.Read8(flags));
+    subscriptionInfo.mFabricFiltered = (flags & kFabricFilteredFlag) != 0;
+
+    uint32_t resumptionRetries;
+    ReturnErrorOnFailure(ReadVarint(reader, resumptionRetries));
+#if CHIP_CONFIG_SUBSCRIPTION_TIMEOUT_RESUMPTION
+    subscriptionInfo.mResumptionRetries = resumptionRetries;
+#endif // CHIP_CONFIG_SUBSCRIPTION_TIMEOUT_RESUMPTION
+
+    // Every path takes at least one byte, which bounds the counts before allocating.
+    size_t pathCount;
+    ReturnErrorOnFailure(ReadVarint(reader, pathCount));
+    VerifyOrReturnError(pathCount <= reader.Remaining(), CHIP_ERROR_DECODE_FAILED);
+    if (decodePaths)
+    {
+        ReturnErrorOnFailure(AllocatePaths(subscriptionInfo.mAttributePaths, pathCount));
+    }
+
+    PathDecoder attributePathDecoder;
+    for (size_t pathIndex = 0; pathIndex < pathCount; pathIndex++)
+    {
+        EndpointId endpoint;
+        ClusterId cluster;
+        AttributeId attribute;
+        bool isUrgent;
+        ReturnErrorOnFailure(attributePathDecoder.Decode(reader, endpoint, cluster, attribute, isUrgent));
+        VerifyOrReturnError(!isUrgent, CHIP_ERROR_DECODE_FAILED);
+
+        if (decodePaths)
+        {
+            subscriptionInfo.mAttributePaths[pathIndex].mEndpointId  = endpoint;
+            subscriptionInfo.mAttributePaths[pathIndex].mClusterId   = cluster;
+            subscriptionInfo.mAttributePaths[pathIndex].mAttributeId = attribute;
+        }
+    }
+
+    ReturnErrorOnFailure(ReadVarint(reader, pathCount));
+    VerifyOrReturnError(pathCount <= reader.Remaining(), CHIP_ERROR_DECODE_FAILED);
+    if (decodePaths)
+    {
+        ReturnErrorOnFailure(AllocatePaths(subscriptionInfo.mEventPaths, pathCount));
+    }
+
+    PathDecoder eventPathDecoder;
+    for (size_t pathIndex = 0; pathIndex < pathCount; pathIndex++)
+    {
+        EndpointId endpoint;
+        ClusterId cluster;
+        EventId event;
+        bool isUrgent;
+        ReturnErrorOnFailure(eventPathDecoder.Decode(reader, endpoint, cluster, event, isUrgent));
+
+        if (decodePaths)
+        {
+            subscriptionInfo.mEventPaths[pathIndex].mEndpointId    = endpoint;
+            subscriptionInfo.mEventPaths[pathIndex].mClusterId     = cluster;
+            subscriptionInfo.mEventPaths[pathIndex].mEventId       = event;
+            subscriptionInfo.mEventPaths[pathIndex].mIsUrgentEvent = isUrgent;
+        }
+    }
+
+    // Anything left in the entry was added by a later version of the format.
+    return entries.Skip(reader.Remaining());
+}
+
+} // namespace
+
+CHIP_ERROR SimpleSubscriptionResumptionStorage::TableReader::Open(PersistentStorageDelegate & storage)
+{
+    Close();
+    mStorage = &storage;
+
+    mShard.Alloc(kShardSize);
+    VerifyOrReturnError(mShard.Get() != nullptr, CHIP_ERROR_NO_MEMORY);
+
+    CHIP_ERROR err = LoadShard(0);
+    if (err == CHIP_ERROR_PERSISTED_STORAGE_VALUE_NOT_FOUND)
+    {
+        Close();
+        return CHIP_NO_ERROR;
+    }
+    return err;
+}
+
+void SimpleSubscriptionResumptionStorage::TableReader::Close()
+{
+    mShard.Free();
+    mLength     = 0;
+    mOffset     = 0;
+    mShardIndex = 0;
+    mShardCount = 0;
+}
+
+CHIP_ERROR SimpleSubscriptionResumptionStorage::TableReader::LoadShard(uint8_t shardIndex)
+{
+    uint16_t len = static_cast<uint16_t>(kShardSize);
+    CHIP_ERROR err =
+        mStorage->SyncGetKeyValue(DefaultStorageKeyAllocator::SubscriptionResumptionTable(shardIndex).KeyName(), mShard.Get(), len);
+    if (shardIndex > 0 && err == CHIP_ERROR_PERSISTED_STORAGE_VALUE_NOT_FOUND)
+    {
+        return CHIP_ERROR_DECODE_FAILED;
+    }
+    // Written by a build with larger shards.
+    VerifyOrReturnError(err != CHIP_ERROR_BUFFER_TOO_SMALL, CHIP_ERROR_DECODE_FAILED);
+    ReturnErrorOnFailure(err);
+
+    VerifyOrReturnError(len > kShardHeaderSize && mShard[0] == kTableVersion, CHIP_ERROR_DECODE_FAILED);
+    if (shardIndex == 0)
+    {
+        mGeneration = mShard[1];
+        mShardCount = mShard[2];
+    }
+    VerifyOrReturnError(mShard[1] == mGeneration && mShard[2] == mShardCount && shardIndex < mShardCount,
+                        CHIP_ERROR_DECODE_FAILED);
+
+    mShardIndex = shardIndex;
+    mLength     = len;
+    mOffset     = kShardHeaderSize;
+    return CHIP_NO_ERROR;
+}
+
+CHIP_ERROR SimpleSubscriptionResumptionStorage::TableReader::Read8(uint8_t & value)
+{
+    if (mOffset == mLength)
+    {
+        VerifyOrReturnError(mShardIndex + 1u < mShardCount, CHIP_ERROR_DECODE_FAILED);
+        ReturnErrorOnFailure(LoadShard(static_cast<uint8_t>(mShardIndex + 1)));
+    }
+
+    value = mShard[mOffset++];
+    return CHIP_NO_ERROR;
+}
+
+CHIP_ERROR SimpleSubscriptionResumptionStorage::TableReader::Skip(size_t size)
+{
+    for (; size > 0; size--)
+    {
+        uint8_t value;
+        ReturnErrorOnFailure(Read8(value));
+    }
+    return CHIP_NO_ERROR;
+}
+
+size_t SimpleSubscriptionResumptionStorage::TableReader::Remaining() const
+{
+    VerifyOrReturnValue(mShardIndex < mShardCount, 0);
+    return (mLength - mOffset) + (mShardCount - mShardIndex - 1u) * kShardPayloadSize;
+}
+
+CHIP_ERROR SimpleSubscriptionResumptionStorage::Table::Load(PersistentStorageDelegate & storage)
+{
+    if (!IsLoaded())
+    {
+        mBuffer.Alloc(MaxTableSize());
+        VerifyOrReturnError(mBuffer.Get() != nullptr, CHIP_ERROR_NO_MEMORY);
+    }
+
+    TableReader reader;
+    CHIP_ERROR err = reader.Open(storage);
+    if (err == CHIP_ERROR_DECODE_FAILED)
+    {
+        ChipLogError(DataManagement, "Invalid subscription resumption table, dropping all subscriptions");
+        Reset();
+        // The shard count cannot be trusted: remove any shard when storing.
+        mStoredShardCount = UINT8_MAX;
+        return CHIP_NO_ERROR;
+    }
+    ReturnErrorOnFailure(err);
+
+    mLength           = kEntriesOffset;
+    mCount            = 0;
+    mGeneration       = reader.GetGeneration();
+    mStoredShardCount = reader.GetShardCount();
+    mModified         = false;
+
+    while (!reader.AtEnd())
+    {
+        if (mLength == MaxTableSize())
         {
-            // increment index for the next call
-            mNextIndex++;
-            return true;
+            // Written by a build supporting more subscriptions: keep the entries that fit.
+            ChipLogError(DataManagement, "Subscription resumption table too large, dropping the last subscriptions");
+            mModified = true;
+            break;
         }
 
-        if (err != CHIP_ERROR_PERSISTED_STORAGE_VALUE_NOT_FOUND)
+        err = reader.Read8(mBuffer[mLength]);
+        if (err == CHIP_ERROR_DECODE_FAILED)
+        {
+            // A shard is missing, e.g. after an interrupted write: keep the entries read so far.
+            mModified = true;
+            break;
+        }
+        ReturnErrorOnFailure(err);
+        mLength++;
+    }
+
+    // Check every entry once, so that later accesses only fail on memory allocation.
+    size_t offset = kEntriesOffset;
+    while (offset < mLength)
+    {
+        SubscriptionInfo subscriptionInfo;
+        size_t entrySize;
+        err = Decode(offset, subscriptionInfo, entrySize, /* decodePaths = */ false);
+        if (err != CHIP_NO_ERROR)
         {
-            ChipLogError(DataManagement, "Failed to load subscription at index %u error %" CHIP_ERROR_FORMAT,
-                         static_cast<unsigned>(mNextIndex), err.Format());
-            mStorage.Delete(mNextIndex);
+            ChipLogError(DataManagement, "Failed to load subscription %u error %" CHIP_ERROR_FORMAT, static_cast<unsigned>(mCount),
+                         err.Format());
+            mLength   = offset;
+            mModified = true;
+            break;
         }
+        offset += entrySize;
+        mCount++;
     }
 
-    return false;
+    return CHIP_NO_ERROR;
+}
+
+CHIP_ERROR SimpleSubscriptionResumptionStorage::Table::Store(PersistentStorageDelegate & storage)
+{
+    static_assert(kShardSize > kShardHeaderSize && kShardSize <= UINT16_MAX, "Invalid subscription resumption shard size");
+    static_assert(MaxTableSize() <= UINT8_MAX * kShardPayloadSize, "The subscription resumption table has too many shards");
+
+    VerifyOrReturnError(IsLoaded(), CHIP_ERROR_INCORRECT_STATE);
+
+    const uint8_t shardCount = static_cast<uint8_t>((mCount == 0) ? 0 : (mLength + kShardPayloadSize - 1) / kShardPayloadSize);
+    if (shardCount > 0)
+    {
+        Platform::ScopedMemoryBuffer<uint8_t> shard;
+        shard.Alloc(kShardSize);
+        VerifyOrReturnError(shard.Get() != nullptr, CHIP_ERROR_NO_MEMORY);
+
+        // An interrupted write leaves the shards written before it, which hold the start of the new table.
+        mGeneration++;
+        for (uint8_t shardIndex = 0; shardIndex < shardCount; shardIndex++)
+        {
+            const size_t offset = shardIndex * kShardPayloadSize;
+            const size_t length = std::min(kShardPayloadSize, mLength - offset);
+
+            shard[0] = kTableVersion;
+            shard[1] = mGeneration;
+            shard[2] = shardCount;
+            memcpy(&shard[kShardHeaderSize], &mBuffer[offset], length);
+
+            const StorageKeyName key = DefaultStorageKeyAllocator::SubscriptionResumptionTable(shardIndex);
+            ReturnErrorOnFailure(
+                storage.SyncSetKeyValue(key.KeyName(), shard.Get(), static_cast<uint16_t>(kShardHeaderSize + length)));
+        }
+    }
+
+    // Remove the shards of a longer table.
+    for (uint8_t shardIndex = shardCount; shardIndex < mStoredShardCount; shardIndex++)
+    {
+        CHIP_ERROR err = storage.SyncDeleteKeyValue(DefaultStorageKeyAllocator::SubscriptionResumptionTable(shardIndex).KeyName());
+        VerifyOrReturnError((err == CHIP_NO_ERROR) || (err == CHIP_ERROR_PERSISTED_STORAGE_VALUE_NOT_FOUND), err);
+    }
+
+    mStoredShardCount = shardCount;
+    mModified         = false;
+    return CHIP_NO_ERROR;
+}
+
+void SimpleSubscriptionResumptionStorage::Table::Release()
+{
+    mBuffer.Free();
+    mLength   = 0;
+    mCount    = 0;
+    mModified = false;
+}
+
+void SimpleSubscriptionResumptionStorage::Table::Reset()
+{
+    mLength   = kEntriesOffset;
+    mCount    = 0;
+    mModified = true;
+}
+
+void SimpleSubscriptionResumptionStorage::Table::Erase(size_t offset, size_t size)
+{
+    memmove(&mBuffer[offset], &mBuffer[offset + size], mLength - offset - size);
+    mLength -= size;
+    mCount--;
+    mModified = true;
+}
+
+CHIP_ERROR SimpleSubscriptionResumptionStorage::Table::Append(const SubscriptionInfo & subscriptionInfo)
+{
+    VerifyOrReturnError(IsLoaded(), CHIP_ERROR_INCORRECT_STATE);
+
+    // Size the entry first, as its length is written ahead of it.
+    BufferWriter sizingWriter(nullptr, 0);
+    EncodeEntryBody(sizingWriter, subscriptionInfo);
+
+    BufferWriter writer(&mBuffer[mLength], MaxTableSize() - mLength);
+    WriteVarint(writer, sizingWriter.Needed());
+    EncodeEntryBody(writer, subscriptionInfo);
+
+    size_t written;
+    VerifyOrReturnError(writer.Fit(written), CHIP_ERROR_BUFFER_TOO_SMALL);
+
+    mLength += written;
+    mCount++;
+    mModified = true;
+    return CHIP_NO_ERROR;
+}
+
+CHIP_ERROR SimpleSubscriptionResumptionStorage::Table::Decode(size_t offset, SubscriptionInfo & subscriptionInfo,
+                                                              size_t & entrySize, bool decodePaths) const
+{
+    VerifyOrReturnError(offset < mLength, CHIP_ERROR_INVALID_ARGUMENT);
+
+    MemoryReader reader(&mBuffer[offset], mLength - offset);
+    ReturnErrorOnFailure(DecodeEntry(reader, subscriptionInfo, decodePaths));
+    entrySize = reader.GetOffset();
+    return CHIP_NO_ERROR;
+}
+
+SimpleSubscriptionResumptionStorage::SimpleSubscriptionInfoIterator::SimpleSubscriptionInfoIterator(
+    SimpleSubscriptionResumptionStorage & storage) :
+    mStorage(storage)
+{}
+
+size_t SimpleSubscriptionResumptionStorage::SimpleSubscriptionInfoIterator::Count()
+{
+    // Count without moving this iterator, reading the table once more.
+    TableReader reader;
+    VerifyOrReturnValue(reader.Open(*mStorage.mStorage) == CHIP_NO_ERROR, 0);
+
+    size_t count = 0;
+    SubscriptionInfo subscriptionInfo;
+    while (!reader.AtEnd() && DecodeEntry(reader, subscriptionInfo, /* decodePaths = */ false) == CHIP_NO_ERROR)
+    {
+        count++;
+    }
+    return count;
+}
+
+bool SimpleSubscriptionResumptionStorage::SimpleSubscriptionInfoIterator::Next(SubscriptionInfo & output)
+{
+    VerifyOrReturnValue(!mReader.AtEnd(), false);
+
+    CHIP_ERROR err = DecodeEntry(mReader, output, /* decodePaths = */ true);
+    if (err != CHIP_NO_ERROR)
+    {
+        ChipLogError(DataManagement, "Failed to load subscription error %" CHIP_ERROR_FORMAT, err.Format());
+        mReader.Close();
+        mStorage.RepairTable();
+        return false;
+    }
+    return true;
 }
 
 void SimpleSubscriptionResumptionStorage::SimpleSubscriptionInfoIterator::Release()
@@ -93,53 +745,96 @@ CHIP_ERROR SimpleSubscriptionResumptionStorage::Init(PersistentStorageDelegate *
     VerifyOrReturnError(storage != nullptr, CHIP_ERROR_INVALID_ARGUMENT);
     mStorage = storage;
 
+    return MigrateLegacySubscriptions();
+}
+
+CHIP_ERROR SimpleSubscriptionResumptionStorage::MigrateLegacySubscriptions()
+{
+    // Older releases kept the maximum count for as long as any subscription was persisted.
     uint16_t countMax;
     uint16_t len = sizeof(countMax);
     CHIP_ERROR err =
         mStorage->SyncGetKeyValue(DefaultStorageKeyAllocator::SubscriptionResumptionMaxCount().KeyName(), &countMax, len);
-    // If there's a previous countMax and it's larger than CHIP_IM_MAX_NUM_SUBSCRIPTIONS,
-    // clean up subscriptions beyond the limit
-    if ((err == CHIP_NO_ERROR) && (countMax != CHIP_IM_MAX_NUM_SUBSCRIPTIONS))
+    VerifyOrReturnError(err != CHIP_ERROR_PERSISTED_STORAGE_VALUE_NOT_FOUND, CHIP_NO_ERROR);
+    if ((err != CHIP_NO_ERROR) || (countMax < CHIP_IM_MAX_NUM_SUBSCRIPTIONS))
+    {
+        countMax = CHIP_IM_MAX_NUM_SUBSCRIPTIONS;
+    }
+
+    Table table;
+    ReturnErrorOnFailure(table.Load(*mStorage));
+
+    for (uint16_t subscriptionIndex = 0; subscriptionIndex < CHIP_IM_MAX_NUM_SUBSCRIPTIONS; subscriptionIndex++)
     {
-        for (uint16_t subscriptionIndex = CHIP_IM_MAX_NUM_SUBSCRIPTIONS; subscriptionIndex < countMax; subscriptionIndex++)
+        SubscriptionInfo subscriptionInfo;
+        err = LoadLegacy(subscriptionIndex, subscriptionInfo);
+        if (err == CHIP_ERROR_PERSISTED_STORAGE_VALUE_NOT_FOUND)
+        {
+            continue;
+        }
+
+        if (err == CHIP_NO_ERROR)
         {
-            Delete(subscriptionIndex);
+            table.Remove([&subscriptionInfo](const SubscriptionInfo & entry) {
+                return IsSameSubscription(entry, subscriptionInfo.mNodeId, subscriptionInfo.mFabricIndex,
+                                          subscriptionInfo.mSubscriptionId);
+            });
+            err = (table.Count() < CHIP_IM_MAX_NUM_SUBSCRIPTIONS) ? table.Append(subscriptionInfo) : CHIP_ERROR_NO_MEMORY;
+        }
+        if (err != CHIP_NO_ERROR)
+        {
+            ChipLogError(DataManagement, "Failed to migrate subscription at index %u error %" CHIP_ERROR_FORMAT,
+                         static_cast<unsigned>(subscriptionIndex), err.Format());
         }
     }
 
-    // Always save the current CHIP_IM_MAX_NUM_SUBSCRIPTIONS
-    uint16_t countMaxToSave = CHIP_IM_MAX_NUM_SUBSCRIPTIONS;
-    ReturnErrorOnFailure(mStorage->SyncSetKeyValue(DefaultStorageKeyAllocator::SubscriptionResumptionMaxCount().KeyName(),
-                                                   &countMaxToSave, sizeof(uint16_t)));
+    if (table.IsModified())
+    {
+        ReturnErrorOnFailure(table.Store(*mStorage));
+    }
 
-    return CHIP_NO_ERROR;
+    // Only remove the old keys once the table holding their subscriptions is stored.
+    for (uint16_t subscriptionIndex = 0; subscriptionIndex < countMax; subscriptionIndex++)
+    {
+        mStorage->SyncDeleteKeyValue(DefaultStorageKeyAllocator::SubscriptionResumption(subscriptionIndex).KeyName());
+    }
+    return mStorage->SyncDeleteKeyValue(DefaultStorageKeyAllocator::SubscriptionResumptionMaxCount().KeyName());
 }
 
 SubscriptionResumptionStorage::SubscriptionInfoIterator * SimpleSubscriptionResumptionStorage::IterateSubscriptions()
 {
-    return mSubscriptionInfoIterators.CreateObject(*this);
-}
+    SimpleSubscriptionInfoIterator * iterator = mSubscriptionInfoIterators.CreateObject(*this);
+    VerifyOrReturnValue(iterator != nullptr, nullptr);
 
-uint16_t SimpleSubscriptionResumptionStorage::Count()
-{
-    uint16_t subscriptionCount = 0;
-    for (uint16_t subscriptionIndex = 0; subscriptionIndex < CHIP_IM_MAX_NUM_SUBSCRIPTIONS; subscriptionIndex++)
+    CHIP_ERROR err = iterator->mReader.Open(*mStorage);
+    if (err != CHIP_NO_ERROR)
     {
-        if (mStorage->SyncDoesKeyExist(DefaultStorageKeyAllocator::SubscriptionResumption(subscriptionIndex).KeyName()))
+        ChipLogError(DataManagement, "Failed to load subscription resumption table error %" CHIP_ERROR_FORMAT, err.Format());
+        iterator->mReader.Close();
+        if (err == CHIP_ERROR_DECODE_FAILED)
         {
-            subscriptionCount++;
+            RepairTable();
         }
     }
 
-    return subscriptionCount;
+    return iterator;
 }
 
-CHIP_ERROR SimpleSubscriptionResumptionStorage::Delete(uint16_t subscriptionIndex)
+void SimpleSubscriptionResumptionStorage::RepairTable()
 {
-    return mStorage->SyncDeleteKeyValue(DefaultStorageKeyAllocator::SubscriptionResumption(subscriptionIndex).KeyName());
+    // A batch repairs its own copy of the table, and stores it when it ends.
+    VerifyOrReturn(!mBatch.IsLoaded());
+
+    Table table;
+    CHIP_ERROR err = table.Load(*mStorage);
+    if ((err == CHIP_NO_ERROR) && table.IsModified())
+    {
+        err = table.Store(*mStorage);
+    }
+    LogErrorOnFailure(err);
 }
 
-CHIP_ERROR SimpleSubscriptionResumptionStorage::Load(uint16_t subscriptionIndex, SubscriptionInfo & subscriptionInfo)
+CHIP_ERROR SimpleSubscriptionResumptionStorage::LoadLegacy(uint16_t subscriptionIndex, SubscriptionInfo & subscriptionInfo)
 {
     Platform::ScopedMemoryBuffer<uint8_t> backingBuffer;
     backingBuffer.Calloc(MaxSubscriptionSize());
@@ -270,7 +965,7 @@ CHIP_ERROR SimpleSubscriptionResumptionStorage::Load(uint16_t subscriptionIndex,
     return CHIP_NO_ERROR;
 }
 
-CHIP_ERROR SimpleSubscriptionResumptionStorage::Save(TLV::TLVWriter & writer, SubscriptionInfo & subscriptionInfo)
+CHIP_ERROR SimpleSubscriptionResumptionStorage::SaveLegacy(TLV::TLVWriter & writer, SubscriptionInfo & subscriptionInfo)
 {
     TLV::TLVType subscriptionContainerType;
     ReturnErrorOnFailure(writer.StartContainer(TLV::AnonymousTag(), TLV::kTLVType_Structure, subscriptionContainerType));
@@ -329,155 +1024,71 @@ CHIP_ERROR SimpleSubscriptionResumptionStorage::Save(TLV::TLVWriter & writer, Su
     return CHIP_NO_ERROR;
 }
 
-CHIP_ERROR SimpleSubscriptionResumptionStorage::Save(SubscriptionInfo & subscriptionInfo)
+template <typename Operation>
+CHIP_ERROR SimpleSubscriptionResumptionStorage::Update(Operation && operation)
 {
-    // Find empty index or duplicate if exists
-    uint16_t subscriptionIndex;
-    uint16_t firstEmptySubscriptionIndex = CHIP_IM_MAX_NUM_SUBSCRIPTIONS; // initialize to out of bounds as "not set"
-    for (subscriptionIndex = 0; subscriptionIndex < CHIP_IM_MAX_NUM_SUBSCRIPTIONS; subscriptionIndex++)
+    if (mBatch.IsLoaded())
     {
-        SubscriptionInfo currentSubscriptionInfo;
-        CHIP_ERROR err = Load(subscriptionIndex, currentSubscriptionInfo);
-
-        // if empty and firstEmptySubscriptionIndex isn't set yet, then mark empty spot
-        if ((firstEmptySubscriptionIndex == CHIP_IM_MAX_NUM_SUBSCRIPTIONS) && (err == CHIP_ERROR_PERSISTED_STORAGE_VALUE_NOT_FOUND))
-        {
-            firstEmptySubscriptionIndex = subscriptionIndex;
-        }
-
-        // delete duplicate
-        if (err == CHIP_NO_ERROR)
-        {
-            if ((subscriptionInfo.mNodeId == currentSubscriptionInfo.mNodeId) &&
-                (subscriptionInfo.mFabricIndex == currentSubscriptionInfo.mFabricIndex) &&
-                (subscriptionInfo.mSubscriptionId == currentSubscriptionInfo.mSubscriptionId))
-            {
-                Delete(subscriptionIndex);
-                // if duplicate is the first empty spot, then also set it
-                if (firstEmptySubscriptionIndex == CHIP_IM_MAX_NUM_SUBSCRIPTIONS)
-                {
-                    firstEmptySubscriptionIndex = subscriptionIndex;
-                }
-            }
-        }
+        return operation(mBatch);
     }
 
-    // Fail if no empty space
-    if (firstEmptySubscriptionIndex == CHIP_IM_MAX_NUM_SUBSCRIPTIONS)
-    {
-        return CHIP_ERROR_NO_MEMORY;
-    }
-
-    // Now construct subscription state and save
-    Platform::ScopedMemoryBuffer<uint8_t> backingBuffer;
-    backingBuffer.Calloc(MaxSubscriptionSize());
-    ReturnErrorCodeIf(backingBuffer.Get() == nullptr, CHIP_ERROR_NO_MEMORY);
-
-    TLV::ScopedBufferTLVWriter writer(std::move(backingBuffer), MaxSubscriptionSize());
-
-    ReturnErrorOnFailure(Save(writer, subscriptionInfo));
-
-    const auto len = writer.GetLengthWritten();
-    VerifyOrReturnError(CanCastTo<uint16_t>(len), CHIP_ERROR_BUFFER_TOO_SMALL);
-
-    writer.Finalize(backingBuffer);
-
-    ReturnErrorOnFailure(
-        mStorage->SyncSetKeyValue(DefaultStorageKeyAllocator::SubscriptionResumption(firstEmptySubscriptionIndex).KeyName(),
-                                  backingBuffer.Get(), static_cast<uint16_t>(len)));
+    Table table;
+    ReturnErrorOnFailure(table.Load(*mStorage));
+    ReturnErrorOnFailure(operation(table));
+    VerifyOrReturnError(table.IsModified(), CHIP_NO_ERROR);
+    return table.Store(*mStorage);
+}
 
-    return CHIP_NO_ERROR;
+CHIP_ERROR SimpleSubscriptionResumptionStorage::Save(SubscriptionInfo & subscriptionInfo)
+{
+    return Update([&subscriptionInfo](Table & table) -> CHIP_ERROR {
+        // Replace the subscription if it is already persisted.
+        table.Remove([&subscriptionInfo](const SubscriptionInfo & entry) {
+            return IsSameSubscription(entry, subscriptionInfo.mNodeId, subscriptionInfo.mFabricIndex,
+                                      subscriptionInfo.mSubscriptionId);
+        });
+        VerifyOrReturnError(table.Count() < CHIP_IM_MAX_NUM_SUBSCRIPTIONS, CHIP_ERROR_NO_MEMORY);
+        return table.Append(subscriptionInfo);
+    });
 }
 
 CHIP_ERROR SimpleSubscriptionResumptionStorage::Delete(NodeId nodeId, FabricIndex fabricIndex, SubscriptionId subscriptionId)
 {
-    bool subscriptionFound   = false;
-    CHIP_ERROR lastDeleteErr = CHIP_NO_ERROR;
-
-    uint16_t remainingSubscriptionsCount = 0;
-    for (uint16_t subscriptionIndex = 0; subscriptionIndex < CHIP_IM_MAX_NUM_SUBSCRIPTIONS; subscriptionIndex++)
-    {
-        SubscriptionInfo subscriptionInfo;
-        CHIP_ERROR err = Load(subscriptionIndex, subscriptionInfo);
-
-        // delete match
-        if (err == CHIP_NO_ERROR)
-        {
-            if ((nodeId == subscriptionInfo.mNodeId) && (fabricIndex == subscriptionInfo.mFabricIndex) &&
-                (subscriptionId == subscriptionInfo.mSubscriptionId))
-            {
-                subscriptionFound    = true;
-                CHIP_ERROR deleteErr = Delete(subscriptionIndex);
-                if (deleteErr != CHIP_NO_ERROR)
-                {
-                    lastDeleteErr = deleteErr;
-                }
-            }
-            else
-            {
-                remainingSubscriptionsCount++;
-            }
-        }
-    }
-
-    // if there are no persisted subscriptions, the MaxCount can also be deleted
-    if (remainingSubscriptionsCount == 0)
-    {
-        DeleteMaxCount();
-    }
-
-    if (lastDeleteErr != CHIP_NO_ERROR)
-    {
-        return lastDeleteErr;
-    }
-
-    return subscriptionFound ? CHIP_NO_ERROR : CHIP_ERROR_PERSISTED_STORAGE_VALUE_NOT_FOUND;
+    return Update([nodeId, fabricIndex, subscriptionId](Table & table) -> CHIP_ERROR {
+        size_t removed = table.Remove([nodeId, fabricIndex, subscriptionId](const SubscriptionInfo & entry) {
+            return IsSameSubscription(entry, nodeId, fabricIndex, subscriptionId);
+        });
+        return (removed > 0) ? CHIP_NO_ERROR : CHIP_ERROR_PERSISTED_STORAGE_VALUE_NOT_FOUND;
+    });
 }
 
-CHIP_ERROR SimpleSubscriptionResumptionStorage::DeleteMaxCount()
+CHIP_ERROR SimpleSubscriptionResumptionStorage::DeleteAll(FabricIndex fabricIndex)
 {
-    return mStorage->SyncDeleteKeyValue(DefaultStorageKeyAllocator::SubscriptionResumptionMaxCount().KeyName());
+    return Update([fabricIndex](Table & table) -> CHIP_ERROR {
+        table.Remove([fabricIndex](const SubscriptionInfo & entry) { return entry.mFabricIndex == fabricIndex; });
+        return CHIP_NO_ERROR;
+    });
 }
 
-CHIP_ERROR SimpleSubscriptionResumptionStorage::DeleteAll(FabricIndex fabricIndex)
+CHIP_ERROR SimpleSubscriptionResumptionStorage::StartBatch()
 {
-    CHIP_ERROR deleteErr = CHIP_NO_ERROR;
+    VerifyOrReturnError(!mBatch.IsLoaded(), CHIP_ERROR_INCORRECT_STATE);
 
-    uint16_t count = 0;
-    for (uint16_t subscriptionIndex = 0; subscriptionIndex < CHIP_IM_MAX_NUM_SUBSCRIPTIONS; subscriptionIndex++)
+    CHIP_ERROR err = mBatch.Load(*mStorage);
+    if (err != CHIP_NO_ERROR)
     {
-        SubscriptionInfo subscriptionInfo;
-        CHIP_ERROR err = Load(subscriptionIndex, subscriptionInfo);
-
-        if (err == CHIP_NO_ERROR)
-        {
-            if (fabricIndex == subscriptionInfo.mFabricIndex)
-            {
-                err = Delete(subscriptionIndex);
-                if ((err != CHIP_NO_ERROR) && (err != CHIP_ERROR_PERSISTED_STORAGE_VALUE_NOT_FOUND))
-                {
-                    deleteErr = err;
-                }
-            }
-            else
-            {
-                count++;
-            }
-        }
+        mBatch.Release();
     }
+    return err;
+}
 
-    // if there are no persisted subscriptions, the MaxCount can also be deleted
-    if (count == 0)
-    {
-        CHIP_ERROR err = DeleteMaxCount();
-
-        if ((err != CHIP_NO_ERROR) && (err != CHIP_ERROR_PERSISTED_STORAGE_VALUE_NOT_FOUND))
-        {
-            deleteErr = err;
-        }
-    }
+CHIP_ERROR SimpleSubscriptionResumptionStorage::EndBatch()
+{
+    VerifyOrReturnError(mBatch.IsLoaded(), CHIP_ERROR_INCORRECT_STATE);
 
-    return deleteErr;
+    CHIP_ERROR err = mBatch.IsModified() ? mBatch.Store(*mStorage) : CHIP_NO_ERROR;
+    mBatch.Release();
+    return err;
 }
 
 } // namespace app
@@ -18,7 +18,7 @@
 /**
  *    @file
  *      This file defines a basic implementation of SubscriptionResumptionStorage that
- *      persists subscriptions in a flat list in TLV.
+ *      persists all subscriptions in a single compact table.
  */
 
 #pragma once
@@ -28,12 +28,24 @@
 #include <lib/core/TLV.h>
 #include <lib/support/DefaultStorageKeyAllocator.h>
 #include <lib/support/Pool.h>
+#include <lib/support/ScopedBuffer.h>
 
 namespace chip {
 namespace app {
 
 /**
  * An example SubscriptionResumptionStorage using PersistentStorageDelegate as it backend.
+ *
+ * All subscriptions are kept in a single table, split over as few storage keys as values of
+ * at most CHIP_CONFIG_SUBSCRIPTION_RESUMPTION_STORAGE_SHARD_SIZE bytes allow, so that any
+ * change is a handful of storage writes, and resuming subscriptions at boot reads each key
+ * once. Iterators read the table from storage one shard at a time, and end early if the
+ * table is changed while they are in use. Subscriptions persisted by older releases under
+ * per-index keys are moved to the table by Init().
+ *
+ * Wrapping the storage delegate with a CoalescingPersistentStorageDelegate also merges
+ * subscriptions saved in quick succession, e.g. when a controller re-establishes all its
+ * subscriptions, into one write of each shard.
  */
 class SimpleSubscriptionResumptionStorage : public SubscriptionResumptionStorage
 {
@@ -50,12 +62,179 @@ public:
 
     CHIP_ERROR DeleteAll(FabricIndex fabricIndex) override;
 
+    /**
+     * Start a batch of changes: until EndBatch() is called, Save(), Delete() and DeleteAll()
+     * only update an in-memory copy of the table. Iterators only see the changes once the
+     * batch has ended.
+     */
+    CHIP_ERROR StartBatch();
+
+    /**
+     * Write the changes made since StartBatch() with a single write of each shard.
+     */
+    CHIP_ERROR EndBatch();
+
+    /**
+     * Upper bound of the size of the table entries: every subscription, together holding
+     * at most the paths the IM engine path pools can hold for subscriptions.
+     */
+    static constexpr size_t MaxTableSize()
+    {
+        return CHIP_IM_MAX_NUM_SUBSCRIPTIONS * kMaxEncodedEntryHeaderSize +
+            2 * CHIP_IM_SERVER_MAX_NUM_PATH_GROUPS_FOR_SUBSCRIPTIONS * kMaxEncodedPathSize;
+    }
+
+    static constexpr size_t kShardSize = CHIP_CONFIG_SUBSCRIPTION_RESUMPTION_STORAGE_SHARD_SIZE;
+
 protected:
-    CHIP_ERROR Save(TLV::TLVWriter & writer, SubscriptionInfo & subscriptionInfo);
-    CHIP_ERROR Load(uint16_t subscriptionIndex, SubscriptionInfo & subscriptionInfo);
-    CHIP_ERROR Delete(uint16_t subscriptionIndex);
-    uint16_t Count();
-    CHIP_ERROR DeleteMaxCount();
+    // Table format:
+    //
+    //   The table is stored in shards, under keys indexed from 0. Each shard holds:
+    //     Format version (1 byte)
+    //     Generation (1 byte): incremented by every write of the table, so that shards left
+    //       over from an interrupted write are told apart
+    //     Shard count (1 byte)
+    //     The next bytes of the entries, an entry possibly continuing in the next shard
+    //
+    //   For each subscription:
+    //     Length of the entry (varint), followed by:
+    //       Node ID, fabric index, subscription ID, min interval, max interval (varints)
+    //       Flags (1 byte): fabric filtered
+    //       Resumption retries (varint)
+    //       Attribute path count (varint), followed by the attribute paths
+    //       Event path count (varint), followed by the event paths
+    //
+    // Varints are unsigned LEB128. Each path starts with a flags byte telling, for each of its
+    // endpoint, cluster and attribute / event ID, whether it is a wildcard, the same as in the
+    // previous path, or follows as a varint. IDs within the same cluster as the previous path
+    // are stored as the (zigzag encoded) difference to the previous ID. Data following the
+    // fields above within an entry is ignored, so that fields can be added in later versions.
+    static constexpr uint8_t kTableVersion             = 2;
+    static constexpr size_t kMaxEncodedEntryHeaderSize = 38;
+    static constexpr size_t kMaxEncodedPathSize        = 14;
+    static constexpr size_t kShardHeaderSize           = 3;
+    static constexpr size_t kShardPayloadSize          = kShardSize - kShardHeaderSize;
+
+    /**
+     * Reads the entries of the stored table in sequence, keeping a single shard in memory.
+     */
+    class TableReader
+    {
+    public:
+        /**
+         * Read the first shard. An empty table is opened if there is none, and
+         * CHIP_ERROR_DECODE_FAILED is returned if it is not a valid shard.
+         */
+        CHIP_ERROR Open(PersistentStorageDelegate & storage);
+        void Close();
+
+        uint8_t GetGeneration() const { return mGeneration; }
+        uint8_t GetShardCount() const { return mShardCount; }
+        bool AtEnd() const { return (mOffset == mLength) && (mShardIndex + 1u >= mShardCount); }
+
+        /**
+         * Read the next byte of the entries. CHIP_ERROR_DECODE_FAILED is returned past the
+         * last shard, or if the next shard is missing or was not written with the first one.
+         */
+        CHIP_ERROR Read8(uint8_t & value);
+        CHIP_ERROR Skip(size_t size);
+
+        /**
+         * Upper bound of the number of bytes left.
+         */
+        size_t Remaining() const;
+
+    private:
+        CHIP_ERROR LoadShard(uint8_t shardIndex);
+
+        PersistentStorageDelegate * mStorage = nullptr;
+        Platform::ScopedMemoryBuffer<uint8_t> mShard;
+        size_t mLength      = 0;
+        size_t mOffset      = 0;
+        uint8_t mShardIndex = 0;
+        uint8_t mShardCount = 0;
+        uint8_t mGeneration = 0;
+    };
+
+    /**
+     * In-memory copy of the encoded table, for changing it.
+     */
+    class Table
+    {
+    public:
+        CHIP_ERROR Load(PersistentStorageDelegate & storage);
+        CHIP_ERROR Store(PersistentStorageDelegate & storage);
+        void Release();
+
+        bool IsLoaded() const { return mBuffer.Get() != nullptr; }
+        bool IsModified() const { return mModified; }
+        size_t Count() const { return mCount; }
+
+        CHIP_ERROR Append(const SubscriptionInfo & subscriptionInfo);
+
+        /**
+         * Remove the subscriptions for which `shouldRemove` returns true, and return how many
+         * were removed. Only the node ID, fabric index and subscription ID of the
+         * SubscriptionInfo passed to `shouldRemove` are set.
+         */
+        template <typename Predicate>
+        size_t Remove(Predicate && shouldRemove)
+        {
+            size_t removed = 0;
+            size_t offset  = kEntriesOffset;
+            while (offset < mLength)
+            {
+                SubscriptionInfo subscriptionInfo;
+                size_t entrySize;
+                if (Decode(offset, subscriptionInfo, entrySize, /* decodePaths = */ false) != CHIP_NO_ERROR)
+                {
+                    break;
+                }
+
+                if (shouldRemove(static_cast<const SubscriptionInfo &>(subscriptionInfo)))
+                {
+                    Erase(offset, entrySize);
+                    removed++;
+                }
+                else
+                {
+                    offset += entrySize;
+                }
+            }
+            return removed;
+        }
+
+        /**
+         * Decode the entry at `offset` and return its encoded size in `entrySize`. Path
+         * buffers of `subscriptionInfo` are only reallocated if the path counts differ.
+         */
+        CHIP_ERROR Decode(size_t offset, SubscriptionInfo & subscriptionInfo, size_t & entrySize, bool decodePaths = true) const;
+
+        static constexpr size_t kEntriesOffset = 0;
+
+    private:
+        void Reset();
+        void Erase(size_t offset, size_t size);
+
+        Platform::ScopedMemoryBuffer<uint8_t> mBuffer;
+        size_t mLength            = 0;
+        size_t mCount             = 0;
+        uint8_t mGeneration       = 0;
+        uint8_t mStoredShardCount = 0;
+        bool mModified            = false;
+    };
+
+    template <typename Operation>
+    CHIP_ERROR Update(Operation && operation);
+
+    CHIP_ERROR MigrateLegacySubscriptions();
+
+    // Drop the entries that cannot be decoded from storage.
+    void RepairTable();
+
+    // Subscriptions persisted by older releases, each in its own key.
+    CHIP_ERROR SaveLegacy(TLV::TLVWriter & writer, SubscriptionInfo & subscriptionInfo);
+    CHIP_ERROR LoadLegacy(uint16_t subscriptionIndex, SubscriptionInfo & subscriptionInfo);
 
     class SimpleSubscriptionInfoIterator : public SubscriptionInfoIterator
     {
@@ -66,8 +245,10 @@ protected:
         void Release() override;
 
     private:
+        friend class SimpleSubscriptionResumptionStorage;
+
         SimpleSubscriptionResumptionStorage & mStorage;
-        uint16_t mNextIndex;
+        TableReader mReader;
     };
 
     static constexpr size_t MaxScopedNodeIdSize() { return TLV::EstimateStructOverhead(sizeof(NodeId), sizeof(FabricIndex)); }
@@ -95,7 +276,7 @@ protected:
         kNonUrgent = 0x2,
     };
 
-    // Flat list of subscriptions indexed from from 0 to CHIP_IM_SERVER_MAX_NUM_PATH_GROUPS_FOR_SUBSCRIPTIONS-1
+    // Legacy format: flat list of subscriptions indexed from from 0 to CHIP_IM_MAX_NUM_SUBSCRIPTIONS-1
     //
     // Each entry in list is a Subscription TLV structure:
     //   Structure of: (Subscription info)
@@ -136,6 +317,7 @@ protected:
 
     PersistentStorageDelegate * mStorage;
     ObjectPool<SimpleSubscriptionInfoIterator, kIteratorsMax> mSubscriptionInfoIterators;
+    Table mBatch;
 };
 } // namespace app
 } // namespace chip
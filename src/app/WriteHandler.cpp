@@ -233,7 +233,7 @@ CHIP_ERROR WriteHandler::DeliverFinalListWriteEndForGroupWrite(bool writeWasSucc
     auto processingConcreteAttributePath = mProcessingAttributePath.Value();
     mProcessingAttributePath.ClearValue();
 
-    iterator = groupDataProvider->IterateEndpoints(fabricIndex);
+    iterator = groupDataProvider->IterateEndpoints(fabricIndex, std::make_optional(groupId));
     VerifyOrReturnError(iterator != nullptr, CHIP_ERROR_NO_MEMORY);
 
     while (iterator->Next(mapping))
@@ -423,7 +423,7 @@ CHIP_ERROR WriteHandler::ProcessGroupAttributeDataIBs(TLV::TLVReader & aAttribut
                       "Received group attribute write for Group=%u Cluster=" ChipLogFormatMEI " attribute=" ChipLogFormatMEI,
                       groupId, ChipLogValueMEI(dataAttributePath.mClusterId), ChipLogValueMEI(dataAttributePath.mAttributeId));
 
-        iterator = groupDataProvider->IterateEndpoints(fabric);
+        iterator = groupDataProvider->IterateEndpoints(fabric, std::make_optional(groupId));
         VerifyOrExit(iterator != nullptr, err = CHIP_ERROR_NO_MEMORY);
 
         bool shouldReportListWriteEnd =
@@ -0,0 +1,202 @@
+/*
+ *
+ *    Copyright (c) 2024 Project CHIP Authors
+ *    All rights reserved.
+ *
+ *    Licensed under the Apache License, Version 2.0 (the "License");
+ *    you may not use this file except in compliance with the License.
+ *    You may obtain a copy of the License at
+ *
+ *        http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *    Unless required by applicable law or agreed to in writing, software
+ *    distributed under the License is distributed on an "AS IS" BASIS,
+ *    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *    See the License for the specific language governing permissions and
+ *    limitations under the License.
+ */
+
+#include <app/cluster-building-blocks/TransitionScheduler.h>
+
+#include <lib/support/CodeUtils.h>
+#include <lib/support/logging/CHIPLogging.h>
+
+#include <algorithm>
+
+namespace chip {
+namespace app {
+
+using namespace System::Clock;
+
+TransitionScheduler::~TransitionScheduler()
+{
+    mTimers.Clear();
+}
+
+TransitionScheduler & TransitionScheduler::Instance()
+{
+    static TransitionScheduler sInstance;
+    return sInstance;
+}
+
+CHIP_ERROR TransitionScheduler::StartTimer(System::Layer & systemLayer, TransitionTimer & timer, Milliseconds32 delay,
+                                           TransitionTimer::Callback callback, void * context)
+{
+    VerifyOrReturnError(callback != nullptr, CHIP_ERROR_INVALID_ARGUMENT);
+    timer.Unlink();
+
+    if (mSystemLayer != &systemLayer)
+    {
+        VerifyOrReturnError(mTimers.Empty(), CHIP_ERROR_INCORRECT_STATE);
+
+        // A system timer still armed on the previous layer is ignored by HandleTimer.
+        mSystemLayer = &systemLayer;
+        mArmed       = false;
+    }
+
+    timer.mCallback = callback;
+    timer.mContext  = context;
+    timer.mDelay    = delay;
+    timer.mDeadline = System::SystemClock().GetMonotonicTimestamp() + delay;
+    mTimers.PushBack(&timer);
+
+    // The system timer is rearmed once all the due timers have run.
+    VerifyOrReturnError(!mDispatching, CHIP_NO_ERROR);
+
+    const Timestamp deadline = CoalescedDeadline();
+    VerifyOrReturnError(!mArmed || mArmedDeadline != deadline, CHIP_NO_ERROR);
+
+    CHIP_ERROR err = ArmSystemTimer(deadline);
+    if (err != CHIP_NO_ERROR)
+    {
+        mTimers.Remove(&timer);
+    }
+    return err;
+}
+
+void TransitionScheduler::CancelTimer(TransitionTimer & timer)
+{
+    timer.Unlink();
+
+    // A system timer firing with no due timers is harmless, but there is no point in keeping it once nothing is scheduled.
+    if (!mDispatching && mArmed && mTimers.Empty())
+    {
+        mSystemLayer->CancelTimer(HandleTimer, this);
+        mArmed = false;
+    }
+}
+
+size_t TransitionScheduler::ScheduledTimerCount() const
+{
+    size_t count = 0;
+    for (auto it = mTimers.begin(); it != mTimers.end(); ++it)
+    {
+        count++;
+    }
+    return count;
+}
+
+void TransitionScheduler::HandleTimer(System::Layer * systemLayer, void * context)
+{
+    auto * scheduler = static_cast<TransitionScheduler *>(context);
+    VerifyOrReturn(systemLayer == scheduler->mSystemLayer);
+
+    scheduler->mArmed = false;
+    scheduler->RunDueTimers();
+}
+
+void TransitionScheduler::RunDueTimers()
+{
+    const Timestamp now = System::SystemClock().GetMonotonicTimestamp();
+
+    // Collect the due timers before running any callback, so that the timers restarted by the callbacks are not run again
+    // in this iteration.
+    IntrusiveList<TransitionTimer, IntrusiveMode::AutoUnlink> dueTimers;
+    for (auto it = mTimers.begin(); it != mTimers.end();)
+    {
+        TransitionTimer & timer = *it;
+        ++it;
+
+        if (timer.mDeadline <= now)
+        {
+            mTimers.Remove(&timer);
+            dueTimers.PushBack(&timer);
+        }
+    }
+
+    // Callbacks may start or cancel any timer, including the due ones that have not run yet.
+    mDispatching = true;
+    while (!dueTimers.Empty())
+    {
+        TransitionTimer & timer = *dueTimers.begin();
+        dueTimers.Remove(&timer);
+        timer.mCallback(timer.mContext);
+    }
+    mDispatching = false;
+
+    RearmSystemTimer();
+}
+
+Timestamp TransitionScheduler::CoalescedDeadline()
+{
+    Timestamp earliest = mTimers.begin()->mDeadline;
+    for (auto & timer : mTimers)
+    {
+        earliest = std::min(earliest, timer.mDeadline);
+    }
+
+    // Latest tick that none of the timers due by then would run too late on.
+    Timestamp latest = earliest + mCoalescingWindow;
+    for (auto & timer : mTimers)
+    {
+        if (timer.mDeadline <= earliest + mCoalescingWindow)
+        {
+            const Milliseconds32 lateness = std::min(mCoalescingWindow, Milliseconds32(timer.mDelay.count() / 2));
+            latest                        = std::min(latest, timer.mDeadline + lateness);
+        }
+    }
+
+    // Tick when the last of these timers is due, rather than at the earliest one, to run them all together.
+    Timestamp deadline = earliest;
+    for (auto & timer : mTimers)
+    {
+        if (timer.mDeadline <= latest)
+        {
+            deadline = std::max(deadline, timer.mDeadline);
+        }
+    }
+    return deadline;
+}
+
+CHIP_ERROR TransitionScheduler::ArmSystemTimer(Timestamp deadline)
+{
+    const Timestamp now = System::SystemClock().GetMonotonicTimestamp();
+    const Timeout delay = (deadline > now) ? std::chrono::duration_cast<Timeout>(deadline - now) : Timeout(0);
+
+    ReturnErrorOnFailure(mSystemLayer->StartTimer(delay, HandleTimer, this));
+    mArmed         = true;
+    mArmedDeadline = deadline;
+    return CHIP_NO_ERROR;
+}
+
+void TransitionScheduler::RearmSystemTimer()
+{
+    if (mTimers.Empty())
+    {
+        if (mArmed)
+        {
+            mSystemLayer->CancelTimer(HandleTimer, this);
+            mArmed = false;
+        }
+        return;
+    }
+
+    CHIP_ERROR err = ArmSystemTimer(CoalescedDeadline());
+    if (err != CHIP_NO_ERROR)
+    {
+        ChipLogError(Zcl, "Transition scheduler failed to schedule event: %" CHIP_ERROR_FORMAT, err.Format());
+    }
+}
+
+} // namespace app
+} // namespace chip
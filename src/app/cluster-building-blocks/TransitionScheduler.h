@@ -0,0 +1,110 @@
+/*
+ *
+ *    Copyright (c) 2024 Project CHIP Authors
+ *    All rights reserved.
+ *
+ *    Licensed under the Apache License, Version 2.0 (the "License");
+ *    you may not use this file except in compliance with the License.
+ *    You may obtain a copy of the License at
+ *
+ *        http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *    Unless required by applicable law or agreed to in writing, software
+ *    distributed under the License is distributed on an "AS IS" BASIS,
+ *    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *    See the License for the specific language governing permissions and
+ *    limitations under the License.
+ */
+
+#pragma once
+
+#include <lib/core/CHIPError.h>
+#include <lib/support/IntrusiveList.h>
+#include <system/SystemClock.h>
+#include <system/SystemLayer.h>
+
+namespace chip {
+namespace app {
+
+/**
+ * The tick timer of a cluster transition (e.g. a Level Control or Color Control transition on one endpoint).
+ *
+ * Timers are owned by the cluster and driven by a TransitionScheduler. A timer is unscheduled when it is destroyed.
+ */
+class TransitionTimer : public IntrusiveListNodeBase<IntrusiveMode::AutoUnlink>
+{
+public:
+    using Callback = void (*)(void * context);
+
+    bool IsScheduled() const { return IsInList(); }
+
+private:
+    friend class TransitionScheduler;
+
+    Callback mCallback = nullptr;
+    void * mContext    = nullptr;
+    System::Clock::Timestamp mDeadline;
+    System::Clock::Milliseconds32 mDelay;
+};
+
+/**
+ * Drives the tick timers of all the running transitions from a single System::Layer timer.
+ *
+ * Every transition ticks every few tens of milliseconds. With one system timer per endpoint, a bridge running the same
+ * transition on hundreds of endpoints wakes the event loop hundreds of times per tick period, and every wakeup ends up
+ * scheduling its own reporting engine run. The scheduler instead runs all the timers that are due in the same event loop
+ * iteration, so that the attribute changes of all the endpoints are batched into one report run.
+ *
+ * Timers never run early, so a transition never ends before its transition time. To coalesce, a timer may instead be
+ * delayed until the timers due shortly after it, by up to half of its delay and never more than the coalescing window.
+ * Timers started at different times thereby converge on the same ticks once, and then stay aligned without further delay.
+ *
+ * The scheduler must only be used from the Matter thread.
+ */
+class TransitionScheduler
+{
+public:
+    static constexpr System::Clock::Milliseconds32 kDefaultCoalescingWindow = System::Clock::Milliseconds32(50);
+
+    explicit TransitionScheduler(System::Clock::Milliseconds32 coalescingWindow = kDefaultCoalescingWindow) :
+        mCoalescingWindow(coalescingWindow)
+    {}
+    ~TransitionScheduler();
+
+    TransitionScheduler(const TransitionScheduler &)             = delete;
+    TransitionScheduler & operator=(const TransitionScheduler &) = delete;
+
+    /// Scheduler shared by the cluster servers of the application.
+    static TransitionScheduler & Instance();
+
+    /**
+     * Schedule the timer to call callback(context) after the given delay, replacing any previous scheduling of the timer.
+     *
+     * All the timers of a scheduler must be driven by the same system layer.
+     */
+    CHIP_ERROR StartTimer(System::Layer & systemLayer, TransitionTimer & timer, System::Clock::Milliseconds32 delay,
+                          TransitionTimer::Callback callback, void * context);
+
+    void CancelTimer(TransitionTimer & timer);
+
+    /// Number of timers that are currently scheduled.
+    size_t ScheduledTimerCount() const;
+
+private:
+    static void HandleTimer(System::Layer * systemLayer, void * context);
+
+    void RunDueTimers();
+    System::Clock::Timestamp CoalescedDeadline();
+    CHIP_ERROR ArmSystemTimer(System::Clock::Timestamp deadline);
+    void RearmSystemTimer();
+
+    IntrusiveList<TransitionTimer, IntrusiveMode::AutoUnlink> mTimers;
+    System::Layer * mSystemLayer = nullptr;
+    System::Clock::Milliseconds32 mCoalescingWindow;
+    System::Clock::Timestamp mArmedDeadline;
+    bool mArmed       = false;
+    bool mDispatching = false;
+};
+
+} // namespace app
+} // namespace chip
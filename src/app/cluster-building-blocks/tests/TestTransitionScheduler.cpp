@@ -0,0 +1,382 @@
+/*
+ *
+ *    Copyright (c) 2024 Project CHIP Authors
+ *    All rights reserved.
+ *
+ *    Licensed under the Apache License, Version 2.0 (the "License");
+ *    you may not use this file except in compliance with the License.
+ *    You may obtain a copy of the License at
+ *
+ *        http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *    Unless required by applicable law or agreed to in writing, software
+ *    distributed under the License is distributed on an "AS IS" BASIS,
+ *    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *    See the License for the specific language governing permissions and
+ *    limitations under the License.
+ */
+
+#include <app/cluster-building-blocks/TransitionScheduler.h>
+
+#include <lib/core/CHIPError.h>
+#include <lib/core/StringBuilderAdapters.h>
+#include <system/SystemClock.h>
+#include <system/SystemLayer.h>
+
+#include <pw_unit_test/framework.h>
+
+using namespace chip;
+using namespace chip::app;
+using namespace chip::System::Clock;
+using namespace chip::System::Clock::Literals;
+
+namespace {
+
+/// System layer with a single timer slot, which is all the scheduler needs, driven by a mock clock.
+class FakeSystemLayer : public System::Layer
+{
+public:
+    CHIP_ERROR Init() override { return CHIP_NO_ERROR; }
+    void Shutdown() override {}
+    bool IsInitialized() const override { return true; }
+
+    CHIP_ERROR StartTimer(Timeout delay, System::TimerCompleteCallback callback, void * appState) override
+    {
+        mCallback = callback;
+        mAppState = appState;
+        mDeadline = System::SystemClock().GetMonotonicTimestamp() + delay;
+        mStartCount++;
+        return CHIP_NO_ERROR;
+    }
+
+    CHIP_ERROR ExtendTimerTo(Timeout delay, System::TimerCompleteCallback callback, void * appState) override
+    {
+        return CHIP_ERROR_NOT_IMPLEMENTED;
+    }
+
+    bool IsTimerActive(System::TimerCompleteCallback callback, void * appState) override
+    {
+        return mCallback == callback && mAppState == appState;
+    }
+
+    Timeout GetRemainingTime(System::TimerCompleteCallback callback, void * appState) override { return 0_ms; }
+
+    void CancelTimer(System::TimerCompleteCallback callback, void * appState) override
+    {
+        if (IsTimerActive(callback, appState))
+        {
+            mCallback = nullptr;
+        }
+    }
+
+    CHIP_ERROR ScheduleWork(System::TimerCompleteCallback callback, void * appState) override
+    {
+        return CHIP_ERROR_NOT_IMPLEMENTED;
+    }
+
+    bool HasTimer() const { return mCallback != nullptr; }
+    Timestamp Deadline() const { return mDeadline; }
+
+    /// Advance the clock to the deadline of the timer and fire it.
+    void FireTimer(Internal::MockClock & clock)
+    {
+        ASSERT_TRUE(HasTimer());
+        if (clock.GetMonotonicTimestamp() < mDeadline)
+        {
+            clock.SetMonotonic(mDeadline);
+        }
+
+        auto callback = mCallback;
+        mCallback     = nullptr;
+        mFireCount++;
+        callback(this, mAppState);
+    }
+
+    size_t mStartCount = 0;
+    size_t mFireCount  = 0;
+
+private:
+    System::TimerCompleteCallback mCallback = nullptr;
+    void * mAppState                        = nullptr;
+    Timestamp mDeadline;
+};
+
+/// A transition ticking every kTickPeriod until it has run all its steps, like the Level Control and Color Control ones.
+struct FakeTransition
+{
+    static constexpr Milliseconds32 kTickPeriod = 100_ms;
+
+    static void Tick(void * context) { static_cast<FakeTransition *>(context)->Step(kTickPeriod, Tick); }
+    static void TickWithoutDelay(void * context) { static_cast<FakeTransition *>(context)->Step(0_ms, TickWithoutDelay); }
+
+    void Step(Milliseconds32 delay, TransitionTimer::Callback callback)
+    {
+        ticks++;
+        lastTick = System::SystemClock().GetMonotonicTimestamp();
+        if (ticks < steps)
+        {
+            EXPECT_EQ(scheduler->StartTimer(*layer, timer, delay, callback, this), CHIP_NO_ERROR);
+        }
+    }
+
+    TransitionScheduler * scheduler = nullptr;
+    System::Layer * layer           = nullptr;
+    TransitionTimer timer;
+    uint32_t steps = 0;
+    uint32_t ticks = 0;
+    Timestamp lastTick;
+};
+
+class TestTransitionScheduler : public ::testing::Test
+{
+public:
+    void SetUp() override
+    {
+        mSavedClock = &System::SystemClock();
+        System::Clock::Internal::SetSystemClockForTesting(&mClock);
+    }
+
+    void TearDown() override { System::Clock::Internal::SetSystemClockForTesting(mSavedClock); }
+
+protected:
+    Internal::MockClock mClock;
+    FakeSystemLayer mLayer;
+
+private:
+    ClockBase * mSavedClock = nullptr;
+};
+
+void CountCall(void * context)
+{
+    (*static_cast<int *>(context))++;
+}
+
+} // namespace
+
+TEST_F(TestTransitionScheduler, TestStartAndCancel)
+{
+    TransitionScheduler scheduler;
+    TransitionTimer first;
+    TransitionTimer second;
+    int firstCalls  = 0;
+    int secondCalls = 0;
+
+    EXPECT_EQ(scheduler.StartTimer(mLayer, first, 100_ms, CountCall, &firstCalls), CHIP_NO_ERROR);
+    EXPECT_TRUE(first.IsScheduled());
+    EXPECT_TRUE(mLayer.HasTimer());
+    EXPECT_EQ(mLayer.Deadline(), Timestamp(100));
+
+    // A later timer does not rearm the system timer, an earlier one does.
+    EXPECT_EQ(scheduler.StartTimer(mLayer, second, 300_ms, CountCall, &secondCalls), CHIP_NO_ERROR);
+    EXPECT_EQ(mLayer.mStartCount, 1u);
+    EXPECT_EQ(scheduler.StartTimer(mLayer, second, 20_ms, CountCall, &secondCalls), CHIP_NO_ERROR);
+    EXPECT_EQ(mLayer.mStartCount, 2u);
+    EXPECT_EQ(mLayer.Deadline(), Timestamp(20));
+    EXPECT_EQ(scheduler.ScheduledTimerCount(), 2u);
+
+    scheduler.CancelTimer(second);
+    EXPECT_FALSE(second.IsScheduled());
+    EXPECT_TRUE(mLayer.HasTimer());
+
+    // Firing early runs nothing and rearms for the remaining timer.
+    mLayer.FireTimer(mClock);
+    EXPECT_EQ(firstCalls, 0);
+    EXPECT_EQ(secondCalls, 0);
+    EXPECT_EQ(mLayer.Deadline(), Timestamp(100));
+
+    mLayer.FireTimer(mClock);
+    EXPECT_EQ(firstCalls, 1);
+    EXPECT_EQ(secondCalls, 0);
+    EXPECT_FALSE(first.IsScheduled());
+    EXPECT_FALSE(mLayer.HasTimer());
+
+    // Cancelling the last timer cancels the system timer.
+    EXPECT_EQ(scheduler.StartTimer(mLayer, first, 100_ms, CountCall, &firstCalls), CHIP_NO_ERROR);
+    EXPECT_TRUE(mLayer.HasTimer());
+    scheduler.CancelTimer(first);
+    EXPECT_FALSE(mLayer.HasTimer());
+    EXPECT_EQ(scheduler.ScheduledTimerCount(), 0u);
+}
+
+TEST_F(TestTransitionScheduler, TestCoalescing)
+{
+    TransitionScheduler scheduler(50_ms);
+    TransitionTimer timers[4];
+    int calls[4] = {};
+
+    EXPECT_EQ(scheduler.StartTimer(mLayer, timers[0], 100_ms, CountCall, &calls[0]), CHIP_NO_ERROR);
+    EXPECT_EQ(mLayer.Deadline(), Timestamp(100));
+    // Due within the window: the first one waits for it.
+    EXPECT_EQ(scheduler.StartTimer(mLayer, timers[1], 140_ms, CountCall, &calls[1]), CHIP_NO_ERROR);
+    EXPECT_EQ(mLayer.Deadline(), Timestamp(140));
+    // Due after the window.
+    EXPECT_EQ(scheduler.StartTimer(mLayer, timers[2], 160_ms, CountCall, &calls[2]), CHIP_NO_ERROR);
+    EXPECT_EQ(mLayer.Deadline(), Timestamp(140));
+
+    mClock.AdvanceMonotonic(90_ms);
+    // Short delay: may only be delayed by up to half of it, so the tick is brought back to when it is due.
+    EXPECT_EQ(scheduler.StartTimer(mLayer, timers[3], 30_ms, CountCall, &calls[3]), CHIP_NO_ERROR);
+    EXPECT_EQ(mLayer.Deadline(), Timestamp(120));
+
+    mLayer.FireTimer(mClock);
+    EXPECT_EQ(mClock.GetMonotonicTimestamp(), Timestamp(120));
+    EXPECT_EQ(calls[0], 1);
+    EXPECT_EQ(calls[1], 0);
+    EXPECT_EQ(calls[2], 0);
+    EXPECT_EQ(calls[3], 1);
+    EXPECT_EQ(mLayer.Deadline(), Timestamp(160));
+
+    // No timer runs before it is due.
+    mLayer.FireTimer(mClock);
+    EXPECT_EQ(mClock.GetMonotonicTimestamp(), Timestamp(160));
+    EXPECT_EQ(calls[1], 1);
+    EXPECT_EQ(calls[2], 1);
+    EXPECT_FALSE(mLayer.HasTimer());
+}
+
+TEST_F(TestTransitionScheduler, TestTransitionDuration)
+{
+    constexpr uint32_t kSteps        = 50;
+    constexpr Milliseconds32 kWindow = 50_ms;
+
+    TransitionScheduler scheduler(kWindow);
+    FakeTransition transitions[3];
+    const Timestamp starts[3] = { Timestamp(0), Timestamp(30), Timestamp(1020) };
+
+    for (size_t i = 0; i < 3; i++)
+    {
+        while (mLayer.HasTimer() && mLayer.Deadline() <= starts[i])
+        {
+            mLayer.FireTimer(mClock);
+        }
+        mClock.SetMonotonic(starts[i]);
+
+        auto & transition    = transitions[i];
+        transition.scheduler = &scheduler;
+        transition.layer     = &mLayer;
+        transition.steps     = kSteps;
+        EXPECT_EQ(scheduler.StartTimer(mLayer, transition.timer, FakeTransition::kTickPeriod, FakeTransition::Tick, &transition),
+                  CHIP_NO_ERROR);
+    }
+
+    while (mLayer.HasTimer())
+    {
+        mLayer.FireTimer(mClock);
+    }
+
+    // Each transition takes at least its transition time, and is only delayed once per coalescing with the others,
+    // by less than the window, rather than on every tick.
+    for (size_t i = 0; i < 3; i++)
+    {
+        EXPECT_EQ(transitions[i].ticks, kSteps);
+        EXPECT_GE(transitions[i].lastTick, starts[i] + kSteps * FakeTransition::kTickPeriod);
+        EXPECT_LE(transitions[i].lastTick, starts[i] + kSteps * FakeTransition::kTickPeriod + 2 * kWindow);
+    }
+
+    // A transition running alone is not delayed at all.
+    FakeTransition alone;
+    alone.scheduler       = &scheduler;
+    alone.layer           = &mLayer;
+    alone.steps           = kSteps;
+    const Timestamp start = mClock.GetMonotonicTimestamp();
+    EXPECT_EQ(scheduler.StartTimer(mLayer, alone.timer, FakeTransition::kTickPeriod, FakeTransition::Tick, &alone), CHIP_NO_ERROR);
+    while (mLayer.HasTimer())
+    {
+        mLayer.FireTimer(mClock);
+    }
+    EXPECT_EQ(alone.ticks, kSteps);
+    EXPECT_EQ(alone.lastTick, start + kSteps * FakeTransition::kTickPeriod);
+}
+
+TEST_F(TestTransitionScheduler, TestCallbacksUpdateTimers)
+{
+    TransitionScheduler scheduler;
+    struct Context
+    {
+        TransitionScheduler * scheduler;
+        TransitionTimer * other;
+        int calls;
+    };
+    TransitionTimer first;
+    TransitionTimer second;
+    Context firstContext{ &scheduler, &second, 0 };
+    Context secondContext{ &scheduler, &first, 0 };
+
+    // Whichever callback runs first cancels the other, even though both are due.
+    auto cancelOther = [](void * context) {
+        auto * ctx = static_cast<Context *>(context);
+        ctx->calls++;
+        ctx->scheduler->CancelTimer(*ctx->other);
+    };
+
+    EXPECT_EQ(scheduler.StartTimer(mLayer, first, 100_ms, cancelOther, &firstContext), CHIP_NO_ERROR);
+    EXPECT_EQ(scheduler.StartTimer(mLayer, second, 100_ms, cancelOther, &secondContext), CHIP_NO_ERROR);
+    mLayer.FireTimer(mClock);
+    EXPECT_EQ(firstContext.calls + secondContext.calls, 1);
+    EXPECT_FALSE(first.IsScheduled());
+    EXPECT_FALSE(second.IsScheduled());
+    EXPECT_FALSE(mLayer.HasTimer());
+
+    // A timer restarted with no delay from its callback runs on the next tick, not in the same one.
+    FakeTransition transition;
+    transition.scheduler = &scheduler;
+    transition.layer     = &mLayer;
+    transition.steps     = 2;
+    EXPECT_EQ(scheduler.StartTimer(mLayer, transition.timer, 0_ms, FakeTransition::TickWithoutDelay, &transition), CHIP_NO_ERROR);
+
+    mLayer.FireTimer(mClock);
+    EXPECT_EQ(transition.ticks, 1u);
+    EXPECT_TRUE(transition.timer.IsScheduled());
+    EXPECT_EQ(mLayer.Deadline(), mClock.GetMonotonicTimestamp());
+
+    mLayer.FireTimer(mClock);
+    EXPECT_EQ(transition.ticks, 2u);
+    EXPECT_FALSE(transition.timer.IsScheduled());
+    EXPECT_FALSE(mLayer.HasTimer());
+}
+
+TEST_F(TestTransitionScheduler, TestManyTransitions)
+{
+    // 200 endpoints running a 30 s transition, started over a couple of tick periods.
+    constexpr size_t kTransitionCount = 200;
+    constexpr uint32_t kSteps         = 300;
+
+    TransitionScheduler scheduler;
+    FakeTransition transitions[kTransitionCount];
+    for (size_t i = 0; i < kTransitionCount; i++)
+    {
+        while (mLayer.HasTimer() && mLayer.Deadline() <= Timestamp(i))
+        {
+            mLayer.FireTimer(mClock);
+        }
+        mClock.SetMonotonic(Timestamp(i));
+
+        auto & transition    = transitions[i];
+        transition.scheduler = &scheduler;
+        transition.layer     = &mLayer;
+        transition.steps     = kSteps;
+        EXPECT_EQ(scheduler.StartTimer(mLayer, transition.timer, FakeTransition::kTickPeriod, FakeTransition::Tick, &transition),
+                  CHIP_NO_ERROR);
+    }
+
+    while (mLayer.HasTimer())
+    {
+        mLayer.FireTimer(mClock);
+    }
+
+    for (size_t i = 0; i < kTransitionCount; i++)
+    {
+        EXPECT_EQ(transitions[i].ticks, kSteps);
+        EXPECT_FALSE(transitions[i].timer.IsScheduled());
+        // Coalescing never runs a tick early, so no transition ends early. Ticks are only delayed while the transitions
+        // converge on shared ticks, which does not add up to more than about a tick period over the whole transition.
+        EXPECT_GE(transitions[i].lastTick, Timestamp(i) + kSteps * FakeTransition::kTickPeriod);
+        EXPECT_LE(transitions[i].lastTick,
+                  Timestamp(i) + (kSteps + 1) * FakeTransition::kTickPeriod + TransitionScheduler::kDefaultCoalescingWindow);
+    }
+
+    // One system timer per tick period for all the transitions, plus the first ticks before they are aligned, instead
+    // of one per transition and tick.
+    EXPECT_LE(mLayer.mFireCount, kSteps + 4);
+    EXPECT_EQ(scheduler.ScheduledTimerCount(), 0u);
+}
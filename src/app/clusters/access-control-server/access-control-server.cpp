@@ -46,6 +46,10 @@ constexpr int kExtensionDataMaxLength = 128;
 
 constexpr uint16_t kClusterRevision = 1;
 
+// Layout of the list resume cursor used when chunking the ACL attribute.
+constexpr uint32_t kAclCursorFabricShift = 16;
+constexpr uint32_t kAclCursorEntryMask   = (1u << kAclCursorFabricShift) - 1;
+
 namespace {
 
 class AccessControlAttribute : public AttributeAccessInterface, public EntryListener
@@ -172,16 +176,40 @@ CHIP_ERROR AccessControlAttribute::ReadAcl(AttributeValueEncoder & aEncoder)
     AccessControl::Entry entry;
     AclStorage::EncodableEntry encodableEntry(entry);
     return aEncoder.EncodeList([&](const auto & encoder) -> CHIP_ERROR {
+        // The list resume cursor packs the position of the fabric in the fabric table (upper bits) and the
+        // index of the entry relative to that fabric (lower bits), so a chunked read skips the fabrics that
+        // were already sent. Entries are visited with a single iterator pass per fabric, since reading them by
+        // index rescans the list for every entry; the iterator cannot seek, so on the fabric where the read
+        // resumes, the entries before the cursor are still visited but not handed to the encoder.
+        uint32_t resumeCursor;
+        ReturnErrorOnFailure(encoder.ResumeCursor(resumeCursor));
+        const uint32_t resumeFabricPos = resumeCursor >> kAclCursorFabricShift;
+        uint32_t fabricPos             = 0;
         for (auto & info : Server::GetInstance().GetFabricTable())
         {
-            auto fabric = info.GetFabricIndex();
+            if (fabricPos < resumeFabricPos)
+            {
+                fabricPos++;
+                continue;
+            }
+
+            auto fabric            = info.GetFabricIndex();
+            const uint32_t skipped = (fabricPos == resumeFabricPos) ? (resumeCursor & kAclCursorEntryMask) : 0;
+            uint32_t index         = 0;
+            CHIP_ERROR err         = CHIP_NO_ERROR;
             ReturnErrorOnFailure(GetAccessControl().Entries(fabric, iterator));
-            CHIP_ERROR err = CHIP_NO_ERROR;
             while ((err = iterator.Next(entry)) == CHIP_NO_ERROR)
             {
-                ReturnErrorOnFailure(encoder.Encode(encodableEntry));
+                VerifyOrReturnError(index < kAclCursorEntryMask, CHIP_ERROR_INCORRECT_STATE);
+                if (index++ < skipped)
+                {
+                    continue;
+                }
+                const uint32_t nextCursor = (fabricPos << kAclCursorFabricShift) | index;
+                ReturnErrorOnFailure(encoder.EncodeAt(nextCursor, encodableEntry));
             }
             ReturnErrorCodeIf(err != CHIP_NO_ERROR && err != CHIP_ERROR_SENTINEL, err);
+            fabricPos++;
         }
         return CHIP_NO_ERROR;
     });
@@ -193,8 +221,17 @@ CHIP_ERROR AccessControlAttribute::ReadExtension(AttributeValueEncoder & aEncode
     auto & fabrics = Server::GetInstance().GetFabricTable();
 
     return aEncoder.EncodeList([&](const auto & encoder) -> CHIP_ERROR {
+        // The list resume cursor is the position in the fabric table of the next fabric to look at.
+        uint32_t resumeFabricPos;
+        ReturnErrorOnFailure(encoder.ResumeCursor(resumeFabricPos));
+        uint32_t fabricPos = 0;
         for (auto & fabric : fabrics)
         {
+            if (fabricPos++ < resumeFabricPos)
+            {
+                continue;
+            }
+
             uint8_t buffer[kExtensionDataMaxLength] = { 0 };
             uint16_t size                           = static_cast<uint16_t>(sizeof(buffer));
             CHIP_ERROR errStorage                   = storage.SyncGetKeyValue(
@@ -209,7 +246,7 @@ CHIP_ERROR AccessControlAttribute::ReadExtension(AttributeValueEncoder & aEncode
                 .data        = ByteSpan(buffer, size),
                 .fabricIndex = fabric.GetFabricIndex(),
             };
-            ReturnErrorOnFailure(encoder.Encode(item));
+            ReturnErrorOnFailure(encoder.EncodeAt(fabricPos, item));
         }
         return CHIP_NO_ERROR;
     });
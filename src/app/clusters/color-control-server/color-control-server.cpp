@@ -414,15 +414,18 @@ static DefaultColorControlSceneHandler sColorControlSceneHandler;
  * Matter timer scheduling glue logic
  *********************************************************/
 
-void ColorControlServer::timerCallback(System::Layer *, void * callbackContext)
+void ColorControlServer::timerCallback(void * callbackContext)
 {
     auto control = static_cast<EmberEventControl *>(callbackContext);
     (control->callback)(control->endpoint);
 }
 
+// The transitions of all the endpoints, and those of the Level Control server, share the ticks of a single scheduler.
 void ColorControlServer::scheduleTimerCallbackMs(EmberEventControl * control, uint32_t delayMs)
 {
-    CHIP_ERROR err = DeviceLayer::SystemLayer().StartTimer(chip::System::Clock::Milliseconds32(delayMs), timerCallback, control);
+    TransitionTimer & timer = transitionTimers[control - eventControls];
+    CHIP_ERROR err          = TransitionScheduler::Instance().StartTimer(
+        DeviceLayer::SystemLayer(), timer, System::Clock::Milliseconds32(delayMs), timerCallback, control);
 
     if (err != CHIP_NO_ERROR)
     {
@@ -432,7 +435,7 @@ void ColorControlServer::scheduleTimerCallbackMs(EmberEventControl * control, ui
 
 void ColorControlServer::cancelEndpointTimerCallback(EmberEventControl * control)
 {
-    DeviceLayer::SystemLayer().CancelTimer(timerCallback, control);
+    TransitionScheduler::Instance().CancelTimer(transitionTimers[control - eventControls]);
 }
 
 void ColorControlServer::cancelEndpointTimerCallback(EndpointId endpoint)
@@ -21,6 +21,7 @@
 #include <app/CommandHandler.h>
 #include <app/ConcreteCommandPath.h>
 #include <app/cluster-building-blocks/QuieterReporting.h>
+#include <app/cluster-building-blocks/TransitionScheduler.h>
 #include <app/data-model/Nullable.h>
 #include <app/util/af-types.h>
 #include <app/util/attribute-storage.h>
@@ -234,7 +235,7 @@ private:
     bool computeNewColor16uValue(Color16uTransitionState * p);
 
     // Matter timer scheduling glue logic
-    static void timerCallback(chip::System::Layer *, void * callbackContext);
+    static void timerCallback(void * callbackContext);
     void scheduleTimerCallbackMs(EmberEventControl * control, uint32_t delayMs);
     void cancelEndpointTimerCallback(EmberEventControl * control);
     uint16_t getEndpointIndex(chip::EndpointId);
@@ -313,6 +314,7 @@ private:
 #endif // MATTER_DM_PLUGIN_COLOR_CONTROL_SERVER_TEMP
 
     EmberEventControl eventControls[kColorControlClusterServerMaxEndpointCount];
+    chip::app::TransitionTimer transitionTimers[kColorControlClusterServerMaxEndpointCount];
     chip::app::QuieterReportingAttribute<uint16_t> quietRemainingTime[kColorControlClusterServerMaxEndpointCount];
 
 #ifdef MATTER_DM_PLUGIN_SCENES_MANAGEMENT
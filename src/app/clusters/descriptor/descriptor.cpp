@@ -40,6 +40,126 @@ using namespace chip::app::Clusters::Descriptor::Attributes;
 
 namespace {
 
+/// Calls callback(EndpointId) for every endpoint in the PartsList of the given endpoint, which must be endpoint 0 or have flat
+/// or tree composition.
+template <typename Callback>
+CHIP_ERROR ForEachPart(EndpointId endpoint, Callback && callback)
+{
+    if (endpoint == 0x00)
+    {
+        for (uint16_t index = 0; index < emberAfEndpointCount(); index++)
+        {
+            if (emberAfEndpointIndexIsEnabled(index))
+            {
+                EndpointId endpointId = emberAfEndpointFromIndex(index);
+                if (endpointId == 0)
+                    continue;
+
+                ReturnErrorOnFailure(callback(endpointId));
+            }
+        }
+    }
+    else if (IsFlatCompositionForEndpoint(endpoint))
+    {
+        for (uint16_t index = 0; index < emberAfEndpointCount(); index++)
+        {
+            if (!emberAfEndpointIndexIsEnabled(index))
+                continue;
+
+            uint16_t childIndex = index;
+            while (childIndex != chip::kInvalidListIndex)
+            {
+                EndpointId parentEndpointId = emberAfParentEndpointFromIndex(childIndex);
+                if (parentEndpointId == chip::kInvalidEndpointId)
+                    break;
+
+                if (parentEndpointId == endpoint)
+                {
+                    ReturnErrorOnFailure(callback(emberAfEndpointFromIndex(index)));
+                    break;
+                }
+
+                childIndex = emberAfIndexFromEndpoint(parentEndpointId);
+            }
+        }
+    }
+    else if (IsTreeCompositionForEndpoint(endpoint))
+    {
+        for (uint16_t index = 0; index < emberAfEndpointCount(); index++)
+        {
+            if (!emberAfEndpointIndexIsEnabled(index))
+                continue;
+
+            EndpointId parentEndpointId = emberAfParentEndpointFromIndex(index);
+            if (parentEndpointId == endpoint)
+            {
+                ReturnErrorOnFailure(callback(emberAfEndpointFromIndex(index)));
+            }
+        }
+    }
+
+    return CHIP_NO_ERROR;
+}
+
+#if CHIP_CONFIG_DESCRIPTOR_PARTS_LIST_CACHE_SIZE > 0
+/// PartsList of the most recently read endpoints, valid until the endpoint composition changes.
+class PartsListCache
+{
+public:
+    struct Entry
+    {
+        EndpointId endpoint = kInvalidEndpointId;
+        uint32_t generation = 0;
+        uint32_t lastUse    = 0;
+        uint16_t count      = 0;
+        EndpointId parts[MAX_ENDPOINT_COUNT];
+    };
+
+    /// Gets the PartsList of the endpoint, computing it if it is not cached or no longer valid.
+    CHIP_ERROR Get(EndpointId endpoint, const Entry *& entry)
+    {
+        const uint32_t generation = GetEndpointCompositionGeneration();
+        Entry * target            = nullptr;
+
+        for (auto & candidate : mEntries)
+        {
+            if (candidate.endpoint == endpoint)
+            {
+                target = &candidate;
+                break;
+            }
+            if (target == nullptr || candidate.lastUse < target->lastUse)
+            {
+                target = &candidate;
+            }
+        }
+
+        if (target->endpoint != endpoint || target->generation != generation)
+        {
+            target->endpoint   = kInvalidEndpointId;
+            target->generation = generation;
+            target->count      = 0;
+            ReturnErrorOnFailure(ForEachPart(endpoint, [target](EndpointId part) {
+                VerifyOrReturnError(target->count < MAX_ENDPOINT_COUNT, CHIP_ERROR_NO_MEMORY);
+                target->parts[target->count++] = part;
+                return CHIP_NO_ERROR;
+            }));
+            target->endpoint = endpoint;
+        }
+
+        target->lastUse = ++mUseCounter;
+        entry           = target;
+        return CHIP_NO_ERROR;
+    }
+
+private:
+    Entry mEntries[CHIP_CONFIG_DESCRIPTOR_PARTS_LIST_CACHE_SIZE];
+    uint32_t mUseCounter = 0;
+};
+
+PartsListCache gPartsListCache;
+#endif // CHIP_CONFIG_DESCRIPTOR_PARTS_LIST_CACHE_SIZE > 0
+
 class DescriptorAttrAccess : public AttributeAccessInterface
 {
 public:
@@ -91,74 +211,27 @@ CHIP_ERROR DescriptorAttrAccess::ReadTagListAttribute(EndpointId endpoint, Attri
 
 CHIP_ERROR DescriptorAttrAccess::ReadPartsAttribute(EndpointId endpoint, AttributeValueEncoder & aEncoder)
 {
-    CHIP_ERROR err = CHIP_NO_ERROR;
-
-    if (endpoint == 0x00)
-    {
-        err = aEncoder.EncodeList([](const auto & encoder) -> CHIP_ERROR {
-            for (uint16_t index = 0; index < emberAfEndpointCount(); index++)
-            {
-                if (emberAfEndpointIndexIsEnabled(index))
-                {
-                    EndpointId endpointId = emberAfEndpointFromIndex(index);
-                    if (endpointId == 0)
-                        continue;
-
-                    ReturnErrorOnFailure(encoder.Encode(endpointId));
-                }
-            }
-
-            return CHIP_NO_ERROR;
-        });
-    }
-    else if (IsFlatCompositionForEndpoint(endpoint))
+    if (endpoint != 0x00 && !IsFlatCompositionForEndpoint(endpoint) && !IsTreeCompositionForEndpoint(endpoint))
     {
-        err = aEncoder.EncodeList([endpoint](const auto & encoder) -> CHIP_ERROR {
-            for (uint16_t index = 0; index < emberAfEndpointCount(); index++)
-            {
-                if (!emberAfEndpointIndexIsEnabled(index))
-                    continue;
-
-                uint16_t childIndex = index;
-                while (childIndex != chip::kInvalidListIndex)
-                {
-                    EndpointId parentEndpointId = emberAfParentEndpointFromIndex(childIndex);
-                    if (parentEndpointId == chip::kInvalidEndpointId)
-                        break;
-
-                    if (parentEndpointId == endpoint)
-                    {
-                        ReturnErrorOnFailure(encoder.Encode(emberAfEndpointFromIndex(index)));
-                        break;
-                    }
-
-                    childIndex = emberAfIndexFromEndpoint(parentEndpointId);
-                }
-            }
-
-            return CHIP_NO_ERROR;
-        });
+        return CHIP_NO_ERROR;
     }
-    else if (IsTreeCompositionForEndpoint(endpoint))
-    {
-        err = aEncoder.EncodeList([endpoint](const auto & encoder) -> CHIP_ERROR {
-            for (uint16_t index = 0; index < emberAfEndpointCount(); index++)
-            {
-                if (!emberAfEndpointIndexIsEnabled(index))
-                    continue;
-
-                EndpointId parentEndpointId = emberAfParentEndpointFromIndex(index);
-                if (parentEndpointId == endpoint)
-                {
-                    ReturnErrorOnFailure(encoder.Encode(emberAfEndpointFromIndex(index)));
-                }
-            }
 
-            return CHIP_NO_ERROR;
-        });
-    }
+#if CHIP_CONFIG_DESCRIPTOR_PARTS_LIST_CACHE_SIZE > 0
+    const PartsListCache::Entry * parts = nullptr;
+    ReturnErrorOnFailure(gPartsListCache.Get(endpoint, parts));
 
-    return err;
+    return aEncoder.EncodeList([parts](const auto & encoder) -> CHIP_ERROR {
+        for (uint16_t i = 0; i < parts->count; i++)
+        {
+            ReturnErrorOnFailure(encoder.Encode(parts->parts[i]));
+        }
+        return CHIP_NO_ERROR;
+    });
+#else
+    return aEncoder.EncodeList([endpoint](const auto & encoder) -> CHIP_ERROR {
+        return ForEachPart(endpoint, [&encoder](EndpointId part) { return encoder.Encode(part); });
+    });
+#endif // CHIP_CONFIG_DESCRIPTOR_PARTS_LIST_CACHE_SIZE > 0
 }
 
 CHIP_ERROR DescriptorAttrAccess::ReadDeviceAttribute(EndpointId endpoint, AttributeValueEncoder & aEncoder)
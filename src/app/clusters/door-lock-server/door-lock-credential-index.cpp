@@ -0,0 +1,308 @@
+/*
+ *
+ *    Copyright (c) 2024 Project CHIP Authors
+ *
+ *    Licensed under the Apache License, Version 2.0 (the "License");
+ *    you may not use this file except in compliance with the License.
+ *    You may obtain a copy of the License at
+ *
+ *        http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *    Unless required by applicable law or agreed to in writing, software
+ *    distributed under the License is distributed on an "AS IS" BASIS,
+ *    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *    See the License for the specific language governing permissions and
+ *    limitations under the License.
+ */
+
+#include "door-lock-credential-index.h"
+
+#include <lib/support/CodeUtils.h>
+
+namespace chip {
+namespace app {
+namespace Clusters {
+namespace DoorLock {
+
+namespace {
+
+constexpr size_t kBitsPerWord = 32;
+
+size_t WordsForBits(size_t bits)
+{
+    return (bits + kBitsPerWord - 1) / kBitsPerWord;
+}
+
+} // namespace
+
+CHIP_ERROR CredentialIndex::Init(uint16_t numberOfUsers, const uint16_t (&numberOfCredentials)[kNumberOfCredentialTypes])
+{
+    Clear();
+
+    size_t totalCredentials = 0;
+    for (size_t type = 0; type < kNumberOfCredentialTypes; type++)
+    {
+        uint16_t count = (type == to_underlying(CredentialTypeEnum::kProgrammingPIN)) ? 0 : numberOfCredentials[type];
+        VerifyOrReturnError(totalCredentials + count <= kMaxCredentials, CHIP_ERROR_INVALID_ARGUMENT);
+
+        mNumberOfCredentials[type] = count;
+        mFirstSlot[type]           = static_cast<uint16_t>(totalCredentials);
+        mOccupiedCredentials[type] = 0;
+        totalCredentials += count;
+    }
+
+    // Keep the load factor of the hash table at or below 1/2, so that probe sequences stay short.
+    size_t hashTableSize = 2;
+    while (hashTableSize < 2 * totalCredentials)
+    {
+        hashTableSize *= 2;
+    }
+
+    mUserOccupied.Calloc(WordsForBits(numberOfUsers) + 1);
+    mCredentialOccupied.Calloc(WordsForBits(totalCredentials) + 1);
+    mSlots.Calloc(totalCredentials + 1);
+    mHashTable.Calloc(hashTableSize);
+    if (!mUserOccupied || !mCredentialOccupied || !mSlots || !mHashTable)
+    {
+        Clear();
+        return CHIP_ERROR_NO_MEMORY;
+    }
+
+    mNumberOfUsers = numberOfUsers;
+    mHashTableMask = hashTableSize - 1;
+    return CHIP_NO_ERROR;
+}
+
+void CredentialIndex::Clear()
+{
+    mUserOccupied.Free();
+    mCredentialOccupied.Free();
+    mSlots.Free();
+    mHashTable.Free();
+    mNumberOfUsers = 0;
+    mHashTableMask = 0;
+}
+
+bool CredentialIndex::IsIndexed(CredentialTypeEnum credentialType) const
+{
+    return IsInitialized() && to_underlying(credentialType) < kNumberOfCredentialTypes &&
+        mNumberOfCredentials[to_underlying(credentialType)] > 0;
+}
+
+void CredentialIndex::SetUserOccupied(uint16_t userIndex, bool occupied)
+{
+    VerifyOrReturn(IsInitialized() && userIndex >= 1 && userIndex <= mNumberOfUsers);
+    SetBit(mUserOccupied.Get(), userIndex - 1u, occupied);
+}
+
+bool CredentialIndex::FindUser(uint16_t startIndex, bool occupied, uint16_t & userIndex) const
+{
+    VerifyOrReturnValue(IsInitialized() && startIndex >= 1 && startIndex <= mNumberOfUsers, false);
+
+    size_t bit = FindBit(mUserOccupied.Get(), startIndex - 1u, mNumberOfUsers, occupied);
+    VerifyOrReturnValue(bit < mNumberOfUsers, false);
+
+    userIndex = static_cast<uint16_t>(bit + 1);
+    return true;
+}
+
+void CredentialIndex::SetCredential(CredentialTypeEnum credentialType, uint16_t credentialIndex, const ByteSpan & credentialData)
+{
+    size_t slot;
+    VerifyOrReturn(GetSlot(credentialType, credentialIndex, slot));
+
+    if (GetBit(mCredentialOccupied.Get(), slot))
+    {
+        RemoveHash(slot);
+    }
+    else
+    {
+        SetBit(mCredentialOccupied.Get(), slot, true);
+        mOccupiedCredentials[to_underlying(credentialType)]++;
+    }
+
+    mSlots[slot].hash = Hash(credentialType, credentialData);
+    InsertHash(slot);
+}
+
+void CredentialIndex::ClearCredential(CredentialTypeEnum credentialType, uint16_t credentialIndex)
+{
+    size_t slot;
+    VerifyOrReturn(GetSlot(credentialType, credentialIndex, slot));
+
+    mSlots[slot].userIndex = 0;
+    VerifyOrReturn(GetBit(mCredentialOccupied.Get(), slot));
+
+    RemoveHash(slot);
+    SetBit(mCredentialOccupied.Get(), slot, false);
+    mOccupiedCredentials[to_underlying(credentialType)]--;
+}
+
+bool CredentialIndex::FindCredential(CredentialTypeEnum credentialType, uint16_t startIndex, bool occupied,
+                                     uint16_t & credentialIndex) const
+{
+    size_t slot;
+    VerifyOrReturnValue(GetSlot(credentialType, startIndex, slot), false);
+
+    size_t end = mFirstSlot[to_underlying(credentialType)] + mNumberOfCredentials[to_underlying(credentialType)];
+    slot       = FindBit(mCredentialOccupied.Get(), slot, end, occupied);
+    VerifyOrReturnValue(slot < end, false);
+
+    credentialIndex = static_cast<uint16_t>(slot - mFirstSlot[to_underlying(credentialType)] + 1);
+    return true;
+}
+
+size_t CredentialIndex::CountOccupiedCredentials(CredentialTypeEnum credentialType) const
+{
+    VerifyOrReturnValue(IsIndexed(credentialType), 0);
+    return mOccupiedCredentials[to_underlying(credentialType)];
+}
+
+void CredentialIndex::SetCredentialUser(CredentialTypeEnum credentialType, uint16_t credentialIndex, uint16_t userIndex)
+{
+    size_t slot;
+    VerifyOrReturn(GetSlot(credentialType, credentialIndex, slot));
+    mSlots[slot].userIndex = userIndex;
+}
+
+uint16_t CredentialIndex::GetCredentialUser(CredentialTypeEnum credentialType, uint16_t credentialIndex) const
+{
+    size_t slot;
+    VerifyOrReturnValue(GetSlot(credentialType, credentialIndex, slot), 0);
+    return mSlots[slot].userIndex;
+}
+
+bool CredentialIndex::NextCandidate(CredentialTypeEnum credentialType, const ByteSpan & credentialData, size_t & cursor,
+                                    uint16_t & credentialIndex) const
+{
+    VerifyOrReturnValue(IsIndexed(credentialType), false);
+
+    const uint32_t hash = Hash(credentialType, credentialData);
+    const size_t first  = mFirstSlot[to_underlying(credentialType)];
+    const size_t end    = first + mNumberOfCredentials[to_underlying(credentialType)];
+
+    // The cursor counts the probes done so far. The table is never full, so the probe sequence ends at an empty entry.
+    for (; cursor <= mHashTableMask; cursor++)
+    {
+        uint16_t entry = mHashTable[(hash + cursor) & mHashTableMask];
+        VerifyOrReturnValue(entry != 0, false);
+
+        size_t slot = entry - 1u;
+        if (mSlots[slot].hash == hash && slot >= first && slot < end)
+        {
+            cursor++;
+            credentialIndex = static_cast<uint16_t>(slot - first + 1);
+            return true;
+        }
+    }
+
+    return false;
+}
+
+uint32_t CredentialIndex::Hash(CredentialTypeEnum credentialType, const ByteSpan & credentialData)
+{
+    // 32-bit FNV-1a over the credential type and data.
+    uint32_t hash = 2166136261u;
+    hash          = (hash ^ to_underlying(credentialType)) * 16777619u;
+    for (uint8_t byte : credentialData)
+    {
+        hash = (hash ^ byte) * 16777619u;
+    }
+    return hash;
+}
+
+bool CredentialIndex::GetBit(const uint32_t * bitmap, size_t bit)
+{
+    return (bitmap[bit / kBitsPerWord] & (1u << (bit % kBitsPerWord))) != 0;
+}
+
+void CredentialIndex::SetBit(uint32_t * bitmap, size_t bit, bool value)
+{
+    if (value)
+    {
+        bitmap[bit / kBitsPerWord] |= (1u << (bit % kBitsPerWord));
+    }
+    else
+    {
+        bitmap[bit / kBitsPerWord] &= ~(1u << (bit % kBitsPerWord));
+    }
+}
+
+size_t CredentialIndex::FindBit(const uint32_t * bitmap, size_t start, size_t end, bool value)
+{
+    size_t bit = start;
+    while (bit < end)
+    {
+        uint32_t word = bitmap[bit / kBitsPerWord];
+        if (!value)
+        {
+            word = ~word;
+        }
+        word &= UINT32_MAX << (bit % kBitsPerWord);
+
+        if (word == 0)
+        {
+            // Skip the whole word.
+            bit = (bit / kBitsPerWord + 1) * kBitsPerWord;
+            continue;
+        }
+
+        bit -= bit % kBitsPerWord;
+        while ((word & 1u) == 0)
+        {
+            word >>= 1;
+            bit++;
+        }
+        return (bit < end) ? bit : end;
+    }
+    return end;
+}
+
+bool CredentialIndex::GetSlot(CredentialTypeEnum credentialType, uint16_t credentialIndex, size_t & slot) const
+{
+    VerifyOrReturnValue(IsIndexed(credentialType), false);
+    VerifyOrReturnValue(credentialIndex >= 1 && credentialIndex <= mNumberOfCredentials[to_underlying(credentialType)], false);
+
+    slot = mFirstSlot[to_underlying(credentialType)] + credentialIndex - 1u;
+    return true;
+}
+
+void CredentialIndex::InsertHash(size_t slot)
+{
+    size_t position = mSlots[slot].hash & mHashTableMask;
+    while (mHashTable[position] != 0)
+    {
+        position = (position + 1) & mHashTableMask;
+    }
+    mHashTable[position] = static_cast<uint16_t>(slot + 1);
+}
+
+void CredentialIndex::RemoveHash(size_t slot)
+{
+    size_t hole = mSlots[slot].hash & mHashTableMask;
+    while (mHashTable[hole] != slot + 1)
+    {
+        VerifyOrReturn(mHashTable[hole] != 0);
+        hole = (hole + 1) & mHashTableMask;
+    }
+
+    // Backward shift deletion: move later entries of the probe sequence into the hole if their home position allows it,
+    // so that no tombstones are needed.
+    size_t next = (hole + 1) & mHashTableMask;
+    while (mHashTable[next] != 0)
+    {
+        size_t home = mSlots[mHashTable[next] - 1u].hash & mHashTableMask;
+        if (((next - home) & mHashTableMask) >= ((next - hole) & mHashTableMask))
+        {
+            mHashTable[hole] = mHashTable[next];
+            hole             = next;
+        }
+        next = (next + 1) & mHashTableMask;
+    }
+    mHashTable[hole] = 0;
+}
+
+} // namespace DoorLock
+} // namespace Clusters
+} // namespace app
+} // namespace chip
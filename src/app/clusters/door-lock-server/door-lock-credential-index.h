@@ -0,0 +1,133 @@
+/*
+ *
+ *    Copyright (c) 2024 Project CHIP Authors
+ *
+ *    Licensed under the Apache License, Version 2.0 (the "License");
+ *    you may not use this file except in compliance with the License.
+ *    You may obtain a copy of the License at
+ *
+ *        http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *    Unless required by applicable law or agreed to in writing, software
+ *    distributed under the License is distributed on an "AS IS" BASIS,
+ *    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *    See the License for the specific language governing permissions and
+ *    limitations under the License.
+ */
+
+#pragma once
+
+#include <app-common/zap-generated/cluster-enums.h>
+#include <lib/core/CHIPError.h>
+#include <lib/support/ScopedBuffer.h>
+#include <lib/support/Span.h>
+#include <lib/support/TypeTraits.h>
+
+#include <cstddef>
+#include <cstdint>
+
+namespace chip {
+namespace app {
+namespace Clusters {
+namespace DoorLock {
+
+/**
+ * In-memory index of the users and credentials of a door lock endpoint.
+ *
+ * The Door Lock server keeps users and credentials in the application and can only access them one slot at a time, so
+ * duplicate detection, free slot searches and credential to user lookups cost one application callback per slot. The
+ * index mirrors the occupancy of every slot, the user owning each credential and a hash of the credential data, so that
+ * these lookups cost at most a few callbacks instead.
+ *
+ * Credential data is not kept: a credential whose data hash matches is only a candidate, which has to be confirmed
+ * against the application. The programming PIN, which has a single slot at index 0, is not indexed.
+ *
+ * User and credential indices are 1-based, as in the Door Lock cluster. Updates for slots that are out of range or for
+ * credential types that are not indexed are ignored.
+ */
+class CredentialIndex
+{
+public:
+    static constexpr size_t kNumberOfCredentialTypes = to_underlying(CredentialTypeEnum::kUnknownEnumValue);
+    static constexpr size_t kMaxCredentials          = UINT16_MAX - 1;
+
+    /**
+     * Allocate an empty index for the given number of users and number of credentials of each type.
+     *
+     * The number of credentials of the programming PIN is ignored. Fails with CHIP_ERROR_INVALID_ARGUMENT if there are
+     * more than kMaxCredentials credentials in total.
+     */
+    CHIP_ERROR Init(uint16_t numberOfUsers, const uint16_t (&numberOfCredentials)[kNumberOfCredentialTypes]);
+
+    /// Release the memory of the index. The index has to be initialized again before use.
+    void Clear();
+
+    bool IsInitialized() const { return mUserOccupied.Get() != nullptr; }
+
+    bool IsIndexed(CredentialTypeEnum credentialType) const;
+
+    void SetUserOccupied(uint16_t userIndex, bool occupied);
+
+    /// Find the first user at or after startIndex that is (or is not) occupied.
+    bool FindUser(uint16_t startIndex, bool occupied, uint16_t & userIndex) const;
+
+    /// Mark the credential as occupied with the given data, which replaces any previous data.
+    void SetCredential(CredentialTypeEnum credentialType, uint16_t credentialIndex, const ByteSpan & credentialData);
+
+    /// Mark the credential as available. It is no longer owned by any user.
+    void ClearCredential(CredentialTypeEnum credentialType, uint16_t credentialIndex);
+
+    /// Find the first credential of the given type at or after startIndex that is (or is not) occupied.
+    bool FindCredential(CredentialTypeEnum credentialType, uint16_t startIndex, bool occupied, uint16_t & credentialIndex) const;
+
+    size_t CountOccupiedCredentials(CredentialTypeEnum credentialType) const;
+
+    /// Set the user owning the credential, or 0 if it is not owned by any user.
+    void SetCredentialUser(CredentialTypeEnum credentialType, uint16_t credentialIndex, uint16_t userIndex);
+
+    /// Get the user owning the credential, or 0 if it is not owned by any user.
+    uint16_t GetCredentialUser(CredentialTypeEnum credentialType, uint16_t credentialIndex) const;
+
+    /**
+     * Iterate over the occupied credentials of the given type whose data hashes like credentialData.
+     *
+     * cursor has to be 0 on the first call and is updated for the next one. Returns false when there are no more
+     * candidates.
+     */
+    bool NextCandidate(CredentialTypeEnum credentialType, const ByteSpan & credentialData, size_t & cursor,
+                       uint16_t & credentialIndex) const;
+
+private:
+    struct Slot
+    {
+        uint32_t hash;
+        uint16_t userIndex;
+    };
+
+    static uint32_t Hash(CredentialTypeEnum credentialType, const ByteSpan & credentialData);
+    static bool GetBit(const uint32_t * bitmap, size_t bit);
+    static void SetBit(uint32_t * bitmap, size_t bit, bool value);
+    static size_t FindBit(const uint32_t * bitmap, size_t start, size_t end, bool value);
+
+    bool GetSlot(CredentialTypeEnum credentialType, uint16_t credentialIndex, size_t & slot) const;
+    void InsertHash(size_t slot);
+    void RemoveHash(size_t slot);
+
+    uint16_t mNumberOfUsers = 0;
+    uint16_t mNumberOfCredentials[kNumberOfCredentialTypes];
+    uint16_t mFirstSlot[kNumberOfCredentialTypes];
+    uint16_t mOccupiedCredentials[kNumberOfCredentialTypes];
+
+    Platform::ScopedMemoryBuffer<uint32_t> mUserOccupied;
+    Platform::ScopedMemoryBuffer<uint32_t> mCredentialOccupied;
+    Platform::ScopedMemoryBuffer<Slot> mSlots;
+
+    // Open addressing hash table of the occupied slots, with linear probing. Entries are slot + 1, 0 is empty.
+    Platform::ScopedMemoryBuffer<uint16_t> mHashTable;
+    size_t mHashTableMask = 0;
+};
+
+} // namespace DoorLock
+} // namespace Clusters
+} // namespace app
+} // namespace chip
@@ -116,6 +116,7 @@ CHIP_ERROR DoorLockServer::InitEndpoint(EndpointId endpointId, Delegate * delega
     endpointContext->lockoutEndTimestamp    = endpointContext->lockoutEndTimestamp.zero();
     endpointContext->wrongCodeEntryAttempts = 0;
     endpointContext->delegate               = delegate;
+    InvalidateCredentialIndex(endpointId);
     return CHIP_NO_ERROR;
 }
 
@@ -129,6 +130,7 @@ void DoorLockServer::ShutdownEndpoint(EndpointId endpointId)
     }
 
     endpointContext->delegate = nullptr;
+    InvalidateCredentialIndex(endpointId);
 }
 
 CHIP_ERROR DoorLockServer::SetDelegate(chip::EndpointId endpointId, chip::app::Clusters::DoorLock::Delegate * delegate)
@@ -147,6 +149,8 @@ CHIP_ERROR DoorLockServer::SetDelegate(chip::EndpointId endpointId, chip::app::C
     }
 
     endpointContext->delegate = delegate;
+    // The number of Aliro credentials comes from the delegate.
+    InvalidateCredentialIndex(endpointId);
     return CHIP_NO_ERROR;
 }
 
@@ -305,6 +309,18 @@ void DoorLockServer::ResetWrongCodeEntryAttempts(chip::EndpointId endpointId)
     endpointContext->wrongCodeEntryAttempts = 0;
 }
 
+void DoorLockServer::InvalidateCredentialIndex(chip::EndpointId endpointId)
+{
+#if DOOR_LOCK_SERVER_CREDENTIAL_INDEX
+    auto endpointContext = getContext(endpointId);
+    if (nullptr == endpointContext)
+    {
+        return;
+    }
+    endpointContext->credentialIndex.Clear();
+#endif
+}
+
 bool DoorLockServer::engageLockout(chip::EndpointId endpointId)
 {
     uint8_t lockoutTimeout;
@@ -724,26 +740,23 @@ void DoorLockServer::setCredentialCommandHandler(
     }
 
     // appclusters, 5.2.4.41.1: we should return DUPLICATE in the response if we're trying to create duplicated credential entry
-    for (uint16_t i = 1; CredentialTypeEnum::kProgrammingPIN != credentialType && (i <= maxNumberOfCredentials); ++i)
+    if (CredentialTypeEnum::kProgrammingPIN != credentialType)
     {
-        EmberAfPluginDoorLockCredentialInfo currentCredential;
-        if (!emberAfPluginDoorLockGetCredential(commandPath.mEndpointId, i, credentialType, currentCredential))
+        bool duplicateFound              = false;
+        uint16_t existingCredentialIndex = 0;
+        if (!findDuplicateCredential(commandPath.mEndpointId, credentialType, credentialData, maxNumberOfCredentials,
+                                     duplicateFound, existingCredentialIndex))
         {
-            ChipLogProgress(Zcl,
-                            "[SetCredential] Unable to get the credential to exclude duplicated entry "
-                            "[endpointId=%d,credentialType=%u,credentialIndex=%d]",
-                            commandPath.mEndpointId, to_underlying(credentialType), i);
             sendSetCredentialResponse(commandObj, commandPath, DlStatus::kFailure, 0, nextAvailableCredentialSlot);
             return;
         }
-        if (DlCredentialStatus::kAvailable != currentCredential.status && currentCredential.credentialType == credentialType &&
-            currentCredential.credentialData.data_equal(credentialData))
+        if (duplicateFound)
         {
             ChipLogProgress(Zcl,
                             "[SetCredential] Credential with the same data and type already exist "
                             "[endpointId=%d,credentialType=%u,dataLength=%u,existingCredentialIndex=%d,credentialIndex=%d]",
                             commandPath.mEndpointId, to_underlying(credentialType),
-                            static_cast<unsigned int>(credentialData.size()), i, credentialIndex);
+                            static_cast<unsigned int>(credentialData.size()), existingCredentialIndex, credentialIndex);
             sendSetCredentialResponse(commandObj, commandPath, DlStatus::kDuplicate, 0, nextAvailableCredentialSlot);
             return;
         }
@@ -1667,6 +1680,14 @@ bool DoorLockServer::getMaxNumberOfCredentials(chip::EndpointId endpointId, Cred
 
 bool DoorLockServer::findOccupiedUserSlot(chip::EndpointId endpointId, uint16_t startIndex, uint16_t & userIndex)
 {
+#if DOOR_LOCK_SERVER_CREDENTIAL_INDEX
+    if (auto * index = getCredentialIndex(endpointId))
+    {
+        userIndex = 0;
+        return index->FindUser(startIndex, true, userIndex);
+    }
+#endif
+
     uint16_t maxNumberOfUsers;
     VerifyOrReturnError(GetAttribute(endpointId, Attributes::NumberOfTotalUsersSupported::Id,
                                      Attributes::NumberOfTotalUsersSupported::Get, maxNumberOfUsers),
@@ -1698,6 +1719,14 @@ bool DoorLockServer::findUnoccupiedUserSlot(chip::EndpointId endpointId, uint16_
 
 bool DoorLockServer::findUnoccupiedUserSlot(chip::EndpointId endpointId, uint16_t startIndex, uint16_t & userIndex)
 {
+#if DOOR_LOCK_SERVER_CREDENTIAL_INDEX
+    if (auto * index = getCredentialIndex(endpointId))
+    {
+        userIndex = 0;
+        return index->FindUser(startIndex, false, userIndex);
+    }
+#endif
+
     uint16_t maxNumberOfUsers;
     VerifyOrReturnError(GetAttribute(endpointId, Attributes::NumberOfTotalUsersSupported::Id,
                                      Attributes::NumberOfTotalUsersSupported::Get, maxNumberOfUsers),
@@ -1725,6 +1754,14 @@ bool DoorLockServer::findUnoccupiedUserSlot(chip::EndpointId endpointId, uint16_
 bool DoorLockServer::findOccupiedCredentialSlot(chip::EndpointId endpointId, CredentialTypeEnum credentialType, uint16_t startIndex,
                                                 uint16_t & credentialIndex)
 {
+#if DOOR_LOCK_SERVER_CREDENTIAL_INDEX
+    auto * index = getCredentialIndex(endpointId);
+    if (nullptr != index && index->IsIndexed(credentialType))
+    {
+        return index->FindCredential(credentialType, startIndex, true, credentialIndex);
+    }
+#endif
+
     uint16_t maxNumberOfCredentials = 0;
     if (!getMaxNumberOfCredentials(endpointId, credentialType, maxNumberOfCredentials))
     {
@@ -1761,6 +1798,14 @@ bool DoorLockServer::findOccupiedCredentialSlot(chip::EndpointId endpointId, Cre
 bool DoorLockServer::findUnoccupiedCredentialSlot(chip::EndpointId endpointId, CredentialTypeEnum credentialType,
                                                   uint16_t startIndex, uint16_t & credentialIndex)
 {
+#if DOOR_LOCK_SERVER_CREDENTIAL_INDEX
+    auto * index = getCredentialIndex(endpointId);
+    if (nullptr != index && index->IsIndexed(credentialType))
+    {
+        return index->FindCredential(credentialType, startIndex, false, credentialIndex);
+    }
+#endif
+
     uint16_t maxNumberOfCredentials = 0;
     if (!getMaxNumberOfCredentials(endpointId, credentialType, maxNumberOfCredentials))
     {
@@ -1797,6 +1842,39 @@ bool DoorLockServer::findUnoccupiedCredentialSlot(chip::EndpointId endpointId, C
 bool DoorLockServer::findUserIndexByCredential(chip::EndpointId endpointId, CredentialTypeEnum credentialType,
                                                uint16_t credentialIndex, uint16_t & userIndex)
 {
+#if DOOR_LOCK_SERVER_CREDENTIAL_INDEX
+    auto * index = getCredentialIndex(endpointId);
+    if (nullptr != index && index->IsIndexed(credentialType))
+    {
+        uint16_t candidateUserIndex = index->GetCredentialUser(credentialType, credentialIndex);
+        if (0 == candidateUserIndex)
+        {
+            return false;
+        }
+
+        EmberAfPluginDoorLockUserInfo user;
+        if (!emberAfPluginDoorLockGetUser(endpointId, candidateUserIndex, user))
+        {
+            ChipLogError(Zcl, "[GetCredentialStatus] Unable to get user: app error [userIndex=%d]", candidateUserIndex);
+            return false;
+        }
+
+        if (UserStatusEnum::kAvailable != user.userStatus)
+        {
+            for (const auto & credential : user.credentials)
+            {
+                if (credential.credentialIndex == credentialIndex && credential.credentialType == credentialType)
+                {
+                    userIndex = candidateUserIndex;
+                    return true;
+                }
+            }
+        }
+
+        // The user no longer has the credential: fall back to going through all users.
+    }
+#endif
+
     uint16_t maxNumberOfUsers = 0;
     VerifyOrReturnError(GetAttribute(endpointId, Attributes::NumberOfTotalUsersSupported::Id,
                                      Attributes::NumberOfTotalUsersSupported::Get, maxNumberOfUsers),
@@ -1835,6 +1913,41 @@ bool DoorLockServer::findUserIndexByCredential(chip::EndpointId endpointId, Cred
                                                chip::ByteSpan credentialData, uint16_t & userIndex, uint16_t & credentialIndex,
                                                EmberAfPluginDoorLockUserInfo & userInfo)
 {
+#if DOOR_LOCK_SERVER_CREDENTIAL_INDEX
+    auto * index = getCredentialIndex(endpointId);
+    if (nullptr != index && index->IsIndexed(credentialType))
+    {
+        bool found                    = false;
+        uint16_t foundCredentialIndex = 0;
+        if (!findDuplicateCredential(endpointId, credentialType, credentialData, 0, found, foundCredentialIndex))
+        {
+            return false;
+        }
+        if (!found)
+        {
+            return false;
+        }
+
+        uint16_t candidateUserIndex = 0;
+        if (findUserIndexByCredential(endpointId, credentialType, foundCredentialIndex, candidateUserIndex))
+        {
+            EmberAfPluginDoorLockUserInfo user;
+            if (!emberAfPluginDoorLockGetUser(endpointId, candidateUserIndex, user))
+            {
+                ChipLogError(Zcl, "[findUserIndexByCredential] Unable to get user: app error [userIndex=%d]", candidateUserIndex);
+                return false;
+            }
+
+            userIndex       = candidateUserIndex;
+            credentialIndex = foundCredentialIndex;
+            userInfo        = user;
+            return true;
+        }
+
+        // The credential is not attached to a user: fall back to going through all users.
+    }
+#endif
+
     uint16_t maxNumberOfUsers = 0;
     VerifyOrReturnError(GetAttribute(endpointId, Attributes::NumberOfTotalUsersSupported::Id,
                                      Attributes::NumberOfTotalUsersSupported::Get, maxNumberOfUsers),
@@ -1895,6 +2008,217 @@ bool DoorLockServer::findUserIndexByCredential(chip::EndpointId endpointId, Cred
     return false;
 }
 
+bool DoorLockServer::findDuplicateCredential(chip::EndpointId endpointId, CredentialTypeEnum credentialType,
+                                             const chip::ByteSpan & credentialData, uint16_t maxNumberOfCredentials, bool & found,
+                                             uint16_t & credentialIndex)
+{
+    found = false;
+
+    auto isDuplicate = [&](uint16_t candidateIndex, bool & duplicate) -> bool {
+        EmberAfPluginDoorLockCredentialInfo currentCredential;
+        if (!emberAfPluginDoorLockGetCredential(endpointId, candidateIndex, credentialType, currentCredential))
+        {
+            ChipLogProgress(Zcl,
+                            "[findDuplicateCredential] Unable to get the credential to exclude duplicated entry "
+                            "[endpointId=%d,credentialType=%u,credentialIndex=%d]",
+                            endpointId, to_underlying(credentialType), candidateIndex);
+            return false;
+        }
+        duplicate = DlCredentialStatus::kAvailable != currentCredential.status &&
+            currentCredential.credentialType == credentialType && currentCredential.credentialData.data_equal(credentialData);
+        return true;
+    };
+
+#if DOOR_LOCK_SERVER_CREDENTIAL_INDEX
+    auto * index = getCredentialIndex(endpointId);
+    if (nullptr != index && index->IsIndexed(credentialType))
+    {
+        // Only the credentials whose data hashes the same need to be checked.
+        size_t cursor           = 0;
+        uint16_t candidateIndex = 0;
+        while (index->NextCandidate(credentialType, credentialData, cursor, candidateIndex))
+        {
+            VerifyOrReturnValue(isDuplicate(candidateIndex, found), false);
+            if (found)
+            {
+                credentialIndex = candidateIndex;
+                return true;
+            }
+        }
+        return true;
+    }
+#endif
+
+    for (uint16_t i = 1; i <= maxNumberOfCredentials; ++i)
+    {
+        VerifyOrReturnValue(isDuplicate(i, found), false);
+        if (found)
+        {
+            credentialIndex = i;
+            return true;
+        }
+    }
+    return true;
+}
+
+bool DoorLockServer::setUser(chip::EndpointId endpointId, uint16_t userIndex, chip::FabricIndex creator, chip::FabricIndex modifier,
+                             const chip::CharSpan & userName, uint32_t uniqueId, UserStatusEnum userStatus, UserTypeEnum userType,
+                             CredentialRuleEnum credentialRule, const CredentialStruct * credentials, size_t totalCredentials)
+{
+    bool success = emberAfPluginDoorLockSetUser(endpointId, userIndex, creator, modifier, userName, uniqueId, userStatus, userType,
+                                                credentialRule, credentials, totalCredentials);
+
+#if DOOR_LOCK_SERVER_CREDENTIAL_INDEX
+    auto * endpointContext = getContext(endpointId);
+    if (nullptr != endpointContext && endpointContext->credentialIndex.IsInitialized())
+    {
+        auto & index = endpointContext->credentialIndex;
+        if (!success)
+        {
+            // The state of the user in the application database is unknown.
+            index.Clear();
+            return false;
+        }
+
+        index.SetUserOccupied(userIndex, UserStatusEnum::kAvailable != userStatus);
+        // Credentials removed from the user keep it as owner until they are cleared, which lookups detect.
+        for (size_t i = 0; i < totalCredentials; ++i)
+        {
+            index.SetCredentialUser(credentials[i].credentialType, credentials[i].credentialIndex, userIndex);
+        }
+    }
+#endif
+
+    return success;
+}
+
+bool DoorLockServer::setCredential(chip::EndpointId endpointId, uint16_t credentialIndex, chip::FabricIndex creator,
+                                   chip::FabricIndex modifier, DlCredentialStatus credentialStatus,
+                                   CredentialTypeEnum credentialType, const chip::ByteSpan & credentialData)
+{
+    bool success = emberAfPluginDoorLockSetCredential(endpointId, credentialIndex, creator, modifier, credentialStatus,
+                                                      credentialType, credentialData);
+
+#if DOOR_LOCK_SERVER_CREDENTIAL_INDEX
+    auto * endpointContext = getContext(endpointId);
+    if (nullptr != endpointContext && endpointContext->credentialIndex.IsInitialized())
+    {
+        auto & index = endpointContext->credentialIndex;
+        if (!success)
+        {
+            // The state of the credential in the application database is unknown.
+            index.Clear();
+            return false;
+        }
+
+        if (DlCredentialStatus::kAvailable == credentialStatus)
+        {
+            index.ClearCredential(credentialType, credentialIndex);
+        }
+        else
+        {
+            index.SetCredential(credentialType, credentialIndex, credentialData);
+        }
+    }
+#endif
+
+    return success;
+}
+
+#if DOOR_LOCK_SERVER_CREDENTIAL_INDEX
+CredentialIndex * DoorLockServer::getCredentialIndex(chip::EndpointId endpointId)
+{
+    auto * endpointContext = getContext(endpointId);
+    if (nullptr == endpointContext)
+    {
+        return nullptr;
+    }
+
+    auto & index = endpointContext->credentialIndex;
+    if (!index.IsInitialized() && !buildCredentialIndex(endpointId, index))
+    {
+        index.Clear();
+        return nullptr;
+    }
+    return &index;
+}
+
+bool DoorLockServer::buildCredentialIndex(chip::EndpointId endpointId, CredentialIndex & index)
+{
+    uint16_t numberOfUsers = 0;
+    if (!GetNumberOfUserSupported(endpointId, numberOfUsers))
+    {
+        numberOfUsers = 0;
+    }
+
+    // Credential types that are not supported, or whose number of credentials is unknown, are not indexed.
+    uint16_t numberOfCredentials[CredentialIndex::kNumberOfCredentialTypes] = {};
+    for (size_t type = 0; type < CredentialIndex::kNumberOfCredentialTypes; ++type)
+    {
+        auto credentialType = static_cast<CredentialTypeEnum>(type);
+        if (!credentialTypeSupported(endpointId, credentialType) ||
+            !getMaxNumberOfCredentials(endpointId, credentialType, numberOfCredentials[type]))
+        {
+            numberOfCredentials[type] = 0;
+        }
+    }
+
+    CHIP_ERROR err = index.Init(numberOfUsers, numberOfCredentials);
+    if (err != CHIP_NO_ERROR)
+    {
+        ChipLogError(Zcl, "Unable to allocate the credential index [endpointId=%d]: %" CHIP_ERROR_FORMAT, endpointId, err.Format());
+        return false;
+    }
+
+    for (uint16_t userIndex = 1; userIndex <= numberOfUsers; ++userIndex)
+    {
+        EmberAfPluginDoorLockUserInfo user;
+        if (!emberAfPluginDoorLockGetUser(endpointId, userIndex, user))
+        {
+            ChipLogError(Zcl, "Unable to get user to build the credential index: app error [userIndex=%d]", userIndex);
+            return false;
+        }
+
+        if (UserStatusEnum::kAvailable == user.userStatus)
+        {
+            continue;
+        }
+
+        index.SetUserOccupied(userIndex, true);
+        for (const auto & credential : user.credentials)
+        {
+            index.SetCredentialUser(credential.credentialType, credential.credentialIndex, userIndex);
+        }
+    }
+
+    for (size_t type = 0; type < CredentialIndex::kNumberOfCredentialTypes; ++type)
+    {
+        auto credentialType = static_cast<CredentialTypeEnum>(type);
+        for (uint16_t credentialIndex = 1; index.IsIndexed(credentialType) && credentialIndex <= numberOfCredentials[type];
+             ++credentialIndex)
+        {
+            EmberAfPluginDoorLockCredentialInfo credential;
+            if (!emberAfPluginDoorLockGetCredential(endpointId, credentialIndex, credentialType, credential))
+            {
+                ChipLogError(Zcl,
+                             "Unable to get credential to build the credential index: app error "
+                             "[endpointId=%d,credentialType=%u,credentialIndex=%d]",
+                             endpointId, to_underlying(credentialType), credentialIndex);
+                return false;
+            }
+
+            if (DlCredentialStatus::kAvailable != credential.status)
+            {
+                index.SetCredential(credentialType, credentialIndex, credential.credentialData);
+            }
+        }
+    }
+
+    ChipLogProgress(Zcl, "Built the credential index [endpointId=%d,users=%d]", endpointId, numberOfUsers);
+    return true;
+}
+#endif // DOOR_LOCK_SERVER_CREDENTIAL_INDEX
+
 ClusterStatusCode DoorLockServer::createUser(chip::EndpointId endpointId, chip::FabricIndex creatorFabricIdx,
                                              chip::NodeId sourceNodeId, uint16_t userIndex,
                                              const Nullable<chip::CharSpan> & userName, const Nullable<uint32_t> & userUniqueId,
@@ -1929,8 +2253,8 @@ ClusterStatusCode DoorLockServer::createUser(chip::EndpointId endpointId, chip::
         newTotalCredentials = 1;
     }
 
-    if (!emberAfPluginDoorLockSetUser(endpointId, userIndex, creatorFabricIdx, creatorFabricIdx, newUserName, newUserUniqueId,
-                                      newUserStatus, newUserType, newCredentialRule, newCredentials, newTotalCredentials))
+    if (!setUser(endpointId, userIndex, creatorFabricIdx, creatorFabricIdx, newUserName, newUserUniqueId, newUserStatus,
+                 newUserType, newCredentialRule, newCredentials, newTotalCredentials))
     {
         ChipLogProgress(Zcl,
                         "[createUser] Unable to create user: app error "
@@ -2002,9 +2326,8 @@ Status DoorLockServer::modifyUser(chip::EndpointId endpointId, chip::FabricIndex
     auto newUserType         = userType.IsNull() ? user.userType : userType.Value();
     auto newCredentialRule   = credentialRule.IsNull() ? user.credentialRule : credentialRule.Value();
 
-    if (!emberAfPluginDoorLockSetUser(endpointId, userIndex, user.createdBy, modifierFabricIndex, newUserName, newUserUniqueId,
-                                      newUserStatus, newUserType, newCredentialRule, user.credentials.data(),
-                                      user.credentials.size()))
+    if (!setUser(endpointId, userIndex, user.createdBy, modifierFabricIndex, newUserName, newUserUniqueId, newUserStatus,
+                 newUserType, newCredentialRule, user.credentials.data(), user.credentials.size()))
     {
         ChipLogError(Zcl,
                      "[modifyUser] Unable to modify the user: app error "
@@ -2050,9 +2373,8 @@ Status DoorLockServer::clearUser(chip::EndpointId endpointId, chip::FabricIndex
             Zcl, "[ClearUser] Clearing associated credential [endpointId=%d,userIndex=%d,credentialType=%u,credentialIndex=%d]",
             endpointId, userIndex, to_underlying(credential.credentialType), credential.credentialIndex);
 
-        if (!emberAfPluginDoorLockSetCredential(endpointId, credential.credentialIndex, kUndefinedFabricIndex,
-                                                kUndefinedFabricIndex, DlCredentialStatus::kAvailable, credential.credentialType,
-                                                chip::ByteSpan()))
+        if (!setCredential(endpointId, credential.credentialIndex, kUndefinedFabricIndex, kUndefinedFabricIndex,
+                           DlCredentialStatus::kAvailable, credential.credentialType, chip::ByteSpan()))
         {
             ChipLogError(Zcl,
                          "[ClearUser] Unable to remove credentials associated with user - internal error "
@@ -2073,9 +2395,8 @@ Status DoorLockServer::clearUser(chip::EndpointId endpointId, chip::FabricIndex
     }
 
     // Remove the user entry
-    if (!emberAfPluginDoorLockSetUser(endpointId, userIndex, kUndefinedFabricIndex, kUndefinedFabricIndex, ""_span, 0,
-                                      UserStatusEnum::kAvailable, UserTypeEnum::kUnrestrictedUser, CredentialRuleEnum::kSingle,
-                                      nullptr, 0))
+    if (!setUser(endpointId, userIndex, kUndefinedFabricIndex, kUndefinedFabricIndex, ""_span, 0, UserStatusEnum::kAvailable,
+                 UserTypeEnum::kUnrestrictedUser, CredentialRuleEnum::kSingle, nullptr, 0))
     {
         return Status::Failure;
     }
@@ -2122,9 +2443,8 @@ bool DoorLockServer::clearFabricFromUsers(chip::EndpointId endpointId, chip::Fab
             user.lastModifiedBy = kUndefinedFabricIndex;
         }
 
-        if (!emberAfPluginDoorLockSetUser(endpointId, userIndex, user.createdBy, user.lastModifiedBy, user.userName,
-                                          user.userUniqueId, user.userStatus, user.userType, user.credentialRule,
-                                          user.credentials.data(), user.credentials.size()))
+        if (!setUser(endpointId, userIndex, user.createdBy, user.lastModifiedBy, user.userName, user.userUniqueId, user.userStatus,
+                     user.userType, user.credentialRule, user.credentials.data(), user.credentials.size()))
         {
             ChipLogError(
                 Zcl,
@@ -2164,8 +2484,8 @@ DlStatus DoorLockServer::createNewCredentialAndUser(chip::EndpointId endpointId,
         return DlStatus::kFailure;
     }
 
-    if (!emberAfPluginDoorLockSetCredential(endpointId, credential.credentialIndex, creatorFabricIdx, creatorFabricIdx,
-                                            DlCredentialStatus::kOccupied, credential.credentialType, credentialData))
+    if (!setCredential(endpointId, credential.credentialIndex, creatorFabricIdx, creatorFabricIdx, DlCredentialStatus::kOccupied,
+                       credential.credentialType, credentialData))
     {
         ChipLogProgress(Zcl,
                         "[SetCredential] Unable to set the credential: app error "
@@ -2229,8 +2549,8 @@ DlStatus DoorLockServer::createNewCredentialAndAddItToUser(chip::EndpointId endp
         return status;
     }
 
-    if (!emberAfPluginDoorLockSetCredential(endpointId, credential.credentialIndex, modifierFabricIdx, modifierFabricIdx,
-                                            DlCredentialStatus::kOccupied, credential.credentialType, credentialData))
+    if (!setCredential(endpointId, credential.credentialIndex, modifierFabricIdx, modifierFabricIdx, DlCredentialStatus::kOccupied,
+                       credential.credentialType, credentialData))
     {
         ChipLogProgress(Zcl,
                         "[SetCredential] Unable to set the credential: app error "
@@ -2305,9 +2625,8 @@ DlStatus DoorLockServer::addCredentialToUser(chip::EndpointId endpointId, chip::
     memcpy(newCredentials.Get(), user.credentials.data(), sizeof(CredentialStruct) * user.credentials.size());
     newCredentials[user.credentials.size()] = credential;
 
-    if (!emberAfPluginDoorLockSetUser(endpointId, userIndex, user.createdBy, modifierFabricIdx, user.userName, user.userUniqueId,
-                                      user.userStatus, user.userType, user.credentialRule, newCredentials.Get(),
-                                      user.credentials.size() + 1))
+    if (!setUser(endpointId, userIndex, user.createdBy, modifierFabricIdx, user.userName, user.userUniqueId, user.userStatus,
+                 user.userType, user.credentialRule, newCredentials.Get(), user.credentials.size() + 1))
     {
         ChipLogProgress(Zcl,
                         "[AddCredentialToUser] Unable to add credential to user: credential with this index is already associated "
@@ -2363,9 +2682,8 @@ DlStatus DoorLockServer::modifyCredentialForUser(chip::EndpointId endpointId, ch
                 "[endpointId=%d,userIndex=%d,credentialType=%d,credentialIndex=%d]",
                 endpointId, userIndex, to_underlying(credential.credentialType), credential.credentialIndex);
 
-            if (!emberAfPluginDoorLockSetUser(endpointId, userIndex, user.createdBy, modifierFabricIdx, user.userName,
-                                              user.userUniqueId, user.userStatus, user.userType, user.credentialRule,
-                                              newCredentials.Get(), user.credentials.size()))
+            if (!setUser(endpointId, userIndex, user.createdBy, modifierFabricIdx, user.userName, user.userUniqueId,
+                         user.userStatus, user.userType, user.credentialRule, newCredentials.Get(), user.credentials.size()))
             {
                 ChipLogProgress(
                     Zcl,
@@ -2498,6 +2816,15 @@ DlStatus DoorLockServer::createCredential(chip::EndpointId endpointId, chip::Fab
 bool DoorLockServer::countOccupiedCredentials(chip::EndpointId endpointId, CredentialTypeEnum credentialType,
                                               size_t & occupiedCount)
 {
+#if DOOR_LOCK_SERVER_CREDENTIAL_INDEX
+    auto * index = getCredentialIndex(endpointId);
+    if (nullptr != index && index->IsIndexed(credentialType))
+    {
+        occupiedCount = index->CountOccupiedCredentials(credentialType);
+        return true;
+    }
+#endif
+
     uint16_t maxCredentialCount;
 
     if (!getMaxNumberOfCredentials(endpointId, credentialType, maxCredentialCount))
@@ -2557,8 +2884,8 @@ DlStatus DoorLockServer::modifyProgrammingPIN(chip::EndpointId endpointId, chip:
         return DlStatus::kFailure;
     }
 
-    if (!emberAfPluginDoorLockSetCredential(endpointId, credentialIndex, existingCredential.createdBy, modifierFabricIndex,
-                                            existingCredential.status, existingCredential.credentialType, credentialData))
+    if (!setCredential(endpointId, credentialIndex, existingCredential.createdBy, modifierFabricIndex, existingCredential.status,
+                       existingCredential.credentialType, credentialData))
     {
         ChipLogProgress(Zcl,
                         "[SetCredential] Unable to modify the credential: app error "
@@ -2601,8 +2928,8 @@ DlStatus DoorLockServer::modifyCredential(chip::EndpointId endpointId, chip::Fab
 
     if (DlStatus::kSuccess == status)
     {
-        if (!emberAfPluginDoorLockSetCredential(endpointId, credentialIndex, existingCredential.createdBy, modifierFabricIndex,
-                                                existingCredential.status, existingCredential.credentialType, credentialData))
+        if (!setCredential(endpointId, credentialIndex, existingCredential.createdBy, modifierFabricIndex,
+                           existingCredential.status, existingCredential.credentialType, credentialData))
         {
             ChipLogProgress(Zcl,
                             "[SetCredential] Unable to modify the credential: app error "
@@ -2997,8 +3324,8 @@ Status DoorLockServer::clearCredential(chip::EndpointId endpointId, chip::Fabric
     }
 
     // 3. If the user wasn't deleted, delete the credential and adjust the list of credentials for related user in the storage
-    if (!emberAfPluginDoorLockSetCredential(endpointId, credentialIndex, kUndefinedFabricIndex, kUndefinedFabricIndex,
-                                            DlCredentialStatus::kAvailable, credentialType, chip::ByteSpan()))
+    if (!setCredential(endpointId, credentialIndex, kUndefinedFabricIndex, kUndefinedFabricIndex, DlCredentialStatus::kAvailable,
+                       credentialType, chip::ByteSpan()))
     {
         ChipLogError(Zcl,
                      "[clearCredential] Unable to clear credential - couldn't write new credential to database "
@@ -3028,9 +3355,9 @@ Status DoorLockServer::clearCredential(chip::EndpointId endpointId, chip::Fabric
         newCredentials[newCredentialsCount++] = c;
     }
 
-    if (!emberAfPluginDoorLockSetUser(endpointId, relatedUserIndex, relatedUser.createdBy, modifier, relatedUser.userName,
-                                      relatedUser.userUniqueId, relatedUser.userStatus, relatedUser.userType,
-                                      relatedUser.credentialRule, newCredentials.Get(), newCredentialsCount))
+    if (!setUser(endpointId, relatedUserIndex, relatedUser.createdBy, modifier, relatedUser.userName, relatedUser.userUniqueId,
+                 relatedUser.userStatus, relatedUser.userType, relatedUser.credentialRule, newCredentials.Get(),
+                 newCredentialsCount))
     {
         ChipLogError(Zcl,
                      "[clearCredential] Unable to clear credential for related user - unable to update database "
@@ -3236,8 +3563,8 @@ bool DoorLockServer::clearFabricFromCredentials(chip::EndpointId endpointId, Cre
             credential.lastModifiedBy = kUndefinedFabricIndex;
         }
 
-        if (!emberAfPluginDoorLockSetCredential(endpointId, credentialIndex, credential.createdBy, credential.lastModifiedBy,
-                                                credential.status, credential.credentialType, credential.credentialData))
+        if (!setCredential(endpointId, credentialIndex, credential.createdBy, credential.lastModifiedBy, credential.status,
+                           credential.credentialType, credential.credentialData))
         {
             ChipLogError(Zcl,
                          "[clearFabricFromCredentials] Unable to clear fabric from credential - internal error "
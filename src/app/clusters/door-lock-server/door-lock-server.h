@@ -39,6 +39,22 @@
 #define DOOR_LOCK_SERVER_ENDPOINT 1
 #endif
 
+/**
+ * Keep an in-memory index of the users and credentials of each endpoint (see door-lock-credential-index.h), so that
+ * duplicate credential checks, free slot searches and credential to user lookups do not need to go through every slot
+ * of the application database. Costs about 8 bytes of RAM per credential slot.
+ *
+ * Applications that modify users or credentials other than through the Door Lock cluster commands have to call
+ * DoorLockServer::InvalidateCredentialIndex.
+ */
+#ifndef DOOR_LOCK_SERVER_CREDENTIAL_INDEX
+#define DOOR_LOCK_SERVER_CREDENTIAL_INDEX 0
+#endif
+
+#if DOOR_LOCK_SERVER_CREDENTIAL_INDEX
+#include "door-lock-credential-index.h"
+#endif
+
 using chip::Optional;
 using chip::app::Clusters::DoorLock::AlarmCodeEnum;
 using chip::app::Clusters::DoorLock::CredentialRuleEnum;
@@ -79,6 +95,7 @@ static constexpr size_t DOOR_LOCK_MAX_USER_NAME_SIZE = 10; /**< Maximum size of
 static constexpr size_t DOOR_LOCK_USER_NAME_BUFFER_SIZE =
     DOOR_LOCK_MAX_USER_NAME_SIZE + 1; /**< Maximum size of the user name string (in bytes). */
 
+enum class DlCredentialStatus : uint8_t;
 struct EmberAfPluginDoorLockCredentialInfo;
 struct EmberAfPluginDoorLockUserInfo;
 
@@ -87,6 +104,9 @@ struct EmberAfDoorLockEndpointContext
     chip::System::Clock::Timestamp lockoutEndTimestamp;
     int wrongCodeEntryAttempts;
     chip::app::Clusters::DoorLock::Delegate * delegate = nullptr;
+#if DOOR_LOCK_SERVER_CREDENTIAL_INDEX
+    chip::app::Clusters::DoorLock::CredentialIndex credentialIndex;
+#endif
 };
 
 /**
@@ -292,6 +312,16 @@ public:
     void HandleLocalLockOperationError(chip::EndpointId endpointId, LockOperationTypeEnum opType, OperationSourceEnum opSource,
                                        Nullable<uint16_t> userId);
 
+    /**
+     * @brief Discards the credential index of the endpoint, which is rebuilt from the application database when next needed.
+     *        Applications that enable DOOR_LOCK_SERVER_CREDENTIAL_INDEX are responsible for calling this API when they add,
+     *        modify or remove users or credentials other than through the Door Lock cluster commands (e.g. from a local
+     *        keypad). Does nothing if the credential index is not enabled.
+     *
+     * @param endpointId
+     */
+    void InvalidateCredentialIndex(chip::EndpointId endpointId);
+
 private:
     chip::FabricIndex getFabricIndex(const chip::app::CommandHandler * commandObj);
     chip::NodeId getNodeId(const chip::app::CommandHandler * commandObj);
@@ -324,6 +354,34 @@ private:
     bool findUserIndexByCredential(chip::EndpointId endpointId, CredentialTypeEnum credentialType, chip::ByteSpan credentialData,
                                    uint16_t & userIndex, uint16_t & credentialIndex, EmberAfPluginDoorLockUserInfo & userInfo);
 
+    /**
+     * findDuplicateCredential looks for an occupied credential of the given type
+     * with the given data.  Returns false on application-side errors.
+     */
+    bool findDuplicateCredential(chip::EndpointId endpointId, CredentialTypeEnum credentialType,
+                                 const chip::ByteSpan & credentialData, uint16_t maxNumberOfCredentials, bool & found,
+                                 uint16_t & credentialIndex);
+
+    /**
+     * setUser and setCredential store the user or credential through the application
+     * callbacks, and keep the credential index of the endpoint up to date.
+     */
+    bool setUser(chip::EndpointId endpointId, uint16_t userIndex, chip::FabricIndex creator, chip::FabricIndex modifier,
+                 const chip::CharSpan & userName, uint32_t uniqueId, UserStatusEnum userStatus, UserTypeEnum userType,
+                 CredentialRuleEnum credentialRule, const CredentialStruct * credentials, size_t totalCredentials);
+    bool setCredential(chip::EndpointId endpointId, uint16_t credentialIndex, chip::FabricIndex creator, chip::FabricIndex modifier,
+                       DlCredentialStatus credentialStatus, CredentialTypeEnum credentialType,
+                       const chip::ByteSpan & credentialData);
+
+#if DOOR_LOCK_SERVER_CREDENTIAL_INDEX
+    /**
+     * Get the credential index of the endpoint, building it from the application database if needed.  Returns null if
+     * the index cannot be built, in which case callers fall back to going through the application database.
+     */
+    chip::app::Clusters::DoorLock::CredentialIndex * getCredentialIndex(chip::EndpointId endpointId);
+    bool buildCredentialIndex(chip::EndpointId endpointId, chip::app::Clusters::DoorLock::CredentialIndex & index);
+#endif
+
     chip::Protocols::InteractionModel::ClusterStatusCode
     createUser(chip::EndpointId endpointId, chip::FabricIndex creatorFabricIdx, chip::NodeId sourceNodeId, uint16_t userIndex,
                const Nullable<chip::CharSpan> & userName, const Nullable<uint32_t> & userUniqueId,
@@ -26,6 +26,7 @@
 #include <app/CommandHandler.h>
 #include <app/ConcreteCommandPath.h>
 #include <app/cluster-building-blocks/QuieterReporting.h>
+#include <app/cluster-building-blocks/TransitionScheduler.h>
 #include <app/util/attribute-storage.h>
 #include <app/util/config.h>
 #include <app/util/util.h>
@@ -100,6 +101,7 @@ struct EmberAfLevelControlState
     uint32_t transitionTimeMs;
     uint32_t elapsedTimeMs;
     CallbackScheduleState callbackSchedule;
+    TransitionTimer transitionTimer;
     QuieterReportingAttribute<uint8_t> quietCurrentLevel{ DataModel::NullNullable };
     QuieterReportingAttribute<uint16_t> quietRemainingTime{ DataModel::MakeNullable<uint16_t>(0) };
 };
@@ -277,7 +279,7 @@ static void reallyUpdateCoupledColorTemp(EndpointId endpoint);
 
 void emberAfLevelControlClusterServerTickCallback(EndpointId endpoint);
 
-static void timerCallback(System::Layer *, void * callbackContext)
+static void timerCallback(void * callbackContext)
 {
     emberAfLevelControlClusterServerTickCallback(static_cast<EndpointId>(reinterpret_cast<uintptr_t>(callbackContext)));
 }
@@ -322,10 +324,15 @@ static uint32_t computeCallbackWaitTimeMs(CallbackScheduleState & callbackSchedu
     return waitTime.count();
 }
 
+// The transitions of all the endpoints, and those of the Color Control server, share the ticks of a single scheduler.
 static void scheduleTimerCallbackMs(EndpointId endpoint, uint32_t delayMs)
 {
-    CHIP_ERROR err = DeviceLayer::SystemLayer().StartTimer(chip::System::Clock::Milliseconds32(delayMs), timerCallback,
-                                                           reinterpret_cast<void *>(static_cast<uintptr_t>(endpoint)));
+    EmberAfLevelControlState * state = getState(endpoint);
+    VerifyOrReturn(state != nullptr);
+
+    CHIP_ERROR err = TransitionScheduler::Instance().StartTimer(DeviceLayer::SystemLayer(), state->transitionTimer,
+                                                                System::Clock::Milliseconds32(delayMs), timerCallback,
+                                                                reinterpret_cast<void *>(static_cast<uintptr_t>(endpoint)));
 
     if (err != CHIP_NO_ERROR)
     {
@@ -335,7 +342,10 @@ static void scheduleTimerCallbackMs(EndpointId endpoint, uint32_t delayMs)
 
 static void cancelEndpointTimerCallback(EndpointId endpoint)
 {
-    DeviceLayer::SystemLayer().CancelTimer(timerCallback, reinterpret_cast<void *>(static_cast<uintptr_t>(endpoint)));
+    EmberAfLevelControlState * state = getState(endpoint);
+    VerifyOrReturn(state != nullptr);
+
+    TransitionScheduler::Instance().CancelTimer(state->transitionTimer);
 }
 
 static EmberAfLevelControlState * getState(EndpointId endpoint)
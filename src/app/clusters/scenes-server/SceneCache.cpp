@@ -0,0 +1,137 @@
+/*
+ *
+ *    Copyright (c) 2024 Project CHIP Authors
+ *
+ *    Licensed under the Apache License, Version 2.0 (the "License");
+ *    you may not use this file except in compliance with the License.
+ *    You may obtain a copy of the License at
+ *
+ *        http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *    Unless required by applicable law or agreed to in writing, software
+ *    distributed under the License is distributed on an "AS IS" BASIS,
+ *    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *    See the License for the specific language governing permissions and
+ *    limitations under the License.
+ */
+
+#include <app/clusters/scenes-server/SceneCache.h>
+
+namespace chip {
+namespace scenes {
+
+bool SceneCache::Get(FabricIndex fabric_index, EndpointId endpoint, const SceneStorageId & scene_id, uint16_t maxScenesPerFabric,
+                     SceneTableEntry & scene)
+{
+    Entry * entry = Find(fabric_index, endpoint, scene_id);
+    VerifyOrReturnValue(entry != nullptr, false);
+
+    if (entry->mSceneIndex >= maxScenesPerFabric)
+    {
+        entry->Clear();
+        return false;
+    }
+
+    entry->mLastUse = ++mUseCounter;
+    scene           = entry->mScene;
+    return true;
+}
+
+void SceneCache::Put(FabricIndex fabric_index, EndpointId endpoint, SceneIndex scene_idx, const SceneTableEntry & scene)
+{
+    Entry * entry = Find(fabric_index, endpoint, scene.mStorageId);
+    if (entry == nullptr)
+    {
+        entry = FindFreeOrLeastRecentlyUsed();
+    }
+    VerifyOrReturn(entry != nullptr);
+
+    entry->mFabricIndex = fabric_index;
+    entry->mEndpointId  = endpoint;
+    entry->mSceneIndex  = scene_idx;
+    entry->mLastUse     = ++mUseCounter;
+    entry->mScene       = scene;
+}
+
+void SceneCache::Remove(FabricIndex fabric_index, EndpointId endpoint, const SceneStorageId & scene_id)
+{
+    Entry * entry = Find(fabric_index, endpoint, scene_id);
+    if (entry != nullptr)
+    {
+        entry->Clear();
+    }
+}
+
+void SceneCache::RemoveGroup(FabricIndex fabric_index, EndpointId endpoint, GroupId group_id)
+{
+    for (auto & entry : mEntries)
+    {
+        if (entry.mFabricIndex == fabric_index && entry.mEndpointId == endpoint && entry.mScene.mStorageId.mGroupId == group_id)
+        {
+            entry.Clear();
+        }
+    }
+}
+
+void SceneCache::RemoveFabric(FabricIndex fabric_index)
+{
+    for (auto & entry : mEntries)
+    {
+        if (entry.mFabricIndex == fabric_index)
+        {
+            entry.Clear();
+        }
+    }
+}
+
+void SceneCache::RemoveEndpoint(EndpointId endpoint)
+{
+    for (auto & entry : mEntries)
+    {
+        if (entry.mEndpointId == endpoint)
+        {
+            entry.Clear();
+        }
+    }
+}
+
+void SceneCache::Clear()
+{
+    for (auto & entry : mEntries)
+    {
+        entry.Clear();
+    }
+}
+
+SceneCache::Entry * SceneCache::Find(FabricIndex fabric_index, EndpointId endpoint, const SceneStorageId & scene_id)
+{
+    for (auto & entry : mEntries)
+    {
+        if (entry.IsValid() && entry.mFabricIndex == fabric_index && entry.mEndpointId == endpoint &&
+            entry.mScene.mStorageId == scene_id)
+        {
+            return &entry;
+        }
+    }
+    return nullptr;
+}
+
+SceneCache::Entry * SceneCache::FindFreeOrLeastRecentlyUsed()
+{
+    Entry * lru = nullptr;
+    for (auto & entry : mEntries)
+    {
+        if (!entry.IsValid())
+        {
+            return &entry;
+        }
+        if (lru == nullptr || entry.mLastUse < lru->mLastUse)
+        {
+            lru = &entry;
+        }
+    }
+    return lru;
+}
+
+} // namespace scenes
+} // namespace chip
@@ -0,0 +1,84 @@
+/*
+ *
+ *    Copyright (c) 2024 Project CHIP Authors
+ *
+ *    Licensed under the Apache License, Version 2.0 (the "License");
+ *    you may not use this file except in compliance with the License.
+ *    You may obtain a copy of the License at
+ *
+ *        http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *    Unless required by applicable law or agreed to in writing, software
+ *    distributed under the License is distributed on an "AS IS" BASIS,
+ *    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *    See the License for the specific language governing permissions and
+ *    limitations under the License.
+ */
+
+#pragma once
+
+#include <app/clusters/scenes-server/ExtensionFieldSetsImpl.h>
+#include <app/clusters/scenes-server/SceneTable.h>
+#include <lib/core/DataModelTypes.h>
+#include <lib/support/Span.h>
+
+namespace chip {
+namespace scenes {
+
+/**
+ * @brief In-memory cache of decoded scenes, used by DefaultSceneTableImpl to recall scenes without reading and decoding them
+ * from persistent storage.
+ *
+ * Scenes are identified by fabric, endpoint, group and scene ID. When the cache is full, the least recently used scene is
+ * evicted. The cache holds no storage of its own: the entries are provided by the owner, and a cache without entries never
+ * holds anything.
+ *
+ * The cache is write-through: the owner updates it after every successful write to storage, and removes the affected scenes
+ * whenever a write fails or scenes are removed from storage.
+ */
+class SceneCache
+{
+public:
+    using SceneTableEntry = SceneTable<ExtensionFieldSetsImpl>::SceneTableEntry;
+    using SceneStorageId  = SceneTable<ExtensionFieldSetsImpl>::SceneStorageId;
+
+    struct Entry
+    {
+        FabricIndex mFabricIndex = kUndefinedFabricIndex;
+        EndpointId mEndpointId   = kInvalidEndpointId;
+        SceneIndex mSceneIndex   = 0;
+        uint32_t mLastUse        = 0;
+        SceneTableEntry mScene;
+
+        bool IsValid() const { return mFabricIndex != kUndefinedFabricIndex; }
+        void Clear() { mFabricIndex = kUndefinedFabricIndex; }
+    };
+
+    SceneCache(Span<Entry> entries) : mEntries(entries) {}
+
+    /// @brief Gets a cached scene and marks it as the most recently used one.
+    /// @param maxScenesPerFabric Current capacity of the fabric's scene table: scenes stored at a position at or beyond it may
+    /// have been truncated from storage, and are no longer returned.
+    /// @return true if the scene was found in the cache
+    bool Get(FabricIndex fabric_index, EndpointId endpoint, const SceneStorageId & scene_id, uint16_t maxScenesPerFabric,
+             SceneTableEntry & scene);
+
+    /// @brief Adds or updates a scene, stored at the given position of the fabric's scene table.
+    void Put(FabricIndex fabric_index, EndpointId endpoint, SceneIndex scene_idx, const SceneTableEntry & scene);
+
+    void Remove(FabricIndex fabric_index, EndpointId endpoint, const SceneStorageId & scene_id);
+    void RemoveGroup(FabricIndex fabric_index, EndpointId endpoint, GroupId group_id);
+    void RemoveFabric(FabricIndex fabric_index);
+    void RemoveEndpoint(EndpointId endpoint);
+    void Clear();
+
+private:
+    Entry * Find(FabricIndex fabric_index, EndpointId endpoint, const SceneStorageId & scene_id);
+    Entry * FindFreeOrLeastRecentlyUsed();
+
+    Span<Entry> mEntries;
+    uint32_t mUseCounter = 0;
+};
+
+} // namespace scenes
+} // namespace chip
@@ -508,6 +508,7 @@ CHIP_ERROR DefaultSceneTableImpl::Init(PersistentStorageDelegate * storage)
     VerifyOrReturnError(mMaxScenesPerFabric <= kMaxScenesPerFabric && mMaxScenesPerEndpoint <= kMaxScenesPerEndpoint,
                         CHIP_ERROR_INVALID_INTEGER_VALUE);
     mStorage = storage;
+    mSceneCache.Clear();
     return CHIP_NO_ERROR;
 }
 
@@ -515,6 +516,7 @@ void DefaultSceneTableImpl::Finish()
 {
     UnregisterAllHandlers();
     mSceneEntryIterators.ReleaseAll();
+    mSceneCache.Clear();
 }
 CHIP_ERROR DefaultSceneTableImpl::GetFabricSceneCount(FabricIndex fabric_index, uint8_t & scene_count)
 {
@@ -593,6 +595,18 @@ CHIP_ERROR DefaultSceneTableImpl::SetSceneTableEntry(FabricIndex fabric_index, c
     VerifyOrReturnError(CHIP_NO_ERROR == err || CHIP_ERROR_NOT_FOUND == err, err);
 
     err = fabric.SaveScene(mStorage, entry);
+
+    // Keep the cache in sync with storage, which may or may not have been updated on failure
+    SceneIndex scene_idx;
+    if (CHIP_NO_ERROR == err && CHIP_NO_ERROR == fabric.Find(entry.mStorageId, scene_idx))
+    {
+        mSceneCache.Put(fabric_index, mEndpointId, scene_idx, entry);
+    }
+    else
+    {
+        mSceneCache.Remove(fabric_index, mEndpointId, entry.mStorageId);
+    }
+
     return err;
 }
 
@@ -600,6 +614,11 @@ CHIP_ERROR DefaultSceneTableImpl::GetSceneTableEntry(FabricIndex fabric_index, S
 {
     VerifyOrReturnError(IsInitialized(), CHIP_ERROR_INTERNAL);
 
+    if (mSceneCache.Get(fabric_index, mEndpointId, scene_id, mMaxScenesPerFabric, entry))
+    {
+        return CHIP_NO_ERROR;
+    }
+
     FabricSceneData fabric(mEndpointId, fabric_index, mMaxScenesPerFabric, mMaxScenesPerEndpoint);
     SceneTableData scene(mEndpointId, fabric_index);
 
@@ -618,6 +637,7 @@ CHIP_ERROR DefaultSceneTableImpl::GetSceneTableEntry(FabricIndex fabric_index, S
 
     entry.mStorageId   = scene.mStorageId;
     entry.mStorageData = scene.mStorageData;
+    mSceneCache.Put(fabric_index, mEndpointId, scene.index, entry);
 
     return CHIP_NO_ERROR;
 }
@@ -627,6 +647,7 @@ CHIP_ERROR DefaultSceneTableImpl::RemoveSceneTableEntry(FabricIndex fabric_index
     VerifyOrReturnError(IsInitialized(), CHIP_ERROR_INTERNAL);
     FabricSceneData fabric(mEndpointId, fabric_index, mMaxScenesPerFabric, mMaxScenesPerEndpoint);
 
+    mSceneCache.Remove(fabric_index, mEndpointId, scene_id);
     ReturnErrorOnFailure(fabric.Load(mStorage));
 
     return fabric.RemoveScene(mStorage, scene_id);
@@ -651,6 +672,7 @@ CHIP_ERROR DefaultSceneTableImpl::RemoveSceneTableEntryAtPosition(EndpointId end
     VerifyOrReturnValue(CHIP_ERROR_NOT_FOUND != err, CHIP_NO_ERROR);
     ReturnErrorOnFailure(err);
 
+    mSceneCache.Remove(fabric_index, endpoint, scene.mStorageId);
     return fabric.RemoveScene(mStorage, scene.mStorageId);
 }
 
@@ -689,6 +711,7 @@ CHIP_ERROR DefaultSceneTableImpl::DeleteAllScenesInGroup(FabricIndex fabric_inde
     FabricSceneData fabric(mEndpointId, fabric_index, mMaxScenesPerFabric, mMaxScenesPerEndpoint);
     SceneTableData scene(mEndpointId, fabric_index);
 
+    mSceneCache.RemoveGroup(fabric_index, mEndpointId, group_id);
     CHIP_ERROR err = fabric.Load(mStorage);
     VerifyOrReturnValue(CHIP_ERROR_NOT_FOUND != err, CHIP_NO_ERROR);
     ReturnErrorOnFailure(err);
@@ -801,6 +824,7 @@ CHIP_ERROR DefaultSceneTableImpl::SceneApplyEFS(const SceneTableEntry & scene)
 CHIP_ERROR DefaultSceneTableImpl::RemoveFabric(FabricIndex fabric_index)
 {
     VerifyOrReturnError(IsInitialized(), CHIP_ERROR_INTERNAL);
+    mSceneCache.RemoveFabric(fabric_index);
 
     for (auto endpoint : app::EnabledEndpointsWithServerCluster(chip::app::Clusters::ScenesManagement::Id))
     {
@@ -830,6 +854,7 @@ CHIP_ERROR DefaultSceneTableImpl::RemoveFabric(FabricIndex fabric_index)
 CHIP_ERROR DefaultSceneTableImpl::RemoveEndpoint()
 {
     VerifyOrReturnError(IsInitialized(), CHIP_ERROR_INTERNAL);
+    mSceneCache.RemoveEndpoint(mEndpointId);
 
     for (FabricIndex fabric_index = kMinValidFabricIndex; fabric_index < kMaxValidFabricIndex; fabric_index++)
     {
@@ -17,6 +17,7 @@
 
 #pragma once
 #include <app/clusters/scenes-server/ExtensionFieldSetsImpl.h>
+#include <app/clusters/scenes-server/SceneCache.h>
 #include <app/clusters/scenes-server/SceneHandlerImpl.h>
 #include <app/clusters/scenes-server/SceneTable.h>
 #include <app/util/attribute-storage.h>
@@ -52,7 +53,7 @@ static constexpr uint16_t kMaxScenesPerFabric = (kMaxScenesPerEndpoint - 1) / 2;
 class DefaultSceneTableImpl : public SceneTable<scenes::ExtensionFieldSetsImpl>
 {
 public:
-    DefaultSceneTableImpl() {}
+    DefaultSceneTableImpl() : mSceneCache(DefaultSceneCacheEntries()) {}
     ~DefaultSceneTableImpl() { Finish(); };
 
     CHIP_ERROR Init(PersistentStorageDelegate * storage) override;
@@ -95,9 +96,10 @@ public:
 
 protected:
     // This constructor is meant for test purposes, it allows to change the defined max for scenes per fabric and global, which
-    // allows to simulate OTA where this value was changed
-    DefaultSceneTableImpl(uint16_t maxScenesPerFabric, uint16_t maxScenesPerEndpoint) :
-        mMaxScenesPerFabric(maxScenesPerFabric), mMaxScenesPerEndpoint(maxScenesPerEndpoint)
+    // allows to simulate OTA where this value was changed. The scene cache is disabled unless entries are provided.
+    DefaultSceneTableImpl(uint16_t maxScenesPerFabric, uint16_t maxScenesPerEndpoint,
+                          Span<SceneCache::Entry> sceneCacheEntries = Span<SceneCache::Entry>()) :
+        mMaxScenesPerFabric(maxScenesPerFabric), mMaxScenesPerEndpoint(maxScenesPerEndpoint), mSceneCache(sceneCacheEntries)
     {}
 
     // Global scene count
@@ -129,11 +131,24 @@ protected:
         uint16_t mMaxScenesPerEndpoint;
     };
 
+    Span<SceneCache::Entry> DefaultSceneCacheEntries()
+    {
+#if CHIP_CONFIG_SCENES_CACHE_SIZE > 0
+        return Span<SceneCache::Entry>(mSceneCacheEntries);
+#else
+        return Span<SceneCache::Entry>();
+#endif // CHIP_CONFIG_SCENES_CACHE_SIZE > 0
+    }
+
     uint16_t mMaxScenesPerFabric               = kMaxScenesPerFabric;
     uint16_t mMaxScenesPerEndpoint             = kMaxScenesPerEndpoint;
     EndpointId mEndpointId                     = kInvalidEndpointId;
     chip::PersistentStorageDelegate * mStorage = nullptr;
     ObjectPool<SceneEntryIteratorImpl, kIteratorsMax> mSceneEntryIterators;
+#if CHIP_CONFIG_SCENES_CACHE_SIZE > 0
+    SceneCache::Entry mSceneCacheEntries[CHIP_CONFIG_SCENES_CACHE_SIZE];
+#endif // CHIP_CONFIG_SCENES_CACHE_SIZE > 0
+    SceneCache mSceneCache;
 }; // class DefaultSceneTableImpl
 
 /// @brief Gets a pointer to the instance of Scene Table Impl, providing EndpointId and Table Size for said endpoint
@@ -35,6 +35,10 @@
 #include <app/reporting/Read.h>
 #include <app/util/MatterCallbacks.h>
 #include <app/util/ember-compatibility-functions.h>
+#include <tracing/macros.h>
+#include <tracing/metric_event.h>
+
+#include <algorithm>
 
 using namespace chip::Access;
 
@@ -42,12 +46,52 @@ namespace chip {
 namespace app {
 namespace reporting {
 
+#if CHIP_CONFIG_IM_REPORTING_STATISTICS
+namespace {
+
+// Accounts a Run pass in the statistics when going out of scope, so that passes ending early are accounted as well.
+class ScopedRunStatistics
+{
+public:
+    ScopedRunStatistics(ReportingStatistics & aStatistics) :
+        mStatistics(aStatistics), mReadHandlersServicedBefore(aStatistics.readHandlersServiced),
+        mStart(System::SystemClock().GetMonotonicMicroseconds64())
+    {}
+
+    ~ScopedRunStatistics()
+    {
+        const System::Clock::Microseconds64 elapsed = System::SystemClock().GetMonotonicMicroseconds64() - mStart;
+        const System::Clock::Microseconds32 runTime(static_cast<uint32_t>(std::min<uint64_t>(elapsed.count(), UINT32_MAX)));
+        const uint32_t readHandlersServiced = mStatistics.readHandlersServiced - mReadHandlersServicedBefore;
+
+        mStatistics.runs++;
+        mStatistics.totalRunTime += elapsed;
+        mStatistics.lastRunTime = runTime;
+        mStatistics.maxRunTime  = std::max(mStatistics.maxRunTime, runTime);
+
+        MATTER_LOG_METRIC(Tracing::kMetricReportingEngineRun, runTime.count());
+        MATTER_LOG_METRIC(Tracing::kMetricReportingEngineReadHandlersServiced, readHandlersServiced);
+        IgnoreUnusedVariable(readHandlersServiced);
+    }
+
+private:
+    ReportingStatistics & mStatistics;
+    const uint32_t mReadHandlersServicedBefore;
+    const System::Clock::Microseconds64 mStart;
+};
+
+} // namespace
+#endif // CHIP_CONFIG_IM_REPORTING_STATISTICS
+
 Engine::Engine(InteractionModelEngine * apImEngine) : mpImEngine(apImEngine) {}
 
 CHIP_ERROR Engine::Init()
 {
     mNumReportsInFlight = 0;
     mCurReadHandlerIdx  = 0;
+#if CHIP_CONFIG_IM_REPORTING_STATISTICS
+    ResetStatistics();
+#endif
     return CHIP_NO_ERROR;
 }
 
@@ -96,6 +140,9 @@ CHIP_ERROR Engine::BuildSingleReportDataAttributeReportIBs(ReportDataMessage::Bu
     TLV::TLVWriter backup;
     const uint32_t kReservedSizeEndOfReportIBs = 1;
     bool reservedEndOfReportIBs                = false;
+#if CHIP_CONFIG_IM_REPORTING_STATISTICS
+    uint32_t attributePathsExpanded = 0;
+#endif
 
     aReportDataBuilder.Checkpoint(backup);
 
@@ -136,6 +183,10 @@ CHIP_ERROR Engine::BuildSingleReportDataAttributeReportIBs(ReportDataMessage::Bu
         for (; apReadHandler->GetAttributePathExpandIterator()->Get(readPath);
              apReadHandler->GetAttributePathExpandIterator()->Next())
         {
+#if CHIP_CONFIG_IM_REPORTING_STATISTICS
+            attributePathsExpanded++;
+#endif
+
             if (!apReadHandler->IsPriming())
             {
                 bool concretePathDirty = false;
@@ -251,6 +302,11 @@ CHIP_ERROR Engine::BuildSingleReportDataAttributeReportIBs(ReportDataMessage::Bu
         hasMoreChunks = false;
     }
 exit:
+#if CHIP_CONFIG_IM_REPORTING_STATISTICS
+    mStatistics.attributePathsExpanded += attributePathsExpanded;
+    MATTER_LOG_METRIC(Tracing::kMetricReportingEngineAttributePaths, attributePathsExpanded);
+#endif
+
     if (attributeReportIBs.GetWriter()->GetLengthWritten() != emptyReportDataLength)
     {
         // We may encounter BUFFER_TOO_SMALL with nothing actually written for the case of list chunking, so we check if we have
@@ -480,6 +536,8 @@ exit:
 
 CHIP_ERROR Engine::BuildAndSendSingleReportData(ReadHandler * apReadHandler)
 {
+    MATTER_TRACE_SCOPE("BuildAndSendSingleReportData", "ReportingEngine");
+
     CHIP_ERROR err = CHIP_NO_ERROR;
     chip::System::PacketBufferTLVWriter reportDataWriter;
     ReportDataMessage::Builder reportDataBuilder;
@@ -502,6 +560,11 @@ CHIP_ERROR Engine::BuildAndSendSingleReportData(ReadHandler * apReadHandler)
     // Reserved size for an empty EventReportIBs, so we can at least check if there are any events need to be reported.
     const uint32_t kReservedSizeForEventReportIBs = 3; // type, tag, end of container
 
+#if CHIP_CONFIG_IM_REPORTING_STATISTICS
+    mStatistics.readHandlersServiced++;
+    MATTER_LOG_METRIC_BEGIN(Tracing::kMetricReportingEngineBuildReport);
+#endif
+
     VerifyOrExit(apReadHandler != nullptr, err = CHIP_ERROR_INVALID_ARGUMENT);
     VerifyOrExit(apReadHandler->GetSession() != nullptr, err = CHIP_ERROR_INCORRECT_STATE);
 
@@ -606,7 +669,26 @@ CHIP_ERROR Engine::BuildAndSendSingleReportData(ReadHandler * apReadHandler)
     ChipLogDetail(DataManagement, "<RE> ReportsInFlight = %" PRIu32 " with readHandler %" PRIu32 ", RE has %s", mNumReportsInFlight,
                   mCurReadHandlerIdx, hasMoreChunks ? "more messages" : "no more messages");
 
+#if CHIP_CONFIG_IM_REPORTING_STATISTICS
+    mStatistics.reportsSent++;
+    mStatistics.bytesEncoded += reportDataWriter.GetLengthWritten();
+    MATTER_LOG_METRIC(Tracing::kMetricReportingEngineReportBytes, reportDataWriter.GetLengthWritten());
+    if (hasMoreChunks)
+    {
+        mStatistics.chunkedReports++;
+        MATTER_LOG_METRIC(Tracing::kMetricReportingEngineChunkedReport);
+    }
+#endif // CHIP_CONFIG_IM_REPORTING_STATISTICS
+
 exit:
+#if CHIP_CONFIG_IM_REPORTING_STATISTICS
+    if (err != CHIP_NO_ERROR)
+    {
+        mStatistics.reportFailures++;
+    }
+    MATTER_LOG_METRIC_END(Tracing::kMetricReportingEngineBuildReport, err);
+#endif // CHIP_CONFIG_IM_REPORTING_STATISTICS
+
     if (err != CHIP_NO_ERROR || (apReadHandler->IsType(ReadHandler::InteractionType::Read) && !hasMoreChunks) ||
         needCloseReadHandler)
     {
@@ -657,6 +739,11 @@ CHIP_ERROR Engine::ScheduleRun()
 
 void Engine::Run()
 {
+    MATTER_TRACE_SCOPE("Run", "ReportingEngine");
+#if CHIP_CONFIG_IM_REPORTING_STATISTICS
+    ScopedRunStatistics runStatistics(mStatistics);
+#endif
+
     uint32_t numReadHandled = 0;
 
     // We may be deallocating read handlers as we go.  Track how many we had
@@ -826,14 +913,27 @@ bool Engine::MergeDirtyPathsUnderSameEndpoint()
 
 CHIP_ERROR Engine::InsertPathIntoDirtySet(const AttributePathParams & aAttributePath)
 {
+    MATTER_TRACE_SCOPE("InsertPathIntoDirtySet", "ReportingEngine");
+#if CHIP_CONFIG_IM_REPORTING_STATISTICS
+    mStatistics.dirtySetInsertions++;
+#endif
+
     ReturnErrorCodeIf(MergeOverlappedAttributePath(aAttributePath), CHIP_NO_ERROR);
 
-    if (mGlobalDirtySet.Exhausted() && !MergeDirtyPathsUnderSameCluster() && !MergeDirtyPathsUnderSameEndpoint())
+    if (mGlobalDirtySet.Exhausted())
     {
-        ChipLogDetail(DataManagement, "Global dirty set pool exhausted, merge all paths.");
-        mGlobalDirtySet.ReleaseAll();
-        auto object         = mGlobalDirtySet.CreateObject();
-        object->mGeneration = GetDirtySetGeneration();
+#if CHIP_CONFIG_IM_REPORTING_STATISTICS
+        mStatistics.dirtySetOverflows++;
+        MATTER_LOG_METRIC(Tracing::kMetricReportingEngineDirtySetOverflow);
+#endif
+
+        if (!MergeDirtyPathsUnderSameCluster() && !MergeDirtyPathsUnderSameEndpoint())
+        {
+            ChipLogDetail(DataManagement, "Global dirty set pool exhausted, merge all paths.");
+            mGlobalDirtySet.ReleaseAll();
+            auto object         = mGlobalDirtySet.CreateObject();
+            object->mGeneration = GetDirtySetGeneration();
+        }
     }
 
     ReturnErrorCodeIf(MergeOverlappedAttributePath(aAttributePath), CHIP_NO_ERROR);
@@ -900,6 +1000,18 @@ CHIP_ERROR Engine::SendReport(ReadHandler * apReadHandler, System::PacketBufferH
     return err;
 }
 
+#if CHIP_CONFIG_IM_REPORTING_STATISTICS
+void Engine::RecordReportLatency(System::Clock::Milliseconds64 aLatency)
+{
+    const System::Clock::Milliseconds32 latency(static_cast<uint32_t>(std::min<uint64_t>(aLatency.count(), UINT32_MAX)));
+
+    mStatistics.reportLatencySamples++;
+    mStatistics.totalReportLatency += aLatency;
+    mStatistics.maxReportLatency = std::max(mStatistics.maxReportLatency, latency);
+    MATTER_LOG_METRIC(Tracing::kMetricReportingEngineReportLatency, latency.count());
+}
+#endif // CHIP_CONFIG_IM_REPORTING_STATISTICS
+
 void Engine::OnReportConfirm()
 {
     VerifyOrDie(mNumReportsInFlight > 0);
@@ -34,6 +34,7 @@
 #include <messaging/ExchangeContext.h>
 #include <messaging/ExchangeMgr.h>
 #include <protocols/Protocols.h>
+#include <system/SystemClock.h>
 #include <system/SystemPacketBuffer.h>
 #include <system/TLVPacketBufferBackingStore.h>
 
@@ -44,6 +45,46 @@ class InteractionModelEngine;
 class TestReadInteraction;
 
 namespace reporting {
+
+#if CHIP_CONFIG_IM_REPORTING_STATISTICS
+/**
+ * Counters and timings of the reporting engine, accumulated since Engine::Init or the last Engine::ResetStatistics.
+ *
+ * The same values are logged as metric events (see the kMetricReportingEngine* keys) when tracing is enabled.
+ */
+struct ReportingStatistics
+{
+    // Run passes, and the time spent in them
+    uint32_t runs                              = 0;
+    System::Clock::Microseconds64 totalRunTime = System::Clock::kZero;
+    System::Clock::Microseconds32 maxRunTime   = System::Clock::kZero;
+    System::Clock::Microseconds32 lastRunTime  = System::Clock::kZero;
+
+    // ReadHandlers a report was built for, i.e. calls to BuildAndSendSingleReportData
+    uint32_t readHandlersServiced = 0;
+
+    // Report messages sent, how many of them had more chunks to follow, and how many could not be built or sent
+    uint32_t reportsSent    = 0;
+    uint32_t chunkedReports = 0;
+    uint32_t reportFailures = 0;
+
+    // Concrete attribute paths visited while building reports (including the ones that were not dirty)
+    uint64_t attributePathsExpanded = 0;
+
+    // Payload bytes of the report messages sent
+    uint64_t bytesEncoded = 0;
+
+    // Attribute paths marked dirty that some ReadHandler is interested in, and how many of them found the dirty set full
+    uint32_t dirtySetInsertions = 0;
+    uint32_t dirtySetOverflows  = 0;
+
+    // Time from the first attribute change after a subscription report to the start of the next report
+    uint32_t reportLatencySamples                    = 0;
+    System::Clock::Milliseconds64 totalReportLatency = System::Clock::kZero;
+    System::Clock::Milliseconds32 maxReportLatency   = System::Clock::kZero;
+};
+#endif // CHIP_CONFIG_IM_REPORTING_STATISTICS
+
 /*
  *  @class Engine
  *
@@ -140,6 +181,18 @@ public:
     size_t GetGlobalDirtySetSize() { return mGlobalDirtySet.Allocated(); }
 #endif
 
+#if CHIP_CONFIG_IM_REPORTING_STATISTICS
+    const ReportingStatistics & GetStatistics() const { return mStatistics; }
+
+    void ResetStatistics() { mStatistics = ReportingStatistics(); }
+
+    /**
+     * Called by a subscription ReadHandler when it starts a report, with the time elapsed since the first attribute change
+     * included in that report.
+     */
+    void RecordReportLatency(System::Clock::Milliseconds64 aLatency);
+#endif // CHIP_CONFIG_IM_REPORTING_STATISTICS
+
 private:
     /**
      * Main work-horse function that executes the run-loop.
@@ -282,6 +335,10 @@ private:
     uint32_t mMaxAttributesPerChunk = UINT32_MAX;
 #endif
 
+#if CHIP_CONFIG_IM_REPORTING_STATISTICS
+    ReportingStatistics mStatistics;
+#endif
+
     InteractionModelEngine * mpImEngine = nullptr;
 };
 
@@ -29,6 +29,7 @@
 #include <lib/core/TLVTags.h>
 #include <lib/core/TLVWriter.h>
 #include <lib/support/CodeUtils.h>
+#include <lib/support/logging/CHIPLogging.h>
 
 using namespace chip;
 using namespace chip::app;
@@ -577,6 +578,182 @@ TEST(TestAttributeValueEncoder, TestEncodeListChunking2)
     }
 }
 
+TEST(TestAttributeValueEncoder, TestEncodeListChunkingWithResumeCursor)
+{
+    AttributeEncodeState state;
+
+    bool list[]         = { true, false, false, true, true, false };
+    size_t itemsVisited = 0;
+    auto listEncoder    = [&list, &itemsVisited](const auto & encoder) -> CHIP_ERROR {
+        uint32_t start;
+        ReturnErrorOnFailure(encoder.ResumeCursor(start));
+        for (uint32_t i = start; i < ArraySize(list); i++)
+        {
+            itemsVisited++;
+            ReturnErrorOnFailure(encoder.EncodeAt(i + 1, list[i]));
+        }
+        return CHIP_NO_ERROR;
+    };
+
+    {
+        // Same chunking as TestEncodeListChunking: the first chunk fits "true" and "false".
+        LimitedTestSetup<30> test1(kTestFabricIndex);
+        CHIP_ERROR err = test1.encoder.EncodeList(listEncoder);
+        EXPECT_TRUE(err == CHIP_ERROR_NO_MEMORY || err == CHIP_ERROR_BUFFER_TOO_SMALL);
+        state = test1.encoder.GetState();
+
+        EXPECT_EQ(itemsVisited, 3u);
+        EXPECT_EQ(state.CurrentEncodingListIndex(), 2u);
+        EXPECT_TRUE(state.HasListResumeCursor());
+        EXPECT_EQ(state.ListResumeCursor(), 2u);
+    }
+    {
+        // The second chunk fits a single item, and must start at the saved cursor rather than replaying the first two items.
+        itemsVisited = 0;
+        LimitedTestSetup<30> test2(0, state);
+        CHIP_ERROR err = test2.encoder.EncodeList(listEncoder);
+        EXPECT_TRUE(err == CHIP_ERROR_NO_MEMORY || err == CHIP_ERROR_BUFFER_TOO_SMALL);
+        state = test2.encoder.GetState();
+
+        EXPECT_EQ(itemsVisited, 2u);
+        EXPECT_EQ(state.CurrentEncodingListIndex(), 3u);
+        EXPECT_EQ(state.ListResumeCursor(), 3u);
+
+        const uint8_t expected[] = {
+            // clang-format off
+            0x15, 0x36, 0x01, // Test overhead, Start Anonymous struct + Start 1 byte Tag Array + Tag (01)
+            0x15, // Start anonymous struct
+              0x35, 0x01, // Start 1 byte tag struct + Tag (01)
+                0x24, 0x00, 0x99, // Tag (00) Value (1 byte uint) 0x99 (Attribute Version)
+                0x37, 0x01, // Start 1 byte tag list + Tag (01) (Attribute Path)
+                  0x24, 0x02, 0x55, // Tag (02) Value (1 byte uint) 0x55
+                  0x24, 0x03, 0xaa, // Tag (03) Value (1 byte uint) 0xaa
+                  0x24, 0x04, 0xcc, // Tag (04) Value (1 byte uint) 0xcc
+                  0x34, 0x05, // Tag (05) Null
+                0x18, // End of container
+                0x28, 0x02, // Tag (02) Value False (Attribute Value)
+              0x18, // End of container
+            0x18, // End of container
+            // clang-format on
+        };
+        VERIFY_BUFFER_STATE(test2, expected);
+    }
+    {
+        // Encode everything else.
+        itemsVisited = 0;
+        TestSetup test3(0, state);
+        CHIP_ERROR err = test3.encoder.EncodeList(listEncoder);
+        EXPECT_EQ(err, CHIP_NO_ERROR);
+        EXPECT_EQ(itemsVisited, 3u);
+
+        // A completed list clears the state, including the cursor.
+        state = test3.encoder.GetState();
+        EXPECT_EQ(state.CurrentEncodingListIndex(), kInvalidListIndex);
+        EXPECT_FALSE(state.HasListResumeCursor());
+    }
+}
+
+TEST(TestAttributeValueEncoder, TestEncodeListChunkingMixedCursorFallsBackToSkipping)
+{
+    AttributeEncodeState state;
+
+    bool list[]      = { true, false, false, true, true, false };
+    auto listEncoder = [&list](const auto & encoder) -> CHIP_ERROR {
+        uint32_t start;
+        ReturnErrorOnFailure(encoder.ResumeCursor(start));
+        for (uint32_t i = start; i < ArraySize(list); i++)
+        {
+            // Only some items carry a cursor, so the cursor can not be trusted for resumption.
+            if (i % 2 == 0)
+            {
+                ReturnErrorOnFailure(encoder.EncodeAt(i + 1, list[i]));
+            }
+            else
+            {
+                ReturnErrorOnFailure(encoder.Encode(list[i]));
+            }
+        }
+        return CHIP_NO_ERROR;
+    };
+
+    LimitedTestSetup<30> test1(kTestFabricIndex);
+    CHIP_ERROR err = test1.encoder.EncodeList(listEncoder);
+    EXPECT_TRUE(err == CHIP_ERROR_NO_MEMORY || err == CHIP_ERROR_BUFFER_TOO_SMALL);
+    state = test1.encoder.GetState();
+    EXPECT_EQ(state.CurrentEncodingListIndex(), 2u);
+    EXPECT_FALSE(state.HasListResumeCursor());
+
+    // Resuming replays from the start and skips the two items already sent.
+    LimitedTestSetup<30> test2(0, state);
+    err = test2.encoder.EncodeList(listEncoder);
+    EXPECT_TRUE(err == CHIP_ERROR_NO_MEMORY || err == CHIP_ERROR_BUFFER_TOO_SMALL);
+    EXPECT_EQ(test2.encoder.GetState().CurrentEncodingListIndex(), 3u);
+}
+
+TEST(TestAttributeValueEncoder, TestEncodeListResumeCursorAfterItem)
+{
+    auto listEncoder = [](const auto & encoder) -> CHIP_ERROR {
+        ReturnErrorOnFailure(encoder.Encode(true));
+
+        // Too late to seek: the producer has to go on from where it is.
+        uint32_t cursor = 1;
+        EXPECT_EQ(encoder.ResumeCursor(cursor), CHIP_ERROR_INCORRECT_STATE);
+        EXPECT_EQ(cursor, 0u);
+        return encoder.Encode(false);
+    };
+
+    TestSetup test(kTestFabricIndex);
+    EXPECT_EQ(test.encoder.EncodeList(listEncoder), CHIP_NO_ERROR);
+}
+
+TEST(TestAttributeValueEncoder, TestEncodeLargeListChunkingProducerWork)
+{
+    constexpr uint32_t kListSize = 100;
+
+    // Encodes the whole list one small chunk at a time, and returns how many items the producer visited.
+    auto encodeInChunks = [](bool useCursor, size_t & chunks) -> size_t {
+        size_t itemsVisited = 0;
+        auto listEncoder    = [useCursor, &itemsVisited](const auto & encoder) -> CHIP_ERROR {
+            uint32_t start = 0;
+            if (useCursor)
+            {
+                ReturnErrorOnFailure(encoder.ResumeCursor(start));
+            }
+            for (uint32_t i = start; i < kListSize; i++)
+            {
+                itemsVisited++;
+                ReturnErrorOnFailure(useCursor ? encoder.EncodeAt(i + 1, (i % 2) == 0) : encoder.Encode((i % 2) == 0));
+            }
+            return CHIP_NO_ERROR;
+        };
+
+        AttributeEncodeState state;
+        CHIP_ERROR err = CHIP_ERROR_NO_MEMORY;
+        for (chunks = 0; err != CHIP_NO_ERROR && chunks <= kListSize; chunks++)
+        {
+            LimitedTestSetup<30> test(kUndefinedFabricIndex, state);
+            err = test.encoder.EncodeList(listEncoder);
+            EXPECT_TRUE(err == CHIP_NO_ERROR || err == CHIP_ERROR_NO_MEMORY || err == CHIP_ERROR_BUFFER_TOO_SMALL);
+            state = test.encoder.GetState();
+        }
+        EXPECT_EQ(err, CHIP_NO_ERROR);
+        return itemsVisited;
+    };
+
+    size_t skippingChunks = 0;
+    size_t cursorChunks   = 0;
+    size_t skippingVisits = encodeInChunks(false, skippingChunks);
+    size_t cursorVisits   = encodeInChunks(true, cursorChunks);
+
+    // Both produce the same chunks, but replaying the list costs a visit of every item already sent for each chunk.
+    EXPECT_EQ(cursorChunks, skippingChunks);
+    EXPECT_LE(cursorVisits, kListSize + 2 * cursorChunks);
+    EXPECT_GE(skippingVisits, kListSize * cursorChunks / 2);
+    ChipLogProgress(Test, "%u items in %u chunks: producer visited %u items when skipping, %u with the resume cursor",
+                    static_cast<unsigned>(kListSize), static_cast<unsigned>(cursorChunks), static_cast<unsigned>(skippingVisits),
+                    static_cast<unsigned>(cursorVisits));
+}
+
 TEST(TestAttributeValueEncoder, TestEncodePreEncoded)
 {
     TestSetup test{};
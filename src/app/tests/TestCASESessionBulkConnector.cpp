@@ -0,0 +1,455 @@
+/*
+ *
+ *    Copyright (c) 2024 Project CHIP Authors
+ *    All rights reserved.
+ *
+ *    Licensed under the Apache License, Version 2.0 (the "License");
+ *    you may not use this file except in compliance with the License.
+ *    You may obtain a copy of the License at
+ *
+ *        http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *    Unless required by applicable law or agreed to in writing, software
+ *    distributed under the License is distributed on an "AS IS" BASIS,
+ *    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *    See the License for the specific language governing permissions and
+ *    limitations under the License.
+ */
+
+#include <app/CASESessionBulkConnector.h>
+#include <lib/core/StringBuilderAdapters.h>
+#include <lib/support/CHIPMem.h>
+#include <messaging/ExchangeMgr.h>
+#include <system/SystemClock.h>
+#include <system/SystemLayer.h>
+#include <transport/GroupSession.h>
+
+#include <pw_unit_test/framework.h>
+
+#include <vector>
+
+using namespace chip;
+using namespace chip::System::Clock;
+using namespace chip::System::Clock::Literals;
+
+namespace {
+
+constexpr FabricIndex kFabricIndex = 1;
+constexpr GroupId kGroupId         = 1;
+
+/// System layer with the single timer slot the connector needs, driven by a mock clock.
+class FakeSystemLayer : public System::Layer
+{
+public:
+    CHIP_ERROR Init() override { return CHIP_NO_ERROR; }
+    void Shutdown() override {}
+    bool IsInitialized() const override { return true; }
+
+    CHIP_ERROR StartTimer(Timeout delay, System::TimerCompleteCallback callback, void * appState) override
+    {
+        mCallback = callback;
+        mAppState = appState;
+        mDeadline = System::SystemClock().GetMonotonicTimestamp() + delay;
+        return CHIP_NO_ERROR;
+    }
+
+    CHIP_ERROR ExtendTimerTo(Timeout delay, System::TimerCompleteCallback callback, void * appState) override
+    {
+        return CHIP_ERROR_NOT_IMPLEMENTED;
+    }
+
+    bool IsTimerActive(System::TimerCompleteCallback callback, void * appState) override
+    {
+        return mCallback == callback && mAppState == appState;
+    }
+
+    Timeout GetRemainingTime(System::TimerCompleteCallback callback, void * appState) override { return 0_ms; }
+
+    void CancelTimer(System::TimerCompleteCallback callback, void * appState) override
+    {
+        if (IsTimerActive(callback, appState))
+        {
+            mCallback = nullptr;
+        }
+    }
+
+    CHIP_ERROR ScheduleWork(System::TimerCompleteCallback callback, void * appState) override
+    {
+        return CHIP_ERROR_NOT_IMPLEMENTED;
+    }
+
+    bool HasTimer() const { return mCallback != nullptr; }
+    Timestamp Deadline() const { return mDeadline; }
+
+    /// Advance the clock to the deadline of the timer and fire it.
+    void FireTimer(Internal::MockClock & clock)
+    {
+        ASSERT_TRUE(HasTimer());
+        if (clock.GetMonotonicTimestamp() < mDeadline)
+        {
+            clock.SetMonotonic(mDeadline);
+        }
+
+        auto callback = mCallback;
+        mCallback     = nullptr;
+        callback(this, mAppState);
+    }
+
+private:
+    System::TimerCompleteCallback mCallback = nullptr;
+    void * mAppState                        = nullptr;
+    Timestamp mDeadline;
+};
+
+/// Connector recording the session establishments and address resolutions it starts instead of running them.
+class TestConnector : public CASESessionBulkConnector
+{
+public:
+    struct Attempt
+    {
+        ScopedNodeId peerId;
+        Callback::Callback<OnDeviceConnected> * onConnected;
+        Callback::Callback<OnDeviceConnectionFailure> * onFailure;
+    };
+
+    void Succeed(size_t attempt, Messaging::ExchangeManager & exchangeMgr, const SessionHandle & session)
+    {
+        auto * callback = attempts[attempt].onConnected;
+        callback->mCall(callback->mContext, exchangeMgr, session);
+    }
+
+    void Fail(size_t attempt, CHIP_ERROR error)
+    {
+        auto * callback = attempts[attempt].onFailure;
+        callback->mCall(callback->mContext, attempts[attempt].peerId, error);
+    }
+
+    std::vector<Attempt> attempts;
+    std::vector<NodeId> primed;
+    std::vector<Transport::PeerAddress> primedAddresses;
+    std::vector<NodeId> primingCancelled;
+
+protected:
+    void EstablishSession(const ScopedNodeId & peerId, Callback::Callback<OnDeviceConnected> * onConnected,
+                          Callback::Callback<OnDeviceConnectionFailure> * onFailure) override
+    {
+        attempts.push_back({ peerId, onConnected, onFailure });
+    }
+
+    void PrimeAddress(const Peer & peer) override
+    {
+        primed.push_back(peer.peerId.GetNodeId());
+        primedAddresses.push_back(peer.lastKnownAddress);
+    }
+
+    void CancelAddressPriming(const ScopedNodeId & peerId) override { primingCancelled.push_back(peerId.GetNodeId()); }
+};
+
+class TestDelegate : public CASESessionBulkConnector::Delegate
+{
+public:
+    void OnPeerConnected(const ScopedNodeId & peerId, Messaging::ExchangeManager & exchangeMgr,
+                         const SessionHandle & sessionHandle) override
+    {
+        connected.push_back(peerId.GetNodeId());
+    }
+
+    void OnPeerConnectionFailure(const ScopedNodeId & peerId, CHIP_ERROR error) override
+    {
+        failed.push_back(peerId.GetNodeId());
+        lastError = error;
+    }
+
+    void OnBulkConnectComplete(size_t connectedCount, size_t failedCount, Milliseconds32 elapsed) override
+    {
+        completeCalls++;
+        completeConnected = connectedCount;
+        completeFailed    = failedCount;
+        completeElapsed   = elapsed;
+    }
+
+    std::vector<NodeId> connected;
+    std::vector<NodeId> failed;
+    CHIP_ERROR lastError           = CHIP_NO_ERROR;
+    int completeCalls              = 0;
+    size_t completeConnected       = 0;
+    size_t completeFailed          = 0;
+    Milliseconds32 completeElapsed = 0_ms;
+};
+
+class TestCASESessionBulkConnector : public ::testing::Test
+{
+public:
+    static void SetUpTestSuite() { ASSERT_EQ(chip::Platform::MemoryInit(), CHIP_NO_ERROR); }
+    static void TearDownTestSuite() { chip::Platform::MemoryShutdown(); }
+
+    void SetUp() override
+    {
+        mSavedClock = &System::SystemClock();
+        System::Clock::Internal::SetSystemClockForTesting(&mClock);
+        EXPECT_EQ(mConnector.Init(&mSessionManager, &mLayer), CHIP_NO_ERROR);
+    }
+
+    void TearDown() override
+    {
+        mConnector.Cancel();
+        System::Clock::Internal::SetSystemClockForTesting(mSavedClock);
+    }
+
+protected:
+    static CASESessionBulkConnector::Peer MakePeer(NodeId nodeId, uint8_t priority = 0)
+    {
+        CASESessionBulkConnector::Peer peer;
+        peer.peerId   = ScopedNodeId(nodeId, kFabricIndex);
+        peer.priority = priority;
+        return peer;
+    }
+
+    static CASESessionBulkConnector::Params MakeParams(uint8_t maxConcurrent, Milliseconds32 pacingInterval, uint8_t primeAhead)
+    {
+        CASESessionBulkConnector::Params params;
+        params.maxConcurrent  = maxConcurrent;
+        params.pacingInterval = pacingInterval;
+        params.primeAhead     = primeAhead;
+        return params;
+    }
+
+    Messaging::ExchangeManager & GetExchangeManager() { return mExchangeManager; }
+    const SessionHandle & GetSessionAliceToBob() const { return mSessionHandle; }
+
+    Internal::MockClock mClock;
+    FakeSystemLayer mLayer;
+    // Never initialized: the connector only hands them over to the delegate, and the test connector does not use the
+    // session manager.
+    CASESessionManager mSessionManager;
+    Messaging::ExchangeManager mExchangeManager;
+    Transport::IncomingGroupSession mSession{ kGroupId, kFabricIndex, 1 };
+    SessionHandle mSessionHandle{ mSession };
+    TestConnector mConnector;
+    TestDelegate mDelegate;
+
+private:
+    ClockBase * mSavedClock = nullptr;
+};
+
+} // namespace
+
+TEST_F(TestCASESessionBulkConnector, TestStartArguments)
+{
+    const CASESessionBulkConnector::Peer peers[] = { MakePeer(1) };
+
+    EXPECT_EQ(mConnector.Start(Span<const CASESessionBulkConnector::Peer>(), MakeParams(1, 0_ms, 0), &mDelegate),
+              CHIP_ERROR_INVALID_ARGUMENT);
+    EXPECT_EQ(mConnector.Start(Span<const CASESessionBulkConnector::Peer>(peers), MakeParams(0, 0_ms, 0), &mDelegate),
+              CHIP_ERROR_INVALID_ARGUMENT);
+    EXPECT_EQ(mConnector.Start(Span<const CASESessionBulkConnector::Peer>(peers), MakeParams(1, 0_ms, 0), nullptr),
+              CHIP_ERROR_INVALID_ARGUMENT);
+
+    EXPECT_EQ(mConnector.Start(Span<const CASESessionBulkConnector::Peer>(peers), MakeParams(1, 0_ms, 0), &mDelegate),
+              CHIP_NO_ERROR);
+    EXPECT_TRUE(mConnector.IsActive());
+    EXPECT_EQ(mConnector.Start(Span<const CASESessionBulkConnector::Peer>(peers), MakeParams(1, 0_ms, 0), &mDelegate),
+              CHIP_ERROR_INCORRECT_STATE);
+
+    // Nothing is started synchronously, and cancelling does not call the delegate.
+    EXPECT_TRUE(mConnector.attempts.empty());
+    mConnector.Cancel();
+    EXPECT_FALSE(mConnector.IsActive());
+    EXPECT_FALSE(mLayer.HasTimer());
+    EXPECT_EQ(mDelegate.completeCalls, 0);
+}
+
+TEST_F(TestCASESessionBulkConnector, TestConcurrencyLimitAndCompletion)
+{
+    // Higher priorities first, equal priorities in list order.
+    const CASESessionBulkConnector::Peer peers[] = { MakePeer(1), MakePeer(2, 5), MakePeer(3), MakePeer(4, 5), MakePeer(5) };
+    ASSERT_EQ(mConnector.Start(Span<const CASESessionBulkConnector::Peer>(peers), MakeParams(2, 0_ms, 0), &mDelegate),
+              CHIP_NO_ERROR);
+
+    mLayer.FireTimer(mClock);
+    ASSERT_EQ(mConnector.attempts.size(), 2u);
+    EXPECT_EQ(mConnector.attempts[0].peerId.GetNodeId(), 2u);
+    EXPECT_EQ(mConnector.attempts[1].peerId.GetNodeId(), 4u);
+    EXPECT_EQ(mConnector.InFlightCount(), 2u);
+    EXPECT_EQ(mConnector.PendingCount(), 3u);
+    EXPECT_FALSE(mLayer.HasTimer());
+
+    // A completion frees a slot, which is refilled from the timer rather than from within the callback.
+    mConnector.Succeed(0, GetExchangeManager(), GetSessionAliceToBob());
+    EXPECT_TRUE(mDelegate.connected == std::vector<NodeId>({ 2 }));
+    EXPECT_EQ(mConnector.attempts.size(), 2u);
+    mLayer.FireTimer(mClock);
+    ASSERT_EQ(mConnector.attempts.size(), 3u);
+    EXPECT_EQ(mConnector.attempts[2].peerId.GetNodeId(), 1u);
+
+    mConnector.Fail(1, CHIP_ERROR_TIMEOUT);
+    EXPECT_TRUE(mDelegate.failed == std::vector<NodeId>({ 4 }));
+    EXPECT_EQ(mDelegate.lastError, CHIP_ERROR_TIMEOUT);
+
+    // A repeated callback for a finished slot is ignored. Once refilled, the slot belongs to the next peer.
+    mConnector.Fail(1, CHIP_ERROR_TIMEOUT);
+    EXPECT_EQ(mDelegate.failed.size(), 1u);
+
+    mLayer.FireTimer(mClock);
+    ASSERT_EQ(mConnector.attempts.size(), 4u);
+    EXPECT_EQ(mConnector.attempts[3].peerId.GetNodeId(), 3u);
+
+    mConnector.Succeed(2, GetExchangeManager(), GetSessionAliceToBob());
+    mLayer.FireTimer(mClock);
+    ASSERT_EQ(mConnector.attempts.size(), 5u);
+    EXPECT_EQ(mConnector.attempts[4].peerId.GetNodeId(), 5u);
+    EXPECT_EQ(mConnector.PendingCount(), 0u);
+
+    mConnector.Succeed(3, GetExchangeManager(), GetSessionAliceToBob());
+    EXPECT_EQ(mDelegate.completeCalls, 0);
+    EXPECT_FALSE(mLayer.HasTimer());
+
+    mClock.AdvanceMonotonic(250_ms);
+    mConnector.Fail(4, CHIP_ERROR_NOT_CONNECTED);
+    EXPECT_EQ(mDelegate.completeCalls, 1);
+    EXPECT_EQ(mDelegate.completeConnected, 3u);
+    EXPECT_EQ(mDelegate.completeFailed, 2u);
+    EXPECT_EQ(mDelegate.completeElapsed, 250_ms);
+    EXPECT_FALSE(mConnector.IsActive());
+}
+
+TEST_F(TestCASESessionBulkConnector, TestPacing)
+{
+    const CASESessionBulkConnector::Peer peers[] = { MakePeer(1), MakePeer(2), MakePeer(3) };
+    ASSERT_EQ(mConnector.Start(Span<const CASESessionBulkConnector::Peer>(peers), MakeParams(4, 100_ms, 0), &mDelegate),
+              CHIP_NO_ERROR);
+
+    // One establishment per pacing interval, even though more could run concurrently.
+    mLayer.FireTimer(mClock);
+    EXPECT_EQ(mConnector.attempts.size(), 1u);
+    EXPECT_EQ(mLayer.Deadline(), Timestamp(100));
+
+    mLayer.FireTimer(mClock);
+    EXPECT_EQ(mConnector.attempts.size(), 2u);
+    EXPECT_EQ(mLayer.Deadline(), Timestamp(200));
+
+    // A completion does not shorten the pacing interval.
+    mConnector.Succeed(0, GetExchangeManager(), GetSessionAliceToBob());
+    EXPECT_EQ(mLayer.Deadline(), Timestamp(200));
+
+    mLayer.FireTimer(mClock);
+    EXPECT_EQ(mConnector.attempts.size(), 3u);
+    EXPECT_FALSE(mLayer.HasTimer());
+
+    mConnector.Succeed(1, GetExchangeManager(), GetSessionAliceToBob());
+    mConnector.Succeed(2, GetExchangeManager(), GetSessionAliceToBob());
+    EXPECT_EQ(mDelegate.completeCalls, 1);
+    EXPECT_EQ(mDelegate.completeConnected, 3u);
+    EXPECT_EQ(mDelegate.completeElapsed, 200_ms);
+}
+
+TEST_F(TestCASESessionBulkConnector, TestAddressPriming)
+{
+    const CASESessionBulkConnector::Peer peers[] = { MakePeer(1), MakePeer(2), MakePeer(3), MakePeer(4), MakePeer(5) };
+    ASSERT_EQ(mConnector.Start(Span<const CASESessionBulkConnector::Peer>(peers), MakeParams(1, 0_ms, 2), &mDelegate),
+              CHIP_NO_ERROR);
+
+    // The peers after the started one are resolved ahead of time, the started one is not.
+    mLayer.FireTimer(mClock);
+    EXPECT_EQ(mConnector.attempts.size(), 1u);
+    EXPECT_TRUE(mConnector.primed == std::vector<NodeId>({ 2, 3 }));
+
+    // The window moves along as peers are started, and no peer is resolved twice.
+    mConnector.Fail(0, CHIP_ERROR_TIMEOUT);
+    mLayer.FireTimer(mClock);
+    EXPECT_EQ(mConnector.attempts.size(), 2u);
+    EXPECT_TRUE(mConnector.primed == std::vector<NodeId>({ 2, 3, 4 }));
+
+    // Cancelling stops the resolutions of the primed peers that were never started.
+    mConnector.Cancel();
+    EXPECT_TRUE(mConnector.primingCancelled == std::vector<NodeId>({ 3, 4 }));
+    EXPECT_EQ(mDelegate.completeCalls, 0);
+}
+
+TEST_F(TestCASESessionBulkConnector, TestAddressPrimingLimit)
+{
+    constexpr size_t kMaxAddressLookups = CASESessionBulkConnector::kMaxAddressLookups;
+
+    const CASESessionBulkConnector::Peer peers[] = { MakePeer(1), MakePeer(2), MakePeer(3), MakePeer(4), MakePeer(5),
+                                                     MakePeer(6), MakePeer(7), MakePeer(8), MakePeer(9), MakePeer(10) };
+    if (kMaxAddressLookups < 2 || kMaxAddressLookups >= ArraySize(peers))
+    {
+        GTEST_SKIP();
+    }
+
+    ASSERT_EQ(mConnector.Start(Span<const CASESessionBulkConnector::Peer>(peers), MakeParams(2, 0_ms, UINT8_MAX), &mDelegate),
+              CHIP_NO_ERROR);
+
+    // Established and primed peers together never need more address lookups than the resolver can track.
+    mLayer.FireTimer(mClock);
+    EXPECT_EQ(mConnector.attempts.size(), 2u);
+    EXPECT_EQ(mConnector.primed.size() + mConnector.InFlightCount(), kMaxAddressLookups);
+
+    // Refilling a slot moves the window along, and a primed peer that is started keeps its lookup.
+    mConnector.Succeed(0, GetExchangeManager(), GetSessionAliceToBob());
+    mLayer.FireTimer(mClock);
+    ASSERT_EQ(mConnector.attempts.size(), 3u);
+    EXPECT_EQ(mConnector.primed.size() - 1 + mConnector.InFlightCount(), kMaxAddressLookups);
+}
+
+TEST_F(TestCASESessionBulkConnector, TestAddressPrimingFromLastKnownAddress)
+{
+    Inet::IPAddress ipAddress;
+    ASSERT_TRUE(Inet::IPAddress::FromString("fd00::2", ipAddress));
+    const Transport::PeerAddress lastKnownAddress = Transport::PeerAddress::UDP(ipAddress, CHIP_PORT);
+
+    CASESessionBulkConnector::Peer peers[] = { MakePeer(1), MakePeer(2), MakePeer(3) };
+    peers[1].lastKnownAddress              = lastKnownAddress;
+    ASSERT_EQ(mConnector.Start(Span<const CASESessionBulkConnector::Peer>(peers), MakeParams(1, 0_ms, 2), &mDelegate),
+              CHIP_NO_ERROR);
+
+    // The last known address is handed over along with the peer to prime.
+    mLayer.FireTimer(mClock);
+    ASSERT_TRUE(mConnector.primed == std::vector<NodeId>({ 2, 3 }));
+    EXPECT_EQ(mConnector.primedAddresses[0], lastKnownAddress);
+    EXPECT_FALSE(mConnector.primedAddresses[1].IsInitialized());
+
+    // A peer primed from its last known address has no DNS-SD resolution to stop.
+    mConnector.Cancel();
+    EXPECT_TRUE(mConnector.primingCancelled == std::vector<NodeId>({ 3 }));
+}
+
+TEST_F(TestCASESessionBulkConnector, TestRestartFromCompletion)
+{
+    class RestartingDelegate : public TestDelegate
+    {
+    public:
+        void OnBulkConnectComplete(size_t connectedCount, size_t failedCount, Milliseconds32 elapsed) override
+        {
+            TestDelegate::OnBulkConnectComplete(connectedCount, failedCount, elapsed);
+            if (completeCalls == 1)
+            {
+                const CASESessionBulkConnector::Peer peers[] = { MakePeer(7) };
+                restartError = connector->Start(Span<const CASESessionBulkConnector::Peer>(peers), MakeParams(1, 0_ms, 0), this);
+            }
+        }
+
+        TestConnector * connector = nullptr;
+        CHIP_ERROR restartError   = CHIP_ERROR_INTERNAL;
+    };
+
+    RestartingDelegate delegate;
+    delegate.connector = &mConnector;
+
+    const CASESessionBulkConnector::Peer peers[] = { MakePeer(1) };
+    ASSERT_EQ(mConnector.Start(Span<const CASESessionBulkConnector::Peer>(peers), MakeParams(1, 0_ms, 0), &delegate),
+              CHIP_NO_ERROR);
+    mLayer.FireTimer(mClock);
+    mConnector.Fail(0, CHIP_ERROR_TIMEOUT);
+
+    EXPECT_EQ(delegate.completeCalls, 1);
+    EXPECT_EQ(delegate.restartError, CHIP_NO_ERROR);
+    EXPECT_TRUE(mConnector.IsActive());
+
+    mLayer.FireTimer(mClock);
+    ASSERT_EQ(mConnector.attempts.size(), 2u);
+    EXPECT_EQ(mConnector.attempts[1].peerId.GetNodeId(), 7u);
+    mConnector.Succeed(1, GetExchangeManager(), GetSessionAliceToBob());
+    EXPECT_EQ(delegate.completeCalls, 2);
+    EXPECT_EQ(delegate.completeConnected, 1u);
+}
@@ -0,0 +1,398 @@
+/*
+ *
+ *    Copyright (c) 2024 Project CHIP Authors
+ *
+ *    Licensed under the Apache License, Version 2.0 (the "License");
+ *    you may not use this file except in compliance with the License.
+ *    You may obtain a copy of the License at
+ *
+ *        http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *    Unless required by applicable law or agreed to in writing, software
+ *    distributed under the License is distributed on an "AS IS" BASIS,
+ *    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *    See the License for the specific language governing permissions and
+ *    limitations under the License.
+ */
+
+#include <app/CoalescingPersistentStorageDelegate.h>
+#include <app/SimpleSubscriptionResumptionStorage.h>
+#include <app/tests/AppTestContext.h>
+#include <crypto/CHIPCryptoPAL.h>
+#include <lib/core/StringBuilderAdapters.h>
+#include <lib/support/DefaultStorageKeyAllocator.h>
+#include <lib/support/TestPersistentStorageDelegate.h>
+#include <protocols/secure_channel/SimpleSessionResumptionStorage.h>
+#include <pw_unit_test/framework.h>
+
+#include <cstring>
+#include <string>
+#include <vector>
+
+namespace {
+
+using namespace chip;
+using namespace chip::app;
+using namespace chip::System::Clock::Literals;
+
+constexpr System::Clock::Milliseconds32 kFlushInterval = 100_ms32;
+
+/// Counts the writes and deletes that reach the storage.
+class CountingStorageDelegate : public TestPersistentStorageDelegate
+{
+public:
+    CHIP_ERROR SyncSetKeyValue(const char * key, const void * value, uint16_t size) override
+    {
+        mWriteCount++;
+        return TestPersistentStorageDelegate::SyncSetKeyValue(key, value, size);
+    }
+
+    CHIP_ERROR SyncDeleteKeyValue(const char * key) override
+    {
+        mWriteCount++;
+        return TestPersistentStorageDelegate::SyncDeleteKeyValue(key);
+    }
+
+    size_t mWriteCount = 0;
+};
+
+class TestCoalescingPersistentStorageDelegate : public chip::Test::AppContext
+{
+};
+
+bool IsResumptionKey(const StorageKeyName & key)
+{
+    return CoalescingPersistentStorageDelegate::IsResumptionKey(key.KeyName());
+}
+
+TEST_F(TestCoalescingPersistentStorageDelegate, TestResumptionKeys)
+{
+    EXPECT_TRUE(IsResumptionKey(DefaultStorageKeyAllocator::SessionResumptionIndex()));
+    EXPECT_TRUE(IsResumptionKey(DefaultStorageKeyAllocator::FabricSession(3, 0x1122334455667788)));
+    EXPECT_TRUE(IsResumptionKey(DefaultStorageKeyAllocator::SubscriptionResumptionTable(0)));
+    EXPECT_TRUE(IsResumptionKey(DefaultStorageKeyAllocator::SubscriptionResumptionTable(0x1a)));
+    EXPECT_TRUE(IsResumptionKey(DefaultStorageKeyAllocator::SubscriptionResumption(2)));
+    EXPECT_TRUE(IsResumptionKey(DefaultStorageKeyAllocator::SubscriptionResumptionMaxCount()));
+
+    EXPECT_FALSE(IsResumptionKey(DefaultStorageKeyAllocator::FabricNOC(3)));
+    EXPECT_FALSE(IsResumptionKey(DefaultStorageKeyAllocator::FabricIndexInfo()));
+    EXPECT_FALSE(IsResumptionKey(DefaultStorageKeyAllocator::GroupDataCounter()));
+    EXPECT_FALSE(IsResumptionKey(DefaultStorageKeyAllocator::SafeAttributeValue(1, 6, 0)));
+}
+
+TEST_F(TestCoalescingPersistentStorageDelegate, TestWritesAreCoalesced)
+{
+    CountingStorageDelegate backend;
+    CoalescingPersistentStorageDelegate storage(backend, GetSystemLayer(), kFlushInterval);
+
+    const StorageKeyName key = DefaultStorageKeyAllocator::SessionResumptionIndex();
+    for (uint8_t i = 0; i < 10; i++)
+    {
+        EXPECT_EQ(storage.SyncSetKeyValue(key.KeyName(), &i, sizeof(i)), CHIP_NO_ERROR);
+    }
+    EXPECT_EQ(backend.mWriteCount, 0u);
+    EXPECT_EQ(storage.GetPendingWriteCount(), 1u);
+
+    // Reads are served from the pending writes.
+    uint8_t value = 0;
+    uint16_t size = sizeof(value);
+    EXPECT_EQ(storage.SyncGetKeyValue(key.KeyName(), &value, size), CHIP_NO_ERROR);
+    EXPECT_EQ(size, sizeof(value));
+    EXPECT_EQ(value, 9);
+    EXPECT_TRUE(storage.SyncDoesKeyExist(key.KeyName()));
+    EXPECT_FALSE(backend.SyncDoesKeyExist(key.KeyName()));
+
+    GetIOContext().DriveIOUntil(1000_ms32, [&backend] { return backend.mWriteCount > 0; });
+    EXPECT_EQ(backend.mWriteCount, 1u);
+    EXPECT_EQ(storage.GetPendingWriteCount(), 0u);
+
+    value = 0;
+    size  = sizeof(value);
+    EXPECT_EQ(backend.SyncGetKeyValue(key.KeyName(), &value, size), CHIP_NO_ERROR);
+    EXPECT_EQ(value, 9);
+}
+
+TEST_F(TestCoalescingPersistentStorageDelegate, TestPartialRead)
+{
+    CountingStorageDelegate backend;
+    CoalescingPersistentStorageDelegate storage(backend, GetSystemLayer(), kFlushInterval);
+
+    const StorageKeyName key = DefaultStorageKeyAllocator::SubscriptionResumption(0);
+    const uint8_t data[]     = { 1, 2, 3, 4 };
+    uint8_t buffer[2]        = {};
+    uint16_t size            = sizeof(buffer);
+
+    EXPECT_EQ(storage.SyncSetKeyValue(key.KeyName(), data, sizeof(data)), CHIP_NO_ERROR);
+    EXPECT_EQ(storage.SyncGetKeyValue(key.KeyName(), buffer, size), CHIP_ERROR_BUFFER_TOO_SMALL);
+    EXPECT_EQ(size, sizeof(buffer));
+    EXPECT_EQ(memcmp(buffer, data, sizeof(buffer)), 0);
+
+    size = 0;
+    EXPECT_EQ(storage.SyncGetKeyValue(key.KeyName(), nullptr, size), CHIP_ERROR_BUFFER_TOO_SMALL);
+
+    // Empty values are supported as well.
+    EXPECT_EQ(storage.SyncSetKeyValue(key.KeyName(), nullptr, 0), CHIP_NO_ERROR);
+    size = 0;
+    EXPECT_EQ(storage.SyncGetKeyValue(key.KeyName(), nullptr, size), CHIP_NO_ERROR);
+    EXPECT_EQ(storage.Flush(), CHIP_NO_ERROR);
+    EXPECT_TRUE(backend.SyncDoesKeyExist(key.KeyName()));
+}
+
+TEST_F(TestCoalescingPersistentStorageDelegate, TestDeletes)
+{
+    CountingStorageDelegate backend;
+    CoalescingPersistentStorageDelegate storage(backend, GetSystemLayer(), kFlushInterval);
+
+    const StorageKeyName key = DefaultStorageKeyAllocator::SubscriptionResumption(1);
+    const uint8_t value      = 0x5a;
+    uint8_t readValue        = 0;
+    uint16_t size            = sizeof(readValue);
+
+    EXPECT_EQ(storage.SyncDeleteKeyValue(key.KeyName()), CHIP_ERROR_PERSISTED_STORAGE_VALUE_NOT_FOUND);
+
+    // A key created and deleted between two flushes never reaches the storage.
+    EXPECT_EQ(storage.SyncSetKeyValue(key.KeyName(), &value, sizeof(value)), CHIP_NO_ERROR);
+    EXPECT_EQ(storage.SyncDeleteKeyValue(key.KeyName()), CHIP_NO_ERROR);
+    EXPECT_EQ(storage.SyncDeleteKeyValue(key.KeyName()), CHIP_ERROR_PERSISTED_STORAGE_VALUE_NOT_FOUND);
+    EXPECT_EQ(storage.Flush(), CHIP_NO_ERROR);
+    EXPECT_EQ(backend.mWriteCount, 0u);
+
+    // A pending delete hides the stored value until it is flushed.
+    EXPECT_EQ(backend.SyncSetKeyValue(key.KeyName(), &value, sizeof(value)), CHIP_NO_ERROR);
+    backend.mWriteCount = 0;
+    EXPECT_EQ(storage.SyncDeleteKeyValue(key.KeyName()), CHIP_NO_ERROR);
+    EXPECT_FALSE(storage.SyncDoesKeyExist(key.KeyName()));
+    EXPECT_EQ(storage.SyncGetKeyValue(key.KeyName(), &readValue, size), CHIP_ERROR_PERSISTED_STORAGE_VALUE_NOT_FOUND);
+    EXPECT_TRUE(backend.SyncDoesKeyExist(key.KeyName()));
+
+    EXPECT_EQ(storage.Flush(), CHIP_NO_ERROR);
+    EXPECT_EQ(backend.mWriteCount, 1u);
+    EXPECT_FALSE(backend.SyncDoesKeyExist(key.KeyName()));
+}
+
+TEST_F(TestCoalescingPersistentStorageDelegate, TestBarriers)
+{
+    CountingStorageDelegate backend;
+    CoalescingPersistentStorageDelegate storage(backend, GetSystemLayer(), kFlushInterval);
+
+    const StorageKeyName resumptionKey = DefaultStorageKeyAllocator::SessionResumptionIndex();
+    const StorageKeyName counterKey    = DefaultStorageKeyAllocator::GroupDataCounter();
+    const uint8_t value                = 1;
+
+    EXPECT_EQ(storage.SyncSetKeyValue(resumptionKey.KeyName(), &value, sizeof(value)), CHIP_NO_ERROR);
+    EXPECT_EQ(backend.mWriteCount, 0u);
+
+    // Writes of other keys are not held back, and flush the pending writes before them.
+    EXPECT_EQ(storage.SyncSetKeyValue(counterKey.KeyName(), &value, sizeof(value)), CHIP_NO_ERROR);
+    EXPECT_TRUE(backend.SyncDoesKeyExist(resumptionKey.KeyName()));
+    EXPECT_TRUE(backend.SyncDoesKeyExist(counterKey.KeyName()));
+    EXPECT_EQ(storage.GetPendingWriteCount(), 0u);
+
+    // Filling up the pending writes flushes them.
+    for (size_t i = 0; i <= CoalescingPersistentStorageDelegate::kMaxPendingWrites; i++)
+    {
+        EXPECT_EQ(storage.SyncSetKeyValue(DefaultStorageKeyAllocator::SubscriptionResumption(i).KeyName(), &value, sizeof(value)),
+                  CHIP_NO_ERROR);
+    }
+    EXPECT_EQ(storage.GetPendingWriteCount(), 1u);
+    EXPECT_TRUE(backend.SyncDoesKeyExist(DefaultStorageKeyAllocator::SubscriptionResumption(0).KeyName()));
+
+    // Destroying the decorator flushes the remaining writes.
+    backend.mWriteCount = 0;
+    {
+        CoalescingPersistentStorageDelegate other(backend, GetSystemLayer(), kFlushInterval);
+        EXPECT_EQ(other.SyncSetKeyValue(resumptionKey.KeyName(), &value, sizeof(value)), CHIP_NO_ERROR);
+    }
+    EXPECT_EQ(backend.mWriteCount, 1u);
+}
+
+TEST_F(TestCoalescingPersistentStorageDelegate, TestFailingFlushDoesNotBlockBarrier)
+{
+    CountingStorageDelegate backend;
+    CoalescingPersistentStorageDelegate storage(backend, GetSystemLayer(), kFlushInterval);
+
+    const StorageKeyName resumptionKey = DefaultStorageKeyAllocator::SessionResumptionIndex();
+    const StorageKeyName counterKey    = DefaultStorageKeyAllocator::GroupDataCounter();
+    const uint8_t value                = 1;
+
+    // A pending write the storage keeps failing to write does not hold back a critical write: the critical write goes
+    // ahead and returns its own status, and the failed pending write is dropped rather than written after it.
+    backend.AddPoisonKey(resumptionKey.KeyName());
+    EXPECT_EQ(storage.SyncSetKeyValue(resumptionKey.KeyName(), &value, sizeof(value)), CHIP_NO_ERROR);
+    EXPECT_EQ(storage.SyncSetKeyValue(counterKey.KeyName(), &value, sizeof(value)), CHIP_NO_ERROR);
+    EXPECT_TRUE(backend.SyncDoesKeyExist(counterKey.KeyName()));
+    EXPECT_EQ(storage.GetPendingWriteCount(), 0u);
+    EXPECT_FALSE(storage.SyncDoesKeyExist(resumptionKey.KeyName()));
+
+    // Deletes are barriers as well.
+    EXPECT_EQ(storage.SyncSetKeyValue(resumptionKey.KeyName(), &value, sizeof(value)), CHIP_NO_ERROR);
+    EXPECT_EQ(storage.SyncDeleteKeyValue(counterKey.KeyName()), CHIP_NO_ERROR);
+    EXPECT_FALSE(backend.SyncDoesKeyExist(counterKey.KeyName()));
+    EXPECT_EQ(storage.GetPendingWriteCount(), 0u);
+
+    // The critical write reports its own failure.
+    backend.AddPoisonKey(counterKey.KeyName());
+    EXPECT_EQ(storage.SyncSetKeyValue(counterKey.KeyName(), &value, sizeof(value)), CHIP_ERROR_PERSISTED_STORAGE_FAILED);
+}
+
+TEST_F(TestCoalescingPersistentStorageDelegate, TestFailingEntriesAgeOut)
+{
+    CountingStorageDelegate backend;
+    CoalescingPersistentStorageDelegate storage(backend, GetSystemLayer(), kFlushInterval);
+
+    const StorageKeyName failingKey = DefaultStorageKeyAllocator::SubscriptionResumption(0);
+    const StorageKeyName otherKey   = DefaultStorageKeyAllocator::SubscriptionResumption(1);
+    const uint8_t value             = 1;
+
+    backend.AddPoisonKey(failingKey.KeyName());
+    EXPECT_EQ(storage.SyncSetKeyValue(failingKey.KeyName(), &value, sizeof(value)), CHIP_NO_ERROR);
+    EXPECT_EQ(storage.SyncSetKeyValue(otherKey.KeyName(), &value, sizeof(value)), CHIP_NO_ERROR);
+
+    // The failing entry is retried, and does not keep the others from being written.
+    for (uint8_t attempt = 1; attempt < CoalescingPersistentStorageDelegate::kMaxFlushAttempts; attempt++)
+    {
+        EXPECT_EQ(storage.Flush(), CHIP_ERROR_PERSISTED_STORAGE_FAILED);
+        EXPECT_EQ(storage.GetPendingWriteCount(), 1u);
+        EXPECT_TRUE(backend.SyncDoesKeyExist(otherKey.KeyName()));
+    }
+
+    // Then it is dropped.
+    EXPECT_EQ(storage.Flush(), CHIP_ERROR_PERSISTED_STORAGE_FAILED);
+    EXPECT_EQ(storage.GetPendingWriteCount(), 0u);
+    EXPECT_EQ(storage.Flush(), CHIP_NO_ERROR);
+}
+
+TEST_F(TestCoalescingPersistentStorageDelegate, TestFlushInWriteOrder)
+{
+    /// Records the order in which keys reach the storage.
+    class OrderRecordingStorageDelegate : public TestPersistentStorageDelegate
+    {
+    public:
+        CHIP_ERROR SyncSetKeyValue(const char * key, const void * value, uint16_t size) override
+        {
+            mOrder.push_back(key);
+            return TestPersistentStorageDelegate::SyncSetKeyValue(key, value, size);
+        }
+
+        CHIP_ERROR SyncDeleteKeyValue(const char * key) override
+        {
+            mOrder.push_back(key);
+            return TestPersistentStorageDelegate::SyncDeleteKeyValue(key);
+        }
+
+        std::vector<std::string> mOrder;
+    };
+
+    OrderRecordingStorageDelegate backend;
+    CoalescingPersistentStorageDelegate storage(backend, GetSystemLayer(), kFlushInterval);
+
+    const StorageKeyName first  = DefaultStorageKeyAllocator::SubscriptionResumption(0);
+    const StorageKeyName second = DefaultStorageKeyAllocator::SubscriptionResumption(1);
+    const StorageKeyName third  = DefaultStorageKeyAllocator::SubscriptionResumption(2);
+    const uint8_t value         = 1;
+
+    EXPECT_EQ(backend.SyncSetKeyValue(third.KeyName(), &value, sizeof(value)), CHIP_NO_ERROR);
+    backend.mOrder.clear();
+
+    // The first key takes the first slot, but is written last.
+    EXPECT_EQ(storage.SyncSetKeyValue(first.KeyName(), &value, sizeof(value)), CHIP_NO_ERROR);
+    EXPECT_EQ(storage.SyncSetKeyValue(second.KeyName(), &value, sizeof(value)), CHIP_NO_ERROR);
+    EXPECT_EQ(storage.SyncDeleteKeyValue(third.KeyName()), CHIP_NO_ERROR);
+    EXPECT_EQ(storage.SyncSetKeyValue(first.KeyName(), &value, sizeof(value)), CHIP_NO_ERROR);
+    EXPECT_EQ(storage.Flush(), CHIP_NO_ERROR);
+
+    const std::vector<std::string> expected = { second.KeyName(), third.KeyName(), first.KeyName() };
+    EXPECT_TRUE(backend.mOrder == expected);
+}
+
+/// Saves `count` CASE sessions with the same peer, as happens when a controller reconnects.
+size_t CountSessionResumptionWrites(PersistentStorageDelegate & storage, CountingStorageDelegate & backend, size_t count)
+{
+    SimpleSessionResumptionStorage sessionStorage;
+    EXPECT_EQ(sessionStorage.Init(&storage), CHIP_NO_ERROR);
+
+    const ScopedNodeId node(0x1122334455667788, 1);
+    Crypto::P256ECDHDerivedSecret sharedSecret;
+    sharedSecret.SetLength(sharedSecret.Capacity());
+    memset(sharedSecret.Bytes(), 0x42, sharedSecret.Length());
+
+    backend.mWriteCount = 0;
+    for (size_t i = 0; i < count; i++)
+    {
+        SessionResumptionStorage::ResumptionIdStorage resumptionId;
+        EXPECT_EQ(Crypto::DRBG_get_bytes(resumptionId.data(), resumptionId.size()), CHIP_NO_ERROR);
+        EXPECT_EQ(sessionStorage.Save(node, resumptionId, sharedSecret, CATValues()), CHIP_NO_ERROR);
+    }
+    return backend.mWriteCount;
+}
+
+TEST_F(TestCoalescingPersistentStorageDelegate, TestSessionResumptionWrites)
+{
+    constexpr size_t kSessionCount = 10;
+
+    CountingStorageDelegate directBackend;
+    const size_t directWrites = CountSessionResumptionWrites(directBackend, directBackend, kSessionCount);
+
+    CountingStorageDelegate backend;
+    CoalescingPersistentStorageDelegate storage(backend, GetSystemLayer(), kFlushInterval);
+    CountSessionResumptionWrites(storage, backend, kSessionCount);
+    EXPECT_EQ(storage.Flush(), CHIP_NO_ERROR);
+    const size_t coalescedWrites = backend.mWriteCount;
+
+    ChipLogProgress(Test, "Storage writes for %u CASE sessions: %u direct, %u coalesced", static_cast<unsigned>(kSessionCount),
+                    static_cast<unsigned>(directWrites), static_cast<unsigned>(coalescedWrites));
+    EXPECT_LT(coalescedWrites, directWrites);
+
+    // The coalesced writes leave the same resumption state behind.
+    const ScopedNodeId node(0x1122334455667788, 1);
+    SimpleSessionResumptionStorage sessionStorage;
+    SessionResumptionStorage::ResumptionIdStorage resumptionId;
+    Crypto::P256ECDHDerivedSecret sharedSecret;
+    CATValues peerCATs;
+    EXPECT_EQ(sessionStorage.Init(&backend), CHIP_NO_ERROR);
+    EXPECT_EQ(sessionStorage.FindByScopedNodeId(node, resumptionId, sharedSecret, peerCATs), CHIP_NO_ERROR);
+    EXPECT_EQ(backend.GetNumKeys(), directBackend.GetNumKeys());
+}
+
+#if CHIP_CONFIG_PERSIST_SUBSCRIPTIONS
+/// Saves the same subscription `count` times, as happens when its parameters are updated.
+size_t CountSubscriptionResumptionWrites(PersistentStorageDelegate & storage, CountingStorageDelegate & backend, size_t count)
+{
+    SimpleSubscriptionResumptionStorage subscriptionStorage;
+    EXPECT_EQ(subscriptionStorage.Init(&storage), CHIP_NO_ERROR);
+
+    backend.mWriteCount = 0;
+    for (size_t i = 0; i < count; i++)
+    {
+        SubscriptionResumptionStorage::SubscriptionInfo subscriptionInfo;
+        subscriptionInfo.mNodeId         = 0x1122334455667788;
+        subscriptionInfo.mFabricIndex    = 1;
+        subscriptionInfo.mSubscriptionId = 1;
+        subscriptionInfo.mMinInterval    = 1;
+        subscriptionInfo.mMaxInterval    = static_cast<uint16_t>(10 + i);
+        subscriptionInfo.mFabricFiltered = true;
+        EXPECT_EQ(subscriptionStorage.Save(subscriptionInfo), CHIP_NO_ERROR);
+    }
+    return backend.mWriteCount;
+}
+
+TEST_F(TestCoalescingPersistentStorageDelegate, TestSubscriptionResumptionWrites)
+{
+    constexpr size_t kSaveCount = 10;
+
+    CountingStorageDelegate directBackend;
+    const size_t directWrites = CountSubscriptionResumptionWrites(directBackend, directBackend, kSaveCount);
+
+    CountingStorageDelegate backend;
+    CoalescingPersistentStorageDelegate storage(backend, GetSystemLayer(), kFlushInterval);
+    CountSubscriptionResumptionWrites(storage, backend, kSaveCount);
+    EXPECT_EQ(storage.Flush(), CHIP_NO_ERROR);
+    const size_t coalescedWrites = backend.mWriteCount;
+
+    ChipLogProgress(Test, "Storage writes for %u subscription updates: %u direct, %u coalesced", static_cast<unsigned>(kSaveCount),
+                    static_cast<unsigned>(directWrites), static_cast<unsigned>(coalescedWrites));
+    EXPECT_LT(coalescedWrites, directWrites);
+}
+#endif // CHIP_CONFIG_PERSIST_SUBSCRIPTIONS
+
+} // namespace
@@ -0,0 +1,261 @@
+/*
+ *
+ *    Copyright (c) 2024 Project CHIP Authors
+ *
+ *    Licensed under the Apache License, Version 2.0 (the "License");
+ *    you may not use this file except in compliance with the License.
+ *    You may obtain a copy of the License at
+ *
+ *        http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *    Unless required by applicable law or agreed to in writing, software
+ *    distributed under the License is distributed on an "AS IS" BASIS,
+ *    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *    See the License for the specific language governing permissions and
+ *    limitations under the License.
+ */
+
+#include <app/clusters/door-lock-server/door-lock-credential-index.h>
+#include <lib/core/StringBuilderAdapters.h>
+#include <lib/support/CHIPMem.h>
+#include <pw_unit_test/framework.h>
+
+#include <cstring>
+
+namespace {
+
+using namespace chip;
+using namespace chip::app::Clusters::DoorLock;
+
+constexpr uint16_t kNumberOfUsers       = 2500;
+constexpr uint16_t kNumberOfPINs        = 5000;
+constexpr uint16_t kNumberOfRFIDs       = 100;
+constexpr uint16_t kPINDataLength       = 8;
+constexpr uint16_t kNumberOfCredentials = kNumberOfPINs + kNumberOfRFIDs;
+
+class TestDoorLockCredentialIndex : public ::testing::Test
+{
+public:
+    static void SetUpTestSuite() { ASSERT_EQ(chip::Platform::MemoryInit(), CHIP_NO_ERROR); }
+    static void TearDownTestSuite() { chip::Platform::MemoryShutdown(); }
+
+    void SetUp() override
+    {
+        uint16_t numberOfCredentials[CredentialIndex::kNumberOfCredentialTypes] = {};
+        numberOfCredentials[to_underlying(CredentialTypeEnum::kProgrammingPIN)] = 1;
+        numberOfCredentials[to_underlying(CredentialTypeEnum::kPin)]            = kNumberOfPINs;
+        numberOfCredentials[to_underlying(CredentialTypeEnum::kRfid)]           = kNumberOfRFIDs;
+        ASSERT_EQ(mIndex.Init(kNumberOfUsers, numberOfCredentials), CHIP_NO_ERROR);
+    }
+
+    void TearDown() override { mIndex.Clear(); }
+
+    // Distinct PIN data for each index, e.g. "00001234".
+    static ByteSpan PINData(uint16_t credentialIndex, uint8_t (&buffer)[kPINDataLength])
+    {
+        for (size_t i = kPINDataLength; i > 0; i--)
+        {
+            buffer[i - 1] = static_cast<uint8_t>('0' + credentialIndex % 10);
+            credentialIndex /= 10;
+        }
+        return ByteSpan(buffer);
+    }
+
+    // Returns the index of the unique candidate, or 0 if there is none.
+    uint16_t FindDuplicate(CredentialTypeEnum type, const ByteSpan & data)
+    {
+        size_t cursor          = 0;
+        uint16_t found         = 0;
+        uint16_t candidate     = 0;
+        size_t candidatesCount = 0;
+        while (mIndex.NextCandidate(type, data, cursor, candidate))
+        {
+            found = candidate;
+            candidatesCount++;
+        }
+        EXPECT_LE(candidatesCount, 1u);
+        return found;
+    }
+
+    CredentialIndex mIndex;
+};
+
+TEST_F(TestDoorLockCredentialIndex, TestInit)
+{
+    EXPECT_TRUE(mIndex.IsInitialized());
+    EXPECT_TRUE(mIndex.IsIndexed(CredentialTypeEnum::kPin));
+    EXPECT_TRUE(mIndex.IsIndexed(CredentialTypeEnum::kRfid));
+    EXPECT_FALSE(mIndex.IsIndexed(CredentialTypeEnum::kProgrammingPIN));
+    EXPECT_FALSE(mIndex.IsIndexed(CredentialTypeEnum::kFace));
+    EXPECT_FALSE(mIndex.IsIndexed(CredentialTypeEnum::kUnknownEnumValue));
+
+    uint16_t index = 0;
+    EXPECT_TRUE(mIndex.FindUser(1, false, index));
+    EXPECT_EQ(index, 1u);
+    EXPECT_FALSE(mIndex.FindUser(1, true, index));
+    EXPECT_TRUE(mIndex.FindCredential(CredentialTypeEnum::kRfid, 1, false, index));
+    EXPECT_EQ(index, 1u);
+    EXPECT_FALSE(mIndex.FindCredential(CredentialTypeEnum::kRfid, 1, true, index));
+    EXPECT_EQ(mIndex.CountOccupiedCredentials(CredentialTypeEnum::kPin), 0u);
+
+    uint16_t tooManyCredentials[CredentialIndex::kNumberOfCredentialTypes] = {};
+    tooManyCredentials[to_underlying(CredentialTypeEnum::kPin)]            = UINT16_MAX;
+    tooManyCredentials[to_underlying(CredentialTypeEnum::kRfid)]           = 1;
+    EXPECT_EQ(mIndex.Init(kNumberOfUsers, tooManyCredentials), CHIP_ERROR_INVALID_ARGUMENT);
+    EXPECT_FALSE(mIndex.IsInitialized());
+    EXPECT_FALSE(mIndex.IsIndexed(CredentialTypeEnum::kPin));
+
+    mIndex.Clear();
+    EXPECT_FALSE(mIndex.FindUser(1, false, index));
+}
+
+TEST_F(TestDoorLockCredentialIndex, TestUsers)
+{
+    mIndex.SetUserOccupied(1, true);
+    mIndex.SetUserOccupied(2, true);
+    mIndex.SetUserOccupied(40, true);
+    mIndex.SetUserOccupied(0, true);
+    mIndex.SetUserOccupied(kNumberOfUsers + 1, true);
+
+    uint16_t index = 0;
+    EXPECT_TRUE(mIndex.FindUser(1, false, index));
+    EXPECT_EQ(index, 3u);
+    EXPECT_TRUE(mIndex.FindUser(3, true, index));
+    EXPECT_EQ(index, 40u);
+    EXPECT_FALSE(mIndex.FindUser(41, true, index));
+    EXPECT_FALSE(mIndex.FindUser(0, false, index));
+    EXPECT_FALSE(mIndex.FindUser(kNumberOfUsers + 1, false, index));
+
+    mIndex.SetUserOccupied(1, false);
+    EXPECT_TRUE(mIndex.FindUser(1, false, index));
+    EXPECT_EQ(index, 1u);
+
+    // Fill up all users but the last one.
+    for (uint16_t i = 1; i < kNumberOfUsers; i++)
+    {
+        mIndex.SetUserOccupied(i, true);
+    }
+    EXPECT_TRUE(mIndex.FindUser(1, false, index));
+    EXPECT_EQ(index, kNumberOfUsers);
+    mIndex.SetUserOccupied(kNumberOfUsers, true);
+    EXPECT_FALSE(mIndex.FindUser(1, false, index));
+}
+
+TEST_F(TestDoorLockCredentialIndex, TestCredentials)
+{
+    const uint8_t pin[]  = { '1', '2', '3', '4' };
+    const uint8_t pin2[] = { '4', '3', '2', '1' };
+
+    mIndex.SetCredential(CredentialTypeEnum::kPin, 2, ByteSpan(pin));
+    mIndex.SetCredentialUser(CredentialTypeEnum::kPin, 2, 7);
+    EXPECT_EQ(mIndex.CountOccupiedCredentials(CredentialTypeEnum::kPin), 1u);
+    EXPECT_EQ(mIndex.GetCredentialUser(CredentialTypeEnum::kPin, 2), 7u);
+
+    // The same data of another type is not a duplicate.
+    EXPECT_EQ(FindDuplicate(CredentialTypeEnum::kPin, ByteSpan(pin)), 2u);
+    EXPECT_EQ(FindDuplicate(CredentialTypeEnum::kRfid, ByteSpan(pin)), 0u);
+    EXPECT_EQ(FindDuplicate(CredentialTypeEnum::kPin, ByteSpan(pin2)), 0u);
+
+    uint16_t index = 0;
+    EXPECT_TRUE(mIndex.FindCredential(CredentialTypeEnum::kPin, 1, false, index));
+    EXPECT_EQ(index, 1u);
+    EXPECT_TRUE(mIndex.FindCredential(CredentialTypeEnum::kPin, 2, false, index));
+    EXPECT_EQ(index, 3u);
+    EXPECT_TRUE(mIndex.FindCredential(CredentialTypeEnum::kPin, 1, true, index));
+    EXPECT_EQ(index, 2u);
+
+    // Modifying the data replaces the previous one.
+    mIndex.SetCredential(CredentialTypeEnum::kPin, 2, ByteSpan(pin2));
+    EXPECT_EQ(mIndex.CountOccupiedCredentials(CredentialTypeEnum::kPin), 1u);
+    EXPECT_EQ(FindDuplicate(CredentialTypeEnum::kPin, ByteSpan(pin)), 0u);
+    EXPECT_EQ(FindDuplicate(CredentialTypeEnum::kPin, ByteSpan(pin2)), 2u);
+
+    mIndex.ClearCredential(CredentialTypeEnum::kPin, 2);
+    EXPECT_EQ(mIndex.CountOccupiedCredentials(CredentialTypeEnum::kPin), 0u);
+    EXPECT_EQ(mIndex.GetCredentialUser(CredentialTypeEnum::kPin, 2), 0u);
+    EXPECT_EQ(FindDuplicate(CredentialTypeEnum::kPin, ByteSpan(pin2)), 0u);
+    EXPECT_FALSE(mIndex.FindCredential(CredentialTypeEnum::kPin, 1, true, index));
+
+    // Clearing an available credential does nothing.
+    mIndex.ClearCredential(CredentialTypeEnum::kPin, 2);
+    EXPECT_EQ(mIndex.CountOccupiedCredentials(CredentialTypeEnum::kPin), 0u);
+
+    // Out of range and unindexed credentials are ignored.
+    mIndex.SetCredential(CredentialTypeEnum::kPin, 0, ByteSpan(pin));
+    mIndex.SetCredential(CredentialTypeEnum::kPin, kNumberOfPINs + 1, ByteSpan(pin));
+    mIndex.SetCredential(CredentialTypeEnum::kProgrammingPIN, 0, ByteSpan(pin));
+    mIndex.SetCredential(CredentialTypeEnum::kFace, 1, ByteSpan(pin));
+    EXPECT_EQ(mIndex.CountOccupiedCredentials(CredentialTypeEnum::kPin), 0u);
+    EXPECT_EQ(FindDuplicate(CredentialTypeEnum::kPin, ByteSpan(pin)), 0u);
+    EXPECT_FALSE(mIndex.FindCredential(CredentialTypeEnum::kFace, 1, false, index));
+
+    // The last slot of a type does not spill into the next type.
+    mIndex.SetCredential(CredentialTypeEnum::kRfid, 1, ByteSpan(pin));
+    for (uint16_t i = 1; i < kNumberOfPINs; i++)
+    {
+        mIndex.SetCredential(CredentialTypeEnum::kPin, i, ByteSpan(pin));
+    }
+    EXPECT_TRUE(mIndex.FindCredential(CredentialTypeEnum::kPin, 1, false, index));
+    EXPECT_EQ(index, kNumberOfPINs);
+    mIndex.SetCredential(CredentialTypeEnum::kPin, kNumberOfPINs, ByteSpan(pin));
+    EXPECT_FALSE(mIndex.FindCredential(CredentialTypeEnum::kPin, 1, false, index));
+    EXPECT_TRUE(mIndex.FindCredential(CredentialTypeEnum::kRfid, 1, false, index));
+    EXPECT_EQ(index, 2u);
+}
+
+TEST_F(TestDoorLockCredentialIndex, TestManyCredentials)
+{
+    uint8_t buffer[kPINDataLength];
+
+    // Provision a full PIN database, as a bulk provisioning would, checking for duplicates before each addition.
+    for (uint16_t i = 1; i <= kNumberOfPINs; i++)
+    {
+        ByteSpan data = PINData(i, buffer);
+        ASSERT_EQ(FindDuplicate(CredentialTypeEnum::kPin, data), 0u);
+
+        uint16_t freeIndex = 0;
+        ASSERT_TRUE(mIndex.FindCredential(CredentialTypeEnum::kPin, 1, false, freeIndex));
+        ASSERT_EQ(freeIndex, i);
+
+        mIndex.SetCredential(CredentialTypeEnum::kPin, freeIndex, data);
+        mIndex.SetCredentialUser(CredentialTypeEnum::kPin, freeIndex, static_cast<uint16_t>((i + 1) / 2));
+    }
+    EXPECT_EQ(mIndex.CountOccupiedCredentials(CredentialTypeEnum::kPin), kNumberOfPINs);
+
+    for (uint16_t i = 1; i <= kNumberOfPINs; i++)
+    {
+        EXPECT_EQ(FindDuplicate(CredentialTypeEnum::kPin, PINData(i, buffer)), i);
+        EXPECT_EQ(mIndex.GetCredentialUser(CredentialTypeEnum::kPin, i), (i + 1) / 2);
+    }
+
+    // Remove every other credential, which exercises the removal from the middle of probe sequences.
+    for (uint16_t i = 1; i <= kNumberOfPINs; i += 2)
+    {
+        mIndex.ClearCredential(CredentialTypeEnum::kPin, i);
+    }
+    EXPECT_EQ(mIndex.CountOccupiedCredentials(CredentialTypeEnum::kPin), kNumberOfPINs / 2);
+
+    for (uint16_t i = 1; i <= kNumberOfPINs; i++)
+    {
+        bool removed = (i % 2) == 1;
+        EXPECT_EQ(FindDuplicate(CredentialTypeEnum::kPin, PINData(i, buffer)), removed ? 0u : i);
+    }
+
+    uint16_t index = 0;
+    EXPECT_TRUE(mIndex.FindCredential(CredentialTypeEnum::kPin, 2, false, index));
+    EXPECT_EQ(index, 3u);
+    EXPECT_TRUE(mIndex.FindCredential(CredentialTypeEnum::kPin, 3, true, index));
+    EXPECT_EQ(index, 4u);
+
+    // Removed slots can be reused with other data.
+    for (uint16_t i = 1; i <= kNumberOfPINs; i += 2)
+    {
+        mIndex.SetCredential(CredentialTypeEnum::kPin, i, PINData(static_cast<uint16_t>(kNumberOfCredentials + i), buffer));
+    }
+    EXPECT_EQ(mIndex.CountOccupiedCredentials(CredentialTypeEnum::kPin), kNumberOfPINs);
+    EXPECT_EQ(FindDuplicate(CredentialTypeEnum::kPin, PINData(1, buffer)), 0u);
+    EXPECT_EQ(FindDuplicate(CredentialTypeEnum::kPin, PINData(kNumberOfCredentials + 1, buffer)), 1u);
+    EXPECT_EQ(FindDuplicate(CredentialTypeEnum::kPin, PINData(2, buffer)), 2u);
+}
+
+} // namespace
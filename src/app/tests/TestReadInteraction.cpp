@@ -1839,16 +1839,30 @@ TEST_F_FROM_FIXTURE(TestReadInteraction, TestSubscribeRoundtrip)
         delegate.mGotEventResponse     = false;
         delegate.mNumAttributeResponse = 0;
 
+#if CHIP_CONFIG_IM_REPORTING_STATISTICS
+        const uint32_t reportLatencySamples = engine->GetReportingStatistics().reportLatencySamples;
+#endif
+
         EXPECT_EQ(engine->GetReportingEngine().SetDirty(dirtyPath1), CHIP_NO_ERROR);
 
         EXPECT_EQ(engine->GetReportingEngine().SetDirty(dirtyPath2), CHIP_NO_ERROR);
 
+#if CHIP_CONFIG_IM_REPORTING_STATISTICS
+        // The report latency is measured from the first change
+        gMockClock.AdvanceMonotonic(System::Clock::Milliseconds32(100));
+#endif
+
         DrainAndServiceIO();
 
         EXPECT_TRUE(delegate.mGotReport);
         EXPECT_TRUE(delegate.mGotEventResponse);
         EXPECT_EQ(delegate.mNumAttributeResponse, 2);
 
+#if CHIP_CONFIG_IM_REPORTING_STATISTICS
+        EXPECT_EQ(engine->GetReportingStatistics().reportLatencySamples, reportLatencySamples + 1);
+        EXPECT_GE(engine->GetReportingStatistics().maxReportLatency, System::Clock::Milliseconds32(100));
+#endif
+
         // Test report with 2 different path, and 1 same path
         // Advance monotonic timestamp for min interval to elapse
         gMockClock.AdvanceMonotonic(System::Clock::Seconds16(readPrepareParams.mMinIntervalFloorSeconds));
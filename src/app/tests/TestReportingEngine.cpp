@@ -192,6 +192,17 @@ TEST_F_FROM_FIXTURE(TestReportingEngine, TestBuildAndSendSingleReportData)
     EXPECT_EQ(InteractionModelEngine::GetInstance()->GetReportingEngine().BuildAndSendSingleReportData(&readHandler),
               CHIP_NO_ERROR);
 
+#if CHIP_CONFIG_IM_REPORTING_STATISTICS
+    const ReportingStatistics statistics = InteractionModelEngine::GetInstance()->GetReportingStatistics();
+    EXPECT_EQ(statistics.readHandlersServiced, 1u);
+    EXPECT_EQ(statistics.reportsSent, 1u);
+    EXPECT_EQ(statistics.chunkedReports, 0u);
+    EXPECT_EQ(statistics.reportFailures, 0u);
+    EXPECT_GT(statistics.bytesEncoded, 0u);
+    // Not a subscription report
+    EXPECT_EQ(statistics.reportLatencySamples, 0u);
+#endif // CHIP_CONFIG_IM_REPORTING_STATISTICS
+
     DrainAndServiceIO();
 }
 
@@ -325,6 +336,20 @@ TEST_F_FROM_FIXTURE(TestReportingEngine, TestMergeAttributePathWhenDirtySetPoolE
     EXPECT_TRUE(VerifyDirtySetContent(AttributePathParams(kTestEndpointId, kInvalidClusterId),
                                       AttributePathParams(kTestEndpointId + 1, kTestClusterId + 1, 1)));
 
+#if CHIP_CONFIG_IM_REPORTING_STATISTICS
+    // Every insertion above found the dirty set full
+    const ReportingStatistics & statistics = InteractionModelEngine::GetInstance()->GetReportingEngine().GetStatistics();
+    EXPECT_EQ(statistics.dirtySetInsertions, 5u);
+    EXPECT_EQ(statistics.dirtySetOverflows, 5u);
+
+    // Merging into an existing path is not an overflow
+    EXPECT_EQ(CHIP_NO_ERROR,
+              InteractionModelEngine::GetInstance()->GetReportingEngine().InsertPathIntoDirtySet(
+                  AttributePathParams(kTestEndpointId, kTestClusterId, 1)));
+    EXPECT_EQ(statistics.dirtySetInsertions, 6u);
+    EXPECT_EQ(statistics.dirtySetOverflows, 5u);
+#endif // CHIP_CONFIG_IM_REPORTING_STATISTICS
+
     InteractionModelEngine::GetInstance()->GetReportingEngine().Shutdown();
 }
 
@@ -403,8 +403,9 @@ public:
 class TestSceneTableImpl : public SceneTableImpl
 {
 public:
-    TestSceneTableImpl(uint16_t maxScenesPerFabric = defaultTestFabricCapacity, uint16_t maxScenesGlobal = defaultTestTableSize) :
-        SceneTableImpl(maxScenesPerFabric, maxScenesGlobal)
+    TestSceneTableImpl(uint16_t maxScenesPerFabric = defaultTestFabricCapacity, uint16_t maxScenesGlobal = defaultTestTableSize,
+                       Span<scenes::SceneCache::Entry> sceneCacheEntries = Span<scenes::SceneCache::Entry>()) :
+        SceneTableImpl(maxScenesPerFabric, maxScenesGlobal, sceneCacheEntries)
     {}
     ~TestSceneTableImpl() override {}
 
@@ -425,6 +426,20 @@ protected:
     uint8_t GetClusterCountFromEndpoint() override { return 3; }
 };
 
+/// @brief Storage counting the reads, to verify which scene table operations are served from the scene cache
+class CountingStorageDelegate : public chip::TestPersistentStorageDelegate
+{
+public:
+    size_t mReadCount = 0;
+
+protected:
+    CHIP_ERROR SyncGetKeyValueInternal(const char * key, void * buffer, uint16_t & size) override
+    {
+        mReadCount++;
+        return chip::TestPersistentStorageDelegate::SyncGetKeyValueInternal(key, buffer, size);
+    }
+};
+
 // Test Fixture Class
 class TestSceneTable : public ::testing::Test
 {
@@ -1771,4 +1786,75 @@ TEST_F(TestSceneTable, TestOTAChanges)
     EXPECT_EQ(1, fabric_capacity);
 }
 
+TEST_F(TestSceneTable, TestSceneCache)
+{
+    constexpr EndpointId kEndpointCount = 64;
+
+    CountingStorageDelegate storage;
+    scenes::SceneCache::Entry cacheEntries[kEndpointCount];
+    TestSceneTableImpl sceneTable(defaultTestFabricCapacity, defaultTestTableSize, Span<scenes::SceneCache::Entry>(cacheEntries));
+    ASSERT_EQ(CHIP_NO_ERROR, sceneTable.Init(&storage));
+
+    SceneTableEntry scene;
+
+    // Store a scene on every endpoint, which also caches it
+    for (EndpointId endpoint = 1; endpoint <= kEndpointCount; endpoint++)
+    {
+        sceneTable.SetEndpoint(endpoint);
+        EXPECT_EQ(CHIP_NO_ERROR, sceneTable.SetSceneTableEntry(kFabric1, scene1));
+    }
+
+    // Recalling the scenes on every endpoint does not read the storage
+    storage.mReadCount = 0;
+    for (EndpointId endpoint = 1; endpoint <= kEndpointCount; endpoint++)
+    {
+        sceneTable.SetEndpoint(endpoint);
+        EXPECT_EQ(CHIP_NO_ERROR, sceneTable.GetSceneTableEntry(kFabric1, sceneId1, scene));
+        EXPECT_EQ(scene, scene1);
+    }
+    EXPECT_EQ(0u, storage.mReadCount);
+
+    // A scene that does not fit in the cache evicts the least recently used one, which is then read from storage again
+    sceneTable.SetEndpoint(kEndpointCount);
+    EXPECT_EQ(CHIP_NO_ERROR, sceneTable.SetSceneTableEntry(kFabric1, scene2));
+    sceneTable.SetEndpoint(1);
+    storage.mReadCount = 0;
+    EXPECT_EQ(CHIP_NO_ERROR, sceneTable.GetSceneTableEntry(kFabric1, sceneId1, scene));
+    EXPECT_EQ(scene, scene1);
+    EXPECT_NE(0u, storage.mReadCount);
+    storage.mReadCount = 0;
+    EXPECT_EQ(CHIP_NO_ERROR, sceneTable.GetSceneTableEntry(kFabric1, sceneId1, scene));
+    EXPECT_EQ(0u, storage.mReadCount);
+
+    // Overwriting a scene updates the cache
+    EXPECT_EQ(CHIP_NO_ERROR, sceneTable.SetSceneTableEntry(kFabric1, scene10));
+    EXPECT_EQ(CHIP_NO_ERROR, sceneTable.GetSceneTableEntry(kFabric1, sceneId1, scene));
+    EXPECT_EQ(scene, scene10);
+
+    // A failed write leaves no stale scene in the cache
+    storage.SetRejectWrites(true);
+    EXPECT_NE(CHIP_NO_ERROR, sceneTable.SetSceneTableEntry(kFabric1, scene1));
+    storage.SetRejectWrites(false);
+    EXPECT_EQ(CHIP_NO_ERROR, sceneTable.GetSceneTableEntry(kFabric1, sceneId1, scene));
+    EXPECT_EQ(scene, scene10);
+
+    // Removed scenes are no longer returned
+    EXPECT_EQ(CHIP_NO_ERROR, sceneTable.RemoveSceneTableEntry(kFabric1, sceneId1));
+    EXPECT_EQ(CHIP_ERROR_NOT_FOUND, sceneTable.GetSceneTableEntry(kFabric1, sceneId1, scene));
+
+    sceneTable.SetEndpoint(2);
+    EXPECT_EQ(CHIP_NO_ERROR, sceneTable.DeleteAllScenesInGroup(kFabric1, kGroup1));
+    EXPECT_EQ(CHIP_ERROR_NOT_FOUND, sceneTable.GetSceneTableEntry(kFabric1, sceneId1, scene));
+
+    sceneTable.SetEndpoint(3);
+    EXPECT_EQ(CHIP_NO_ERROR, sceneTable.RemoveEndpoint());
+    EXPECT_EQ(CHIP_ERROR_NOT_FOUND, sceneTable.GetSceneTableEntry(kFabric1, sceneId1, scene));
+
+    sceneTable.SetEndpoint(4);
+    EXPECT_EQ(CHIP_NO_ERROR, sceneTable.RemoveSceneTableEntryAtPosition(4, kFabric1, 0));
+    EXPECT_EQ(CHIP_ERROR_NOT_FOUND, sceneTable.GetSceneTableEntry(kFabric1, sceneId1, scene));
+
+    sceneTable.Finish();
+}
+
 } // namespace TestScenes
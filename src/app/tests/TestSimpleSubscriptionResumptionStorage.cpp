@@ -19,7 +19,9 @@
 #include <lib/core/StringBuilderAdapters.h>
 #include <lib/support/DefaultStorageKeyAllocator.h>
 #include <lib/support/TestPersistentStorageDelegate.h>
+#include <lib/support/logging/CHIPLogging.h>
 #include <pw_unit_test/framework.h>
+#include <system/SystemClock.h>
 
 class TestSimpleSubscriptionResumptionStorage : public ::testing::Test
 {
@@ -31,14 +33,72 @@ public:
 class SimpleSubscriptionResumptionStorageTest : public chip::app::SimpleSubscriptionResumptionStorage
 {
 public:
-    CHIP_ERROR TestSave(chip::TLV::TLVWriter & writer,
-                        chip::app::SubscriptionResumptionStorage::SubscriptionInfo & subscriptionInfo)
+    CHIP_ERROR TestSaveLegacy(chip::TLV::TLVWriter & writer,
+                              chip::app::SubscriptionResumptionStorage::SubscriptionInfo & subscriptionInfo)
     {
-        return Save(writer, subscriptionInfo);
+        return SaveLegacy(writer, subscriptionInfo);
     }
     static constexpr size_t TestMaxSubscriptionSize() { return MaxSubscriptionSize(); }
+    static constexpr size_t kTestShardHeaderSize = kShardHeaderSize;
 };
 
+namespace {
+
+class CountingStorageDelegate : public chip::TestPersistentStorageDelegate
+{
+public:
+    CHIP_ERROR SyncGetKeyValue(const char * key, void * buffer, uint16_t & size) override
+    {
+        mReadCount++;
+        return TestPersistentStorageDelegate::SyncGetKeyValue(key, buffer, size);
+    }
+    CHIP_ERROR SyncSetKeyValue(const char * key, const void * value, uint16_t size) override
+    {
+        mWriteCount++;
+        return TestPersistentStorageDelegate::SyncSetKeyValue(key, value, size);
+    }
+
+    size_t mReadCount  = 0;
+    size_t mWriteCount = 0;
+};
+
+// Persisted by older releases before the subscription resumption table.
+void SaveLegacyMaxCount(chip::TestPersistentStorageDelegate & storage)
+{
+    uint16_t countMax = CHIP_IM_MAX_NUM_SUBSCRIPTIONS;
+    EXPECT_EQ(storage.SyncSetKeyValue(chip::DefaultStorageKeyAllocator::SubscriptionResumptionMaxCount().KeyName(), &countMax,
+                                      sizeof(countMax)),
+              CHIP_NO_ERROR);
+}
+
+// Total size of the shards of the table, checking that each fits in the configured shard size.
+uint16_t GetTableSize(chip::TestPersistentStorageDelegate & storage, size_t * shardCount = nullptr)
+{
+    uint8_t buffer[SimpleSubscriptionResumptionStorageTest::kShardSize];
+    size_t shardIndex = 0;
+    uint16_t total    = 0;
+    for (;; shardIndex++)
+    {
+        const chip::StorageKeyName key = chip::DefaultStorageKeyAllocator::SubscriptionResumptionTable(shardIndex);
+        uint16_t size                  = sizeof(buffer);
+        CHIP_ERROR err                 = storage.SyncGetKeyValue(key.KeyName(), buffer, size);
+        if (err == CHIP_ERROR_PERSISTED_STORAGE_VALUE_NOT_FOUND)
+        {
+            break;
+        }
+        EXPECT_EQ(err, CHIP_NO_ERROR);
+        EXPECT_LE(size, SimpleSubscriptionResumptionStorageTest::kShardSize);
+        total = static_cast<uint16_t>(total + size);
+    }
+    if (shardCount != nullptr)
+    {
+        *shardCount = shardIndex;
+    }
+    return total;
+}
+
+} // namespace
+
 struct TestSubscriptionInfo : public chip::app::SubscriptionResumptionStorage::SubscriptionInfo
 {
     bool operator==(const SubscriptionInfo & that) const
@@ -121,7 +181,7 @@ TEST_F(TestSimpleSubscriptionResumptionStorage, TestSubscriptionCount)
 
 TEST_F(TestSimpleSubscriptionResumptionStorage, TestSubscriptionMaxCount)
 {
-    // Force large MacCount value and check that Init resets it properly, and deletes extra subs:
+    // Force large MacCount value of the legacy format and check that Init removes it, and deletes extra subs:
 
     chip::TestPersistentStorageDelegate storage;
     SimpleSubscriptionResumptionStorageTest subscriptionStorage;
@@ -143,16 +203,16 @@ TEST_F(TestSimpleSubscriptionResumptionStorage, TestSubscriptionMaxCount)
 
     subscriptionStorage.Init(&storage);
 
-    // First check the MaxCount is reset to CHIP_IM_MAX_NUM_SUBSCRIPTIONS
+    // First check the MaxCount is removed
     uint16_t countMax = 0;
     uint16_t len      = sizeof(countMax);
     EXPECT_EQ(storage.SyncGetKeyValue(chip::DefaultStorageKeyAllocator::SubscriptionResumptionMaxCount().KeyName(), &countMax, len),
-              CHIP_NO_ERROR);
-    EXPECT_EQ(countMax, CHIP_IM_MAX_NUM_SUBSCRIPTIONS);
+              CHIP_ERROR_PERSISTED_STORAGE_VALUE_NOT_FOUND);
 
     // Then check the fake sub is no more
     EXPECT_FALSE(storage.SyncDoesKeyExist(
         chip::DefaultStorageKeyAllocator::SubscriptionResumption(CHIP_IM_MAX_NUM_SUBSCRIPTIONS + 1).KeyName()));
+    EXPECT_EQ(storage.GetNumKeys(), 0u);
 }
 
 TEST_F(TestSimpleSubscriptionResumptionStorage, TestSubscriptionState)
@@ -271,9 +331,8 @@ TEST_F(TestSimpleSubscriptionResumptionStorage, TestSubscriptionStateUnexpectedF
 {
     chip::TestPersistentStorageDelegate storage;
     SimpleSubscriptionResumptionStorageTest subscriptionStorage;
-    subscriptionStorage.Init(&storage);
 
-    // Write additional entries at the end of TLV and see it still loads correctly
+    // Write additional entries at the end of legacy TLV and see it still migrates correctly
     chip::app::SubscriptionResumptionStorage::SubscriptionInfo subscriptionInfo1 = {
         .mNodeId         = 4444,
         .mFabricIndex    = 44,
@@ -295,7 +354,7 @@ TEST_F(TestSimpleSubscriptionResumptionStorage, TestSubscriptionStateUnexpectedF
     ASSERT_NE(backingBuffer.Get(), nullptr);
     chip::TLV::ScopedBufferTLVWriter writer(std::move(backingBuffer), subscriptionStorage.TestMaxSubscriptionSize());
 
-    EXPECT_EQ(subscriptionStorage.TestSave(writer, subscriptionInfo1), CHIP_NO_ERROR);
+    EXPECT_EQ(subscriptionStorage.TestSaveLegacy(writer, subscriptionInfo1), CHIP_NO_ERROR);
 
     // Additional stuff
     chip::TLV::TLVType containerType;
@@ -313,6 +372,11 @@ TEST_F(TestSimpleSubscriptionResumptionStorage, TestSubscriptionStateUnexpectedF
     EXPECT_EQ(storage.SyncSetKeyValue(chip::DefaultStorageKeyAllocator::SubscriptionResumption(0).KeyName(), backingBuffer.Get(),
                                       static_cast<uint16_t>(len)),
               CHIP_NO_ERROR);
+    SaveLegacyMaxCount(storage);
+
+    EXPECT_EQ(subscriptionStorage.Init(&storage), CHIP_NO_ERROR);
+    EXPECT_FALSE(storage.SyncDoesKeyExist(chip::DefaultStorageKeyAllocator::SubscriptionResumption(0).KeyName()));
+    EXPECT_FALSE(storage.SyncDoesKeyExist(chip::DefaultStorageKeyAllocator::SubscriptionResumptionMaxCount().KeyName()));
 
     // Now read back and verify
     auto * iterator = subscriptionStorage.IterateSubscriptions();
@@ -327,9 +391,8 @@ TEST_F(TestSimpleSubscriptionResumptionStorage, TestSubscriptionStateTooBigToLoa
 {
     chip::TestPersistentStorageDelegate storage;
     SimpleSubscriptionResumptionStorageTest subscriptionStorage;
-    subscriptionStorage.Init(&storage);
 
-    // Write additional too-big data at the end of TLV and see it fails to loads and entry deleted
+    // Write additional too-big data at the end of legacy TLV and see it fails to migrate and entry deleted
     chip::app::SubscriptionResumptionStorage::SubscriptionInfo subscriptionInfo1 = {
         .mNodeId         = 5555,
         .mFabricIndex    = 45,
@@ -351,7 +414,7 @@ TEST_F(TestSimpleSubscriptionResumptionStorage, TestSubscriptionStateTooBigToLoa
     ASSERT_NE(backingBuffer.Get(), nullptr);
     chip::TLV::ScopedBufferTLVWriter writer(std::move(backingBuffer), subscriptionStorage.TestMaxSubscriptionSize() * 2);
 
-    EXPECT_EQ(subscriptionStorage.TestSave(writer, subscriptionInfo1), CHIP_NO_ERROR);
+    EXPECT_EQ(subscriptionStorage.TestSaveLegacy(writer, subscriptionInfo1), CHIP_NO_ERROR);
 
     // Additional too-many bytes
     chip::TLV::TLVType containerType;
@@ -372,13 +435,16 @@ TEST_F(TestSimpleSubscriptionResumptionStorage, TestSubscriptionStateTooBigToLoa
     EXPECT_EQ(storage.SyncSetKeyValue(chip::DefaultStorageKeyAllocator::SubscriptionResumption(0).KeyName(), backingBuffer.Get(),
                                       static_cast<uint16_t>(len)),
               CHIP_NO_ERROR);
+    SaveLegacyMaxCount(storage);
+
+    EXPECT_EQ(subscriptionStorage.Init(&storage), CHIP_NO_ERROR);
+    EXPECT_FALSE(storage.SyncDoesKeyExist(chip::DefaultStorageKeyAllocator::SubscriptionResumption(0).KeyName()));
 
     // Now read back and verify
     auto * iterator = subscriptionStorage.IterateSubscriptions();
-    EXPECT_EQ(iterator->Count(), 1u);
+    EXPECT_EQ(iterator->Count(), 0u);
     TestSubscriptionInfo subscriptionInfo;
     EXPECT_FALSE(iterator->Next(subscriptionInfo));
-    EXPECT_EQ(iterator->Count(), 0u);
     iterator->Release();
 }
 
@@ -386,7 +452,6 @@ TEST_F(TestSimpleSubscriptionResumptionStorage, TestSubscriptionStateJunkData)
 {
     chip::TestPersistentStorageDelegate storage;
     SimpleSubscriptionResumptionStorageTest subscriptionStorage;
-    subscriptionStorage.Init(&storage);
 
     chip::Platform::ScopedMemoryBuffer<uint8_t> junkBytes;
     junkBytes.Calloc(subscriptionStorage.TestMaxSubscriptionSize() / 2);
@@ -394,12 +459,369 @@ TEST_F(TestSimpleSubscriptionResumptionStorage, TestSubscriptionStateJunkData)
     EXPECT_EQ(storage.SyncSetKeyValue(chip::DefaultStorageKeyAllocator::SubscriptionResumption(0).KeyName(), junkBytes.Get(),
                                       static_cast<uint16_t>(subscriptionStorage.TestMaxSubscriptionSize() / 2)),
               CHIP_NO_ERROR);
+    SaveLegacyMaxCount(storage);
+
+    EXPECT_EQ(subscriptionStorage.Init(&storage), CHIP_NO_ERROR);
+    EXPECT_EQ(storage.GetNumKeys(), 0u);
 
     // Now read back and verify
     auto * iterator = subscriptionStorage.IterateSubscriptions();
-    EXPECT_EQ(iterator->Count(), 1u);
+    EXPECT_EQ(iterator->Count(), 0u);
     TestSubscriptionInfo subscriptionInfo;
     EXPECT_FALSE(iterator->Next(subscriptionInfo));
+    iterator->Release();
+}
+
+TEST_F(TestSimpleSubscriptionResumptionStorage, TestSubscriptionPaths)
+{
+    chip::TestPersistentStorageDelegate storage;
+    SimpleSubscriptionResumptionStorageTest subscriptionStorage;
+    EXPECT_EQ(subscriptionStorage.Init(&storage), CHIP_NO_ERROR);
+
+    // Wildcards, repeated endpoints and clusters, and IDs going up and down within a cluster
+    chip::app::SubscriptionResumptionStorage::SubscriptionInfo subscriptionInfo1 = {
+        .mNodeId         = 0xFFFFFFFFFFFFFFF0,
+        .mFabricIndex    = 0xFE,
+        .mSubscriptionId = 0xFFFFFFFF,
+        .mMinInterval    = 0,
+        .mMaxInterval    = 0xFFFF,
+        .mFabricFiltered = true,
+    };
+    const chip::app::SubscriptionResumptionStorage::AttributePathParamsValues attributePaths[] = {
+        { 0x0006, 0x0000, 1 },
+        { 0x0006, 0x4003, 1 },
+        { 0x0006, 0x0002, 1 },
+        { 0x0008, chip::kInvalidAttributeId, 1 },
+        { 0x0008, 0xFFFFFFFE, 1 },
+        { chip::kInvalidClusterId, 0x0000, chip::kInvalidEndpointId },
+        { 0xFFF1FC01, 0x00000000, 0xFFFE },
+        { 0xFFF1FC01, 0xFFF1FFFF, 0xFFFE },
+    };
+    subscriptionInfo1.mAttributePaths.Calloc(ArraySize(attributePaths));
+    ASSERT_NE(subscriptionInfo1.mAttributePaths.Get(), nullptr);
+    memcpy(subscriptionInfo1.mAttributePaths.Get(), attributePaths, sizeof(attributePaths));
+
+    const chip::app::SubscriptionResumptionStorage::EventPathParamsValues eventPaths[] = {
+        { 0x0028, 0x00, 0, true },
+        { 0x0028, 0x01, 0, false },
+        { chip::kInvalidClusterId, chip::kInvalidEventId, chip::kInvalidEndpointId, true },
+    };
+    subscriptionInfo1.mEventPaths.Calloc(ArraySize(eventPaths));
+    ASSERT_NE(subscriptionInfo1.mEventPaths.Get(), nullptr);
+    memcpy(subscriptionInfo1.mEventPaths.Get(), eventPaths, sizeof(eventPaths));
+
+    // A second subscription with fewer paths, to check the paths buffers are resized when iterating
+    chip::app::SubscriptionResumptionStorage::SubscriptionInfo subscriptionInfo2 = {
+        .mNodeId         = 1,
+        .mFabricIndex    = 1,
+        .mSubscriptionId = 1,
+        .mMinInterval    = 1,
+        .mMaxInterval    = 60,
+        .mFabricFiltered = false,
+    };
+    subscriptionInfo2.mAttributePaths.Calloc(1);
+    ASSERT_NE(subscriptionInfo2.mAttributePaths.Get(), nullptr);
+    subscriptionInfo2.mAttributePaths[0] = attributePaths[0];
+
+    EXPECT_EQ(subscriptionStorage.Save(subscriptionInfo1), CHIP_NO_ERROR);
+    EXPECT_EQ(subscriptionStorage.Save(subscriptionInfo2), CHIP_NO_ERROR);
+
+    auto * iterator = subscriptionStorage.IterateSubscriptions();
+    EXPECT_EQ(iterator->Count(), 2u);
+    TestSubscriptionInfo subscriptionInfo;
+    EXPECT_TRUE(iterator->Next(subscriptionInfo));
+    EXPECT_EQ(subscriptionInfo, subscriptionInfo1);
+    EXPECT_TRUE(iterator->Next(subscriptionInfo));
+    EXPECT_EQ(subscriptionInfo, subscriptionInfo2);
+    EXPECT_FALSE(iterator->Next(subscriptionInfo));
+    iterator->Release();
+
+    // The table is smaller than the legacy TLV encoding of the same subscriptions
+    size_t legacySize = 0;
+    for (auto * info : { &subscriptionInfo1, &subscriptionInfo2 })
+    {
+        uint8_t buffer[SimpleSubscriptionResumptionStorageTest::TestMaxSubscriptionSize()];
+        chip::TLV::TLVWriter writer;
+        writer.Init(buffer);
+        EXPECT_EQ(subscriptionStorage.TestSaveLegacy(writer, *info), CHIP_NO_ERROR);
+        legacySize += writer.GetLengthWritten();
+    }
+    const uint16_t tableSize = GetTableSize(storage);
+    ChipLogProgress(Test, "Subscription resumption storage size: %u bytes, %u bytes with the legacy format",
+                    static_cast<unsigned>(tableSize), static_cast<unsigned>(legacySize));
+    EXPECT_LT(tableSize, legacySize);
+}
+
+TEST_F(TestSimpleSubscriptionResumptionStorage, TestSubscriptionTableUnexpectedFields)
+{
+    chip::TestPersistentStorageDelegate storage;
+    SimpleSubscriptionResumptionStorageTest subscriptionStorage;
+    EXPECT_EQ(subscriptionStorage.Init(&storage), CHIP_NO_ERROR);
+
+    chip::app::SubscriptionResumptionStorage::SubscriptionInfo subscriptionInfo1 = {
+        .mNodeId         = 6666,
+        .mFabricIndex    = 46,
+        .mSubscriptionId = 6,
+        .mMinInterval    = 6,
+        .mMaxInterval    = 16,
+        .mFabricFiltered = true,
+    };
+    subscriptionInfo1.mAttributePaths.Calloc(1);
+    ASSERT_NE(subscriptionInfo1.mAttributePaths.Get(), nullptr);
+    subscriptionInfo1.mAttributePaths[0].mEndpointId  = 13;
+    subscriptionInfo1.mAttributePaths[0].mClusterId   = 13;
+    subscriptionInfo1.mAttributePaths[0].mAttributeId = 13;
+    EXPECT_EQ(subscriptionStorage.Save(subscriptionInfo1), CHIP_NO_ERROR);
+
+    // Append fields of a later version to the entry: shard header, entry length (single byte), entry
+    constexpr size_t kEntryOffset = SimpleSubscriptionResumptionStorageTest::kTestShardHeaderSize;
+    uint8_t table[64];
+    uint16_t size = sizeof(table);
+    EXPECT_EQ(storage.SyncGetKeyValue(chip::DefaultStorageKeyAllocator::SubscriptionResumptionTable(0).KeyName(), table, size),
+              CHIP_NO_ERROR);
+    ASSERT_LT(size + 2u, sizeof(table));
+    ASSERT_EQ(table[kEntryOffset], size - kEntryOffset - 1u);
+    table[kEntryOffset] = static_cast<uint8_t>(table[kEntryOffset] + 2);
+    table[size++]       = 0x5A;
+    table[size++]       = 0xA5;
+    EXPECT_EQ(storage.SyncSetKeyValue(chip::DefaultStorageKeyAllocator::SubscriptionResumptionTable(0).KeyName(), table, size),
+              CHIP_NO_ERROR);
+
+    auto * iterator = subscriptionStorage.IterateSubscriptions();
+    EXPECT_EQ(iterator->Count(), 1u);
+    TestSubscriptionInfo subscriptionInfo;
+    EXPECT_TRUE(iterator->Next(subscriptionInfo));
+    EXPECT_EQ(subscriptionInfo, subscriptionInfo1);
+    iterator->Release();
+}
+
+TEST_F(TestSimpleSubscriptionResumptionStorage, TestSubscriptionTableJunkData)
+{
+    chip::TestPersistentStorageDelegate storage;
+    SimpleSubscriptionResumptionStorageTest subscriptionStorage;
+    EXPECT_EQ(subscriptionStorage.Init(&storage), CHIP_NO_ERROR);
+
+    chip::app::SubscriptionResumptionStorage::SubscriptionInfo subscriptionInfo = { .mNodeId = 7777, .mFabricIndex = 47 };
+    for (chip::SubscriptionId subscriptionId = 0; subscriptionId < 3; subscriptionId++)
+    {
+        subscriptionInfo.mSubscriptionId = subscriptionId;
+        EXPECT_EQ(subscriptionStorage.Save(subscriptionInfo), CHIP_NO_ERROR);
+    }
+
+    // Cut the last entry short: the entries before it are kept, and the table is repaired
+    uint8_t table[SimpleSubscriptionResumptionStorageTest::kShardSize];
+    uint16_t size = sizeof(table);
+    EXPECT_EQ(storage.SyncGetKeyValue(chip::DefaultStorageKeyAllocator::SubscriptionResumptionTable(0).KeyName(), table, size),
+              CHIP_NO_ERROR);
+    EXPECT_EQ(storage.SyncSetKeyValue(chip::DefaultStorageKeyAllocator::SubscriptionResumptionTable(0).KeyName(), table,
+                                      static_cast<uint16_t>(size - 1)),
+              CHIP_NO_ERROR);
+
+    auto * iterator = subscriptionStorage.IterateSubscriptions();
+    EXPECT_EQ(iterator->Count(), 2u);
+    size_t count = 0;
+    while (iterator->Next(subscriptionInfo))
+    {
+        EXPECT_EQ(subscriptionInfo.mSubscriptionId, count);
+        count++;
+    }
+    iterator->Release();
+    EXPECT_EQ(count, 2u);
+    EXPECT_LT(GetTableSize(storage), size - 1);
+
+    // An unknown version drops the whole table
+    table[0] = 0xFF;
+    EXPECT_EQ(storage.SyncSetKeyValue(chip::DefaultStorageKeyAllocator::SubscriptionResumptionTable(0).KeyName(), table, size),
+              CHIP_NO_ERROR);
+    iterator = subscriptionStorage.IterateSubscriptions();
     EXPECT_EQ(iterator->Count(), 0u);
+    EXPECT_FALSE(iterator->Next(subscriptionInfo));
+    iterator->Release();
+    EXPECT_FALSE(storage.SyncDoesKeyExist(chip::DefaultStorageKeyAllocator::SubscriptionResumptionTable(0).KeyName()));
+}
+
+TEST_F(TestSimpleSubscriptionResumptionStorage, TestSubscriptionBatch)
+{
+    CountingStorageDelegate storage;
+    SimpleSubscriptionResumptionStorageTest subscriptionStorage;
+    EXPECT_EQ(subscriptionStorage.Init(&storage), CHIP_NO_ERROR);
+    EXPECT_EQ(subscriptionStorage.EndBatch(), CHIP_ERROR_INCORRECT_STATE);
+
+    // A controller re-establishing its subscriptions costs a single write of each shard
+    chip::app::SubscriptionResumptionStorage::SubscriptionInfo subscriptionInfo = { .mNodeId = 8888, .mFabricIndex = 48 };
+    storage.mWriteCount = 0;
+    EXPECT_EQ(subscriptionStorage.StartBatch(), CHIP_NO_ERROR);
+    EXPECT_EQ(subscriptionStorage.StartBatch(), CHIP_ERROR_INCORRECT_STATE);
+    for (size_t i = 0; i < (CHIP_IM_MAX_NUM_SUBSCRIPTIONS / 2); i++)
+    {
+        subscriptionInfo.mSubscriptionId = static_cast<chip::SubscriptionId>(i);
+        EXPECT_EQ(subscriptionStorage.Save(subscriptionInfo), CHIP_NO_ERROR);
+    }
+    EXPECT_EQ(subscriptionStorage.Delete(8888, 48, 0), CHIP_NO_ERROR);
+    EXPECT_EQ(subscriptionStorage.Delete(8888, 48, 0), CHIP_ERROR_PERSISTED_STORAGE_VALUE_NOT_FOUND);
+    EXPECT_EQ(storage.mWriteCount, 0u);
+    EXPECT_EQ(subscriptionStorage.EndBatch(), CHIP_NO_ERROR);
+    size_t shardCount;
+    GetTableSize(storage, &shardCount);
+    EXPECT_GT(shardCount, 0u);
+    EXPECT_EQ(storage.mWriteCount, shardCount);
+
+    auto * iterator = subscriptionStorage.IterateSubscriptions();
+    EXPECT_EQ(iterator->Count(), std::make_unsigned_t<int>(CHIP_IM_MAX_NUM_SUBSCRIPTIONS / 2 - 1));
     iterator->Release();
+
+    // Without a batch, every change is written on its own
+    storage.mWriteCount              = 0;
+    subscriptionInfo.mSubscriptionId = 0;
+    EXPECT_EQ(subscriptionStorage.Save(subscriptionInfo), CHIP_NO_ERROR);
+    subscriptionInfo.mSubscriptionId = 1;
+    EXPECT_EQ(subscriptionStorage.Save(subscriptionInfo), CHIP_NO_ERROR);
+    EXPECT_EQ(storage.mWriteCount, 2 * shardCount);
+
+    // A batch without changes writes nothing
+    storage.mWriteCount = 0;
+    EXPECT_EQ(subscriptionStorage.StartBatch(), CHIP_NO_ERROR);
+    EXPECT_EQ(subscriptionStorage.EndBatch(), CHIP_NO_ERROR);
+    EXPECT_EQ(storage.mWriteCount, 0u);
+}
+
+TEST_F(TestSimpleSubscriptionResumptionStorage, TestSubscriptionResumptionAtMaxCount)
+{
+    CountingStorageDelegate storage;
+    SimpleSubscriptionResumptionStorageTest subscriptionStorage;
+    EXPECT_EQ(subscriptionStorage.Init(&storage), CHIP_NO_ERROR);
+
+    // Fill the storage, spreading the paths of the IM engine pools over all subscriptions
+    constexpr size_t kPathsPerSubscription = CHIP_IM_SERVER_MAX_NUM_PATH_GROUPS_FOR_SUBSCRIPTIONS / CHIP_IM_MAX_NUM_SUBSCRIPTIONS;
+    EXPECT_EQ(subscriptionStorage.StartBatch(), CHIP_NO_ERROR);
+    for (size_t i = 0; i < CHIP_IM_MAX_NUM_SUBSCRIPTIONS; i++)
+    {
+        chip::app::SubscriptionResumptionStorage::SubscriptionInfo subscriptionInfo = {
+            .mNodeId         = 0x0102030405060708 + (i / 3),
+            .mFabricIndex    = static_cast<chip::FabricIndex>(1 + (i % 3)),
+            .mSubscriptionId = static_cast<chip::SubscriptionId>(0x12345678 + i),
+            .mMinInterval    = 0,
+            .mMaxInterval    = 3600,
+            .mFabricFiltered = true,
+        };
+        subscriptionInfo.mAttributePaths.Calloc(kPathsPerSubscription);
+        subscriptionInfo.mEventPaths.Calloc(kPathsPerSubscription);
+        ASSERT_NE(subscriptionInfo.mAttributePaths.Get(), nullptr);
+        ASSERT_NE(subscriptionInfo.mEventPaths.Get(), nullptr);
+        for (size_t pathIndex = 0; pathIndex < kPathsPerSubscription; pathIndex++)
+        {
+            subscriptionInfo.mAttributePaths[pathIndex].mEndpointId  = static_cast<chip::EndpointId>(1 + pathIndex);
+            subscriptionInfo.mAttributePaths[pathIndex].mClusterId   = 0x0300;
+            subscriptionInfo.mAttributePaths[pathIndex].mAttributeId = chip::kInvalidAttributeId;
+            subscriptionInfo.mEventPaths[pathIndex].mEndpointId      = static_cast<chip::EndpointId>(1 + pathIndex);
+            subscriptionInfo.mEventPaths[pathIndex].mClusterId       = 0x003B;
+            subscriptionInfo.mEventPaths[pathIndex].mEventId         = static_cast<chip::EventId>(pathIndex);
+            subscriptionInfo.mEventPaths[pathIndex].mIsUrgentEvent   = true;
+        }
+        EXPECT_EQ(subscriptionStorage.Save(subscriptionInfo), CHIP_NO_ERROR);
+    }
+    EXPECT_EQ(subscriptionStorage.EndBatch(), CHIP_NO_ERROR);
+
+    chip::app::SubscriptionResumptionStorage::SubscriptionInfo subscriptionInfo = { .mNodeId = 9999, .mFabricIndex = 49 };
+    EXPECT_EQ(subscriptionStorage.Save(subscriptionInfo), CHIP_ERROR_NO_MEMORY);
+
+    size_t shardCount;
+    const uint16_t tableSize = GetTableSize(storage, &shardCount);
+    EXPECT_GT(shardCount, 0u);
+
+    auto * iterator = subscriptionStorage.IterateSubscriptions();
+    EXPECT_EQ(iterator->Count(), std::make_unsigned_t<int>(CHIP_IM_MAX_NUM_SUBSCRIPTIONS));
+    iterator->Release();
+
+    // Resume them as the IM engine does at boot, reading each shard once
+    storage.mReadCount   = 0;
+    const auto startTime = chip::System::SystemClock().GetMonotonicMicroseconds64();
+
+    iterator     = subscriptionStorage.IterateSubscriptions();
+    size_t count = 0;
+    while (iterator->Next(subscriptionInfo))
+    {
+        EXPECT_EQ(subscriptionInfo.mAttributePaths.AllocatedSize(), kPathsPerSubscription);
+        EXPECT_EQ(subscriptionInfo.mEventPaths.AllocatedSize(), kPathsPerSubscription);
+        count++;
+    }
+    iterator->Release();
+
+    const auto elapsed = chip::System::SystemClock().GetMonotonicMicroseconds64() - startTime;
+    EXPECT_EQ(count, std::make_unsigned_t<int>(CHIP_IM_MAX_NUM_SUBSCRIPTIONS));
+    EXPECT_EQ(storage.mReadCount, shardCount);
+
+    ChipLogProgress(Test, "Resumed %u subscriptions from a %u byte table in %u shards in %u us", static_cast<unsigned>(count),
+                    static_cast<unsigned>(tableSize), static_cast<unsigned>(shardCount), static_cast<unsigned>(elapsed.count()));
+}
+
+TEST_F(TestSimpleSubscriptionResumptionStorage, TestSubscriptionTableShards)
+{
+    chip::TestPersistentStorageDelegate storage;
+    SimpleSubscriptionResumptionStorageTest subscriptionStorage;
+    EXPECT_EQ(subscriptionStorage.Init(&storage), CHIP_NO_ERROR);
+
+    // Subscriptions with paths that do not compress well, so that all but the first span several shards
+    constexpr size_t kSubscriptionCount = 3;
+    TestSubscriptionInfo subscriptionInfos[kSubscriptionCount];
+    for (size_t i = 0; i < kSubscriptionCount; i++)
+    {
+        const size_t pathCount               = (i == 0) ? 4 : SimpleSubscriptionResumptionStorageTest::kShardSize / 4;
+        subscriptionInfos[i].mNodeId         = 0x1111 + i;
+        subscriptionInfos[i].mFabricIndex    = 51;
+        subscriptionInfos[i].mSubscriptionId = static_cast<chip::SubscriptionId>(i);
+        subscriptionInfos[i].mMinInterval    = 1;
+        subscriptionInfos[i].mMaxInterval    = 60;
+        subscriptionInfos[i].mFabricFiltered = false;
+        subscriptionInfos[i].mAttributePaths.Calloc(pathCount);
+        ASSERT_NE(subscriptionInfos[i].mAttributePaths.Get(), nullptr);
+        for (size_t pathIndex = 0; pathIndex < pathCount; pathIndex++)
+        {
+            subscriptionInfos[i].mAttributePaths[pathIndex].mEndpointId  = static_cast<chip::EndpointId>(pathIndex);
+            subscriptionInfos[i].mAttributePaths[pathIndex].mClusterId   = static_cast<chip::ClusterId>(0xFFF10000 + pathIndex);
+            subscriptionInfos[i].mAttributePaths[pathIndex].mAttributeId = static_cast<chip::AttributeId>(pathIndex);
+        }
+        EXPECT_EQ(subscriptionStorage.Save(subscriptionInfos[i]), CHIP_NO_ERROR);
+    }
+
+    size_t shardCount;
+    GetTableSize(storage, &shardCount);
+    EXPECT_GT(shardCount, kSubscriptionCount);
+
+    auto * iterator = subscriptionStorage.IterateSubscriptions();
+    EXPECT_EQ(iterator->Count(), kSubscriptionCount);
+    TestSubscriptionInfo subscriptionInfo;
+    for (size_t i = 0; i < kSubscriptionCount; i++)
+    {
+        EXPECT_TRUE(iterator->Next(subscriptionInfo));
+        EXPECT_EQ(subscriptionInfo, subscriptionInfos[i]);
+    }
+    EXPECT_FALSE(iterator->Next(subscriptionInfo));
+    iterator->Release();
+
+    // A write interrupted after the first shard: the subscriptions entirely in it are kept
+    uint8_t shard[SimpleSubscriptionResumptionStorageTest::kShardSize];
+    uint16_t size = sizeof(shard);
+    EXPECT_EQ(storage.SyncGetKeyValue(chip::DefaultStorageKeyAllocator::SubscriptionResumptionTable(1).KeyName(), shard, size),
+              CHIP_NO_ERROR);
+    shard[1]++;
+    EXPECT_EQ(storage.SyncSetKeyValue(chip::DefaultStorageKeyAllocator::SubscriptionResumptionTable(1).KeyName(), shard, size),
+              CHIP_NO_ERROR);
+
+    iterator = subscriptionStorage.IterateSubscriptions();
+    EXPECT_EQ(iterator->Count(), 1u);
+    EXPECT_TRUE(iterator->Next(subscriptionInfo));
+    EXPECT_EQ(subscriptionInfo, subscriptionInfos[0]);
+    EXPECT_FALSE(iterator->Next(subscriptionInfo));
+    iterator->Release();
+
+    // The table was repaired, and the shards it no longer needs removed
+    size_t repairedShardCount;
+    GetTableSize(storage, &repairedShardCount);
+    EXPECT_LT(repairedShardCount, shardCount);
+    EXPECT_FALSE(
+        storage.SyncDoesKeyExist(chip::DefaultStorageKeyAllocator::SubscriptionResumptionTable(shardCount - 1).KeyName()));
+
+    EXPECT_EQ(subscriptionStorage.Delete(0x1111, 51, 0), CHIP_NO_ERROR);
+    EXPECT_FALSE(storage.SyncDoesKeyExist(chip::DefaultStorageKeyAllocator::SubscriptionResumptionTable(0).KeyName()));
 }
@@ -93,6 +93,9 @@ uint8_t singletonAttributeData[ACTUAL_SINGLETONS_SIZE];
 
 uint16_t emberEndpointCount = 0;
 
+// Changed whenever the set of enabled endpoints or their composition changes, see GetEndpointCompositionGeneration.
+uint32_t endpointCompositionGeneration = 0;
+
 // If we have attributes that are more than 4 bytes, then
 // we need this data block for the defaults
 #if (defined(GENERATED_DEFAULTS) && GENERATED_DEFAULTS_COUNT)
@@ -915,6 +918,8 @@ bool emberAfEndpointEnableDisable(EndpointId endpoint, bool enable)
 
     if (currentlyEnabled != enable)
     {
+        endpointCompositionGeneration++;
+
         if (enable)
         {
             initializeEndpoint(&(emAfEndpoints[index]));
@@ -1353,6 +1358,7 @@ CHIP_ERROR SetParentEndpointForEndpoint(EndpointId childEndpoint, EndpointId par
         return CHIP_ERROR_INVALID_ARGUMENT;
     }
     emAfEndpoints[childIndex].parentEndpointId = parentEndpoint;
+    endpointCompositionGeneration++;
     return CHIP_NO_ERROR;
 }
 
@@ -1365,6 +1371,7 @@ CHIP_ERROR SetFlatCompositionForEndpoint(EndpointId endpoint)
     }
     emAfEndpoints[index].bitmask.Clear(EmberAfEndpointOptions::isTreeComposition);
     emAfEndpoints[index].bitmask.Set(EmberAfEndpointOptions::isFlatComposition);
+    endpointCompositionGeneration++;
     return CHIP_NO_ERROR;
 }
 
@@ -1377,6 +1384,7 @@ CHIP_ERROR SetTreeCompositionForEndpoint(EndpointId endpoint)
     }
     emAfEndpoints[index].bitmask.Clear(EmberAfEndpointOptions::isFlatComposition);
     emAfEndpoints[index].bitmask.Set(EmberAfEndpointOptions::isTreeComposition);
+    endpointCompositionGeneration++;
     return CHIP_NO_ERROR;
 }
 
@@ -1400,6 +1408,11 @@ bool IsTreeCompositionForEndpoint(EndpointId endpoint)
     return emAfEndpoints[index].bitmask.Has(EmberAfEndpointOptions::isTreeComposition);
 }
 
+uint32_t GetEndpointCompositionGeneration()
+{
+    return endpointCompositionGeneration;
+}
+
 } // namespace app
 } // namespace chip
 
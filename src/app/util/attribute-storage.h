@@ -342,5 +342,12 @@ bool IsFlatCompositionForEndpoint(EndpointId endpoint);
  */
 bool IsTreeCompositionForEndpoint(EndpointId endpoint);
 
+/**
+ * @brief Returns a counter that changes whenever an endpoint is enabled or disabled, or the parent or composition of an
+ * endpoint changes. Data derived from the endpoint composition, such as the Descriptor PartsList, is still valid as long as
+ * the counter has not changed.
+ */
+uint32_t GetEndpointCompositionGeneration();
+
 } // namespace app
 } // namespace chip
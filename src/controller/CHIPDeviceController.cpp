@@ -992,6 +992,7 @@ CHIP_ERROR DeviceCommissioner::Commission(NodeId remoteDeviceId)
     if (device->IsSecureConnected())
     {
         MATTER_LOG_METRIC_BEGIN(kMetricDeviceCommissionerCommission);
+        mCommissioningStageLatencies.Clear();
         mDefaultCommissioner->StartCommissioning(this, device);
     }
     else
@@ -1188,6 +1189,7 @@ void DeviceCommissioner::OnSessionEstablished(const SessionHandle & session)
     {
         mRunCommissioningAfterConnection = false;
         MATTER_LOG_METRIC_BEGIN(kMetricDeviceCommissionerCommission);
+        mCommissioningStageLatencies.Clear();
         mDefaultCommissioner->StartCommissioning(this, device);
     }
 }
@@ -2042,8 +2044,9 @@ void DeviceCommissioner::SendCommissioningCompleteCallbacks(NodeId nodeId, const
         return;
     }
 
-    mPairingDelegate->OnCommissioningComplete(nodeId, completionStatus.err);
     PeerId peerId(GetCompressedFabricId(), nodeId);
+    mPairingDelegate->OnCommissioningStageLatencies(peerId, mCommissioningStageLatencies);
+    mPairingDelegate->OnCommissioningComplete(nodeId, completionStatus.err);
     if (completionStatus.err == CHIP_NO_ERROR)
     {
         mPairingDelegate->OnCommissioningSuccess(peerId);
@@ -2064,6 +2067,10 @@ void DeviceCommissioner::CommissioningStageComplete(CHIP_ERROR err, Commissionin
     MATTER_LOG_METRIC_END(MetricKeyForCommissioningStage(mCommissioningStage), err);
     VerifyOrDie(mDeviceBeingCommissioned);
 
+    mCommissioningStageLatencies.Record(mCommissioningStage,
+                                        std::chrono::duration_cast<System::Clock::Milliseconds32>(
+                                            System::SystemClock().GetMonotonicTimestamp() - mCommissioningStageStartTime));
+
     NodeId nodeId            = mDeviceBeingCommissioned->GetDeviceId();
     DeviceProxy * proxy      = mDeviceBeingCommissioned;
     mDeviceBeingCommissioned = nullptr;
@@ -2899,9 +2906,10 @@ void DeviceCommissioner::PerformCommissioningStep(DeviceProxy * proxy, Commissio
                         params.GetCompletionStatus().err.AsString());
     }
 
-    mCommissioningStage      = step;
-    mCommissioningDelegate   = delegate;
-    mDeviceBeingCommissioned = proxy;
+    mCommissioningStage          = step;
+    mCommissioningDelegate       = delegate;
+    mDeviceBeingCommissioned     = proxy;
+    mCommissioningStageStartTime = System::SystemClock().GetMonotonicTimestamp();
 
     // TODO: Extend timeouts to the DAC and Opcert requests.
     // TODO(cecille): We probably want something better than this for breadcrumbs.
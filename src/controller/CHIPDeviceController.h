@@ -702,6 +702,12 @@ public:
      */
     CommissioningStage GetCommissioningStage() { return mCommissioningStage; }
 
+    /**
+     * @brief
+     *   Time spent in each stage of the current, or most recently completed, commissioning attempt.
+     */
+    const CommissioningStageLatencies & GetCommissioningStageLatencies() const { return mCommissioningStageLatencies; }
+
 #if CONFIG_NETWORK_LAYER_BLE
 #if CHIP_DEVICE_CONFIG_ENABLE_BOTH_COMMISSIONER_AND_COMMISSIONEE
     /**
@@ -833,6 +839,9 @@ private:
     Internal::InvokeCancelFn mInvokeCancelFn;
     Internal::WriteCancelFn mWriteCancelFn;
 
+    System::Clock::Timestamp mCommissioningStageStartTime = System::Clock::kZero;
+    CommissioningStageLatencies mCommissioningStageLatencies;
+
     ObjectPool<CommissioneeDeviceProxy, kNumMaxActiveDevices> mCommissioneeDevicePool;
 
 #if CHIP_DEVICE_CONFIG_ENABLE_COMMISSIONER_DISCOVERY // make this commissioner discoverable
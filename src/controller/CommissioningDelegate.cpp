@@ -21,6 +21,64 @@
 namespace chip {
 namespace Controller {
 
+namespace {
+
+// There is deliberately no default case: adding a stage to CommissioningStage fails to build here until it is
+// listed, and the static_assert below then checks that kCommissioningStageCount still covers the last stage.
+constexpr bool IsLastCommissioningStage(CommissioningStage stage)
+{
+    switch (stage)
+    {
+    case kError:
+    case kSecurePairing:
+    case kReadCommissioningInfo:
+    case kReadCommissioningInfo2:
+    case kArmFailsafe:
+    case kConfigRegulatory:
+    case kConfigureUTCTime:
+    case kConfigureTimeZone:
+    case kConfigureDSTOffset:
+    case kConfigureDefaultNTP:
+    case kSendPAICertificateRequest:
+    case kSendDACCertificateRequest:
+    case kSendAttestationRequest:
+    case kAttestationVerification:
+    case kAttestationRevocationCheck:
+    case kSendOpCertSigningRequest:
+    case kValidateCSR:
+    case kGenerateNOCChain:
+    case kSendTrustedRootCert:
+    case kSendNOC:
+    case kConfigureTrustedTimeSource:
+    case kICDGetRegistrationInfo:
+    case kICDRegistration:
+    case kWiFiNetworkSetup:
+    case kThreadNetworkSetup:
+    case kFailsafeBeforeWiFiEnable:
+    case kFailsafeBeforeThreadEnable:
+    case kWiFiNetworkEnable:
+    case kThreadNetworkEnable:
+    case kEvictPreviousCaseSessions:
+    case kFindOperationalForStayActive:
+    case kFindOperationalForCommissioningComplete:
+    case kSendComplete:
+    case kICDSendStayActive:
+    case kCleanup:
+    case kScanNetworks:
+    case kNeedsNetworkCreds:
+    case kPrimaryOperationalNetworkFailed:
+        return false;
+    case kDisablePrimaryNetworkInterface:
+        return true;
+    }
+    return false;
+}
+
+static_assert(IsLastCommissioningStage(static_cast<CommissioningStage>(kCommissioningStageCount - 1)),
+              "kCommissioningStageCount must be one past the last CommissioningStage");
+
+} // namespace
+
 const char * StageToString(CommissioningStage stage)
 {
     switch (stage)
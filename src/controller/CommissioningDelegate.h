@@ -23,6 +23,7 @@
 #include <credentials/attestation_verifier/DeviceAttestationDelegate.h>
 #include <credentials/attestation_verifier/DeviceAttestationVerifier.h>
 #include <crypto/CHIPCryptoPAL.h>
+#include <lib/support/CodeUtils.h>
 #include <lib/support/Variant.h>
 #include <matter/tracing/build_config.h>
 #include <system/SystemClock.h>
@@ -84,6 +85,36 @@ enum CommissioningStage : uint8_t
     kDisablePrimaryNetworkInterface,  ///< Send InterfaceEnabled write request to the device to disable network interface.
 };
 
+/// Number of values in CommissioningStage; must be kept in sync with the last enumerator, which is checked in
+/// CommissioningDelegate.cpp.
+inline constexpr size_t kCommissioningStageCount = static_cast<size_t>(CommissioningStage::kDisablePrimaryNetworkInterface) + 1;
+
+/**
+ * Time spent in each stage of a single commissioning attempt, measured from the moment the stage is
+ * performed until it reports completion.  Stages that did not run report zero.  Unlike the
+ * per-stage tracing metrics, this is always collected, so that commissioners can report where
+ * commissioning time goes without a tracing backend.
+ *
+ * DeviceCommissioner runs the stages of one commissionee at a time, so these latencies describe
+ * a serial commissioning flow; they do not account for any concurrency between commissionees.
+ */
+struct CommissioningStageLatencies
+{
+    System::Clock::Milliseconds32 stageDuration[kCommissioningStageCount] = {};
+    // Sum of all stage durations.
+    System::Clock::Milliseconds32 total = System::Clock::kZero;
+
+    void Clear() { *this = CommissioningStageLatencies(); }
+
+    void Record(CommissioningStage stage, System::Clock::Milliseconds32 elapsed)
+    {
+        VerifyOrReturn(static_cast<size_t>(stage) < kCommissioningStageCount);
+        // A stage may run more than once (e.g. fail-safe re-arming), so accumulate.
+        stageDuration[static_cast<size_t>(stage)] += elapsed;
+        total += elapsed;
+    }
+};
+
 enum class ICDRegistrationStrategy : uint8_t
 {
     kIgnore,         ///< Do not check whether the device is an ICD during commissioning
@@ -77,6 +77,12 @@ public:
 
     virtual void OnCommissioningStatusUpdate(PeerId peerId, CommissioningStage stageCompleted, CHIP_ERROR error) {}
 
+    /**
+     * @brief
+     *  Called right before OnCommissioningComplete with the time spent in each commissioning stage.
+     */
+    virtual void OnCommissioningStageLatencies(PeerId peerId, const CommissioningStageLatencies & latencies) {}
+
     /**
      * @brief
      *  Called with the ReadCommissioningInfo returned from the target
@@ -0,0 +1,220 @@
+/*
+ *
+ *    Copyright (c) 2024 Project CHIP Authors
+ *    All rights reserved.
+ *
+ *    Licensed under the Apache License, Version 2.0 (the "License");
+ *    you may not use this file except in compliance with the License.
+ *    You may obtain a copy of the License at
+ *
+ *        http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *    Unless required by applicable law or agreed to in writing, software
+ *    distributed under the License is distributed on an "AS IS" BASIS,
+ *    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *    See the License for the specific language governing permissions and
+ *    limitations under the License.
+ */
+
+#include <vector>
+
+#include <pw_unit_test/framework.h>
+
+#include <app-common/zap-generated/cluster-objects.h>
+#include <app-common/zap-generated/ids/Attributes.h>
+#include <app-common/zap-generated/ids/Clusters.h>
+#include <app/tests/AppTestContext.h>
+#include <app/util/attribute-storage.h>
+#include <app/util/endpoint-config-api.h>
+#include <controller/ReadInteraction.h>
+#include <lib/core/StringBuilderAdapters.h>
+#include <lib/support/logging/CHIPLogging.h>
+
+// Registers the Descriptor cluster server, which is built for this test with a PartsList cache of two entries.
+void MatterDescriptorPluginServerInitCallback();
+
+using namespace chip;
+using namespace chip::app;
+using namespace chip::app::Clusters;
+
+namespace {
+
+// Endpoint 1 is used by the fixed endpoint of the controller data model.
+constexpr EndpointId kAggregatorEndpointId = 10;
+constexpr EndpointId kBridgedEndpointId    = 11;
+constexpr EndpointId kChildEndpointId      = 12;
+constexpr EndpointId kAddedEndpointId      = 13;
+
+constexpr uint16_t kAggregatorIndex = 0;
+constexpr uint16_t kBridgedIndex    = 1;
+constexpr uint16_t kChildIndex      = 2;
+constexpr uint16_t kAddedIndex      = 3;
+
+constexpr int kDescriptorAttributeArraySize = 254;
+
+DECLARE_DYNAMIC_ATTRIBUTE_LIST_BEGIN(descriptorAttrs)
+DECLARE_DYNAMIC_ATTRIBUTE(Descriptor::Attributes::DeviceTypeList::Id, ARRAY, kDescriptorAttributeArraySize, 0),
+    DECLARE_DYNAMIC_ATTRIBUTE(Descriptor::Attributes::ServerList::Id, ARRAY, kDescriptorAttributeArraySize, 0),
+    DECLARE_DYNAMIC_ATTRIBUTE(Descriptor::Attributes::ClientList::Id, ARRAY, kDescriptorAttributeArraySize, 0),
+    DECLARE_DYNAMIC_ATTRIBUTE(Descriptor::Attributes::PartsList::Id, ARRAY, kDescriptorAttributeArraySize, 0),
+    DECLARE_DYNAMIC_ATTRIBUTE_LIST_END();
+
+DECLARE_DYNAMIC_CLUSTER_LIST_BEGIN(testEndpointClusters)
+DECLARE_DYNAMIC_CLUSTER(Descriptor::Id, descriptorAttrs, ZAP_CLUSTER_MASK(SERVER), nullptr, nullptr),
+    DECLARE_DYNAMIC_CLUSTER_LIST_END;
+
+DECLARE_DYNAMIC_ENDPOINT(testEndpoint, testEndpointClusters);
+
+DataVersion dataVersionStorage[4][ArraySize(testEndpointClusters)];
+
+/// PartsList computed directly from the endpoint composition, without going through the Descriptor cluster.
+std::vector<EndpointId> ComputePartsList(EndpointId endpoint)
+{
+    std::vector<EndpointId> parts;
+    for (uint16_t index = 0; index < emberAfEndpointCount(); index++)
+    {
+        if (!emberAfEndpointIndexIsEnabled(index))
+        {
+            continue;
+        }
+
+        // Tree composition only lists direct children, flat composition lists all descendants.
+        EndpointId parent = emberAfParentEndpointFromIndex(index);
+        while (parent != kInvalidEndpointId && parent != endpoint && IsFlatCompositionForEndpoint(endpoint))
+        {
+            uint16_t parentIndex = emberAfIndexFromEndpoint(parent);
+            if (parentIndex == kInvalidListIndex)
+            {
+                break;
+            }
+            parent = emberAfParentEndpointFromIndex(parentIndex);
+        }
+        if (parent == endpoint)
+        {
+            parts.push_back(emberAfEndpointFromIndex(index));
+        }
+    }
+    return parts;
+}
+
+class TestDescriptorPartsList : public chip::Test::AppContext
+{
+public:
+    static void SetUpTestSuite()
+    {
+        AppContext::SetUpTestSuite();
+        MatterDescriptorPluginServerInitCallback();
+    }
+
+    void SetUp() override
+    {
+        AppContext::SetUp();
+
+        // An aggregator with flat composition, bridging a device with tree composition that has a child.
+        ASSERT_EQ(emberAfSetDynamicEndpoint(kAggregatorIndex, kAggregatorEndpointId, &testEndpoint,
+                                            Span<DataVersion>(dataVersionStorage[kAggregatorIndex])),
+                  CHIP_NO_ERROR);
+        ASSERT_EQ(emberAfSetDynamicEndpoint(kBridgedIndex, kBridgedEndpointId, &testEndpoint,
+                                            Span<DataVersion>(dataVersionStorage[kBridgedIndex]), {}, kAggregatorEndpointId),
+                  CHIP_NO_ERROR);
+        ASSERT_EQ(emberAfSetDynamicEndpoint(kChildIndex, kChildEndpointId, &testEndpoint,
+                                            Span<DataVersion>(dataVersionStorage[kChildIndex]), {}, kBridgedEndpointId),
+                  CHIP_NO_ERROR);
+        ASSERT_EQ(SetFlatCompositionForEndpoint(kAggregatorEndpointId), CHIP_NO_ERROR);
+        ASSERT_EQ(SetTreeCompositionForEndpoint(kBridgedEndpointId), CHIP_NO_ERROR);
+    }
+
+    void TearDown() override
+    {
+        emberAfClearDynamicEndpoint(kAddedIndex);
+        emberAfClearDynamicEndpoint(kChildIndex);
+        emberAfClearDynamicEndpoint(kBridgedIndex);
+        emberAfClearDynamicEndpoint(kAggregatorIndex);
+        AppContext::TearDown();
+    }
+
+protected:
+    std::vector<EndpointId> ReadPartsList(EndpointId endpoint)
+    {
+        std::vector<EndpointId> parts;
+        bool onSuccessWasCalled = false;
+        bool onFailureWasCalled = false;
+
+        // Passing of stack variables by reference is only safe because of synchronous completion of the interaction.
+        auto onSuccessCb = [&parts, &onSuccessWasCalled](const ConcreteDataAttributePath &,
+                                                         const DataModel::DecodableList<EndpointId> & partsList) {
+            auto iter = partsList.begin();
+            while (iter.Next())
+            {
+                parts.push_back(iter.GetValue());
+            }
+            EXPECT_EQ(iter.GetStatus(), CHIP_NO_ERROR);
+            onSuccessWasCalled = true;
+        };
+        auto onFailureCb = [&onFailureWasCalled](const ConcreteDataAttributePath *, CHIP_ERROR aError) {
+            ChipLogError(NotSpecified, "TEST FAILURE: %" CHIP_ERROR_FORMAT, aError.Format());
+            onFailureWasCalled = true;
+        };
+
+        EXPECT_EQ(Controller::ReadAttribute<Descriptor::Attributes::PartsList::TypeInfo>(
+                      &GetExchangeManager(), GetSessionBobToAlice(), endpoint, onSuccessCb, onFailureCb),
+                  CHIP_NO_ERROR);
+        DrainAndServiceIO();
+
+        EXPECT_TRUE(onSuccessWasCalled && !onFailureWasCalled);
+        EXPECT_EQ(GetExchangeManager().GetNumActiveExchanges(), 0u);
+        return parts;
+    }
+
+    /// Reads the PartsList of the endpoints twice, the second time from the cache, and checks both against the composition.
+    void ExpectPartsLists(const std::vector<EndpointId> & aggregatorParts, const std::vector<EndpointId> & bridgedParts)
+    {
+        EXPECT_TRUE(ComputePartsList(kAggregatorEndpointId) == aggregatorParts);
+        EXPECT_TRUE(ComputePartsList(kBridgedEndpointId) == bridgedParts);
+
+        for (int i = 0; i < 2; i++)
+        {
+            EXPECT_TRUE(ReadPartsList(kAggregatorEndpointId) == aggregatorParts);
+            EXPECT_TRUE(ReadPartsList(kBridgedEndpointId) == bridgedParts);
+        }
+    }
+};
+
+TEST_F(TestDescriptorPartsList, TestCachedPartsListMatchesComposition)
+{
+    ExpectPartsLists({ kBridgedEndpointId, kChildEndpointId }, { kChildEndpointId });
+
+    // Reading a third endpoint evicts one of the two cached ones, which is then computed again.
+    EXPECT_TRUE(ReadPartsList(kChildEndpointId).empty());
+    ExpectPartsLists({ kBridgedEndpointId, kChildEndpointId }, { kChildEndpointId });
+}
+
+TEST_F(TestDescriptorPartsList, TestCacheInvalidatedByEnableDisable)
+{
+    ExpectPartsLists({ kBridgedEndpointId, kChildEndpointId }, { kChildEndpointId });
+
+    EXPECT_TRUE(emberAfEndpointEnableDisable(kChildEndpointId, false));
+    ExpectPartsLists({ kBridgedEndpointId }, {});
+
+    EXPECT_TRUE(emberAfEndpointEnableDisable(kChildEndpointId, true));
+    ExpectPartsLists({ kBridgedEndpointId, kChildEndpointId }, { kChildEndpointId });
+}
+
+TEST_F(TestDescriptorPartsList, TestCacheInvalidatedByDynamicEndpoints)
+{
+    ExpectPartsLists({ kBridgedEndpointId, kChildEndpointId }, { kChildEndpointId });
+
+    ASSERT_EQ(emberAfSetDynamicEndpoint(kAddedIndex, kAddedEndpointId, &testEndpoint,
+                                        Span<DataVersion>(dataVersionStorage[kAddedIndex]), {}, kAggregatorEndpointId),
+              CHIP_NO_ERROR);
+    ExpectPartsLists({ kBridgedEndpointId, kChildEndpointId, kAddedEndpointId }, { kChildEndpointId });
+
+    // Moving an endpoint changes the composition too.
+    EXPECT_EQ(SetParentEndpointForEndpoint(kAddedEndpointId, kBridgedEndpointId), CHIP_NO_ERROR);
+    ExpectPartsLists({ kBridgedEndpointId, kChildEndpointId, kAddedEndpointId }, { kChildEndpointId, kAddedEndpointId });
+
+    EXPECT_EQ(emberAfClearDynamicEndpoint(kAddedIndex), kAddedEndpointId);
+    ExpectPartsLists({ kBridgedEndpointId, kChildEndpointId }, { kChildEndpointId });
+}
+
+} // namespace
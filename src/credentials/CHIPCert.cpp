@@ -33,6 +33,7 @@
 #include <lib/asn1/ASN1Macros.h>
 #include <lib/core/CHIPCore.h>
 #include <lib/core/CHIPSafeCasts.h>
+#include <lib/core/Global.h>
 #include <lib/core/TLV.h>
 #include <lib/support/BytesToHex.h>
 #include <lib/support/CHIPMem.h>
@@ -41,6 +42,7 @@
 #include <lib/support/ScopedBuffer.h>
 #include <lib/support/TimeUtils.h>
 #include <protocols/Protocols.h>
+#include <system/SystemMutex.h>
 
 namespace chip {
 namespace Credentials {
@@ -50,6 +52,181 @@ using namespace chip::TLV;
 using namespace chip::Protocols;
 using namespace chip::Crypto;
 
+namespace {
+
+#if CHIP_CONFIG_CERT_SIGNATURE_CACHE_SIZE > 0
+
+/**
+ * Remembers CA certificate signatures that were successfully verified, keyed by a digest of
+ * (signer public key, TBS hash, signature), so that validating many chains that share an
+ * ICAC / RCAC only pays for the ECDSA verification once.  Least recently used entries are
+ * evicted first.
+ *
+ * Chains are validated both on the Matter thread and on the background thread that handles
+ * CASE Sigma3, so every access goes through the lock.
+ */
+class CertSignatureCache
+{
+public:
+    CertSignatureCache()
+    {
+#if !CHIP_SYSTEM_CONFIG_NO_LOCKING
+        System::Mutex::Init(mLock);
+#endif // !CHIP_SYSTEM_CONFIG_NO_LOCKING
+    }
+
+    bool Contains(const uint8_t (&key)[kSHA256_Hash_Length])
+    {
+        ScopedLock lock(*this);
+        for (auto & entry : mEntries)
+        {
+            if (entry.lastUsed != 0 && memcmp(entry.key, key, sizeof(key)) == 0)
+            {
+                entry.lastUsed = ++mUseCounter;
+                mStats.hits++;
+                return true;
+            }
+        }
+        mStats.misses++;
+        return false;
+    }
+
+    void Add(const uint8_t (&key)[kSHA256_Hash_Length])
+    {
+        ScopedLock lock(*this);
+        Entry * victim = &mEntries[0];
+        for (auto & entry : mEntries)
+        {
+            if (entry.lastUsed < victim->lastUsed)
+            {
+                victim = &entry;
+            }
+        }
+        memcpy(victim->key, key, sizeof(key));
+        victim->lastUsed = ++mUseCounter;
+    }
+
+    void Clear()
+    {
+        ScopedLock lock(*this);
+        for (auto & entry : mEntries)
+        {
+            entry.lastUsed = 0;
+        }
+    }
+
+    CertSignatureCacheStats GetStats()
+    {
+        ScopedLock lock(*this);
+        return mStats;
+    }
+
+    void ResetStats()
+    {
+        ScopedLock lock(*this);
+        mStats = CertSignatureCacheStats();
+    }
+
+private:
+    struct Entry
+    {
+        uint8_t key[kSHA256_Hash_Length];
+        // 0 marks an unused entry.
+        uint32_t lastUsed = 0;
+    };
+
+    class ScopedLock
+    {
+    public:
+        ScopedLock(CertSignatureCache & cache) : mCache(cache)
+        {
+#if !CHIP_SYSTEM_CONFIG_NO_LOCKING
+            mCache.mLock.Lock();
+#endif // !CHIP_SYSTEM_CONFIG_NO_LOCKING
+        }
+        ~ScopedLock()
+        {
+#if !CHIP_SYSTEM_CONFIG_NO_LOCKING
+            mCache.mLock.Unlock();
+#endif // !CHIP_SYSTEM_CONFIG_NO_LOCKING
+        }
+
+    private:
+        CertSignatureCache & mCache;
+    };
+
+    Entry mEntries[CHIP_CONFIG_CERT_SIGNATURE_CACHE_SIZE];
+    uint32_t mUseCounter = 0;
+    CertSignatureCacheStats mStats;
+#if !CHIP_SYSTEM_CONFIG_NO_LOCKING
+    System::Mutex mLock;
+#endif // !CHIP_SYSTEM_CONFIG_NO_LOCKING
+};
+
+AtomicGlobal<CertSignatureCache> gCertSignatureCache;
+
+CHIP_ERROR ComputeCertSignatureCacheKey(const ChipCertificateData & cert, const ChipCertificateData & signer,
+                                        uint8_t (&outKey)[kSHA256_Hash_Length])
+{
+    Hash_SHA256_stream hash;
+    ReturnErrorOnFailure(hash.Begin());
+    ReturnErrorOnFailure(hash.AddData(ByteSpan(signer.mPublicKey.data(), signer.mPublicKey.size())));
+    ReturnErrorOnFailure(hash.AddData(ByteSpan(cert.mTBSHash)));
+    ReturnErrorOnFailure(hash.AddData(ByteSpan(cert.mSignature.data(), cert.mSignature.size())));
+    MutableByteSpan keySpan(outKey);
+    return hash.Finish(keySpan);
+}
+
+#endif // CHIP_CONFIG_CERT_SIGNATURE_CACHE_SIZE > 0
+
+/**
+ * Same as VerifyCertSignature(), but for CA certificates consults and fills the signature cache.
+ * Leaf certificates are always verified, since they differ for every peer.
+ */
+CHIP_ERROR VerifyCertSignatureWithCache(const ChipCertificateData & cert, const ChipCertificateData & signer)
+{
+#if CHIP_CONFIG_CERT_SIGNATURE_CACHE_SIZE > 0
+    if (cert.mCertFlags.Has(CertFlags::kIsCA) && cert.mCertFlags.Has(CertFlags::kTBSHashPresent))
+    {
+        uint8_t key[kSHA256_Hash_Length];
+        if (ComputeCertSignatureCacheKey(cert, signer, key) == CHIP_NO_ERROR)
+        {
+            VerifyOrReturnError(!gCertSignatureCache->Contains(key), CHIP_NO_ERROR);
+            ReturnErrorOnFailure(VerifyCertSignature(cert, signer));
+            gCertSignatureCache->Add(key);
+            return CHIP_NO_ERROR;
+        }
+    }
+#endif // CHIP_CONFIG_CERT_SIGNATURE_CACHE_SIZE > 0
+
+    return VerifyCertSignature(cert, signer);
+}
+
+} // namespace
+
+void ClearCertSignatureCache()
+{
+#if CHIP_CONFIG_CERT_SIGNATURE_CACHE_SIZE > 0
+    gCertSignatureCache->Clear();
+#endif
+}
+
+CertSignatureCacheStats GetCertSignatureCacheStats()
+{
+#if CHIP_CONFIG_CERT_SIGNATURE_CACHE_SIZE > 0
+    return gCertSignatureCache->GetStats();
+#else
+    return CertSignatureCacheStats();
+#endif
+}
+
+void ResetCertSignatureCacheStats()
+{
+#if CHIP_CONFIG_CERT_SIGNATURE_CACHE_SIZE > 0
+    gCertSignatureCache->ResetStats();
+#endif
+}
+
 ChipCertificateSet::ChipCertificateSet()
 {
     mCerts               = nullptr;
@@ -411,7 +588,7 @@ CHIP_ERROR ChipCertificateSet::ValidateCert(const ChipCertificateData * cert, Va
 
     // Verify signature of the current certificate against public key of the CA certificate. If signature verification
     // succeeds, the current certificate is valid.
-    err = VerifyCertSignature(*cert, *caCert);
+    err = VerifyCertSignatureWithCache(*cert, *caCert);
     SuccessOrExit(err);
 
 exit:
@@ -1126,7 +1303,7 @@ CHIP_ERROR ValidateChipRCAC(const ByteSpan & rcac)
 
     VerifyOrReturnError(certData.mKeyUsageFlags.Has(KeyUsageFlags::kKeyCertSign), CHIP_ERROR_CERT_USAGE_NOT_ALLOWED);
 
-    return VerifyCertSignature(certData, certData);
+    return VerifyCertSignatureWithCache(certData, certData);
 }
 
 CHIP_ERROR ConvertIntegerDERToRaw(ByteSpan derInt, uint8_t * rawInt, const uint16_t rawIntLen)
@@ -535,6 +535,26 @@ CHIP_ERROR ConvertChipCertToX509Cert(const ByteSpan chipCert, MutableByteSpan &
  **/
 CHIP_ERROR VerifyCertSignature(const ChipCertificateData & cert, const ChipCertificateData & signer);
 
+/**
+ * Counters for the cache of verified CA certificate signatures used during chain validation
+ * (see CHIP_CONFIG_CERT_SIGNATURE_CACHE_SIZE).
+ */
+struct CertSignatureCacheStats
+{
+    uint32_t hits   = 0;
+    uint32_t misses = 0;
+};
+
+/**
+ * @brief Forget all cached CA certificate signature verifications.
+ *
+ * Called by the FabricTable whenever operational credentials are added, updated or removed.
+ **/
+void ClearCertSignatureCache();
+
+CertSignatureCacheStats GetCertSignatureCacheStats();
+void ResetCertSignatureCacheStats();
+
 /**
  * Validate CHIP Root CA Certificate (RCAC) in ByteSpan TLV-encoded form.
  * This function performs RCAC parsing, checks SubjectDN validity, verifies that SubjectDN
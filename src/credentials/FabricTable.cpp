@@ -758,6 +758,10 @@ public:
 CHIP_ERROR FabricTable::NotifyFabricUpdated(FabricIndex fabricIndex)
 {
     MATTER_TRACE_SCOPE("NotifyFabricUpdated", "Fabric");
+
+    // Cached CA signature verifications may refer to credentials that were just replaced.
+    ClearCertSignatureCache();
+
     FabricTable::Delegate * delegate = mDelegateListRoot;
     while (delegate)
     {
@@ -993,6 +997,7 @@ CHIP_ERROR FabricTable::Delete(FabricIndex fabricIndex)
 
     // Since fabricIsInitialized was true, fabric is not null.
     fabricInfo->Reset();
+    ClearCertSignatureCache();
 
     if (!mNextAvailableFabricIndex.HasValue())
     {
@@ -2027,6 +2032,8 @@ CHIP_ERROR FabricTable::CommitPendingFabricData()
 void FabricTable::RevertPendingFabricData()
 {
     MATTER_TRACE_SCOPE("RevertPendingFabricData", "Fabric");
+    ClearCertSignatureCache();
+
     // Will clear pending UpdateNoc/AddNOC
     RevertPendingOpCertsExceptRoot();
 
@@ -24,6 +24,9 @@
 #include <lib/support/Pool.h>
 #include <stdlib.h>
 
+#include <algorithm>
+#include <limits>
+
 namespace chip {
 namespace Credentials {
 
@@ -832,12 +835,14 @@ void GroupDataProviderImpl::Finish()
     mKeySetIterators.ReleaseAll();
     mGroupSessionsIterator.ReleaseAll();
     mGroupKeyContexPool.ReleaseAll();
+    InvalidateCachedFabrics();
 }
 
 void GroupDataProviderImpl::SetStorageDelegate(PersistentStorageDelegate * storage)
 {
     VerifyOrDie(storage != nullptr);
     mStorage = storage;
+    InvalidateCachedFabrics();
 }
 
 //
@@ -848,6 +853,7 @@ CHIP_ERROR GroupDataProviderImpl::SetGroupInfo(chip::FabricIndex fabric_index, c
 {
     VerifyOrReturnError(IsInitialized(), CHIP_ERROR_INTERNAL);
 
+    ScopedCacheInvalidation invalidation(*this, fabric_index);
     FabricData fabric(fabric_index);
     GroupData group;
 
@@ -870,6 +876,17 @@ CHIP_ERROR GroupDataProviderImpl::SetGroupInfo(chip::FabricIndex fabric_index, c
 
 CHIP_ERROR GroupDataProviderImpl::GetGroupInfo(chip::FabricIndex fabric_index, chip::GroupId group_id, GroupInfo & info)
 {
+    const CachedFabric * cache = GetCachedFabric(fabric_index);
+    if (cache != nullptr)
+    {
+        const CachedFabric::Group * cached = cache->FindGroup(group_id);
+        VerifyOrReturnError(nullptr != cached, CHIP_ERROR_NOT_FOUND);
+
+        info.group_id = group_id;
+        info.SetName(cached->name);
+        return CHIP_NO_ERROR;
+    }
+
     FabricData fabric(fabric_index);
     GroupData group;
 
@@ -896,6 +913,7 @@ CHIP_ERROR GroupDataProviderImpl::SetGroupInfoAt(chip::FabricIndex fabric_index,
 {
     VerifyOrReturnError(IsInitialized(), CHIP_ERROR_INTERNAL);
 
+    ScopedCacheInvalidation invalidation(*this, fabric_index);
     FabricData fabric(fabric_index);
     GroupData group;
 
@@ -962,6 +980,16 @@ CHIP_ERROR GroupDataProviderImpl::GetGroupInfoAt(chip::FabricIndex fabric_index,
 {
     VerifyOrReturnError(IsInitialized(), CHIP_ERROR_INTERNAL);
 
+    const CachedFabric * cache = GetCachedFabric(fabric_index);
+    if (cache != nullptr)
+    {
+        VerifyOrReturnError(index < cache->group_count, CHIP_ERROR_NOT_FOUND);
+
+        info.group_id = cache->groups[index].group_id;
+        info.SetName(cache->groups[index].name);
+        return CHIP_NO_ERROR;
+    }
+
     FabricData fabric(fabric_index);
     GroupData group;
 
@@ -978,6 +1006,7 @@ CHIP_ERROR GroupDataProviderImpl::RemoveGroupInfoAt(chip::FabricIndex fabric_ind
 {
     VerifyOrReturnError(IsInitialized(), CHIP_ERROR_INTERNAL);
 
+    ScopedCacheInvalidation invalidation(*this, fabric_index);
     FabricData fabric(fabric_index);
     GroupData group;
 
@@ -1025,6 +1054,12 @@ bool GroupDataProviderImpl::HasEndpoint(chip::FabricIndex fabric_index, chip::Gr
 {
     VerifyOrReturnError(IsInitialized(), false);
 
+    const CachedFabric * cache = GetCachedFabric(fabric_index);
+    if (cache != nullptr)
+    {
+        return cache->HasEndpoint(group_id, endpoint_id);
+    }
+
     FabricData fabric(fabric_index);
     GroupData group;
     EndpointData endpoint;
@@ -1038,6 +1073,7 @@ CHIP_ERROR GroupDataProviderImpl::AddEndpoint(chip::FabricIndex fabric_index, ch
 {
     VerifyOrReturnError(IsInitialized(), CHIP_ERROR_INTERNAL);
 
+    ScopedCacheInvalidation invalidation(*this, fabric_index);
     FabricData fabric(fabric_index);
     GroupData group;
 
@@ -1096,6 +1132,7 @@ CHIP_ERROR GroupDataProviderImpl::RemoveEndpoint(chip::FabricIndex fabric_index,
 {
     VerifyOrReturnError(IsInitialized(), CHIP_ERROR_INTERNAL);
 
+    ScopedCacheInvalidation invalidation(*this, fabric_index);
     FabricData fabric(fabric_index);
     GroupData group;
     EndpointData endpoint;
@@ -1139,6 +1176,18 @@ CHIP_ERROR GroupDataProviderImpl::RemoveEndpoint(chip::FabricIndex fabric_index,
 
     ReturnErrorOnFailure(fabric.Load(mStorage));
 
+    const CachedFabric * cache    = GetCachedFabric(fabric_index);
+    const GroupEndpoint * mapping = (cache != nullptr) ? cache->FindEndpoint(endpoint_id) : nullptr;
+    while ((cache != nullptr) && (mapping != nullptr))
+    {
+        // The removal drops the mirror, so look up the next group of the endpoint in the reloaded one
+        const GroupId group_id = mapping->group_id;
+        ReturnErrorOnFailure(RemoveEndpoint(fabric_index, group_id, endpoint_id));
+        cache   = GetCachedFabric(fabric_index);
+        mapping = (cache != nullptr) ? cache->FindEndpoint(endpoint_id, group_id + 1u) : nullptr;
+    }
+    VerifyOrReturnError(cache == nullptr, CHIP_NO_ERROR);
+
     GroupData group(fabric_index, fabric.first_group);
     size_t group_index = 0;
     EndpointData endpoint;
@@ -1219,6 +1268,28 @@ GroupDataProviderImpl::EndpointIteratorImpl::EndpointIteratorImpl(GroupDataProvi
     mProvider(provider),
     mFabric(fabric_index)
 {
+    const CachedFabric * cache = provider.GetCachedFabric(fabric_index);
+    if (cache != nullptr)
+    {
+        size_t first = 0;
+        size_t count = cache->endpoint_count;
+        if (group_id.has_value())
+        {
+            const CachedFabric::Group * group = cache->FindGroup(*group_id);
+            first                             = (nullptr != group) ? group->first_endpoint : 0;
+            count                             = (nullptr != group) ? group->endpoint_count : 0;
+        }
+
+        // Without memory for the copy, iterate from storage
+        if (count == 0 || mSnapshot.Alloc(count))
+        {
+            std::copy(cache->endpoints.Get() + first, cache->endpoints.Get() + first + count, mSnapshot.Get());
+            mSnapshotCount = count;
+            mUseSnapshot   = true;
+            return;
+        }
+    }
+
     FabricData fabric(fabric_index);
     VerifyOrReturn(CHIP_NO_ERROR == fabric.Load(provider.mStorage));
 
@@ -1248,6 +1319,11 @@ GroupDataProviderImpl::EndpointIteratorImpl::EndpointIteratorImpl(GroupDataProvi
 
 size_t GroupDataProviderImpl::EndpointIteratorImpl::Count()
 {
+    if (mUseSnapshot)
+    {
+        return mSnapshotCount;
+    }
+
     GroupData group(mFabric, mFirstGroup);
     size_t group_index    = 0;
     size_t endpoint_index = 0;
@@ -1277,6 +1353,13 @@ size_t GroupDataProviderImpl::EndpointIteratorImpl::Count()
 
 bool GroupDataProviderImpl::EndpointIteratorImpl::Next(GroupEndpoint & output)
 {
+    if (mUseSnapshot)
+    {
+        VerifyOrReturnValue(mSnapshotNext < mSnapshotCount, false);
+        output = mSnapshot[mSnapshotNext++];
+        return true;
+    }
+
     while (mGroupIndex < mGroupCount)
     {
         GroupData group(mFabric, mGroup);
@@ -1320,6 +1403,7 @@ CHIP_ERROR GroupDataProviderImpl::RemoveEndpoints(chip::FabricIndex fabric_index
 {
     VerifyOrReturnError(IsInitialized(), CHIP_ERROR_INTERNAL);
 
+    ScopedCacheInvalidation invalidation(*this, fabric_index);
     FabricData fabric(fabric_index);
     GroupData group;
 
@@ -1695,6 +1779,7 @@ void GroupDataProviderImpl::KeySetIteratorImpl::Release()
 
 CHIP_ERROR GroupDataProviderImpl::RemoveFabric(chip::FabricIndex fabric_index)
 {
+    ScopedCacheInvalidation invalidation(*this, fabric_index);
     FabricData fabric(fabric_index);
 
     // Fabric data defaults to zero, so if not entry is found, no mappings, or keys are removed
@@ -1737,6 +1822,185 @@ CHIP_ERROR GroupDataProviderImpl::RemoveFabric(chip::FabricIndex fabric_index)
     return fabric.Delete(mStorage);
 }
 
+//
+// Group membership cache
+//
+
+static bool EndpointMappingLess(const GroupEndpoint & a, const GroupEndpoint & b)
+{
+    return (a.endpoint_id < b.endpoint_id) || ((a.endpoint_id == b.endpoint_id) && (a.group_id < b.group_id));
+}
+
+const GroupDataProviderImpl::CachedFabric::Group * GroupDataProviderImpl::CachedFabric::FindGroup(GroupId group_id) const
+{
+    const uint16_t * first = groups_by_id.Get();
+    const uint16_t * last  = first + group_count;
+    const uint16_t * found =
+        std::lower_bound(first, last, group_id, [this](uint16_t index, GroupId id) { return groups[index].group_id < id; });
+    VerifyOrReturnValue(found != last && groups[*found].group_id == group_id, nullptr);
+    return &groups[*found];
+}
+
+const GroupEndpoint * GroupDataProviderImpl::CachedFabric::FindEndpoint(EndpointId endpoint_id, uint32_t min_group_id) const
+{
+    VerifyOrReturnValue(min_group_id <= std::numeric_limits<GroupId>::max(), nullptr);
+
+    const GroupEndpoint * first = endpoints_by_id.Get();
+    const GroupEndpoint * last  = first + endpoint_count;
+    const GroupEndpoint * found =
+        std::lower_bound(first, last, GroupEndpoint(static_cast<GroupId>(min_group_id), endpoint_id), EndpointMappingLess);
+    VerifyOrReturnValue(found != last && found->endpoint_id == endpoint_id, nullptr);
+    return found;
+}
+
+bool GroupDataProviderImpl::CachedFabric::HasEndpoint(GroupId group_id, EndpointId endpoint_id) const
+{
+    const GroupEndpoint * mapping = FindEndpoint(endpoint_id, group_id);
+    return (mapping != nullptr) && (mapping->group_id == group_id);
+}
+
+void GroupDataProviderImpl::CachedFabric::Clear()
+{
+    fabric_index   = kUndefinedFabricIndex;
+    group_count    = 0;
+    endpoint_count = 0;
+    groups.Free();
+    groups_by_id.Free();
+    endpoints.Free();
+    endpoints_by_id.Free();
+}
+
+const GroupDataProviderImpl::CachedFabric * GroupDataProviderImpl::GetCachedFabric(chip::FabricIndex fabric_index)
+{
+#if CHIP_CONFIG_GROUP_DATA_CACHED_FABRICS > 0
+    VerifyOrReturnValue(IsInitialized() && kUndefinedFabricIndex != fabric_index, nullptr);
+
+    CachedFabric * entry = nullptr;
+    for (CachedFabric & cached : mCachedFabrics)
+    {
+        if (cached.fabric_index == fabric_index)
+        {
+            return &cached;
+        }
+        if (entry == nullptr && cached.fabric_index == kUndefinedFabricIndex)
+        {
+            entry = &cached;
+        }
+    }
+
+    if (entry == nullptr)
+    {
+        // All entries in use, replace them in turn
+        entry              = &mCachedFabrics[mNextCacheEviction];
+        mNextCacheEviction = (mNextCacheEviction + 1) % CHIP_CONFIG_GROUP_DATA_CACHED_FABRICS;
+        entry->Clear();
+    }
+
+    CHIP_ERROR err = LoadCachedFabric(fabric_index, *entry);
+    if (CHIP_NO_ERROR != err)
+    {
+        // Serve this lookup from storage, and try again on the next one
+        ChipLogError(FabricProvisioning, "Failed to cache groups of fabric %u: %" CHIP_ERROR_FORMAT, fabric_index, err.Format());
+        entry->Clear();
+        return nullptr;
+    }
+    return entry;
+#else
+    return nullptr;
+#endif
+}
+
+CHIP_ERROR GroupDataProviderImpl::LoadCachedFabric(chip::FabricIndex fabric_index, CachedFabric & entry)
+{
+    FabricData fabric(fabric_index);
+
+    // Load fabric, defaults to zero
+    CHIP_ERROR err = fabric.Load(mStorage);
+    VerifyOrReturnError(CHIP_NO_ERROR == err || CHIP_ERROR_NOT_FOUND == err, err);
+
+    // Groups, in list order. As in the iterators, the lists end at the first entry that fails to load.
+    Platform::ScopedMemoryBuffer<EndpointId> first_endpoints;
+    if (fabric.group_count > 0)
+    {
+        entry.groups.Calloc(fabric.group_count);
+        entry.groups_by_id.Calloc(fabric.group_count);
+        first_endpoints.Calloc(fabric.group_count);
+        VerifyOrReturnError(entry.groups && entry.groups_by_id && first_endpoints, CHIP_ERROR_NO_MEMORY);
+    }
+
+    GroupData group(fabric_index, fabric.first_group);
+    size_t endpoint_total = 0;
+    while (entry.group_count < fabric.group_count && CHIP_NO_ERROR == group.Load(mStorage))
+    {
+        CachedFabric::Group & cached = entry.groups[entry.group_count];
+        cached.group_id              = group.group_id;
+        cached.endpoint_count        = group.endpoint_count;
+        Platform::CopyString(cached.name, group.name);
+
+        first_endpoints[entry.group_count]    = group.first_endpoint;
+        entry.groups_by_id[entry.group_count] = static_cast<uint16_t>(entry.group_count);
+        endpoint_total += group.endpoint_count;
+        entry.group_count++;
+        group.group_id = group.next;
+    }
+
+    // Endpoints, grouped by group in list order
+    if (endpoint_total > 0)
+    {
+        entry.endpoints.Calloc(endpoint_total);
+        entry.endpoints_by_id.Calloc(endpoint_total);
+        VerifyOrReturnError(entry.endpoints && entry.endpoints_by_id, CHIP_ERROR_NO_MEMORY);
+    }
+
+    for (size_t i = 0; i < entry.group_count; i++)
+    {
+        CachedFabric::Group & cached = entry.groups[i];
+        EndpointData endpoint(fabric_index, cached.group_id, first_endpoints[i]);
+        uint16_t count = 0;
+
+        cached.first_endpoint = entry.endpoint_count;
+        while (count < cached.endpoint_count && CHIP_NO_ERROR == endpoint.Load(mStorage))
+        {
+            entry.endpoints[entry.endpoint_count++] = GroupEndpoint(cached.group_id, endpoint.endpoint_id);
+            endpoint.endpoint_id                    = endpoint.next;
+            count++;
+        }
+        cached.endpoint_count = count;
+    }
+
+    // Indexes
+    std::sort(entry.groups_by_id.Get(), entry.groups_by_id.Get() + entry.group_count,
+              [&entry](uint16_t a, uint16_t b) { return entry.groups[a].group_id < entry.groups[b].group_id; });
+    std::copy(entry.endpoints.Get(), entry.endpoints.Get() + entry.endpoint_count, entry.endpoints_by_id.Get());
+    std::sort(entry.endpoints_by_id.Get(), entry.endpoints_by_id.Get() + entry.endpoint_count, EndpointMappingLess);
+
+    entry.fabric_index = fabric_index;
+    return CHIP_NO_ERROR;
+}
+
+void GroupDataProviderImpl::InvalidateCachedFabric(chip::FabricIndex fabric_index)
+{
+#if CHIP_CONFIG_GROUP_DATA_CACHED_FABRICS > 0
+    for (CachedFabric & cached : mCachedFabrics)
+    {
+        if (cached.fabric_index == fabric_index)
+        {
+            cached.Clear();
+        }
+    }
+#endif
+}
+
+void GroupDataProviderImpl::InvalidateCachedFabrics()
+{
+#if CHIP_CONFIG_GROUP_DATA_CACHED_FABRICS > 0
+    for (CachedFabric & cached : mCachedFabrics)
+    {
+        cached.Clear();
+    }
+#endif
+}
+
 //
 // Cryptography
 //
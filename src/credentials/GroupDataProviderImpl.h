@@ -18,8 +18,10 @@
 
 #include <credentials/GroupDataProvider.h>
 #include <crypto/SessionKeystore.h>
+#include <lib/core/CHIPConfig.h>
 #include <lib/core/CHIPPersistentStorageDelegate.h>
 #include <lib/support/Pool.h>
+#include <lib/support/ScopedBuffer.h>
 
 namespace chip {
 namespace Credentials {
@@ -149,6 +151,13 @@ protected:
         size_t mEndpointIndex = 0;
         size_t mEndpointCount = 0;
         bool mFirstEndpoint   = true;
+
+        // Endpoints copied from the mirror of the fabric when the iterator is created. Changes made while
+        // iterating, e.g. by a group command removing the group from an endpoint, do not affect the iteration.
+        bool mUseSnapshot     = false;
+        size_t mSnapshotNext  = 0;
+        size_t mSnapshotCount = 0;
+        Platform::ScopedMemoryBuffer<GroupEndpoint> mSnapshot;
     };
 
     class GroupKeyContext : public Crypto::SymmetricKeyContext
@@ -243,9 +252,67 @@ protected:
         bool mFirstMap           = true;
         GroupKeyContext mGroupKeyContext;
     };
+
+    /**
+     * In-memory mirror of the groups and endpoints of a fabric, loaded from storage on first use.
+     *
+     * Groups and endpoints are kept in storage order, which is the order of the iterators, along with
+     * indexes sorted by group id and by (endpoint id, group id) for lookups.
+     */
+    struct CachedFabric
+    {
+        struct Group
+        {
+            GroupId group_id;
+            uint16_t endpoint_count;
+            size_t first_endpoint; // Position of the first endpoint of the group in endpoints
+            char name[GroupInfo::kGroupNameMax + 1];
+        };
+
+        const Group * FindGroup(GroupId group_id) const;
+        // Returns the mapping of the given endpoint with the lowest group id not below min_group_id, if any.
+        const GroupEndpoint * FindEndpoint(EndpointId endpoint_id, uint32_t min_group_id = 0) const;
+        bool HasEndpoint(GroupId group_id, EndpointId endpoint_id) const;
+        void Clear();
+
+        FabricIndex fabric_index = kUndefinedFabricIndex;
+        size_t group_count       = 0;
+        size_t endpoint_count    = 0;
+        Platform::ScopedMemoryBuffer<Group> groups;
+        Platform::ScopedMemoryBuffer<uint16_t> groups_by_id;
+        Platform::ScopedMemoryBuffer<GroupEndpoint> endpoints;
+        Platform::ScopedMemoryBuffer<GroupEndpoint> endpoints_by_id;
+    };
+
+    /**
+     * Drops the mirror of a fabric around a change of its groups or endpoints. The change is written to
+     * storage as before, and the mirror is loaded again, with the change, on the next lookup.
+     */
+    class ScopedCacheInvalidation
+    {
+    public:
+        ScopedCacheInvalidation(GroupDataProviderImpl & provider, FabricIndex fabric_index) :
+            mProvider(provider),
+            mFabric(fabric_index)
+        {
+            mProvider.InvalidateCachedFabric(mFabric);
+        }
+        ~ScopedCacheInvalidation() { mProvider.InvalidateCachedFabric(mFabric); }
+
+    private:
+        GroupDataProviderImpl & mProvider;
+        FabricIndex mFabric;
+    };
+
     bool IsInitialized() { return (mStorage != nullptr); }
     CHIP_ERROR RemoveEndpoints(FabricIndex fabric_index, GroupId group_id);
 
+    // Returns the mirror of the fabric, or nullptr if the fabric must be read from storage.
+    const CachedFabric * GetCachedFabric(FabricIndex fabric_index);
+    CHIP_ERROR LoadCachedFabric(FabricIndex fabric_index, CachedFabric & entry);
+    void InvalidateCachedFabric(FabricIndex fabric_index);
+    void InvalidateCachedFabrics();
+
     PersistentStorageDelegate * mStorage       = nullptr;
     Crypto::SessionKeystore * mSessionKeystore = nullptr;
     ObjectPool<GroupInfoIteratorImpl, kIteratorsMax> mGroupInfoIterators;
@@ -254,6 +321,10 @@ protected:
     ObjectPool<KeySetIteratorImpl, kIteratorsMax> mKeySetIterators;
     ObjectPool<GroupSessionIteratorImpl, kIteratorsMax> mGroupSessionsIterator;
     ObjectPool<GroupKeyContext, kIteratorsMax> mGroupKeyContexPool;
+#if CHIP_CONFIG_GROUP_DATA_CACHED_FABRICS > 0
+    CachedFabric mCachedFabrics[CHIP_CONFIG_GROUP_DATA_CACHED_FABRICS];
+    size_t mNextCacheEviction = 0;
+#endif
 };
 
 } // namespace Credentials
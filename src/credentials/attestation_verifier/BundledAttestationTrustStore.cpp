@@ -0,0 +1,256 @@
+/*
+ *
+ *    Copyright (c) 2024 Project CHIP Authors
+ *
+ *    Licensed under the Apache License, Version 2.0 (the "License");
+ *    you may not use this file except in compliance with the License.
+ *    You may obtain a copy of the License at
+ *
+ *        http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *    Unless required by applicable law or agreed to in writing, software
+ *    distributed under the License is distributed on an "AS IS" BASIS,
+ *    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *    See the License for the specific language governing permissions and
+ *    limitations under the License.
+ */
+#include "BundledAttestationTrustStore.h"
+
+#include <credentials/CHIPCert.h>
+#include <lib/core/CHIPEncoding.h>
+#include <lib/support/CodeUtils.h>
+#include <lib/support/SafeInt.h>
+
+#include <algorithm>
+#include <array>
+#include <cstdio>
+#include <cstring>
+
+extern "C" {
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+}
+
+namespace chip {
+namespace Credentials {
+
+using namespace chip::Encoding;
+
+namespace {
+
+using Skid = std::array<uint8_t, Crypto::kSubjectKeyIdentifierLength>;
+
+bool IsValidPAA(const ByteSpan & cert, Skid & outSkid)
+{
+    VerifyOrReturnValue(VerifyAttestationCertificateFormat(cert, Crypto::AttestationCertType::kPAA) == CHIP_NO_ERROR, false);
+
+    MutableByteSpan skidSpan{ outSkid.data(), outSkid.size() };
+    VerifyOrReturnValue(Crypto::ExtractSKIDFromX509Cert(cert, skidSpan) == CHIP_NO_ERROR, false);
+    return skidSpan.size() == outSkid.size();
+}
+
+} // namespace
+
+CHIP_ERROR WritePAABundle(const std::vector<std::vector<uint8_t>> & paaDerCerts, const char * bundlePath, size_t & outEntryCount)
+{
+    VerifyOrReturnError(bundlePath != nullptr, CHIP_ERROR_INVALID_ARGUMENT);
+
+    struct Entry
+    {
+        Skid skid;
+        const std::vector<uint8_t> * cert;
+    };
+
+    std::vector<Entry> entries;
+    entries.reserve(paaDerCerts.size());
+    for (const auto & cert : paaDerCerts)
+    {
+        Entry entry{ {}, &cert };
+        if (IsValidPAA(ByteSpan{ cert.data(), cert.size() }, entry.skid))
+        {
+            entries.push_back(entry);
+        }
+    }
+
+    // Sort by SKID for binary search, keeping the first certificate for duplicate SKIDs.
+    std::stable_sort(entries.begin(), entries.end(), [](const Entry & a, const Entry & b) { return a.skid < b.skid; });
+    entries.erase(std::unique(entries.begin(), entries.end(), [](const Entry & a, const Entry & b) { return a.skid == b.skid; }),
+                  entries.end());
+    VerifyOrReturnError(entries.size() <= PAABundle::kMaxEntryCount, CHIP_ERROR_INVALID_ARGUMENT);
+
+    std::vector<uint8_t> header(PAABundle::kHeaderLength + entries.size() * PAABundle::kIndexEntryLength, 0);
+    uint8_t * p = header.data();
+    memcpy(p, PAABundle::kMagic, sizeof(PAABundle::kMagic));
+    LittleEndian::Put16(p + 4, PAABundle::kVersion);
+    LittleEndian::Put32(p + 8, static_cast<uint32_t>(entries.size()));
+
+    size_t offset = header.size();
+    p += PAABundle::kHeaderLength;
+    for (const auto & entry : entries)
+    {
+        VerifyOrReturnError(CanCastTo<uint32_t>(offset + entry.cert->size()), CHIP_ERROR_BUFFER_TOO_SMALL);
+        memcpy(p, entry.skid.data(), entry.skid.size());
+        LittleEndian::Put32(p + entry.skid.size(), static_cast<uint32_t>(offset));
+        LittleEndian::Put32(p + entry.skid.size() + sizeof(uint32_t), static_cast<uint32_t>(entry.cert->size()));
+        p += PAABundle::kIndexEntryLength;
+        offset += entry.cert->size();
+    }
+
+    FILE * file = fopen(bundlePath, "wb");
+    VerifyOrReturnError(file != nullptr, CHIP_ERROR_OPEN_FAILED);
+
+    bool ok = (fwrite(header.data(), 1, header.size(), file) == header.size());
+    for (const auto & entry : entries)
+    {
+        ok = ok && (fwrite(entry.cert->data(), 1, entry.cert->size(), file) == entry.cert->size());
+    }
+    ok = (fclose(file) == 0) && ok;
+    VerifyOrReturnError(ok, CHIP_ERROR_WRITE_FAILED);
+
+    outEntryCount = entries.size();
+    return CHIP_NO_ERROR;
+}
+
+BundledAttestationTrustStore::BundledAttestationTrustStore(const char * paaBundlePath)
+{
+    VerifyOrReturn(paaBundlePath != nullptr);
+
+    int fd = open(paaBundlePath, O_RDONLY);
+    VerifyOrReturn(fd >= 0);
+
+    struct stat fileStat;
+    if (fstat(fd, &fileStat) != 0 || fileStat.st_size < static_cast<off_t>(PAABundle::kHeaderLength))
+    {
+        close(fd);
+        return;
+    }
+
+    size_t length  = static_cast<size_t>(fileStat.st_size);
+    void * mapping = mmap(nullptr, length, PROT_READ, MAP_PRIVATE, fd, 0);
+    // The mapping stays valid after the descriptor is closed.
+    close(fd);
+    VerifyOrReturn(mapping != MAP_FAILED);
+
+    mMapping       = static_cast<const uint8_t *>(mapping);
+    mMappingLength = length;
+
+    // Only the header and index are checked here; the certificates themselves are validated on first use.
+    VerifyOrReturn(memcmp(mMapping, PAABundle::kMagic, sizeof(PAABundle::kMagic)) == 0, Cleanup());
+    VerifyOrReturn(LittleEndian::Get16(mMapping + 4) == PAABundle::kVersion, Cleanup());
+
+    uint32_t entryCount = LittleEndian::Get32(mMapping + 8);
+    VerifyOrReturn(entryCount <= PAABundle::kMaxEntryCount, Cleanup());
+    VerifyOrReturn(PAABundle::kHeaderLength + entryCount * PAABundle::kIndexEntryLength <= mMappingLength, Cleanup());
+    mEntryCount = entryCount;
+
+    for (size_t i = 0; i < mEntryCount; i++)
+    {
+        const uint8_t * entry = IndexEntry(i);
+        uint64_t offset       = LittleEndian::Get32(entry + Crypto::kSubjectKeyIdentifierLength);
+        uint64_t certLength   = LittleEndian::Get32(entry + Crypto::kSubjectKeyIdentifierLength + sizeof(uint32_t));
+        VerifyOrReturn(certLength > 0 && certLength <= kMaxDERCertLength && offset + certLength <= mMappingLength, Cleanup());
+        if (i > 0)
+        {
+            VerifyOrReturn(memcmp(IndexEntry(i - 1), entry, Crypto::kSubjectKeyIdentifierLength) < 0, Cleanup());
+        }
+    }
+
+    mEntryStates.assign(mEntryCount, EntryState::kUnchecked);
+    mIsInitialized = true;
+}
+
+BundledAttestationTrustStore::~BundledAttestationTrustStore()
+{
+    Cleanup();
+}
+
+void BundledAttestationTrustStore::Cleanup()
+{
+    if (mMapping != nullptr)
+    {
+        munmap(const_cast<uint8_t *>(mMapping), mMappingLength);
+    }
+    mMapping       = nullptr;
+    mMappingLength = 0;
+    mEntryCount    = 0;
+    mEntryStates.clear();
+    mIsInitialized = false;
+}
+
+const uint8_t * BundledAttestationTrustStore::IndexEntry(size_t index) const
+{
+    return mMapping + PAABundle::kHeaderLength + index * PAABundle::kIndexEntryLength;
+}
+
+bool BundledAttestationTrustStore::FindEntry(const ByteSpan & skid, size_t & outIndex) const
+{
+    size_t low  = 0;
+    size_t high = mEntryCount;
+    while (low < high)
+    {
+        size_t mid = low + (high - low) / 2;
+        int cmp    = memcmp(IndexEntry(mid), skid.data(), Crypto::kSubjectKeyIdentifierLength);
+        if (cmp == 0)
+        {
+            outIndex = mid;
+            return true;
+        }
+        if (cmp < 0)
+        {
+            low = mid + 1;
+        }
+        else
+        {
+            high = mid;
+        }
+    }
+    return false;
+}
+
+bool BundledAttestationTrustStore::ValidateEntry(size_t index, ByteSpan & outCert) const
+{
+    const uint8_t * entry = IndexEntry(index);
+    uint32_t offset       = LittleEndian::Get32(entry + Crypto::kSubjectKeyIdentifierLength);
+    uint32_t certLength   = LittleEndian::Get32(entry + Crypto::kSubjectKeyIdentifierLength + sizeof(uint32_t));
+    outCert               = ByteSpan(mMapping + offset, certLength);
+
+    if (mEntryStates[index] == EntryState::kUnchecked)
+    {
+        // The indexed SKID must be the one in the certificate, otherwise a corrupted bundle could make us
+        // return a different PAA than the one requested.
+        Skid certSkid;
+        bool valid = IsValidPAA(outCert, certSkid) && memcmp(certSkid.data(), entry, certSkid.size()) == 0;
+
+        mEntryStates[index] = valid ? EntryState::kValid : EntryState::kInvalid;
+    }
+
+    return mEntryStates[index] == EntryState::kValid;
+}
+
+CHIP_ERROR BundledAttestationTrustStore::GetProductAttestationAuthorityCert(const ByteSpan & skid,
+                                                                            MutableByteSpan & outPaaDerBuffer) const
+{
+    // Same contract as FileAttestationTrustStore: an empty store lets the DefaultAttestationVerifier fall back to the
+    // testing trust store.
+    if (mIsInitialized && paaCount() == 0)
+    {
+        return CHIP_ERROR_NOT_IMPLEMENTED;
+    }
+
+    VerifyOrReturnError(mIsInitialized, CHIP_ERROR_CA_CERT_NOT_FOUND);
+    VerifyOrReturnError(!skid.empty() && (skid.data() != nullptr), CHIP_ERROR_INVALID_ARGUMENT);
+    VerifyOrReturnError(skid.size() == Crypto::kSubjectKeyIdentifierLength, CHIP_ERROR_INVALID_ARGUMENT);
+
+    size_t index = 0;
+    VerifyOrReturnError(FindEntry(skid, index), CHIP_ERROR_CA_CERT_NOT_FOUND);
+
+    ByteSpan cert;
+    VerifyOrReturnError(ValidateEntry(index, cert), CHIP_ERROR_CA_CERT_NOT_FOUND);
+
+    return CopySpanToMutableSpan(cert, outPaaDerBuffer);
+}
+
+} // namespace Credentials
+} // namespace chip
@@ -0,0 +1,103 @@
+/*
+ *
+ *    Copyright (c) 2024 Project CHIP Authors
+ *
+ *    Licensed under the Apache License, Version 2.0 (the "License");
+ *    you may not use this file except in compliance with the License.
+ *    You may obtain a copy of the License at
+ *
+ *        http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *    Unless required by applicable law or agreed to in writing, software
+ *    distributed under the License is distributed on an "AS IS" BASIS,
+ *    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *    See the License for the specific language governing permissions and
+ *    limitations under the License.
+ */
+#pragma once
+
+#include <credentials/attestation_verifier/DeviceAttestationVerifier.h>
+#include <crypto/CHIPCryptoPAL.h>
+
+#include <vector>
+
+namespace chip {
+namespace Credentials {
+
+/**
+ * PAA bundle file layout. All integers are little-endian.
+ *
+ *   Header (16 bytes):
+ *     magic[4]       "MPAB"
+ *     version        uint16
+ *     reserved       uint16
+ *     entryCount     uint32
+ *     reserved       uint32
+ *   Index (entryCount * 28 bytes), sorted by SKID:
+ *     skid[20]
+ *     offset         uint32, from start of file
+ *     length         uint32
+ *   Certificate data: DER certificates referenced by the index.
+ */
+namespace PAABundle {
+
+inline constexpr uint8_t kMagic[]         = { 'M', 'P', 'A', 'B' };
+inline constexpr uint16_t kVersion        = 1;
+inline constexpr size_t kHeaderLength     = 16;
+inline constexpr size_t kIndexEntryLength = Crypto::kSubjectKeyIdentifierLength + 2 * sizeof(uint32_t);
+inline constexpr uint32_t kMaxEntryCount  = 0x10000;
+
+} // namespace PAABundle
+
+/**
+ * @brief Write a PAA bundle file from a set of DER-encoded PAA certificates.
+ *
+ * Certificates that are not valid PAAs are skipped. If several certificates share a SKID, the first one wins.
+ *
+ * @param paaDerCerts    DER certificates, e.g. as returned by LoadAllX509DerCerts().
+ * @param bundlePath     Output file path.
+ * @param outEntryCount  Number of certificates actually written to the bundle.
+ */
+CHIP_ERROR WritePAABundle(const std::vector<std::vector<uint8_t>> & paaDerCerts, const char * bundlePath, size_t & outEntryCount);
+
+/**
+ * An AttestationTrustStore backed by a single memory-mapped PAA bundle file (see PAABundle).
+ *
+ * Construction only maps the file and checks the header and index bounds; certificates are looked up by binary search over
+ * the SKID-sorted index, and each certificate is validated the first time it is returned.
+ */
+class BundledAttestationTrustStore : public AttestationTrustStore
+{
+public:
+    BundledAttestationTrustStore(const char * paaBundlePath = nullptr);
+    ~BundledAttestationTrustStore();
+
+    CHIP_ERROR GetProductAttestationAuthorityCert(const ByteSpan & skid, MutableByteSpan & outPaaDerBuffer) const override;
+
+    bool IsInitialized() const { return mIsInitialized; }
+    size_t paaCount() const { return mEntryCount; }
+
+private:
+    enum class EntryState : uint8_t
+    {
+        kUnchecked,
+        kValid,
+        kInvalid,
+    };
+
+    const uint8_t * IndexEntry(size_t index) const;
+    bool FindEntry(const ByteSpan & skid, size_t & outIndex) const;
+    bool ValidateEntry(size_t index, ByteSpan & outCert) const;
+    void Cleanup();
+
+    const uint8_t * mMapping = nullptr;
+    size_t mMappingLength    = 0;
+    size_t mEntryCount       = 0;
+    bool mIsInitialized      = false;
+
+    // Validation results, filled in lazily on lookup.
+    mutable std::vector<EntryState> mEntryStates;
+};
+
+} // namespace Credentials
+} // namespace chip
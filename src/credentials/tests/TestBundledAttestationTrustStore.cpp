@@ -0,0 +1,122 @@
+/*
+ *
+ *    Copyright (c) 2024 Project CHIP Authors
+ *    All rights reserved.
+ *
+ *    Licensed under the Apache License, Version 2.0 (the "License");
+ *    you may not use this file except in compliance with the License.
+ *    You may obtain a copy of the License at
+ *
+ *        http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *    Unless required by applicable law or agreed to in writing, software
+ *    distributed under the License is distributed on an "AS IS" BASIS,
+ *    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *    See the License for the specific language governing permissions and
+ *    limitations under the License.
+ */
+
+#include <pw_unit_test/framework.h>
+
+#include <credentials/attestation_verifier/BundledAttestationTrustStore.h>
+#include <credentials/attestation_verifier/TestPAAStore.h>
+#include <crypto/CHIPCryptoPAL.h>
+#include <lib/core/CHIPError.h>
+#include <lib/core/StringBuilderAdapters.h>
+#include <lib/support/CHIPMem.h>
+#include <lib/support/Span.h>
+
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+#include <unistd.h>
+#include <vector>
+
+using namespace chip;
+using namespace chip::Credentials;
+
+namespace {
+
+std::vector<uint8_t> ToVector(const ByteSpan & span)
+{
+    return std::vector<uint8_t>(span.data(), span.data() + span.size());
+}
+
+struct TestBundledAttestationTrustStore : public ::testing::Test
+{
+    static void SetUpTestSuite() { ASSERT_EQ(chip::Platform::MemoryInit(), CHIP_NO_ERROR); }
+
+    static void TearDownTestSuite() { chip::Platform::MemoryShutdown(); }
+
+    void SetUp() override
+    {
+        char path[] = "/tmp/paa-bundle-XXXXXX";
+        int fd      = mkstemp(path);
+        ASSERT_GE(fd, 0);
+        close(fd);
+        mBundlePath = path;
+    }
+
+    void TearDown() override { unlink(mBundlePath.c_str()); }
+
+    std::string mBundlePath;
+};
+
+TEST_F(TestBundledAttestationTrustStore, TestLookupBySkid)
+{
+    // Include a duplicate and a non-certificate, both of which should be dropped from the bundle.
+    std::vector<std::vector<uint8_t>> certs = {
+        ToVector(sTestCert_PAA_NoVID_Cert),
+        ToVector(sTestCert_PAA_FFF1_Cert),
+        ToVector(sTestCert_PAA_FFF1_Cert),
+        { 0x01, 0x02, 0x03 },
+    };
+
+    size_t entryCount = 0;
+    EXPECT_EQ(WritePAABundle(certs, mBundlePath.c_str(), entryCount), CHIP_NO_ERROR);
+    EXPECT_EQ(entryCount, 2u);
+
+    BundledAttestationTrustStore store(mBundlePath.c_str());
+    EXPECT_TRUE(store.IsInitialized());
+    EXPECT_EQ(store.paaCount(), 2u);
+
+    for (const ByteSpan & expected : { sTestCert_PAA_FFF1_Cert, sTestCert_PAA_NoVID_Cert })
+    {
+        uint8_t skidBuf[Crypto::kSubjectKeyIdentifierLength];
+        MutableByteSpan skid(skidBuf);
+        EXPECT_EQ(Crypto::ExtractSKIDFromX509Cert(expected, skid), CHIP_NO_ERROR);
+
+        // Look up twice to cover both the first-use validation and the cached result.
+        for (int i = 0; i < 2; i++)
+        {
+            uint8_t certBuf[kMaxDERCertLength];
+            MutableByteSpan cert(certBuf);
+            EXPECT_EQ(store.GetProductAttestationAuthorityCert(skid, cert), CHIP_NO_ERROR);
+            EXPECT_TRUE(cert.data_equal(expected));
+        }
+    }
+
+    uint8_t unknownSkid[Crypto::kSubjectKeyIdentifierLength] = { 0 };
+    uint8_t certBuf[kMaxDERCertLength];
+    MutableByteSpan cert(certBuf);
+    EXPECT_EQ(store.GetProductAttestationAuthorityCert(ByteSpan(unknownSkid), cert), CHIP_ERROR_CA_CERT_NOT_FOUND);
+    EXPECT_EQ(store.GetProductAttestationAuthorityCert(ByteSpan(unknownSkid, 4), cert), CHIP_ERROR_INVALID_ARGUMENT);
+}
+
+TEST_F(TestBundledAttestationTrustStore, TestRejectsCorruptBundle)
+{
+    FILE * file = fopen(mBundlePath.c_str(), "wb");
+    ASSERT_NE(file, nullptr);
+    const uint8_t garbage[32] = { 'N', 'O', 'P', 'E' };
+    EXPECT_EQ(fwrite(garbage, 1, sizeof(garbage), file), sizeof(garbage));
+    fclose(file);
+
+    BundledAttestationTrustStore store(mBundlePath.c_str());
+    EXPECT_FALSE(store.IsInitialized());
+    EXPECT_EQ(store.paaCount(), 0u);
+
+    BundledAttestationTrustStore missing("/nonexistent/paa-bundle.bin");
+    EXPECT_FALSE(missing.IsInitialized());
+}
+
+} // namespace
@@ -37,6 +37,10 @@
 #include <lib/support/CHIPMem.h>
 #include <lib/support/CodeUtils.h>
 
+#if CHIP_SYSTEM_CONFIG_POSIX_LOCKING
+#include <thread>
+#endif
+
 #include "CHIPCert_error_test_vectors.h"
 #include "CHIPCert_test_vectors.h"
 
@@ -833,6 +837,100 @@ TEST_F(TestChipCert, TestChipCert_CertValidTime)
     certSet.Release();
 }
 
+TEST_F(TestChipCert, TestChipCert_CertSignatureCache)
+{
+    ChipCertificateSet certSet;
+    ValidationContext validContext;
+
+    EXPECT_EQ(certSet.Init(kStandardCertsCount), CHIP_NO_ERROR);
+    EXPECT_EQ(LoadTestCertSet01(certSet), CHIP_NO_ERROR);
+
+    validContext.Reset();
+    validContext.mRequiredKeyUsages.Set(KeyUsageFlags::kDigitalSignature);
+    validContext.mRequiredKeyPurposes.Set(KeyPurposeFlags::kServerAuth);
+    validContext.mRequiredKeyPurposes.Set(KeyPurposeFlags::kClientAuth);
+    ClearTimeSource(validContext);
+
+    ClearCertSignatureCache();
+    ResetCertSignatureCacheStats();
+
+    // The first validation verifies the ICA signature and caches it; the NOC signature is never cached.
+    EXPECT_EQ(certSet.ValidateCert(certSet.GetLastCert(), validContext), CHIP_NO_ERROR);
+    EXPECT_EQ(GetCertSignatureCacheStats().hits, 0u);
+    EXPECT_EQ(GetCertSignatureCacheStats().misses, 1u);
+
+    // Subsequent validations of chains through the same ICA hit the cache.
+    for (int i = 0; i < 3; i++)
+    {
+        EXPECT_EQ(certSet.ValidateCert(certSet.GetLastCert(), validContext), CHIP_NO_ERROR);
+    }
+    EXPECT_EQ(GetCertSignatureCacheStats().hits, 3u);
+    EXPECT_EQ(GetCertSignatureCacheStats().misses, 1u);
+
+    // Clearing the cache forces the ICA signature to be verified again.
+    ClearCertSignatureCache();
+    EXPECT_EQ(certSet.ValidateCert(certSet.GetLastCert(), validContext), CHIP_NO_ERROR);
+    EXPECT_EQ(GetCertSignatureCacheStats().misses, 2u);
+
+    // A tampered ICA signature must not be accepted, whatever is cached.
+    ChipCertificateData & icaCert = const_cast<ChipCertificateData &>(certSet.GetCertSet()[1]);
+    uint8_t tamperedSignature[kP256_ECDSA_Signature_Length_Raw];
+    memcpy(tamperedSignature, icaCert.mSignature.data(), sizeof(tamperedSignature));
+    tamperedSignature[10] ^= 0x01;
+    icaCert.mSignature = P256ECDSASignatureSpan(tamperedSignature);
+    EXPECT_NE(certSet.ValidateCert(certSet.GetLastCert(), validContext), CHIP_NO_ERROR);
+
+    ClearCertSignatureCache();
+}
+
+#if CHIP_SYSTEM_CONFIG_POSIX_LOCKING
+TEST_F(TestChipCert, TestChipCert_CertSignatureCacheConcurrentValidation)
+{
+    // Chains are validated on the Matter thread and on the CASE background thread at the same time.
+    constexpr int kThreads     = 2;
+    constexpr int kValidations = 50;
+
+    ChipCertificateSet certSets[kThreads];
+    for (auto & certSet : certSets)
+    {
+        EXPECT_EQ(certSet.Init(kStandardCertsCount), CHIP_NO_ERROR);
+        EXPECT_EQ(LoadTestCertSet01(certSet), CHIP_NO_ERROR);
+    }
+
+    ClearCertSignatureCache();
+    ResetCertSignatureCacheStats();
+
+    std::thread threads[kThreads];
+    for (int i = 0; i < kThreads; i++)
+    {
+        threads[i] = std::thread([&certSet = certSets[i]]() {
+            ValidationContext validContext;
+            validContext.Reset();
+            validContext.mRequiredKeyUsages.Set(KeyUsageFlags::kDigitalSignature);
+            validContext.mRequiredKeyPurposes.Set(KeyPurposeFlags::kServerAuth);
+            validContext.mRequiredKeyPurposes.Set(KeyPurposeFlags::kClientAuth);
+            ClearTimeSource(validContext);
+
+            for (int j = 0; j < kValidations; j++)
+            {
+                EXPECT_EQ(certSet.ValidateCert(certSet.GetLastCert(), validContext), CHIP_NO_ERROR);
+            }
+        });
+    }
+    for (auto & thread : threads)
+    {
+        thread.join();
+    }
+
+    const CertSignatureCacheStats stats = GetCertSignatureCacheStats();
+    EXPECT_EQ(stats.hits + stats.misses, static_cast<uint32_t>(kThreads * kValidations));
+    EXPECT_GE(stats.misses, 1u);
+    EXPECT_LE(stats.misses, static_cast<uint32_t>(kThreads));
+
+    ClearCertSignatureCache();
+}
+#endif // CHIP_SYSTEM_CONFIG_POSIX_LOCKING
+
 TEST_F(TestChipCert, TestChipCert_ValidateChipRCAC)
 {
     struct RCACTestCase
@@ -20,6 +20,7 @@
 #include <string.h>
 #include <tuple>
 #include <utility>
+#include <vector>
 
 #include <pw_unit_test/framework.h>
 
@@ -29,7 +30,9 @@
 #include <lib/core/TLV.h>
 #include <lib/support/CHIPMem.h>
 #include <lib/support/TestPersistentStorageDelegate.h>
+#include <lib/support/logging/CHIPLogging.h>
 #include <platform/KeyValueStoreManager.h>
+#include <system/SystemClock.h>
 
 using namespace chip::Credentials;
 using GroupInfo      = GroupDataProvider::GroupInfo;
@@ -168,6 +171,35 @@ void ResetProvider(GroupDataProvider * provider)
     provider->RemoveFabric(kFabric2);
 }
 
+std::vector<std::pair<GroupId, EndpointId>> ReadEndpoints(GroupDataProvider & provider, chip::FabricIndex fabric,
+                                                          std::optional<GroupId> group = std::nullopt)
+{
+    std::vector<std::pair<GroupId, EndpointId>> endpoints;
+    auto it = provider.IterateEndpoints(fabric, group);
+    VerifyOrReturnValue(it != nullptr, endpoints);
+
+    GroupEndpoint output;
+    while (it->Next(output))
+    {
+        endpoints.emplace_back(output.group_id, output.endpoint_id);
+    }
+    EXPECT_EQ(endpoints.size(), it->Count());
+    it->Release();
+    return endpoints;
+}
+
+class CountingStorageDelegate : public chip::TestPersistentStorageDelegate
+{
+public:
+    CHIP_ERROR SyncGetKeyValue(const char * key, void * buffer, uint16_t & size) override
+    {
+        mReadCount++;
+        return TestPersistentStorageDelegate::SyncGetKeyValue(key, buffer, size);
+    }
+
+    size_t mReadCount = 0;
+};
+
 bool CompareKeySets(const KeySet & retrievedKeySet, const KeySet & keyset2)
 {
     VerifyOrReturnError(retrievedKeySet.policy == keyset2.policy, false);
@@ -611,6 +643,228 @@ TEST_F(TestGroupDataProvider, TestEndpointIterator)
     it->Release();
 }
 
+TEST_F(TestGroupDataProvider, TestEndpointCache)
+{
+    GroupDataProvider * provider = GetGroupDataProvider();
+    EXPECT_TRUE(provider);
+
+    // Reset test
+    ResetProvider(provider);
+
+    // Lookups load the tables of the fabric, later changes must show in the following lookups
+
+    GroupInfo group;
+    EXPECT_FALSE(provider->HasEndpoint(kFabric1, kGroup1, kEndpointId0));
+    EXPECT_EQ(CHIP_ERROR_NOT_FOUND, provider->GetGroupInfo(kFabric1, kGroup1, group));
+
+    EXPECT_EQ(provider->AddEndpoint(kFabric1, kGroup1, kEndpointId0), CHIP_NO_ERROR);
+    EXPECT_EQ(provider->AddEndpoint(kFabric1, kGroup2, kEndpointId3), CHIP_NO_ERROR);
+    EXPECT_EQ(provider->AddEndpoint(kFabric1, kGroup2, kEndpointId1), CHIP_NO_ERROR);
+    EXPECT_EQ(provider->AddEndpoint(kFabric1, kGroup3, kEndpointId1), CHIP_NO_ERROR);
+    EXPECT_TRUE(provider->HasEndpoint(kFabric1, kGroup1, kEndpointId0));
+    EXPECT_TRUE(provider->HasEndpoint(kFabric1, kGroup2, kEndpointId1));
+    EXPECT_FALSE(provider->HasEndpoint(kFabric1, kGroup1, kEndpointId1));
+    EXPECT_FALSE(provider->HasEndpoint(kFabric2, kGroup1, kEndpointId0));
+
+    EXPECT_EQ(provider->SetGroupInfo(kFabric1, kGroupInfo1_2), CHIP_NO_ERROR);
+    EXPECT_EQ(provider->GetGroupInfo(kFabric1, kGroup2, group), CHIP_NO_ERROR);
+    EXPECT_EQ(group, kGroupInfo1_2);
+
+    // Groups are added first, endpoints last
+    EXPECT_EQ(provider->GetGroupInfoAt(kFabric1, 0, group), CHIP_NO_ERROR);
+    EXPECT_EQ(group.group_id, kGroup3);
+    EXPECT_EQ(ReadEndpoints(*provider, kFabric1, kGroup2),
+              (std::vector<std::pair<GroupId, EndpointId>>{ { kGroup2, kEndpointId3 }, { kGroup2, kEndpointId1 } }));
+    EXPECT_EQ(ReadEndpoints(*provider, kFabric1),
+              (std::vector<std::pair<GroupId, EndpointId>>{
+                  { kGroup3, kEndpointId1 }, { kGroup2, kEndpointId3 }, { kGroup2, kEndpointId1 }, { kGroup1, kEndpointId0 } }));
+    EXPECT_TRUE(ReadEndpoints(*provider, kFabric1, kGroup4).empty());
+    EXPECT_TRUE(ReadEndpoints(*provider, kFabric2).empty());
+
+    // Removing an endpoint from all groups removes the groups left empty
+    EXPECT_EQ(provider->RemoveEndpoint(kFabric1, kEndpointId1), CHIP_NO_ERROR);
+    EXPECT_FALSE(provider->HasEndpoint(kFabric1, kGroup2, kEndpointId1));
+    EXPECT_FALSE(provider->HasEndpoint(kFabric1, kGroup3, kEndpointId1));
+    EXPECT_TRUE(provider->HasEndpoint(kFabric1, kGroup2, kEndpointId3));
+    EXPECT_EQ(CHIP_ERROR_NOT_FOUND, provider->GetGroupInfo(kFabric1, kGroup3, group));
+    EXPECT_EQ(ReadEndpoints(*provider, kFabric1),
+              (std::vector<std::pair<GroupId, EndpointId>>{ { kGroup2, kEndpointId3 }, { kGroup1, kEndpointId0 } }));
+
+    // A provider reading the same storage finds the same tables
+    GroupDataProviderImpl other(kMaxGroupsPerFabric, kMaxGroupKeysPerFabric);
+    other.SetStorageDelegate(&sDelegate);
+    other.SetSessionKeystore(&sSessionKeystore);
+    EXPECT_EQ(other.Init(), CHIP_NO_ERROR);
+    EXPECT_EQ(ReadEndpoints(other, kFabric1), ReadEndpoints(*provider, kFabric1));
+    EXPECT_TRUE(other.HasEndpoint(kFabric1, kGroup1, kEndpointId0));
+    EXPECT_EQ(other.GetGroupInfo(kFabric1, kGroup2, group), CHIP_NO_ERROR);
+    EXPECT_EQ(group, kGroupInfo1_2);
+    other.Finish();
+
+    // Removing the fabric clears its tables
+    EXPECT_EQ(provider->RemoveFabric(kFabric1), CHIP_NO_ERROR);
+    EXPECT_FALSE(provider->HasEndpoint(kFabric1, kGroup1, kEndpointId0));
+    EXPECT_TRUE(ReadEndpoints(*provider, kFabric1).empty());
+}
+
+TEST_F(TestGroupDataProvider, TestEndpointCacheChangeDuringIteration)
+{
+    GroupDataProvider * provider = GetGroupDataProvider();
+    EXPECT_TRUE(provider);
+
+    // Reset test
+    ResetProvider(provider);
+
+    // kGroup1 is added last, so it comes first and its endpoints precede those of kGroup2
+    EXPECT_EQ(provider->AddEndpoint(kFabric1, kGroup2, kEndpointId1), CHIP_NO_ERROR);
+    EXPECT_EQ(provider->AddEndpoint(kFabric1, kGroup2, kEndpointId2), CHIP_NO_ERROR);
+    EXPECT_EQ(provider->AddEndpoint(kFabric1, kGroup2, kEndpointId3), CHIP_NO_ERROR);
+    EXPECT_EQ(provider->AddEndpoint(kFabric1, kGroup1, kEndpointId0), CHIP_NO_ERROR);
+
+    GroupDataProvider::GroupEndpoint mapping;
+    auto it = provider->IterateEndpoints(kFabric1, std::make_optional(kGroup2));
+    ASSERT_NE(it, nullptr);
+    EXPECT_EQ(it->Count(), 3u);
+    EXPECT_TRUE(it->Next(mapping));
+    EXPECT_EQ(mapping.group_id, kGroup2);
+    EXPECT_EQ(mapping.endpoint_id, kEndpointId1);
+
+    // Growing kGroup1 moves the endpoints of kGroup2 in the mirror
+    EXPECT_EQ(provider->AddEndpoint(kFabric1, kGroup1, kEndpointId4), CHIP_NO_ERROR);
+
+    std::vector<GroupDataProvider::GroupEndpoint> rest;
+    while (it->Next(mapping))
+    {
+        rest.push_back(mapping);
+    }
+
+    // The iteration goes on over the endpoints the group had when it started
+    EXPECT_EQ(it->Count(), 3u);
+    ASSERT_EQ(rest.size(), 2u);
+    EXPECT_EQ(rest[0].group_id, kGroup2);
+    EXPECT_EQ(rest[0].endpoint_id, kEndpointId2);
+    EXPECT_EQ(rest[1].group_id, kGroup2);
+    EXPECT_EQ(rest[1].endpoint_id, kEndpointId3);
+    it->Release();
+
+    // A new iteration sees the change
+    EXPECT_EQ(ReadEndpoints(*provider, kFabric1, kGroup1),
+              (std::vector<std::pair<GroupId, EndpointId>>{ { kGroup1, kEndpointId0 }, { kGroup1, kEndpointId4 } }));
+    EXPECT_EQ(ReadEndpoints(*provider, kFabric1, kGroup2),
+              (std::vector<std::pair<GroupId, EndpointId>>{
+                  { kGroup2, kEndpointId1 }, { kGroup2, kEndpointId2 }, { kGroup2, kEndpointId3 } }));
+}
+
+TEST_F(TestGroupDataProvider, TestGroupcastRemoveGroup)
+{
+    GroupDataProvider * provider = GetGroupDataProvider();
+    EXPECT_TRUE(provider);
+
+    // Reset test
+    ResetProvider(provider);
+
+    EXPECT_EQ(provider->AddEndpoint(kFabric1, kGroup2, kEndpointId1), CHIP_NO_ERROR);
+    EXPECT_EQ(provider->AddEndpoint(kFabric1, kGroup2, kEndpointId2), CHIP_NO_ERROR);
+    EXPECT_EQ(provider->AddEndpoint(kFabric1, kGroup1, kEndpointId1), CHIP_NO_ERROR);
+    EXPECT_EQ(provider->AddEndpoint(kFabric2, kGroup2, kEndpointId1), CHIP_NO_ERROR);
+
+    // A groupcast RemoveGroup is dispatched to each endpoint of the group, as CommandHandlerImpl does, and each
+    // Groups cluster instance removes its own endpoint from the group. Changes on another fabric can happen too.
+    std::vector<EndpointId> dispatched;
+    GroupDataProvider::GroupEndpoint mapping;
+    auto it = provider->IterateEndpoints(kFabric1, std::make_optional(kGroup2));
+    ASSERT_NE(it, nullptr);
+    while (it->Next(mapping))
+    {
+        EXPECT_EQ(mapping.group_id, kGroup2);
+        dispatched.push_back(mapping.endpoint_id);
+        EXPECT_EQ(provider->RemoveEndpoint(kFabric1, mapping.group_id, mapping.endpoint_id), CHIP_NO_ERROR);
+        EXPECT_EQ(provider->AddEndpoint(kFabric2, kGroup3, mapping.endpoint_id), CHIP_NO_ERROR);
+    }
+    it->Release();
+
+    EXPECT_EQ(dispatched, (std::vector<EndpointId>{ kEndpointId1, kEndpointId2 }));
+    EXPECT_TRUE(ReadEndpoints(*provider, kFabric1, kGroup2).empty());
+    EXPECT_EQ(ReadEndpoints(*provider, kFabric1, kGroup1),
+              (std::vector<std::pair<GroupId, EndpointId>>{ { kGroup1, kEndpointId1 } }));
+    EXPECT_EQ(ReadEndpoints(*provider, kFabric2, kGroup2),
+              (std::vector<std::pair<GroupId, EndpointId>>{ { kGroup2, kEndpointId1 } }));
+}
+
+TEST_F(TestGroupDataProvider, TestEndpointLookupPerformance)
+{
+    constexpr uint16_t kGroupCount       = 64;
+    constexpr uint16_t kEndpointsByGroup = 4;
+    constexpr size_t kLookupCount        = 10000;
+
+    CountingStorageDelegate storage;
+    GroupDataProviderImpl provider(kGroupCount, kMaxGroupKeysPerFabric);
+    provider.SetStorageDelegate(&storage);
+    provider.SetSessionKeystore(&sSessionKeystore);
+    EXPECT_EQ(provider.Init(), CHIP_NO_ERROR);
+
+    // A large groupcast installation: every group controls a few endpoints
+    for (uint16_t i = 0; i < kGroupCount; i++)
+    {
+        for (uint16_t j = 0; j < kEndpointsByGroup; j++)
+        {
+            EXPECT_EQ(provider.AddEndpoint(kFabric1, static_cast<GroupId>(kGroup1 + i), static_cast<EndpointId>(1 + i + j)),
+                      CHIP_NO_ERROR);
+        }
+    }
+
+    // Check the membership of incoming group commands, as the Groups and Scenes clusters do
+    provider.HasEndpoint(kFabric1, kGroup1, 1);
+    storage.mReadCount = 0;
+    auto startTime     = System::SystemClock().GetMonotonicMicroseconds64();
+
+    size_t found = 0;
+    for (size_t i = 0; i < kLookupCount; i++)
+    {
+        const uint16_t group = static_cast<uint16_t>(i % kGroupCount);
+        if (provider.HasEndpoint(kFabric1, static_cast<GroupId>(kGroup1 + group), static_cast<EndpointId>(1 + group + (i % 8))))
+        {
+            found++;
+        }
+    }
+
+    auto elapsed = System::SystemClock().GetMonotonicMicroseconds64() - startTime;
+    EXPECT_EQ(found, kLookupCount / 2);
+    ChipLogProgress(Test, "%u endpoint lookups in %u us, %u storage reads", static_cast<unsigned>(kLookupCount),
+                    static_cast<unsigned>(elapsed.count()), static_cast<unsigned>(storage.mReadCount));
+#if CHIP_CONFIG_GROUP_DATA_CACHED_FABRICS > 0
+    EXPECT_EQ(storage.mReadCount, 0u);
+#endif
+
+    // Dispatch group commands to the endpoints of their group, as the command handler does
+    storage.mReadCount = 0;
+    startTime          = System::SystemClock().GetMonotonicMicroseconds64();
+
+    size_t dispatched = 0;
+    for (size_t i = 0; i < kLookupCount; i++)
+    {
+        auto it = provider.IterateEndpoints(kFabric1, std::make_optional(static_cast<GroupId>(kGroup1 + (i % kGroupCount))));
+        ASSERT_NE(it, nullptr);
+        GroupEndpoint mapping;
+        while (it->Next(mapping))
+        {
+            dispatched++;
+        }
+        it->Release();
+    }
+
+    elapsed = System::SystemClock().GetMonotonicMicroseconds64() - startTime;
+    EXPECT_EQ(dispatched, kLookupCount * kEndpointsByGroup);
+    ChipLogProgress(Test, "%u group dispatches in %u us, %u storage reads", static_cast<unsigned>(kLookupCount),
+                    static_cast<unsigned>(elapsed.count()), static_cast<unsigned>(storage.mReadCount));
+#if CHIP_CONFIG_GROUP_DATA_CACHED_FABRICS > 0
+    EXPECT_EQ(storage.mReadCount, 0u);
+#endif
+
+    EXPECT_EQ(provider.RemoveFabric(kFabric1), CHIP_NO_ERROR);
+    provider.Finish();
+}
+
 TEST_F(TestGroupDataProvider, TestGroupKeys)
 {
     GroupDataProvider * provider = GetGroupDataProvider();
@@ -572,6 +572,12 @@ CHIP_ERROR Spake2pVerifier::Generate(uint32_t pbkdf2IterCount, const ByteSpan &
 {
     uint8_t serializedWS[kSpake2p_WS_Length * 2] = { 0 };
     ReturnErrorOnFailure(ComputeWS(pbkdf2IterCount, salt, setupPin, serializedWS, sizeof(serializedWS)));
+    return GenerateFromWS(serializedWS, sizeof(serializedWS));
+}
+
+CHIP_ERROR Spake2pVerifier::GenerateFromWS(const uint8_t * ws, size_t ws_len)
+{
+    VerifyOrReturnError(ws != nullptr && ws_len == kSpake2p_WS_Length * 2, CHIP_ERROR_INVALID_ARGUMENT);
 
     CHIP_ERROR err = CHIP_NO_ERROR;
     size_t len;
@@ -583,12 +589,12 @@ CHIP_ERROR Spake2pVerifier::Generate(uint32_t pbkdf2IterCount, const ByteSpan &
 
     // Compute w0
     len = sizeof(mW0);
-    SuccessOrExit(err = spake2p.ComputeW0(mW0, &len, &serializedWS[0], kSpake2p_WS_Length));
+    SuccessOrExit(err = spake2p.ComputeW0(mW0, &len, &ws[0], kSpake2p_WS_Length));
     VerifyOrExit(len == sizeof(mW0), err = CHIP_ERROR_INTERNAL);
 
     // Compute L
     len = sizeof(mL);
-    SuccessOrExit(err = spake2p.ComputeL(mL, &len, &serializedWS[kSpake2p_WS_Length], kSpake2p_WS_Length));
+    SuccessOrExit(err = spake2p.ComputeL(mL, &len, &ws[kSpake2p_WS_Length], kSpake2p_WS_Length));
     VerifyOrExit(len == sizeof(mL), err = CHIP_ERROR_INTERNAL);
 
 exit:
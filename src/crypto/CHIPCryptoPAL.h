@@ -1557,6 +1557,19 @@ public:
      */
     CHIP_ERROR Generate(uint32_t pbkdf2IterCount, const ByteSpan & salt, uint32_t setupPin);
 
+    /**
+     * @brief Generate the Spake2+ verifier from the (w0, w1) pair computed by ComputeWS().
+     *
+     * Generate() is ComputeWS() followed by this. Unlike ComputeWS(), this may draw random numbers
+     * from the DRBG of the crypto backend.
+     *
+     * @param ws              The pair (w0, w1) stored sequentially
+     * @param ws_len          The length of ws, which must be 2 * kSpake2p_WS_Length
+     *
+     * @return CHIP_ERROR     The result of Spake2+ verifier generation
+     */
+    CHIP_ERROR GenerateFromWS(const uint8_t * ws, size_t ws_len);
+
     /**
      * @brief Compute the initiator values (w0, w1) used for PAKE input.
      *
@@ -79,6 +79,15 @@ protected:
     pthread_t mChipStackLockOwnerThread;
 #endif
 
+#if CHIP_DEVICE_CONFIG_ENABLE_BG_EVENT_PROCESSING && !CHIP_SYSTEM_CONFIG_USE_LIBEV
+    pthread_t mBackgroundEventLoopTask;
+    bool mInternallyManagedBackgroundEventLoopTask = false;
+    std::atomic<bool> mShouldRunBackgroundEventLoop{ false };
+    pthread_mutex_t mBackgroundEventQueueLock = PTHREAD_MUTEX_INITIALIZER;
+    pthread_cond_t mBackgroundEventQueueCond  = PTHREAD_COND_INITIALIZER;
+    std::queue<ChipDeviceEvent> mBackgroundEventQueue;
+#endif
+
     // ===== Methods that implement the PlatformManager abstract interface.
 
     CHIP_ERROR
@@ -93,6 +102,13 @@ protected:
     CHIP_ERROR _StartChipTimer(System::Clock::Timeout duration);
     void _Shutdown();
 
+#if CHIP_DEVICE_CONFIG_ENABLE_BG_EVENT_PROCESSING && !CHIP_SYSTEM_CONFIG_USE_LIBEV
+    CHIP_ERROR _PostBackgroundEvent(const ChipDeviceEvent * event);
+    void _RunBackgroundEventLoop();
+    CHIP_ERROR _StartBackgroundEventLoopTask();
+    CHIP_ERROR _StopBackgroundEventLoopTask();
+#endif
+
 #if CHIP_STACK_LOCK_TRACKING_ENABLED
     bool _IsChipStackLockedByCurrentThread() const;
 #endif
@@ -111,6 +127,9 @@ private:
     DeviceSafeQueue mChipEventQueue;
     std::atomic<bool> mShouldRunEventLoop{ true };
     static void * EventLoopTaskMain(void * arg);
+#endif
+#if CHIP_DEVICE_CONFIG_ENABLE_BG_EVENT_PROCESSING && !CHIP_SYSTEM_CONFIG_USE_LIBEV
+    static void * BackgroundEventLoopTaskMain(void * arg);
 #endif
     void ProcessDeviceEvents();
 };
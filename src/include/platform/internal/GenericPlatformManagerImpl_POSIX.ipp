@@ -383,6 +383,112 @@ exit:
 #endif // CHIP_SYSTEM_CONFIG_USE_LIBEV
 }
 
+#if CHIP_DEVICE_CONFIG_ENABLE_BG_EVENT_PROCESSING && !CHIP_SYSTEM_CONFIG_USE_LIBEV
+
+template <class ImplClass>
+CHIP_ERROR GenericPlatformManagerImpl_POSIX<ImplClass>::_PostBackgroundEvent(const ChipDeviceEvent * event)
+{
+    VerifyOrReturnError(event->Type == DeviceEventType::kCallWorkFunct || event->Type == DeviceEventType::kNoOp,
+                        CHIP_ERROR_INVALID_ARGUMENT);
+
+    pthread_mutex_lock(&mBackgroundEventQueueLock);
+    if (!mShouldRunBackgroundEventLoop.load(std::memory_order_relaxed))
+    {
+        pthread_mutex_unlock(&mBackgroundEventQueueLock);
+
+        // Nothing would process the event, so use the foreground event loop instead.
+        return Impl()->PostEvent(event);
+    }
+    mBackgroundEventQueue.push(*event);
+    pthread_cond_signal(&mBackgroundEventQueueCond);
+    pthread_mutex_unlock(&mBackgroundEventQueueLock);
+
+    return CHIP_NO_ERROR;
+}
+
+template <class ImplClass>
+void GenericPlatformManagerImpl_POSIX<ImplClass>::_RunBackgroundEventLoop()
+{
+    pthread_mutex_lock(&mBackgroundEventQueueLock);
+
+    if (mShouldRunBackgroundEventLoop.load(std::memory_order_relaxed))
+    {
+        pthread_mutex_unlock(&mBackgroundEventQueueLock);
+        ChipLogError(DeviceLayer, "Error trying to run the background event loop while it is already running");
+        return;
+    }
+    mShouldRunBackgroundEventLoop.store(true, std::memory_order_relaxed);
+
+    while (mShouldRunBackgroundEventLoop.load(std::memory_order_relaxed))
+    {
+        if (mBackgroundEventQueue.empty())
+        {
+            pthread_cond_wait(&mBackgroundEventQueueCond, &mBackgroundEventQueueLock);
+            continue;
+        }
+
+        const ChipDeviceEvent event = mBackgroundEventQueue.front();
+        mBackgroundEventQueue.pop();
+
+        pthread_mutex_unlock(&mBackgroundEventQueueLock);
+        Impl()->DispatchEvent(&event);
+        pthread_mutex_lock(&mBackgroundEventQueueLock);
+    }
+
+    // Work that was not started yet is handed over to the foreground event loop.
+    while (!mBackgroundEventQueue.empty())
+    {
+        Impl()->PostEventOrDie(&mBackgroundEventQueue.front());
+        mBackgroundEventQueue.pop();
+    }
+
+    pthread_mutex_unlock(&mBackgroundEventQueueLock);
+}
+
+template <class ImplClass>
+void * GenericPlatformManagerImpl_POSIX<ImplClass>::BackgroundEventLoopTaskMain(void * arg)
+{
+    ChipLogDetail(DeviceLayer, "CHIP background task running");
+    static_cast<GenericPlatformManagerImpl_POSIX<ImplClass> *>(arg)->Impl()->RunBackgroundEventLoop();
+    return nullptr;
+}
+
+template <class ImplClass>
+CHIP_ERROR GenericPlatformManagerImpl_POSIX<ImplClass>::_StartBackgroundEventLoopTask()
+{
+    VerifyOrReturnError(!mInternallyManagedBackgroundEventLoopTask, CHIP_ERROR_INCORRECT_STATE);
+
+    int err = pthread_create(&mBackgroundEventLoopTask, nullptr, BackgroundEventLoopTaskMain, this);
+    VerifyOrReturnError(err == 0, CHIP_ERROR_POSIX(err));
+
+    mInternallyManagedBackgroundEventLoopTask = true;
+    return CHIP_NO_ERROR;
+}
+
+template <class ImplClass>
+CHIP_ERROR GenericPlatformManagerImpl_POSIX<ImplClass>::_StopBackgroundEventLoopTask()
+{
+    pthread_mutex_lock(&mBackgroundEventQueueLock);
+    mShouldRunBackgroundEventLoop.store(false, std::memory_order_relaxed);
+    pthread_cond_signal(&mBackgroundEventQueueCond);
+    pthread_mutex_unlock(&mBackgroundEventQueueLock);
+
+    //
+    // Wait for the thread to terminate if we had previously created it, unless this is called from
+    // the background work itself.
+    //
+    if (mInternallyManagedBackgroundEventLoopTask && (pthread_equal(pthread_self(), mBackgroundEventLoopTask) == 0))
+    {
+        int err = pthread_join(mBackgroundEventLoopTask, nullptr);
+        VerifyOrReturnError(err == 0, CHIP_ERROR_POSIX(err));
+        mInternallyManagedBackgroundEventLoopTask = false;
+    }
+
+    return CHIP_NO_ERROR;
+}
+
+#endif // CHIP_DEVICE_CONFIG_ENABLE_BG_EVENT_PROCESSING && !CHIP_SYSTEM_CONFIG_USE_LIBEV
+
 template <class ImplClass>
 void GenericPlatformManagerImpl_POSIX<ImplClass>::_Shutdown()
 {
@@ -393,6 +499,10 @@ void GenericPlatformManagerImpl_POSIX<ImplClass>::_Shutdown()
     //
     VerifyOrDie(mState.load(std::memory_order_relaxed) == State::kStopped);
 
+#if CHIP_DEVICE_CONFIG_ENABLE_BG_EVENT_PROCESSING && !CHIP_SYSTEM_CONFIG_USE_LIBEV
+    LogErrorOnFailure(_StopBackgroundEventLoopTask());
+#endif
+
 #if !CHIP_SYSTEM_CONFIG_USE_LIBEV
     pthread_mutex_destroy(&mStateLock);
     pthread_cond_destroy(&mEventQueueStoppedCond);
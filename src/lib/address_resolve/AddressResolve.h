@@ -142,6 +142,19 @@ public:
         return *this;
     }
 
+    /// Whether a recently resolved address may be returned without a new
+    /// DNSSD query (see CHIP_CONFIG_ADDRESS_RESOLVE_CACHE_SIZE).
+    ///
+    /// Callers looking up a node because its previous address stopped working
+    /// should disable this, so that the stale address is not returned again.
+    NodeLookupRequest & SetAllowCachedResult(bool value)
+    {
+        mAllowCachedResult = value;
+        return *this;
+    }
+
+    bool AllowCachedResult() const { return mAllowCachedResult; }
+
 private:
     static constexpr uint32_t kMinLookupTimeMsDefault = 200;
     static constexpr uint32_t kMaxLookupTimeMsDefault = 45000;
@@ -149,6 +162,7 @@ private:
     PeerId mPeerId;
     System::Clock::Milliseconds32 mMinLookupTimeMs{ kMinLookupTimeMsDefault };
     System::Clock::Milliseconds32 mMaxLookupTimeMs{ kMaxLookupTimeMsDefault };
+    bool mAllowCachedResult = true;
 };
 
 /// These things are expected to be defined by the implementation header.
@@ -241,6 +255,16 @@ public:
     /// a clear decision if the callback should or should not be invoked.
     virtual CHIP_ERROR CancelLookup(Impl::NodeLookupHandle & handle, FailureCallback cancel_method) = 0;
 
+    /// Provides an address of a node obtained without DNSSD, e.g. the address
+    /// the node was last reached at, persisted by the caller. Later lookups
+    /// that allow cached results may use it instead of waiting for DNSSD.
+    ///
+    /// Addresses already known from DNSSD are not replaced.
+    ///
+    /// Returns CHIP_ERROR_NOT_IMPLEMENTED if the implementation has no address
+    /// cache.
+    virtual CHIP_ERROR AddKnownAddress(const PeerId & peerId, const ResolveResult & result) { return CHIP_ERROR_NOT_IMPLEMENTED; }
+
     /// Shut down any active resolves
     ///
     /// Will immediately fail any scheduled resolve calls and will refuse to register
@@ -26,6 +26,8 @@ namespace Impl {
 namespace {
 
 static constexpr System::Clock::Timeout kInvalidTimeout{ System::Clock::Timeout::max() };
+static constexpr System::Clock::Timestamp kNodeAddressCacheTtl =
+    System::Clock::Seconds32(CHIP_CONFIG_ADDRESS_RESOLVE_CACHE_TTL_SECONDS);
 
 } // namespace
 
@@ -34,6 +36,16 @@ void NodeLookupHandle::ResetForLookup(System::Clock::Timestamp now, const NodeLo
     mRequestStartTime = now;
     mRequest          = request;
     mResults          = NodeLookupResults();
+    mServedFromCache  = false;
+}
+
+void NodeLookupHandle::ResetForCachedLookup(System::Clock::Timestamp now, const NodeLookupRequest & request,
+                                            const NodeLookupResults & results)
+{
+    mRequestStartTime = now;
+    mRequest          = request;
+    mResults          = results;
+    mServedFromCache  = true;
 }
 
 void NodeLookupHandle::LookupResult(const ResolveResult & result)
@@ -65,6 +77,11 @@ System::Clock::Timeout NodeLookupHandle::NextEventTimeout(System::Clock::Timesta
 {
     const System::Clock::Timestamp elapsed = now - mRequestStartTime;
 
+    if (mServedFromCache)
+    {
+        return System::Clock::Timeout::zero();
+    }
+
     if (elapsed < mRequest.GetMinLookupTime())
     {
         return mRequest.GetMinLookupTime() - elapsed;
@@ -103,6 +120,12 @@ NodeLookupAction NodeLookupHandle::NextAction(System::Clock::Timestamp now)
     ChipLogProgress(Discovery, "Checking node lookup status for " ChipLogFormatPeerId " after %lu ms",
                     ChipLogValuePeerId(mRequest.GetPeerId()), static_cast<unsigned long>(elapsed.count()));
 
+    // Cached results need not wait for more DNSSD responses.
+    if (mServedFromCache && HasLookupResult())
+    {
+        return NodeLookupAction::Success(TakeLookupResult());
+    }
+
     // We are still within the minimal search time. Wait for more results.
     if (elapsed < mRequest.GetMinLookupTime())
     {
@@ -183,21 +206,190 @@ bool NodeLookupResults::UpdateResults(const ResolveResult & result, const Dnssd:
     return true;
 }
 
+NodeAddressCache::Entry * NodeAddressCache::Find(const PeerId & peerId)
+{
+    for (auto & entry : mEntries)
+    {
+        if (entry.inUse && entry.peerId == peerId)
+        {
+            return &entry;
+        }
+    }
+    return nullptr;
+}
+
+NodeAddressCache::LookupStatus NodeAddressCache::Lookup(const PeerId & peerId, System::Clock::Timestamp now,
+                                                        NodeLookupResults & outResults)
+{
+    Entry * entry = Find(peerId);
+    if (entry != nullptr && now - entry->updateTime >= kNodeAddressCacheTtl)
+    {
+        entry->inUse = false;
+        entry        = nullptr;
+    }
+
+    if (entry == nullptr)
+    {
+        mStats.misses++;
+        return LookupStatus::kMiss;
+    }
+
+    mStats.hits++;
+    entry->lastUse = ++mUseCounter;
+    outResults     = entry->results;
+    if (!entry->confirmed || now - entry->updateTime >= kNodeAddressCacheTtl / 2)
+    {
+        return LookupStatus::kHitNeedsRefresh;
+    }
+    return LookupStatus::kHit;
+}
+
+void NodeAddressCache::Update(const PeerId & peerId, const NodeLookupResults & results, System::Clock::Timestamp now)
+{
+    Entry * entry = Find(peerId);
+    if (entry == nullptr)
+    {
+        // Use a free entry if there is one, otherwise replace the least recently used one.
+        for (auto & candidate : mEntries)
+        {
+            if (!candidate.inUse || entry == nullptr || candidate.lastUse < entry->lastUse)
+            {
+                entry = &candidate;
+            }
+            if (!candidate.inUse)
+            {
+                break;
+            }
+        }
+        VerifyOrReturn(entry != nullptr);
+    }
+
+    entry->peerId           = peerId;
+    entry->results          = results;
+    entry->results.consumed = 0;
+    entry->updateTime       = now;
+    entry->lastUse          = ++mUseCounter;
+    entry->inUse            = true;
+    entry->confirmed        = true;
+}
+
+void NodeAddressCache::AddUnconfirmed(const PeerId & peerId, const NodeLookupResults & results, System::Clock::Timestamp now)
+{
+    Entry * entry = Find(peerId);
+    VerifyOrReturn(entry == nullptr || now - entry->updateTime >= kNodeAddressCacheTtl);
+
+    Update(peerId, results, now);
+    entry = Find(peerId);
+    if (entry != nullptr)
+    {
+        entry->confirmed = false;
+    }
+}
+
+void NodeAddressCache::Remove(const PeerId & peerId)
+{
+    Entry * entry = Find(peerId);
+    if (entry != nullptr)
+    {
+        entry->inUse = false;
+    }
+}
+
+void NodeAddressCache::Clear()
+{
+    for (auto & entry : mEntries)
+    {
+        entry.inUse = false;
+    }
+}
+
 CHIP_ERROR Resolver::LookupNode(const NodeLookupRequest & request, Impl::NodeLookupHandle & handle)
 {
     MATTER_LOG_NODE_LOOKUP(&request);
 
     VerifyOrReturnError(mSystemLayer != nullptr, CHIP_ERROR_INCORRECT_STATE);
 
-    handle.ResetForLookup(mTimeSource.GetMonotonicTimestamp(), request);
     auto & peerId = request.GetPeerId();
-    ReturnErrorOnFailure(Dnssd::Resolver::Instance().ResolveNodeId(peerId));
+    if (request.AllowCachedResult())
+    {
+        const System::Clock::Timestamp now = mTimeSource.GetMonotonicTimestamp();
+
+        NodeLookupResults cachedResults;
+        auto status = mCache.Lookup(peerId, now, cachedResults);
+        if (status != NodeAddressCache::LookupStatus::kMiss)
+        {
+            // Still completed from the timer, so listeners are never called from within LookupNode.
+            handle.ResetForCachedLookup(now, request, cachedResults);
+            mActiveLookups.PushBack(&handle);
+            ReArmTimer();
+            ChipLogProgress(Discovery, "Lookup for " ChipLogFormatPeerId " answered from cache", ChipLogValuePeerId(peerId));
+
+            if (status == NodeAddressCache::LookupStatus::kHitNeedsRefresh)
+            {
+                StartBackgroundRefresh(peerId);
+            }
+            return CHIP_NO_ERROR;
+        }
+    }
+
+    ReturnErrorOnFailure(StartDnssdLookup(request, handle));
+    ChipLogProgress(Discovery, "Lookup started for " ChipLogFormatPeerId, ChipLogValuePeerId(peerId));
+    return CHIP_NO_ERROR;
+}
+
+CHIP_ERROR Resolver::AddKnownAddress(const PeerId & peerId, const ResolveResult & result)
+{
+    VerifyOrReturnError(kNodeAddressCacheSize > 0, CHIP_ERROR_NOT_IMPLEMENTED);
+    VerifyOrReturnError(mSystemLayer != nullptr, CHIP_ERROR_INCORRECT_STATE);
+    VerifyOrReturnError(result.address.IsInitialized(), CHIP_ERROR_INVALID_ARGUMENT);
+
+    NodeLookupResults results;
+    results.UpdateResults(result,
+                          Dnssd::IPAddressSorter::ScoreIpAddress(result.address.GetIPAddress(), result.address.GetInterface()));
+    // Lookups served from an unconfirmed address start a background refresh of it, so that a stale one
+    // gets replaced by DNSSD.
+    mCache.AddUnconfirmed(peerId, results, mTimeSource.GetMonotonicTimestamp());
+    return CHIP_NO_ERROR;
+}
+
+CHIP_ERROR Resolver::StartDnssdLookup(const NodeLookupRequest & request, NodeLookupHandle & handle)
+{
+    handle.ResetForLookup(mTimeSource.GetMonotonicTimestamp(), request);
+    ReturnErrorOnFailure(Dnssd::Resolver::Instance().ResolveNodeId(request.GetPeerId()));
     mActiveLookups.PushBack(&handle);
     ReArmTimer();
-    ChipLogProgress(Discovery, "Lookup started for " ChipLogFormatPeerId, ChipLogValuePeerId(peerId));
     return CHIP_NO_ERROR;
 }
 
+void Resolver::StartBackgroundRefresh(const PeerId & peerId)
+{
+    VerifyOrReturn(!mRefreshHandle.IsActive());
+
+    // Nobody waits for this result, so there is no point waiting for a better address than the first one received.
+    NodeLookupRequest request(peerId);
+    request.SetMinLookupTime(System::Clock::kZero).SetAllowCachedResult(false);
+
+    mRefreshHandle.SetListener(&mRefreshListener);
+    CHIP_ERROR err = StartDnssdLookup(request, mRefreshHandle);
+    if (err != CHIP_NO_ERROR)
+    {
+        ChipLogError(Discovery, "Failed to refresh cached address for " ChipLogFormatPeerId ": %" CHIP_ERROR_FORMAT,
+                     ChipLogValuePeerId(peerId), err.Format());
+    }
+}
+
+void Resolver::ReleaseDnssdLookup(const PeerId & peerId)
+{
+    for (auto & lookup : mActiveLookups)
+    {
+        if (lookup.GetRequest().GetPeerId() == peerId && !lookup.IsServedFromCache())
+        {
+            return;
+        }
+    }
+    Dnssd::Resolver::Instance().NodeIdResolutionNoLongerNeeded(peerId);
+}
+
 CHIP_ERROR Resolver::TryNextResult(Impl::NodeLookupHandle & handle)
 {
     VerifyOrReturnError(!mActiveLookups.Contains(&handle), CHIP_ERROR_INCORRECT_STATE);
@@ -217,7 +409,10 @@ CHIP_ERROR Resolver::CancelLookup(Impl::NodeLookupHandle & handle, FailureCallba
 {
     VerifyOrReturnError(handle.IsActive(), CHIP_ERROR_INVALID_ARGUMENT);
     mActiveLookups.Remove(&handle);
-    Dnssd::Resolver::Instance().NodeIdResolutionNoLongerNeeded(handle.GetRequest().GetPeerId());
+    if (!handle.IsServedFromCache())
+    {
+        ReleaseDnssdLookup(handle.GetRequest().GetPeerId());
+    }
 
     // Adjust any timing updates.
     ReArmTimer();
@@ -252,14 +447,18 @@ void Resolver::Shutdown()
     {
         auto current = mActiveLookups.begin();
 
-        const PeerId peerId     = current->GetRequest().GetPeerId();
-        NodeListener * listener = current->GetListener();
+        const PeerId peerId        = current->GetRequest().GetPeerId();
+        NodeListener * listener    = current->GetListener();
+        const bool servedFromCache = current->IsServedFromCache();
 
         mActiveLookups.Erase(current);
 
         MATTER_LOG_NODE_DISCOVERY_FAILED(&peerId, CHIP_ERROR_SHUT_DOWN);
 
-        Dnssd::Resolver::Instance().NodeIdResolutionNoLongerNeeded(peerId);
+        if (!servedFromCache)
+        {
+            ReleaseDnssdLookup(peerId);
+        }
         // Failure callback only called after iterator was cleared:
         // This allows failure handlers to deallocate structures that may
         // contain the active lookup data as a member (intrusive lists members)
@@ -270,12 +469,15 @@ void Resolver::Shutdown()
     // internal list of active lookups is empty at this point.
     ReArmTimer();
 
+    mCache.Clear();
     mSystemLayer = nullptr;
     Dnssd::Resolver::Instance().SetOperationalDelegate(nullptr);
 }
 
 void Resolver::OnOperationalNodeResolved(const Dnssd::ResolvedNodeData & nodeData)
 {
+    UpdateCache(nodeData);
+
     auto it = mActiveLookups.begin();
     while (it != mActiveLookups.end())
     {
@@ -318,6 +520,44 @@ void Resolver::OnOperationalNodeResolved(const Dnssd::ResolvedNodeData & nodeDat
     ReArmTimer();
 }
 
+void Resolver::UpdateCache(const Dnssd::ResolvedNodeData & nodeData)
+{
+    const PeerId & peerId = nodeData.operationalData.peerId;
+    if (nodeData.operationalData.hasZeroTTL)
+    {
+        // The node withdrew its records (e.g. it is going away or changing addresses).
+        mCache.Remove(peerId);
+        return;
+    }
+
+    ResolveResult result;
+    result.address.SetPort(nodeData.resolutionData.port);
+    result.address.SetInterface(nodeData.resolutionData.interfaceId);
+    result.mrpRemoteConfig     = nodeData.resolutionData.GetRemoteMRPConfig();
+    result.supportsTcpClient   = nodeData.resolutionData.supportsTcpClient;
+    result.supportsTcpServer   = nodeData.resolutionData.supportsTcpServer;
+    result.isICDOperatingAsLIT = nodeData.resolutionData.isICDOperatingAsLIT.value_or(false);
+
+    NodeLookupResults results;
+    for (size_t i = 0; i < nodeData.resolutionData.numIPs; i++)
+    {
+#if !INET_CONFIG_ENABLE_IPV4
+        if (!nodeData.resolutionData.ipAddress[i].IsIPv6())
+        {
+            continue;
+        }
+#endif
+        result.address.SetIPAddress(nodeData.resolutionData.ipAddress[i]);
+        auto score = Dnssd::IPAddressSorter::ScoreIpAddress(result.address.GetIPAddress(), result.address.GetInterface());
+        results.UpdateResults(result, score);
+    }
+
+    if (results.count > 0)
+    {
+        mCache.Update(peerId, results, mTimeSource.GetMonotonicTimestamp());
+    }
+}
+
 void Resolver::HandleAction(IntrusiveList<NodeLookupHandle>::Iterator & current)
 {
     const NodeLookupAction action = current->NextAction(mTimeSource.GetMonotonicTimestamp());
@@ -329,11 +569,15 @@ void Resolver::HandleAction(IntrusiveList<NodeLookupHandle>::Iterator & current)
     }
 
     // final result, handle either success or failure
-    const PeerId peerId     = current->GetRequest().GetPeerId();
-    NodeListener * listener = current->GetListener();
+    const PeerId peerId        = current->GetRequest().GetPeerId();
+    NodeListener * listener    = current->GetListener();
+    const bool servedFromCache = current->IsServedFromCache();
     mActiveLookups.Erase(current);
 
-    Dnssd::Resolver::Instance().NodeIdResolutionNoLongerNeeded(peerId);
+    if (!servedFromCache)
+    {
+        ReleaseDnssdLookup(peerId);
+    }
 
     // ensure action is taken AFTER the current current lookup is marked complete
     // This allows failure handlers to deallocate structures that may
@@ -375,7 +619,8 @@ void Resolver::OnOperationalNodeResolutionFailed(const PeerId & peerId, CHIP_ERR
     {
         auto current = it;
         it++;
-        if (current->GetRequest().GetPeerId() != peerId)
+        // Lookups answered from the cache complete on their own.
+        if (current->GetRequest().GetPeerId() != peerId || current->IsServedFromCache())
         {
             continue;
         }
@@ -425,13 +670,17 @@ void Resolver::ReArmTimer()
         auto it = mActiveLookups.begin();
         while (it != mActiveLookups.end())
         {
-            const PeerId peerId     = it->GetRequest().GetPeerId();
-            NodeListener * listener = it->GetListener();
+            const PeerId peerId        = it->GetRequest().GetPeerId();
+            NodeListener * listener    = it->GetListener();
+            const bool servedFromCache = it->IsServedFromCache();
 
             mActiveLookups.Erase(it);
             it = mActiveLookups.begin();
 
-            Dnssd::Resolver::Instance().NodeIdResolutionNoLongerNeeded(peerId);
+            if (!servedFromCache)
+            {
+                Dnssd::Resolver::Instance().NodeIdResolutionNoLongerNeeded(peerId);
+            }
             // Callback only called after active lookup is cleared
             // This allows failure handlers to deallocate structures that may
             // contain the active lookup data as a member (intrusive lists members)
@@ -22,11 +22,14 @@
 #include <system/TimeSource.h>
 #include <transport/raw/PeerAddress.h>
 
+#include <array>
+
 namespace chip {
 namespace AddressResolve {
 namespace Impl {
 
 inline constexpr uint8_t kNodeLookupResultsLen = CHIP_CONFIG_MDNS_RESOLVE_LOOKUP_RESULTS;
+inline constexpr size_t kNodeAddressCacheSize  = CHIP_CONFIG_ADDRESS_RESOLVE_CACHE_SIZE;
 
 enum class NodeLookupResult
 {
@@ -64,6 +67,61 @@ struct NodeLookupResults
 #endif // CHIP_DETAIL_LOGGING
 };
 
+/// Recently resolved operational addresses, indexed by peer id.
+///
+/// Entries are updated from every operational DNSSD response, including ones
+/// nobody is actively looking for, and expire after
+/// CHIP_CONFIG_ADDRESS_RESOLVE_CACHE_TTL_SECONDS. When the cache is full, the
+/// least recently used entry is replaced.
+class NodeAddressCache
+{
+public:
+    struct Stats
+    {
+        uint32_t hits   = 0;
+        uint32_t misses = 0;
+    };
+
+    enum class LookupStatus
+    {
+        kMiss,
+        kHit,             // entry is valid
+        kHitNeedsRefresh, // entry is valid, but more than half of its lifetime has passed
+    };
+
+    /// Looks up a non-expired entry for the given peer and updates the hit/miss counters.
+    LookupStatus Lookup(const PeerId & peerId, System::Clock::Timestamp now, NodeLookupResults & outResults);
+
+    void Update(const PeerId & peerId, const NodeLookupResults & results, System::Clock::Timestamp now);
+
+    /// Adds results that were not obtained through DNSSD for a peer without a
+    /// valid entry. Lookups report them as kHitNeedsRefresh until an Update
+    /// confirms them.
+    void AddUnconfirmed(const PeerId & peerId, const NodeLookupResults & results, System::Clock::Timestamp now);
+    void Remove(const PeerId & peerId);
+    void Clear();
+
+    const Stats & GetStats() const { return mStats; }
+    void ResetStats() { mStats = Stats(); }
+
+private:
+    struct Entry
+    {
+        PeerId peerId;
+        NodeLookupResults results;
+        System::Clock::Timestamp updateTime = System::Clock::kZero;
+        uint32_t lastUse                    = 0;
+        bool inUse                          = false;
+        bool confirmed                      = false;
+    };
+
+    Entry * Find(const PeerId & peerId);
+
+    std::array<Entry, kNodeAddressCacheSize> mEntries;
+    uint32_t mUseCounter = 0;
+    Stats mStats;
+};
+
 /// Action to take when some resolve data
 /// has been received by an active lookup
 class NodeLookupAction
@@ -133,6 +191,12 @@ public:
     /// Resets internal state (i.e. best address so far)
     void ResetForLookup(System::Clock::Timestamp now, const NodeLookupRequest & request);
 
+    /// Sets up a request that is answered from cached results rather than
+    /// through DNSSD. The lookup completes as soon as it is processed.
+    void ResetForCachedLookup(System::Clock::Timestamp now, const NodeLookupRequest & request, const NodeLookupResults & results);
+
+    bool IsServedFromCache() const { return mServedFromCache; }
+
     /// Mark that a specific IP address has been found
     void LookupResult(const ResolveResult & result);
 
@@ -161,6 +225,7 @@ private:
     NodeLookupResults mResults;
     NodeLookupRequest mRequest; // active request to process
     System::Clock::Timestamp mRequestStartTime;
+    bool mServedFromCache = false;
 };
 
 class Resolver : public ::chip::AddressResolve::Resolver, public Dnssd::OperationalResolveDelegate
@@ -174,6 +239,7 @@ public:
     CHIP_ERROR LookupNode(const NodeLookupRequest & request, Impl::NodeLookupHandle & handle) override;
     CHIP_ERROR TryNextResult(Impl::NodeLookupHandle & handle) override;
     CHIP_ERROR CancelLookup(Impl::NodeLookupHandle & handle, FailureCallback cancel_method) override;
+    CHIP_ERROR AddKnownAddress(const PeerId & peerId, const ResolveResult & result) override;
     void Shutdown() override;
 
     // Dnssd::OperationalResolveDelegate
@@ -181,7 +247,20 @@ public:
     void OnOperationalNodeResolved(const Dnssd::ResolvedNodeData & nodeData) override;
     void OnOperationalNodeResolutionFailed(const PeerId & peerId, CHIP_ERROR error) override;
 
+    const NodeAddressCache::Stats & GetCacheStats() const { return mCache.GetStats(); }
+    void ResetCacheStats() { mCache.ResetStats(); }
+    void ClearCache() { mCache.Clear(); }
+
 private:
+    /// Receives the results of background cache refreshes. The results
+    /// themselves reach the cache through OnOperationalNodeResolved.
+    class RefreshListener : public NodeListener
+    {
+    public:
+        void OnNodeAddressResolved(const PeerId & peerId, const ResolveResult & result) override {}
+        void OnNodeAddressResolutionFailed(const PeerId & peerId, CHIP_ERROR reason) override {}
+    };
+
     static void OnResolveTimer(System::Layer * layer, void * context) { static_cast<Resolver *>(context)->HandleTimer(); }
 
     /// Timer on lookup node events: min and max search times.
@@ -200,9 +279,29 @@ private:
     /// be used after calling this method.
     void HandleAction(IntrusiveList<NodeLookupHandle>::Iterator & current);
 
+    /// Records the addresses of a resolved node in mCache.
+    void UpdateCache(const Dnssd::ResolvedNodeData & nodeData);
+
+    /// Starts a DNSSD lookup for the given request and tracks it as active.
+    CHIP_ERROR StartDnssdLookup(const NodeLookupRequest & request, NodeLookupHandle & handle);
+
+    /// Re-resolves a cached peer that is close to expiry, without anybody
+    /// waiting on the result. Only one refresh runs at a time.
+    void StartBackgroundRefresh(const PeerId & peerId);
+
+    /// Tells DNSSD that a lookup for the given peer, already removed from the
+    /// active lookups, is over, unless another active lookup still waits on
+    /// the same DNSSD resolution (e.g. a background refresh and a lookup of
+    /// the same peer).
+    void ReleaseDnssdLookup(const PeerId & peerId);
+
     System::Layer * mSystemLayer = nullptr;
     Time::TimeSource<Time::Source::kSystem> mTimeSource;
     IntrusiveList<NodeLookupHandle> mActiveLookups;
+
+    NodeAddressCache mCache;
+    RefreshListener mRefreshListener;
+    NodeLookupHandle mRefreshHandle;
 };
 
 } // namespace Impl
@@ -199,4 +199,115 @@ TEST(TestAddressResolveDefaultImpl, TestLookupResult)
     // Check that the results has been consumed properly.
     EXPECT_FALSE(handle.HasLookupResult());
 }
+
+TEST(TestAddressResolveDefaultImpl, TestNodeAddressCache)
+{
+    using namespace chip::System::Clock::Literals;
+    using LookupStatus = AddressResolve::Impl::NodeAddressCache::LookupStatus;
+
+    if (AddressResolve::Impl::kNodeAddressCacheSize == 0)
+    {
+        GTEST_SKIP();
+    }
+
+    AddressResolve::Impl::NodeAddressCache cache;
+    AddressResolve::Impl::NodeLookupResults results;
+    AddressResolve::Impl::NodeLookupResults outResults;
+
+    ResolveResult mediumResult;
+    mediumResult.address = GetAddressWithMediumScore();
+    results.UpdateResults(mediumResult, ScoreIpAddress(mediumResult.address.GetIPAddress(), Inet::InterfaceId::Null()));
+
+    const PeerId peer(1, 2);
+    const System::Clock::Timestamp start = 1000_ms64;
+    const System::Clock::Timestamp ttl   = System::Clock::Seconds32(CHIP_CONFIG_ADDRESS_RESOLVE_CACHE_TTL_SECONDS);
+
+    EXPECT_EQ(cache.Lookup(peer, start, outResults), LookupStatus::kMiss);
+
+    cache.Update(peer, results, start);
+    EXPECT_EQ(cache.Lookup(peer, start, outResults), LookupStatus::kHit);
+    EXPECT_TRUE(outResults.HasValidResult());
+    EXPECT_EQ(outResults.ConsumeResult().address, mediumResult.address);
+
+    // Consuming a returned result does not consume the cached one.
+    EXPECT_EQ(cache.Lookup(peer, start, outResults), LookupStatus::kHit);
+    EXPECT_TRUE(outResults.HasValidResult());
+
+    // Past half of the TTL, results are still returned but should be refreshed; past the TTL they expire.
+    EXPECT_EQ(cache.Lookup(peer, start + ttl / 2, outResults), LookupStatus::kHitNeedsRefresh);
+    EXPECT_EQ(cache.Lookup(peer, start + ttl, outResults), LookupStatus::kMiss);
+
+    auto stats = cache.GetStats();
+    EXPECT_EQ(stats.hits, 3u);
+    EXPECT_EQ(stats.misses, 2u);
+
+    // When full, the least recently used entry is replaced.
+    for (uint64_t i = 0; i < AddressResolve::Impl::kNodeAddressCacheSize; i++)
+    {
+        cache.Update(PeerId(1, 100 + i), results, start);
+    }
+    EXPECT_EQ(cache.Lookup(PeerId(1, 100), start, outResults), LookupStatus::kHit);
+    cache.Update(peer, results, start);
+    EXPECT_EQ(cache.Lookup(peer, start, outResults), LookupStatus::kHit);
+    if (AddressResolve::Impl::kNodeAddressCacheSize > 1)
+    {
+        EXPECT_EQ(cache.Lookup(PeerId(1, 100), start, outResults), LookupStatus::kHit);
+        EXPECT_EQ(cache.Lookup(PeerId(1, 101), start, outResults), LookupStatus::kMiss);
+    }
+
+    cache.Remove(peer);
+    EXPECT_EQ(cache.Lookup(peer, start, outResults), LookupStatus::kMiss);
+
+    cache.Clear();
+    EXPECT_EQ(cache.Lookup(PeerId(1, 100), start, outResults), LookupStatus::kMiss);
+
+    cache.ResetStats();
+    EXPECT_EQ(cache.GetStats().hits, 0u);
+}
+
+TEST(TestAddressResolveDefaultImpl, TestNodeAddressCacheUnconfirmed)
+{
+    using namespace chip::System::Clock::Literals;
+    using LookupStatus = AddressResolve::Impl::NodeAddressCache::LookupStatus;
+
+    if (AddressResolve::Impl::kNodeAddressCacheSize == 0)
+    {
+        GTEST_SKIP();
+    }
+
+    AddressResolve::Impl::NodeAddressCache cache;
+    AddressResolve::Impl::NodeLookupResults knownResults;
+    AddressResolve::Impl::NodeLookupResults dnssdResults;
+    AddressResolve::Impl::NodeLookupResults outResults;
+
+    ResolveResult knownResult;
+    knownResult.address = GetAddressWithLowScore();
+    knownResults.UpdateResults(knownResult, ScoreIpAddress(knownResult.address.GetIPAddress(), Inet::InterfaceId::Null()));
+    ResolveResult dnssdResult;
+    dnssdResult.address = GetAddressWithMediumScore();
+    dnssdResults.UpdateResults(dnssdResult, ScoreIpAddress(dnssdResult.address.GetIPAddress(), Inet::InterfaceId::Null()));
+
+    const PeerId peer(1, 2);
+    const System::Clock::Timestamp start = 1000_ms64;
+    const System::Clock::Timestamp ttl   = System::Clock::Seconds32(CHIP_CONFIG_ADDRESS_RESOLVE_CACHE_TTL_SECONDS);
+
+    // An unconfirmed address is returned, but asks for a refresh right away.
+    cache.AddUnconfirmed(peer, knownResults, start);
+    EXPECT_EQ(cache.Lookup(peer, start, outResults), LookupStatus::kHitNeedsRefresh);
+    EXPECT_EQ(outResults.ConsumeResult().address, knownResult.address);
+
+    // DNSSD results replace and confirm it.
+    cache.Update(peer, dnssdResults, start);
+    EXPECT_EQ(cache.Lookup(peer, start, outResults), LookupStatus::kHit);
+    EXPECT_EQ(outResults.ConsumeResult().address, dnssdResult.address);
+
+    // And are not replaced by an unconfirmed address until they expire.
+    cache.AddUnconfirmed(peer, knownResults, start);
+    EXPECT_EQ(cache.Lookup(peer, start, outResults), LookupStatus::kHit);
+    EXPECT_EQ(outResults.ConsumeResult().address, dnssdResult.address);
+
+    cache.AddUnconfirmed(peer, knownResults, start + ttl);
+    EXPECT_EQ(cache.Lookup(peer, start + ttl, outResults), LookupStatus::kHitNeedsRefresh);
+    EXPECT_EQ(outResults.ConsumeResult().address, knownResult.address);
+}
 } // namespace
@@ -931,6 +931,16 @@ extern const char CHIP_NON_PRODUCTION_MARKER[];
 #define CHIP_IM_SERVER_MAX_NUM_DIRTY_SET 8
 #endif
 
+/**
+ * @def CHIP_CONFIG_IM_REPORTING_STATISTICS
+ *
+ * @brief Enables counters and timings of the reporting engine (see reporting::Engine::GetStatistics), which are also logged
+ *        as metric events when tracing is enabled. Costs a few clock reads per reporting run and a timestamp per ReadHandler.
+ */
+#ifndef CHIP_CONFIG_IM_REPORTING_STATISTICS
+#define CHIP_CONFIG_IM_REPORTING_STATISTICS 1
+#endif
+
 /**
  * @def CHIP_IM_MAX_NUM_WRITE_HANDLER
  *
@@ -1055,6 +1065,33 @@ extern const char CHIP_NON_PRODUCTION_MARKER[];
 #define CHIP_CONFIG_DEVICE_MAX_ACTIVE_DEVICES 4
 #endif
 
+/**
+ * @def CHIP_CONFIG_CASE_BULK_CONNECT_MAX_CONCURRENCY
+ *
+ * @brief Maximum number of CASE session establishments a CASESessionBulkConnector
+ *        keeps in flight at once. Should not exceed the size of the
+ *        OperationalSessionSetup pool used by the CASESessionManager.
+ */
+#ifndef CHIP_CONFIG_CASE_BULK_CONNECT_MAX_CONCURRENCY
+#define CHIP_CONFIG_CASE_BULK_CONNECT_MAX_CONCURRENCY 4
+#endif
+
+/**
+ * @def CHIP_CONFIG_CASE_BULK_CONNECT_PRIME_AHEAD
+ *
+ * @brief Default number of not yet started peers whose operational address a
+ *        CASESessionBulkConnector resolves ahead of time, so that their session
+ *        establishment finds the address in the address resolver cache.
+ *        0 disables address priming.
+ *
+ *        Priming is limited so that primed and in-flight lookups together fit
+ *        in both CHIP_CONFIG_ADDRESS_RESOLVE_CACHE_SIZE and
+ *        CHIP_CONFIG_MINMDNS_RETRY_QUEUE_SIZE: raise those along with this.
+ */
+#ifndef CHIP_CONFIG_CASE_BULK_CONNECT_PRIME_AHEAD
+#define CHIP_CONFIG_CASE_BULK_CONNECT_PRIME_AHEAD 8
+#endif
+
 /**
  * @def CHIP_CONFIG_MAX_GROUP_ENDPOINTS_PER_FABRIC
  *
@@ -1107,6 +1144,19 @@ extern const char CHIP_NON_PRODUCTION_MARKER[];
 #define CHIP_CONFIG_MAX_GROUP_CONCURRENT_ITERATORS 2
 #endif
 
+/**
+ * @def CHIP_CONFIG_GROUP_DATA_CACHED_FABRICS
+ *
+ * @brief Defines the number of fabrics whose group membership GroupDataProviderImpl mirrors in memory
+ *
+ * Group and endpoint lookups of a mirrored fabric are served without reading persistent storage. The
+ * mirror of a fabric is loaded from storage on first use and allocated from the heap, in proportion
+ * to the number of groups and endpoints of the fabric. Set to 0 to always read from storage.
+ */
+#ifndef CHIP_CONFIG_GROUP_DATA_CACHED_FABRICS
+#define CHIP_CONFIG_GROUP_DATA_CACHED_FABRICS CHIP_CONFIG_MAX_FABRICS
+#endif
+
 /**
  * @def CHIP_CONFIG_MAX_GROUP_NAME_LENGTH
  *
@@ -1216,6 +1266,17 @@ extern const char CHIP_NON_PRODUCTION_MARKER[];
 #define CHIP_CONFIG_CASE_SESSION_RESUME_CACHE_SIZE (3 * CHIP_CONFIG_MAX_FABRICS)
 #endif
 
+/**
+ * @def CHIP_CONFIG_PERSISTENT_STORAGE_MAX_PENDING_WRITES
+ *
+ * @brief
+ *   Maximum number of keys whose writes a CoalescingPersistentStorageDelegate
+ *   holds back before they are flushed to the underlying storage.
+ */
+#ifndef CHIP_CONFIG_PERSISTENT_STORAGE_MAX_PENDING_WRITES
+#define CHIP_CONFIG_PERSISTENT_STORAGE_MAX_PENDING_WRITES 8
+#endif
+
 /**
  * @def CHIP_CONFIG_EVENT_LOGGING_BYTE_THRESHOLD
  *
@@ -1359,6 +1420,44 @@ extern const char CHIP_NON_PRODUCTION_MARKER[];
 #define CHIP_CONFIG_MINMDNS_MAX_PARALLEL_RESOLVES 2
 #endif // CHIP_CONFIG_MINMDNS_MAX_PARALLEL_RESOLVES
 
+/*
+ * @def CHIP_CONFIG_MINMDNS_RETRY_QUEUE_SIZE
+ *
+ * @brief Number of DNS-SD queries (operational resolves and browses) that the
+ *        minmdns resolver can keep retrying at once. When the queue is full,
+ *        starting a new query drops the oldest one.
+ */
+#ifndef CHIP_CONFIG_MINMDNS_RETRY_QUEUE_SIZE
+#define CHIP_CONFIG_MINMDNS_RETRY_QUEUE_SIZE 4
+#endif // CHIP_CONFIG_MINMDNS_RETRY_QUEUE_SIZE
+
+/*
+ * @def CHIP_CONFIG_MINMDNS_KNOWN_ANSWER_CACHE_SIZE
+ *
+ * @brief Number of PTR records received in browse responses that minimal mDNS
+ *        remembers, to list them as known answers (RFC 6762 Section 7.1) when
+ *        the browse query is repeated. Devices that find their record in the
+ *        known answer list do not respond again.
+ */
+#ifndef CHIP_CONFIG_MINMDNS_KNOWN_ANSWER_CACHE_SIZE
+#define CHIP_CONFIG_MINMDNS_KNOWN_ANSWER_CACHE_SIZE 8
+#endif // CHIP_CONFIG_MINMDNS_KNOWN_ANSWER_CACHE_SIZE
+
+/*
+ * @def CHIP_CONFIG_MINMDNS_AGGREGATE_RESPONSES
+ *
+ * @brief When enabled, the minimal mDNS advertiser delays multicast replies made
+ *        only of shared (PTR) records by a random 20-120 ms (RFC 6762 Section 6),
+ *        so that queries from several controllers browsing at the same time are
+ *        answered with one packet. Replies with unique records are never delayed.
+ *
+ *        Disabled by default: it trades up to 120 ms of browse latency for fewer
+ *        packets, which only pays off on networks with many controllers.
+ */
+#ifndef CHIP_CONFIG_MINMDNS_AGGREGATE_RESPONSES
+#define CHIP_CONFIG_MINMDNS_AGGREGATE_RESPONSES 0
+#endif // CHIP_CONFIG_MINMDNS_AGGREGATE_RESPONSES
+
 /**
  * def CHIP_CONFIG_MDNS_RESOLVE_LOOKUP_RESULTS
  *
@@ -1370,6 +1469,30 @@ extern const char CHIP_NON_PRODUCTION_MARKER[];
 #define CHIP_CONFIG_MDNS_RESOLVE_LOOKUP_RESULTS 1
 #endif // CHIP_CONFIG_MDNS_RESOLVE_LOOKUP_RESULTS
 
+/**
+ * @def CHIP_CONFIG_ADDRESS_RESOLVE_CACHE_SIZE
+ *
+ * @brief Number of nodes whose resolved operational addresses are cached by the
+ *        default address resolver, so that repeated lookups of the same node can
+ *        be answered without a new DNS-SD query. The least recently used entry
+ *        is replaced when the cache is full. Set to 0 to disable the cache.
+ */
+#ifndef CHIP_CONFIG_ADDRESS_RESOLVE_CACHE_SIZE
+#define CHIP_CONFIG_ADDRESS_RESOLVE_CACHE_SIZE 4
+#endif // CHIP_CONFIG_ADDRESS_RESOLVE_CACHE_SIZE
+
+/**
+ * @def CHIP_CONFIG_ADDRESS_RESOLVE_CACHE_TTL_SECONDS
+ *
+ * @brief How long a cached operational address stays valid. Defaults to the
+ *        TTL that Matter nodes use for their SRV and AAAA records. Once half of
+ *        this time has passed, lookups are still answered from the cache but
+ *        also trigger a background refresh.
+ */
+#ifndef CHIP_CONFIG_ADDRESS_RESOLVE_CACHE_TTL_SECONDS
+#define CHIP_CONFIG_ADDRESS_RESOLVE_CACHE_TTL_SECONDS 120
+#endif // CHIP_CONFIG_ADDRESS_RESOLVE_CACHE_TTL_SECONDS
+
 /*
  * @def CHIP_CONFIG_NETWORK_COMMISSIONING_DEBUG_TEXT_BUFFER_SIZE
  *
@@ -1427,6 +1550,20 @@ extern const char CHIP_NON_PRODUCTION_MARKER[];
 #define CHIP_CONFIG_MAX_SUBSCRIPTION_RESUMPTION_STORAGE_CONCURRENT_ITERATORS 2
 #endif
 
+/**
+ * @def CHIP_CONFIG_SUBSCRIPTION_RESUMPTION_STORAGE_SHARD_SIZE
+ *
+ * @brief Largest storage value written by SimpleSubscriptionResumptionStorage
+ *
+ * The subscription resumption table is split over as many storage keys as needed for no
+ * value to be larger than this, which must not exceed the largest value the key value store
+ * of the platform accepts. Each iterator over the persisted subscriptions allocates a buffer
+ * of this size.
+ */
+#ifndef CHIP_CONFIG_SUBSCRIPTION_RESUMPTION_STORAGE_SHARD_SIZE
+#define CHIP_CONFIG_SUBSCRIPTION_RESUMPTION_STORAGE_SHARD_SIZE 1024
+#endif
+
 /**
  * @brief Maximum length of Scene names
  */
@@ -1537,6 +1674,32 @@ extern const char CHIP_NON_PRODUCTION_MARKER[];
 #endif // CHIP_CONFIG_TEST
 #endif // CHIP_CONFIG_MAX_SCENES_TABLE_SIZE
 
+/**
+ * @def CHIP_CONFIG_SCENES_CACHE_SIZE
+ *
+ * @brief Number of decoded scenes the default scene table keeps in memory, so that recalling them does not need to read and
+ * decode them from persistent storage. When the cache is full, the least recently used scene is evicted.
+ *
+ * Each entry holds a full scene table entry, which is a few hundred bytes with the default extension field set sizes. The
+ * cache is disabled by default.
+ */
+#ifndef CHIP_CONFIG_SCENES_CACHE_SIZE
+#define CHIP_CONFIG_SCENES_CACHE_SIZE 0
+#endif // CHIP_CONFIG_SCENES_CACHE_SIZE
+
+/**
+ * @def CHIP_CONFIG_DESCRIPTOR_PARTS_LIST_CACHE_SIZE
+ *
+ * @brief Number of endpoints whose Descriptor PartsList is kept in memory between reads, until the endpoint composition
+ * changes. Computing the PartsList of an endpoint with flat composition walks the parents of every endpoint, and large lists are
+ * computed again for every report chunk, which adds up on bridges with many dynamic endpoints.
+ *
+ * Each entry holds one endpoint ID per possible endpoint. The cache is disabled by default.
+ */
+#ifndef CHIP_CONFIG_DESCRIPTOR_PARTS_LIST_CACHE_SIZE
+#define CHIP_CONFIG_DESCRIPTOR_PARTS_LIST_CACHE_SIZE 0
+#endif // CHIP_CONFIG_DESCRIPTOR_PARTS_LIST_CACHE_SIZE
+
 /**
  * @def CHIP_CONFIG_SCENES_USE_DEFAULT_HANDLERS
  *
@@ -1785,6 +1948,33 @@ extern const char CHIP_NON_PRODUCTION_MARKER[];
 #define CHIP_CONFIG_MAX_BDX_LOG_TRANSFERS 5
 #endif // CHIP_CONFIG_MAX_BDX_LOG_TRANSFERS
 
+/**
+ *  @def CHIP_CONFIG_BDX_WINDOWED_TRANSFER_VENDOR_ID
+ *
+ *  @brief
+ *    Vendor ID of the vendor-specific Metadata element used by bdx::TransferSession to negotiate its windowed extension
+ *    of Sender Drive, which is not part of the BDX specification.
+ *
+ *    The extension is only used between peers that use the same value, so products should set it to their own Vendor ID.
+ *
+ */
+#ifndef CHIP_CONFIG_BDX_WINDOWED_TRANSFER_VENDOR_ID
+#define CHIP_CONFIG_BDX_WINDOWED_TRANSFER_VENDOR_ID 0xFFF1
+#endif // CHIP_CONFIG_BDX_WINDOWED_TRANSFER_VENDOR_ID
+
+/**
+ *  @def CHIP_CONFIG_CERT_SIGNATURE_CACHE_SIZE
+ *
+ *  @brief
+ *    Number of successfully verified CA certificate (ICAC/RCAC) signatures remembered by
+ *    ChipCertificateSet::ValidateCert, so that repeated chain validations against the same
+ *    fabric only verify the leaf signature.  Set to 0 to disable the cache.
+ *
+ */
+#ifndef CHIP_CONFIG_CERT_SIGNATURE_CACHE_SIZE
+#define CHIP_CONFIG_CERT_SIGNATURE_CACHE_SIZE 8
+#endif // CHIP_CONFIG_CERT_SIGNATURE_CACHE_SIZE
+
 /**
  * @}
  */
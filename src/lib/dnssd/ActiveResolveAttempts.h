@@ -21,6 +21,7 @@
 #include <cstdint>
 #include <optional>
 
+#include <lib/core/CHIPConfig.h>
 #include <lib/core/PeerId.h>
 #include <lib/dnssd/Resolver.h>
 #include <lib/dnssd/minimal_mdns/core/HeapQName.h>
@@ -41,7 +42,7 @@ namespace Minimal {
 class ActiveResolveAttempts
 {
 public:
-    static constexpr size_t kRetryQueueSize                      = 4;
+    static constexpr size_t kRetryQueueSize                      = CHIP_CONFIG_MINMDNS_RETRY_QUEUE_SIZE;
     static constexpr chip::System::Clock::Timeout kMaxRetryDelay = chip::System::Clock::Seconds16(16);
 
     struct ScheduledAttempt
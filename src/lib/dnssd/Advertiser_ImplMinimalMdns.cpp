@@ -378,6 +378,10 @@ CHIP_ERROR AdvertiserMinMdns::Init(chip::Inet::EndPointManager<chip::Inet::UDPEn
 
     ReturnErrorOnFailure(GlobalMinimalMdnsServer::Instance().StartServer(udpEndPointManager, kMdnsPort));
 
+#if CHIP_CONFIG_MINMDNS_AGGREGATE_RESPONSES
+    mResponseSender.EnableResponseAggregation(&udpEndPointManager->SystemLayer());
+#endif // CHIP_CONFIG_MINMDNS_AGGREGATE_RESPONSES
+
     ChipLogProgress(Discovery, "CHIP minimal mDNS started advertising.");
 
     AdvertiseRecords(BroadcastAdvertiseType::kStarted);
@@ -391,6 +395,7 @@ void AdvertiserMinMdns::Shutdown()
 {
     VerifyOrReturn(mIsInitialized);
 
+    mResponseSender.DisableResponseAggregation();
     AdvertiseRecords(BroadcastAdvertiseType::kRemovingAll);
 
     GlobalMinimalMdnsServer::Server().Shutdown();
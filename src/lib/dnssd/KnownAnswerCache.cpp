@@ -0,0 +1,113 @@
+/*
+ *
+ *    Copyright (c) 2024 Project CHIP Authors
+ *
+ *    Licensed under the Apache License, Version 2.0 (the "License");
+ *    you may not use this file except in compliance with the License.
+ *    You may obtain a copy of the License at
+ *
+ *        http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *    Unless required by applicable law or agreed to in writing, software
+ *    distributed under the License is distributed on an "AS IS" BASIS,
+ *    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *    See the License for the specific language governing permissions and
+ *    limitations under the License.
+ */
+
+#include "KnownAnswerCache.h"
+
+#include <chrono>
+
+namespace mdns {
+namespace Minimal {
+
+using namespace chip::System::Clock;
+
+void KnownAnswerCache::Add(SerializedQNameIterator name, SerializedQNameIterator target, uint32_t ttlSeconds)
+{
+    Entry * slot = nullptr;
+
+    for (auto & entry : mEntries)
+    {
+        if (entry.IsInUse() && (name == entry.name.Content()) && (target == entry.target.Content()))
+        {
+            slot = &entry;
+            break;
+        }
+    }
+
+    if (ttlSeconds == 0)
+    {
+        if (slot != nullptr)
+        {
+            *slot = Entry();
+        }
+        return;
+    }
+
+    if (slot == nullptr)
+    {
+        // Prefer a free (or expired) entry, otherwise evict the entry closest to expiry.
+        uint32_t lowestRemainingTtl = UINT32_MAX;
+        for (auto & entry : mEntries)
+        {
+            uint32_t remaining = RemainingTtlSeconds(entry);
+            if (remaining < lowestRemainingTtl)
+            {
+                lowestRemainingTtl = remaining;
+                slot               = &entry;
+            }
+        }
+
+        slot->name   = HeapQName(name);
+        slot->target = HeapQName(target);
+        if (!slot->name.IsOk() || !slot->target.IsOk())
+        {
+            *slot = Entry();
+            return;
+        }
+    }
+
+    slot->ttlSeconds = ttlSeconds;
+    slot->receivedAt = mClock->GetMonotonicTimestamp();
+}
+
+void KnownAnswerCache::Clear()
+{
+    for (auto & entry : mEntries)
+    {
+        entry = Entry();
+    }
+}
+
+uint32_t KnownAnswerCache::RemainingTtlSeconds(const Entry & entry) const
+{
+    if (!entry.IsInUse())
+    {
+        return 0;
+    }
+
+    const Seconds32 elapsed = std::chrono::duration_cast<Seconds32>(mClock->GetMonotonicTimestamp() - entry.receivedAt);
+    if (elapsed.count() >= entry.ttlSeconds)
+    {
+        return 0;
+    }
+    return entry.ttlSeconds - elapsed.count();
+}
+
+bool KnownAnswerCache::IsKnownAnswer(const Entry & entry, const FullQName & name, uint32_t & remainingTtl) const
+{
+    remainingTtl = RemainingTtlSeconds(entry);
+
+    // Records past half of their lifetime are left out, so that responders refresh them.
+    if (remainingTtl == 0 || (static_cast<uint64_t>(remainingTtl) * 2 < entry.ttlSeconds))
+    {
+        return false;
+    }
+
+    return entry.name.Content() == name;
+}
+
+} // namespace Minimal
+} // namespace mdns
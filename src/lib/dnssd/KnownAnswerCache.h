@@ -0,0 +1,104 @@
+/*
+ *
+ *    Copyright (c) 2024 Project CHIP Authors
+ *
+ *    Licensed under the Apache License, Version 2.0 (the "License");
+ *    you may not use this file except in compliance with the License.
+ *    You may obtain a copy of the License at
+ *
+ *        http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *    Unless required by applicable law or agreed to in writing, software
+ *    distributed under the License is distributed on an "AS IS" BASIS,
+ *    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *    See the License for the specific language governing permissions and
+ *    limitations under the License.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+#include <lib/core/CHIPConfig.h>
+#include <lib/dnssd/minimal_mdns/core/HeapQName.h>
+#include <lib/dnssd/minimal_mdns/records/Ptr.h>
+#include <lib/support/Iterators.h>
+#include <system/SystemClock.h>
+
+namespace mdns {
+namespace Minimal {
+
+/// Keeps track of PTR records received in browse responses, so that
+/// repeated browse queries can list them as known answers (RFC 6762
+/// Section 7.1).
+///
+/// A responder that finds its own record in the known answer list of a
+/// query does not reply to that query. On networks with many devices this
+/// keeps every retry of a browse from triggering a response from every
+/// device that was already discovered.
+class KnownAnswerCache
+{
+public:
+    static constexpr size_t kCacheSize = CHIP_CONFIG_MINMDNS_KNOWN_ANSWER_CACHE_SIZE;
+
+    KnownAnswerCache(chip::System::Clock::ClockBase * clock) : mClock(clock) {}
+
+    /// Remember the given PTR record, replacing any previous copy of it.
+    ///
+    /// A TTL of 0 (i.e. a goodbye record) forgets the record instead. When
+    /// the cache is full, the record closest to expiry is replaced.
+    void Add(SerializedQNameIterator name, SerializedQNameIterator target, uint32_t ttlSeconds);
+
+    /// Calls `callback` for every record named `name` that may be listed as
+    /// a known answer: per RFC 6762 Section 7.1 that is every record for
+    /// which at least half of its original TTL remains. The TTL of the
+    /// record passed to the callback is the remaining TTL.
+    ///
+    /// Returns chip::Loop::Break if the callback stopped the iteration.
+    template <typename Callback>
+    chip::Loop ForEachKnownAnswer(const FullQName & name, Callback && callback)
+    {
+        for (auto & entry : mEntries)
+        {
+            uint32_t remainingTtl;
+            if (!IsKnownAnswer(entry, name, remainingTtl))
+            {
+                continue;
+            }
+
+            PtrResourceRecord record(entry.name.Content(), entry.target.Content());
+            record.SetTtl(remainingTtl);
+            if (callback(static_cast<const PtrResourceRecord &>(record)) == chip::Loop::Break)
+            {
+                return chip::Loop::Break;
+            }
+        }
+        return chip::Loop::Finish;
+    }
+
+    /// Forget all records.
+    void Clear();
+
+private:
+    struct Entry
+    {
+        HeapQName name;
+        HeapQName target;
+        uint32_t ttlSeconds                       = 0;
+        chip::System::Clock::Timestamp receivedAt = chip::System::Clock::kZero;
+
+        bool IsInUse() const { return ttlSeconds != 0; }
+    };
+
+    /// Seconds until the entry expires, 0 if it has expired or is not in use.
+    uint32_t RemainingTtlSeconds(const Entry & entry) const;
+
+    bool IsKnownAnswer(const Entry & entry, const FullQName & name, uint32_t & remainingTtl) const;
+
+    chip::System::Clock::ClockBase * mClock;
+    Entry mEntries[kCacheSize];
+};
+
+} // namespace Minimal
+} // namespace mdns
@@ -17,9 +17,12 @@
 
 #include "Resolver.h"
 
+#include <algorithm>
+
 #include <lib/core/CHIPConfig.h>
 #include <lib/dnssd/ActiveResolveAttempts.h>
 #include <lib/dnssd/IncrementalResolve.h>
+#include <lib/dnssd/KnownAnswerCache.h>
 #include <lib/dnssd/MinimalMdnsServer.h>
 #include <lib/dnssd/ServiceNaming.h>
 #include <lib/dnssd/minimal_mdns/Logging.h>
@@ -45,6 +48,10 @@ constexpr uint16_t kMdnsPort        = 5353;
 
 using namespace mdns::Minimal;
 
+constexpr QNamePart kOperationalSuffix[]    = { kOperationalServiceName, kOperationalProtocol, kLocalDomain };
+constexpr QNamePart kCommissionableSuffix[] = { kCommissionableServiceName, kCommissionProtocol, kLocalDomain };
+constexpr QNamePart kCommissionerSuffix[]   = { kCommissionerServiceName, kCommissionProtocol, kLocalDomain };
+
 /// Handles processing of minmdns packet data.
 ///
 /// Can process multiple incremental resolves based on SRV data and allows
@@ -53,7 +60,9 @@ using namespace mdns::Minimal;
 class PacketParser : private ParserDelegate
 {
 public:
-    PacketParser(ActiveResolveAttempts & activeResolves) : mActiveResolves(activeResolves) {}
+    PacketParser(ActiveResolveAttempts & activeResolves, KnownAnswerCache & knownAnswers) :
+        mActiveResolves(activeResolves), mKnownAnswers(knownAnswers)
+    {}
 
     /// Goes through the given SRV records within a response packet
     /// and sets up data resolution
@@ -85,6 +94,11 @@ private:
     /// Forwards the resource to all active resolvers.
     void ParseResource(const ResourceData & data);
 
+    /// Remembers PTR records pointing to matter service instances that an
+    /// active browse is looking for, to list them as known answers when
+    /// the browse is retried.
+    void ParsePtrResource(const ResourceData & data);
+
     enum class RecordParsingState
     {
         kIdle,
@@ -102,6 +116,7 @@ private:
 
     // resolvers kept between parse steps
     ActiveResolveAttempts & mActiveResolves;
+    KnownAnswerCache & mKnownAnswers;
     IncrementalResolver mResolvers[kMinMdnsNumParallelResolvers];
 };
 
@@ -186,6 +201,46 @@ void PacketParser::ParseResource(const ResourceData & data)
     {
         mActiveResolves.CompleteIpResolution(data.GetName());
     }
+
+    if (data.GetType() == QType::PTR)
+    {
+        ParsePtrResource(data);
+    }
+}
+
+void PacketParser::ParsePtrResource(const ResourceData & data)
+{
+    SerializedQNameIterator target;
+    if (!ParsePtrRecord(data.GetData(), mPacketRange, &target))
+    {
+        return;
+    }
+
+    // Instance names look like <instance>.<service>.<protocol>.local, skip over the instance.
+    SerializedQNameIterator service = target;
+    if (!service.Next() || !service.IsValid())
+    {
+        return;
+    }
+
+    bool isBrowsed = false;
+    if (service == kCommissionableSuffix)
+    {
+        isBrowsed = mActiveResolves.HasBrowseFor(chip::Dnssd::DiscoveryType::kCommissionableNode);
+    }
+    else if (service == kCommissionerSuffix)
+    {
+        isBrowsed = mActiveResolves.HasBrowseFor(chip::Dnssd::DiscoveryType::kCommissionerNode);
+    }
+    else if (service == kOperationalSuffix)
+    {
+        isBrowsed = mActiveResolves.HasBrowseFor(chip::Dnssd::DiscoveryType::kOperational);
+    }
+
+    if (isBrowsed)
+    {
+        mKnownAnswers.Add(data.GetName(), target, static_cast<uint32_t>(std::min<uint64_t>(data.GetTtlSeconds(), UINT32_MAX)));
+    }
 }
 
 void PacketParser::ParseSRVResource(const ResourceData & data)
@@ -267,7 +322,9 @@ void PacketParser::ParseNonSrvRecords(Inet::InterfaceId interface, const BytesRa
 class MinMdnsResolver : public Resolver, public MdnsPacketDelegate
 {
 public:
-    MinMdnsResolver() : mActiveResolves(&chip::System::SystemClock()), mPacketParser(mActiveResolves)
+    MinMdnsResolver() :
+        mActiveResolves(&chip::System::SystemClock()), mKnownAnswers(&chip::System::SystemClock()),
+        mPacketParser(mActiveResolves, mKnownAnswers)
     {
         GlobalMinimalMdnsServer::Instance().SetResponseDelegate(this);
     }
@@ -292,6 +349,7 @@ private:
     DiscoveryContext * mDiscoveryContext              = nullptr;
     System::Layer * mSystemLayer                      = nullptr;
     ActiveResolveAttempts mActiveResolves;
+    KnownAnswerCache mKnownAnswers;
     PacketParser mPacketParser;
 
     void SetDiscoveryContext(DiscoveryContext * context);
@@ -304,10 +362,18 @@ private:
     CHIP_ERROR BuildQuery(QueryBuilder & builder, const ActiveResolveAttempts::ScheduledAttempt & attempt);
 
     /// Prepare a query for specific resolve types
+    ///
+    /// A question that does not fit into the packet is left out and fails the builder.
     CHIP_ERROR BuildQuery(QueryBuilder & builder, const ActiveResolveAttempts::ScheduledAttempt::Browse & data, bool firstSend);
     CHIP_ERROR BuildQuery(QueryBuilder & builder, const ActiveResolveAttempts::ScheduledAttempt::Resolve & data, bool firstSend);
     CHIP_ERROR BuildQuery(QueryBuilder & builder, const ActiveResolveAttempts::ScheduledAttempt::IpResolve & data, bool firstSend);
 
+    /// Compute the name queried for the given browse
+    CHIP_ERROR BuildBrowseQName(const ActiveResolveAttempts::ScheduledAttempt::Browse & data, mdns::Minimal::FullQName & qname);
+
+    /// Append the known answers of the given browse, as many as fit into the packet.
+    void AddKnownAnswers(QueryBuilder & builder, const ActiveResolveAttempts::ScheduledAttempt::Browse & data);
+
     /// Clear any incremental resolver that is not waiting for a AAAA address.
     void ExpireIncrementalResolvers();
     void AdvancePendingResolverStates();
@@ -534,12 +600,13 @@ bool MinMdnsResolver::IsInitialized()
 void MinMdnsResolver::Shutdown()
 {
     GlobalMinimalMdnsServer::Instance().ShutdownServer();
+    mKnownAnswers.Clear();
 }
 
-CHIP_ERROR MinMdnsResolver::BuildQuery(QueryBuilder & builder, const ActiveResolveAttempts::ScheduledAttempt::Browse & data,
-                                       bool firstSend)
+CHIP_ERROR MinMdnsResolver::BuildBrowseQName(const ActiveResolveAttempts::ScheduledAttempt::Browse & data,
+                                             mdns::Minimal::FullQName & qname)
 {
-    mdns::Minimal::FullQName qname;
+    qname = mdns::Minimal::FullQName();
 
     switch (data.type)
     {
@@ -581,6 +648,14 @@ CHIP_ERROR MinMdnsResolver::BuildQuery(QueryBuilder & builder, const ActiveResol
     }
 
     ReturnErrorCodeIf(!qname.nameCount, CHIP_ERROR_NO_MEMORY);
+    return CHIP_NO_ERROR;
+}
+
+CHIP_ERROR MinMdnsResolver::BuildQuery(QueryBuilder & builder, const ActiveResolveAttempts::ScheduledAttempt::Browse & data,
+                                       bool firstSend)
+{
+    mdns::Minimal::FullQName qname;
+    ReturnErrorOnFailure(BuildBrowseQName(data, qname));
 
     mdns::Minimal::Query query(qname);
     query
@@ -589,8 +664,11 @@ CHIP_ERROR MinMdnsResolver::BuildQuery(QueryBuilder & builder, const ActiveResol
         .SetAnswerViaUnicast(firstSend) //
         ;
 
-    mdns::Minimal::Logging::LogSendingQuery(query);
     builder.AddQuery(query);
+    if (builder.Ok())
+    {
+        mdns::Minimal::Logging::LogSendingQuery(query);
+    }
 
     return CHIP_NO_ERROR;
 }
@@ -612,8 +690,11 @@ CHIP_ERROR MinMdnsResolver::BuildQuery(QueryBuilder & builder, const ActiveResol
         .SetAnswerViaUnicast(firstSend) //
         ;
 
-    mdns::Minimal::Logging::LogSendingQuery(query);
     builder.AddQuery(query);
+    if (builder.Ok())
+    {
+        mdns::Minimal::Logging::LogSendingQuery(query);
+    }
 
     return CHIP_NO_ERROR;
 }
@@ -630,8 +711,11 @@ CHIP_ERROR MinMdnsResolver::BuildQuery(QueryBuilder & builder, const ActiveResol
         .SetAnswerViaUnicast(firstSend) //
         ;
 
-    mdns::Minimal::Logging::LogSendingQuery(query);
     builder.AddQuery(query);
+    if (builder.Ok())
+    {
+        mdns::Minimal::Logging::LogSendingQuery(query);
+    }
 
     return CHIP_NO_ERROR;
 }
@@ -659,26 +743,64 @@ CHIP_ERROR MinMdnsResolver::BuildQuery(QueryBuilder & builder, const ActiveResol
     return CHIP_NO_ERROR;
 }
 
-CHIP_ERROR MinMdnsResolver::SendAllPendingQueries()
+void MinMdnsResolver::AddKnownAnswers(QueryBuilder & builder, const ActiveResolveAttempts::ScheduledAttempt::Browse & data)
 {
-    while (true)
-    {
-        std::optional<ActiveResolveAttempts::ScheduledAttempt> resolve = mActiveResolves.NextScheduled();
+    mdns::Minimal::FullQName qname;
+    VerifyOrReturn(BuildBrowseQName(data, qname) == CHIP_NO_ERROR);
+
+    // Known answers that do not fit are left out: responders will answer with them again, which is
+    // no worse than not sending known answers at all.
+    mKnownAnswers.ForEachKnownAnswer(qname, [&builder](const PtrResourceRecord & record) {
+        builder.AddKnownAnswer(record);
+        return builder.Ok() ? chip::Loop::Continue : chip::Loop::Break;
+    });
+}
 
-        if (!resolve.has_value())
-        {
-            break;
-        }
+CHIP_ERROR MinMdnsResolver::SendAllPendingQueries()
+{
+    // All questions that are due are packed into as few packets as possible rather than sent one per packet.
+    // First sends ask for unicast replies and go out through a different path, so they get their own packets.
+    std::optional<ActiveResolveAttempts::ScheduledAttempt> resolve = mActiveResolves.NextScheduled();
 
+    while (resolve.has_value())
+    {
         System::PacketBufferHandle buffer = System::PacketBufferHandle::New(kMdnsMaxPacketSize);
         ReturnErrorCodeIf(buffer.IsNull(), CHIP_ERROR_NO_MEMORY);
 
         QueryBuilder builder(std::move(buffer));
         builder.Header().SetMessageId(0);
 
-        ReturnErrorOnFailure(BuildQuery(builder, *resolve));
+        const bool firstSend = resolve->firstSend;
 
-        if (resolve->firstSend)
+        // Known answers have to follow all the questions, so remember the browses in this packet.
+        std::optional<ActiveResolveAttempts::ScheduledAttempt::Browse> browses[ActiveResolveAttempts::kRetryQueueSize];
+        size_t browseCount = 0;
+
+        do
+        {
+            CHIP_ERROR err = BuildQuery(builder, *resolve);
+            if (!builder.Ok())
+            {
+                // Out of space: the question starts the next packet.
+                ReturnErrorCodeIf(!builder.HasQueries(), CHIP_ERROR_NO_MEMORY);
+                break;
+            }
+            ReturnErrorOnFailure(err);
+
+            if (resolve->IsBrowse() && browseCount < ArraySize(browses))
+            {
+                browses[browseCount++].emplace(resolve->BrowseData());
+            }
+
+            resolve = mActiveResolves.NextScheduled();
+        } while (resolve.has_value() && (resolve->firstSend == firstSend));
+
+        for (size_t i = 0; (i < browseCount) && builder.Ok(); i++)
+        {
+            AddKnownAnswers(builder, *browses[i]);
+        }
+
+        if (firstSend)
         {
             ReturnErrorOnFailure(GlobalMinimalMdnsServer::Server().BroadcastUnicastQuery(builder.ReleasePacket(), kMdnsPort));
         }
@@ -722,12 +844,17 @@ CHIP_ERROR MinMdnsResolver::StartDiscovery(DiscoveryType type, DiscoveryFilter f
     // minmdns currently supports only one discovery context at a time so override the previous context
     SetDiscoveryContext(&context);
 
+    // Known answers only apply to the browse they were received in: responders must answer a new browse
+    // even if they were already discovered by an earlier one.
+    mKnownAnswers.Clear();
+
     return BrowseNodes(type, filter);
 }
 
 CHIP_ERROR MinMdnsResolver::StopDiscovery(DiscoveryContext & context)
 {
     SetDiscoveryContext(nullptr);
+    mKnownAnswers.Clear();
 
     return mActiveResolves.CompleteAllBrowses();
 }
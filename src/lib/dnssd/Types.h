@@ -200,7 +200,7 @@ struct CommonResolutionData
 struct OperationalNodeData
 {
     PeerId peerId;
-    bool hasZeroTTL;
+    bool hasZeroTTL = false;
     void Reset() { peerId = PeerId(); }
 };
 
@@ -19,6 +19,8 @@
 
 #include "QueryReplyFilter.h"
 
+#include <crypto/RandUtils.h>
+#include <lib/support/logging/CHIPLogging.h>
 #include <system/SystemClock.h>
 
 namespace mdns {
@@ -37,6 +39,21 @@ constexpr uint16_t kMdnsStandardPort = 5353;
 //    the header.
 constexpr uint16_t kPacketSizeBytes = 512;
 
+// Delay range for multicast answers made only of shared (non-unique) records: https://tools.ietf.org/html/rfc6762#section-6
+constexpr uint32_t kAggregationMinDelayMs = 20;
+constexpr uint32_t kAggregationMaxDelayMs = 120;
+
+/// Whether the record was multicast recently enough that it should not be multicast again.
+bool WasRecentlyMulticast(const QueryResponderRecord & record, chip::System::Clock::Timestamp now)
+{
+    // According to https://tools.ietf.org/html/rfc6762#section-6  we should multicast at most 1/sec
+    //
+    // TODO: the 'last sent' value does NOT track the interface we used to send, so this may cause
+    //       broadcasts on one interface to throttle broadcasts on another interface.
+    const chip::System::Clock::Timestamp cutoff = now - chip::System::Clock::Seconds32(1);
+    return (cutoff > chip::System::Clock::kZero) && (record.lastMulticastTime >= cutoff);
+}
+
 } // namespace
 namespace Internal {
 
@@ -52,6 +69,15 @@ bool ResponseSendingState::IncludeQuery() const
 
 } // namespace Internal
 
+ResponseSender::~ResponseSender()
+{
+    // Responders may already be gone, so only stop the timer.
+    if (mSystemLayer != nullptr)
+    {
+        mSystemLayer->CancelTimer(AggregationTimerFired, this);
+    }
+}
+
 CHIP_ERROR ResponseSender::AddQueryResponder(QueryResponderBase * queryResponder)
 {
     // If already existing or we find a free slot, just use it
@@ -107,24 +133,18 @@ CHIP_ERROR ResponseSender::Respond(uint16_t messageId, const QueryData & query,
 {
     mSendState.Reset(messageId, query, querySource);
 
+    if ((mSystemLayer != nullptr) && !query.IsAnnounceBroadcast() && !mSendState.SendUnicast() && HasOnlySharedAnswers(query))
+    {
+        return AggregateResponse(query, querySource, configuration);
+    }
+
     if (query.IsAnnounceBroadcast())
     {
         // Deny listing large amount of data
         mSendState.MarkWasSent(ResponseItemsSent::kServiceListingData);
     }
 
-    // Responder has a stateful 'additional replies required' that is used within the response
-    // loop. 'no additionals required' is set at the start and additionals are marked as the query
-    // reply is built.
-    for (auto & responder : mResponders)
-    {
-        {
-            if (responder != nullptr)
-            {
-                responder->ResetAdditionals();
-            }
-        }
-    }
+    ResetAdditionals();
 
     // send all 'Answer' replies
     {
@@ -135,14 +155,6 @@ CHIP_ERROR ResponseSender::Respond(uint16_t messageId, const QueryData & query,
 
         responseFilter.SetReplyFilter(&queryReplyFilter);
 
-        if (!mSendState.SendUnicast())
-        {
-            // According to https://tools.ietf.org/html/rfc6762#section-6  we should multicast at most 1/sec
-            //
-            // TODO: the 'last sent' value does NOT track the interface we used to send, so this may cause
-            //       broadcasts on one interface to throttle broadcasts on another interface.
-            responseFilter.SetIncludeOnlyMulticastBeforeMS(kTimeNow - chip::System::Clock::Seconds32(1));
-        }
         for (auto & responder : mResponders)
         {
             if (responder == nullptr)
@@ -151,6 +163,12 @@ CHIP_ERROR ResponseSender::Respond(uint16_t messageId, const QueryData & query,
             }
             for (auto it = responder->begin(&responseFilter); it != responder->end(); it++)
             {
+                if (!mSendState.SendUnicast() && WasRecentlyMulticast(*it, kTimeNow))
+                {
+                    mCounters.recordsSuppressed++;
+                    continue;
+                }
+
                 it->responder->AddAllResponses(querySource, this, configuration);
                 ReturnErrorOnFailure(mSendState.GetError());
 
@@ -164,37 +182,235 @@ CHIP_ERROR ResponseSender::Respond(uint16_t messageId, const QueryData & query,
         }
     }
 
-    // send all 'Additional' replies
+    ReturnErrorOnFailure(AddAdditionalResponses(query, querySource, configuration));
+
+    return FlushReply();
+}
+
+void ResponseSender::ResetAdditionals()
+{
+    // Responder has a stateful 'additional replies required' that is used within the response
+    // loop. 'no additionals required' is set at the start and additionals are marked as the query
+    // reply is built.
+    for (auto & responder : mResponders)
     {
-        if (!query.IsAnnounceBroadcast())
+        if (responder != nullptr)
         {
-            // Initial service broadcast should keep adding data as 'Answers' rather
-            // than addtional data (https://datatracker.ietf.org/doc/html/rfc6762#section-8.3)
-            mSendState.SetResourceType(ResourceType::kAdditional);
+            responder->ResetAdditionals();
         }
+    }
+}
 
-        QueryReplyFilter queryReplyFilter(query);
+CHIP_ERROR ResponseSender::AddAdditionalResponses(const QueryData & query, const chip::Inet::IPPacketInfo * querySource,
+                                                  const ResponseConfiguration & configuration)
+{
+    if (!query.IsAnnounceBroadcast())
+    {
+        // Initial service broadcast should keep adding data as 'Answers' rather
+        // than addtional data (https://datatracker.ietf.org/doc/html/rfc6762#section-8.3)
+        mSendState.SetResourceType(ResourceType::kAdditional);
+    }
 
-        queryReplyFilter.SetIgnoreNameMatch(true).SetSendingAdditionalItems(true);
+    QueryReplyFilter queryReplyFilter(query);
 
-        QueryResponderRecordFilter responseFilter;
-        responseFilter
-            .SetReplyFilter(&queryReplyFilter) //
-            .SetIncludeAdditionalRepliesOnly(true);
-        for (auto & responder : mResponders)
+    queryReplyFilter.SetIgnoreNameMatch(true).SetSendingAdditionalItems(true);
+
+    QueryResponderRecordFilter responseFilter;
+    responseFilter
+        .SetReplyFilter(&queryReplyFilter) //
+        .SetIncludeAdditionalRepliesOnly(true);
+    for (auto & responder : mResponders)
+    {
+        if (responder == nullptr)
         {
-            if (responder == nullptr)
+            continue;
+        }
+        for (auto it = responder->begin(&responseFilter); it != responder->end(); it++)
+        {
+            it->responder->AddAllResponses(querySource, this, configuration);
+            ReturnErrorOnFailure(mSendState.GetError());
+        }
+    }
+
+    return CHIP_NO_ERROR;
+}
+
+void ResponseSender::EnableResponseAggregation(chip::System::Layer * systemLayer)
+{
+    DisableResponseAggregation();
+    mSystemLayer = systemLayer;
+}
+
+void ResponseSender::DisableResponseAggregation()
+{
+    VerifyOrReturn(mSystemLayer != nullptr);
+
+    mSystemLayer->CancelTimer(AggregationTimerFired, this);
+    mSystemLayer               = nullptr;
+    mAggregatedResponsePending = false;
+    ClearPendingMulticast();
+}
+
+void ResponseSender::ClearPendingMulticast()
+{
+    for (auto & responder : mResponders)
+    {
+        if (responder != nullptr)
+        {
+            responder->ClearPendingMulticast();
+        }
+    }
+}
+
+bool ResponseSender::HasOnlySharedAnswers(const QueryData & query)
+{
+    QueryReplyFilter queryReplyFilter(query);
+    QueryResponderRecordFilter responseFilter;
+
+    responseFilter.SetReplyFilter(&queryReplyFilter);
+
+    for (auto & responder : mResponders)
+    {
+        if (responder == nullptr)
+        {
+            continue;
+        }
+        for (auto it = responder->begin(&responseFilter); it != responder->end(); it++)
+        {
+            // Only PTR records are shared among responders. Answers with a unique record
+            // (SRV, TXT, A, AAAA) must not be delayed: https://tools.ietf.org/html/rfc6762#section-6
+            if (it->responder->GetQType() != QType::PTR)
+            {
+                return false;
+            }
+        }
+    }
+    return true;
+}
+
+CHIP_ERROR ResponseSender::AggregateResponse(const QueryData & query, const chip::Inet::IPPacketInfo * querySource,
+                                             const ResponseConfiguration & configuration)
+{
+    if (mAggregatedResponsePending &&
+        ((mAggregatedSource.Interface != querySource->Interface) ||
+         (mAggregatedSource.SrcAddress.Type() != querySource->SrcAddress.Type()) ||
+         (mAggregatedConfiguration.GetTtlSecondsOverride() != configuration.GetTtlSecondsOverride())))
+    {
+        // The pending reply is multicast where its first query came from, so it cannot answer this one.
+        mSystemLayer->CancelTimer(AggregationTimerFired, this);
+        ReturnErrorOnFailure(SendAggregatedResponse());
+    }
+
+    const chip::System::Clock::Timestamp kTimeNow = chip::System::SystemClock().GetMonotonicTimestamp();
+
+    QueryReplyFilter queryReplyFilter(query);
+    QueryResponderRecordFilter responseFilter;
+
+    responseFilter.SetReplyFilter(&queryReplyFilter);
+
+    // Only select the answers here: they are written out, along with their additional records,
+    // once the aggregation delay expires.
+    bool hasAnswers = false;
+    for (auto & responder : mResponders)
+    {
+        if (responder == nullptr)
+        {
+            continue;
+        }
+        for (auto it = responder->begin(&responseFilter); it != responder->end(); it++)
+        {
+            if (WasRecentlyMulticast(*it, kTimeNow))
             {
+                mCounters.recordsSuppressed++;
                 continue;
             }
-            for (auto it = responder->begin(&responseFilter); it != responder->end(); it++)
+            it.GetInternal()->pendingMulticast = true;
+            hasAnswers                         = true;
+        }
+    }
+
+    VerifyOrReturnError(hasAnswers, CHIP_NO_ERROR);
+
+    if (mAggregatedResponsePending)
+    {
+        mCounters.queriesAggregated++;
+        return CHIP_NO_ERROR;
+    }
+
+    mAggregatedResponsePending = true;
+    mAggregatedSource          = *querySource;
+    mAggregatedConfiguration   = configuration;
+
+    const uint32_t delayMs =
+        kAggregationMinDelayMs + chip::Crypto::GetRandU32() % (kAggregationMaxDelayMs - kAggregationMinDelayMs + 1);
+
+    CHIP_ERROR err = mSystemLayer->StartTimer(chip::System::Clock::Milliseconds32(delayMs), AggregationTimerFired, this);
+    if (err != CHIP_NO_ERROR)
+    {
+        // Better to reply right away than not at all.
+        return SendAggregatedResponse();
+    }
+
+    return CHIP_NO_ERROR;
+}
+
+void ResponseSender::AggregationTimerFired(chip::System::Layer * systemLayer, void * context)
+{
+    CHIP_ERROR err = static_cast<ResponseSender *>(context)->SendAggregatedResponse();
+    if (err != CHIP_NO_ERROR)
+    {
+        ChipLogError(Discovery, "Failed to send aggregated mDNS reply: %" CHIP_ERROR_FORMAT, err.Format());
+    }
+}
+
+CHIP_ERROR ResponseSender::SendAggregatedResponse()
+{
+    VerifyOrReturnError(mAggregatedResponsePending, CHIP_NO_ERROR);
+    mAggregatedResponsePending = false;
+
+    // The answers were selected as the queries came in, so this only needs to stand in for them
+    // when selecting additional records.
+    const QueryData query(QType::ANY, QClass::ANY, false /* unicast */);
+    mSendState.Reset(0, query, &mAggregatedSource);
+
+    ResetAdditionals();
+
+    const chip::System::Clock::Timestamp kTimeNow = chip::System::SystemClock().GetMonotonicTimestamp();
+
+    QueryResponderRecordFilter responseFilter;
+    responseFilter.SetIncludePendingMulticastOnly(true);
+
+    for (auto & responder : mResponders)
+    {
+        if (responder == nullptr)
+        {
+            continue;
+        }
+        for (auto it = responder->begin(&responseFilter); it != responder->end(); it++)
+        {
+            it.GetInternal()->pendingMulticast = false;
+
+            // May have been announced since the query was received.
+            if (WasRecentlyMulticast(*it, kTimeNow))
             {
-                it->responder->AddAllResponses(querySource, this, configuration);
-                ReturnErrorOnFailure(mSendState.GetError());
+                mCounters.recordsSuppressed++;
+                continue;
+            }
+
+            it->responder->AddAllResponses(&mAggregatedSource, this, mAggregatedConfiguration);
+            if (mSendState.GetError() != CHIP_NO_ERROR)
+            {
+                ClearPendingMulticast();
+                return mSendState.GetError();
             }
+
+            responder->MarkAdditionalRepliesFor(it);
+            it->lastMulticastTime = kTimeNow;
         }
     }
 
+    ReturnErrorOnFailure(AddAdditionalResponses(query, &mAggregatedSource, mAggregatedConfiguration));
+
     return FlushReply();
 }
 
@@ -215,6 +431,7 @@ CHIP_ERROR ResponseSender::FlushReply()
 #endif
             ReturnErrorOnFailure(mServer->DirectSend(mResponseBuilder.ReleasePacket(), mSendState.GetSourceAddress(),
                                                      mSendState.GetSourcePort(), mSendState.GetSourceInterfaceId()));
+            mCounters.packetsSent++;
         }
         else
         {
@@ -223,6 +440,7 @@ CHIP_ERROR ResponseSender::FlushReply()
 #endif
             ReturnErrorOnFailure(mServer->BroadcastSend(mResponseBuilder.ReleasePacket(), kMdnsStandardPort,
                                                         mSendState.GetSourceInterfaceId(), mSendState.GetSourceAddress().Type()));
+            mCounters.packetsSent++;
         }
     }
 
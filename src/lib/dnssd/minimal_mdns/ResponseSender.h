@@ -23,6 +23,7 @@
 
 #include <lib/dnssd/minimal_mdns/responders/QueryResponder.h>
 
+#include <system/SystemLayer.h>
 #include <system/SystemPacketBuffer.h>
 
 #if CHIP_CONFIG_MINMDNS_DYNAMIC_OPERATIONAL_RESPONDER_LIST
@@ -125,10 +126,22 @@ private:
 ///
 /// Handles processing the query via a QueryResponderBase and then sending back the reply
 /// using appropriate paths (unicast or multicast) via the given Server.
+///
+/// Records are multicast at most once per second (RFC 6762 Section 6). When response
+/// aggregation is enabled, multicast replies are also delayed a little, so that the answers
+/// to all queries received meanwhile go out as a single packet.
 class ResponseSender : public ResponderDelegate
 {
 public:
+    struct Counters
+    {
+        uint32_t packetsSent       = 0; // reply packets sent, unicast or multicast
+        uint32_t recordsSuppressed = 0; // answers not multicast because they were multicast within the last second
+        uint32_t queriesAggregated = 0; // queries answered by a multicast reply already pending for an earlier query
+    };
+
     ResponseSender(ServerBase * server) : mServer(server) {}
+    ~ResponseSender() override;
 
     CHIP_ERROR AddQueryResponder(QueryResponderBase * queryResponder);
     CHIP_ERROR RemoveQueryResponder(QueryResponderBase * queryResponder);
@@ -145,7 +158,32 @@ public:
 
     void SetServer(ServerBase * server) { mServer = server; }
 
+    /// Delay multicast replies made only of shared (PTR) records by a random 20-120 ms, answering
+    /// all such queries received on the same interface in the meantime with a single packet.
+    ///
+    /// Replies that include a unique record (SRV, TXT, A, AAAA), unicast replies and announcements
+    /// are always sent immediately, as RFC 6762 Section 6 requires.
+    void EnableResponseAggregation(chip::System::Layer * systemLayer);
+
+    /// Go back to replying immediately. Drops any multicast reply still being aggregated.
+    void DisableResponseAggregation();
+
+    const Counters & GetCounters() const { return mCounters; }
+    void ResetCounters() { mCounters = Counters(); }
+
 private:
+    static void AggregationTimerFired(chip::System::Layer * systemLayer, void * context);
+
+    CHIP_ERROR AggregateResponse(const QueryData & query, const chip::Inet::IPPacketInfo * querySource,
+                                 const ResponseConfiguration & configuration);
+    CHIP_ERROR SendAggregatedResponse();
+    void ClearPendingMulticast();
+    bool HasOnlySharedAnswers(const QueryData & query);
+
+    void ResetAdditionals();
+    CHIP_ERROR AddAdditionalResponses(const QueryData & query, const chip::Inet::IPPacketInfo * querySource,
+                                      const ResponseConfiguration & configuration);
+
     CHIP_ERROR FlushReply();
     CHIP_ERROR PrepareNewReplyPacket();
 
@@ -155,6 +193,14 @@ private:
     /// Current send state
     ResponseBuilder mResponseBuilder;          // packet being built
     Internal::ResponseSendingState mSendState; // sending state
+
+    /// Aggregated multicast reply state: the reply goes out where the first query it answers came from.
+    chip::System::Layer * mSystemLayer = nullptr; // set while response aggregation is enabled
+    bool mAggregatedResponsePending    = false;
+    chip::Inet::IPPacketInfo mAggregatedSource;
+    ResponseConfiguration mAggregatedConfiguration;
+
+    Counters mCounters;
 };
 
 } // namespace Minimal
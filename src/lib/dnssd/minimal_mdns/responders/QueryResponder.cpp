@@ -176,5 +176,13 @@ void QueryResponderBase::ClearBroadcastThrottle()
     }
 }
 
+void QueryResponderBase::ClearPendingMulticast()
+{
+    for (size_t i = 0; i < mResponderInfoSize; i++)
+    {
+        mResponderInfos[i].pendingMulticast = false;
+    }
+}
+
 } // namespace Minimal
 } // namespace mdns
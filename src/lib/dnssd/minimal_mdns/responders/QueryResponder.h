@@ -39,7 +39,8 @@ namespace Internal {
 /// Internal information for query responder records.
 struct QueryResponderInfo : public QueryResponderRecord
 {
-    bool reportNowAsAdditional; // report as additional data required
+    bool reportNowAsAdditional;    // report as additional data required
+    bool pendingMulticast = false; // answer is part of a multicast reply that is being aggregated
 
     bool alsoReportAdditionalQName = false; // report more data when this record is listed
     FullQName additionalQName;              // if alsoReportAdditionalQName is set, send this extra data
@@ -49,6 +50,7 @@ struct QueryResponderInfo : public QueryResponderRecord
         responder                 = nullptr;
         reportService             = false;
         reportNowAsAdditional     = false;
+        pendingMulticast          = false;
         alsoReportAdditionalQName = false;
     }
 };
@@ -112,6 +114,13 @@ public:
         return *this;
     }
 
+    /// Set if to include only items that are part of a pending aggregated multicast reply.
+    QueryResponderRecordFilter & SetIncludePendingMulticastOnly(bool includePendingMulticastOnly)
+    {
+        mIncludePendingMulticastOnly = includePendingMulticastOnly;
+        return *this;
+    }
+
     /// Filter out anything rejected by the given reply filter.
     /// If replyFilter is nullptr, no such filtering is applied.
     QueryResponderRecordFilter & SetReplyFilter(ReplyFilter * replyFilter)
@@ -140,6 +149,11 @@ public:
             return false;
         }
 
+        if (mIncludePendingMulticastOnly && !record->pendingMulticast)
+        {
+            return false;
+        }
+
         if ((mIncludeOnlyMulticastBefore > chip::System::Clock::kZero) &&
             (record->lastMulticastTime >= mIncludeOnlyMulticastBefore))
         {
@@ -156,6 +170,7 @@ public:
 
 private:
     bool mIncludeAdditionalRepliesOnly                         = false;
+    bool mIncludePendingMulticastOnly                          = false;
     ReplyFilter * mReplyFilter                                 = nullptr;
     chip::System::Clock::Timestamp mIncludeOnlyMulticastBefore = chip::System::Clock::kZero;
 };
@@ -275,6 +290,9 @@ public:
     /// of all packets without a timedelay.
     void ClearBroadcastThrottle();
 
+    /// Drops all answers from any pending aggregated multicast reply.
+    void ClearPendingMulticast();
+
 private:
     Internal::QueryResponderInfo * mResponderInfos;
     size_t mResponderInfoSize;
@@ -233,9 +233,21 @@ public:
             TestGotAllExpectedPackets();
         }
         mSendCalled = true;
+        mSendCount++;
         return CHIP_NO_ERROR;
     }
 
+    using ServerBase::BroadcastSend;
+    CHIP_ERROR BroadcastSend(chip::System::PacketBufferHandle && data, uint16_t port, chip::Inet::InterfaceId interface,
+                             chip::Inet::IPAddressType addressType) override
+    {
+        if (!mCheckBroadcasts)
+        {
+            return ServerBase::BroadcastSend(std::move(data), port, interface, addressType);
+        }
+        return DirectSend(std::move(data), chip::Inet::IPAddress::Any, port, interface);
+    }
+
     // Functions used for controlling testing.
     void AddExpectedRecord(PtrResourceRecord * ptr)
     {
@@ -267,6 +279,9 @@ public:
         info->target = kIgnoreQname;
     }
     bool GetSendCalled() { return mSendCalled; }
+    size_t GetSendCount() { return mSendCount; }
+    // Check multicast replies like unicast ones, instead of sending them to the (absent) endpoints.
+    void SetCheckBroadcasts(bool checkBroadcasts) { mCheckBroadcasts = checkBroadcasts; }
     bool GetHeaderFound() { return mHeaderFound; }
     void Reset()
     {
@@ -277,6 +292,7 @@ public:
         }
         mHeaderFound  = false;
         mSendCalled   = false;
+        mSendCount    = 0;
         mTotalRecords = 0;
         ClearTxtRecords();
     }
@@ -311,6 +327,8 @@ private:
     size_t mNumReceivedTxtRecords = 0;
     bool mHeaderFound             = false;
     bool mSendCalled              = false;
+    bool mCheckBroadcasts         = false;
+    size_t mSendCount             = 0;
     int mTotalRecords             = 0;
     FullQName kIgnoreQname        = FullQName(kIgnoreQNameParts);
     BytesRange mPacketData;
@@ -0,0 +1,252 @@
+/*
+ *
+ *    Copyright (c) 2024 Project CHIP Authors
+ *
+ *    Licensed under the Apache License, Version 2.0 (the "License");
+ *    you may not use this file except in compliance with the License.
+ *    You may obtain a copy of the License at
+ *
+ *        http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *    Unless required by applicable law or agreed to in writing, software
+ *    distributed under the License is distributed on an "AS IS" BASIS,
+ *    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *    See the License for the specific language governing permissions and
+ *    limitations under the License.
+ */
+
+#include <vector>
+
+#include <pw_unit_test/framework.h>
+
+#include <lib/core/StringBuilderAdapters.h>
+#include <lib/dnssd/MinimalMdnsServer.h>
+#include <lib/dnssd/Resolver.h>
+#include <lib/dnssd/minimal_mdns/Parser.h>
+#include <lib/dnssd/minimal_mdns/RecordData.h>
+#include <lib/dnssd/minimal_mdns/ResponseBuilder.h>
+#include <lib/dnssd/minimal_mdns/Server.h>
+#include <lib/dnssd/minimal_mdns/core/tests/QNameStrings.h>
+#include <lib/dnssd/minimal_mdns/records/Ptr.h>
+#include <lib/support/CHIPMem.h>
+#include <lib/support/logging/CHIPLogging.h>
+#include <transport/raw/tests/NetworkTestHelpers.h>
+
+namespace {
+
+using namespace chip;
+using namespace chip::Dnssd;
+using namespace chip::System::Clock::Literals;
+using namespace mdns::Minimal;
+
+const auto kCommissionableService = testing::TestQName<3>({ "_matterc", "_udp", "local" });
+
+/// Commissionable nodes answering the browse queries of the resolver.
+const testing::TestQName<4> kDevices[] = {
+    testing::TestQName<4>({ "0000000000000001", "_matterc", "_udp", "local" }),
+    testing::TestQName<4>({ "0000000000000002", "_matterc", "_udp", "local" }),
+    testing::TestQName<4>({ "0000000000000003", "_matterc", "_udp", "local" }),
+    testing::TestQName<4>({ "0000000000000004", "_matterc", "_udp", "local" }),
+    testing::TestQName<4>({ "0000000000000005", "_matterc", "_udp", "local" }),
+};
+
+/// Replaces the mDNS server: queries sent by the resolver are answered by every device that is not listed as a
+/// known answer in the query, like a responder implementing RFC 6762 Section 7.1 would do.
+class RespondingServer : private chip::PoolImpl<ServerBase::EndpointInfo, 0, chip::ObjectPoolMem::kInline,
+                                                ServerBase::EndpointInfoPoolType::Interface>,
+                         public ServerBase,
+                         public ParserDelegate
+{
+public:
+    struct SentQuery
+    {
+        size_t browseQuestions = 0;
+        size_t knownAnswers    = 0;
+        size_t responses       = 0;
+    };
+
+    RespondingServer() : ServerBase(*static_cast<ServerBase::EndpointInfoPoolType *>(this)) {}
+
+    using ServerBase::BroadcastSend;
+    using ServerBase::BroadcastUnicastQuery;
+
+    CHIP_ERROR BroadcastUnicastQuery(System::PacketBufferHandle && data, uint16_t port) override
+    {
+        return OnQuerySent(std::move(data));
+    }
+
+    CHIP_ERROR BroadcastSend(System::PacketBufferHandle && data, uint16_t port) override { return OnQuerySent(std::move(data)); }
+
+    /// Delivers the responses to the queries sent so far to the resolver.
+    void DeliverResponses()
+    {
+        std::vector<size_t> pending;
+        pending.swap(mPendingResponses);
+
+        for (size_t device : pending)
+        {
+            System::PacketBufferHandle buffer = System::PacketBufferHandle::New(512);
+            ASSERT_FALSE(buffer.IsNull());
+
+            ResponseBuilder builder(std::move(buffer));
+            builder.Header().SetMessageId(0);
+            PtrResourceRecord record(kCommissionableService.Full(), kDevices[device].Full());
+            record.SetTtl(120);
+            builder.AddRecord(ResourceType::kAnswer, record);
+            ASSERT_TRUE(builder.Ok());
+
+            System::PacketBufferHandle packet = builder.ReleasePacket();
+            Inet::IPPacketInfo packetInfo;
+            packetInfo.Clear();
+            GlobalMinimalMdnsServer::Instance().OnResponse(BytesRange(packet->Start(), packet->Start() + packet->DataLength()),
+                                                           &packetInfo);
+        }
+    }
+
+    std::vector<SentQuery> & SentQueries() { return mSentQueries; }
+
+    // ParserDelegate
+    void OnHeader(ConstHeaderRef & header) override {}
+
+    void OnQuery(const QueryData & data) override
+    {
+        if (data.GetName() == kCommissionableService.Full())
+        {
+            mCurrent.browseQuestions++;
+        }
+    }
+
+    void OnResource(ResourceType type, const ResourceData & data) override
+    {
+        SerializedQNameIterator target;
+        if (type != ResourceType::kAnswer || data.GetType() != QType::PTR || !ParsePtrRecord(data.GetData(), mPacket, &target))
+        {
+            return;
+        }
+
+        mCurrent.knownAnswers++;
+        for (size_t i = 0; i < ArraySize(kDevices); i++)
+        {
+            mKnown[i] = mKnown[i] || (target == kDevices[i].Full());
+        }
+    }
+
+private:
+    CHIP_ERROR OnQuerySent(System::PacketBufferHandle && data)
+    {
+        mPacket  = BytesRange(data->Start(), data->Start() + data->DataLength());
+        mCurrent = SentQuery();
+        for (bool & known : mKnown)
+        {
+            known = false;
+        }
+        EXPECT_TRUE(ParsePacket(mPacket, this));
+
+        // Responses are delivered later, as they would come from the network.
+        for (size_t i = 0; (i < ArraySize(kDevices)) && (mCurrent.browseQuestions > 0); i++)
+        {
+            if (!mKnown[i])
+            {
+                mPendingResponses.push_back(i);
+                mCurrent.responses++;
+            }
+        }
+        mSentQueries.push_back(mCurrent);
+        return CHIP_NO_ERROR;
+    }
+
+    BytesRange mPacket;
+    SentQuery mCurrent;
+    bool mKnown[ArraySize(kDevices)] = {};
+    std::vector<SentQuery> mSentQueries;
+    std::vector<size_t> mPendingResponses;
+};
+
+class TestResolver : public ::testing::Test
+{
+public:
+    static chip::Test::IOContext context;
+    static RespondingServer server;
+
+    static void SetUpTestSuite()
+    {
+        chip::Platform::MemoryInit();
+        context.Init();
+        GlobalMinimalMdnsServer::Instance().Server().Shutdown();
+        GlobalMinimalMdnsServer::Instance().SetReplacementServer(&server);
+        Resolver::Instance().Init(context.GetUDPEndPointManager());
+    }
+    static void TearDownTestSuite()
+    {
+        Resolver::Instance().Shutdown();
+        context.Shutdown();
+        GlobalMinimalMdnsServer::Instance().SetReplacementServer(nullptr);
+        chip::Platform::MemoryShutdown();
+    }
+
+    void TearDown() override { server.SentQueries().clear(); }
+
+protected:
+    /// Starts browsing for commissionable nodes and returns the query sent for the browse.
+    RespondingServer::SentQuery StartBrowse()
+    {
+        server.SentQueries().clear();
+        EXPECT_EQ(Resolver::Instance().StartDiscovery(DiscoveryType::kCommissionableNode, DiscoveryFilter(), mDiscoveryContext),
+                  CHIP_NO_ERROR);
+        EXPECT_EQ(server.SentQueries().size(), 1u);
+        RespondingServer::SentQuery query = server.SentQueries().empty() ? RespondingServer::SentQuery() : server.SentQueries()[0];
+        EXPECT_EQ(query.browseQuestions, 1u);
+
+        server.DeliverResponses();
+        return query;
+    }
+
+    // Never released to 0 by the resolver, as this holds a reference.
+    DiscoveryContext mDiscoveryContext;
+};
+
+chip::Test::IOContext TestResolver::context;
+RespondingServer TestResolver::server;
+
+TEST_F(TestResolver, TestBackToBackBrowses)
+{
+    RespondingServer::SentQuery query = StartBrowse();
+    EXPECT_EQ(query.knownAnswers, 0u);
+    EXPECT_EQ(query.responses, ArraySize(kDevices));
+
+    // Devices found by a browse that was stopped are not known answers of the next browse.
+    EXPECT_EQ(Resolver::Instance().StopDiscovery(mDiscoveryContext), CHIP_NO_ERROR);
+    query = StartBrowse();
+    EXPECT_EQ(query.knownAnswers, 0u);
+    EXPECT_EQ(query.responses, ArraySize(kDevices));
+
+    // Nor those of a browse replaced by a new one.
+    query = StartBrowse();
+    EXPECT_EQ(query.knownAnswers, 0u);
+    EXPECT_EQ(query.responses, ArraySize(kDevices));
+
+    EXPECT_EQ(Resolver::Instance().StopDiscovery(mDiscoveryContext), CHIP_NO_ERROR);
+}
+
+TEST_F(TestResolver, TestRetryListsKnownAnswers)
+{
+    RespondingServer::SentQuery query = StartBrowse();
+    EXPECT_EQ(query.responses, ArraySize(kDevices));
+
+    // The first retry is sent a second after the first query.
+    context.DriveIOUntil(3000_ms, [] { return server.SentQueries().size() > 1; });
+    ASSERT_EQ(server.SentQueries().size(), 2u);
+
+    // All the devices were discovered by the first query, so none answers the retry.
+    RespondingServer::SentQuery retry = server.SentQueries()[1];
+    EXPECT_EQ(retry.browseQuestions, 1u);
+    EXPECT_EQ(retry.knownAnswers, ArraySize(kDevices));
+    EXPECT_EQ(retry.responses, 0u);
+    ChipLogProgress(Test, "Browse with %u responders: %u responses to the query, %u to the retry with %u known answers",
+                    static_cast<unsigned>(ArraySize(kDevices)), static_cast<unsigned>(query.responses),
+                    static_cast<unsigned>(retry.responses), static_cast<unsigned>(retry.knownAnswers));
+
+    EXPECT_EQ(Resolver::Instance().StopDiscovery(mDiscoveryContext), CHIP_NO_ERROR);
+}
+
+} // namespace
@@ -31,11 +31,13 @@
 #include <lib/dnssd/minimal_mdns/responders/Txt.h>
 #include <lib/dnssd/minimal_mdns/tests/CheckOnlyServer.h>
 #include <lib/support/CHIPMem.h>
+#include <transport/raw/tests/NetworkTestHelpers.h>
 
 namespace {
 
 using namespace std;
 using namespace chip;
+using namespace chip::System::Clock::Literals;
 using namespace mdns::Minimal;
 using namespace mdns::Minimal::test;
 
@@ -351,4 +353,114 @@ TEST_F(TestResponseSender, PtrSrvTxtMultipleRespondersToServiceListing)
     EXPECT_TRUE(common1->server.GetHeaderFound());
 }
 
+class TestResponseSenderAggregation : public ::testing::Test
+{
+public:
+    static chip::Test::IOContext context;
+
+    static void SetUpTestSuite() { ASSERT_EQ(context.Init(), CHIP_NO_ERROR); }
+    static void TearDownTestSuite() { context.Shutdown(); }
+};
+
+chip::Test::IOContext TestResponseSenderAggregation::context;
+
+TEST_F(TestResponseSenderAggregation, SharedMulticastRepliesAreAggregated)
+{
+    CommonTestElements common("test");
+    common.server.SetCheckBroadcasts(true);
+    common.packetInfo.SrcPort = 5353; // Multicast reply
+
+    ResponseSender responseSender(&common.server);
+    EXPECT_EQ(responseSender.AddQueryResponder(&common.queryResponder), CHIP_NO_ERROR);
+    common.queryResponder.AddResponder(&common.ptrResponder).SetReportAdditional(common.instance);
+    common.queryResponder.AddResponder(&common.srvResponder);
+    common.queryResponder.AddResponder(&common.txtResponder);
+    responseSender.EnableResponseAggregation(&context.GetSystemLayer());
+
+    // Two browse queries for the service, answered by a single reply.
+    common.recordWriter.WriteQName(common.service);
+    QueryData ptrQuery = QueryData(QType::PTR, QClass::IN, false, common.requestNameStart, common.requestBytesRange);
+
+    common.server.AddExpectedRecord(&common.ptrRecord);
+    common.server.AddExpectedRecord(&common.srvRecord);
+    common.server.AddExpectedRecord(&common.txtRecord);
+
+    EXPECT_EQ(responseSender.Respond(1, ptrQuery, &common.packetInfo, ResponseConfiguration()), CHIP_NO_ERROR);
+    EXPECT_EQ(responseSender.Respond(2, ptrQuery, &common.packetInfo, ResponseConfiguration()), CHIP_NO_ERROR);
+    EXPECT_FALSE(common.server.GetSendCalled());
+
+    context.DriveIOUntil(1_s, [&common] { return common.server.GetSendCalled(); });
+
+    EXPECT_TRUE(common.server.GetSendCalled());
+    EXPECT_TRUE(common.server.GetHeaderFound());
+    EXPECT_EQ(common.server.GetSendCount(), 1u);
+    EXPECT_EQ(responseSender.GetCounters().packetsSent, 1u);
+    EXPECT_EQ(responseSender.GetCounters().queriesAggregated, 1u);
+    EXPECT_EQ(responseSender.GetCounters().recordsSuppressed, 0u);
+
+    // The same records are not multicast again within a second.
+    common.server.Reset();
+    EXPECT_EQ(responseSender.Respond(3, ptrQuery, &common.packetInfo, ResponseConfiguration()), CHIP_NO_ERROR);
+    context.DriveIOUntil(200_ms, [&common] { return common.server.GetSendCalled(); });
+
+    EXPECT_FALSE(common.server.GetSendCalled());
+    EXPECT_EQ(responseSender.GetCounters().packetsSent, 1u);
+    EXPECT_EQ(responseSender.GetCounters().recordsSuppressed, 1u);
+
+    responseSender.DisableResponseAggregation();
+}
+
+TEST_F(TestResponseSenderAggregation, UniqueMulticastRepliesAreImmediate)
+{
+    CommonTestElements common("test");
+    common.server.SetCheckBroadcasts(true);
+    common.packetInfo.SrcPort = 5353; // Multicast reply
+
+    ResponseSender responseSender(&common.server);
+    EXPECT_EQ(responseSender.AddQueryResponder(&common.queryResponder), CHIP_NO_ERROR);
+    common.queryResponder.AddResponder(&common.srvResponder);
+    common.queryResponder.AddResponder(&common.txtResponder);
+    responseSender.EnableResponseAggregation(&context.GetSystemLayer());
+
+    // SRV and TXT records are unique to this responder, so the reply is not delayed.
+    common.recordWriter.WriteQName(common.instance);
+    QueryData queryData = QueryData(QType::ANY, QClass::IN, false, common.requestNameStart, common.requestBytesRange);
+
+    common.server.AddExpectedRecord(&common.srvRecord);
+    common.server.AddExpectedRecord(&common.txtRecord);
+    EXPECT_EQ(responseSender.Respond(1, queryData, &common.packetInfo, ResponseConfiguration()), CHIP_NO_ERROR);
+
+    EXPECT_TRUE(common.server.GetSendCalled());
+    EXPECT_TRUE(common.server.GetHeaderFound());
+    EXPECT_EQ(responseSender.GetCounters().packetsSent, 1u);
+    EXPECT_EQ(responseSender.GetCounters().queriesAggregated, 0u);
+
+    responseSender.DisableResponseAggregation();
+}
+
+TEST_F(TestResponseSenderAggregation, UnicastRepliesAreImmediate)
+{
+    CommonTestElements common("test");
+    common.server.SetCheckBroadcasts(true);
+
+    ResponseSender responseSender(&common.server);
+    EXPECT_EQ(responseSender.AddQueryResponder(&common.queryResponder), CHIP_NO_ERROR);
+    common.queryResponder.AddResponder(&common.srvResponder);
+    responseSender.EnableResponseAggregation(&context.GetSystemLayer());
+
+    // Queries from a port other than 5353 are answered by unicast, without delay.
+    common.recordWriter.WriteQName(common.instance);
+    QueryData queryData = QueryData(QType::SRV, QClass::IN, false, common.requestNameStart, common.requestBytesRange);
+
+    common.server.AddExpectedRecord(&common.srvRecord);
+    EXPECT_EQ(responseSender.Respond(1, queryData, &common.packetInfo, ResponseConfiguration()), CHIP_NO_ERROR);
+
+    EXPECT_TRUE(common.server.GetSendCalled());
+    EXPECT_TRUE(common.server.GetHeaderFound());
+    EXPECT_EQ(responseSender.GetCounters().packetsSent, 1u);
+    EXPECT_EQ(responseSender.GetCounters().queriesAggregated, 0u);
+
+    responseSender.DisableResponseAggregation();
+}
+
 } // namespace
@@ -0,0 +1,209 @@
+/*
+ *
+ *    Copyright (c) 2024 Project CHIP Authors
+ *
+ *    Licensed under the Apache License, Version 2.0 (the "License");
+ *    you may not use this file except in compliance with the License.
+ *    You may obtain a copy of the License at
+ *
+ *        http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *    Unless required by applicable law or agreed to in writing, software
+ *    distributed under the License is distributed on an "AS IS" BASIS,
+ *    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *    See the License for the specific language governing permissions and
+ *    limitations under the License.
+ */
+
+#include <lib/dnssd/KnownAnswerCache.h>
+
+#include <pw_unit_test/framework.h>
+
+#include <lib/core/StringBuilderAdapters.h>
+#include <lib/dnssd/minimal_mdns/Parser.h>
+#include <lib/dnssd/minimal_mdns/QueryBuilder.h>
+#include <lib/dnssd/minimal_mdns/core/tests/QNameStrings.h>
+
+#include <cstdio>
+#include <vector>
+
+namespace {
+
+using namespace chip;
+using namespace chip::System::Clock::Literals;
+using namespace mdns::Minimal;
+
+const auto kCommissionableService = testing::TestQName<3>({ "_matterc", "_udp", "local" });
+const auto kCommissionerService   = testing::TestQName<3>({ "_matterd", "_udp", "local" });
+const auto kInstance1             = testing::TestQName<4>({ "C5038835313B8B98", "_matterc", "_udp", "local" });
+const auto kInstance2             = testing::TestQName<4>({ "0123456789ABCDEF", "_matterc", "_udp", "local" });
+const auto kCommissioner          = testing::TestQName<4>({ "C5038835313B8B98", "_matterd", "_udp", "local" });
+
+/// Collects the TTLs of the known answers listed for the given name.
+std::vector<uint32_t> KnownAnswerTtls(KnownAnswerCache & cache, const FullQName & name)
+{
+    std::vector<uint32_t> ttls;
+    cache.ForEachKnownAnswer(name, [&ttls](const PtrResourceRecord & record) {
+        ttls.push_back(record.GetTtl());
+        return Loop::Continue;
+    });
+    return ttls;
+}
+
+class CountingDelegate : public ParserDelegate
+{
+public:
+    void OnHeader(ConstHeaderRef & header) override { isQuery = header.GetFlags().IsQuery(); }
+    void OnQuery(const QueryData & data) override { queries++; }
+    void OnResource(ResourceType type, const ResourceData & data) override
+    {
+        if (type == ResourceType::kAnswer && data.GetType() == QType::PTR)
+        {
+            knownAnswers++;
+        }
+    }
+
+    bool isQuery        = false;
+    size_t queries      = 0;
+    size_t knownAnswers = 0;
+};
+
+TEST(TestKnownAnswerCache, TestAddAndList)
+{
+    System::Clock::Internal::MockClock mockClock;
+    KnownAnswerCache cache(&mockClock);
+
+    EXPECT_TRUE(KnownAnswerTtls(cache, kCommissionableService.Full()).empty());
+
+    cache.Add(kCommissionableService.Serialized(), kInstance1.Serialized(), 120);
+    cache.Add(kCommissionableService.Serialized(), kInstance2.Serialized(), 120);
+    cache.Add(kCommissionerService.Serialized(), kCommissioner.Serialized(), 120);
+
+    EXPECT_EQ(KnownAnswerTtls(cache, kCommissionableService.Full()), (std::vector<uint32_t>{ 120, 120 }));
+    EXPECT_EQ(KnownAnswerTtls(cache, kCommissionerService.Full()), (std::vector<uint32_t>{ 120 }));
+
+    // Adding the same record again refreshes it rather than duplicating it.
+    mockClock.AdvanceMonotonic(10_s);
+    cache.Add(kCommissionableService.Serialized(), kInstance1.Serialized(), 120);
+    EXPECT_EQ(KnownAnswerTtls(cache, kCommissionableService.Full()), (std::vector<uint32_t>{ 120, 110 }));
+
+    cache.Clear();
+    EXPECT_TRUE(KnownAnswerTtls(cache, kCommissionableService.Full()).empty());
+    EXPECT_TRUE(KnownAnswerTtls(cache, kCommissionerService.Full()).empty());
+}
+
+TEST(TestKnownAnswerCache, TestHalfTtlAndGoodbye)
+{
+    System::Clock::Internal::MockClock mockClock;
+    KnownAnswerCache cache(&mockClock);
+
+    cache.Add(kCommissionableService.Serialized(), kInstance1.Serialized(), 120);
+    cache.Add(kCommissionableService.Serialized(), kInstance2.Serialized(), 120);
+
+    // Still listed at exactly half of the TTL, with the remaining TTL.
+    mockClock.AdvanceMonotonic(60_s);
+    EXPECT_EQ(KnownAnswerTtls(cache, kCommissionableService.Full()), (std::vector<uint32_t>{ 60, 60 }));
+
+    // Past half of the TTL records are left out so that responders refresh them.
+    mockClock.AdvanceMonotonic(1_s);
+    EXPECT_TRUE(KnownAnswerTtls(cache, kCommissionableService.Full()).empty());
+
+    // A goodbye record (TTL 0) removes the record.
+    cache.Add(kCommissionableService.Serialized(), kInstance1.Serialized(), 120);
+    cache.Add(kCommissionableService.Serialized(), kInstance2.Serialized(), 120);
+    cache.Add(kCommissionableService.Serialized(), kInstance2.Serialized(), 0);
+    EXPECT_EQ(KnownAnswerTtls(cache, kCommissionableService.Full()), (std::vector<uint32_t>{ 120 }));
+}
+
+TEST(TestKnownAnswerCache, TestEvictsClosestToExpiry)
+{
+    System::Clock::Internal::MockClock mockClock;
+    KnownAnswerCache cache(&mockClock);
+
+    // Fill the cache: the first record expires first.
+    cache.Add(kCommissionerService.Serialized(), kCommissioner.Serialized(), 100);
+    for (size_t i = 1; i < KnownAnswerCache::kCacheSize; i++)
+    {
+        char instanceName[17];
+        snprintf(instanceName, sizeof(instanceName), "%016X", static_cast<unsigned>(i));
+        const auto instance = testing::TestQName<4>({ instanceName, "_matterc", "_udp", "local" });
+        cache.Add(kCommissionableService.Serialized(), instance.Serialized(), static_cast<uint32_t>(1000 + i));
+    }
+    EXPECT_EQ(KnownAnswerTtls(cache, kCommissionableService.Full()).size(), KnownAnswerCache::kCacheSize - 1);
+    EXPECT_EQ(KnownAnswerTtls(cache, kCommissionerService.Full()).size(), 1u);
+
+    // A new record replaces the one closest to expiry.
+    cache.Add(kCommissionableService.Serialized(), kInstance2.Serialized(), 120);
+    EXPECT_TRUE(KnownAnswerTtls(cache, kCommissionerService.Full()).empty());
+}
+
+TEST(TestKnownAnswerCache, TestQueryWithKnownAnswers)
+{
+    System::Clock::Internal::MockClock mockClock;
+    KnownAnswerCache cache(&mockClock);
+
+    cache.Add(kCommissionableService.Serialized(), kInstance1.Serialized(), 120);
+    cache.Add(kCommissionableService.Serialized(), kInstance2.Serialized(), 120);
+    cache.Add(kCommissionerService.Serialized(), kCommissioner.Serialized(), 120);
+
+    System::PacketBufferHandle buffer = System::PacketBufferHandle::New(1024);
+    ASSERT_FALSE(buffer.IsNull());
+
+    // Two questions packed in a single packet, followed by the known answers for both.
+    QueryBuilder builder(std::move(buffer));
+    builder.Header().SetMessageId(0);
+    builder.AddQuery(Query(kCommissionableService.Full()).SetClass(QClass::IN).SetType(QType::ANY));
+    builder.AddQuery(Query(kCommissionerService.Full()).SetClass(QClass::IN).SetType(QType::ANY));
+
+    for (const FullQName & name : { kCommissionableService.Full(), kCommissionerService.Full() })
+    {
+        cache.ForEachKnownAnswer(name, [&builder](const PtrResourceRecord & record) {
+            builder.AddKnownAnswer(record);
+            return builder.Ok() ? Loop::Continue : Loop::Break;
+        });
+    }
+    ASSERT_TRUE(builder.Ok());
+
+    // Questions cannot follow known answers.
+    builder.AddQuery(Query(kCommissionableService.Full()).SetClass(QClass::IN).SetType(QType::ANY));
+    EXPECT_FALSE(builder.Ok());
+
+    System::PacketBufferHandle packet = builder.ReleasePacket();
+    CountingDelegate delegate;
+    EXPECT_TRUE(ParsePacket(BytesRange(packet->Start(), packet->Start() + packet->DataLength()), &delegate));
+    EXPECT_TRUE(delegate.isQuery);
+    EXPECT_EQ(delegate.queries, 2u);
+    EXPECT_EQ(delegate.knownAnswers, 3u);
+}
+
+TEST(TestKnownAnswerCache, TestFullPacketKeepsQuestions)
+{
+    System::PacketBufferHandle buffer = System::PacketBufferHandle::New(1024);
+    ASSERT_FALSE(buffer.IsNull());
+
+    QueryBuilder builder(std::move(buffer));
+    builder.Header().SetMessageId(0);
+
+    // Keep adding questions until the packet is full.
+    size_t added = 0;
+    for (size_t i = 0; i < 1024 && builder.Ok(); i++)
+    {
+        builder.AddQuery(Query((i % 2) != 0 ? kInstance1.Full() : kInstance2.Full()).SetClass(QClass::IN).SetType(QType::ANY));
+        if (builder.Ok())
+        {
+            added++;
+        }
+    }
+    EXPECT_FALSE(builder.Ok());
+    EXPECT_TRUE(builder.HasQueries());
+    EXPECT_EQ(builder.Header().GetQueryCount(), added);
+
+    // The failed question left the packet untouched, so everything added before it can still be sent.
+    System::PacketBufferHandle packet = builder.ReleasePacket();
+    CountingDelegate delegate;
+    EXPECT_TRUE(ParsePacket(BytesRange(packet->Start(), packet->Start() + packet->DataLength()), &delegate));
+    EXPECT_EQ(delegate.queries, added);
+    EXPECT_EQ(delegate.knownAnswers, 0u);
+}
+
+} // namespace
@@ -219,6 +219,10 @@ public:
         return StorageKeyName::Formatted("g/su/%x", static_cast<unsigned>(index));
     }
     static StorageKeyName SubscriptionResumptionMaxCount() { return StorageKeyName::Formatted("g/sum"); }
+    static StorageKeyName SubscriptionResumptionTable(size_t shard)
+    {
+        return StorageKeyName::Formatted("g/sut/%x", static_cast<unsigned>(shard));
+    }
 
     // Number of scenes stored in a given endpoint's scene table, across all fabrics.
     static StorageKeyName EndpointSceneCountKey(EndpointId endpoint) { return StorageKeyName::Formatted("g/scc/e/%x", endpoint); }
@@ -16,15 +16,18 @@
  */
 
 #include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
 
 #include <algorithm>
 #include <charconv>
-#include <sstream>
+#include <cmath>
+#include <limits>
 #include <string>
 #include <vector>
 
-#include <json/json.h>
 #include <lib/support/Base64.h>
+#include <lib/support/CodeUtils.h>
 #include <lib/support/SafeInt.h>
 #include <lib/support/jsontlv/ElementTypes.h>
 #include <lib/support/jsontlv/JsonToTlv.h>
@@ -38,61 +41,559 @@ namespace {
 // This profile, but will be used for deciding what binary values to encode.
 constexpr uint32_t kTemporaryImplicitProfileId = 0xFF01;
 
-std::vector<std::string> SplitIntoFieldsBySeparator(const std::string & input, char separator)
+// Same nesting limit as the jsoncpp reader previously used to parse the input.
+constexpr unsigned kMaxJsonNestingDepth = 1000;
+
+enum class JsonValueType : uint8_t
+{
+    kInvalid,
+    kNull,
+    kBoolean,
+    kNumber,
+    kString,
+    kArray,
+    kObject,
+};
+
+/*
+ * A JSON number, typed the way Json::Reader decodes it: integers are kept as integers as long as they fit in 64 bits,
+ * anything else is a double.
+ */
+struct JsonNumber
+{
+    enum class Type : uint8_t
+    {
+        kNegativeInteger,
+        kPositiveInteger,
+        kReal,
+    };
+
+    static bool IsIntegral(double value)
+    {
+        double integralPart;
+        return std::modf(value, &integralPart) == 0.0;
+    }
+
+    bool IsUInt64() const
+    {
+        switch (type)
+        {
+        case Type::kNegativeInteger:
+            return false;
+        case Type::kPositiveInteger:
+            return true;
+        case Type::kReal:
+            // 2^64 - 1 is not representable as a double, the limit is 2^64 (exclusive).
+            return realValue >= 0 && realValue < 18446744073709551616.0 && IsIntegral(realValue);
+        }
+        return false;
+    }
+
+    bool IsInt64() const
+    {
+        switch (type)
+        {
+        case Type::kNegativeInteger:
+            return true;
+        case Type::kPositiveInteger:
+            return unsignedValue <= static_cast<uint64_t>(std::numeric_limits<int64_t>::max());
+        case Type::kReal:
+            // 2^63 - 1 is not representable as a double, the limit is 2^63 (exclusive).
+            return realValue >= -9223372036854775808.0 && realValue < 9223372036854775808.0 && IsIntegral(realValue);
+        }
+        return false;
+    }
+
+    uint64_t AsUInt64() const { return (type == Type::kReal) ? static_cast<uint64_t>(realValue) : unsignedValue; }
+
+    int64_t AsInt64() const
+    {
+        switch (type)
+        {
+        case Type::kNegativeInteger:
+            return signedValue;
+        case Type::kPositiveInteger:
+            return static_cast<int64_t>(unsignedValue);
+        case Type::kReal:
+            return static_cast<int64_t>(realValue);
+        }
+        return 0;
+    }
+
+    double AsDouble() const
+    {
+        switch (type)
+        {
+        case Type::kNegativeInteger:
+            return static_cast<double>(signedValue);
+        case Type::kPositiveInteger:
+            return static_cast<double>(unsignedValue);
+        case Type::kReal:
+            return realValue;
+        }
+        return 0;
+    }
+
+    float AsFloat() const
+    {
+        switch (type)
+        {
+        case Type::kNegativeInteger:
+            return static_cast<float>(signedValue);
+        case Type::kPositiveInteger:
+            return static_cast<float>(unsignedValue);
+        case Type::kReal:
+            return static_cast<float>(realValue);
+        }
+        return 0;
+    }
+
+    Type type              = Type::kPositiveInteger;
+    int64_t signedValue    = 0;
+    uint64_t unsignedValue = 0;
+    double realValue       = 0;
+};
+
+/*
+ * Reads a JSON document in place, without building any representation of it.
+ *
+ * The accepted syntax is the one of the Json::Reader this converter used to be based on: comments are allowed, numbers
+ * may have leading zeros, and anything following the root value is ignored.
+ */
+class JsonParser
+{
+public:
+    explicit JsonParser(const std::string & json) : mBegin(json.data()), mEnd(json.data() + json.size()), mCursor(mBegin) {}
+
+    size_t GetPosition() const { return static_cast<size_t>(mCursor - mBegin); }
+    void SetPosition(size_t position) { mCursor = mBegin + position; }
+
+    bool Consume(char c)
+    {
+        VerifyOrReturnValue(mCursor < mEnd && *mCursor == c, false);
+        mCursor++;
+        return true;
+    }
+
+    void SkipSpaces()
+    {
+        while (mCursor < mEnd && (*mCursor == ' ' || *mCursor == '\t' || *mCursor == '\r' || *mCursor == '\n'))
+        {
+            mCursor++;
+        }
+    }
+
+    bool SkipSpacesAndComments()
+    {
+        for (SkipSpaces(); Consume('/'); SkipSpaces())
+        {
+            if (Consume('*'))
+            {
+                static constexpr char kCommentEnd[] = "*/";
+                const char * commentEnd             = std::search(mCursor, mEnd, kCommentEnd, kCommentEnd + 2);
+                VerifyOrReturnValue(commentEnd != mEnd, false);
+                mCursor = commentEnd + 2;
+            }
+            else
+            {
+                VerifyOrReturnValue(Consume('/'), false);
+                while (mCursor < mEnd && *mCursor != '\n' && *mCursor != '\r')
+                {
+                    mCursor++;
+                }
+            }
+        }
+        return true;
+    }
+
+    JsonValueType PeekValueType() const
+    {
+        VerifyOrReturnValue(mCursor < mEnd, JsonValueType::kInvalid);
+        switch (*mCursor)
+        {
+        case '{':
+            return JsonValueType::kObject;
+        case '[':
+            return JsonValueType::kArray;
+        case '"':
+            return JsonValueType::kString;
+        case 't':
+        case 'f':
+            return JsonValueType::kBoolean;
+        case 'n':
+            return JsonValueType::kNull;
+        case '-':
+            return JsonValueType::kNumber;
+        default:
+            return (*mCursor >= '0' && *mCursor <= '9') ? JsonValueType::kNumber : JsonValueType::kInvalid;
+        }
+    }
+
+    bool ReadNull() { return ConsumeLiteral("null"); }
+
+    bool ReadBoolean(bool & value)
+    {
+        value = (mCursor < mEnd && *mCursor == 't');
+        return ConsumeLiteral(value ? "true" : "false");
+    }
+
+    /// Reads the string at the cursor, appending its decoded content to `out` unless it is null.
+    bool ReadString(std::string * out);
+
+    bool ReadNumber(JsonNumber & number);
+
+    /// Reads the object at the cursor. `handleMember(valuePosition)` is called for each member once its name has been
+    /// appended to `names` (unless null); the value is skipped afterwards.
+    template <typename MemberHandler>
+    bool ReadObject(std::string * names, unsigned depth, MemberHandler && handleMember)
+    {
+        VerifyOrReturnValue(Consume('{') && SkipSpacesAndComments(), false);
+        VerifyOrReturnValue(!Consume('}'), true);
+
+        while (true)
+        {
+            VerifyOrReturnValue(PeekValueType() == JsonValueType::kString && ReadString(names), false);
+            // Comments are not allowed between a name and its colon.
+            SkipSpaces();
+            VerifyOrReturnValue(Consume(':'), false);
+            handleMember(GetPosition());
+            VerifyOrReturnValue(SkipValue(depth + 1) && SkipSpacesAndComments(), false);
+            VerifyOrReturnValue(!Consume('}'), true);
+            VerifyOrReturnValue(Consume(',') && SkipSpacesAndComments(), false);
+        }
+    }
+
+    bool SkipValue(unsigned depth);
+
+private:
+    bool SkipArray(unsigned depth);
+
+    bool ConsumeLiteral(const char * literal)
+    {
+        const size_t length = strlen(literal);
+        VerifyOrReturnValue(static_cast<size_t>(mEnd - mCursor) >= length && memcmp(mCursor, literal, length) == 0, false);
+        mCursor += length;
+        return true;
+    }
+
+    bool ReadHexQuad(uint32_t & value);
+
+    const char * const mBegin;
+    const char * const mEnd;
+    const char * mCursor;
+    std::string mNumber;
+};
+
+bool JsonParser::ReadHexQuad(uint32_t & value)
+{
+    VerifyOrReturnValue(mEnd - mCursor >= 4, false);
+
+    value = 0;
+    for (int i = 0; i < 4; i++)
+    {
+        const char c = *mCursor++;
+        uint32_t digit;
+        if (c >= '0' && c <= '9')
+        {
+            digit = static_cast<uint32_t>(c - '0');
+        }
+        else if (c >= 'a' && c <= 'f')
+        {
+            digit = static_cast<uint32_t>(c - 'a' + 10);
+        }
+        else if (c >= 'A' && c <= 'F')
+        {
+            digit = static_cast<uint32_t>(c - 'A' + 10);
+        }
+        else
+        {
+            return false;
+        }
+        value = (value << 4) | digit;
+    }
+    return true;
+}
+
+bool JsonParser::ReadString(std::string * out)
+{
+    VerifyOrReturnValue(Consume('"'), false);
+
+    while (true)
+    {
+        const char * run = mCursor;
+        while (mCursor < mEnd && *mCursor != '"' && *mCursor != '\\')
+        {
+            mCursor++;
+        }
+        VerifyOrReturnValue(mCursor < mEnd, false);
+        if (out != nullptr)
+        {
+            out->append(run, static_cast<size_t>(mCursor - run));
+        }
+        if (Consume('"'))
+        {
+            return true;
+        }
+
+        mCursor++; // backslash
+        VerifyOrReturnValue(mCursor < mEnd, false);
+        char escaped = *mCursor++;
+        switch (escaped)
+        {
+        case '"':
+        case '/':
+        case '\\':
+            break;
+        case 'b':
+            escaped = '\b';
+            break;
+        case 'f':
+            escaped = '\f';
+            break;
+        case 'n':
+            escaped = '\n';
+            break;
+        case 'r':
+            escaped = '\r';
+            break;
+        case 't':
+            escaped = '\t';
+            break;
+        case 'u': {
+            uint32_t codePoint;
+            VerifyOrReturnValue(ReadHexQuad(codePoint), false);
+            if (codePoint >= 0xD800 && codePoint <= 0xDBFF)
+            {
+                // The second half of a surrogate pair is not checked to be a low surrogate, as jsoncpp did.
+                uint32_t lowSurrogate;
+                VerifyOrReturnValue(Consume('\\') && Consume('u') && ReadHexQuad(lowSurrogate), false);
+                codePoint = 0x10000 + ((codePoint & 0x3FF) << 10) + (lowSurrogate & 0x3FF);
+            }
+            if (out != nullptr)
+            {
+                char utf8[4];
+                size_t length;
+                if (codePoint <= 0x7F)
+                {
+                    utf8[0] = static_cast<char>(codePoint);
+                    length  = 1;
+                }
+                else if (codePoint <= 0x7FF)
+                {
+                    utf8[0] = static_cast<char>(0xC0 | (codePoint >> 6));
+                    utf8[1] = static_cast<char>(0x80 | (codePoint & 0x3F));
+                    length  = 2;
+                }
+                else if (codePoint <= 0xFFFF)
+                {
+                    utf8[0] = static_cast<char>(0xE0 | (codePoint >> 12));
+                    utf8[1] = static_cast<char>(0x80 | ((codePoint >> 6) & 0x3F));
+                    utf8[2] = static_cast<char>(0x80 | (codePoint & 0x3F));
+                    length  = 3;
+                }
+                else
+                {
+                    utf8[0] = static_cast<char>(0xF0 | (codePoint >> 18));
+                    utf8[1] = static_cast<char>(0x80 | ((codePoint >> 12) & 0x3F));
+                    utf8[2] = static_cast<char>(0x80 | ((codePoint >> 6) & 0x3F));
+                    utf8[3] = static_cast<char>(0x80 | (codePoint & 0x3F));
+                    length  = 4;
+                }
+                out->append(utf8, length);
+            }
+            continue;
+        }
+        default:
+            return false;
+        }
+
+        if (out != nullptr)
+        {
+            out->push_back(escaped);
+        }
+    }
+}
+
+bool JsonParser::ReadNumber(JsonNumber & number)
+{
+    const char * start = mCursor;
+    const bool isNegative = Consume('-');
+
+    // Same lenient tokenization as Json::Reader: a sign alone is zero, and the number is only validated when decoded.
+    auto skipDigits = [this]() {
+        while (mCursor < mEnd && *mCursor >= '0' && *mCursor <= '9')
+        {
+            mCursor++;
+        }
+    };
+    const char * digits = mCursor;
+    skipDigits();
+    bool isInteger = true;
+    if (Consume('.'))
+    {
+        isInteger = false;
+        skipDigits();
+    }
+    if (Consume('e') || Consume('E'))
+    {
+        isInteger = false;
+        if (!Consume('+'))
+        {
+            Consume('-');
+        }
+        skipDigits();
+    }
+
+    if (isInteger)
+    {
+        const uint64_t maxValue = isNegative ? static_cast<uint64_t>(std::numeric_limits<int64_t>::max()) + 1
+                                             : std::numeric_limits<uint64_t>::max();
+        uint64_t value = 0;
+        for (const char * p = digits; p < mCursor && isInteger; p++)
+        {
+            const auto digit = static_cast<uint64_t>(*p - '0');
+            isInteger        = (value < maxValue / 10) || (value == maxValue / 10 && digit <= maxValue % 10);
+            value            = value * 10 + digit;
+        }
+
+        if (isInteger)
+        {
+            if (isNegative && value != 0)
+            {
+                number.type        = JsonNumber::Type::kNegativeInteger;
+                number.signedValue = (value == maxValue) ? std::numeric_limits<int64_t>::min() : -static_cast<int64_t>(value);
+            }
+            else
+            {
+                number.type          = JsonNumber::Type::kPositiveInteger;
+                number.unsignedValue = value;
+            }
+            return true;
+        }
+    }
+
+    mNumber.assign(start, static_cast<size_t>(mCursor - start));
+    char * end;
+    number.type      = JsonNumber::Type::kReal;
+    number.realValue = strtod(mNumber.c_str(), &end);
+    return end == mNumber.c_str() + mNumber.size() && std::isfinite(number.realValue);
+}
+
+bool JsonParser::SkipValue(unsigned depth)
+{
+    VerifyOrReturnValue(depth < kMaxJsonNestingDepth && SkipSpacesAndComments(), false);
+
+    switch (PeekValueType())
+    {
+    case JsonValueType::kNull:
+        return ReadNull();
+    case JsonValueType::kBoolean: {
+        bool value;
+        return ReadBoolean(value);
+    }
+    case JsonValueType::kNumber: {
+        JsonNumber number;
+        return ReadNumber(number);
+    }
+    case JsonValueType::kString:
+        return ReadString(nullptr);
+    case JsonValueType::kObject:
+        return ReadObject(nullptr, depth, [](size_t) {});
+    case JsonValueType::kArray:
+        return SkipArray(depth);
+    default:
+        return false;
+    }
+}
+
+bool JsonParser::SkipArray(unsigned depth)
+{
+    VerifyOrReturnValue(Consume('['), false);
+
+    // Comments are not allowed in an empty array.
+    SkipSpaces();
+    VerifyOrReturnValue(!Consume(']'), true);
+
+    while (true)
+    {
+        VerifyOrReturnValue(SkipValue(depth + 1) && SkipSpacesAndComments(), false);
+        VerifyOrReturnValue(!Consume(']'), true);
+        VerifyOrReturnValue(Consume(','), false);
+    }
+}
+
+// Splits the input the way successive calls to std::getline() would: a separator at the end of the input does not start
+// an empty field. Returns the number of fields, of which at most maxFields are stored.
+size_t SplitIntoFieldsBySeparator(CharSpan input, char separator, CharSpan * fields, size_t maxFields)
 {
-    std::vector<std::string> substrings;
-    std::stringstream ss(input);
-    std::string substring;
+    size_t count = 0;
+    size_t start = 0;
 
-    while (std::getline(ss, substring, separator))
+    while (start < input.size())
     {
-        substrings.push_back(std::move(substring));
+        size_t end = start;
+        while (end < input.size() && input.data()[end] != separator)
+        {
+            end++;
+        }
+        if (count < maxFields)
+        {
+            fields[count] = input.SubSpan(start, end - start);
+        }
+        count++;
+        start = end + 1;
     }
 
-    return substrings;
+    return count;
 }
 
-CHIP_ERROR JsonTypeStrToTlvType(const char * elementType, ElementTypeContext & type)
+bool IsElementType(CharSpan elementType, const char * expected)
 {
-    if (strcmp(elementType, kElementTypeInt) == 0)
+    return elementType.data_equal(CharSpan::fromCharString(expected));
+}
+
+CHIP_ERROR JsonTypeStrToTlvType(CharSpan elementType, ElementTypeContext & type)
+{
+    if (IsElementType(elementType, kElementTypeInt))
     {
         type.tlvType = TLV::kTLVType_SignedInteger;
     }
-    else if (strcmp(elementType, kElementTypeUInt) == 0)
+    else if (IsElementType(elementType, kElementTypeUInt))
     {
         type.tlvType = TLV::kTLVType_UnsignedInteger;
     }
-    else if (strcmp(elementType, kElementTypeBool) == 0)
+    else if (IsElementType(elementType, kElementTypeBool))
     {
         type.tlvType = TLV::kTLVType_Boolean;
     }
-    else if (strcmp(elementType, kElementTypeFloat) == 0)
+    else if (IsElementType(elementType, kElementTypeFloat))
     {
         type.tlvType  = TLV::kTLVType_FloatingPointNumber;
         type.isDouble = false;
     }
-    else if (strcmp(elementType, kElementTypeDouble) == 0)
+    else if (IsElementType(elementType, kElementTypeDouble))
     {
         type.tlvType  = TLV::kTLVType_FloatingPointNumber;
         type.isDouble = true;
     }
-    else if (strcmp(elementType, kElementTypeBytes) == 0)
+    else if (IsElementType(elementType, kElementTypeBytes))
     {
         type.tlvType = TLV::kTLVType_ByteString;
     }
-    else if (strcmp(elementType, kElementTypeString) == 0)
+    else if (IsElementType(elementType, kElementTypeString))
     {
         type.tlvType = TLV::kTLVType_UTF8String;
     }
-    else if (strcmp(elementType, kElementTypeNull) == 0)
+    else if (IsElementType(elementType, kElementTypeNull))
     {
         type.tlvType = TLV::kTLVType_Null;
     }
-    else if (strcmp(elementType, kElementTypeStruct) == 0)
+    else if (IsElementType(elementType, kElementTypeStruct))
     {
         type.tlvType = TLV::kTLVType_Structure;
     }
-    else if (strncmp(elementType, kElementTypeArray, strlen(kElementTypeArray)) == 0)
+    else if (elementType.size() >= strlen(kElementTypeArray) &&
+             memcmp(elementType.data(), kElementTypeArray, strlen(kElementTypeArray)) == 0)
     {
         type.tlvType = TLV::kTLVType_Array;
     }
@@ -106,7 +607,6 @@ CHIP_ERROR JsonTypeStrToTlvType(const char * elementType, ElementTypeContext & t
 
 struct ElementContext
 {
-    std::string jsonName;
     TLV::Tag tag = TLV::AnonymousTag();
     ElementTypeContext type;
     ElementTypeContext subType;
@@ -149,7 +649,7 @@ CHIP_ERROR InternalConvertTlvTag(uint32_t tagNumber, TLV::Tag & tag, const uint3
 }
 
 template <typename T>
-CHIP_ERROR ParseNumericalField(const std::string & decimalString, T & outValue)
+CHIP_ERROR ParseNumericalField(CharSpan decimalString, T & outValue)
 {
     const char * start_ptr       = decimalString.data();
     const char * end_ptr         = decimalString.data() + decimalString.size();
@@ -158,24 +658,25 @@ CHIP_ERROR ParseNumericalField(const std::string & decimalString, T & outValue)
     return CHIP_NO_ERROR;
 }
 
-CHIP_ERROR ParseJsonName(const std::string & name, ElementContext & elementCtx, uint32_t implicitProfileId)
+CHIP_ERROR ParseJsonName(CharSpan name, ElementContext & elementCtx, uint32_t implicitProfileId)
 {
-    uint32_t tagNumber                  = 0;
-    const char * elementType            = nullptr;
-    std::vector<std::string> nameFields = SplitIntoFieldsBySeparator(name, ':');
-    TLV::Tag tag                        = TLV::AnonymousTag();
+    uint32_t tagNumber = 0;
+    CharSpan elementType;
+    CharSpan nameFields[3];
+    TLV::Tag tag = TLV::AnonymousTag();
     ElementTypeContext type;
     ElementTypeContext subType;
 
-    if (nameFields.size() == 2)
+    size_t fieldCount = SplitIntoFieldsBySeparator(name, ':', nameFields, ArraySize(nameFields));
+    if (fieldCount == 2)
     {
         ReturnErrorOnFailure(ParseNumericalField(nameFields[0], tagNumber));
-        elementType = nameFields[1].c_str();
+        elementType = nameFields[1];
     }
-    else if (nameFields.size() == 3)
+    else if (fieldCount == 3)
     {
         ReturnErrorOnFailure(ParseNumericalField(nameFields[1], tagNumber));
-        elementType = nameFields[2].c_str();
+        elementType = nameFields[2];
     }
     else
     {
@@ -187,113 +688,227 @@ CHIP_ERROR ParseJsonName(const std::string & name, ElementContext & elementCtx,
 
     if (type.tlvType == TLV::kTLVType_Array)
     {
-        std::vector<std::string> arrayFields = SplitIntoFieldsBySeparator(elementType, '-');
-        VerifyOrReturnError(arrayFields.size() == 2, CHIP_ERROR_INVALID_ARGUMENT);
+        CharSpan arrayFields[2];
+        VerifyOrReturnError(SplitIntoFieldsBySeparator(elementType, '-', arrayFields, ArraySize(arrayFields)) == 2,
+                            CHIP_ERROR_INVALID_ARGUMENT);
 
-        if (strcmp(arrayFields[1].c_str(), kElementTypeEmpty) == 0)
+        if (IsElementType(arrayFields[1], kElementTypeEmpty))
         {
             subType.tlvType = TLV::kTLVType_NotSpecified;
         }
         else
         {
-            ReturnErrorOnFailure(JsonTypeStrToTlvType(arrayFields[1].c_str(), subType));
+            ReturnErrorOnFailure(JsonTypeStrToTlvType(arrayFields[1], subType));
         }
     }
 
-    elementCtx.jsonName = name;
-    elementCtx.tag      = tag;
-    elementCtx.type     = type;
-    elementCtx.subType  = subType;
+    elementCtx.tag     = tag;
+    elementCtx.type    = type;
+    elementCtx.subType = subType;
 
     return CHIP_NO_ERROR;
 }
 
-CHIP_ERROR EncodeTlvElement(const Json::Value & val, TLV::TLVWriter & writer, const ElementContext & elementCtx)
+/*
+ * Encodes a JSON document into TLV while parsing it.
+ *
+ * The members of a JSON object have to be encoded in tag order, so each object is first scanned to collect the names and
+ * positions of its members, which are then encoded in order by parsing again their values. The members collected for
+ * the objects being encoded are kept in a single buffer, reused for the whole document. Only the members of the open
+ * objects are kept, so that buffer, like the one holding the value being encoded, is bounded by the size of the document
+ * rather than by a fixed limit.
+ *
+ * Open structures and arrays are tracked on a fixed stack of kJsonToTlvMaxContainerDepth entries rather than by
+ * recursion, so that the nesting of the input does not bound the memory used.
+ */
+class JsonToTlvEncoder
+{
+public:
+    JsonToTlvEncoder(const std::string & jsonString, TLV::TLVWriter & writer) : mParser(jsonString), mWriter(writer) {}
+
+    CHIP_ERROR Encode()
+    {
+        VerifyOrReturnError(mParser.SkipSpacesAndComments(), CHIP_ERROR_INTERNAL);
+
+        // Like any other syntax error, an invalid root value prevails over it not being an object.
+        if (mParser.PeekValueType() != JsonValueType::kObject)
+        {
+            VerifyOrReturnError(mParser.SkipValue(0), CHIP_ERROR_INTERNAL);
+            return CHIP_ERROR_INVALID_ARGUMENT;
+        }
+
+        ElementContext elementCtx;
+        elementCtx.type = { TLV::kTLVType_Structure, false };
+        ReturnErrorOnFailure(EncodeElement(elementCtx));
+
+        while (mContainerCount > 0)
+        {
+            ReturnErrorOnFailure(EncodeNextInContainer());
+        }
+        return CHIP_NO_ERROR;
+    }
+
+private:
+    struct MemberContext
+    {
+        ElementContext element;
+        size_t nameOffset;
+        size_t nameLength;
+        size_t valuePosition;
+    };
+
+    struct ContainerContext
+    {
+        TLV::TLVType outerContainerType;
+        // Structures: the members collected are mMembers[membersStart, membersEnd), of which those from nextMember on are
+        // still to be encoded. Once they are, the members and their names are dropped, and parsing resumes after the
+        // closing brace.
+        size_t membersStart;
+        size_t nextMember;
+        size_t membersEnd;
+        size_t namesStart;
+        size_t endPosition;
+        // Arrays: the type of the elements, and whether the first one has been encoded.
+        ElementTypeContext elementType;
+        bool isArray;
+        bool started;
+    };
+
+    CharSpan GetName(const MemberContext & member) const
+    {
+        return CharSpan(mNames.data() + member.nameOffset, member.nameLength);
+    }
+
+    int CompareNames(const MemberContext & a, const MemberContext & b) const
+    {
+        return mNames.compare(a.nameOffset, a.nameLength, mNames, b.nameOffset, b.nameLength);
+    }
+
+    CHIP_ERROR ReadString()
+    {
+        mString.clear();
+        VerifyOrReturnError(mParser.ReadString(&mString), CHIP_ERROR_INTERNAL);
+        return CHIP_NO_ERROR;
+    }
+
+    unsigned Depth() const { return static_cast<unsigned>(mContainerCount); }
+
+    /// Encodes a scalar value, or opens a structure or array whose content is then encoded by EncodeNextInContainer().
+    CHIP_ERROR EncodeElement(const ElementContext & elementCtx);
+    CHIP_ERROR OpenStruct(TLV::Tag tag);
+    CHIP_ERROR OpenArray(const ElementContext & elementCtx);
+    CHIP_ERROR EncodeNextInContainer();
+
+    JsonParser mParser;
+    TLV::TLVWriter & mWriter;
+    ContainerContext mContainers[kJsonToTlvMaxContainerDepth];
+    size_t mContainerCount = 0;
+    std::vector<MemberContext> mMembers;
+    std::string mNames;
+    std::string mString;
+};
+
+CHIP_ERROR JsonToTlvEncoder::EncodeElement(const ElementContext & elementCtx)
 {
     TLV::Tag tag = elementCtx.tag;
 
+    VerifyOrReturnError(mParser.SkipSpacesAndComments(), CHIP_ERROR_INTERNAL);
+    const JsonValueType valueType = mParser.PeekValueType();
+
     switch (elementCtx.type.tlvType)
     {
     case TLV::kTLVType_UnsignedInteger: {
         uint64_t v = 0;
-        if (val.isUInt64())
+        if (valueType == JsonValueType::kNumber)
         {
-            v = val.asUInt64();
+            JsonNumber number;
+            VerifyOrReturnError(mParser.ReadNumber(number), CHIP_ERROR_INTERNAL);
+            VerifyOrReturnError(number.IsUInt64(), CHIP_ERROR_INVALID_ARGUMENT);
+            v = number.AsUInt64();
         }
-        else if (val.isString())
+        else if (valueType == JsonValueType::kString)
         {
-            ReturnErrorOnFailure(ParseNumericalField(val.asString(), v));
+            ReturnErrorOnFailure(ReadString());
+            ReturnErrorOnFailure(ParseNumericalField(CharSpan(mString.data(), mString.size()), v));
         }
         else
         {
             return CHIP_ERROR_INVALID_ARGUMENT;
         }
-        ReturnErrorOnFailure(writer.Put(tag, v));
+        ReturnErrorOnFailure(mWriter.Put(tag, v));
         break;
     }
 
     case TLV::kTLVType_SignedInteger: {
         int64_t v = 0;
-        if (val.isInt64())
+        if (valueType == JsonValueType::kNumber)
         {
-            v = val.asInt64();
+            JsonNumber number;
+            VerifyOrReturnError(mParser.ReadNumber(number), CHIP_ERROR_INTERNAL);
+            VerifyOrReturnError(number.IsInt64(), CHIP_ERROR_INVALID_ARGUMENT);
+            v = number.AsInt64();
         }
-        else if (val.isString())
+        else if (valueType == JsonValueType::kString)
         {
-            ReturnErrorOnFailure(ParseNumericalField(val.asString(), v));
+            ReturnErrorOnFailure(ReadString());
+            ReturnErrorOnFailure(ParseNumericalField(CharSpan(mString.data(), mString.size()), v));
         }
         else
         {
             return CHIP_ERROR_INVALID_ARGUMENT;
         }
-        ReturnErrorOnFailure(writer.Put(tag, v));
+        ReturnErrorOnFailure(mWriter.Put(tag, v));
         break;
     }
 
     case TLV::kTLVType_Boolean: {
-        VerifyOrReturnError(val.isBool(), CHIP_ERROR_INVALID_ARGUMENT);
-        ReturnErrorOnFailure(writer.Put(tag, val.asBool()));
+        bool v;
+        VerifyOrReturnError(valueType == JsonValueType::kBoolean, CHIP_ERROR_INVALID_ARGUMENT);
+        VerifyOrReturnError(mParser.ReadBoolean(v), CHIP_ERROR_INTERNAL);
+        ReturnErrorOnFailure(mWriter.Put(tag, v));
         break;
     }
 
     case TLV::kTLVType_FloatingPointNumber: {
-        if (val.isNumeric())
+        if (valueType == JsonValueType::kNumber)
         {
+            JsonNumber number;
+            VerifyOrReturnError(mParser.ReadNumber(number), CHIP_ERROR_INTERNAL);
             if (elementCtx.type.isDouble)
             {
-                ReturnErrorOnFailure(writer.Put(tag, val.asDouble()));
+                ReturnErrorOnFailure(mWriter.Put(tag, number.AsDouble()));
             }
             else
             {
-                ReturnErrorOnFailure(writer.Put(tag, val.asFloat()));
+                ReturnErrorOnFailure(mWriter.Put(tag, number.AsFloat()));
             }
         }
-        else if (val.isString())
+        else if (valueType == JsonValueType::kString)
         {
-            const std::string valAsString = val.asString();
-            bool isPositiveInfinity       = (valAsString == kFloatingPointPositiveInfinity);
-            bool isNegativeInfinity       = (valAsString == kFloatingPointNegativeInfinity);
+            ReturnErrorOnFailure(ReadString());
+            bool isPositiveInfinity = (mString == kFloatingPointPositiveInfinity);
+            bool isNegativeInfinity = (mString == kFloatingPointNegativeInfinity);
             VerifyOrReturnError(isPositiveInfinity || isNegativeInfinity, CHIP_ERROR_INVALID_ARGUMENT);
             if (elementCtx.type.isDouble)
             {
                 if (isPositiveInfinity)
                 {
-                    ReturnErrorOnFailure(writer.Put(tag, std::numeric_limits<double>::infinity()));
+                    ReturnErrorOnFailure(mWriter.Put(tag, std::numeric_limits<double>::infinity()));
                 }
                 else
                 {
-                    ReturnErrorOnFailure(writer.Put(tag, -std::numeric_limits<double>::infinity()));
+                    ReturnErrorOnFailure(mWriter.Put(tag, -std::numeric_limits<double>::infinity()));
                 }
             }
             else
             {
                 if (isPositiveInfinity)
                 {
-                    ReturnErrorOnFailure(writer.Put(tag, std::numeric_limits<float>::infinity()));
+                    ReturnErrorOnFailure(mWriter.Put(tag, std::numeric_limits<float>::infinity()));
                 }
                 else
                 {
-                    ReturnErrorOnFailure(writer.Put(tag, -std::numeric_limits<float>::infinity()));
+                    ReturnErrorOnFailure(mWriter.Put(tag, -std::numeric_limits<float>::infinity()));
                 }
             }
         }
@@ -305,95 +920,179 @@ CHIP_ERROR EncodeTlvElement(const Json::Value & val, TLV::TLVWriter & writer, co
     }
 
     case TLV::kTLVType_ByteString: {
-        VerifyOrReturnError(val.isString(), CHIP_ERROR_INVALID_ARGUMENT);
-        const std::string valAsString = val.asString();
-        size_t encodedLen             = valAsString.length();
+        VerifyOrReturnError(valueType == JsonValueType::kString, CHIP_ERROR_INVALID_ARGUMENT);
+        ReturnErrorOnFailure(ReadString());
+        size_t encodedLen = mString.length();
         VerifyOrReturnError(CanCastTo<uint16_t>(encodedLen), CHIP_ERROR_INVALID_ARGUMENT);
 
         // Check if the length is a multiple of 4 as strict padding is required.
         VerifyOrReturnError(encodedLen % 4 == 0, CHIP_ERROR_INVALID_ARGUMENT);
 
-        Platform::ScopedMemoryBuffer<uint8_t> byteString;
-        byteString.Alloc(BASE64_MAX_DECODED_LEN(static_cast<uint16_t>(encodedLen)));
-        VerifyOrReturnError(byteString.Get() != nullptr, CHIP_ERROR_NO_MEMORY);
-
-        auto decodedLen = Base64Decode(valAsString.c_str(), static_cast<uint16_t>(encodedLen), byteString.Get());
+        // Decoded in place: Base64Decode() only writes a byte once the characters it is decoded from have been read.
+        auto * bytes    = reinterpret_cast<uint8_t *>(&mString[0]);
+        auto decodedLen = Base64Decode(mString.data(), static_cast<uint16_t>(encodedLen), bytes);
         VerifyOrReturnError(decodedLen < UINT16_MAX, CHIP_ERROR_INVALID_ARGUMENT);
-        ReturnErrorOnFailure(writer.PutBytes(tag, byteString.Get(), decodedLen));
+        ReturnErrorOnFailure(mWriter.PutBytes(tag, bytes, decodedLen));
         break;
     }
 
     case TLV::kTLVType_UTF8String: {
-        VerifyOrReturnError(val.isString(), CHIP_ERROR_INVALID_ARGUMENT);
-        const std::string valAsString = val.asString();
-        ReturnErrorOnFailure(writer.PutString(tag, valAsString.data(), static_cast<uint32_t>(valAsString.size())));
+        VerifyOrReturnError(valueType == JsonValueType::kString, CHIP_ERROR_INVALID_ARGUMENT);
+        ReturnErrorOnFailure(ReadString());
+        ReturnErrorOnFailure(mWriter.PutString(tag, mString.data(), static_cast<uint32_t>(mString.size())));
         break;
     }
 
     case TLV::kTLVType_Null: {
-        VerifyOrReturnError(val.isNull(), CHIP_ERROR_INVALID_ARGUMENT);
-        ReturnErrorOnFailure(writer.PutNull(tag));
+        VerifyOrReturnError(valueType == JsonValueType::kNull, CHIP_ERROR_INVALID_ARGUMENT);
+        VerifyOrReturnError(mParser.ReadNull(), CHIP_ERROR_INTERNAL);
+        ReturnErrorOnFailure(mWriter.PutNull(tag));
         break;
     }
 
     case TLV::kTLVType_Structure: {
-        TLV::TLVType containerType;
-        VerifyOrReturnError(val.isObject(), CHIP_ERROR_INVALID_ARGUMENT);
-        ReturnErrorOnFailure(writer.StartContainer(tag, TLV::kTLVType_Structure, containerType));
+        VerifyOrReturnError(valueType == JsonValueType::kObject, CHIP_ERROR_INVALID_ARGUMENT);
+        ReturnErrorOnFailure(OpenStruct(tag));
+        break;
+    }
 
-        std::vector<std::string> jsonNames = val.getMemberNames();
-        std::vector<ElementContext> nestedElementsCtx;
+    case TLV::kTLVType_Array: {
+        VerifyOrReturnError(valueType == JsonValueType::kArray, CHIP_ERROR_INVALID_ARGUMENT);
+        ReturnErrorOnFailure(OpenArray(elementCtx));
+        break;
+    }
 
-        for (size_t i = 0; i < jsonNames.size(); i++)
-        {
-            ElementContext ctx;
-            ReturnErrorOnFailure(ParseJsonName(jsonNames[i], ctx, writer.ImplicitProfileId));
-            nestedElementsCtx.push_back(ctx);
-        }
+    default:
+        return CHIP_ERROR_INVALID_TLV_ELEMENT;
+        break;
+    }
 
-        // Sort Json object elements by Tag number (low to high).
-        // Note that all sorted Context Tags will appear first followed by all sorted Common Tags.
-        std::sort(nestedElementsCtx.begin(), nestedElementsCtx.end(), CompareByTag);
+    return CHIP_NO_ERROR;
+}
 
-        for (auto & ctx : nestedElementsCtx)
-        {
-            ReturnErrorOnFailure(EncodeTlvElement(val[ctx.jsonName], writer, ctx));
-        }
+CHIP_ERROR JsonToTlvEncoder::OpenStruct(TLV::Tag tag)
+{
+    VerifyOrReturnError(mContainerCount < kJsonToTlvMaxContainerDepth, CHIP_ERROR_NO_MEMORY);
 
-        ReturnErrorOnFailure(writer.EndContainer(containerType));
-        break;
+    const size_t membersStart = mMembers.size();
+    const size_t namesStart   = mNames.size();
+    size_t nameOffset         = namesStart;
+
+    // Scanning the root object validates the whole document, so that syntax errors are reported before anything is
+    // written, as when the document was parsed upfront.
+    bool scanned = mParser.ReadObject(&mNames, Depth(), [&](size_t valuePosition) {
+        mMembers.push_back({ ElementContext(), nameOffset, mNames.size() - nameOffset, valuePosition });
+        nameOffset = mNames.size();
+    });
+    VerifyOrReturnError(scanned, CHIP_ERROR_INTERNAL);
+
+    ContainerContext & container = mContainers[mContainerCount];
+    container.membersStart       = membersStart;
+    container.nextMember         = membersStart;
+    container.membersEnd         = mMembers.size();
+    container.namesStart         = namesStart;
+    container.endPosition        = mParser.GetPosition();
+    container.isArray            = false;
+    ReturnErrorOnFailure(mWriter.StartContainer(tag, TLV::kTLVType_Structure, container.outerContainerType));
+    mContainerCount++;
+
+    for (size_t i = membersStart; i < mMembers.size(); i++)
+    {
+        ReturnErrorOnFailure(ParseJsonName(GetName(mMembers[i]), mMembers[i].element, mWriter.ImplicitProfileId));
     }
 
-    case TLV::kTLVType_Array: {
-        TLV::TLVType containerType;
-        VerifyOrReturnError(val.isArray(), CHIP_ERROR_INVALID_ARGUMENT);
-        ReturnErrorOnFailure(writer.StartContainer(tag, TLV::kTLVType_Array, containerType));
+    // Sort Json object elements by Tag number (low to high).
+    // Note that all sorted Context Tags will appear first followed by all sorted Common Tags.
+    // Members with the same tag number are ordered by name, and then by position so that only the last of the members
+    // sharing the same name gets encoded.
+    std::sort(mMembers.begin() + static_cast<ptrdiff_t>(membersStart), mMembers.end(),
+              [this](const MemberContext & a, const MemberContext & b) {
+                  if (CompareByTag(a.element, b.element))
+                  {
+                      return true;
+                  }
+                  if (CompareByTag(b.element, a.element))
+                  {
+                      return false;
+                  }
+                  int nameComparison = CompareNames(a, b);
+                  return (nameComparison != 0) ? (nameComparison < 0) : (a.valuePosition < b.valuePosition);
+              });
 
-        if (elementCtx.subType.tlvType == TLV::kTLVType_NotSpecified)
-        {
-            VerifyOrReturnError(val.size() == 0, CHIP_ERROR_INVALID_ARGUMENT);
-        }
-        else
+    return CHIP_NO_ERROR;
+}
+
+CHIP_ERROR JsonToTlvEncoder::OpenArray(const ElementContext & elementCtx)
+{
+    VerifyOrReturnError(mContainerCount < kJsonToTlvMaxContainerDepth, CHIP_ERROR_NO_MEMORY);
+
+    ContainerContext & container = mContainers[mContainerCount];
+    ReturnErrorOnFailure(mWriter.StartContainer(elementCtx.tag, TLV::kTLVType_Array, container.outerContainerType));
+
+    VerifyOrReturnError(mParser.Consume('[') && mParser.SkipSpacesAndComments(), CHIP_ERROR_INTERNAL);
+
+    if (elementCtx.subType.tlvType == TLV::kTLVType_NotSpecified)
+    {
+        VerifyOrReturnError(mParser.Consume(']'), CHIP_ERROR_INVALID_ARGUMENT);
+        return mWriter.EndContainer(container.outerContainerType);
+    }
+    if (mParser.Consume(']'))
+    {
+        return mWriter.EndContainer(container.outerContainerType);
+    }
+
+    container.elementType = elementCtx.subType;
+    container.isArray     = true;
+    container.started     = false;
+    mContainerCount++;
+    return CHIP_NO_ERROR;
+}
+
+CHIP_ERROR JsonToTlvEncoder::EncodeNextInContainer()
+{
+    ContainerContext & container = mContainers[mContainerCount - 1];
+
+    if (container.isArray)
+    {
+        if (container.started)
         {
-            ElementContext nestedElementCtx;
-            nestedElementCtx.tag  = TLV::AnonymousTag();
-            nestedElementCtx.type = elementCtx.subType;
-            for (Json::ArrayIndex i = 0; i < val.size(); i++)
+            VerifyOrReturnError(mParser.SkipSpacesAndComments(), CHIP_ERROR_INTERNAL);
+            if (!mParser.Consume(','))
             {
-                ReturnErrorOnFailure(EncodeTlvElement(val[i], writer, nestedElementCtx));
+                VerifyOrReturnError(mParser.Consume(']'), CHIP_ERROR_INTERNAL);
+                mContainerCount--;
+                return mWriter.EndContainer(container.outerContainerType);
             }
         }
+        container.started = true;
 
-        ReturnErrorOnFailure(writer.EndContainer(containerType));
-        break;
+        ElementContext nestedElementCtx;
+        nestedElementCtx.tag  = TLV::AnonymousTag();
+        nestedElementCtx.type = container.elementType;
+        return EncodeElement(nestedElementCtx);
     }
 
-    default:
-        return CHIP_ERROR_INVALID_TLV_ELEMENT;
-        break;
+    // Only the last of the members sharing the same name is encoded.
+    while (container.nextMember + 1 < container.membersEnd &&
+           CompareNames(mMembers[container.nextMember], mMembers[container.nextMember + 1]) == 0)
+    {
+        container.nextMember++;
     }
 
-    return CHIP_NO_ERROR;
+    if (container.nextMember == container.membersEnd)
+    {
+        mMembers.resize(container.membersStart);
+        mNames.resize(container.namesStart);
+        mParser.SetPosition(container.endPosition);
+        mContainerCount--;
+        return mWriter.EndContainer(container.outerContainerType);
+    }
+
+    // A nested structure appends its members to mMembers, which may reallocate it.
+    const MemberContext & member = mMembers[container.nextMember++];
+    const ElementContext element = member.element;
+    mParser.SetPosition(member.valuePosition);
+    return EncodeElement(element);
 }
 
 } // namespace
@@ -411,14 +1110,6 @@ CHIP_ERROR JsonToTlv(const std::string & jsonString, MutableByteSpan & tlv)
 
 CHIP_ERROR JsonToTlv(const std::string & jsonString, TLV::TLVWriter & writer)
 {
-    Json::Reader reader;
-    Json::Value json;
-    bool result = reader.parse(jsonString, json);
-    VerifyOrReturnError(result, CHIP_ERROR_INTERNAL);
-
-    ElementContext elementCtx;
-    elementCtx.type = { TLV::kTLVType_Structure, false };
-
     // Use kTemporaryImplicitProfileId as the default value for cases where no explicit implicit profile ID is provided by
     // the caller. This allows for the encoding of tags that are not vendor-specific or context-specific but are instead
     // associated with a temporary implicit profile ID (0xFF01).
@@ -427,7 +1118,7 @@ CHIP_ERROR JsonToTlv(const std::string & jsonString, TLV::TLVWriter & writer)
         writer.ImplicitProfileId = kTemporaryImplicitProfileId;
     }
 
-    return EncodeTlvElement(json, writer, elementCtx);
+    return JsonToTlvEncoder(jsonString, writer).Encode();
 }
 
 CHIP_ERROR ConvertTlvTag(uint32_t tagNumber, TLV::Tag & tag)
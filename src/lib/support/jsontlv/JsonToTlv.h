@@ -20,6 +20,12 @@
 
 namespace chip {
 
+/*
+ * Deepest nesting of structures and arrays that JsonToTlv can encode, the top-level structure being the first level. Deeper
+ * documents are rejected with CHIP_ERROR_NO_MEMORY.
+ */
+inline constexpr size_t kJsonToTlvMaxContainerDepth = 32;
+
 /*
  * Given a JSON object that represents TLV, this function writes the corresponding TLV bytes into the provided buffer.
  * The size of tlv will be adjusted to the size of the actual data written to the buffer.
@@ -15,11 +15,18 @@
  *    limitations under the License.
  */
 
-#include "lib/support/CHIPMemString.h"
-#include "lib/support/ScopedBuffer.h"
-#include <json/json.h>
+#include <stdio.h>
+
+#include <algorithm>
+#include <charconv>
+#include <cmath>
+#include <limits>
+#include <string>
+#include <vector>
+
 #include <lib/core/DataModelTypes.h>
 #include <lib/support/Base64.h>
+#include <lib/support/CodeUtils.h>
 #include <lib/support/SafeInt.h>
 #include <lib/support/jsontlv/ElementTypes.h>
 #include <lib/support/jsontlv/TlvToJson.h>
@@ -35,6 +42,13 @@ namespace {
 // and this value is never stored.
 constexpr uint32_t kTemporaryImplicitProfileId = 0xFF01;
 
+// Layout of the output, which is the one of the Json::StyledWriter this converter used to be based on.
+constexpr size_t kIndentSize  = 3;
+constexpr size_t kRightMargin = 74;
+
+// Arrays of scalars are written on a single line when short enough, which they cannot be with that many elements.
+constexpr size_t kMaxSingleLineArrayElements = (kRightMargin - 1) / 3;
+
 /// RAII to switch the implicit profile id for a reader
 class ImplicitProfileIdChange
 {
@@ -77,117 +91,276 @@ const char * GetJsonElementStrFromType(const ElementTypeContext & ctx)
     }
 };
 
+ElementTypeContext GetElementType(TLV::TLVReader & reader)
+{
+    ElementTypeContext type;
+    type.tlvType = reader.GetType();
+    if (type.tlvType == TLV::kTLVType_FloatingPointNumber)
+    {
+        type.isDouble = reader.IsElementDouble();
+    }
+    return type;
+}
+
+// Decodes the UTF-8 sequence starting at c, leaving c on its last byte. Invalid sequences decode as the replacement
+// character.
+uint32_t Utf8ToCodePoint(const char *& c, const char * end)
+{
+    constexpr uint32_t kReplacementCharacter = 0xFFFD;
+
+    const auto firstByte = static_cast<uint8_t>(*c);
+    const auto remaining = end - c;
+    auto continuation    = [c](int i) { return static_cast<uint32_t>(c[i] & 0x3F); };
+    uint32_t codePoint;
+
+    if (firstByte < 0x80)
+    {
+        return firstByte;
+    }
+
+    if (firstByte < 0xE0)
+    {
+        VerifyOrReturnValue(remaining >= 2, kReplacementCharacter);
+        codePoint = ((firstByte & 0x1Fu) << 6) | continuation(1);
+        c += 1;
+        // overlong encodings are invalid
+        return (codePoint < 0x80) ? kReplacementCharacter : codePoint;
+    }
+
+    if (firstByte < 0xF0)
+    {
+        VerifyOrReturnValue(remaining >= 3, kReplacementCharacter);
+        codePoint = ((firstByte & 0x0Fu) << 12) | (continuation(1) << 6) | continuation(2);
+        c += 2;
+        // neither surrogates nor overlong encodings are valid
+        return (codePoint < 0x800 || (codePoint >= 0xD800 && codePoint <= 0xDFFF)) ? kReplacementCharacter : codePoint;
+    }
+
+    if (firstByte < 0xF8)
+    {
+        VerifyOrReturnValue(remaining >= 4, kReplacementCharacter);
+        codePoint = ((firstByte & 0x07u) << 18) | (continuation(1) << 12) | (continuation(2) << 6) | continuation(3);
+        c += 3;
+        return (codePoint < 0x10000) ? kReplacementCharacter : codePoint;
+    }
+
+    return kReplacementCharacter;
+}
+
+template <typename T>
+void AppendDecimal(std::string & json, T value)
+{
+    char buffer[24];
+    auto result = std::to_chars(buffer, buffer + sizeof(buffer), value);
+    json.append(buffer, result.ptr);
+}
+
 /*
- * Encapsulates the element information required to construct a JSON element name string in a JSON object.
+ * Writes the JSON representation of a TLV structure while reading it.
  *
- * The generated JSON element name string is constructed as:
- *     'TagNumber:ElementType-SubElementType'.
+ * The members of a JSON object are written sorted by name, so the members of each structure are written in TLV order
+ * first and reordered afterwards when needed, which only takes a copy of the structure when its tags are not already in
+ * name order. Arrays are written on multiple lines first and rewritten on a single line when they turn out to be short.
  */
-struct JsonObjectElementContext
+class TlvToJsonWriter
 {
-    JsonObjectElementContext(TLV::TLVReader & reader)
+public:
+    CHIP_ERROR Convert(TLV::TLVReader & reader)
     {
-        tag               = reader.GetTag();
-        implicitProfileId = reader.ImplicitProfileId;
-        type.tlvType      = reader.GetType();
-        if (type.tlvType == TLV::kTLVType_FloatingPointNumber)
-        {
-            type.isDouble = reader.IsElementDouble();
-        }
+        ReturnErrorOnFailure(WriteStruct(reader));
+        mJson.push_back('\n');
+        return CHIP_NO_ERROR;
     }
 
-    std::string GenerateJsonElementName() const
+    std::string & GetJson() { return mJson; }
+
+private:
+    struct MemberSegment
     {
-        std::string str = "???";
-        if (TLV::IsContextTag(tag))
-        {
-            // common case for context tags: raw value
-            str = std::to_string(TLV::TagNumFromTag(tag));
-        }
-        else if (TLV::IsProfileTag(tag))
-        {
-            if (TLV::ProfileIdFromTag(tag) == implicitProfileId)
-            {
-                str = std::to_string(TLV::TagNumFromTag(tag));
-            }
-            else
-            {
-                uint32_t tagNumber = (static_cast<uint32_t>(TLV::VendorIdFromTag(tag)) << 16) | TLV::TagNumFromTag(tag);
-                str                = std::to_string(tagNumber);
-            }
-        }
-        str = str + ":" + GetJsonElementStrFromType(type);
-        if (type.tlvType == TLV::kTLVType_Array)
-        {
-            str = str + "-" + GetJsonElementStrFromType(subType);
-        }
-        return str;
+        size_t start;
+        size_t end;
+        size_t nameOffset;
+        size_t nameLength;
+    };
+
+    int CompareNames(const MemberSegment & a, const MemberSegment & b) const
+    {
+        return mJson.compare(a.nameOffset, a.nameLength, mJson, b.nameOffset, b.nameLength);
     }
 
-    TLV::Tag tag;
-    uint32_t implicitProfileId;
-    ElementTypeContext type;
-    ElementTypeContext subType;
+    void WriteNewLine()
+    {
+        mJson.push_back('\n');
+        mJson.append(mIndent, ' ');
+    }
+
+    void WriteMemberName(TLV::Tag tag, uint32_t implicitProfileId, const ElementTypeContext & type,
+                         const ElementTypeContext & subType);
+    void WriteQuotedString(CharSpan str);
+    void WriteDouble(double v);
+
+    CHIP_ERROR WriteMember(TLV::TLVReader & reader);
+    CHIP_ERROR WriteValue(TLV::TLVReader & reader);
+    CHIP_ERROR WriteStruct(TLV::TLVReader & reader);
+    CHIP_ERROR WriteArrayElements(TLV::TLVReader & reader, CHIP_ERROR err, const ElementTypeContext & subType);
+    void SortMembers(size_t membersStart);
+
+    std::string mJson;
+    size_t mIndent = 0;
+    std::vector<MemberSegment> mMembers;
+    std::string mScratch;
 };
 
 /*
- * This templated function inserts a name/value pair into the Json object.
- * The value is templated to be of type T and accepts any of the following types:
- *
- *      bool, uint*_t, int*_t, char *, float, double, std::string, Json::Value
- *
- * This method uses the provided element context to generate Json name string.
+ * The generated JSON element name string is constructed as:
+ *     'TagNumber:ElementType-SubElementType'.
  */
-template <typename T>
-void InsertJsonElement(Json::Value & json, const JsonObjectElementContext & ctx, T val)
+void TlvToJsonWriter::WriteMemberName(TLV::Tag tag, uint32_t implicitProfileId, const ElementTypeContext & type,
+                                      const ElementTypeContext & subType)
 {
-    if (json.isArray())
+    mJson.push_back('"');
+    if (TLV::IsContextTag(tag))
     {
-        json.append(val);
+        // common case for context tags: raw value
+        AppendDecimal(mJson, TLV::TagNumFromTag(tag));
+    }
+    else if (TLV::IsProfileTag(tag))
+    {
+        if (TLV::ProfileIdFromTag(tag) == implicitProfileId)
+        {
+            AppendDecimal(mJson, TLV::TagNumFromTag(tag));
+        }
+        else
+        {
+            uint32_t tagNumber = (static_cast<uint32_t>(TLV::VendorIdFromTag(tag)) << 16) | TLV::TagNumFromTag(tag);
+            AppendDecimal(mJson, tagNumber);
+        }
     }
     else
     {
-        json[ctx.GenerateJsonElementName()] = val;
+        mJson.append("???");
+    }
+    mJson.push_back(':');
+    mJson.append(GetJsonElementStrFromType(type));
+    if (type.tlvType == TLV::kTLVType_Array)
+    {
+        mJson.push_back('-');
+        mJson.append(GetJsonElementStrFromType(subType));
     }
+    mJson.append("\" : ");
 }
 
-static CHIP_ERROR TlvToJson(TLV::TLVReader & reader, Json::Value & jsonObj);
-
-/*
- * Given a TLVReader positioned at TLV structure this function:
- *   - enters structure
- *   - converts all elements of a structure into JSON object representation
- *   - exits structure
- */
-CHIP_ERROR TlvStructToJson(TLV::TLVReader & reader, Json::Value & jsonObj)
+// Escapes the string like Json::StyledWriter did: control and non-ASCII characters are written as \u escapes, invalid
+// UTF-8 sequences as the replacement character.
+void TlvToJsonWriter::WriteQuotedString(CharSpan str)
 {
-    CHIP_ERROR err;
-    TLV::TLVType containerType;
-
-    ReturnErrorOnFailure(reader.EnterContainer(containerType));
-
-    while ((err = reader.Next()) == CHIP_NO_ERROR)
+    const char * const end = str.data() + str.size();
+
+    auto requiresEscaping = [](char c) {
+        auto u = static_cast<unsigned char>(c);
+        return u == '\\' || u == '"' || u < 0x20 || u > 0x7F;
+    };
+    auto appendHex = [this](uint32_t value) {
+        static constexpr char kHex[] = "0123456789abcdef";
+        char escape[]                = { '\\', 'u', kHex[(value >> 12) & 0xF], kHex[(value >> 8) & 0xF],
+                          kHex[(value >> 4) & 0xF], kHex[value & 0xF] };
+        mJson.append(escape, sizeof(escape));
+    };
+
+    mJson.push_back('"');
+    for (const char * c = str.data(); c != end; ++c)
     {
-        TLV::Tag tag = reader.GetTag();
-        VerifyOrReturnError(TLV::IsContextTag(tag) || TLV::IsProfileTag(tag), CHIP_ERROR_INVALID_TLV_TAG);
+        const char * run = c;
+        while (c != end && !requiresEscaping(*c))
+        {
+            ++c;
+        }
+        mJson.append(run, static_cast<size_t>(c - run));
+        if (c == end)
+        {
+            break;
+        }
 
-        if (TLV::IsProfileTag(tag) && TLV::VendorIdFromTag(tag) == 0)
+        switch (*c)
         {
-            VerifyOrReturnError(TLV::TagNumFromTag(tag) > UINT8_MAX, CHIP_ERROR_INVALID_TLV_TAG);
+        case '"':
+            mJson.append("\\\"");
+            continue;
+        case '\\':
+            mJson.append("\\\\");
+            continue;
+        case '\b':
+            mJson.append("\\b");
+            continue;
+        case '\f':
+            mJson.append("\\f");
+            continue;
+        case '\n':
+            mJson.append("\\n");
+            continue;
+        case '\r':
+            mJson.append("\\r");
+            continue;
+        case '\t':
+            mJson.append("\\t");
+            continue;
+        default:
+            break;
         }
 
-        // Recursively convert to JSON the item within the struct.
-        ReturnErrorOnFailure(TlvToJson(reader, jsonObj));
+        uint32_t codePoint = Utf8ToCodePoint(c, end);
+        if (codePoint < 0x80 && codePoint >= 0x20)
+        {
+            mJson.push_back(static_cast<char>(codePoint));
+        }
+        else if (codePoint < 0x10000)
+        {
+            appendHex(codePoint);
+        }
+        else
+        {
+            // Encode 20 bits as a surrogate pair.
+            codePoint -= 0x10000;
+            appendHex(0xD800 + ((codePoint >> 10) & 0x3FF));
+            appendHex(0xDC00 + (codePoint & 0x3FF));
+        }
     }
-
-    VerifyOrReturnError(err == CHIP_END_OF_TLV, err);
-    return reader.ExitContainer(containerType);
+    mJson.push_back('"');
 }
 
-CHIP_ERROR TlvToJson(TLV::TLVReader & reader, Json::Value & jsonObj)
+void TlvToJsonWriter::WriteDouble(double v)
 {
-    JsonObjectElementContext context(reader);
+    if (v == std::numeric_limits<double>::infinity())
+    {
+        WriteQuotedString(CharSpan::fromCharString(kFloatingPointPositiveInfinity));
+        return;
+    }
+    if (v == -std::numeric_limits<double>::infinity())
+    {
+        WriteQuotedString(CharSpan::fromCharString(kFloatingPointNegativeInfinity));
+        return;
+    }
+    if (std::isnan(v))
+    {
+        mJson.append("null");
+        return;
+    }
+
+    char buffer[32];
+    int length = snprintf(buffer, sizeof(buffer), "%.17g", v);
+    VerifyOrReturn(length > 0 && static_cast<size_t>(length) < sizeof(buffer));
 
+    // Keep the output locale independent, and make sure that the number reads back as a floating point number.
+    std::replace(buffer, buffer + length, ',', '.');
+    mJson.append(buffer, static_cast<size_t>(length));
+    if (std::none_of(buffer, buffer + length, [](char c) { return c == '.' || c == 'e'; }))
+    {
+        mJson.append(".0");
+    }
+}
+
+CHIP_ERROR TlvToJsonWriter::WriteValue(TLV::TLVReader & reader)
+{
     switch (reader.GetType())
     {
     case TLV::kTLVType_UnsignedInteger: {
@@ -195,11 +368,13 @@ CHIP_ERROR TlvToJson(TLV::TLVReader & reader, Json::Value & jsonObj)
         ReturnErrorOnFailure(reader.Get(v));
         if (CanCastTo<uint32_t>(v))
         {
-            InsertJsonElement(jsonObj, context, v);
+            AppendDecimal(mJson, v);
         }
         else
         {
-            InsertJsonElement(jsonObj, context, std::to_string(v));
+            mJson.push_back('"');
+            AppendDecimal(mJson, v);
+            mJson.push_back('"');
         }
         break;
     }
@@ -209,11 +384,13 @@ CHIP_ERROR TlvToJson(TLV::TLVReader & reader, Json::Value & jsonObj)
         ReturnErrorOnFailure(reader.Get(v));
         if (CanCastTo<int32_t>(v))
         {
-            InsertJsonElement(jsonObj, context, v);
+            AppendDecimal(mJson, v);
         }
         else
         {
-            InsertJsonElement(jsonObj, context, std::to_string(v));
+            mJson.push_back('"');
+            AppendDecimal(mJson, v);
+            mJson.push_back('"');
         }
         break;
     }
@@ -221,25 +398,14 @@ CHIP_ERROR TlvToJson(TLV::TLVReader & reader, Json::Value & jsonObj)
     case TLV::kTLVType_Boolean: {
         bool v;
         ReturnErrorOnFailure(reader.Get(v));
-        InsertJsonElement(jsonObj, context, v);
+        mJson.append(v ? "true" : "false");
         break;
     }
 
     case TLV::kTLVType_FloatingPointNumber: {
         double v;
         ReturnErrorOnFailure(reader.Get(v));
-        if (v == std::numeric_limits<double>::infinity())
-        {
-            InsertJsonElement(jsonObj, context, kFloatingPointPositiveInfinity);
-        }
-        else if (v == -std::numeric_limits<double>::infinity())
-        {
-            InsertJsonElement(jsonObj, context, kFloatingPointNegativeInfinity);
-        }
-        else
-        {
-            InsertJsonElement(jsonObj, context, v);
-        }
+        WriteDouble(v);
         break;
     }
 
@@ -247,88 +413,265 @@ CHIP_ERROR TlvToJson(TLV::TLVReader & reader, Json::Value & jsonObj)
         ByteSpan span;
         ReturnErrorOnFailure(reader.Get(span));
 
-        Platform::ScopedMemoryBuffer<char> byteString;
-        byteString.Alloc(BASE64_ENCODED_LEN(span.size()) + 1);
-        VerifyOrReturnError(byteString.Get() != nullptr, CHIP_ERROR_NO_MEMORY);
-
-        auto encodedLen              = Base64Encode(span.data(), static_cast<uint16_t>(span.size()), byteString.Get());
-        byteString.Get()[encodedLen] = '\0';
-
-        InsertJsonElement(jsonObj, context, byteString.Get());
+        // Base64 output never needs escaping: encode in place.
+        mJson.push_back('"');
+        size_t offset = mJson.size();
+        mJson.resize(offset + BASE64_ENCODED_LEN(span.size()));
+        auto encodedLen = Base64Encode(span.data(), static_cast<uint16_t>(span.size()), &mJson[offset]);
+        mJson.resize(offset + encodedLen);
+        mJson.push_back('"');
         break;
     }
 
     case TLV::kTLVType_UTF8String: {
         CharSpan span;
         ReturnErrorOnFailure(reader.Get(span));
-
-        std::string str(span.data(), span.size());
-        InsertJsonElement(jsonObj, context, str);
+        WriteQuotedString(span);
         break;
     }
 
     case TLV::kTLVType_Null: {
-        InsertJsonElement(jsonObj, context, Json::Value());
+        mJson.append("null");
         break;
     }
 
     case TLV::kTLVType_Structure: {
-        Json::Value jsonStruct(Json::objectValue);
-        ReturnErrorOnFailure(TlvStructToJson(reader, jsonStruct));
-        InsertJsonElement(jsonObj, context, jsonStruct);
+        ReturnErrorOnFailure(WriteStruct(reader));
         break;
     }
 
-    case TLV::kTLVType_Array: {
-        CHIP_ERROR err;
-        Json::Value jsonArray(Json::arrayValue);
-        ElementTypeContext prevSubType;
-        ElementTypeContext nextSubType;
-        TLV::TLVType containerType;
+    default:
+        return CHIP_ERROR_INVALID_TLV_ELEMENT;
+        break;
+    }
+
+    return CHIP_NO_ERROR;
+}
+
+/*
+ * Given a TLVReader positioned at TLV structure this function:
+ *   - enters structure
+ *   - converts all elements of a structure into JSON object representation
+ *   - exits structure
+ */
+CHIP_ERROR TlvToJsonWriter::WriteStruct(TLV::TLVReader & reader)
+{
+    CHIP_ERROR err;
+    TLV::TLVType containerType;
+
+    ReturnErrorOnFailure(reader.EnterContainer(containerType));
+
+    const size_t membersStart = mMembers.size();
+    while ((err = reader.Next()) == CHIP_NO_ERROR)
+    {
+        TLV::Tag tag = reader.GetTag();
+        VerifyOrReturnError(TLV::IsContextTag(tag) || TLV::IsProfileTag(tag), CHIP_ERROR_INVALID_TLV_TAG);
+
+        if (TLV::IsProfileTag(tag) && TLV::VendorIdFromTag(tag) == 0)
+        {
+            VerifyOrReturnError(TLV::TagNumFromTag(tag) > UINT8_MAX, CHIP_ERROR_INVALID_TLV_TAG);
+        }
+
+        if (mMembers.size() == membersStart)
+        {
+            mJson.push_back('{');
+            mIndent += kIndentSize;
+        }
+        else
+        {
+            mJson.push_back(',');
+        }
 
+        // Recursively convert to JSON the item within the struct.
+        ReturnErrorOnFailure(WriteMember(reader));
+    }
+
+    VerifyOrReturnError(err == CHIP_END_OF_TLV, err);
+    ReturnErrorOnFailure(reader.ExitContainer(containerType));
+
+    if (mMembers.size() == membersStart)
+    {
+        mJson.append("{}");
+        return CHIP_NO_ERROR;
+    }
+
+    SortMembers(membersStart);
+    mMembers.resize(membersStart);
+
+    mIndent -= kIndentSize;
+    WriteNewLine();
+    mJson.push_back('}');
+    return CHIP_NO_ERROR;
+}
+
+CHIP_ERROR TlvToJsonWriter::WriteMember(TLV::TLVReader & reader)
+{
+    MemberSegment member;
+    member.start = mJson.size();
+    WriteNewLine();
+    member.nameOffset = mJson.size() + 1;
+
+    TLV::Tag tag            = reader.GetTag();
+    ElementTypeContext type = GetElementType(reader);
+    if (type.tlvType != TLV::kTLVType_Array)
+    {
+        WriteMemberName(tag, reader.ImplicitProfileId, type, ElementTypeContext());
+        ReturnErrorOnFailure(WriteValue(reader));
+    }
+    else
+    {
+        // The type of the array elements is part of the member name, get it from the first element.
+        TLV::TLVType containerType;
         ReturnErrorOnFailure(reader.EnterContainer(containerType));
 
-        while ((err = reader.Next()) == CHIP_NO_ERROR)
+        ElementTypeContext subType;
+        CHIP_ERROR err = reader.Next();
+        if (err == CHIP_NO_ERROR)
         {
-            VerifyOrReturnError(reader.GetTag() == TLV::AnonymousTag(), CHIP_ERROR_INVALID_TLV_TAG);
-            VerifyOrReturnError(reader.GetType() != TLV::kTLVType_Array, CHIP_ERROR_INVALID_TLV_ELEMENT);
-
-            nextSubType.tlvType = reader.GetType();
-            if (nextSubType.tlvType == TLV::kTLVType_FloatingPointNumber)
-            {
-                nextSubType.isDouble = reader.IsElementDouble();
-            }
-
-            if (jsonArray.empty())
-            {
-                prevSubType = nextSubType;
-            }
-            else
-            {
-                VerifyOrReturnError(prevSubType.tlvType == nextSubType.tlvType && prevSubType.isDouble == nextSubType.isDouble,
-                                    CHIP_ERROR_INVALID_TLV_ELEMENT);
-            }
-
-            // Recursively convert to JSON the encompassing item within the array.
-            ReturnErrorOnFailure(TlvToJson(reader, jsonArray));
+            subType = GetElementType(reader);
         }
 
-        VerifyOrReturnError(err == CHIP_END_OF_TLV, err);
+        WriteMemberName(tag, reader.ImplicitProfileId, type, subType);
+        ReturnErrorOnFailure(WriteArrayElements(reader, err, subType));
         ReturnErrorOnFailure(reader.ExitContainer(containerType));
+    }
 
-        context.subType = prevSubType;
-        InsertJsonElement(jsonObj, context, jsonArray);
-        break;
+    member.nameLength = mJson.find('"', member.nameOffset) - member.nameOffset;
+    member.end        = mJson.size();
+    mMembers.push_back(member);
+    return CHIP_NO_ERROR;
+}
+
+CHIP_ERROR TlvToJsonWriter::WriteArrayElements(TLV::TLVReader & reader, CHIP_ERROR err, const ElementTypeContext & subType)
+{
+    if (err == CHIP_END_OF_TLV)
+    {
+        mJson.append("[]");
+        return CHIP_NO_ERROR;
     }
 
-    default:
-        return CHIP_ERROR_INVALID_TLV_ELEMENT;
-        break;
+    const size_t arrayStart = mJson.size();
+    mJson.push_back('[');
+    mIndent += kIndentSize;
+
+    // Offsets and lengths of the first elements, and whether the array can still be written on a single line.
+    size_t elementOffsets[kMaxSingleLineArrayElements];
+    size_t elementLengths[kMaxSingleLineArrayElements];
+    size_t elementCount = 0;
+    size_t lineLength   = 0;
+    bool singleLine     = true;
+
+    for (; err == CHIP_NO_ERROR; err = reader.Next())
+    {
+        VerifyOrReturnError(reader.GetTag() == TLV::AnonymousTag(), CHIP_ERROR_INVALID_TLV_TAG);
+        VerifyOrReturnError(reader.GetType() != TLV::kTLVType_Array, CHIP_ERROR_INVALID_TLV_ELEMENT);
+
+        ElementTypeContext nextSubType = GetElementType(reader);
+        VerifyOrReturnError(subType.tlvType == nextSubType.tlvType && subType.isDouble == nextSubType.isDouble,
+                            CHIP_ERROR_INVALID_TLV_ELEMENT);
+
+        if (elementCount > 0)
+        {
+            mJson.push_back(',');
+        }
+        WriteNewLine();
+
+        // Recursively convert to JSON the encompassing item within the array.
+        const size_t elementOffset = mJson.size();
+        ReturnErrorOnFailure(WriteValue(reader));
+        const size_t elementLength = mJson.size() - elementOffset;
+
+        if (elementCount < kMaxSingleLineArrayElements)
+        {
+            elementOffsets[elementCount] = elementOffset;
+            elementLengths[elementCount] = elementLength;
+        }
+        else
+        {
+            singleLine = false;
+        }
+        lineLength += elementLength;
+        // Only empty structures can be written on a single line.
+        singleLine = singleLine && !(nextSubType.tlvType == TLV::kTLVType_Structure && elementLength > 2);
+        elementCount++;
     }
 
+    VerifyOrReturnError(err == CHIP_END_OF_TLV, err);
+    mIndent -= kIndentSize;
+
+    // '[ ' + ', ' between elements + ' ]'
+    lineLength += 4 + (elementCount - 1) * 2;
+    if (!singleLine || lineLength >= kRightMargin)
+    {
+        WriteNewLine();
+        mJson.push_back(']');
+        return CHIP_NO_ERROR;
+    }
+
+    char line[kRightMargin];
+    size_t length = 0;
+    line[length++] = '[';
+    line[length++] = ' ';
+    for (size_t i = 0; i < elementCount; i++)
+    {
+        if (i > 0)
+        {
+            line[length++] = ',';
+            line[length++] = ' ';
+        }
+        memcpy(&line[length], &mJson[elementOffsets[i]], elementLengths[i]);
+        length += elementLengths[i];
+    }
+    line[length++] = ' ';
+    line[length++] = ']';
+
+    mJson.resize(arrayStart);
+    mJson.append(line, length);
     return CHIP_NO_ERROR;
 }
 
+// Orders the members of the structure by name, like a JSON object, keeping only the last of the members with the same
+// name.
+void TlvToJsonWriter::SortMembers(size_t membersStart)
+{
+    bool sorted = true;
+    for (size_t i = membersStart + 1; i < mMembers.size() && sorted; i++)
+    {
+        sorted = CompareNames(mMembers[i - 1], mMembers[i]) < 0;
+    }
+    VerifyOrReturn(!sorted);
+
+    const size_t regionStart = mMembers[membersStart].start;
+    mScratch.assign(mJson, regionStart, mJson.size() - regionStart);
+
+    auto first = mMembers.begin() + static_cast<ptrdiff_t>(membersStart);
+    std::sort(first, mMembers.end(), [this](const MemberSegment & a, const MemberSegment & b) {
+        int nameComparison = CompareNames(a, b);
+        return (nameComparison != 0) ? (nameComparison < 0) : (a.start < b.start);
+    });
+
+    size_t end = membersStart;
+    for (size_t i = membersStart; i < mMembers.size(); i++)
+    {
+        if (i + 1 < mMembers.size() && CompareNames(mMembers[i], mMembers[i + 1]) == 0)
+        {
+            continue;
+        }
+        mMembers[end++] = mMembers[i];
+    }
+    mMembers.resize(end);
+
+    mJson.resize(regionStart);
+    for (size_t i = membersStart; i < mMembers.size(); i++)
+    {
+        if (i > membersStart)
+        {
+            mJson.push_back(',');
+        }
+        mJson.append(mScratch, mMembers[i].start - regionStart, mMembers[i].end - mMembers[i].start);
+    }
+}
+
 } // namespace
 
 CHIP_ERROR TlvToJson(const ByteSpan & tlv, std::string & jsonString)
@@ -350,11 +693,10 @@ CHIP_ERROR TlvToJson(TLV::TLVReader & reader, std::string & jsonString)
     // During json conversion, a implicit profile ID is required
     ImplicitProfileIdChange implicitProfileIdChange(reader, kTemporaryImplicitProfileId);
 
-    Json::Value jsonObject(Json::objectValue);
-    ReturnErrorOnFailure(TlvStructToJson(reader, jsonObject));
+    TlvToJsonWriter writer;
+    ReturnErrorOnFailure(writer.Convert(reader));
 
-    Json::StyledWriter writer;
-    jsonString = writer.write(jsonObject);
+    jsonString = std::move(writer.GetJson());
     return CHIP_NO_ERROR;
 }
 } // namespace chip
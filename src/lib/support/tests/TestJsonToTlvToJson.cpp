@@ -26,6 +26,7 @@
 #include <lib/core/StringBuilderAdapters.h>
 #include <lib/support/jsontlv/JsonToTlv.h>
 #include <lib/support/jsontlv/TextFormat.h>
+#include <lib/support/ScopedBuffer.h>
 #include <lib/support/jsontlv/TlvToJson.h>
 
 namespace {
@@ -1862,4 +1863,224 @@ TEST_F(TestJsonToTlvToJson, TestConverter_Struct_MEITags)
     ByteSpan tlvSpan(buf, writer.GetLengthWritten());
     CheckValidConversion(jsonString, tlvSpan, jsonString);
 }
+
+// Report-sized payload: a long list of structures, such as a large list attribute, converted to JSON and back
+TEST_F(TestJsonToTlvToJson, TestConverter_LargeList_RoundTrip)
+{
+    constexpr size_t kBufferSize = 1024 * 1024;
+    constexpr uint32_t kEntries  = 10000;
+
+    Platform::ScopedMemoryBuffer<uint8_t> tlvBuffer;
+    Platform::ScopedMemoryBuffer<uint8_t> roundTripBuffer;
+    ASSERT_TRUE(tlvBuffer.Alloc(kBufferSize));
+    ASSERT_TRUE(roundTripBuffer.Alloc(kBufferSize));
+
+    TLV::TLVWriter writer;
+    TLV::TLVType containerType;
+    TLV::TLVType containerType2;
+    TLV::TLVType containerType3;
+    TLV::TLVType containerType4;
+    const char bytes[] = "Report ByteString Value";
+
+    writer.Init(tlvBuffer.Get(), kBufferSize);
+    writer.ImplicitProfileId = kImplicitProfileId;
+
+    EXPECT_EQ(CHIP_NO_ERROR, writer.StartContainer(TLV::AnonymousTag(), TLV::kTLVType_Structure, containerType));
+    EXPECT_EQ(CHIP_NO_ERROR, writer.StartContainer(TLV::ContextTag(1), TLV::kTLVType_Array, containerType2));
+    for (uint32_t i = 0; i < kEntries; i++)
+    {
+        EXPECT_EQ(CHIP_NO_ERROR, writer.StartContainer(TLV::AnonymousTag(), TLV::kTLVType_Structure, containerType3));
+        EXPECT_EQ(CHIP_NO_ERROR, writer.Put(TLV::ContextTag(0), static_cast<uint64_t>(i)));
+        EXPECT_EQ(CHIP_NO_ERROR, writer.Put(TLV::ContextTag(1), static_cast<int64_t>(i) * -1000));
+        EXPECT_EQ(CHIP_NO_ERROR, writer.Put(TLV::ContextTag(2), (i % 2) == 0));
+        EXPECT_EQ(CHIP_NO_ERROR, writer.PutString(TLV::ContextTag(3), "entry label"));
+        EXPECT_EQ(CHIP_NO_ERROR,
+                  writer.PutBytes(TLV::ContextTag(4), reinterpret_cast<const uint8_t *>(bytes),
+                                  static_cast<uint32_t>(strlen(bytes))));
+        EXPECT_EQ(CHIP_NO_ERROR, writer.StartContainer(TLV::ContextTag(5), TLV::kTLVType_Array, containerType4));
+        for (uint8_t j = 0; j < 4; j++)
+        {
+            EXPECT_EQ(CHIP_NO_ERROR, writer.Put(TLV::AnonymousTag(), static_cast<uint64_t>(i + j)));
+        }
+        EXPECT_EQ(CHIP_NO_ERROR, writer.EndContainer(containerType4));
+        EXPECT_EQ(CHIP_NO_ERROR, writer.Put(TLV::ContextTag(6), static_cast<double>(i) / 8));
+        EXPECT_EQ(CHIP_NO_ERROR, writer.EndContainer(containerType3));
+    }
+    EXPECT_EQ(CHIP_NO_ERROR, writer.EndContainer(containerType2));
+    EXPECT_EQ(CHIP_NO_ERROR, writer.EndContainer(containerType));
+    EXPECT_EQ(CHIP_NO_ERROR, writer.Finalize());
+
+    ByteSpan tlvSpan(tlvBuffer.Get(), writer.GetLengthWritten());
+    std::string jsonString;
+    EXPECT_EQ(CHIP_NO_ERROR, TlvToJson(tlvSpan, jsonString));
+    EXPECT_GT(jsonString.size(), kBufferSize);
+
+    MutableByteSpan roundTripSpan(roundTripBuffer.Get(), kBufferSize);
+    EXPECT_EQ(CHIP_NO_ERROR, JsonToTlv(jsonString, roundTripSpan));
+    EXPECT_TRUE(roundTripSpan.data_equal(tlvSpan));
+}
+void CheckJsonToTlv(const std::string & jsonString, const ByteSpan & tlvEncoding)
+{
+    uint8_t buf[256];
+    MutableByteSpan tlvEncodingLocal(buf);
+    EXPECT_EQ(JsonToTlv(jsonString, tlvEncodingLocal), CHIP_NO_ERROR);
+
+    bool match = tlvEncodingLocal.data_equal(tlvEncoding);
+    EXPECT_TRUE(match);
+    if (!match)
+    {
+        PrintSpan("Expected TLV Encoding:  ", tlvEncoding);
+        PrintSpan("Generated TLV Encoding: ", tlvEncodingLocal);
+    }
+}
+
+// Comments are allowed around values, trailing content after the top-level object is ignored, and numbers in any JSON
+// form are accepted as long as they convert exactly, as with the jsoncpp reader.
+TEST_F(TestJsonToTlvToJson, TestConverter_JsonToTlv_ReaderLeniency)
+{
+    uint8_t buf[256];
+    TLV::TLVWriter writer;
+    TLV::TLVType containerType;
+
+    writer.Init(buf);
+    writer.ImplicitProfileId = kImplicitProfileId;
+
+    EXPECT_EQ(CHIP_NO_ERROR, writer.StartContainer(TLV::AnonymousTag(), TLV::kTLVType_Structure, containerType));
+    EXPECT_EQ(CHIP_NO_ERROR, writer.Put(TLV::ContextTag(1), static_cast<uint64_t>(100)));
+    EXPECT_EQ(CHIP_NO_ERROR, writer.Put(TLV::ContextTag(2), static_cast<int64_t>(-5)));
+    EXPECT_EQ(CHIP_NO_ERROR, writer.Put(TLV::ContextTag(3), static_cast<uint64_t>(UINT64_MAX)));
+    EXPECT_EQ(CHIP_NO_ERROR, writer.Put(TLV::ContextTag(4), 0.25));
+    EXPECT_EQ(CHIP_NO_ERROR, writer.EndContainer(containerType));
+    EXPECT_EQ(CHIP_NO_ERROR, writer.Finalize());
+
+    std::string jsonString = "// leading comment\n"
+                             "{\n"
+                             "   \"1:UINT\" : 1e2, // exponent\n"
+                             "   /* before a name */ \"2:INT\" : -5.0,\n"
+                             "   \"3:UINT\" : 18446744073709551615,\n"
+                             "   \"4:DOUBLE\" : /* before a value */ 25E-2\n"
+                             "}\n"
+                             "trailing content";
+
+    CheckJsonToTlv(jsonString, ByteSpan(buf, writer.GetLengthWritten()));
+}
+
+// A name used more than once only keeps its last value, and members sharing a tag number are encoded in name order.
+TEST_F(TestJsonToTlvToJson, TestConverter_JsonToTlv_DuplicateMembers)
+{
+    uint8_t buf[256];
+    TLV::TLVWriter writer;
+    TLV::TLVType containerType;
+    TLV::TLVType containerType2;
+
+    writer.Init(buf);
+    writer.ImplicitProfileId = kImplicitProfileId;
+
+    EXPECT_EQ(CHIP_NO_ERROR, writer.StartContainer(TLV::AnonymousTag(), TLV::kTLVType_Structure, containerType));
+    EXPECT_EQ(CHIP_NO_ERROR, writer.Put(TLV::ContextTag(1), static_cast<int64_t>(-1)));
+    EXPECT_EQ(CHIP_NO_ERROR, writer.Put(TLV::ContextTag(1), static_cast<uint64_t>(3)));
+    EXPECT_EQ(CHIP_NO_ERROR, writer.StartContainer(TLV::ContextTag(2), TLV::kTLVType_Structure, containerType2));
+    EXPECT_EQ(CHIP_NO_ERROR, writer.Put(TLV::ContextTag(0), true));
+    EXPECT_EQ(CHIP_NO_ERROR, writer.EndContainer(containerType2));
+    EXPECT_EQ(CHIP_NO_ERROR, writer.EndContainer(containerType));
+    EXPECT_EQ(CHIP_NO_ERROR, writer.Finalize());
+
+    std::string jsonString = "{\n"
+                             "   \"2:STRUCT\" : { \"0:BOOL\" : false },\n"
+                             "   \"1:UINT\" : 1,\n"
+                             "   \"1:INT\" : -1,\n"
+                             "   \"2:STRUCT\" : { \"0:BOOL\" : true },\n"
+                             "   \"1:UINT\" : 3\n"
+                             "}\n";
+
+    CheckJsonToTlv(jsonString, ByteSpan(buf, writer.GetLengthWritten()));
+}
+
+// A comment must be followed by a member separator, which the jsoncpp reader did not check.
+TEST_F(TestJsonToTlvToJson, TestConverter_JsonToTlv_CommentInsteadOfSeparator)
+{
+    uint8_t buf[256];
+    MutableByteSpan tlvSpan(buf);
+
+    EXPECT_EQ(JsonToTlv("{ \"1:UINT\" : 1 /* c */ \"2:UINT\" : 2 }", tlvSpan), CHIP_ERROR_INTERNAL);
+
+    tlvSpan = MutableByteSpan(buf);
+    EXPECT_EQ(JsonToTlv("{ \"1:UINT\" : 1 /* c */, \"2:UINT\" : 2 }", tlvSpan), CHIP_NO_ERROR);
+}
+
+// Structures and arrays can be nested up to kJsonToTlvMaxContainerDepth levels, deeper documents are rejected.
+TEST_F(TestJsonToTlvToJson, TestConverter_JsonToTlv_NestingDepth)
+{
+    auto nestedJson = [](size_t depth) {
+        std::string json = "{";
+        for (size_t i = 1; i < depth; i++)
+        {
+            json += (i % 2) ? "\"0:ARRAY-STRUCT\" : [" : "{";
+        }
+        for (size_t i = depth - 1; i > 0; i--)
+        {
+            json += (i % 2) ? "]" : "}";
+        }
+        return json + "}";
+    };
+
+    uint8_t buf[256];
+    MutableByteSpan tlvSpan(buf);
+    EXPECT_EQ(JsonToTlv(nestedJson(kJsonToTlvMaxContainerDepth), tlvSpan), CHIP_NO_ERROR);
+
+    TLV::TLVReader reader;
+    reader.Init(tlvSpan);
+    size_t depth = 0;
+    TLV::TLVType containerType;
+    while (reader.Next() == CHIP_NO_ERROR && TLV::TLVTypeIsContainer(reader.GetType()))
+    {
+        EXPECT_EQ(reader.EnterContainer(containerType), CHIP_NO_ERROR);
+        depth++;
+    }
+    EXPECT_EQ(depth, kJsonToTlvMaxContainerDepth);
+
+    tlvSpan = MutableByteSpan(buf);
+    EXPECT_EQ(JsonToTlv(nestedJson(kJsonToTlvMaxContainerDepth + 1), tlvSpan), CHIP_ERROR_NO_MEMORY);
+
+    // The whole document is parsed before encoding, so syntax errors are still reported as such.
+    std::string truncatedJson = nestedJson(kJsonToTlvMaxContainerDepth + 1);
+    truncatedJson.pop_back();
+    tlvSpan = MutableByteSpan(buf);
+    EXPECT_EQ(JsonToTlv(truncatedJson, tlvSpan), CHIP_ERROR_INTERNAL);
+}
+
+// Members are written sorted by name, whichever order their tags have in the TLV.
+TEST_F(TestJsonToTlvToJson, TestConverter_TlvToJson_MemberOrder)
+{
+    uint8_t buf[256];
+    TLV::TLVWriter writer;
+    TLV::TLVType containerType;
+    TLV::TLVType containerType2;
+
+    writer.Init(buf);
+    writer.ImplicitProfileId = kImplicitProfileId;
+
+    EXPECT_EQ(CHIP_NO_ERROR, writer.StartContainer(TLV::AnonymousTag(), TLV::kTLVType_Structure, containerType));
+    EXPECT_EQ(CHIP_NO_ERROR, writer.Put(TLV::ContextTag(2), static_cast<uint64_t>(1)));
+    EXPECT_EQ(CHIP_NO_ERROR, writer.StartContainer(TLV::ContextTag(10), TLV::kTLVType_Structure, containerType2));
+    EXPECT_EQ(CHIP_NO_ERROR, writer.Put(TLV::ContextTag(9), false));
+    EXPECT_EQ(CHIP_NO_ERROR, writer.PutString(TLV::ContextTag(11), "b"));
+    EXPECT_EQ(CHIP_NO_ERROR, writer.EndContainer(containerType2));
+    EXPECT_EQ(CHIP_NO_ERROR, writer.Put(TLV::ContextTag(3), static_cast<int64_t>(-2)));
+    EXPECT_EQ(CHIP_NO_ERROR, writer.EndContainer(containerType));
+    EXPECT_EQ(CHIP_NO_ERROR, writer.Finalize());
+
+    std::string expectedJsonString = "{\n"
+                                     "   \"10:STRUCT\" : {\n"
+                                     "      \"11:STRING\" : \"b\",\n"
+                                     "      \"9:BOOL\" : false\n"
+                                     "   },\n"
+                                     "   \"2:UINT\" : 1,\n"
+                                     "   \"3:INT\" : -2\n"
+                                     "}\n";
+
+    std::string jsonString;
+    EXPECT_EQ(CHIP_NO_ERROR, TlvToJson(ByteSpan(buf, writer.GetLengthWritten()), jsonString));
+    EXPECT_EQ(jsonString, expectedJsonString);
+}
 } // namespace
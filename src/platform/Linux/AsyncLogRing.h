@@ -0,0 +1,129 @@
+/*
+ *
+ *    Copyright (c) 2024 Project CHIP Authors
+ *
+ *    Licensed under the Apache License, Version 2.0 (the "License");
+ *    you may not use this file except in compliance with the License.
+ *    You may obtain a copy of the License at
+ *
+ *        http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *    Unless required by applicable law or agreed to in writing, software
+ *    distributed under the License is distributed on an "AS IS" BASIS,
+ *    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *    See the License for the specific language governing permissions and
+ *    limitations under the License.
+ */
+
+/**
+ *    @file
+ *          Ring buffer of formatted log lines backing the Linux asynchronous
+ *          log output (see AsyncLogging.h).
+ */
+
+#pragma once
+
+#include <lib/core/CHIPConfig.h>
+#include <lib/support/logging/Constants.h>
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <sys/time.h>
+
+namespace chip {
+namespace Logging {
+namespace Platform {
+
+/**
+ * Bounded multi-producer, single-consumer ring of formatted log lines.
+ *
+ * Each cell carries a sequence number telling whether it is free for the producer at a given position or holds a
+ * record for the consumer, so producers only contend on a single atomic increment and never block. A record that
+ * does not fit is dropped and counted.
+ */
+template <size_t kCapacity>
+class AsyncLogRing
+{
+public:
+    static_assert(kCapacity > 0 && (kCapacity & (kCapacity - 1)) == 0, "Ring capacity must be a power of two");
+
+    struct Record
+    {
+        struct timeval timestamp;
+        long long tid;
+        char module[kMaxModuleNameLen + 1];
+        char message[CHIP_CONFIG_LOG_MESSAGE_MAX_SIZE];
+    };
+
+    AsyncLogRing()
+    {
+        for (size_t i = 0; i < kCapacity; i++)
+        {
+            mCells[i].sequence.store(i, std::memory_order_relaxed);
+        }
+    }
+
+    // Reserve a record for writing, or return nullptr and count a dropped record when the ring is full. Must be
+    // followed by Commit(pos).
+    Record * Reserve(size_t & outPos)
+    {
+        size_t pos = mEnqueuePos.load(std::memory_order_relaxed);
+        while (true)
+        {
+            Cell & cell   = mCells[pos & (kCapacity - 1)];
+            size_t seq    = cell.sequence.load(std::memory_order_acquire);
+            intptr_t diff = static_cast<intptr_t>(seq) - static_cast<intptr_t>(pos);
+            if (diff == 0)
+            {
+                if (mEnqueuePos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed))
+                {
+                    outPos = pos;
+                    return &cell.record;
+                }
+            }
+            else if (diff < 0)
+            {
+                mDropped.fetch_add(1, std::memory_order_relaxed);
+                return nullptr;
+            }
+            else
+            {
+                pos = mEnqueuePos.load(std::memory_order_relaxed);
+            }
+        }
+    }
+
+    void Commit(size_t pos) { mCells[pos & (kCapacity - 1)].sequence.store(pos + 1, std::memory_order_release); }
+
+    // Consumer side; only called from a single thread.
+    Record * Front()
+    {
+        Cell & cell = mCells[mDequeuePos & (kCapacity - 1)];
+        return (cell.sequence.load(std::memory_order_acquire) == mDequeuePos + 1) ? &cell.record : nullptr;
+    }
+
+    void Pop()
+    {
+        mCells[mDequeuePos & (kCapacity - 1)].sequence.store(mDequeuePos + kCapacity, std::memory_order_release);
+        mDequeuePos++;
+    }
+
+    uint64_t DroppedCount() const { return mDropped.load(std::memory_order_relaxed); }
+
+private:
+    struct Cell
+    {
+        std::atomic<size_t> sequence;
+        Record record;
+    };
+
+    Cell mCells[kCapacity];
+    alignas(64) std::atomic<size_t> mEnqueuePos{ 0 };
+    alignas(64) size_t mDequeuePos = 0;
+    std::atomic<uint64_t> mDropped{ 0 };
+};
+
+} // namespace Platform
+} // namespace Logging
+} // namespace chip
@@ -0,0 +1,62 @@
+/*
+ *
+ *    Copyright (c) 2024 Project CHIP Authors
+ *
+ *    Licensed under the Apache License, Version 2.0 (the "License");
+ *    you may not use this file except in compliance with the License.
+ *    You may obtain a copy of the License at
+ *
+ *        http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *    Unless required by applicable law or agreed to in writing, software
+ *    distributed under the License is distributed on an "AS IS" BASIS,
+ *    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *    See the License for the specific language governing permissions and
+ *    limitations under the License.
+ */
+
+/**
+ *    @file
+ *          Opt-in asynchronous log output for the Linux platform.
+ *
+ *          By default every log line is written to stdout synchronously by the
+ *          thread that emits it. Once asynchronous logging is started, log lines
+ *          are formatted by the emitting thread into a single lock-free ring
+ *          buffer shared by all threads, and written out by a dedicated writer
+ *          thread. When the ring is full, new log lines are dropped and counted
+ *          rather than blocking the caller. The child of a fork() goes back to
+ *          synchronous output.
+ */
+
+#pragma once
+
+#include <lib/core/CHIPError.h>
+
+#include <cstdint>
+
+namespace chip {
+namespace Logging {
+namespace Platform {
+
+/**
+ * Start the log writer thread and route subsequent log lines through it.
+ * Calling this while asynchronous logging is already running is a no-op.
+ *
+ * Has no effect when logging goes through pw_log.
+ */
+CHIP_ERROR StartAsyncLogging();
+
+/**
+ * Flush all queued log lines, stop the writer thread and go back to
+ * synchronous output. Also registered with atexit() by StartAsyncLogging().
+ */
+void StopAsyncLogging();
+
+/**
+ * Number of log lines dropped because the ring buffer was full.
+ */
+uint64_t GetAsyncLoggingDroppedCount();
+
+} // namespace Platform
+} // namespace Logging
+} // namespace chip
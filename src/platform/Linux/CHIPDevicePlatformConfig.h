@@ -54,6 +54,18 @@
 // These are configuration options that are unique to Linux platforms.
 // These can be overridden by the application as needed.
 
+// Number of downloaded OTA image blocks that may wait for the image writer thread
+// before the download is paused until the writer catches up.
+#ifndef CHIP_DEVICE_CONFIG_OTA_WRITER_QUEUE_DEPTH
+#define CHIP_DEVICE_CONFIG_OTA_WRITER_QUEUE_DEPTH 16
+#endif // CHIP_DEVICE_CONFIG_OTA_WRITER_QUEUE_DEPTH
+
+// Number of OTA image bytes written between two fdatasync() calls. A download
+// resumed after an interruption can continue from the last synced offset.
+#ifndef CHIP_DEVICE_CONFIG_OTA_DURABLE_CHECKPOINT_BYTES
+#define CHIP_DEVICE_CONFIG_OTA_DURABLE_CHECKPOINT_BYTES (1024 * 1024)
+#endif // CHIP_DEVICE_CONFIG_OTA_DURABLE_CHECKPOINT_BYTES
+
 // ========== Platform-specific Configuration Overrides =========
 
 #ifndef CHIP_DEVICE_CONFIG_CHIP_TASK_STACK_SIZE
@@ -3,11 +3,22 @@
 #include <platform/logging/LogV.h>
 
 #include <lib/core/CHIPConfig.h>
+#include <lib/support/CHIPMemString.h>
+#include <lib/support/CodeUtils.h>
 #include <lib/support/logging/Constants.h>
+#include <lib/support/logging/TextOnlyLogging.h>
+#include <platform/Linux/AsyncLogRing.h>
+#include <platform/Linux/AsyncLogging.h>
 
+#include <atomic>
 #include <cinttypes>
 #include <cstdio>
+#include <cstdlib>
 #include <cstring>
+#include <mutex>
+#include <new>
+#include <pthread.h>
+#include <semaphore.h>
 #include <sys/syscall.h>
 #include <sys/time.h>
 #include <unistd.h>
@@ -32,6 +43,244 @@ void __attribute__((weak)) OnLogOutput() {}
 namespace Logging {
 namespace Platform {
 
+namespace {
+
+// The process and thread ids only change in the child of a fork(), so avoid a syscall for each log line and forget them in
+// the child (see OnForkChild()). 0 is not a valid id.
+std::atomic<long long> gPid{ 0 };
+thread_local long long tTid = 0;
+pthread_once_t gForkHandlersOnce = PTHREAD_ONCE_INIT;
+
+void RegisterForkHandlers();
+
+long long GetPid()
+{
+    long long pid = gPid.load(std::memory_order_relaxed);
+    if (pid == 0)
+    {
+        pthread_once(&gForkHandlersOnce, RegisterForkHandlers);
+        pid = static_cast<long long>(syscall(SYS_getpid));
+        gPid.store(pid, std::memory_order_relaxed);
+    }
+    return pid;
+}
+
+long long GetTid()
+{
+    if (tTid == 0)
+    {
+        pthread_once(&gForkHandlersOnce, RegisterForkHandlers);
+        tTid = static_cast<long long>(syscall(SYS_gettid));
+    }
+    return tTid;
+}
+
+#if !CHIP_USE_PW_LOGGING
+
+constexpr size_t kAsyncLogRingCapacity = 1024;
+using LogRing                           = AsyncLogRing<kAsyncLogRingCapacity>;
+
+// A single ring shared by all the logging threads. Allocated by the first StartAsyncLogging() call, so processes that never
+// enable asynchronous logging do not pay for the ring. Never freed, since a producer may still be writing to it after the
+// writer has stopped.
+LogRing * gAsyncLogRing = nullptr;
+std::atomic<bool> gAsyncLoggingEnabled{ false };
+std::atomic<bool> gAsyncLoggingStopRequested{ false };
+
+// Protects starting and stopping the writer thread.
+std::mutex gAsyncLoggingControlLock;
+bool gAsyncLoggingWriterRunning        = false;
+bool gAsyncLoggingSemaphoreInitialized = false;
+bool gAsyncLoggingAtExitRegistered     = false;
+pthread_t gAsyncLoggingWriter;
+// Posted once per committed record. Never destroyed, since a producer may still post after the writer has stopped.
+sem_t gAsyncLoggingRecordsAvailable;
+
+// Makes the ring single-consumer: held by the writer thread, and by producers that find asynchronous logging stopped.
+std::mutex gAsyncLogDrainLock;
+uint64_t gAsyncLogReportedDropped = 0;
+
+void PrintLogLine(const struct timeval & tv, long long tid, const char * module, const char * message)
+{
+    printf("[%" PRIu64 ".%06" PRIu64 "][%lld:%lld] CHIP:%s: %s\n", static_cast<uint64_t>(tv.tv_sec),
+           static_cast<uint64_t>(tv.tv_usec), GetPid(), tid, module, message);
+}
+
+void DrainAsyncLogRing()
+{
+    std::lock_guard<std::mutex> lock(gAsyncLogDrainLock);
+
+    flockfile(stdout);
+    while (LogRing::Record * record = gAsyncLogRing->Front())
+    {
+        PrintLogLine(record->timestamp, record->tid, record->module, record->message);
+        gAsyncLogRing->Pop();
+    }
+
+    uint64_t dropped = gAsyncLogRing->DroppedCount();
+    if (dropped != gAsyncLogReportedDropped)
+    {
+        printf("CHIP: %" PRIu64 " log lines dropped, log output could not keep up\n", dropped - gAsyncLogReportedDropped);
+        gAsyncLogReportedDropped = dropped;
+    }
+    fflush(stdout);
+    funlockfile(stdout);
+}
+
+void * AsyncLogWriterMain(void *)
+{
+    while (true)
+    {
+        if (sem_wait(&gAsyncLoggingRecordsAvailable) != 0)
+        {
+            continue; // EINTR
+        }
+
+        // One wakeup drains everything queued so far; later wakeups for already written records find the ring empty.
+        DrainAsyncLogRing();
+
+        if (gAsyncLoggingStopRequested.load(std::memory_order_acquire))
+        {
+            break;
+        }
+    }
+    return nullptr;
+}
+
+void EnqueueLogLine(const struct timeval & tv, const char * module, const char * msg, va_list v)
+{
+    size_t pos;
+    LogRing::Record * record = gAsyncLogRing->Reserve(pos);
+    VerifyOrReturn(record != nullptr);
+
+    record->timestamp = tv;
+    record->tid       = GetTid();
+    chip::Platform::CopyString(record->module, module);
+    vsnprintf(record->message, sizeof(record->message), msg, v);
+
+    gAsyncLogRing->Commit(pos);
+    sem_post(&gAsyncLoggingRecordsAvailable);
+
+    // Asynchronous logging may have been stopped since this line was reserved, in which case the ring may already have been
+    // drained for the last time. Pairs with the fence in StopAsyncLogging(): either its final drain sees this line, or this
+    // thread sees that asynchronous logging was stopped and writes the line out.
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    if (!gAsyncLoggingEnabled.load(std::memory_order_relaxed))
+    {
+        DrainAsyncLogRing();
+    }
+}
+
+#endif // !CHIP_USE_PW_LOGGING
+
+// Only the thread calling fork() exists in the child: take the asynchronous logging state to a consistent point first, so
+// the child can reset it.
+void OnForkPrepare()
+{
+#if !CHIP_USE_PW_LOGGING
+    gAsyncLoggingControlLock.lock();
+    gAsyncLogDrainLock.lock();
+#endif // !CHIP_USE_PW_LOGGING
+}
+
+void OnForkParent()
+{
+#if !CHIP_USE_PW_LOGGING
+    gAsyncLogDrainLock.unlock();
+    gAsyncLoggingControlLock.unlock();
+#endif // !CHIP_USE_PW_LOGGING
+}
+
+void OnForkChild()
+{
+    gPid.store(0, std::memory_order_relaxed);
+    tTid = 0;
+
+#if !CHIP_USE_PW_LOGGING
+    // The writer thread does not exist in the child, and the copy of the ring holds lines of the parent (possibly half
+    // written by other threads), so go back to synchronous output. A later StartAsyncLogging() allocates a new ring.
+    gAsyncLoggingEnabled.store(false, std::memory_order_relaxed);
+    gAsyncLoggingWriterRunning = false;
+    gAsyncLogRing              = nullptr;
+    gAsyncLogReportedDropped   = 0;
+    gAsyncLogDrainLock.unlock();
+    gAsyncLoggingControlLock.unlock();
+#endif // !CHIP_USE_PW_LOGGING
+}
+
+void RegisterForkHandlers()
+{
+    pthread_atfork(OnForkPrepare, OnForkParent, OnForkChild);
+}
+
+} // namespace
+
+CHIP_ERROR StartAsyncLogging()
+{
+#if !CHIP_USE_PW_LOGGING
+    std::lock_guard<std::mutex> lock(gAsyncLoggingControlLock);
+    VerifyOrReturnError(!gAsyncLoggingWriterRunning, CHIP_NO_ERROR);
+
+    if (gAsyncLogRing == nullptr)
+    {
+        gAsyncLogRing = new (std::nothrow) LogRing();
+        VerifyOrReturnError(gAsyncLogRing != nullptr, CHIP_ERROR_NO_MEMORY);
+    }
+
+    if (!gAsyncLoggingSemaphoreInitialized)
+    {
+        VerifyOrReturnError(sem_init(&gAsyncLoggingRecordsAvailable, 0, 0) == 0, CHIP_ERROR_INTERNAL);
+        gAsyncLoggingSemaphoreInitialized = true;
+    }
+
+    gAsyncLoggingStopRequested.store(false, std::memory_order_relaxed);
+    VerifyOrReturnError(pthread_create(&gAsyncLoggingWriter, nullptr, AsyncLogWriterMain, nullptr) == 0, CHIP_ERROR_NO_MEMORY);
+    pthread_setname_np(gAsyncLoggingWriter, "CHIP log writer");
+    gAsyncLoggingWriterRunning = true;
+
+    if (!gAsyncLoggingAtExitRegistered)
+    {
+        atexit(StopAsyncLogging);
+        gAsyncLoggingAtExitRegistered = true;
+    }
+
+    // Also writes out any lines queued while asynchronous logging was being stopped.
+    sem_post(&gAsyncLoggingRecordsAvailable);
+    gAsyncLoggingEnabled.store(true, std::memory_order_release);
+    return CHIP_NO_ERROR;
+#else
+    return CHIP_ERROR_NOT_IMPLEMENTED;
+#endif // !CHIP_USE_PW_LOGGING
+}
+
+void StopAsyncLogging()
+{
+#if !CHIP_USE_PW_LOGGING
+    std::lock_guard<std::mutex> lock(gAsyncLoggingControlLock);
+    VerifyOrReturn(gAsyncLoggingWriterRunning);
+
+    gAsyncLoggingEnabled.store(false, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    gAsyncLoggingStopRequested.store(true, std::memory_order_release);
+    sem_post(&gAsyncLoggingRecordsAvailable);
+    pthread_join(gAsyncLoggingWriter, nullptr);
+    gAsyncLoggingWriterRunning = false;
+
+    // Lines committed after the last drain of the writer are either written out here, or by the threads that logged them.
+    DrainAsyncLogRing();
+#endif // !CHIP_USE_PW_LOGGING
+}
+
+uint64_t GetAsyncLoggingDroppedCount()
+{
+#if !CHIP_USE_PW_LOGGING
+    std::lock_guard<std::mutex> lock(gAsyncLoggingControlLock);
+    return (gAsyncLogRing != nullptr) ? gAsyncLogRing->DroppedCount() : 0;
+#else
+    return 0;
+#endif // !CHIP_USE_PW_LOGGING
+}
+
 /**
  * CHIP log output functions.
  */
@@ -44,23 +293,28 @@ void LogV(const char * module, uint8_t category, const char * msg, va_list v)
     gettimeofday(&tv, nullptr);
 
 #if !CHIP_USE_PW_LOGGING
-    // Lock standard output, so a single log line will not be corrupted in case
-    // where multiple threads are using logging subsystem at the same time.
-    flockfile(stdout);
+    if (gAsyncLoggingEnabled.load(std::memory_order_acquire))
+    {
+        EnqueueLogLine(tv, module, msg, v);
+    }
+    else
+    {
+        // Lock standard output, so a single log line will not be corrupted in case
+        // where multiple threads are using logging subsystem at the same time.
+        flockfile(stdout);
 
-    printf("[%" PRIu64 ".%06" PRIu64 "][%lld:%lld] CHIP:%s: ", static_cast<uint64_t>(tv.tv_sec), static_cast<uint64_t>(tv.tv_usec),
-           static_cast<long long>(syscall(SYS_getpid)), static_cast<long long>(syscall(SYS_gettid)), module);
-    vprintf(msg, v);
-    printf("\n");
-    fflush(stdout);
+        printf("[%" PRIu64 ".%06" PRIu64 "][%lld:%lld] CHIP:%s: ", static_cast<uint64_t>(tv.tv_sec),
+               static_cast<uint64_t>(tv.tv_usec), GetPid(), GetTid(), module);
+        vprintf(msg, v);
+        printf("\n");
+        fflush(stdout);
 
-    funlockfile(stdout);
+        funlockfile(stdout);
+    }
 #else  // !CHIP_USE_PW_LOGGING
     char formattedMsg[CHIP_CONFIG_LOG_MESSAGE_MAX_SIZE];
-    snprintf(formattedMsg, sizeof(formattedMsg),
-             "[%" PRIu64 ".%06" PRIu64 "][%lld:%lld] CHIP:%s: ", static_cast<uint64_t>(tv.tv_sec),
-             static_cast<uint64_t>(tv.tv_usec), static_cast<long long>(syscall(SYS_getpid)),
-             static_cast<long long>(syscall(SYS_gettid)), module);
+    snprintf(formattedMsg, sizeof(formattedMsg), "[%" PRIu64 ".%06" PRIu64 "][%lld:%lld] CHIP:%s: ",
+             static_cast<uint64_t>(tv.tv_sec), static_cast<uint64_t>(tv.tv_usec), GetPid(), GetTid(), module);
     size_t len = strnlen(formattedMsg, sizeof(formattedMsg));
     vsnprintf(formattedMsg + len, sizeof(formattedMsg) - len, msg, v);
 
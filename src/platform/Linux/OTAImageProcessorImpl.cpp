@@ -21,10 +21,35 @@
 
 #include "OTAImageProcessorImpl.h"
 
+#include <cinttypes>
+#include <errno.h>
+#include <fcntl.h>
+#include <string.h>
 #include <sys/stat.h>
+#include <unistd.h>
 
 namespace chip {
 
+namespace {
+
+void CancelImageUpdate()
+{
+    // The BDX transfer has already completed, so the update has to be cancelled rather than the download ended.
+    OTARequestorInterface * requestor = chip::GetRequestorInstance();
+    if (requestor != nullptr)
+    {
+        requestor->CancelImageUpdate();
+    }
+}
+
+} // namespace
+
+OTAImageProcessorImpl::~OTAImageProcessorImpl()
+{
+    StopWriter();
+    CloseImageFile();
+}
+
 CHIP_ERROR OTAImageProcessorImpl::PrepareDownload()
 {
     if (mImageFile == nullptr)
@@ -45,6 +70,29 @@ CHIP_ERROR OTAImageProcessorImpl::Finalize()
 
 CHIP_ERROR OTAImageProcessorImpl::Apply()
 {
+    // Only an image that was completely written and verified may replace the running one.
+    if (mWriter.joinable())
+    {
+        bool finishing;
+        {
+            std::lock_guard<std::mutex> lock(mWriterLock);
+            finishing = mFinishWriter;
+        }
+
+        // Verification may still be running on the writer thread, but only once the download has been finalized.
+        VerifyOrReturnError(finishing, CHIP_ERROR_INCORRECT_STATE);
+
+        // Rather than waiting for the writer thread here, HandleFinalizeComplete applies the image once it is verified.
+        mApplyPending = true;
+        return CHIP_NO_ERROR;
+    }
+
+    if (!mImageVerified)
+    {
+        ChipLogError(SoftwareUpdate, "No verified OTA image to apply");
+        return CHIP_ERROR_INCORRECT_STATE;
+    }
+
     DeviceLayer::PlatformMgr().ScheduleWork(HandleApply, reinterpret_cast<intptr_t>(this));
     return CHIP_NO_ERROR;
 }
@@ -63,16 +111,25 @@ CHIP_ERROR OTAImageProcessorImpl::Abort()
 
 CHIP_ERROR OTAImageProcessorImpl::ProcessBlock(ByteSpan & block)
 {
-    if (!mOfs.is_open() || !mOfs.good())
+    if (mFd < 0)
     {
         return CHIP_ERROR_INTERNAL;
     }
 
-    // Store block data for HandleProcessBlock to access
-    CHIP_ERROR err = SetBlock(block);
-    if (err != CHIP_NO_ERROR)
+    // Store block data for HandleProcessBlock to access. The buffer is handed over to the writer thread from there.
+    mBlock.payloadOffset = 0;
+    if (!block.empty())
     {
-        ChipLogError(SoftwareUpdate, "Cannot set block data: %" CHIP_ERROR_FORMAT, err.Format());
+        if (mBlock.data.Alloc(block.size()).Get() == nullptr)
+        {
+            ChipLogError(SoftwareUpdate, "Cannot set block data: %" CHIP_ERROR_FORMAT, CHIP_ERROR_NO_MEMORY.Format());
+            return CHIP_ERROR_NO_MEMORY;
+        }
+        memcpy(mBlock.data.Get(), block.data(), block.size());
+    }
+    else
+    {
+        mBlock.data.Free();
     }
 
     DeviceLayer::PlatformMgr().ScheduleWork(HandleProcessBlock, reinterpret_cast<intptr_t>(this));
@@ -125,18 +182,25 @@ void OTAImageProcessorImpl::HandlePrepareDownload(intptr_t context)
         return;
     }
 
+    // A previous download may still be in progress if it was not aborted
+    imageProcessor->StopWriter();
+    imageProcessor->CloseImageFile();
     unlink(imageProcessor->mImageFile);
 
     imageProcessor->mParams.downloadedBytes = 0;
     imageProcessor->mParams.totalFileBytes  = 0;
+    imageProcessor->mExpectedDigestLength   = 0;
+    imageProcessor->mImageVerified          = false;
     imageProcessor->mHeaderParser.Init();
-    imageProcessor->mOfs.open(imageProcessor->mImageFile, std::ofstream::out | std::ofstream::ate | std::ofstream::app);
-    if (!imageProcessor->mOfs.good())
+    imageProcessor->mFd = open(imageProcessor->mImageFile, O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, S_IRUSR | S_IWUSR);
+    if (imageProcessor->mFd < 0)
     {
+        ChipLogError(SoftwareUpdate, "Cannot open %s: %s", imageProcessor->mImageFile, strerror(errno));
         imageProcessor->mDownloader->OnPreparedForDownload(CHIP_ERROR_OPEN_FAILED);
         return;
     }
 
+    imageProcessor->StartWriter();
     imageProcessor->mDownloader->OnPreparedForDownload(CHIP_NO_ERROR);
 }
 
@@ -148,10 +212,65 @@ void OTAImageProcessorImpl::HandleFinalize(intptr_t context)
         return;
     }
 
-    imageProcessor->mOfs.close();
-    imageProcessor->ReleaseBlock();
+    imageProcessor->mBlock.data.Free();
+
+    // The writer thread writes out the queued blocks, verifies the image and then reports back through
+    // HandleFinalizeComplete, so the Matter thread does not wait for the disk.
+    bool writerFailed;
+    {
+        std::lock_guard<std::mutex> lock(imageProcessor->mWriterLock);
+        imageProcessor->mFinishWriter = true;
+        writerFailed                  = (imageProcessor->mWriterResult != CHIP_NO_ERROR);
+    }
+
+    if (!imageProcessor->mWriter.joinable())
+    {
+        if (imageProcessor->mImageVerified)
+        {
+            ChipLogProgress(SoftwareUpdate, "OTA image already finalized");
+            return;
+        }
+
+        // Never prepared, aborted or already failed: there is no image to hand over.
+        ChipLogError(SoftwareUpdate, "No OTA image download to finalize");
+        imageProcessor->ReportFailure(CHIP_ERROR_INCORRECT_STATE);
+        return;
+    }
+
+    if (writerFailed)
+    {
+        // The writer thread has already stopped
+        HandleFinalizeComplete(context);
+        return;
+    }
+    imageProcessor->mWriterWakeup.notify_one();
+}
+
+void OTAImageProcessorImpl::HandleFinalizeComplete(intptr_t context)
+{
+    auto * imageProcessor = reinterpret_cast<OTAImageProcessorImpl *>(context);
+    VerifyOrReturn(imageProcessor != nullptr);
+
+    // Already completed, e.g. after a write failure reported by HandleFinalize
+    VerifyOrReturn(imageProcessor->mWriter.joinable());
+
+    const bool applyPending       = imageProcessor->mApplyPending;
+    imageProcessor->mApplyPending = false;
+
+    CHIP_ERROR err = imageProcessor->CompleteFinalize();
+    if (err != CHIP_NO_ERROR)
+    {
+        ChipLogError(SoftwareUpdate, "OTA image verification failed: %" CHIP_ERROR_FORMAT, err.Format());
+        unlink(imageProcessor->mImageFile);
+        imageProcessor->ReportFailure(err);
+        return;
+    }
 
     ChipLogProgress(SoftwareUpdate, "OTA image downloaded to %s", imageProcessor->mImageFile);
+    if (applyPending)
+    {
+        HandleApply(context);
+    }
 }
 
 void OTAImageProcessorImpl::HandleApply(intptr_t context)
@@ -162,10 +281,31 @@ void OTAImageProcessorImpl::HandleApply(intptr_t context)
     OTARequestorInterface * requestor = chip::GetRequestorInstance();
     VerifyOrReturn(requestor != nullptr);
 
-    // Move the downloaded image to the location where the new image is to be executed from
-    unlink(kImageExecPath);
-    rename(imageProcessor->mImageFile, kImageExecPath);
-    chmod(kImageExecPath, S_IRUSR | S_IWUSR | S_IXUSR | S_IRGRP | S_IXGRP | S_IROTH | S_IXOTH);
+    // A new download may have started since Apply() checked the image.
+    if (!imageProcessor->mImageVerified)
+    {
+        ChipLogError(SoftwareUpdate, "No verified OTA image to apply");
+        requestor->CancelImageUpdate();
+        return;
+    }
+
+    // Move the downloaded image to the location where the new image is to be executed from. rename() replaces any
+    // previous image atomically.
+    if (rename(imageProcessor->mImageFile, kImageExecPath) != 0)
+    {
+        ChipLogError(SoftwareUpdate, "Cannot move the OTA image to %s: %s", kImageExecPath, strerror(errno));
+        requestor->CancelImageUpdate();
+        return;
+    }
+    imageProcessor->mImageVerified = false;
+
+    if (chmod(kImageExecPath, S_IRUSR | S_IWUSR | S_IXUSR | S_IRGRP | S_IXGRP | S_IROTH | S_IXOTH) != 0)
+    {
+        ChipLogError(SoftwareUpdate, "Cannot make %s executable: %s", kImageExecPath, strerror(errno));
+        unlink(kImageExecPath);
+        requestor->CancelImageUpdate();
+        return;
+    }
 
     // Shutdown the stack and expect to boot into the new image once the event loop is stopped
     DeviceLayer::PlatformMgr().ScheduleWork([](intptr_t) { DeviceLayer::PlatformMgr().HandleServerShuttingDown(); });
@@ -180,9 +320,12 @@ void OTAImageProcessorImpl::HandleAbort(intptr_t context)
         return;
     }
 
-    imageProcessor->mOfs.close();
+    imageProcessor->StopWriter();
+    imageProcessor->CloseImageFile();
     unlink(imageProcessor->mImageFile);
-    imageProcessor->ReleaseBlock();
+    imageProcessor->mBlock.data.Free();
+    imageProcessor->mImageVerified = false;
+    imageProcessor->mApplyPending  = false;
 }
 
 void OTAImageProcessorImpl::HandleProcessBlock(intptr_t context)
@@ -199,8 +342,14 @@ void OTAImageProcessorImpl::HandleProcessBlock(intptr_t context)
         return;
     }
 
-    ByteSpan block   = imageProcessor->mBlock;
+    PendingBlock & pending = imageProcessor->mBlock;
+    ByteSpan block(pending.data.Get(), pending.data.AllocatedSize());
     CHIP_ERROR error = imageProcessor->ProcessHeader(block);
+    if (error == CHIP_ERROR_PERSISTED_STORAGE_FAILED)
+    {
+        imageProcessor->mDownloader->EndDownload(CHIP_ERROR_WRITE_FAILED);
+        return;
+    }
     if (error != CHIP_NO_ERROR)
     {
         ChipLogError(SoftwareUpdate, "Image does not contain a valid header");
@@ -208,16 +357,85 @@ void OTAImageProcessorImpl::HandleProcessBlock(intptr_t context)
         return;
     }
 
-    if (!imageProcessor->mOfs.write(reinterpret_cast<const char *>(block.data()), static_cast<std::streamsize>(block.size())))
+    if (block.empty())
+    {
+        pending.data.Free();
+        imageProcessor->mDownloader->FetchNextData();
+        return;
+    }
+
+    pending.payloadOffset = static_cast<size_t>(block.data() - pending.data.Get());
+
+    // Queue the payload for the writer thread and fetch the next block right away, unless the writer is too far behind.
+    // In that case the next block is fetched once the writer catches up.
+    bool fetchNow = false;
+    {
+        std::lock_guard<std::mutex> lock(imageProcessor->mWriterLock);
+        if (imageProcessor->mWriterResult != CHIP_NO_ERROR)
+        {
+            error = imageProcessor->mWriterResult;
+        }
+        else
+        {
+            imageProcessor->mWriteQueue.push_back(std::move(pending));
+            fetchNow                       = imageProcessor->mWriteQueue.size() < CHIP_DEVICE_CONFIG_OTA_WRITER_QUEUE_DEPTH;
+            imageProcessor->mFetchDeferred = !fetchNow;
+        }
+    }
+
+    if (error != CHIP_NO_ERROR)
     {
         imageProcessor->mDownloader->EndDownload(CHIP_ERROR_WRITE_FAILED);
         return;
     }
 
+    imageProcessor->mWriterWakeup.notify_one();
     imageProcessor->mParams.downloadedBytes += block.size();
+    if (fetchNow)
+    {
+        imageProcessor->mDownloader->FetchNextData();
+    }
+}
+
+void OTAImageProcessorImpl::HandleFetchNextData(intptr_t context)
+{
+    auto * imageProcessor = reinterpret_cast<OTAImageProcessorImpl *>(context);
+    VerifyOrReturn(imageProcessor != nullptr && imageProcessor->mDownloader != nullptr);
+
     imageProcessor->mDownloader->FetchNextData();
 }
 
+void OTAImageProcessorImpl::HandleWriteFailure(intptr_t context)
+{
+    auto * imageProcessor = reinterpret_cast<OTAImageProcessorImpl *>(context);
+    VerifyOrReturn(imageProcessor != nullptr);
+
+    imageProcessor->ReportFailure(CHIP_ERROR_WRITE_FAILED);
+}
+
+void OTAImageProcessorImpl::ReportFailure(CHIP_ERROR error)
+{
+    // A write failure may be reported by both HandleWriteFailure and HandleFinalizeComplete, depending on when
+    // Finalize() is called, but the download or the update is only ended once.
+    VerifyOrReturn(!mFailureReported);
+    mFailureReported = true;
+
+    bool finishing;
+    {
+        std::lock_guard<std::mutex> lock(mWriterLock);
+        finishing = mFinishWriter;
+    }
+
+    if (finishing || mDownloader == nullptr)
+    {
+        CancelImageUpdate();
+    }
+    else
+    {
+        mDownloader->EndDownload(error);
+    }
+}
+
 CHIP_ERROR OTAImageProcessorImpl::ProcessHeader(ByteSpan & block)
 {
     if (mHeaderParser.IsInitialized())
@@ -230,50 +448,230 @@ CHIP_ERROR OTAImageProcessorImpl::ProcessHeader(ByteSpan & block)
         ReturnErrorOnFailure(error);
 
         mParams.totalFileBytes = header.mPayloadSize;
+
+        // Only the SHA-256 based digests are supported by the crypto layer; the others are left unchecked.
+        switch (header.mImageDigestType)
+        {
+        case OTAImageDigestType::kSha256:
+        case OTAImageDigestType::kSha256_128:
+        case OTAImageDigestType::kSha256_120:
+        case OTAImageDigestType::kSha256_96:
+        case OTAImageDigestType::kSha256_64:
+        case OTAImageDigestType::kSha256_32:
+            VerifyOrReturnError(!header.mImageDigest.empty() && header.mImageDigest.size() <= sizeof(mExpectedDigest),
+                                CHIP_ERROR_INVALID_ARGUMENT);
+            memcpy(mExpectedDigest, header.mImageDigest.data(), header.mImageDigest.size());
+            mExpectedDigestLength = header.mImageDigest.size();
+            ReturnErrorOnFailure(mHash.Begin());
+            break;
+        default:
+            ChipLogProgress(SoftwareUpdate, "Image digest type %u is not verified", static_cast<unsigned>(header.mImageDigestType));
+            break;
+        }
+
+        // Reserve the space for the whole payload up front, so running out of space is detected before the download
+        // and the file does not need to be extended on every write.
+        int result = (header.mPayloadSize > 0) ? posix_fallocate(mFd, 0, static_cast<off_t>(header.mPayloadSize)) : 0;
+        if (result == ENOSPC || result == EDQUOT)
+        {
+            ChipLogError(SoftwareUpdate, "Not enough space for a %" PRIu64 " bytes image", header.mPayloadSize);
+            return CHIP_ERROR_PERSISTED_STORAGE_FAILED;
+        }
+        if (result != 0)
+        {
+            ChipLogProgress(SoftwareUpdate, "Cannot preallocate the image file: %s", strerror(result));
+        }
+
         mHeaderParser.Clear();
     }
 
     return CHIP_NO_ERROR;
 }
 
-CHIP_ERROR OTAImageProcessorImpl::SetBlock(ByteSpan & block)
+void OTAImageProcessorImpl::StartWriter()
+{
+    mImageVerified   = false;
+    mApplyPending    = false;
+    mFailureReported = false;
+    mWriteQueue.clear();
+    mStopWriter     = false;
+    mFinishWriter   = false;
+    mFetchDeferred  = false;
+    mWriterResult   = CHIP_NO_ERROR;
+    mWriteOffset    = 0;
+    mBytesSinceSync = 0;
+    mDurableBytes.store(0, std::memory_order_release);
+    mWriter = std::thread(&OTAImageProcessorImpl::WriterMain, this);
+}
+
+void OTAImageProcessorImpl::StopWriter()
 {
-    if (block.empty())
     {
-        ReleaseBlock();
-        return CHIP_NO_ERROR;
+        std::lock_guard<std::mutex> lock(mWriterLock);
+        mStopWriter = true;
     }
-    if (mBlock.size() < block.size())
+    mWriterWakeup.notify_one();
+
+    if (mWriter.joinable())
     {
-        if (!mBlock.empty())
+        mWriter.join();
+    }
+    mWriteQueue.clear();
+}
+
+void OTAImageProcessorImpl::WriterMain()
+{
+    while (true)
+    {
+        PendingBlock block;
+        bool fetchNextData = false;
         {
-            ReleaseBlock();
+            std::unique_lock<std::mutex> lock(mWriterLock);
+            mWriterWakeup.wait(lock, [this] { return mStopWriter || mFinishWriter || !mWriteQueue.empty(); });
+            if (mStopWriter)
+            {
+                return;
+            }
+            if (mWriteQueue.empty())
+            {
+                // Finishing and everything has been written
+                break;
+            }
+
+            block = std::move(mWriteQueue.front());
+            mWriteQueue.pop_front();
+            fetchNextData  = mFetchDeferred;
+            mFetchDeferred = false;
         }
-        uint8_t * mBlock_ptr = static_cast<uint8_t *>(chip::Platform::MemoryAlloc(block.size()));
-        if (mBlock_ptr == nullptr)
+
+        if (fetchNextData)
         {
-            return CHIP_ERROR_NO_MEMORY;
+            DeviceLayer::PlatformMgr().ScheduleWork(HandleFetchNextData, reinterpret_cast<intptr_t>(this));
+        }
+
+        CHIP_ERROR err = WriteBlock(block);
+        if (err != CHIP_NO_ERROR)
+        {
+            ChipLogError(SoftwareUpdate, "Cannot write the OTA image: %" CHIP_ERROR_FORMAT, err.Format());
+
+            bool finishing;
+            {
+                std::lock_guard<std::mutex> lock(mWriterLock);
+                mWriterResult = err;
+                mWriteQueue.clear();
+                finishing = mFinishWriter;
+            }
+
+            // Once finishing, the failure is reported by HandleFinalizeComplete instead.
+            if (finishing)
+            {
+                break;
+            }
+            DeviceLayer::PlatformMgr().ScheduleWork(HandleWriteFailure, reinterpret_cast<intptr_t>(this));
+            return;
         }
-        mBlock = MutableByteSpan(mBlock_ptr, block.size());
     }
-    CHIP_ERROR err = CopySpanToMutableSpan(block, mBlock);
-    if (err != CHIP_NO_ERROR)
+
+    // Only reached when finishing: make the whole image durable and check it before reporting completion.
+    std::unique_lock<std::mutex> lock(mWriterLock);
+    if (mStopWriter)
+    {
+        // Aborted while finishing: the image is discarded, so do not make the Matter thread wait for it to be synced.
+        return;
+    }
+    if (mWriterResult == CHIP_NO_ERROR)
+    {
+        lock.unlock();
+        CHIP_ERROR err = Checkpoint();
+        if (err == CHIP_NO_ERROR)
+        {
+            err = VerifyImage();
+        }
+        lock.lock();
+        mWriterResult = err;
+    }
+    lock.unlock();
+
+    DeviceLayer::PlatformMgr().ScheduleWork(HandleFinalizeComplete, reinterpret_cast<intptr_t>(this));
+}
+
+CHIP_ERROR OTAImageProcessorImpl::CompleteFinalize()
+{
+    // The writer thread has already exited or is about to
+    mWriter.join();
+    CloseImageFile();
+
+    mImageVerified = (mWriterResult == CHIP_NO_ERROR);
+    return mWriterResult;
+}
+
+CHIP_ERROR OTAImageProcessorImpl::WriteBlock(const PendingBlock & block)
+{
+    const uint8_t * data = block.data.Get() + block.payloadOffset;
+    size_t size          = block.data.AllocatedSize() - block.payloadOffset;
+
+    if (mExpectedDigestLength > 0)
     {
-        ChipLogError(SoftwareUpdate, "Cannot copy block data: %" CHIP_ERROR_FORMAT, err.Format());
-        return err;
+        ReturnErrorOnFailure(mHash.AddData(ByteSpan(data, size)));
     }
+
+    while (size > 0)
+    {
+        ssize_t written = pwrite(mFd, data, size, static_cast<off_t>(mWriteOffset));
+        if (written < 0)
+        {
+            VerifyOrReturnError(errno == EINTR, CHIP_ERROR_WRITE_FAILED);
+            continue;
+        }
+
+        data += written;
+        size -= static_cast<size_t>(written);
+        mWriteOffset += static_cast<uint64_t>(written);
+        mBytesSinceSync += static_cast<uint64_t>(written);
+    }
+
+    if (mBytesSinceSync >= CHIP_DEVICE_CONFIG_OTA_DURABLE_CHECKPOINT_BYTES)
+    {
+        ReturnErrorOnFailure(Checkpoint());
+    }
+
     return CHIP_NO_ERROR;
 }
 
-CHIP_ERROR OTAImageProcessorImpl::ReleaseBlock()
+CHIP_ERROR OTAImageProcessorImpl::Checkpoint()
 {
-    if (mBlock.data() != nullptr)
+    VerifyOrReturnError(fdatasync(mFd) == 0, CHIP_ERROR_WRITE_FAILED);
+
+    mBytesSinceSync = 0;
+    mDurableBytes.store(mWriteOffset, std::memory_order_release);
+    return CHIP_NO_ERROR;
+}
+
+CHIP_ERROR OTAImageProcessorImpl::VerifyImage()
+{
+    if (mWriteOffset != mParams.totalFileBytes)
     {
-        chip::Platform::MemoryFree(mBlock.data());
+        ChipLogError(SoftwareUpdate, "Image payload is %" PRIu64 " bytes, expected %" PRIu64, mWriteOffset, mParams.totalFileBytes);
+        return CHIP_ERROR_INTEGRITY_CHECK_FAILED;
     }
 
-    mBlock = MutableByteSpan();
+    VerifyOrReturnError(mExpectedDigestLength > 0, CHIP_NO_ERROR);
+
+    uint8_t digestBuffer[Crypto::kSHA256_Hash_Length];
+    MutableByteSpan digest(digestBuffer);
+    ReturnErrorOnFailure(mHash.Finish(digest));
+    VerifyOrReturnError(memcmp(digest.data(), mExpectedDigest, mExpectedDigestLength) == 0, CHIP_ERROR_INTEGRITY_CHECK_FAILED);
+
     return CHIP_NO_ERROR;
 }
 
+void OTAImageProcessorImpl::CloseImageFile()
+{
+    if (mFd >= 0)
+    {
+        close(mFd);
+        mFd = -1;
+    }
+}
+
 } // namespace chip
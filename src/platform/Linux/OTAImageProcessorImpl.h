@@ -19,20 +19,37 @@
 #pragma once
 
 #include <app/clusters/ota-requestor/OTADownloader.h>
+#include <crypto/CHIPCryptoPAL.h>
 #include <lib/core/OTAImageHeader.h>
+#include <lib/support/ScopedBuffer.h>
 #include <platform/CHIPDeviceLayer.h>
 #include <platform/OTAImageProcessor.h>
 
-#include <fstream>
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <thread>
 
 namespace chip {
 
 // Full file path to where the new image will be executed from post-download
 static char kImageExecPath[] = "/tmp/ota.update";
 
+/**
+ * Downloads an OTA image payload into a file.
+ *
+ * Blocks are handed from the Matter thread to a writer thread, which hashes them and writes them into a file preallocated
+ * to the payload size. The data is flushed to storage with fdatasync() every CHIP_DEVICE_CONFIG_OTA_DURABLE_CHECKPOINT_BYTES
+ * bytes, so the download, hashing and disk I/O overlap. When the payload is complete, its digest is checked against the
+ * one in the image header before the image is considered downloaded. Apply() refuses any image that has not been finalized
+ * and verified this way.
+ */
 class OTAImageProcessorImpl : public OTAImageProcessorInterface
 {
 public:
+    ~OTAImageProcessorImpl() override;
+
     //////////// OTAImageProcessorInterface Implementation ///////////////
     CHIP_ERROR PrepareDownload() override;
     CHIP_ERROR Finalize() override;
@@ -45,31 +62,90 @@ public:
     void SetOTADownloader(OTADownloader * downloader) { mDownloader = downloader; }
     void SetOTAImageFile(const char * imageFile) { mImageFile = imageFile; }
 
+    /**
+     * Number of payload bytes known to be on persistent storage. A transfer resumed after an interruption may continue
+     * from this offset.
+     */
+    uint64_t GetDurableBytes() const { return mDurableBytes.load(std::memory_order_acquire); }
+
 private:
+    struct PendingBlock
+    {
+        Platform::ScopedMemoryBufferWithSize<uint8_t> data;
+        size_t payloadOffset = 0; // Offset of the first byte following the image header
+    };
+
     //////////// Actual handlers for the OTAImageProcessorInterface ///////////////
     static void HandlePrepareDownload(intptr_t context);
     static void HandleFinalize(intptr_t context);
     static void HandleApply(intptr_t context);
     static void HandleAbort(intptr_t context);
     static void HandleProcessBlock(intptr_t context);
+    static void HandleFetchNextData(intptr_t context);
+    static void HandleWriteFailure(intptr_t context);
+    static void HandleFinalizeComplete(intptr_t context);
 
     CHIP_ERROR ProcessHeader(ByteSpan & block);
 
     /**
-     * Called to allocate memory for mBlock if necessary and set it to block
+     * End the download, or cancel the update once the download has been finalized. Only the first failure of a
+     * download is reported.
+     */
+    void ReportFailure(CHIP_ERROR error);
+
+    //////////// Writer thread ///////////////
+    void StartWriter();
+
+    /**
+     * Stop the writer thread, dropping any blocks that have not been written yet.
      */
-    CHIP_ERROR SetBlock(ByteSpan & block);
+    void StopWriter();
+
+    void WriterMain();
 
     /**
-     * Called to release allocated memory for mBlock
+     * Join the writer thread once it has finished writing and verifying the image, and record the outcome.
      */
-    CHIP_ERROR ReleaseBlock();
+    CHIP_ERROR CompleteFinalize();
+    CHIP_ERROR WriteBlock(const PendingBlock & block);
+    CHIP_ERROR Checkpoint();
+    CHIP_ERROR VerifyImage();
+    void CloseImageFile();
 
-    std::ofstream mOfs;
-    MutableByteSpan mBlock;
+    int mFd = -1;
+    PendingBlock mBlock;
     OTADownloader * mDownloader;
     OTAImageHeaderParser mHeaderParser;
     const char * mImageFile = nullptr;
+
+    // Digest of the payload, only checked for the SHA-256 based digest types.
+    Crypto::Hash_SHA256_stream mHash;
+    uint8_t mExpectedDigest[Crypto::kSHA256_Hash_Length];
+    size_t mExpectedDigestLength = 0;
+
+    // Set once the writer thread has written and verified the whole image, which is required by Apply().
+    bool mImageVerified = false;
+
+    // Set when Apply() is called while the writer thread is still verifying the image.
+    bool mApplyPending = false;
+
+    // Set once a failure of the current download has been reported.
+    bool mFailureReported = false;
+
+    // Shared with the writer thread.
+    std::mutex mWriterLock;
+    std::condition_variable mWriterWakeup;
+    std::deque<PendingBlock> mWriteQueue;
+    bool mStopWriter         = false;
+    bool mFinishWriter       = false;
+    bool mFetchDeferred      = false;
+    CHIP_ERROR mWriterResult = CHIP_NO_ERROR;
+    std::thread mWriter;
+
+    // Only accessed by the writer thread while it runs.
+    uint64_t mWriteOffset    = 0;
+    uint64_t mBytesSinceSync = 0;
+    std::atomic<uint64_t> mDurableBytes{ 0 };
 };
 
 } // namespace chip
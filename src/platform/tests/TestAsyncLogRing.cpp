@@ -0,0 +1,173 @@
+/*
+ *
+ *    Copyright (c) 2024 Project CHIP Authors
+ *
+ *    Licensed under the Apache License, Version 2.0 (the "License");
+ *    you may not use this file except in compliance with the License.
+ *    You may obtain a copy of the License at
+ *
+ *        http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *    Unless required by applicable law or agreed to in writing, software
+ *    distributed under the License is distributed on an "AS IS" BASIS,
+ *    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *    See the License for the specific language governing permissions and
+ *    limitations under the License.
+ */
+
+#include <pw_unit_test/framework.h>
+
+#include <lib/support/CHIPMemString.h>
+#include <platform/Linux/AsyncLogRing.h>
+
+#include <cstdio>
+#include <cstdlib>
+#include <memory>
+#include <thread>
+#include <vector>
+
+using namespace chip::Logging::Platform;
+
+namespace {
+
+template <size_t kCapacity>
+bool EnqueueLine(AsyncLogRing<kCapacity> & ring, long long tid, unsigned value)
+{
+    size_t pos;
+    auto * record = ring.Reserve(pos);
+    if (record == nullptr)
+    {
+        return false;
+    }
+    record->tid = tid;
+    chip::Platform::CopyString(record->module, "TST");
+    snprintf(record->message, sizeof(record->message), "%u", value);
+    ring.Commit(pos);
+    return true;
+}
+
+template <size_t kCapacity>
+bool DequeueLine(AsyncLogRing<kCapacity> & ring, long long & tid, unsigned & value)
+{
+    auto * record = ring.Front();
+    if (record == nullptr)
+    {
+        return false;
+    }
+    tid   = record->tid;
+    value = static_cast<unsigned>(strtoul(record->message, nullptr, 10));
+    ring.Pop();
+    return true;
+}
+
+TEST(TestAsyncLogRing, TestOrderingAcrossWrapAround)
+{
+    auto ring = std::make_unique<AsyncLogRing<4>>();
+    long long tid;
+    unsigned value;
+    unsigned next = 0;
+
+    EXPECT_FALSE(DequeueLine(*ring, tid, value));
+
+    // Interleave producing and consuming so the positions wrap around the ring several times.
+    for (unsigned i = 0; i < 20; i++)
+    {
+        EXPECT_TRUE(EnqueueLine(*ring, 1, i));
+        if (i % 3 == 2)
+        {
+            while (DequeueLine(*ring, tid, value))
+            {
+                EXPECT_EQ(value, next++);
+            }
+        }
+    }
+    while (DequeueLine(*ring, tid, value))
+    {
+        EXPECT_EQ(value, next++);
+    }
+
+    EXPECT_EQ(next, 20u);
+    EXPECT_EQ(ring->DroppedCount(), 0u);
+}
+
+TEST(TestAsyncLogRing, TestDropCounting)
+{
+    auto ring = std::make_unique<AsyncLogRing<4>>();
+    long long tid;
+    unsigned value;
+
+    for (unsigned i = 0; i < 4; i++)
+    {
+        EXPECT_TRUE(EnqueueLine(*ring, 1, i));
+    }
+
+    // A full ring drops new lines instead of overwriting queued ones.
+    EXPECT_FALSE(EnqueueLine(*ring, 1, 100));
+    EXPECT_FALSE(EnqueueLine(*ring, 1, 101));
+    EXPECT_FALSE(EnqueueLine(*ring, 1, 102));
+    EXPECT_EQ(ring->DroppedCount(), 3u);
+
+    // Consuming one line makes room for exactly one more.
+    EXPECT_TRUE(DequeueLine(*ring, tid, value));
+    EXPECT_EQ(value, 0u);
+    EXPECT_TRUE(EnqueueLine(*ring, 1, 4));
+    EXPECT_FALSE(EnqueueLine(*ring, 1, 103));
+    EXPECT_EQ(ring->DroppedCount(), 4u);
+
+    for (unsigned expected = 1; expected <= 4; expected++)
+    {
+        EXPECT_TRUE(DequeueLine(*ring, tid, value));
+        EXPECT_EQ(value, expected);
+    }
+    EXPECT_FALSE(DequeueLine(*ring, tid, value));
+}
+
+TEST(TestAsyncLogRing, TestConcurrentProducersKeepPerThreadOrder)
+{
+    constexpr unsigned kProducers        = 4;
+    constexpr unsigned kLinesPerProducer = 2000;
+
+    auto ring = std::make_unique<AsyncLogRing<64>>();
+    std::vector<std::thread> producers;
+    for (unsigned p = 0; p < kProducers; p++)
+    {
+        producers.emplace_back([&ring, p]() {
+            for (unsigned i = 0; i < kLinesPerProducer; i++)
+            {
+                EnqueueLine(*ring, p, i);
+            }
+        });
+    }
+
+    // Consume concurrently. Lines from one thread must come out in the order they were logged, and every line is
+    // either written or counted as dropped.
+    unsigned nextExpected[kProducers] = {};
+    unsigned written                  = 0;
+    bool ordered                      = true;
+    auto drain                        = [&]() {
+        long long tid;
+        unsigned value;
+        while (DequeueLine(*ring, tid, value))
+        {
+            ordered = ordered && (value >= nextExpected[tid]);
+            nextExpected[tid] = value + 1;
+            written++;
+        }
+    };
+
+    while (written + ring->DroppedCount() < kProducers * kLinesPerProducer)
+    {
+        drain();
+        std::this_thread::yield();
+    }
+    for (auto & producer : producers)
+    {
+        producer.join();
+    }
+    drain();
+
+    EXPECT_TRUE(ordered);
+    EXPECT_EQ(written + ring->DroppedCount(), kProducers * kLinesPerProducer);
+}
+
+} // namespace
@@ -0,0 +1,226 @@
+/*
+ *
+ *    Copyright (c) 2024 Project CHIP Authors
+ *
+ *    Licensed under the Apache License, Version 2.0 (the "License");
+ *    you may not use this file except in compliance with the License.
+ *    You may obtain a copy of the License at
+ *
+ *        http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *    Unless required by applicable law or agreed to in writing, software
+ *    distributed under the License is distributed on an "AS IS" BASIS,
+ *    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *    See the License for the specific language governing permissions and
+ *    limitations under the License.
+ */
+
+#include <pw_unit_test/framework.h>
+
+#include <lib/core/StringBuilderAdapters.h>
+#include <lib/support/logging/CHIPLogging.h>
+#include <platform/Linux/AsyncLogging.h>
+
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <string>
+#include <sys/wait.h>
+#include <thread>
+#include <unistd.h>
+#include <vector>
+
+using namespace chip::Logging::Platform;
+
+namespace {
+
+/// Redirects the standard output, where the log lines go, to a file for the lifetime of the object.
+class StdoutRedirect
+{
+public:
+    explicit StdoutRedirect(FILE * file = tmpfile()) : mFile(file)
+    {
+        fflush(stdout);
+        mSavedFd = dup(STDOUT_FILENO);
+        dup2(fileno(mFile), STDOUT_FILENO);
+    }
+
+    ~StdoutRedirect()
+    {
+        Restore();
+        fclose(mFile);
+    }
+
+    void Restore()
+    {
+        if (mSavedFd >= 0)
+        {
+            fflush(stdout);
+            dup2(mSavedFd, STDOUT_FILENO);
+            close(mSavedFd);
+            mSavedFd = -1;
+        }
+    }
+
+    /// Restores the standard output and returns the lines written to it.
+    std::vector<std::string> Lines()
+    {
+        Restore();
+
+        std::vector<std::string> lines;
+        char line[1024];
+        rewind(mFile);
+        while (fgets(line, sizeof(line), mFile) != nullptr)
+        {
+            lines.emplace_back(line);
+        }
+        return lines;
+    }
+
+private:
+    FILE * mFile;
+    int mSavedFd = -1;
+};
+
+size_t CountLinesContaining(const std::vector<std::string> & lines, const char * marker)
+{
+    size_t count = 0;
+    for (const auto & line : lines)
+    {
+        count += (line.find(marker) != std::string::npos) ? 1 : 0;
+    }
+    return count;
+}
+
+/// Logs from several threads at once, returning the total time the threads spent logging.
+std::chrono::nanoseconds LogFromThreads(unsigned threads, unsigned linesPerThread)
+{
+    std::vector<std::thread> producers;
+    std::vector<std::chrono::nanoseconds> elapsed(threads);
+    for (unsigned t = 0; t < threads; t++)
+    {
+        producers.emplace_back([t, linesPerThread, &elapsed]() {
+            const auto start = std::chrono::steady_clock::now();
+            for (unsigned i = 0; i < linesPerThread; i++)
+            {
+                ChipLogProgress(Test, "async-test line %u of thread %u", i, t);
+            }
+            elapsed[t] = std::chrono::steady_clock::now() - start;
+        });
+    }
+
+    std::chrono::nanoseconds total(0);
+    for (unsigned t = 0; t < threads; t++)
+    {
+        producers[t].join();
+        total += elapsed[t];
+    }
+    return total;
+}
+
+TEST(TestAsyncLogging, TestStopWritesQueuedLines)
+{
+    constexpr unsigned kThreads        = 4;
+    constexpr unsigned kLinesPerThread = 100;
+
+    const uint64_t droppedBefore = GetAsyncLoggingDroppedCount();
+    StdoutRedirect redirect;
+
+    ASSERT_EQ(StartAsyncLogging(), CHIP_NO_ERROR);
+    LogFromThreads(kThreads, kLinesPerThread);
+    StopAsyncLogging();
+
+    // Every line is written out by the time StopAsyncLogging() returns, or counted as dropped.
+    const size_t written = CountLinesContaining(redirect.Lines(), "async-test line");
+    EXPECT_EQ(written + (GetAsyncLoggingDroppedCount() - droppedBefore), kThreads * kLinesPerThread);
+}
+
+TEST(TestAsyncLogging, TestForkedChildLogsItsOwnIds)
+{
+    StdoutRedirect redirect;
+
+    // Fill the cached ids of the parent first.
+    ASSERT_EQ(StartAsyncLogging(), CHIP_NO_ERROR);
+    ChipLogProgress(Test, "async-test parent");
+
+    fflush(stdout);
+    pid_t child = fork();
+    ASSERT_GE(child, 0);
+    if (child == 0)
+    {
+        // The writer thread of the parent does not exist here, so this must be written synchronously.
+        ChipLogProgress(Test, "async-test child");
+        fflush(stdout);
+        _exit(0);
+    }
+
+    int status = 0;
+    ASSERT_EQ(waitpid(child, &status, 0), child);
+    EXPECT_TRUE(WIFEXITED(status));
+    StopAsyncLogging();
+
+    // Lines look like "[<seconds>.<microseconds>][<pid>:<tid>] CHIP:<module>: <message>".
+    bool found = false;
+    for (const auto & line : redirect.Lines())
+    {
+        if (line.find("async-test child") == std::string::npos)
+        {
+            continue;
+        }
+        long long pid = 0;
+        long long tid = 0;
+        const char * ids = strstr(line.c_str(), "][");
+        ASSERT_NE(ids, nullptr);
+        ASSERT_EQ(sscanf(ids, "][%lld:%lld]", &pid, &tid), 2);
+        EXPECT_EQ(pid, static_cast<long long>(child));
+        EXPECT_EQ(tid, static_cast<long long>(child));
+        found = true;
+    }
+    EXPECT_TRUE(found);
+}
+
+// Cost of logging for the threads emitting the lines, with the output going to /dev/null. The lines come in bursts that fit in
+// the ring, which is drained between bursts, so that the asynchronous cost is not that of dropping lines.
+TEST(TestAsyncLogging, TestLoggingThroughput)
+{
+    constexpr unsigned kThreads        = 4;
+    constexpr unsigned kLinesPerThread = 200;
+    constexpr unsigned kBursts         = 50;
+
+    FILE * devNull = fopen("/dev/null", "w");
+    ASSERT_NE(devNull, nullptr);
+
+    std::chrono::nanoseconds elapsed[2] = {};
+    uint64_t dropped                    = 0;
+    {
+        StdoutRedirect redirect(devNull);
+
+        for (int async = 0; async < 2; async++)
+        {
+            for (unsigned burst = 0; burst < kBursts; burst++)
+            {
+                const uint64_t droppedBefore = GetAsyncLoggingDroppedCount();
+                if (async)
+                {
+                    ASSERT_EQ(StartAsyncLogging(), CHIP_NO_ERROR);
+                }
+
+                elapsed[async] += LogFromThreads(kThreads, kLinesPerThread);
+
+                if (async)
+                {
+                    StopAsyncLogging();
+                    dropped += GetAsyncLoggingDroppedCount() - droppedBefore;
+                }
+            }
+        }
+    }
+
+    constexpr unsigned kLines = kThreads * kLinesPerThread * kBursts;
+    ChipLogProgress(Test, "%u lines from %u threads: synchronous %u ns/line, asynchronous %u ns/line (%u dropped)", kLines,
+                    kThreads, static_cast<unsigned>(elapsed[0].count() / kLines),
+                    static_cast<unsigned>(elapsed[1].count() / kLines), static_cast<unsigned>(dropped));
+    EXPECT_EQ(dropped, 0u);
+}
+
+} // namespace
@@ -0,0 +1,214 @@
+/*
+ *
+ *    Copyright (c) 2024 Project CHIP Authors
+ *
+ *    Licensed under the Apache License, Version 2.0 (the "License");
+ *    you may not use this file except in compliance with the License.
+ *    You may obtain a copy of the License at
+ *
+ *        http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *    Unless required by applicable law or agreed to in writing, software
+ *    distributed under the License is distributed on an "AS IS" BASIS,
+ *    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *    See the License for the specific language governing permissions and
+ *    limitations under the License.
+ */
+
+/**
+ *    @file
+ *      Unit tests for the failure paths of the Linux OTA image processor.
+ */
+
+#include <atomic>
+#include <csignal>
+#include <sys/resource.h>
+#include <unistd.h>
+
+#include <pw_unit_test/framework.h>
+
+#include <app/clusters/ota-requestor/OTADownloader.h>
+#include <app/clusters/ota-requestor/OTARequestorInterface.h>
+#include <lib/core/StringBuilderAdapters.h>
+#include <lib/support/CHIPMem.h>
+#include <lib/support/UnitTestUtils.h>
+#include <platform/CHIPDeviceLayer.h>
+#include <platform/Linux/OTAImageProcessorImpl.h>
+#include <platform/TestOnlyCommissionableDataProvider.h>
+
+using namespace chip;
+using namespace chip::DeviceLayer;
+
+namespace chip {
+
+// Normally provided by the application. Without a requestor, failures are only visible through the downloader and Apply().
+OTARequestorInterface * GetRequestorInstance()
+{
+    return nullptr;
+}
+
+} // namespace chip
+
+namespace {
+
+constexpr char kImageFile[] = "/tmp/TestOTAImageProcessor.ota";
+
+// Same image as in TestOTAImageHeader: a 12 byte "test payload" with its SHA-256 digest.
+const uint8_t kOtaImage[] = { 0x1e, 0xf1, 0xee, 0x1b, 0x6e, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x52, 0x00, 0x00, 0x00,
+                              0x15, 0x25, 0x00, 0xad, 0xde, 0x25, 0x01, 0xef, 0xbe, 0x26, 0x02, 0xff, 0xff, 0xff, 0xff, 0x2c,
+                              0x03, 0x03, 0x31, 0x2e, 0x30, 0x24, 0x04, 0x0c, 0x24, 0x05, 0x01, 0x24, 0x06, 0x02, 0x2c, 0x07,
+                              0x0a, 0x68, 0x74, 0x74, 0x70, 0x73, 0x3a, 0x2f, 0x2f, 0x72, 0x6e, 0x24, 0x08, 0x01, 0x30, 0x09,
+                              0x20, 0x81, 0x3c, 0xa5, 0x28, 0x5c, 0x28, 0xcc, 0xee, 0x5c, 0xab, 0x8b, 0x10, 0xeb, 0xda, 0x9c,
+                              0x90, 0x8f, 0xd6, 0xd7, 0x8e, 0xd9, 0xdc, 0x94, 0xcc, 0x65, 0xea, 0x6c, 0xb6, 0x7a, 0x7f, 0x13,
+                              0xae, 0x18, 0x74, 0x65, 0x73, 0x74, 0x20, 0x70, 0x61, 0x79, 0x6c, 0x6f, 0x61, 0x64 };
+
+class TestDownloader : public OTADownloader
+{
+public:
+    CHIP_ERROR BeginPrepareDownload() override { return CHIP_NO_ERROR; }
+
+    CHIP_ERROR OnPreparedForDownload(CHIP_ERROR status) override
+    {
+        mPrepareStatus = status;
+        mPrepared.store(true, std::memory_order_release);
+        return CHIP_NO_ERROR;
+    }
+
+    void OnDownloadTimeout() override {}
+
+    void EndDownload(CHIP_ERROR reason) override
+    {
+        mEndReason = reason;
+        mEnded.store(true, std::memory_order_release);
+    }
+
+    CHIP_ERROR FetchNextData() override { return CHIP_NO_ERROR; }
+
+    std::atomic<bool> mPrepared{ false };
+    CHIP_ERROR mPrepareStatus = CHIP_NO_ERROR;
+    std::atomic<bool> mEnded{ false };
+    CHIP_ERROR mEndReason = CHIP_NO_ERROR;
+};
+
+template <typename Predicate>
+bool WaitFor(Predicate predicate)
+{
+    for (int i = 0; i < 500 && !predicate(); i++)
+    {
+        test_utils::SleepMillis(10);
+    }
+    return predicate();
+}
+
+bool ImageFileExists()
+{
+    return access(kImageFile, F_OK) == 0;
+}
+
+class TestOTAImageProcessor : public ::testing::Test
+{
+public:
+    static void SetUpTestSuite()
+    {
+        ASSERT_EQ(chip::Platform::MemoryInit(), CHIP_NO_ERROR);
+
+        static TestOnlyCommissionableDataProvider commissionable_data_provider;
+        SetCommissionableDataProvider(&commissionable_data_provider);
+
+        ASSERT_EQ(PlatformMgr().InitChipStack(), CHIP_NO_ERROR);
+        ASSERT_EQ(PlatformMgr().StartEventLoopTask(), CHIP_NO_ERROR);
+    }
+
+    static void TearDownTestSuite()
+    {
+        PlatformMgr().StopEventLoopTask();
+        PlatformMgr().Shutdown();
+        chip::Platform::MemoryShutdown();
+    }
+
+    void SetUp() override
+    {
+        mProcessor.SetOTADownloader(&mDownloader);
+        mProcessor.SetOTAImageFile(kImageFile);
+        mDownloader.SetImageProcessorDelegate(&mProcessor);
+
+        EXPECT_EQ(mProcessor.PrepareDownload(), CHIP_NO_ERROR);
+        ASSERT_TRUE(WaitFor([this] { return mDownloader.mPrepared.load(std::memory_order_acquire); }));
+        ASSERT_EQ(mDownloader.mPrepareStatus, CHIP_NO_ERROR);
+    }
+
+    void TearDown() override
+    {
+        EXPECT_EQ(mProcessor.Abort(), CHIP_NO_ERROR);
+        EXPECT_TRUE(WaitFor([] { return !ImageFileExists(); }));
+    }
+
+    CHIP_ERROR ProcessBlock(ByteSpan block)
+    {
+        PlatformMgr().LockChipStack();
+        CHIP_ERROR err = mProcessor.ProcessBlock(block);
+        PlatformMgr().UnlockChipStack();
+        return err;
+    }
+
+    CHIP_ERROR Apply()
+    {
+        PlatformMgr().LockChipStack();
+        CHIP_ERROR err = mProcessor.Apply();
+        PlatformMgr().UnlockChipStack();
+        return err;
+    }
+
+    OTAImageProcessorImpl mProcessor;
+    TestDownloader mDownloader;
+};
+
+TEST_F(TestOTAImageProcessor, TestWriteFailureEndsDownloadAndRefusesApply)
+{
+    // Limit the size of files this process may write, so the payload write fails with EFBIG.
+    struct rlimit savedLimit;
+    ASSERT_EQ(getrlimit(RLIMIT_FSIZE, &savedLimit), 0);
+    struct rlimit limit = savedLimit;
+    limit.rlim_cur      = 1;
+    auto savedHandler   = signal(SIGXFSZ, SIG_IGN);
+    ASSERT_EQ(setrlimit(RLIMIT_FSIZE, &limit), 0);
+
+    EXPECT_EQ(ProcessBlock(ByteSpan(kOtaImage)), CHIP_NO_ERROR);
+    bool ended = WaitFor([this] { return mDownloader.mEnded.load(std::memory_order_acquire); });
+
+    setrlimit(RLIMIT_FSIZE, &savedLimit);
+    signal(SIGXFSZ, savedHandler);
+
+    ASSERT_TRUE(ended);
+    EXPECT_EQ(mDownloader.mEndReason, CHIP_ERROR_WRITE_FAILED);
+
+    // Finalizing reports the failure and removes the partial image, which can then not be applied.
+    EXPECT_EQ(mProcessor.Finalize(), CHIP_NO_ERROR);
+    EXPECT_TRUE(WaitFor([] { return !ImageFileExists(); }));
+    EXPECT_NE(Apply(), CHIP_NO_ERROR);
+}
+
+TEST_F(TestOTAImageProcessor, TestDigestMismatchRefusesApply)
+{
+    uint8_t image[sizeof(kOtaImage)];
+    memcpy(image, kOtaImage, sizeof(image));
+    image[sizeof(image) - 1] ^= 0xff;
+
+    EXPECT_EQ(ProcessBlock(ByteSpan(image)), CHIP_NO_ERROR);
+    EXPECT_EQ(mProcessor.Finalize(), CHIP_NO_ERROR);
+
+    // The image is written completely but fails verification, so it is removed rather than applied.
+    EXPECT_TRUE(WaitFor([] { return !ImageFileExists(); }));
+    EXPECT_FALSE(mDownloader.mEnded.load(std::memory_order_acquire));
+    EXPECT_NE(Apply(), CHIP_NO_ERROR);
+}
+
+TEST_F(TestOTAImageProcessor, TestApplyBeforeFinalizeIsRefused)
+{
+    EXPECT_EQ(ProcessBlock(ByteSpan(kOtaImage)), CHIP_NO_ERROR);
+
+    EXPECT_EQ(Apply(), CHIP_ERROR_INCORRECT_STATE);
+    EXPECT_FALSE(mDownloader.mEnded.load(std::memory_order_acquire));
+}
+
+} // namespace
@@ -24,6 +24,8 @@
 
 #pragma once
 
+#include <lib/core/CHIPConfig.h>
+#include <lib/core/TLVTags.h>
 #include <lib/support/BitFlags.h>
 #include <lib/support/BufferWriter.h>
 #include <lib/support/CodeUtils.h>
@@ -38,6 +40,11 @@ inline constexpr uint16_t kMaxFileDesignatorLen = 0xFF;
 
 inline constexpr char kProtocolName[] = "BDX";
 
+/// Tag of the vendor-specific element that TransferSession appends to the Metadata of TransferInit and Accept messages to
+/// negotiate its windowed extension of Sender Drive. The element holds the window size as an unsigned integer.
+inline constexpr TLV::Tag kWindowSizeMetadataTag =
+    TLV::ProfileTag(static_cast<uint16_t>(CHIP_CONFIG_BDX_WINDOWED_TRANSFER_VENDOR_ID), Protocols::BDX::Id.GetProtocolId(), 1);
+
 enum class MessageType : uint8_t
 {
     SendInit           = 0x01,
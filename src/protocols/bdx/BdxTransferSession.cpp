@@ -6,6 +6,8 @@
 
 #include <protocols/bdx/BdxTransferSession.h>
 
+#include <lib/core/TLVReader.h>
+#include <lib/core/TLVWriter.h>
 #include <lib/support/BufferReader.h>
 #include <lib/support/CodeUtils.h>
 #include <lib/support/TypeTraits.h>
@@ -22,19 +24,37 @@
 namespace {
 constexpr uint8_t kBdxVersion = 0; ///< The version of this implementation of the BDX spec
 
+// Encoded size of the window size Metadata element: control byte, fully-qualified tag and 1-byte value
+constexpr size_t kWindowSizeMetadataLength = 8;
+
 /**
  * @brief
  *   Allocate a new PacketBuffer and write data from a BDX message struct.
+ *
+ *   A windowSize above 1 is appended to the Metadata of the message, which must end with it (TransferInit and Accept messages).
  */
-CHIP_ERROR WriteToPacketBuffer(const ::chip::bdx::BdxMessage & msgStruct, ::chip::System::PacketBufferHandle & msgBuf)
+CHIP_ERROR WriteToPacketBuffer(const ::chip::bdx::BdxMessage & msgStruct, ::chip::System::PacketBufferHandle & msgBuf,
+                               uint8_t windowSize = 1)
 {
-    size_t msgDataSize = msgStruct.MessageSize();
+    uint8_t windowSizeMetadata[kWindowSizeMetadataLength];
+    size_t windowSizeMetadataLength = 0;
+    if (windowSize > 1)
+    {
+        ::chip::TLV::TLVWriter writer;
+        writer.Init(windowSizeMetadata);
+        ReturnErrorOnFailure(writer.Put(::chip::bdx::kWindowSizeMetadataTag, windowSize));
+        ReturnErrorOnFailure(writer.Finalize());
+        windowSizeMetadataLength = writer.GetLengthWritten();
+    }
+
+    size_t msgDataSize = msgStruct.MessageSize() + windowSizeMetadataLength;
     ::chip::Encoding::LittleEndian::PacketBufferWriter bbuf(chip::MessagePacketBuffer::New(msgDataSize), msgDataSize);
     if (bbuf.IsNull())
     {
         return CHIP_ERROR_NO_MEMORY;
     }
     msgStruct.WriteToBuffer(bbuf);
+    bbuf.Put(windowSizeMetadata, windowSizeMetadataLength);
     msgBuf = bbuf.Finalize();
     if (msgBuf.IsNull())
     {
@@ -43,6 +63,40 @@ CHIP_ERROR WriteToPacketBuffer(const ::chip::bdx::BdxMessage & msgStruct, ::chip
     return CHIP_NO_ERROR;
 }
 
+/**
+ * @brief
+ *   Remove the window size element appended by WriteToPacketBuffer() from received Metadata, so that the application only sees
+ *   the Metadata of its peer.
+ *
+ * @return The window size proposed by the peer, 1 if the Metadata does not end with a window size element.
+ */
+uint8_t ExtractWindowSize(const uint8_t *& metadata, size_t & metadataLength)
+{
+    VerifyOrReturnValue(metadata != nullptr && metadataLength >= kWindowSizeMetadataLength, 1);
+    const size_t appMetadataLength = metadataLength - kWindowSizeMetadataLength;
+
+    // The element must follow complete elements, rather than be the end of an element of the application.
+    ::chip::TLV::TLVReader reader;
+    CHIP_ERROR err = CHIP_NO_ERROR;
+    reader.Init(metadata, appMetadataLength);
+    while ((err = reader.Next()) == CHIP_NO_ERROR)
+    {
+    }
+    VerifyOrReturnValue(err == CHIP_END_OF_TLV, 1);
+
+    uint8_t windowSize = 1;
+    reader.Init(metadata + appMetadataLength, kWindowSizeMetadataLength);
+    VerifyOrReturnValue(reader.Next() == CHIP_NO_ERROR && reader.GetTag() == ::chip::bdx::kWindowSizeMetadataTag, 1);
+    VerifyOrReturnValue(reader.Get(windowSize) == CHIP_NO_ERROR && reader.Next() == CHIP_END_OF_TLV, 1);
+
+    metadataLength = appMetadataLength;
+    if (metadataLength == 0)
+    {
+        metadata = nullptr;
+    }
+    return ::chip::max<uint8_t>(windowSize, 1);
+}
+
 template <typename MessageType>
 void PrepareOutgoingMessageEvent(MessageType messageType, chip::bdx::TransferSession::OutputEventType & pendingOutput,
                                  chip::bdx::TransferSession::MessageTypeData & outputMsgType)
@@ -146,6 +200,7 @@ CHIP_ERROR TransferSession::StartTransfer(TransferRole role, const TransferInitD
     mMaxSupportedBlockSize = initData.MaxBlockSize;
     mStartOffset           = initData.StartOffset;
     mTransferLength        = initData.Length;
+    mWindowSize            = initData.WindowSize;
 
     // Prepare TransferInit message
     TransferInit initMsg;
@@ -159,7 +214,9 @@ CHIP_ERROR TransferSession::StartTransfer(TransferRole role, const TransferInitD
     initMsg.Metadata           = initData.Metadata;
     initMsg.MetadataLength     = initData.MetadataLength;
 
-    ReturnErrorOnFailure(WriteToPacketBuffer(initMsg, mPendingMsgHandle));
+    // The windowed extension only applies to Sender Drive
+    const bool proposeWindow = mSuppportedXferOpts.Has(TransferControlFlags::kSenderDrive) && mWindowSize > 1;
+    ReturnErrorOnFailure(WriteToPacketBuffer(initMsg, mPendingMsgHandle, proposeWindow ? mWindowSize : 1));
 
     const MessageType msgType = (mRole == TransferRole::kSender) ? MessageType::SendInit : MessageType::ReceiveInit;
 
@@ -177,7 +234,7 @@ CHIP_ERROR TransferSession::StartTransfer(TransferRole role, const TransferInitD
 }
 
 CHIP_ERROR TransferSession::WaitForTransfer(TransferRole role, BitFlags<TransferControlFlags> xferControlOpts,
-                                            uint16_t maxBlockSize, System::Clock::Timeout timeout)
+                                            uint16_t maxBlockSize, System::Clock::Timeout timeout, uint8_t windowSize)
 {
     VerifyOrReturnError(mState == TransferState::kUnitialized, CHIP_ERROR_INCORRECT_STATE);
 
@@ -186,6 +243,7 @@ CHIP_ERROR TransferSession::WaitForTransfer(TransferRole role, BitFlags<Transfer
     mTimeout               = timeout;
     mSuppportedXferOpts    = xferControlOpts;
     mMaxSupportedBlockSize = maxBlockSize;
+    mWindowSize            = windowSize;
 
     mState = TransferState::kAwaitingInitMsg;
 
@@ -208,6 +266,11 @@ CHIP_ERROR TransferSession::AcceptTransfer(const TransferAcceptData & acceptData
 
     mTransferMaxBlockSize = acceptData.MaxBlockSize;
 
+    // Only use the windowed extension if both sides support it, with the smaller of their windows.
+    mWindowed = (acceptData.ControlMode == TransferControlFlags::kSenderDrive) && (mTransferRequestData.WindowSize > 1) &&
+        (mWindowSize > 1);
+    mWindowSize = mWindowed ? ::chip::min(mWindowSize, mTransferRequestData.WindowSize) : 1;
+
     if (mRole == TransferRole::kSender)
     {
         mStartOffset    = acceptData.StartOffset;
@@ -222,7 +285,7 @@ CHIP_ERROR TransferSession::AcceptTransfer(const TransferAcceptData & acceptData
         acceptMsg.Metadata       = acceptData.Metadata;
         acceptMsg.MetadataLength = acceptData.MetadataLength;
 
-        ReturnErrorOnFailure(WriteToPacketBuffer(acceptMsg, mPendingMsgHandle));
+        ReturnErrorOnFailure(WriteToPacketBuffer(acceptMsg, mPendingMsgHandle, mWindowSize));
         msgType = MessageType::ReceiveAccept;
 
 #if CHIP_AUTOMATION_LOGGING
@@ -239,7 +302,7 @@ CHIP_ERROR TransferSession::AcceptTransfer(const TransferAcceptData & acceptData
         acceptMsg.Metadata       = acceptData.Metadata;
         acceptMsg.MetadataLength = acceptData.MetadataLength;
 
-        ReturnErrorOnFailure(WriteToPacketBuffer(acceptMsg, mPendingMsgHandle));
+        ReturnErrorOnFailure(WriteToPacketBuffer(acceptMsg, mPendingMsgHandle, mWindowSize));
         msgType = MessageType::SendAccept;
 
 #if CHIP_AUTOMATION_LOGGING
@@ -332,7 +395,14 @@ CHIP_ERROR TransferSession::PrepareBlock(const BlockData & inData)
     VerifyOrReturnError(mState == TransferState::kTransferInProgress, CHIP_ERROR_INCORRECT_STATE);
     VerifyOrReturnError(mRole == TransferRole::kSender, CHIP_ERROR_INCORRECT_STATE);
     VerifyOrReturnError(mPendingOutput == OutputEventType::kNone, CHIP_ERROR_INCORRECT_STATE);
-    VerifyOrReturnError(!mAwaitingResponse, CHIP_ERROR_INCORRECT_STATE);
+    if (mWindowed)
+    {
+        VerifyOrReturnError(GetNumBlocksInFlight() < mWindowSize, CHIP_ERROR_INCORRECT_STATE);
+    }
+    else
+    {
+        VerifyOrReturnError(!mAwaitingResponse, CHIP_ERROR_INCORRECT_STATE);
+    }
 
     // Verify non-zero data is provided and is no longer than MaxBlockSize (BlockEOF may contain 0 length data)
     VerifyOrReturnError((inData.Data != nullptr) && (inData.Length <= mTransferMaxBlockSize), CHIP_ERROR_INVALID_ARGUMENT);
@@ -424,14 +494,17 @@ void TransferSession::Reset()
     mStartOffset           = 0;
     mTransferLength        = 0;
     mTransferMaxBlockSize  = 0;
+    mWindowSize            = 1;
+    mWindowed              = false;
 
     mPendingMsgHandle = nullptr;
 
-    mNumBytesProcessed = 0;
-    mLastBlockNum      = 0;
-    mNextBlockNum      = 0;
-    mLastQueryNum      = 0;
-    mNextQueryNum      = 0;
+    mNumBytesProcessed    = 0;
+    mLastBlockNum         = 0;
+    mNextBlockNum         = 0;
+    mLastQueryNum         = 0;
+    mNextQueryNum         = 0;
+    mFirstUnackedBlockNum = 0;
 
     mTimeout                = System::Clock::kZero;
     mTimeoutStartTime       = System::Clock::kZero;
@@ -553,6 +626,8 @@ void TransferSession::HandleTransferInit(MessageType msgType, System::PacketBuff
     const CHIP_ERROR err = transferInit.Parse(msgData.Retain());
     VerifyOrReturn(err == CHIP_NO_ERROR, PrepareStatusReport(StatusCode::kBadMessageContents));
 
+    const uint8_t proposedWindowSize = ExtractWindowSize(transferInit.Metadata, transferInit.MetadataLength);
+
     ResolveTransferControlOptions(transferInit.TransferCtlOptions);
     mTransferVersion      = ::chip::min(kBdxVersion, transferInit.Version);
     mTransferMaxBlockSize = ::chip::min(mMaxSupportedBlockSize, transferInit.MaxBlockSize);
@@ -570,6 +645,7 @@ void TransferSession::HandleTransferInit(MessageType msgType, System::PacketBuff
     mTransferRequestData.FileDesLength    = transferInit.FileDesLength;
     mTransferRequestData.Metadata         = transferInit.Metadata;
     mTransferRequestData.MetadataLength   = transferInit.MetadataLength;
+    mTransferRequestData.WindowSize       = proposedWindowSize;
 
     mPendingMsgHandle = std::move(msgData);
     mPendingOutput    = OutputEventType::kInitReceived;
@@ -592,6 +668,7 @@ void TransferSession::HandleReceiveAccept(System::PacketBufferHandle msgData)
 
     // Verify that Accept parameters are compatible with the original proposed parameters
     ReturnOnFailure(VerifyProposedMode(rcvAcceptMsg.TransferCtlFlags));
+    ReturnOnFailure(VerifyProposedWindowSize(ExtractWindowSize(rcvAcceptMsg.Metadata, rcvAcceptMsg.MetadataLength)));
 
     mTransferMaxBlockSize = rcvAcceptMsg.MaxBlockSize;
     mStartOffset          = rcvAcceptMsg.StartOffset;
@@ -628,6 +705,7 @@ void TransferSession::HandleSendAccept(System::PacketBufferHandle msgData)
 
     // Verify that Accept parameters are compatible with the original proposed parameters
     ReturnOnFailure(VerifyProposedMode(sendAcceptMsg.TransferCtlFlags));
+    ReturnOnFailure(VerifyProposedWindowSize(ExtractWindowSize(sendAcceptMsg.Metadata, sendAcceptMsg.MetadataLength)));
 
     // Note: if VerifyProposedMode() returned with no error, then mControlMode must match the proposed mode in the SendAccept
     // message
@@ -665,8 +743,9 @@ void TransferSession::HandleBlockQuery(System::PacketBufferHandle msgData)
 
     mPendingOutput = OutputEventType::kQueryReceived;
 
-    mAwaitingResponse = false;
-    mLastQueryNum     = query.BlockCounter;
+    mAwaitingResponse     = false;
+    mLastQueryNum         = query.BlockCounter;
+    mFirstUnackedBlockNum = query.BlockCounter;
 
 #if CHIP_AUTOMATION_LOGGING
     query.LogMessage(MessageType::BlockQuery);
@@ -689,6 +768,7 @@ void TransferSession::HandleBlockQueryWithSkip(System::PacketBufferHandle msgDat
 
     mAwaitingResponse        = false;
     mLastQueryNum            = query.BlockCounter;
+    mFirstUnackedBlockNum    = query.BlockCounter;
     mBytesToSkip.BytesToSkip = query.BytesToSkip;
 
 #if CHIP_AUTOMATION_LOGGING
@@ -727,7 +807,15 @@ void TransferSession::HandleBlock(System::PacketBufferHandle msgData)
     mNumBytesProcessed += blockMsg.DataLength;
     mLastBlockNum = blockMsg.BlockCounter;
 
-    mAwaitingResponse = false;
+    if (mWindowed)
+    {
+        // More Blocks may already be on their way, whether or not this one gets acknowledged.
+        mLastQueryNum = blockMsg.BlockCounter + 1;
+    }
+    else
+    {
+        mAwaitingResponse = false;
+    }
 
 #if CHIP_AUTOMATION_LOGGING
     blockMsg.LogMessage(MessageType::Block);
@@ -769,15 +857,43 @@ void TransferSession::HandleBlockEOF(System::PacketBufferHandle msgData)
 void TransferSession::HandleBlockAck(System::PacketBufferHandle msgData)
 {
     VerifyOrReturn(mRole == TransferRole::kSender, PrepareStatusReport(StatusCode::kUnexpectedMessage));
-    VerifyOrReturn(mState == TransferState::kTransferInProgress, PrepareStatusReport(StatusCode::kUnexpectedMessage));
+    if (mWindowed)
+    {
+        // Blocks sent before the BlockEOF may still be acknowledged after it.
+        VerifyOrReturn(mState == TransferState::kTransferInProgress || mState == TransferState::kAwaitingEOFAck,
+                       PrepareStatusReport(StatusCode::kUnexpectedMessage));
+    }
+    else
+    {
+        VerifyOrReturn(mState == TransferState::kTransferInProgress, PrepareStatusReport(StatusCode::kUnexpectedMessage));
+    }
     VerifyOrReturn(mAwaitingResponse, PrepareStatusReport(StatusCode::kUnexpectedMessage));
 
     BlockAck ackMsg;
     const CHIP_ERROR err = ackMsg.Parse(std::move(msgData));
     VerifyOrReturn(err == CHIP_NO_ERROR, PrepareStatusReport(StatusCode::kBadMessageContents));
+
+    if (mWindowed)
+    {
+        // Acknowledges every Block up to BlockCounter, which must be one of the Blocks in flight (other than a BlockEOF).
+        const uint32_t ackedIndex = ackMsg.BlockCounter - mFirstUnackedBlockNum;
+        const uint32_t ackable    = GetNumBlocksInFlight() - ((mState == TransferState::kAwaitingEOFAck) ? 1 : 0);
+        VerifyOrReturn(ackedIndex < ackable, PrepareStatusReport(StatusCode::kBadBlockCounter));
+
+        mPendingOutput        = OutputEventType::kAckReceived;
+        mFirstUnackedBlockNum = ackMsg.BlockCounter + 1;
+        mAwaitingResponse     = (GetNumBlocksInFlight() > 0);
+
+#if CHIP_AUTOMATION_LOGGING
+        ackMsg.LogMessage(MessageType::BlockAck);
+#endif // CHIP_AUTOMATION_LOGGING
+        return;
+    }
+
     VerifyOrReturn(ackMsg.BlockCounter == mLastBlockNum, PrepareStatusReport(StatusCode::kBadBlockCounter));
 
-    mPendingOutput = OutputEventType::kAckReceived;
+    mPendingOutput        = OutputEventType::kAckReceived;
+    mFirstUnackedBlockNum = ackMsg.BlockCounter + 1;
 
     // In Receiver Drive, the Receiver can send a BlockAck to indicate receipt of the message and reset the timeout.
     // In this case, the Sender should wait to receive a BlockQuery next.
@@ -801,7 +917,8 @@ void TransferSession::HandleBlockAckEOF(System::PacketBufferHandle msgData)
 
     mPendingOutput = OutputEventType::kAckEOFReceived;
 
-    mAwaitingResponse = false;
+    mAwaitingResponse     = false;
+    mFirstUnackedBlockNum = ackMsg.BlockCounter + 1;
 
     mState = TransferState::kTransferDone;
 
@@ -878,6 +995,23 @@ CHIP_ERROR TransferSession::VerifyProposedMode(const BitFlags<TransferControlFla
     return CHIP_NO_ERROR;
 }
 
+CHIP_ERROR TransferSession::VerifyProposedWindowSize(uint8_t windowSize)
+{
+    VerifyOrReturnError(windowSize > 1, CHIP_NO_ERROR);
+
+    // The windowed extension only applies to Sender Drive, and the window may not be larger than the proposed one
+    if (mControlMode != TransferControlFlags::kSenderDrive || windowSize > mWindowSize)
+    {
+        PrepareStatusReport(StatusCode::kTransferMethodNotSupported);
+        return CHIP_ERROR_INTERNAL;
+    }
+
+    mWindowed   = true;
+    mWindowSize = windowSize;
+
+    return CHIP_NO_ERROR;
+}
+
 void TransferSession::PrepareStatusReport(StatusCode code)
 {
     mStatusReportData.statusCode = code;
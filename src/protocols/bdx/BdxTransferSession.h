@@ -3,6 +3,14 @@
  *      This file defines a TransferSession state machine that contains the main logic governing a Bulk Data Transfer session. It
  *      provides APIs for starting a transfer or preparing to receive a transfer request, providing input to be processed, and
  *      accessing output data (including messages to be sent, message data received by the TransferSession, or state information).
+ *
+ *      In addition to the modes defined by the BDX specification, TransferSession supports a windowed variant of Sender Drive:
+ *      the sender may have up to a window of Blocks in flight, and each BlockAck acknowledges every Block up to its counter.
+ *      Both peers propose their window size in a vendor-specific element (kWindowSizeMetadataTag) appended to the Metadata of
+ *      the TransferInit and Accept messages, and the smaller one is used. The element is removed from the Metadata reported to
+ *      the application. Peers that do not propose a window get a plain Sender Drive transfer. Blocks must be delivered in order,
+ *      and the messaging layer only allows a single unacknowledged reliable message per exchange, so a window larger than 1 is
+ *      only useful over sessions that do not use MRP (e.g. TCP).
  */
 
 #pragma once
@@ -51,6 +59,10 @@ public:
         uint64_t StartOffset  = 0;
         uint64_t Length       = 0;
 
+        // Blocks the sender may have in flight. Values above 1 propose the windowed extension of Sender Drive. For a received
+        // TransferInit, the window size proposed by the peer.
+        uint8_t WindowSize = 1;
+
         const uint8_t * FileDesignator = nullptr;
         uint16_t FileDesLength         = 0;
 
@@ -191,12 +203,14 @@ public:
      * @param xferControlOpts Indicates all supported control modes. Used to respond to a TransferInit message
      * @param maxBlockSize    The max Block size that this object supports.
      * @param timeout         The amount of time to wait for a response before considering the transfer failed
+     * @param windowSize      The number of Blocks a sender may have in flight. Values above 1 enable the windowed extension of
+     *                        Sender Drive if the initiator proposes it too (see TransferInitData::WindowSize).
      *
      * @return CHIP_ERROR Result of initialization. May also indicate if the TransferSession object is unable to handle this
      *                    request.
      */
     CHIP_ERROR WaitForTransfer(TransferRole role, BitFlags<TransferControlFlags> xferControlOpts, uint16_t maxBlockSize,
-                               System::Clock::Timeout timeout);
+                               System::Clock::Timeout timeout, uint8_t windowSize = 1);
 
     /**
      * @brief
@@ -244,6 +258,9 @@ public:
      * @brief
      *   Prepare a Block message. The Block counter will be populated automatically.
      *
+     *   In windowed mode, this may be called again (after the message has been emitted via PollOutput()) as long as
+     *   GetNumBlocksInFlight() is lower than GetWindowSize(), without waiting for a BlockAck.
+     *
      * @param inData Contains data for filling out the Block message
      *
      * @return CHIP_ERROR The result of the preparation of a Block message. May also indicate if the TransferSession object
@@ -300,6 +317,9 @@ public:
     uint32_t GetNextBlockNum() const { return mNextBlockNum; }
     uint32_t GetNextQueryNum() const { return mNextQueryNum; }
     size_t GetNumBytesProcessed() const { return mNumBytesProcessed; }
+    bool IsWindowed() const { return mWindowed; }
+    uint8_t GetWindowSize() const { return mWindowed ? mWindowSize : 1; }
+    uint32_t GetNumBlocksInFlight() const { return mNextBlockNum - mFirstUnackedBlockNum; }
     const uint8_t * GetFileDesignator(uint16_t & fileDesignatorLen) const
     {
         fileDesignatorLen = mTransferRequestData.FileDesLength;
@@ -348,6 +368,13 @@ private:
      */
     CHIP_ERROR VerifyProposedMode(const BitFlags<TransferControlFlags> & proposed);
 
+    /**
+     * @brief
+     *   Used when handling an Accept message, after VerifyProposedMode(). Verifies that the window size chosen by the peer, if any,
+     *   is compatible with the proposed one, and enables the windowed extension of Sender Drive if so.
+     */
+    CHIP_ERROR VerifyProposedWindowSize(uint8_t windowSize);
+
     void PrepareStatusReport(StatusCode code);
     bool IsTransferLengthDefinite() const;
 
@@ -358,6 +385,7 @@ private:
     // Indicate supported options pre- transfer accept
     BitFlags<TransferControlFlags> mSuppportedXferOpts;
     uint16_t mMaxSupportedBlockSize = 0;
+    uint8_t mWindowSize             = 1;
 
     // Used to govern transfer once it has been accepted
     TransferControlFlags mControlMode;
@@ -365,6 +393,7 @@ private:
     uint64_t mStartOffset          = 0; ///< 0 represents no offset
     uint64_t mTransferLength       = 0; ///< 0 represents indefinite length
     uint16_t mTransferMaxBlockSize = 0;
+    bool mWindowed                 = false;
 
     // Used to store event data before it is emitted via PollOutput()
     System::PacketBufferHandle mPendingMsgHandle;
@@ -377,10 +406,11 @@ private:
 
     size_t mNumBytesProcessed = 0;
 
-    uint32_t mLastBlockNum = 0;
-    uint32_t mNextBlockNum = 0;
-    uint32_t mLastQueryNum = 0;
-    uint32_t mNextQueryNum = 0;
+    uint32_t mLastBlockNum         = 0;
+    uint32_t mNextBlockNum         = 0;
+    uint32_t mLastQueryNum         = 0;
+    uint32_t mNextQueryNum         = 0;
+    uint32_t mFirstUnackedBlockNum = 0; ///< Sender only
 
     System::Clock::Timeout mTimeout            = System::Clock::kZero;
     System::Clock::Timestamp mTimeoutStartTime = System::Clock::kZero;
@@ -1,3 +1,5 @@
+#include <algorithm>
+#include <deque>
 #include <string.h>
 
 #include <pw_unit_test/framework.h>
@@ -7,6 +9,7 @@
 #include <lib/support/BufferReader.h>
 #include <lib/support/CHIPMem.h>
 #include <lib/support/CodeUtils.h>
+#include <lib/support/logging/CHIPLogging.h>
 #include <protocols/Protocols.h>
 #include <protocols/bdx/BdxMessages.h>
 #include <protocols/bdx/BdxTransferSession.h>
@@ -135,14 +138,15 @@ void VerifyInternalError(TransferSession & transferSession)
 // TransferSession.
 void SendAndVerifyTransferInit(TransferSession::OutputEvent & outEvent, System::Clock::Timeout timeout, TransferSession & initiator,
                                TransferRole initiatorRole, TransferSession::TransferInitData initData, TransferSession & responder,
-                               BitFlags<TransferControlFlags> & responderControlOpts, uint16_t responderMaxBlock)
+                               BitFlags<TransferControlFlags> & responderControlOpts, uint16_t responderMaxBlock,
+                               uint8_t responderWindowSize = 1)
 {
     CHIP_ERROR err              = CHIP_NO_ERROR;
     TransferRole responderRole  = (initiatorRole == TransferRole::kSender) ? TransferRole::kReceiver : TransferRole::kSender;
     MessageType expectedInitMsg = (initiatorRole == TransferRole::kSender) ? MessageType::SendInit : MessageType::ReceiveInit;
 
     // Initializer responder to wait for transfer
-    err = responder.WaitForTransfer(responderRole, responderControlOpts, responderMaxBlock, timeout);
+    err = responder.WaitForTransfer(responderRole, responderControlOpts, responderMaxBlock, timeout, responderWindowSize);
     EXPECT_EQ(err, CHIP_NO_ERROR);
     VerifyNoMoreOutput(responder);
 
@@ -161,6 +165,7 @@ void SendAndVerifyTransferInit(TransferSession::OutputEvent & outEvent, System::
     VerifyNoMoreOutput(responder);
     EXPECT_EQ(outEvent.EventType, TransferSession::OutputEventType::kInitReceived);
     EXPECT_EQ(outEvent.transferInitData.TransferCtlFlags, initData.TransferCtlFlags);
+    EXPECT_EQ(outEvent.transferInitData.WindowSize, initData.WindowSize);
     EXPECT_EQ(outEvent.transferInitData.MaxBlockSize, initData.MaxBlockSize);
     EXPECT_EQ(outEvent.transferInitData.StartOffset, initData.StartOffset);
     EXPECT_EQ(outEvent.transferInitData.Length, initData.Length);
@@ -759,3 +764,340 @@ TEST_F(TestBdxTransferSession, TestRejectTransfer)
     // Reject the transfer with a status
     SendAndVerifyRejectMsg(outEvent, respondingSender, StatusCode::kResponderBusy, initiatingReceiver);
 }
+
+// Test Sender Drive with several Blocks in flight, acknowledged cumulatively.
+TEST_F(TestBdxTransferSession, TestWindowedSenderDrive)
+{
+    CHIP_ERROR err = CHIP_NO_ERROR;
+    TransferSession::OutputEvent outEvent;
+    TransferSession initiatingSender;
+    TransferSession respondingReceiver;
+
+    TransferControlFlags driveMode = TransferControlFlags::kSenderDrive;
+
+    // Chosen arbitrarily for this test
+    uint16_t transferBlockSize     = 10;
+    uint8_t senderWindowSize       = 6;
+    uint8_t windowSize             = 4;
+    System::Clock::Timeout timeout = System::Clock::Seconds16(24);
+
+    // Application metadata, which must get through unchanged next to the window size
+    uint8_t tlvBuf[64]    = { 0 };
+    char metadataStr[11]  = { "hi_dad.txt" };
+    uint32_t bytesWritten = 0;
+    EXPECT_EQ(WriteTLVString(tlvBuf, sizeof(tlvBuf), metadataStr, bytesWritten), CHIP_NO_ERROR);
+
+    BitFlags<TransferControlFlags> receiverOpts;
+    receiverOpts.Set(driveMode);
+
+    TransferSession::TransferInitData initOptions;
+    initOptions.TransferCtlFlags = driveMode;
+    initOptions.MaxBlockSize     = transferBlockSize;
+    initOptions.WindowSize       = senderWindowSize;
+    char testFileDes[9]          = { "test.txt" };
+    initOptions.FileDesLength    = static_cast<uint16_t>(strlen(testFileDes));
+    initOptions.FileDesignator   = reinterpret_cast<uint8_t *>(testFileDes);
+    initOptions.Metadata         = tlvBuf;
+    initOptions.MetadataLength   = bytesWritten;
+
+    SendAndVerifyTransferInit(outEvent, timeout, initiatingSender, TransferRole::kSender, initOptions, respondingReceiver,
+                              receiverOpts, transferBlockSize, windowSize);
+    EXPECT_EQ(ReadAndVerifyTLVString(outEvent.transferInitData.Metadata,
+                                     static_cast<uint32_t>(outEvent.transferInitData.MetadataLength), metadataStr,
+                                     strlen(metadataStr)),
+              CHIP_NO_ERROR);
+
+    TransferSession::TransferAcceptData acceptData;
+    acceptData.ControlMode    = respondingReceiver.GetControlMode();
+    acceptData.MaxBlockSize   = transferBlockSize;
+    acceptData.Metadata       = tlvBuf;
+    acceptData.MetadataLength = bytesWritten;
+
+    // The smaller of the two windows is used
+    SendAndVerifyAcceptMsg(outEvent, respondingReceiver, TransferRole::kReceiver, acceptData, initiatingSender, initOptions);
+    EXPECT_EQ(ReadAndVerifyTLVString(outEvent.transferAcceptData.Metadata,
+                                     static_cast<uint32_t>(outEvent.transferAcceptData.MetadataLength), metadataStr,
+                                     strlen(metadataStr)),
+              CHIP_NO_ERROR);
+    EXPECT_TRUE(initiatingSender.IsWindowed());
+    EXPECT_TRUE(respondingReceiver.IsWindowed());
+    EXPECT_EQ(initiatingSender.GetWindowSize(), windowSize);
+    EXPECT_EQ(respondingReceiver.GetWindowSize(), windowSize);
+
+    // Fill the window without waiting for any BlockAck
+    uint32_t numBlocksSent = 0;
+    for (; numBlocksSent < windowSize; numBlocksSent++)
+    {
+        SendAndVerifyArbitraryBlock(initiatingSender, respondingReceiver, outEvent, false, numBlocksSent);
+    }
+    EXPECT_EQ(initiatingSender.GetNumBlocksInFlight(), static_cast<uint32_t>(windowSize));
+
+    // No more Blocks until some are acknowledged
+    uint8_t fakeData[10] = { 0 };
+    TransferSession::BlockData blockData;
+    blockData.Data   = fakeData;
+    blockData.Length = sizeof(fakeData);
+    err              = initiatingSender.PrepareBlock(blockData);
+    EXPECT_EQ(err, CHIP_ERROR_INCORRECT_STATE);
+    VerifyNoMoreOutput(initiatingSender);
+
+    // A single BlockAck acknowledges every Block received so far
+    SendAndVerifyBlockAck(initiatingSender, respondingReceiver, outEvent, false);
+    EXPECT_EQ(initiatingSender.GetNumBlocksInFlight(), 0u);
+
+    SendAndVerifyArbitraryBlock(initiatingSender, respondingReceiver, outEvent, false, numBlocksSent++);
+    SendAndVerifyArbitraryBlock(initiatingSender, respondingReceiver, outEvent, true, numBlocksSent++);
+    SendAndVerifyBlockAck(initiatingSender, respondingReceiver, outEvent, true);
+    EXPECT_EQ(initiatingSender.GetNumBlocksInFlight(), 0u);
+}
+
+// Test that the windowed extension falls back to plain Sender Drive when the peer does not support it.
+TEST_F(TestBdxTransferSession, TestWindowedFallback)
+{
+    CHIP_ERROR err = CHIP_NO_ERROR;
+    TransferSession::OutputEvent outEvent;
+    TransferSession initiatingSender;
+    TransferSession respondingReceiver;
+
+    TransferControlFlags driveMode = TransferControlFlags::kSenderDrive;
+    uint16_t transferBlockSize     = 10;
+    System::Clock::Timeout timeout = System::Clock::Seconds16(24);
+
+    BitFlags<TransferControlFlags> receiverOpts;
+    receiverOpts.Set(driveMode);
+
+    TransferSession::TransferInitData initOptions;
+    initOptions.TransferCtlFlags = driveMode;
+    initOptions.MaxBlockSize     = transferBlockSize;
+    initOptions.WindowSize       = 4;
+    char testFileDes[9]          = { "test.txt" };
+    initOptions.FileDesLength    = static_cast<uint16_t>(strlen(testFileDes));
+    initOptions.FileDesignator   = reinterpret_cast<uint8_t *>(testFileDes);
+
+    // The receiver does not support the windowed extension
+    SendAndVerifyTransferInit(outEvent, timeout, initiatingSender, TransferRole::kSender, initOptions, respondingReceiver,
+                              receiverOpts, transferBlockSize);
+
+    TransferSession::TransferAcceptData acceptData;
+    acceptData.ControlMode  = respondingReceiver.GetControlMode();
+    acceptData.MaxBlockSize = transferBlockSize;
+
+    SendAndVerifyAcceptMsg(outEvent, respondingReceiver, TransferRole::kReceiver, acceptData, initiatingSender, initOptions);
+    EXPECT_FALSE(initiatingSender.IsWindowed());
+    EXPECT_FALSE(respondingReceiver.IsWindowed());
+    EXPECT_EQ(initiatingSender.GetWindowSize(), 1);
+
+    // Only one Block may be in flight
+    SendAndVerifyArbitraryBlock(initiatingSender, respondingReceiver, outEvent, false, 0);
+
+    uint8_t fakeData[10] = { 0 };
+    TransferSession::BlockData blockData;
+    blockData.Data   = fakeData;
+    blockData.Length = sizeof(fakeData);
+    err              = initiatingSender.PrepareBlock(blockData);
+    EXPECT_EQ(err, CHIP_ERROR_INCORRECT_STATE);
+
+    SendAndVerifyBlockAck(initiatingSender, respondingReceiver, outEvent, false);
+    SendAndVerifyArbitraryBlock(initiatingSender, respondingReceiver, outEvent, true, 1);
+    SendAndVerifyBlockAck(initiatingSender, respondingReceiver, outEvent, true);
+}
+
+// Test that the window size is proposed in a vendor-specific element appended to the Metadata, not in the transfer control flags.
+TEST_F(TestBdxTransferSession, TestWindowSizeMetadata)
+{
+    TransferSession::OutputEvent outEvent;
+    TransferSession initiatingSender;
+
+    uint8_t tlvBuf[64]    = { 0 };
+    char metadataStr[11]  = { "hi_dad.txt" };
+    uint32_t bytesWritten = 0;
+    EXPECT_EQ(WriteTLVString(tlvBuf, sizeof(tlvBuf), metadataStr, bytesWritten), CHIP_NO_ERROR);
+
+    TransferSession::TransferInitData initOptions;
+    initOptions.TransferCtlFlags = TransferControlFlags::kSenderDrive;
+    initOptions.MaxBlockSize     = 10;
+    initOptions.WindowSize       = 4;
+    char testFileDes[9]          = { "test.txt" };
+    initOptions.FileDesLength    = static_cast<uint16_t>(strlen(testFileDes));
+    initOptions.FileDesignator   = reinterpret_cast<uint8_t *>(testFileDes);
+    initOptions.Metadata         = tlvBuf;
+    initOptions.MetadataLength   = bytesWritten;
+
+    EXPECT_EQ(initiatingSender.StartTransfer(TransferRole::kSender, initOptions, System::Clock::Seconds16(24)), CHIP_NO_ERROR);
+    initiatingSender.PollOutput(outEvent, kNoAdvanceTime);
+    VerifyBdxMessageToSend(outEvent, MessageType::SendInit);
+
+    // What a peer without the extension sees
+    TransferInit initMsg;
+    ASSERT_EQ(initMsg.Parse(std::move(outEvent.MsgData)), CHIP_NO_ERROR);
+    EXPECT_EQ(initMsg.TransferCtlOptions.Raw(), BitFlags<TransferControlFlags>(TransferControlFlags::kSenderDrive).Raw());
+    ASSERT_GT(initMsg.MetadataLength, static_cast<size_t>(bytesWritten));
+    EXPECT_EQ(0, memcmp(initMsg.Metadata, tlvBuf, bytesWritten));
+
+    TLV::TLVReader reader;
+    uint8_t windowSize = 0;
+    reader.Init(initMsg.Metadata + bytesWritten, initMsg.MetadataLength - bytesWritten);
+    ASSERT_EQ(reader.Next(), CHIP_NO_ERROR);
+    EXPECT_EQ(reader.GetTag(), kWindowSizeMetadataTag);
+    EXPECT_EQ(reader.Get(windowSize), CHIP_NO_ERROR);
+    EXPECT_EQ(windowSize, 4);
+    EXPECT_EQ(reader.Next(), CHIP_END_OF_TLV);
+}
+
+namespace {
+
+// Simulated link between two TransferSessions: every message takes half of the round trip time to arrive.
+struct SimulatedLink
+{
+    struct InFlightMessage
+    {
+        System::Clock::Timestamp deliveryTime;
+        TransferSession::MessageTypeData typeData;
+        System::PacketBufferHandle msg;
+    };
+
+    System::Clock::Milliseconds64 oneWayDelay;
+    std::deque<InFlightMessage> toReceiver;
+    std::deque<InFlightMessage> toSender;
+};
+
+// Send every message a TransferSession has pending over the link, returning the last non-message event.
+TransferSession::OutputEvent DrainOutput(TransferSession & session, std::deque<SimulatedLink::InFlightMessage> & link,
+                                         System::Clock::Timestamp now, System::Clock::Milliseconds64 oneWayDelay)
+{
+    TransferSession::OutputEvent event;
+    while (true)
+    {
+        session.PollOutput(event, now);
+        if (event.EventType != TransferSession::OutputEventType::kMsgToSend)
+        {
+            return event;
+        }
+        link.push_back({ now + oneWayDelay, event.msgTypeData, std::move(event.MsgData) });
+    }
+}
+
+// Transfer `length` bytes from a sender to a receiver in Sender Drive, returning the simulated time it took.
+System::Clock::Milliseconds64 SimulateTransfer(uint64_t length, uint16_t blockSize, uint8_t windowSize,
+                                               System::Clock::Milliseconds64 rtt)
+{
+    static uint8_t blockBuffer[1024];
+
+    TransferSession sender;
+    TransferSession receiver;
+    TransferSession::OutputEvent event;
+    SimulatedLink link{ rtt / 2, {}, {} };
+    System::Clock::Timestamp now   = System::Clock::kZero;
+    System::Clock::Timeout timeout = System::Clock::Seconds16(60);
+
+    VerifyOrDie(blockSize <= sizeof(blockBuffer));
+
+    // Negotiate the transfer right away, only the Blocks are timed
+    BitFlags<TransferControlFlags> receiverOpts(TransferControlFlags::kSenderDrive);
+    EXPECT_EQ(receiver.WaitForTransfer(TransferRole::kReceiver, receiverOpts, blockSize, timeout, windowSize), CHIP_NO_ERROR);
+
+    TransferSession::TransferInitData initOptions;
+    initOptions.TransferCtlFlags = TransferControlFlags::kSenderDrive;
+    initOptions.MaxBlockSize     = blockSize;
+    initOptions.Length           = length;
+    initOptions.WindowSize       = windowSize;
+    char testFileDes[9]          = { "test.bin" };
+    initOptions.FileDesLength    = static_cast<uint16_t>(strlen(testFileDes));
+    initOptions.FileDesignator   = reinterpret_cast<uint8_t *>(testFileDes);
+    EXPECT_EQ(sender.StartTransfer(TransferRole::kSender, initOptions, timeout), CHIP_NO_ERROR);
+
+    sender.PollOutput(event, now);
+    EXPECT_EQ(AttachHeaderAndSend(event.msgTypeData, std::move(event.MsgData), receiver), CHIP_NO_ERROR);
+    receiver.PollOutput(event, now);
+    EXPECT_EQ(event.EventType, TransferSession::OutputEventType::kInitReceived);
+
+    TransferSession::TransferAcceptData acceptData;
+    acceptData.ControlMode  = TransferControlFlags::kSenderDrive;
+    acceptData.MaxBlockSize = blockSize;
+    EXPECT_EQ(receiver.AcceptTransfer(acceptData), CHIP_NO_ERROR);
+    receiver.PollOutput(event, now);
+    EXPECT_EQ(AttachHeaderAndSend(event.msgTypeData, std::move(event.MsgData), sender), CHIP_NO_ERROR);
+    sender.PollOutput(event, now);
+    EXPECT_EQ(event.EventType, TransferSession::OutputEventType::kAcceptReceived);
+
+    uint64_t bytesSent = 0;
+    bool done          = false;
+    while (!done)
+    {
+        // The sender keeps its window full
+        while (bytesSent < length && sender.GetNumBlocksInFlight() < sender.GetWindowSize())
+        {
+            TransferSession::BlockData blockData;
+            blockData.Data   = blockBuffer;
+            blockData.Length = static_cast<size_t>(std::min<uint64_t>(blockSize, length - bytesSent));
+            blockData.IsEof  = (bytesSent + blockData.Length == length);
+            VerifyOrReturnValue(sender.PrepareBlock(blockData) == CHIP_NO_ERROR, System::Clock::Milliseconds64(0));
+            bytesSent += blockData.Length;
+            DrainOutput(sender, link.toReceiver, now, link.oneWayDelay);
+        }
+
+        // Deliver the next message to arrive, in either direction
+        bool toReceiver = !link.toReceiver.empty() &&
+            (link.toSender.empty() || link.toReceiver.front().deliveryTime <= link.toSender.front().deliveryTime);
+        auto & queue = toReceiver ? link.toReceiver : link.toSender;
+        VerifyOrReturnValue(!queue.empty(), System::Clock::Milliseconds64(0));
+
+        SimulatedLink::InFlightMessage message = std::move(queue.front());
+        queue.pop_front();
+        now = message.deliveryTime;
+
+        PayloadHeader payloadHeader;
+        payloadHeader.SetMessageType(message.typeData.ProtocolId, message.typeData.MessageType);
+
+        if (toReceiver)
+        {
+            VerifyOrReturnValue(receiver.HandleMessageReceived(payloadHeader, std::move(message.msg), now) == CHIP_NO_ERROR,
+                                System::Clock::Milliseconds64(0));
+            receiver.PollOutput(event, now);
+            VerifyOrReturnValue(event.EventType == TransferSession::OutputEventType::kBlockReceived,
+                                System::Clock::Milliseconds64(0));
+            EXPECT_EQ(receiver.PrepareBlockAck(), CHIP_NO_ERROR);
+            DrainOutput(receiver, link.toSender, now, link.oneWayDelay);
+        }
+        else
+        {
+            VerifyOrReturnValue(sender.HandleMessageReceived(payloadHeader, std::move(message.msg), now) == CHIP_NO_ERROR,
+                                System::Clock::Milliseconds64(0));
+            event = DrainOutput(sender, link.toReceiver, now, link.oneWayDelay);
+            VerifyOrReturnValue(event.EventType == TransferSession::OutputEventType::kAckReceived ||
+                                    event.EventType == TransferSession::OutputEventType::kAckEOFReceived,
+                                System::Clock::Milliseconds64(0));
+            done = (event.EventType == TransferSession::OutputEventType::kAckEOFReceived);
+        }
+    }
+
+    EXPECT_EQ(receiver.GetNumBytesProcessed(), length);
+    return now;
+}
+
+} // namespace
+
+// Loopback throughput of a 10 MB image, one Block per round trip versus a window of Blocks in flight.
+TEST_F(TestBdxTransferSession, TestWindowedThroughput)
+{
+    constexpr uint64_t kImageSize = 10 * 1024 * 1024;
+    constexpr uint16_t kBlockSize = 1024;
+    constexpr uint8_t kWindowSize = 8;
+    constexpr uint32_t kRttsMs[]  = { 10, 100, 300 };
+
+    for (uint32_t rttMs : kRttsMs)
+    {
+        const System::Clock::Milliseconds64 rtt(rttMs);
+        const System::Clock::Milliseconds64 stopAndWait = SimulateTransfer(kImageSize, kBlockSize, 1, rtt);
+        const System::Clock::Milliseconds64 windowed    = SimulateTransfer(kImageSize, kBlockSize, kWindowSize, rtt);
+
+        ASSERT_GT(stopAndWait.count(), 0u);
+        ASSERT_GT(windowed.count(), 0u);
+        ChipLogProgress(BDX, "RTT %u ms: stop-and-wait %u kB/s, window of %u: %u kB/s", static_cast<unsigned>(rttMs),
+                        static_cast<unsigned>(kImageSize / stopAndWait.count()), static_cast<unsigned>(kWindowSize),
+                        static_cast<unsigned>(kImageSize / windowed.count()));
+
+        // Every round trip carries a full window of Blocks instead of a single one.
+        EXPECT_LE(windowed.count() * kWindowSize, stopAndWait.count() + rtt.count() * kWindowSize);
+    }
+}
@@ -42,6 +42,7 @@
 #include <protocols/Protocols.h>
 #include <protocols/secure_channel/CASEDestinationId.h>
 #include <protocols/secure_channel/PairingSession.h>
+#include <protocols/secure_channel/PairingSessionWorkHelper.h>
 #include <protocols/secure_channel/SessionResumptionStorage.h>
 #include <protocols/secure_channel/StatusReport.h>
 #include <system/SystemClock.h>
@@ -132,205 +133,6 @@ static constexpr ExchangeContext::Timeout kExpectedLowProcessingTime    = System
 static constexpr ExchangeContext::Timeout kExpectedSigma1ProcessingTime = kExpectedLowProcessingTime;
 static constexpr ExchangeContext::Timeout kExpectedHighProcessingTime   = System::Clock::Seconds16(30);
 
-// Helper for managing a session's outstanding work.
-// Holds work data which is provided to a scheduled work callback (standalone),
-// then (if not canceled) to a scheduled after work callback (on the session).
-template <class DATA>
-class CASESession::WorkHelper
-{
-public:
-    // Work callback, processed in the background via `PlatformManager::ScheduleBackgroundWork`.
-    // This is a non-member function which does not use the associated session.
-    // The return value is passed to the after work callback (called afterward).
-    // Set `cancel` to true if calling the after work callback is not necessary.
-    typedef CHIP_ERROR (*WorkCallback)(DATA & data, bool & cancel);
-
-    // After work callback, processed in the main Matter task via `PlatformManager::ScheduleWork`.
-    // This is a member function to be called on the associated session after the work callback.
-    // The `status` value is the result of the work callback (called beforehand), or the status of
-    // queueing the after work callback back to the Matter thread, if the work callback succeeds
-    // but queueing fails.
-    //
-    // When this callback is called asynchronously (i.e. via ScheduleWork), the helper guarantees
-    // that it will keep itself (and hence `data`) alive until the callback completes.
-    typedef CHIP_ERROR (CASESession::*AfterWorkCallback)(DATA & data, CHIP_ERROR status);
-
-public:
-    // Create a work helper using the specified session, work callback, after work callback, and data (template arg).
-    // Lifetime is managed by sharing between the caller (typically the session) and the helper itself (while work is scheduled).
-    static Platform::SharedPtr<WorkHelper> Create(CASESession & session, WorkCallback workCallback,
-                                                  AfterWorkCallback afterWorkCallback)
-    {
-        struct EnableShared : public WorkHelper
-        {
-            EnableShared(CASESession & session, WorkCallback workCallback, AfterWorkCallback afterWorkCallback) :
-                WorkHelper(session, workCallback, afterWorkCallback)
-            {}
-        };
-        auto ptr = Platform::MakeShared<EnableShared>(session, workCallback, afterWorkCallback);
-        if (ptr)
-        {
-            ptr->mWeakPtr = ptr; // used by `ScheduleWork`
-        }
-        return ptr;
-    }
-
-    // Do the work immediately.
-    // No scheduling, no outstanding work, no shared lifetime management.
-    //
-    // The caller must guarantee that it keeps the helper alive across this call, most likely by
-    // holding a reference to it on the stack.
-    CHIP_ERROR DoWork()
-    {
-        // Ensure that this function is being called from main Matter thread
-        assertChipStackLockedByCurrentThread();
-
-        VerifyOrReturnError(mSession && mWorkCallback && mAfterWorkCallback, CHIP_ERROR_INCORRECT_STATE);
-        auto * helper   = this;
-        bool cancel     = false;
-        helper->mStatus = helper->mWorkCallback(helper->mData, cancel);
-        if (!cancel)
-        {
-            helper->mStatus = (helper->mSession->*(helper->mAfterWorkCallback))(helper->mData, helper->mStatus);
-        }
-        return helper->mStatus;
-    }
-
-    // Schedule the work for later execution.
-    // If lifetime is managed, the helper shares management while work is outstanding.
-    CHIP_ERROR ScheduleWork()
-    {
-        VerifyOrReturnError(mSession && mWorkCallback && mAfterWorkCallback, CHIP_ERROR_INCORRECT_STATE);
-        // Hold strong ptr while work is outstanding
-        mStrongPtr  = mWeakPtr.lock(); // set in `Create`
-        auto status = DeviceLayer::PlatformMgr().ScheduleBackgroundWork(WorkHandler, reinterpret_cast<intptr_t>(this));
-        if (status != CHIP_NO_ERROR)
-        {
-            // Release strong ptr since scheduling failed.
-            mStrongPtr.reset();
-        }
-        return status;
-    }
-
-    // Cancel the work, by clearing the associated session.
-    void CancelWork() { mSession.store(nullptr); }
-
-    bool IsCancelled() const { return mSession.load() == nullptr; }
-
-    // This API returns true when background thread fails to schedule the AfterWorkCallback
-    bool UnableToScheduleAfterWorkCallback() { return mScheduleAfterWorkFailed.load(); }
-
-    // Do after work immediately.
-    // No scheduling, no outstanding work, no shared lifetime management.
-    void DoAfterWork()
-    {
-        VerifyOrDie(UnableToScheduleAfterWorkCallback());
-        AfterWorkHandler(reinterpret_cast<intptr_t>(this));
-    }
-
-private:
-    // Create a work helper using the specified session, work callback, after work callback, and data (template arg).
-    // Lifetime is not managed, see `Create` for that option.
-    WorkHelper(CASESession & session, WorkCallback workCallback, AfterWorkCallback afterWorkCallback) :
-        mSession(&session), mWorkCallback(workCallback), mAfterWorkCallback(afterWorkCallback)
-    {}
-
-    // Handler for the work callback.
-    static void WorkHandler(intptr_t arg)
-    {
-        auto * helper = reinterpret_cast<WorkHelper *>(arg);
-        // Hold strong ptr while work is handled
-        auto strongPtr(std::move(helper->mStrongPtr));
-        VerifyOrReturn(!helper->IsCancelled());
-        bool cancel = false;
-        // Execute callback in background thread; data must be OK with this
-        helper->mStatus = helper->mWorkCallback(helper->mData, cancel);
-        VerifyOrReturn(!cancel && !helper->IsCancelled());
-        // Hold strong ptr to ourselves while work is outstanding
-        helper->mStrongPtr.swap(strongPtr);
-        auto status = DeviceLayer::PlatformMgr().ScheduleWork(AfterWorkHandler, reinterpret_cast<intptr_t>(helper));
-        if (status != CHIP_NO_ERROR)
-        {
-            ChipLogError(SecureChannel, "Failed to Schedule the AfterWorkCallback on foreground thread: %" CHIP_ERROR_FORMAT,
-                         status.Format());
-
-            // We failed to schedule after work callback, so setting mScheduleAfterWorkFailed flag to true
-            // This can be checked from foreground thread and after work callback can be retried
-            helper->mStatus = status;
-
-            // Release strong ptr to self since scheduling failed, because nothing guarantees
-            // that AfterWorkHandler will get called at this point to release the reference,
-            // and we don't want to leak.  That said, we want to ensure that "helper" stays
-            // alive through the end of this function (so we can set mScheduleAfterWorkFailed
-            // on it), but also want to avoid racing on the single SharedPtr instance in
-            // helper->mStrongPtr.  That means we need to not touch helper->mStrongPtr after
-            // writing to mScheduleAfterWorkFailed.
-            //
-            // The simplest way to do this is to move the reference in helper->mStrongPtr to
-            // our stack, where it outlives all our accesses to "helper".
-            strongPtr.swap(helper->mStrongPtr);
-
-            // helper and any of its state should not be touched after storing mScheduleAfterWorkFailed.
-            helper->mScheduleAfterWorkFailed.store(true);
-        }
-    }
-
-    // Handler for the after work callback.
-    static void AfterWorkHandler(intptr_t arg)
-    {
-        // Ensure that this function is being called from main Matter thread
-        assertChipStackLockedByCurrentThread();
-
-        auto * helper = reinterpret_cast<WorkHelper *>(arg);
-        // Hold strong ptr while work is handled, and ensure that helper->mStrongPtr does not keep
-        // holding a reference.
-        auto strongPtr(std::move(helper->mStrongPtr));
-        if (!strongPtr)
-        {
-            // This can happen if scheduling AfterWorkHandler failed.  Just grab a strong ref
-            // to handler directly, to fulfill our API contract of holding a strong reference
-            // across the after-work callback.  At this point, we are guaranteed that the
-            // background thread is not touching the helper anymore.
-            strongPtr = helper->mWeakPtr.lock();
-        }
-        if (auto * session = helper->mSession.load())
-        {
-            // Execute callback in Matter thread; session should be OK with this
-            (session->*(helper->mAfterWorkCallback))(helper->mData, helper->mStatus);
-        }
-    }
-
-private:
-    // Lifetime management: `ScheduleWork` sets `mStrongPtr` from `mWeakPtr`.
-    Platform::WeakPtr<WorkHelper> mWeakPtr;
-
-    // Lifetime management: `ScheduleWork` sets `mStrongPtr` from `mWeakPtr`.
-    Platform::SharedPtr<WorkHelper> mStrongPtr;
-
-    // Associated session, cleared by `CancelWork`.
-    std::atomic<CASESession *> mSession;
-
-    // Work callback, called by `WorkHandler`.
-    WorkCallback mWorkCallback;
-
-    // After work callback, called by `AfterWorkHandler`.
-    AfterWorkCallback mAfterWorkCallback;
-
-    // Return value of `mWorkCallback`, passed to `mAfterWorkCallback`.
-    CHIP_ERROR mStatus;
-
-    // If background thread fails to schedule AfterWorkCallback then this flag is set to true
-    // and CASEServer then can check this one and run the AfterWorkCallback for us.
-    //
-    // When this happens, the write to this boolean _must_ be the last code that touches this
-    // object on the background thread.  After that, the Matter thread owns the object.
-    std::atomic<bool> mScheduleAfterWorkFailed{ false };
-
-public:
-    // Data passed to `mWorkCallback` and `mAfterWorkCallback`.
-    DATA mData;
-};
-
 struct CASESession::SendSigma3Data
 {
     FabricIndex fabricIndex;
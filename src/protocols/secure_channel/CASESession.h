@@ -50,6 +50,9 @@
 
 namespace chip {
 
+template <class SESSION, class DATA>
+class PairingSessionWorkHelper;
+
 // TODO: temporary derive from Messaging::UnsolicitedMessageHandler, actually the CASEServer should be the umh, it will be fixed
 // when implementing concurrent CASE session.
 class DLL_EXPORT CASESession : public Messaging::UnsolicitedMessageHandler,
@@ -331,7 +334,7 @@ private:
     uint8_t mInitiatorRandom[kSigmaParamRandomNumberSize];
 
     template <class DATA>
-    class WorkHelper;
+    using WorkHelper = PairingSessionWorkHelper<CASESession, DATA>;
     Platform::SharedPtr<WorkHelper<SendSigma3Data>> mSendSigma3Helper;
     Platform::SharedPtr<WorkHelper<HandleSigma3Data>> mHandleSigma3Helper;
 
@@ -42,12 +42,17 @@
 #include <messaging/SessionParameters.h>
 #include <protocols/Protocols.h>
 #include <protocols/secure_channel/Constants.h>
+#include <protocols/secure_channel/PairingSessionWorkHelper.h>
 #include <protocols/secure_channel/StatusReport.h>
 #include <setup_payload/SetupPayload.h>
+#include <system/SystemClock.h>
 #include <system/TLVPacketBufferBackingStore.h>
 #include <tracing/macros.h>
+#include <tracing/metric_event.h>
 #include <transport/SessionManager.h>
 
+#include <algorithm>
+
 namespace chip {
 
 using namespace Crypto;
@@ -68,6 +73,115 @@ const char kSpake2pR2ISessionInfo[] = "Commissioning R2I Key";
 static constexpr ExchangeContext::Timeout kExpectedLowProcessingTime  = System::Clock::Seconds16(2);
 static constexpr ExchangeContext::Timeout kExpectedHighProcessingTime = System::Clock::Seconds16(30);
 
+namespace {
+
+// How long w0s/w1s derived by a pairing attempt may be reused by further attempts of the same pairing.
+constexpr System::Clock::Seconds16 kDerivedWSLifetime = System::Clock::Seconds16(60);
+
+// How often to check whether deriving w0s/w1s in the background failed to hand its result back.
+constexpr System::Clock::Milliseconds32 kDeriveWSWatchdogInterval = System::Clock::Milliseconds32(500);
+
+// w0s/w1s derived by the last commissioner-side pairing attempt.
+//
+// Attempts that are started in parallel or retried for the same commissionee (e.g. over BLE and
+// over IP by SetUpCodePairer) use the same passcode, salt and iteration count, so they reuse the
+// result instead of running PBKDF2 again.  Wiped by a timer kDerivedWSLifetime after it was
+// derived, and when a pairing that derived or reused it completes or fails.  Only accessed from
+// the Matter thread.
+struct DerivedWS
+{
+    bool valid;
+    System::Layer * systemLayer;
+    uint32_t setupPINCode;
+    uint32_t iterationCount;
+    uint8_t salt[kSpake2p_Max_PBKDF_Salt_Length];
+    size_t saltLength;
+    uint8_t serializedWS[kSpake2p_WS_Length * 2];
+};
+
+DerivedWS sDerivedWS;
+
+void OnDerivedWSExpired(System::Layer * systemLayer, void * appState);
+
+void ClearDerivedWS()
+{
+    if (sDerivedWS.systemLayer != nullptr)
+    {
+        sDerivedWS.systemLayer->CancelTimer(OnDerivedWSExpired, nullptr);
+    }
+    ClearSecretData(reinterpret_cast<uint8_t *>(&sDerivedWS), sizeof(sDerivedWS));
+}
+
+void OnDerivedWSExpired(System::Layer * systemLayer, void * appState)
+{
+    ClearDerivedWS();
+}
+
+bool FindDerivedWS(uint32_t setupPINCode, uint32_t iterationCount, const ByteSpan & salt, uint8_t * serializedWS)
+{
+    VerifyOrReturnValue(sDerivedWS.valid, false);
+    VerifyOrReturnValue(sDerivedWS.setupPINCode == setupPINCode && sDerivedWS.iterationCount == iterationCount, false);
+    VerifyOrReturnValue(salt.data_equal(ByteSpan(sDerivedWS.salt, sDerivedWS.saltLength)), false);
+
+    memcpy(serializedWS, sDerivedWS.serializedWS, sizeof(sDerivedWS.serializedWS));
+    return true;
+}
+
+bool StoreDerivedWS(System::Layer & systemLayer, uint32_t setupPINCode, uint32_t iterationCount, const ByteSpan & salt,
+                    const uint8_t * serializedWS)
+{
+    ClearDerivedWS();
+    VerifyOrReturnValue(salt.size() <= sizeof(sDerivedWS.salt), false);
+
+    // Without the expiry timer the values would outlive the pairing, so they are not kept at all.
+    VerifyOrReturnValue(CHIP_NO_ERROR == systemLayer.StartTimer(kDerivedWSLifetime, OnDerivedWSExpired, nullptr), false);
+
+    sDerivedWS.systemLayer    = &systemLayer;
+    sDerivedWS.setupPINCode   = setupPINCode;
+    sDerivedWS.iterationCount = iterationCount;
+    sDerivedWS.saltLength     = salt.size();
+    memcpy(sDerivedWS.salt, salt.data(), salt.size());
+    memcpy(sDerivedWS.serializedWS, serializedWS, sizeof(sDerivedWS.serializedWS));
+    sDerivedWS.valid = true;
+    return true;
+}
+
+// Reports the time spent on the Matter thread within the scope, i.e. how long a PASE step stalled the event loop.
+class ScopedEventLoopTimeMetric
+{
+public:
+    ScopedEventLoopTimeMetric() : mStart(System::SystemClock().GetMonotonicMicroseconds64()) {}
+
+    ~ScopedEventLoopTimeMetric()
+    {
+        const System::Clock::Microseconds64 elapsed = System::SystemClock().GetMonotonicMicroseconds64() - mStart;
+        MATTER_LOG_METRIC(Tracing::kMetricPASESessionEventLoopTime,
+                          static_cast<uint32_t>(std::min<uint64_t>(elapsed.count(), UINT32_MAX)));
+        IgnoreUnusedVariable(elapsed);
+    }
+
+private:
+    const System::Clock::Microseconds64 mStart;
+};
+
+} // namespace
+
+// Data for deriving w0s/w1s from the passcode in the background.
+struct PASESession::DeriveWSData
+{
+    ~DeriveWSData()
+    {
+        setupPINCode = 0;
+        ClearSecretData(serializedWS);
+    }
+
+    uint32_t setupPINCode;
+    uint32_t iterationCount;
+    uint8_t salt[kSpake2p_Max_PBKDF_Salt_Length];
+    size_t saltLength;
+    uint8_t serializedWS[kSpake2p_WS_Length * 2];
+};
+
 PASESession::~PASESession()
 {
     // Let's clear out any security state stored in the object, before destroying it.
@@ -83,6 +197,12 @@ void PASESession::OnSessionReleased()
 
 void PASESession::Finish()
 {
+    if (mRole == CryptoContext::SessionRole::kInitiator)
+    {
+        // The pairing is done, further attempts are not going to need the derived w0s/w1s.
+        ClearDerivedWS();
+    }
+
     mPairingComplete = true;
     PairingSession::Finish();
 }
@@ -95,6 +215,20 @@ void PASESession::Clear()
     memset(&mPASEVerifier, 0, sizeof(mPASEVerifier));
     mNextExpectedMsg.ClearValue();
 
+    if (mDeriveWSHelper)
+    {
+        mSessionManager->SystemLayer()->CancelTimer(OnDeriveWSWatchdog, this);
+        mDeriveWSHelper->CancelWork();
+        mDeriveWSHelper.reset();
+    }
+
+    if (mUsesDerivedWS)
+    {
+        // The pairing that derived or reused w0s/w1s is over, so they are not needed anymore.
+        ClearDerivedWS();
+        mUsesDerivedWS = false;
+    }
+
     mSpake2p.Clear();
     mCommissioningHash.Clear();
 
@@ -453,7 +587,6 @@ CHIP_ERROR PASESession::HandlePBKDFParamResponse(System::PacketBufferHandle && m
 
     uint32_t decodeTagIdSeq = 0;
     ByteSpan salt;
-    uint8_t serializedWS[kSpake2p_WS_Length * 2] = { 0 };
 
     ChipLogDetail(SecureChannel, "Received PBKDF param response");
 
@@ -520,24 +653,105 @@ CHIP_ERROR PASESession::HandlePBKDFParamResponse(System::PacketBufferHandle && m
     err = SetupSpake2p();
     SuccessOrExit(err);
 
-    err = Spake2pVerifier::ComputeWS(mIterationCount, salt, mSetupPINCode, serializedWS, sizeof(serializedWS));
-    SuccessOrExit(err);
+    {
+        auto helper = WorkHelper<DeriveWSData>::Create(*this, &DeriveWS, &PASESession::OnWSDerived);
+        VerifyOrExit(helper, err = CHIP_ERROR_NO_MEMORY);
 
-    err = mSpake2p.BeginProver(nullptr, 0, nullptr, 0, &serializedWS[0], kSpake2p_WS_Length, &serializedWS[kSpake2p_WS_Length],
-                               kSpake2p_WS_Length);
-    SuccessOrExit(err);
+        auto & data = helper->mData;
+        VerifyOrExit(salt.size() <= sizeof(data.salt), err = CHIP_ERROR_INVALID_PASE_PARAMETER);
+        data.setupPINCode   = mSetupPINCode;
+        data.iterationCount = mIterationCount;
+        data.saltLength     = salt.size();
+        memcpy(data.salt, salt.data(), salt.size());
+
+        if (FindDerivedWS(data.setupPINCode, data.iterationCount, salt, data.serializedWS))
+        {
+            ChipLogDetail(SecureChannel, "Reusing w0s/w1s derived by a previous attempt of this pairing");
+            mUsesDerivedWS = true;
+            SuccessOrExit(err = BeginProverAndSendMsg1(data));
+        }
+        else
+        {
+            // PBKDF2 with up to kSpake2p_Max_PBKDF_Iterations would stall the Matter thread, so
+            // run it in the background and continue the handshake in OnWSDerived.
+            SuccessOrExit(err = helper->ScheduleWork());
+            mDeriveWSHelper = helper;
+            SuccessOrExit(err = mSessionManager->SystemLayer()->StartTimer(kDeriveWSWatchdogInterval, OnDeriveWSWatchdog, this));
+            mExchangeCtxt.Value()->WillSendMessage();
+            mNextExpectedMsg.ClearValue();
+        }
+    }
+
+exit:
+    if (err != CHIP_NO_ERROR)
+    {
+        SendStatusReport(mExchangeCtxt, kProtocolCodeInvalidParam);
+    }
+    return err;
+}
+
+CHIP_ERROR PASESession::DeriveWS(DeriveWSData & data, bool & cancel)
+{
+    // Executes in the background, so only uses the copy of the parameters in data.
+    return Spake2pVerifier::ComputeWS(data.iterationCount, ByteSpan(data.salt, data.saltLength), data.setupPINCode,
+                                      data.serializedWS, sizeof(data.serializedWS));
+}
 
-    err = SendMsg1();
+CHIP_ERROR PASESession::OnWSDerived(DeriveWSData & data, CHIP_ERROR status)
+{
+    MATTER_TRACE_SCOPE("OnWSDerived", "PASESession");
+    ScopedEventLoopTimeMetric eventLoopTimeMetric;
+
+    CHIP_ERROR err = status;
     SuccessOrExit(err);
 
+    mUsesDerivedWS = StoreDerivedWS(*mSessionManager->SystemLayer(), data.setupPINCode, data.iterationCount,
+                                    ByteSpan(data.salt, data.saltLength), data.serializedWS);
+    err = BeginProverAndSendMsg1(data);
+
 exit:
+    mSessionManager->SystemLayer()->CancelTimer(OnDeriveWSWatchdog, this);
+    mDeriveWSHelper.reset();
+
+    // This runs after HandlePBKDFParamResponse returned, so do what it and OnMessageReceived would
+    // have done on error: send a status report, discard the exchange and abort the pairing.
     if (err != CHIP_NO_ERROR)
     {
         SendStatusReport(mExchangeCtxt, kProtocolCodeInvalidParam);
+        DiscardExchange();
+        Clear();
+        ChipLogError(SecureChannel, "Failed during PASE session setup: %" CHIP_ERROR_FORMAT, err.Format());
+        MATTER_TRACE_COUNTER("PASEFail");
+        // Do this last in case the delegate frees us.
+        NotifySessionEstablishmentError(err);
     }
     return err;
 }
 
+void PASESession::OnDeriveWSWatchdog(System::Layer * layer, void * appState)
+{
+    auto * session = static_cast<PASESession *>(appState);
+    VerifyOrReturn(session->mDeriveWSHelper);
+
+    if (session->mDeriveWSHelper->UnableToScheduleAfterWorkCallback())
+    {
+        // Nothing else would ever call OnWSDerived, so call it here with the scheduling error,
+        // which aborts the pairing and notifies the delegate.
+        ChipLogError(SecureChannel, "DeriveWSHelper was unable to schedule the AfterWorkCallback");
+        session->mDeriveWSHelper->DoAfterWork();
+        return;
+    }
+
+    LogErrorOnFailure(layer->StartTimer(kDeriveWSWatchdogInterval, OnDeriveWSWatchdog, appState));
+}
+
+CHIP_ERROR PASESession::BeginProverAndSendMsg1(const DeriveWSData & data)
+{
+    ReturnErrorOnFailure(mSpake2p.BeginProver(nullptr, 0, nullptr, 0, &data.serializedWS[0], kSpake2p_WS_Length,
+                                              &data.serializedWS[kSpake2p_WS_Length], kSpake2p_WS_Length));
+    return SendMsg1();
+}
+
 CHIP_ERROR PASESession::SendMsg1()
 {
     MATTER_TRACE_SCOPE("SendMsg1", "PASESession");
@@ -832,6 +1046,8 @@ CHIP_ERROR PASESession::OnMessageReceived(ExchangeContext * exchange, const Payl
                                           System::PacketBufferHandle && msg)
 {
     MATTER_TRACE_SCOPE("OnMessageReceived", "PASESession");
+    ScopedEventLoopTimeMetric eventLoopTimeMetric;
+
     CHIP_ERROR err  = ValidateReceivedMessage(exchange, payloadHeader, msg);
     MsgType msgType = static_cast<MsgType>(payloadHeader.GetMessageType());
     SuccessOrExit(err);
@@ -31,6 +31,7 @@
 #include <crypto/PSASpake2p.h>
 #endif
 #include <lib/support/Base64.h>
+#include <lib/support/CHIPMem.h>
 #include <messaging/ExchangeContext.h>
 #include <messaging/ExchangeDelegate.h>
 #include <messaging/ExchangeMessageDispatch.h>
@@ -44,6 +45,9 @@
 
 namespace chip {
 
+template <class SESSION, class DATA>
+class PairingSessionWorkHelper;
+
 extern const char kSpake2pI2RSessionInfo[];
 extern const char kSpake2pR2ISessionInfo[];
 
@@ -186,6 +190,12 @@ private:
     CHIP_ERROR SendPBKDFParamResponse(ByteSpan initiatorRandom, bool initiatorHasPBKDFParams);
     CHIP_ERROR HandlePBKDFParamResponse(System::PacketBufferHandle && msg);
 
+    struct DeriveWSData;
+    static CHIP_ERROR DeriveWS(DeriveWSData & data, bool & cancel);
+    CHIP_ERROR OnWSDerived(DeriveWSData & data, CHIP_ERROR status);
+    static void OnDeriveWSWatchdog(System::Layer * layer, void * appState);
+    CHIP_ERROR BeginProverAndSendMsg1(const DeriveWSData & data);
+
     CHIP_ERROR SendMsg1();
 
     CHIP_ERROR HandleMsg1_and_SendMsg2(System::PacketBufferHandle && msg);
@@ -220,6 +230,12 @@ private:
     uint16_t mSaltLength     = 0;
     uint8_t * mSalt          = nullptr;
 
+    template <class DATA>
+    using WorkHelper = PairingSessionWorkHelper<PASESession, DATA>;
+    Platform::SharedPtr<WorkHelper<DeriveWSData>> mDeriveWSHelper;
+    // Whether this session derived or reused the w0s/w1s kept for further attempts of the same pairing.
+    bool mUsesDerivedWS = false;
+
     struct Spake2pErrorMsg
     {
         Spake2pErrorType error;
@@ -33,6 +33,7 @@
 #include <lib/support/CodeUtils.h>
 #include <lib/support/UnitTestUtils.h>
 #include <messaging/tests/MessagingContext.h>
+#include <platform/PlatformManager.h>
 #include <protocols/secure_channel/PASESession.h>
 #include <stdarg.h>
 
@@ -89,12 +90,28 @@ class TestSecurePairingDelegate;
 class TestPASESession : public chip::Test::LoopbackMessagingContext
 {
 public:
+    static void SetUpTestSuite()
+    {
+        chip::Test::LoopbackMessagingContext::SetUpTestSuite();
+        ASSERT_EQ(chip::DeviceLayer::PlatformMgr().InitChipStack(), CHIP_NO_ERROR);
+        chip::DeviceLayer::SetSystemLayerForTesting(&GetSystemLayer());
+    }
+
+    static void TearDownTestSuite()
+    {
+        chip::DeviceLayer::SetSystemLayerForTesting(nullptr);
+        chip::DeviceLayer::PlatformMgr().Shutdown();
+        chip::Test::LoopbackMessagingContext::TearDownTestSuite();
+    }
+
     void SetUp() override
     {
         ConfigInitializeNodes(false);
         chip::Test::LoopbackMessagingContext::SetUp();
     }
 
+    void ServiceEvents();
+
     void SecurePairingHandshakeTestCommon(SessionManager & sessionManager, PASESession & pairingCommissioner,
                                           Optional<ReliableMessageProtocolConfig> mrpCommissionerConfig,
                                           Optional<ReliableMessageProtocolConfig> mrpAccessoryConfig,
@@ -165,6 +182,20 @@ private:
 
 using namespace System::Clock::Literals;
 
+void TestPASESession::ServiceEvents()
+{
+    // Takes a few rounds of this because handling IO messages may schedule work (e.g. deriving
+    // w0s/w1s on the commissioner), and scheduled work may queue messages for sending...
+    for (int i = 0; i < 3; ++i)
+    {
+        DrainAndServiceIO();
+
+        chip::DeviceLayer::PlatformMgr().ScheduleWork(
+            [](intptr_t) -> void { chip::DeviceLayer::PlatformMgr().StopEventLoopTask(); }, (intptr_t) nullptr);
+        chip::DeviceLayer::PlatformMgr().RunEventLoop();
+    }
+}
+
 TEST_F(TestPASESession, SecurePairingWaitTest)
 {
     TemporarySessionManager sessionManager(*this);
@@ -296,7 +327,7 @@ void TestPASESession::SecurePairingHandshakeTestCommon(SessionManager & sessionM
     EXPECT_EQ(pairingCommissioner.Pair(sessionManager, sTestSpake2p01_PinCode, mrpCommissionerConfig, contextCommissioner,
                                        &delegateCommissioner),
               CHIP_NO_ERROR);
-    DrainAndServiceIO();
+    ServiceEvents();
 
     while (delegate.mMessageDropped)
     {
@@ -314,7 +345,7 @@ void TestPASESession::SecurePairingHandshakeTestCommon(SessionManager & sessionM
         chip::test_utils::SleepMillis(waitTimeout.count());
         delegate.mMessageDropped = false;
         ReliableMessageMgr::Timeout(&GetSystemLayer(), GetExchangeManager().GetReliableMessageMgr());
-        DrainAndServiceIO();
+        ServiceEvents();
     };
 
     // Standalone acks also increment the mSentMessageCount. But some messages could be acked
@@ -470,7 +501,7 @@ TEST_F(TestPASESession, SecurePairingFailedHandshake)
     EXPECT_EQ(pairingCommissioner.Pair(sessionManager, 4321, Optional<ReliableMessageProtocolConfig>::Missing(),
                                        contextCommissioner, &delegateCommissioner),
               CHIP_NO_ERROR);
-    DrainAndServiceIO();
+    ServiceEvents();
 
     EXPECT_EQ(delegateAccessory.mNumPairingComplete, 0u);
     EXPECT_EQ(delegateAccessory.mNumPairingErrors, 1u);
@@ -478,6 +509,98 @@ TEST_F(TestPASESession, SecurePairingFailedHandshake)
     EXPECT_EQ(delegateCommissioner.mNumPairingErrors, 1u);
 }
 
+TEST_F(TestPASESession, SecurePairingWipesDerivedWSOnError)
+{
+    TemporarySessionManager sessionManager(*this);
+
+    auto & loopback = GetLoopback();
+    loopback.Reset();
+
+    // A device with another passcode, but the same salt and iteration count.
+    Spake2pVerifier otherVerifier;
+    uint32_t otherPinCode = sTestSpake2p01_PinCode + 1;
+    EXPECT_EQ(PASESession::GeneratePASEVerifier(otherVerifier, sTestSpake2p01_IterationCount, ByteSpan(sTestSpake2p01_Salt),
+                                                false, otherPinCode),
+              CHIP_NO_ERROR);
+
+    // The first attempt derives w0s/w1s in the background, and fails.
+    {
+        TestSecurePairingDelegate delegateCommissioner;
+        PASESession pairingCommissioner;
+        TestSecurePairingDelegate delegateAccessory;
+        PASESession pairingAccessory;
+
+        ExchangeContext * contextCommissioner = NewUnauthenticatedExchangeToBob(&pairingCommissioner);
+
+        EXPECT_EQ(GetExchangeManager().RegisterUnsolicitedMessageHandlerForType(
+                      Protocols::SecureChannel::MsgType::PBKDFParamRequest, &pairingAccessory),
+                  CHIP_NO_ERROR);
+        EXPECT_EQ(pairingAccessory.WaitForPairing(sessionManager, otherVerifier, sTestSpake2p01_IterationCount,
+                                                  ByteSpan(sTestSpake2p01_Salt),
+                                                  Optional<ReliableMessageProtocolConfig>::Missing(), &delegateAccessory),
+                  CHIP_NO_ERROR);
+        DrainAndServiceIO();
+
+        EXPECT_EQ(pairingCommissioner.Pair(sessionManager, sTestSpake2p01_PinCode,
+                                           Optional<ReliableMessageProtocolConfig>::Missing(), contextCommissioner,
+                                           &delegateCommissioner),
+                  CHIP_NO_ERROR);
+        DrainAndServiceIO();
+
+        // Nothing happens until the derivation has completed.
+        EXPECT_EQ(delegateCommissioner.mNumPairingComplete, 0u);
+        EXPECT_EQ(delegateCommissioner.mNumPairingErrors, 0u);
+
+        ServiceEvents();
+        EXPECT_EQ(delegateAccessory.mNumPairingErrors, 1u);
+        EXPECT_EQ(delegateCommissioner.mNumPairingComplete, 0u);
+        EXPECT_EQ(delegateCommissioner.mNumPairingErrors, 1u);
+    }
+
+    // The failed attempt wiped w0s/w1s, so the second attempt with the same passcode, salt and
+    // iteration count derives them again.
+    {
+        TestSecurePairingDelegate delegateCommissioner;
+        PASESession pairingCommissioner;
+        TestSecurePairingDelegate delegateAccessory;
+        PASESession pairingAccessory;
+
+        ExchangeContext * contextCommissioner = NewUnauthenticatedExchangeToBob(&pairingCommissioner);
+
+        EXPECT_EQ(GetExchangeManager().RegisterUnsolicitedMessageHandlerForType(
+                      Protocols::SecureChannel::MsgType::PBKDFParamRequest, &pairingAccessory),
+                  CHIP_NO_ERROR);
+        EXPECT_EQ(pairingAccessory.WaitForPairing(sessionManager, sTestSpake2p01_PASEVerifier, sTestSpake2p01_IterationCount,
+                                                  ByteSpan(sTestSpake2p01_Salt),
+                                                  Optional<ReliableMessageProtocolConfig>::Missing(), &delegateAccessory),
+                  CHIP_NO_ERROR);
+        DrainAndServiceIO();
+
+        EXPECT_EQ(pairingCommissioner.Pair(sessionManager, sTestSpake2p01_PinCode,
+                                           Optional<ReliableMessageProtocolConfig>::Missing(), contextCommissioner,
+                                           &delegateCommissioner),
+                  CHIP_NO_ERROR);
+        DrainAndServiceIO();
+
+        EXPECT_EQ(delegateCommissioner.mNumPairingComplete, 0u);
+        EXPECT_EQ(delegateCommissioner.mNumPairingErrors, 0u);
+
+        ServiceEvents();
+        EXPECT_EQ(delegateAccessory.mNumPairingComplete, 1u);
+        EXPECT_EQ(delegateCommissioner.mNumPairingComplete, 1u);
+        EXPECT_EQ(delegateCommissioner.mNumPairingErrors, 0u);
+
+        // Evict the PASE sessions before the PASESession objects go away.
+        auto session = pairingCommissioner.CopySecureSession();
+        ASSERT_TRUE(session.HasValue());
+        session.Value()->AsSecureSession()->MarkForEviction();
+        session = pairingAccessory.CopySecureSession();
+        ASSERT_TRUE(session.HasValue());
+        session.Value()->AsSecureSession()->MarkForEviction();
+        DrainAndServiceIO();
+    }
+}
+
 TEST_F(TestPASESession, PASEVerifierSerializeTest)
 {
     Spake2pVerifier verifier;
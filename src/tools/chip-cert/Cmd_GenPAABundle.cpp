@@ -0,0 +1,157 @@
+/*
+ *
+ *    Copyright (c) 2024 Project CHIP Authors
+ *    All rights reserved.
+ *
+ *    Licensed under the Apache License, Version 2.0 (the "License");
+ *    you may not use this file except in compliance with the License.
+ *    You may obtain a copy of the License at
+ *
+ *        http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *    Unless required by applicable law or agreed to in writing, software
+ *    distributed under the License is distributed on an "AS IS" BASIS,
+ *    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *    See the License for the specific language governing permissions and
+ *    limitations under the License.
+ */
+
+/**
+ *    @file
+ *      This file implements the command handler for the 'chip-cert' tool
+ *      that consolidates a directory of PAA certificates into a single
+ *      indexed bundle file for BundledAttestationTrustStore.
+ *
+ */
+
+#include "chip-cert.h"
+
+#include <credentials/attestation_verifier/BundledAttestationTrustStore.h>
+#include <credentials/attestation_verifier/FileAttestationTrustStore.h>
+
+namespace {
+
+using namespace chip;
+using namespace chip::ArgParser;
+using namespace chip::Credentials;
+
+#define CMD_NAME "chip-cert gen-paa-bundle"
+
+bool HandleOption(const char * progName, OptionSet * optSet, int id, const char * name, const char * arg);
+bool HandleNonOptionArgs(const char * progName, int argc, char * const argv[]);
+
+// clang-format off
+OptionDef gCmdOptionDefs[] =
+{
+    { "out",           kArgumentRequired, 'o' },
+    { }
+};
+
+const char * const gCmdOptionHelp =
+    "   -o, --out <file>\n"
+    "\n"
+    "       File to contain the PAA bundle.\n"
+    "\n"
+    ;
+
+OptionSet gCmdOptions =
+{
+    HandleOption,
+    gCmdOptionDefs,
+    "COMMAND OPTIONS",
+    gCmdOptionHelp
+};
+
+HelpOptions gHelpOptions(
+    CMD_NAME,
+    "Usage: " CMD_NAME " [<options...>] <dir...>\n",
+    CHIP_VERSION_STRING "\n" COPYRIGHT_STRING,
+    "Consolidate PAA certificates into a single bundle file indexed by subject key identifier.\n"
+    "\n"
+    "ARGUMENTS\n"
+    "\n"
+    "  <dir...>\n"
+    "\n"
+    "       One or more directories containing X.509 DER PAA certificates (*.der).\n"
+    "       Files that are not valid PAA certificates are skipped. If several\n"
+    "       certificates share a subject key identifier, the first one is kept.\n"
+    "\n"
+);
+
+OptionSet *gCmdOptionSets[] =
+{
+    &gCmdOptions,
+    &gHelpOptions,
+    nullptr
+};
+// clang-format on
+
+const char * gOutFileName  = nullptr;
+char * const * gInDirNames = nullptr;
+int gInDirCount            = 0;
+
+bool HandleOption(const char * progName, OptionSet * optSet, int id, const char * name, const char * arg)
+{
+    switch (id)
+    {
+    case 'o':
+        gOutFileName = arg;
+        break;
+    default:
+        PrintArgError("%s: Unhandled option: %s\n", progName, name);
+        return false;
+    }
+
+    return true;
+}
+
+bool HandleNonOptionArgs(const char * progName, int argc, char * const argv[])
+{
+    if (argc == 0)
+    {
+        PrintArgError("%s: Please specify at least one PAA certificate directory.\n", progName);
+        return false;
+    }
+
+    gInDirNames = argv;
+    gInDirCount = argc;
+
+    return true;
+}
+
+} // namespace
+
+bool Cmd_GenPAABundle(int argc, char * argv[])
+{
+    if (argc == 1)
+    {
+        gHelpOptions.PrintBriefUsage(stderr);
+        return true;
+    }
+
+    VerifyOrReturnError(ParseArgs(CMD_NAME, argc, argv, gCmdOptionSets, HandleNonOptionArgs), false);
+
+    if (gOutFileName == nullptr)
+    {
+        fprintf(stderr, "Please specify the output file name using the --out option.\n");
+        return false;
+    }
+
+    std::vector<std::vector<uint8_t>> certs;
+    for (int i = 0; i < gInDirCount; i++)
+    {
+        std::vector<std::vector<uint8_t>> dirCerts = LoadAllX509DerCerts(gInDirNames[i]);
+        certs.insert(certs.end(), dirCerts.begin(), dirCerts.end());
+    }
+
+    size_t entryCount = 0;
+    CHIP_ERROR err    = WritePAABundle(certs, gOutFileName, entryCount);
+    if (err != CHIP_NO_ERROR)
+    {
+        fprintf(stderr, "Failed to write PAA bundle %s: %s\n", gOutFileName, chip::ErrorStr(err));
+        return false;
+    }
+
+    printf("Wrote %u PAA certificates to %s\n", static_cast<unsigned>(entryCount), gOutFileName);
+    return true;
+}
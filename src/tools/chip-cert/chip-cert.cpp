@@ -66,6 +66,8 @@ const char * const sHelp =
     "\n"
     "    print-cd -- Print a CHIP certification declaration (CD) content.\n"
     "\n"
+    "    gen-paa-bundle -- Consolidate PAA certificates into an indexed bundle file.\n"
+    "\n"
     "    version -- Print the program version and exit.\n"
     "\n";
 // clang-format on
@@ -143,6 +145,10 @@ extern "C" int main(int argc, char * argv[])
     {
         res = Cmd_PrintCD(argc - 1, argv + 1);
     }
+    else if (strcasecmp(argv[1], "gen-paa-bundle") == 0 || strcasecmp(argv[1], "genpaabundle") == 0)
+    {
+        res = Cmd_GenPAABundle(argc - 1, argv + 1);
+    }
     else
     {
         fprintf(stderr, "Unrecognized command: %s\n", argv[1]);
@@ -25,10 +25,16 @@
 
 #include "spake2p.h"
 
+#include <algorithm>
+#include <chrono>
+#include <condition_variable>
 #include <cstring>
 #include <fstream>
 #include <iomanip>
 #include <iostream>
+#include <mutex>
+#include <thread>
+#include <vector>
 
 #include <CHIPVersion.h>
 #include <crypto/CHIPCryptoPAL.h>
@@ -58,6 +64,8 @@ OptionDef gCmdOptionDefs[] =
     { "salt-len",        kArgumentRequired, 'l' },
     { "salt",            kArgumentRequired, 's' },
     { "out",             kArgumentRequired, 'o' },
+    { "jobs",            kArgumentRequired, 'j' },
+    { "progress",        kNoArgument,       'P' },
     { }
 };
 
@@ -127,6 +135,17 @@ const char * const gCmdOptionHelp =
     "           index of the parameter set in the list,'pin-code','iteration-count','salt'(Base-64 encoded),'verifier'(Base-64 encoded)\n"
     "           ....\n"
     "\n"
+    "   -j, --jobs <int>\n"
+    "\n"
+    "       The number of threads generating verifiers in parallel. Specify 0 to use one thread\n"
+    "       per CPU core. If not specified, one thread will be used. The parameter sets are\n"
+    "       written in index order, and PIN codes from the 'pin-code-file' are assigned in file\n"
+    "       order, independently of the number of threads.\n"
+    "\n"
+    "   -P, --progress\n"
+    "\n"
+    "       Report the progress and the generation rate (parameter sets per second) to stderr.\n"
+    "\n"
     ;
 
 OptionSet gCmdOptions =
@@ -160,6 +179,35 @@ uint8_t gSaltDecodedLen   = 0;
 uint8_t gSaltLen          = 0;
 const char * gOutFileName = nullptr;
 std::ifstream gPinCodeFile;
+uint32_t gJobs            = 1;
+bool gReportProgress      = false;
+
+constexpr uint32_t kMaxJobs = 256;
+
+// Number of parameter sets per thread that may be generated ahead of the one being written.
+constexpr uint32_t kSetsInFlightPerJob = 16;
+
+struct ParameterSet
+{
+    uint32_t pinCode;
+    uint8_t salt[kSpake2p_Max_PBKDF_Salt_Length];
+    char verifierB64[BASE64_ENCODED_LEN(kSpake2p_VerifierSerialized_Length) + 1];
+    CHIP_ERROR status;
+    bool done;
+};
+
+// State shared by the generator threads and the writer (the calling thread).
+// Parameter set `i` is generated into mSets[i % mSets.size()], which is reused once the set
+// has been written.
+struct GeneratorState
+{
+    std::mutex mMutex;
+    std::condition_variable mCondition;
+    std::vector<ParameterSet> mSets;
+    uint32_t mNextIndex    = 0;
+    uint32_t mWrittenCount = 0;
+    bool mAborted          = false;
+};
 
 static uint32_t GetNextPinCode()
 {
@@ -186,6 +234,182 @@ static uint32_t GetNextPinCode()
     return pinCode;
 }
 
+// Must be called with the generator state locked, so that the PIN codes and the salts are
+// assigned to the parameter sets in index order.
+CHIP_ERROR PrepareParameterSet(ParameterSet & set)
+{
+    set.pinCode = gPinCode;
+    if (set.pinCode == chip::kSetupPINCodeUndefinedValue)
+    {
+        // Same as PASESession::GeneratePASEVerifier(), with the DRBG used under the generator state lock.
+        ReturnErrorOnFailure(chip::Crypto::DRBG_get_bytes(reinterpret_cast<uint8_t *>(&set.pinCode), sizeof(set.pinCode)));
+        set.pinCode = (set.pinCode % chip::kSetupPINCodeMaximumValue) + 1;
+    }
+
+    if (gSaltDecodedLen == 0)
+    {
+        ReturnErrorOnFailure(chip::Crypto::DRBG_get_bytes(set.salt, gSaltLen));
+    }
+    else
+    {
+        memcpy(set.salt, gSalt, gSaltLen);
+    }
+
+    // If the file with PIN codes is not provided, the PIN code of the next set will be randomly generated.
+    gPinCode = GetNextPinCode();
+    // The Salt of the next set will be randomly generated.
+    gSaltDecodedLen = 0;
+
+    return CHIP_NO_ERROR;
+}
+
+// Same as Spake2pVerifier::ComputeWS(), safe to run on any thread.
+CHIP_ERROR ComputeWS(const ParameterSet & set, uint8_t (&ws)[kSpake2p_WS_Length * 2])
+{
+    return Spake2pVerifier::ComputeWS(gIterationCount, chip::ByteSpan(set.salt, gSaltLen), set.pinCode, ws, sizeof(ws));
+}
+
+// Computing L blinds the EC multiplication with random numbers from the DRBG of the crypto backend,
+// which is shared by all threads and not thread-safe with mbedTLS: must be called with the generator
+// state locked.
+CHIP_ERROR GenerateVerifier(ParameterSet & set, const uint8_t (&ws)[kSpake2p_WS_Length * 2])
+{
+    Spake2pVerifier verifier;
+    ReturnErrorOnFailure(verifier.GenerateFromWS(ws, sizeof(ws)));
+
+    Spake2pVerifierSerialized serializedVerifier;
+    chip::MutableByteSpan serializedVerifierSpan(serializedVerifier);
+    ReturnErrorOnFailure(verifier.Serialize(serializedVerifierSpan));
+
+    uint32_t verifierB64Len         = chip::Base64Encode32(serializedVerifier, kSpake2p_VerifierSerialized_Length, set.verifierB64);
+    set.verifierB64[verifierB64Len] = '\0';
+
+    return CHIP_NO_ERROR;
+}
+
+void GeneratorThreadMain(GeneratorState * state)
+{
+    std::unique_lock<std::mutex> lock(state->mMutex);
+
+    while (true)
+    {
+        state->mCondition.wait(lock, [state] {
+            return state->mAborted || state->mNextIndex >= gCount ||
+                state->mNextIndex - state->mWrittenCount < state->mSets.size();
+        });
+        if (state->mAborted || state->mNextIndex >= gCount)
+        {
+            return;
+        }
+
+        ParameterSet & set = state->mSets[state->mNextIndex % state->mSets.size()];
+        state->mNextIndex++;
+
+        CHIP_ERROR err = PrepareParameterSet(set);
+        if (err == CHIP_NO_ERROR)
+        {
+            // PBKDF2 dominates, so only it runs unlocked.
+            uint8_t ws[kSpake2p_WS_Length * 2];
+            lock.unlock();
+            err = ComputeWS(set, ws);
+            lock.lock();
+            if (err == CHIP_NO_ERROR)
+            {
+                err = GenerateVerifier(set, ws);
+            }
+        }
+
+        set.status = err;
+        set.done   = true;
+        state->mCondition.notify_all();
+    }
+}
+
+void ReportProgress(uint32_t writtenCount, std::chrono::steady_clock::time_point startTime, bool final)
+{
+    std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - startTime;
+    double rate                           = (elapsed.count() > 0) ? writtenCount / elapsed.count() : 0;
+
+    std::cerr << "\rGenerated " << writtenCount << "/" << gCount << " parameter sets in " << std::fixed
+              << std::setprecision(1) << elapsed.count() << " s (" << rate << " sets/s, " << gJobs << " threads)"
+              << (final ? "\n" : "") << std::flush;
+}
+
+bool GenerateParameterSets(std::ostream & outStream)
+{
+    GeneratorState state;
+    state.mSets.resize(gJobs * kSetsInFlightPerJob);
+
+    std::vector<std::thread> threads;
+    threads.reserve(gJobs);
+    for (uint32_t i = 0; i < gJobs; i++)
+    {
+        threads.emplace_back(GeneratorThreadMain, &state);
+    }
+
+    const auto startTime    = std::chrono::steady_clock::now();
+    auto lastProgressReport = startTime;
+    bool res                = true;
+
+    while (state.mWrittenCount < gCount)
+    {
+        std::unique_lock<std::mutex> lock(state.mMutex);
+        ParameterSet & set = state.mSets[state.mWrittenCount % state.mSets.size()];
+        state.mCondition.wait(lock, [&set] { return set.done; });
+        lock.unlock();
+
+        // The set is not reused before it has been written, so it can be accessed unlocked.
+        if (set.status != CHIP_NO_ERROR)
+        {
+            std::cerr << "Failed to generate parameter set " << state.mWrittenCount << ": " << set.status.AsString() << "\n";
+            res = false;
+            break;
+        }
+
+        char saltB64[BASE64_ENCODED_LEN(kSpake2p_Max_PBKDF_Salt_Length) + 1];
+        uint32_t saltB64Len = chip::Base64Encode32(set.salt, gSaltLen, saltB64);
+        saltB64[saltB64Len] = '\0';
+
+        outStream << state.mWrittenCount << "," << std::setfill('0') << std::setw(8) << set.pinCode << "," << gIterationCount << ","
+                  << saltB64 << "," << set.verifierB64 << "\n";
+        if (outStream.fail())
+        {
+            std::cerr << "Error writing to output file: " << strerror(errno) << "\n";
+            res = false;
+            break;
+        }
+
+        lock.lock();
+        set.done = false;
+        state.mWrittenCount++;
+        state.mCondition.notify_all();
+        lock.unlock();
+
+        if (gReportProgress && std::chrono::steady_clock::now() - lastProgressReport >= std::chrono::seconds(1))
+        {
+            lastProgressReport = std::chrono::steady_clock::now();
+            ReportProgress(state.mWrittenCount, startTime, false);
+        }
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(state.mMutex);
+        state.mAborted = true;
+        state.mCondition.notify_all();
+    }
+    for (std::thread & thread : threads)
+    {
+        thread.join();
+    }
+
+    if (gReportProgress && res)
+    {
+        ReportProgress(state.mWrittenCount, startTime, true);
+    }
+
+    return res;
+}
+
 bool HandleOption(const char * progName, OptionSet * optSet, int id, const char * name, const char * arg)
 {
     switch (id)
@@ -262,6 +486,18 @@ bool HandleOption(const char * progName, OptionSet * optSet, int id, const char
         gOutFileName = arg;
         break;
 
+    case 'j':
+        if (!ParseInt(arg, gJobs) || gJobs > kMaxJobs)
+        {
+            PrintArgError("%s: Invalid value specified for the number of jobs: %s\n", progName, arg);
+            return false;
+        }
+        break;
+
+    case 'P':
+        gReportProgress = true;
+        break;
+
     default:
         PrintArgError("%s: Unhandled option: %s\n", progName, name);
         return false;
@@ -331,61 +567,16 @@ bool Cmd_GenVerifier(int argc, char * argv[])
         std::cerr << "Error writing to output file: " << strerror(errno) << "\n";
     }
 
-    for (uint32_t i = 0; i < gCount; i++)
+    if (gJobs == 0)
     {
-        uint8_t salt[kSpake2p_Max_PBKDF_Salt_Length];
-        if (gSaltDecodedLen == 0)
-        {
-            CHIP_ERROR err = chip::Crypto::DRBG_get_bytes(salt, gSaltLen);
-            if (err != CHIP_NO_ERROR)
-            {
-                std::cerr << "DRBG_get_bytes() failed.\n";
-                return false;
-            }
-        }
-        else
-        {
-            memcpy(salt, gSalt, gSaltLen);
-        }
-
-        Spake2pVerifier verifier;
-        CHIP_ERROR err = chip::PASESession::GeneratePASEVerifier(verifier, gIterationCount, chip::ByteSpan(salt, gSaltLen),
-                                                                 (gPinCode == chip::kSetupPINCodeUndefinedValue), gPinCode);
-        if (err != CHIP_NO_ERROR)
-        {
-            std::cerr << "GeneratePASEVerifier() failed.\n";
-            return false;
-        }
-
-        Spake2pVerifierSerialized serializedVerifier;
-        chip::MutableByteSpan serializedVerifierSpan(serializedVerifier);
-        err = verifier.Serialize(serializedVerifierSpan);
-        if (err != CHIP_NO_ERROR)
-        {
-            std::cerr << "Spake2pVerifier::Serialize() failed.\n";
-            return false;
-        }
-
-        char saltB64[BASE64_ENCODED_LEN(kSpake2p_Max_PBKDF_Salt_Length) + 1];
-        uint32_t saltB64Len = chip::Base64Encode32(salt, gSaltLen, saltB64);
-        saltB64[saltB64Len] = '\0';
-
-        char verifierB64[BASE64_ENCODED_LEN(kSpake2p_VerifierSerialized_Length) + 1];
-        uint32_t verifierB64Len     = chip::Base64Encode32(serializedVerifier, kSpake2p_VerifierSerialized_Length, verifierB64);
-        verifierB64[verifierB64Len] = '\0';
-
-        (*outStream) << i << "," << std::setfill('0') << std::setw(8) << gPinCode << "," << gIterationCount << "," << saltB64 << ","
-                     << verifierB64 << "\n";
-        if (outStream->fail())
-        {
-            std::cerr << "Error writing to output file: " << strerror(errno) << "\n";
-            return false;
-        }
+        gJobs = std::clamp(std::thread::hardware_concurrency(), 1u, kMaxJobs);
+    }
+    // More threads than parameter sets would have nothing to do.
+    gJobs = std::min(gJobs, gCount);
 
-        // If the file with PIN codes is not provided, the PIN code on next iteration will be randomly generated.
-        gPinCode = GetNextPinCode();
-        // On the next iteration the Salt will be randomly generated.
-        gSaltDecodedLen = 0;
+    if (!GenerateParameterSets(*outStream))
+    {
+        return false;
     }
 
     gPinCodeFile.close();
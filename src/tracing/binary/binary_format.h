@@ -0,0 +1,151 @@
+/*
+ *
+ *    Copyright (c) 2024 Project CHIP Authors
+ *    All rights reserved.
+ *
+ *    Licensed under the Apache License, Version 2.0 (the "License");
+ *    you may not use this file except in compliance with the License.
+ *    You may obtain a copy of the License at
+ *
+ *        http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *    Unless required by applicable law or agreed to in writing, software
+ *    distributed under the License is distributed on an "AS IS" BASIS,
+ *    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *    See the License for the specific language governing permissions and
+ *    limitations under the License.
+ */
+#pragma once
+
+#include <lib/core/CHIPEncoding.h>
+
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+
+namespace chip {
+namespace Tracing {
+namespace Binary {
+
+/// On-disk layout of binary trace files.
+///
+/// A file starts with a kFileHeaderSize header:
+///
+///    magic[8]      "MTRTRACE"
+///    version       uint16
+///    recordSize    uint16
+///    reserved      uint32
+///
+/// followed by kRecordSize records. All integers are little endian. Every record
+/// starts with:
+///
+///    kind          uint8  (RecordKind)
+///    aux           uint8  (kind specific)
+///    thread        uint16 (index of the thread that emitted the event)
+///    label         uint32 (string id)
+///    timestampNs   uint64 (monotonic clock)
+///
+/// and ends with kRecordArgsSize kind specific bytes. A kString record defines
+/// the string for a label id and is followed by `length` bytes of string data.
+/// The writer always defines a string before the first record that uses it.
+constexpr uint8_t kFileMagic[]        = { 'M', 'T', 'R', 'T', 'R', 'A', 'C', 'E' };
+constexpr uint16_t kFileFormatVersion = 1;
+constexpr size_t kFileHeaderSize      = 16;
+constexpr size_t kRecordSize          = 32;
+constexpr size_t kRecordArgsSize      = 16;
+
+/// String id 0 is never defined and stands for "no string".
+constexpr uint32_t kNoStringId = 0;
+
+enum class RecordKind : uint8_t
+{
+    kString = 0, // label: defined id. args: length (uint32)
+
+    kBegin   = 1, // args: group (uint32 string id)
+    kEnd     = 2, // args: group (uint32 string id)
+    kInstant = 3, // args: group (uint32 string id)
+    kCounter = 4, // no args; counting happens when converting
+
+    kMetricBegin   = 5, // aux: MetricEvent::Value::Type. args: value (uint32)
+    kMetricEnd     = 6, // aux: MetricEvent::Value::Type. args: value (uint32)
+    kMetricInstant = 7, // aux: MetricEvent::Value::Type. args: value (uint32)
+
+    kMessageSend     = 8, // aux: OutgoingMessageType. args: MessageArgs
+    kMessageReceived = 9, // aux: IncomingMessageType. args: MessageArgs
+
+    kDropped = 10, // args: number of events the thread dropped because its buffer was full (uint32)
+};
+
+/// Summary of a sent or received message, stored in the record arguments
+struct MessageArgs
+{
+    static constexpr uint8_t kFlagInitiator = 0x01;
+    static constexpr uint8_t kFlagNeedsAck  = 0x02;
+
+    uint32_t payloadSize = 0;
+    uint32_t protocolId  = 0; // Protocols::Id::ToFullyQualifiedSpecForm
+    uint16_t exchangeId  = 0;
+    uint16_t sessionId   = 0;
+    uint8_t messageType  = 0;
+    uint8_t flags        = 0;
+
+    void Encode(uint8_t * args) const
+    {
+        Encoding::LittleEndian::Put32(args, payloadSize);
+        Encoding::LittleEndian::Put32(args + 4, protocolId);
+        Encoding::LittleEndian::Put16(args + 8, exchangeId);
+        Encoding::LittleEndian::Put16(args + 10, sessionId);
+        args[12] = messageType;
+        args[13] = flags;
+        args[14] = 0;
+        args[15] = 0;
+    }
+
+    void Decode(const uint8_t * args)
+    {
+        payloadSize = Encoding::LittleEndian::Get32(args);
+        protocolId  = Encoding::LittleEndian::Get32(args + 4);
+        exchangeId  = Encoding::LittleEndian::Get16(args + 8);
+        sessionId   = Encoding::LittleEndian::Get16(args + 10);
+        messageType = args[12];
+        flags       = args[13];
+    }
+};
+
+/// A decoded record
+struct Record
+{
+    RecordKind kind               = RecordKind::kString;
+    uint8_t aux                   = 0;
+    uint16_t thread               = 0;
+    uint32_t label                = kNoStringId;
+    uint64_t timestampNs          = 0;
+    uint8_t args[kRecordArgsSize] = {};
+
+    void Encode(uint8_t * buffer) const
+    {
+        buffer[0] = static_cast<uint8_t>(kind);
+        buffer[1] = aux;
+        Encoding::LittleEndian::Put16(buffer + 2, thread);
+        Encoding::LittleEndian::Put32(buffer + 4, label);
+        Encoding::LittleEndian::Put64(buffer + 8, timestampNs);
+        memcpy(buffer + kRecordSize - kRecordArgsSize, args, kRecordArgsSize);
+    }
+
+    void Decode(const uint8_t * buffer)
+    {
+        kind        = static_cast<RecordKind>(buffer[0]);
+        aux         = buffer[1];
+        thread      = Encoding::LittleEndian::Get16(buffer + 2);
+        label       = Encoding::LittleEndian::Get32(buffer + 4);
+        timestampNs = Encoding::LittleEndian::Get64(buffer + 8);
+        memcpy(args, buffer + kRecordSize - kRecordArgsSize, kRecordArgsSize);
+    }
+
+    uint32_t ArgUInt32() const { return Encoding::LittleEndian::Get32(args); }
+    void SetArgUInt32(uint32_t value) { Encoding::LittleEndian::Put32(args, value); }
+};
+
+} // namespace Binary
+} // namespace Tracing
+} // namespace chip
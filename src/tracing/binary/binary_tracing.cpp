@@ -0,0 +1,452 @@
+/*
+ *
+ *    Copyright (c) 2024 Project CHIP Authors
+ *    All rights reserved.
+ *
+ *    Licensed under the Apache License, Version 2.0 (the "License");
+ *    you may not use this file except in compliance with the License.
+ *    You may obtain a copy of the License at
+ *
+ *        http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *    Unless required by applicable law or agreed to in writing, software
+ *    distributed under the License is distributed on an "AS IS" BASIS,
+ *    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *    See the License for the specific language governing permissions and
+ *    limitations under the License.
+ */
+
+#include <tracing/binary/binary_tracing.h>
+
+#include <lib/support/CodeUtils.h>
+#include <tracing/metric_event.h>
+#include <transport/TracingStructs.h>
+
+#include <errno.h>
+#include <string.h>
+
+namespace chip {
+namespace Tracing {
+namespace Binary {
+
+namespace {
+
+// The converter reports both message directions with the same names
+static_assert(static_cast<uint8_t>(OutgoingMessageType::kGroupMessage) == static_cast<uint8_t>(IncomingMessageType::kGroupMessage));
+static_assert(static_cast<uint8_t>(OutgoingMessageType::kSecureSession) ==
+              static_cast<uint8_t>(IncomingMessageType::kSecureUnicast));
+static_assert(static_cast<uint8_t>(OutgoingMessageType::kUnauthenticated) ==
+              static_cast<uint8_t>(IncomingMessageType::kUnauthenticated));
+
+// Records are written to the output file in chunks of about this size
+constexpr size_t kWriteBufferSize = 64 * 1024;
+
+std::atomic<uint32_t> sNextInstanceId{ 1 };
+
+uint64_t MonotonicTimestampNs()
+{
+    return static_cast<uint64_t>(
+        std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count());
+}
+
+size_t RoundUpToPowerOfTwo(size_t value)
+{
+    size_t result = 1;
+    while (result < value)
+    {
+        result <<= 1;
+    }
+    return result;
+}
+
+MessageArgs GetMessageArgs(const PayloadHeader * payloadHeader, const PacketHeader * packetHeader, const ByteSpan & payload)
+{
+    MessageArgs args;
+
+    args.payloadSize = static_cast<uint32_t>(payload.size());
+    args.protocolId  = payloadHeader->GetProtocolID().ToFullyQualifiedSpecForm();
+    args.exchangeId  = payloadHeader->GetExchangeID();
+    args.sessionId   = packetHeader->GetSessionId();
+    args.messageType = payloadHeader->GetMessageType();
+    args.flags       = static_cast<uint8_t>((payloadHeader->IsInitiator() ? MessageArgs::kFlagInitiator : 0) |
+                                      (payloadHeader->NeedsAck() ? MessageArgs::kFlagNeedsAck : 0));
+    return args;
+}
+
+} // namespace
+
+/// Single producer (the owning thread), single consumer (the flushing thread)
+/// ring of events.
+class BinaryBackend::ThreadBuffer
+{
+public:
+    ThreadBuffer(size_t capacity, uint16_t thread) :
+        mEvents(capacity), mMask(capacity - 1), mThread(thread), mOwner(std::this_thread::get_id())
+    {}
+
+    uint16_t Thread() const { return mThread; }
+    std::thread::id Owner() const { return mOwner; }
+
+    /// Called by the owning thread only. Returns false if the buffer is full.
+    bool Push(const Event & event)
+    {
+        const size_t head = mHead.load(std::memory_order_relaxed);
+        if (head - mCachedTail > mMask)
+        {
+            mCachedTail = mTail.load(std::memory_order_acquire);
+            if (head - mCachedTail > mMask)
+            {
+                mDropped.fetch_add(1, std::memory_order_relaxed);
+                return false;
+            }
+        }
+
+        mEvents[head & mMask] = event;
+        mHead.store(head + 1, std::memory_order_release);
+        return true;
+    }
+
+    /// Called by the consumer only: hands every pending event to `handler`
+    template <typename Handler>
+    void Drain(Handler && handler)
+    {
+        const size_t head = mHead.load(std::memory_order_acquire);
+        for (size_t tail = mTail.load(std::memory_order_relaxed); tail != head; tail++)
+        {
+            handler(mEvents[tail & mMask]);
+        }
+        mTail.store(head, std::memory_order_release);
+    }
+
+    /// Called by the consumer only: drops all pending events
+    void Discard()
+    {
+        mTail.store(mHead.load(std::memory_order_acquire), std::memory_order_release);
+        mDropped.store(0, std::memory_order_relaxed);
+    }
+
+    uint32_t TakeDroppedCount() { return mDropped.exchange(0, std::memory_order_relaxed); }
+
+private:
+    std::vector<Event> mEvents;
+    const size_t mMask;
+    const uint16_t mThread;
+    const std::thread::id mOwner;
+
+    // Producer and consumer indexes are kept on separate cache lines
+    alignas(64) std::atomic<size_t> mHead{ 0 };
+    size_t mCachedTail = 0;
+    std::atomic<uint32_t> mDropped{ 0 };
+    alignas(64) std::atomic<size_t> mTail{ 0 };
+};
+
+thread_local BinaryBackend::ThreadBufferCache BinaryBackend::sThreadBuffer = { 0, nullptr };
+
+BinaryBackend::BinaryBackend(size_t eventsPerThread, std::chrono::milliseconds flushInterval) :
+    mEventsPerThread(RoundUpToPowerOfTwo(eventsPerThread)), mFlushInterval(flushInterval),
+    mInstanceId(sNextInstanceId.fetch_add(1, std::memory_order_relaxed))
+{}
+
+BinaryBackend::~BinaryBackend()
+{
+    CloseFile();
+}
+
+BinaryBackend::ThreadBuffer * BinaryBackend::GetThreadBuffer()
+{
+    ThreadBufferCache & cache = sThreadBuffer;
+    if (cache.instanceId == mInstanceId)
+    {
+        return cache.buffer;
+    }
+
+    std::lock_guard<std::mutex> lock(mBuffersMutex);
+
+    // A thread may come back here after using another backend instance
+    const std::thread::id self = std::this_thread::get_id();
+    ThreadBuffer * buffer      = nullptr;
+    for (auto & existing : mBuffers)
+    {
+        if (existing->Owner() == self)
+        {
+            buffer = existing.get();
+            break;
+        }
+    }
+
+    if (buffer == nullptr)
+    {
+        VerifyOrReturnValue(mBuffers.size() <= UINT16_MAX, nullptr);
+        mBuffers.push_back(std::make_unique<ThreadBuffer>(mEventsPerThread, static_cast<uint16_t>(mBuffers.size())));
+        buffer = mBuffers.back().get();
+    }
+
+    cache = { mInstanceId, buffer };
+    return buffer;
+}
+
+void BinaryBackend::Append(Event & event)
+{
+    VerifyOrReturn(mRecording.load(std::memory_order_relaxed));
+
+    ThreadBuffer * buffer = GetThreadBuffer();
+    VerifyOrReturn(buffer != nullptr);
+
+    event.timestampNs = MonotonicTimestampNs();
+    if (!buffer->Push(event))
+    {
+        mDroppedEvents.fetch_add(1, std::memory_order_relaxed);
+    }
+}
+
+void BinaryBackend::Append(RecordKind kind, const char * label, const char * group)
+{
+    Event event;
+    event.label = label;
+    event.group = group;
+    event.kind  = kind;
+    event.aux   = 0;
+    memset(event.args, 0, sizeof(event.args));
+    Append(event);
+}
+
+void BinaryBackend::TraceBegin(const char * label, const char * group)
+{
+    Append(RecordKind::kBegin, label, group);
+}
+
+void BinaryBackend::TraceEnd(const char * label, const char * group)
+{
+    Append(RecordKind::kEnd, label, group);
+}
+
+void BinaryBackend::TraceInstant(const char * label, const char * group)
+{
+    Append(RecordKind::kInstant, label, group);
+}
+
+void BinaryBackend::TraceCounter(const char * label)
+{
+    Append(RecordKind::kCounter, label, nullptr);
+}
+
+void BinaryBackend::LogMessageSend(MessageSendInfo & info)
+{
+    Event event;
+    event.label = "MessageSend";
+    event.group = nullptr;
+    event.kind  = RecordKind::kMessageSend;
+    event.aux   = static_cast<uint8_t>(info.messageType);
+    GetMessageArgs(info.payloadHeader, info.packetHeader, info.payload).Encode(event.args);
+    Append(event);
+}
+
+void BinaryBackend::LogMessageReceived(MessageReceivedInfo & info)
+{
+    Event event;
+    event.label = "MessageReceived";
+    event.group = nullptr;
+    event.kind  = RecordKind::kMessageReceived;
+    event.aux   = static_cast<uint8_t>(info.messageType);
+    GetMessageArgs(info.payloadHeader, info.packetHeader, info.payload).Encode(event.args);
+    Append(event);
+}
+
+void BinaryBackend::LogMetricEvent(const MetricEvent & event)
+{
+    Event metric;
+    metric.label = event.key();
+    metric.group = nullptr;
+    metric.aux   = static_cast<uint8_t>(event.ValueType());
+
+    switch (event.type())
+    {
+    case MetricEvent::Type::kBeginEvent:
+        metric.kind = RecordKind::kMetricBegin;
+        break;
+    case MetricEvent::Type::kEndEvent:
+        metric.kind = RecordKind::kMetricEnd;
+        break;
+    case MetricEvent::Type::kInstantEvent:
+    default:
+        metric.kind = RecordKind::kMetricInstant;
+        break;
+    }
+
+    uint32_t value  = 0;
+    using ValueType = MetricEvent::Value::Type;
+    switch (event.ValueType())
+    {
+    case ValueType::kInt32:
+        value = static_cast<uint32_t>(event.ValueInt32());
+        break;
+    case ValueType::kUInt32:
+        value = event.ValueUInt32();
+        break;
+    case ValueType::kChipErrorCode:
+        value = event.ValueErrorCode();
+        break;
+    default:
+        break;
+    }
+    Encoding::LittleEndian::Put32(metric.args, value);
+
+    Append(metric);
+}
+
+CHIP_ERROR BinaryBackend::OpenFile(const char * path)
+{
+    CloseFile();
+    mOutputFile.open(path, std::ios_base::out | std::ios_base::trunc | std::ios_base::binary);
+
+    if (!mOutputFile)
+    {
+        return CHIP_ERROR_POSIX(errno);
+    }
+
+    uint8_t header[kFileHeaderSize] = {};
+    memcpy(header, kFileMagic, sizeof(kFileMagic));
+    Encoding::LittleEndian::Put16(header + 8, kFileFormatVersion);
+    Encoding::LittleEndian::Put16(header + 10, static_cast<uint16_t>(kRecordSize));
+    mOutputFile.write(reinterpret_cast<const char *>(header), sizeof(header));
+    mWriteBuffer.reserve(kWriteBufferSize + kRecordSize);
+
+    // String ids are per file, and events left over from a previous file are not part of this one
+    mStringIds.clear();
+    {
+        std::lock_guard<std::mutex> lock(mBuffersMutex);
+        for (auto & buffer : mBuffers)
+        {
+            buffer->Discard();
+        }
+    }
+
+    mStopFlushing = false;
+    mFlushThread  = std::thread(&BinaryBackend::FlushLoop, this);
+    mRecording.store(true, std::memory_order_relaxed);
+
+    return CHIP_NO_ERROR;
+}
+
+void BinaryBackend::CloseFile()
+{
+    if (!mOutputFile.is_open())
+    {
+        return;
+    }
+
+    mRecording.store(false, std::memory_order_relaxed);
+
+    {
+        std::lock_guard<std::mutex> lock(mFlushMutex);
+        mStopFlushing = true;
+    }
+    mFlushCondition.notify_one();
+    mFlushThread.join();
+
+    // Events appended while stopping are flushed here
+    Flush();
+    mOutputFile.close();
+}
+
+void BinaryBackend::FlushLoop()
+{
+    std::unique_lock<std::mutex> lock(mFlushMutex);
+    while (!mStopFlushing)
+    {
+        mFlushCondition.wait_for(lock, mFlushInterval);
+
+        lock.unlock();
+        Flush();
+        lock.lock();
+    }
+}
+
+void BinaryBackend::Flush()
+{
+    {
+        std::lock_guard<std::mutex> lock(mBuffersMutex);
+        mFlushBuffers.clear();
+        for (auto & buffer : mBuffers)
+        {
+            mFlushBuffers.push_back(buffer.get());
+        }
+    }
+
+    for (ThreadBuffer * buffer : mFlushBuffers)
+    {
+        buffer->Drain([this, buffer](const Event & event) {
+            Record record;
+            record.kind        = event.kind;
+            record.aux         = event.aux;
+            record.thread      = buffer->Thread();
+            record.label       = GetStringId(event.label);
+            record.timestampNs = event.timestampNs;
+            memcpy(record.args, event.args, sizeof(record.args));
+            if (event.group != nullptr)
+            {
+                record.SetArgUInt32(GetStringId(event.group));
+            }
+            WriteRecord(record);
+            if (mWriteBuffer.size() >= kWriteBufferSize)
+            {
+                WritePendingRecords();
+            }
+        });
+
+        uint32_t dropped = buffer->TakeDroppedCount();
+        if (dropped > 0)
+        {
+            Record record;
+            record.kind        = RecordKind::kDropped;
+            record.thread      = buffer->Thread();
+            record.timestampNs = MonotonicTimestampNs();
+            record.SetArgUInt32(dropped);
+            WriteRecord(record);
+        }
+    }
+
+    WritePendingRecords();
+    mOutputFile.flush();
+}
+
+void BinaryBackend::WriteRecord(const Record & record)
+{
+    const size_t offset = mWriteBuffer.size();
+    mWriteBuffer.resize(offset + kRecordSize);
+    record.Encode(mWriteBuffer.data() + offset);
+}
+
+void BinaryBackend::WritePendingRecords()
+{
+    mOutputFile.write(reinterpret_cast<const char *>(mWriteBuffer.data()), static_cast<std::streamsize>(mWriteBuffer.size()));
+    mWriteBuffer.clear();
+}
+
+uint32_t BinaryBackend::GetStringId(const char * string)
+{
+    VerifyOrReturnValue(string != nullptr, kNoStringId);
+
+    auto it = mStringIds.find(string);
+    if (it != mStringIds.end())
+    {
+        return it->second;
+    }
+
+    const uint32_t id     = static_cast<uint32_t>(mStringIds.size() + 1);
+    const uint32_t length = static_cast<uint32_t>(strlen(string));
+    mStringIds.emplace(string, id);
+
+    Record record;
+    record.kind  = RecordKind::kString;
+    record.label = id;
+    record.SetArgUInt32(length);
+    WriteRecord(record);
+    mWriteBuffer.insert(mWriteBuffer.end(), string, string + length);
+
+    return id;
+}
+
+} // namespace Binary
+} // namespace Tracing
+} // namespace chip
@@ -0,0 +1,146 @@
+/*
+ *
+ *    Copyright (c) 2024 Project CHIP Authors
+ *    All rights reserved.
+ *
+ *    Licensed under the Apache License, Version 2.0 (the "License");
+ *    you may not use this file except in compliance with the License.
+ *    You may obtain a copy of the License at
+ *
+ *        http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *    Unless required by applicable law or agreed to in writing, software
+ *    distributed under the License is distributed on an "AS IS" BASIS,
+ *    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *    See the License for the specific language governing permissions and
+ *    limitations under the License.
+ */
+#pragma once
+
+#include <lib/core/CHIPError.h>
+#include <tracing/backend.h>
+#include <tracing/binary/binary_format.h>
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <fstream>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+namespace chip {
+namespace Tracing {
+namespace Binary {
+
+/// A Backend that records events as fixed-size binary records, meant to be
+/// cheap enough to stay enabled in production.
+///
+/// Tracing calls only append a record to a ring buffer owned by the calling
+/// thread: no locks, allocations, formatting or payload decoding happen on
+/// the traced thread (except once per thread, to create its buffer). A
+/// background thread moves the records to the output file. When a thread
+/// produces events faster than they are flushed, new events are dropped and
+/// the number of dropped events is recorded instead.
+///
+/// Labels, groups and metric keys are stored by pointer and only resolved to
+/// strings by the flushing thread, so they MUST be constant strings (as
+/// already required for all tracing labels).
+///
+/// Use ConvertToChromeTrace (chrome_trace_converter.h) to view the output.
+///
+/// THREAD SAFETY:
+///    Tracing calls may be made from any thread. OpenFile/CloseFile MUST NOT
+///    be called concurrently with each other.
+class BinaryBackend : public ::chip::Tracing::Backend
+{
+public:
+    static constexpr size_t kDefaultEventsPerThread                  = 8192;
+    static constexpr std::chrono::milliseconds kDefaultFlushInterval = std::chrono::milliseconds(20);
+
+    /// `eventsPerThread` is rounded up to a power of two.
+    BinaryBackend(size_t eventsPerThread                  = kDefaultEventsPerThread,
+                  std::chrono::milliseconds flushInterval = kDefaultFlushInterval);
+    ~BinaryBackend();
+
+    /// Start tracing output to the given file, closing any previous one
+    CHIP_ERROR OpenFile(const char * path);
+
+    /// Flush pending events and close the output file, if open. Events traced
+    /// while no file is open are discarded.
+    void CloseFile();
+
+    /// Total number of events dropped because a thread buffer was full
+    uint64_t DroppedEventCount() const { return mDroppedEvents.load(std::memory_order_relaxed); }
+
+    void TraceBegin(const char * label, const char * group) override;
+    void TraceEnd(const char * label, const char * group) override;
+    void TraceInstant(const char * label, const char * group) override;
+    void TraceCounter(const char * label) override;
+    void LogMessageSend(MessageSendInfo &) override;
+    void LogMessageReceived(MessageReceivedInfo &) override;
+    void LogMetricEvent(const MetricEvent &) override;
+    void Close() override { CloseFile(); }
+
+private:
+    /// An event as stored in the thread buffers, before its strings are resolved
+    struct Event
+    {
+        uint64_t timestampNs;
+        const char * label;
+        const char * group;
+        RecordKind kind;
+        uint8_t aux;
+        uint8_t args[kRecordArgsSize];
+    };
+
+    class ThreadBuffer;
+
+    /// Buffer last used by the current thread, and the backend instance it belongs to
+    struct ThreadBufferCache
+    {
+        uint32_t instanceId;
+        ThreadBuffer * buffer;
+    };
+    static thread_local ThreadBufferCache sThreadBuffer;
+
+    ThreadBuffer * GetThreadBuffer();
+    void Append(RecordKind kind, const char * label, const char * group);
+    void Append(Event & event);
+
+    void FlushLoop();
+    void Flush();
+    void WriteRecord(const Record & record);
+    void WritePendingRecords();
+    uint32_t GetStringId(const char * string);
+
+    const size_t mEventsPerThread;
+    const std::chrono::milliseconds mFlushInterval;
+    const uint32_t mInstanceId;
+
+    std::atomic<bool> mRecording{ false };
+    std::atomic<uint64_t> mDroppedEvents{ 0 };
+
+    // Thread buffers are created on first use by each thread and live as long
+    // as the backend, so traced threads may keep using them without locking.
+    std::mutex mBuffersMutex;
+    std::vector<std::unique_ptr<ThreadBuffer>> mBuffers;
+
+    // State below is only used by the flushing thread (or by OpenFile/CloseFile
+    // while no flushing thread runs)
+    std::thread mFlushThread;
+    std::mutex mFlushMutex;
+    std::condition_variable mFlushCondition;
+    bool mStopFlushing = false;
+
+    std::fstream mOutputFile;
+    std::vector<uint8_t> mWriteBuffer;
+    std::vector<ThreadBuffer *> mFlushBuffers;
+    std::unordered_map<const char *, uint32_t> mStringIds;
+};
+
+} // namespace Binary
+} // namespace Tracing
+} // namespace chip
@@ -0,0 +1,316 @@
+/*
+ *
+ *    Copyright (c) 2024 Project CHIP Authors
+ *    All rights reserved.
+ *
+ *    Licensed under the Apache License, Version 2.0 (the "License");
+ *    you may not use this file except in compliance with the License.
+ *    You may obtain a copy of the License at
+ *
+ *        http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *    Unless required by applicable law or agreed to in writing, software
+ *    distributed under the License is distributed on an "AS IS" BASIS,
+ *    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *    See the License for the specific language governing permissions and
+ *    limitations under the License.
+ */
+
+#include <tracing/binary/chrome_trace_converter.h>
+
+#include <lib/support/CodeUtils.h>
+#include <tracing/binary/binary_format.h>
+#include <tracing/metric_event.h>
+
+#include <inttypes.h>
+#include <stdio.h>
+#include <string.h>
+
+#include <string>
+#include <unordered_map>
+
+namespace chip {
+namespace Tracing {
+namespace Binary {
+
+namespace {
+
+// Longer strings are treated as a corrupt trace
+constexpr uint32_t kMaxStringLength = 4096;
+
+const char * MessageTypeName(uint8_t messageType)
+{
+    // Values of OutgoingMessageType and IncomingMessageType
+    switch (messageType)
+    {
+    case 0:
+        return "Group";
+    case 1:
+        return "Secure";
+    case 2:
+        return "Unauthenticated";
+    default:
+        return "UNKNOWN";
+    }
+}
+
+class ChromeTraceWriter
+{
+public:
+    ChromeTraceWriter(std::ostream & output) : mOutput(output) {}
+
+    void Start() { mOutput << "{\"traceEvents\":["; }
+    void Finish() { mOutput << "\n]}\n"; }
+
+    /// Writes the fields common to all events. The event is left open for
+    /// optional arguments, and MUST be completed with EndEvent.
+    void StartEvent(const Record & record, const char * phase, const std::string & name, const std::string & category)
+    {
+        mOutput << (mFirstEvent ? "\n" : ",\n");
+        mFirstEvent = false;
+
+        mOutput << "{\"name\":";
+        WriteString(name);
+        mOutput << ",\"cat\":";
+        WriteString(category);
+
+        char timestamp[32];
+        snprintf(timestamp, sizeof(timestamp), "%" PRIu64 ".%03u", record.timestampNs / 1000,
+                 static_cast<unsigned>(record.timestampNs % 1000));
+        mOutput << ",\"ph\":\"" << phase << "\",\"ts\":" << timestamp << ",\"pid\":0,\"tid\":" << record.thread;
+    }
+
+    void StartArgs() { mOutput << ",\"args\":{"; }
+    void EndArgs() { mOutput << "}"; }
+    void EndEvent() { mOutput << "}"; }
+
+    template <typename T>
+    ChromeTraceWriter & Arg(const char * name, T value, bool first = false)
+    {
+        mOutput << (first ? "\"" : ",\"") << name << "\":" << value;
+        return *this;
+    }
+
+    ChromeTraceWriter & HexArg(const char * name, uint32_t value, bool first = false)
+    {
+        char hex[16];
+        snprintf(hex, sizeof(hex), "\"0x%08" PRIX32 "\"", value);
+        return Arg(name, hex, first);
+    }
+
+    void WriteString(const std::string & value)
+    {
+        mOutput << '"';
+        for (char c : value)
+        {
+            switch (c)
+            {
+            case '"':
+                mOutput << "\\\"";
+                break;
+            case '\\':
+                mOutput << "\\\\";
+                break;
+            default:
+                if (static_cast<unsigned char>(c) < 0x20)
+                {
+                    char escaped[8];
+                    snprintf(escaped, sizeof(escaped), "\\u%04x", static_cast<unsigned>(c));
+                    mOutput << escaped;
+                }
+                else
+                {
+                    mOutput << c;
+                }
+                break;
+            }
+        }
+        mOutput << '"';
+    }
+
+private:
+    std::ostream & mOutput;
+    bool mFirstEvent = true;
+};
+
+class Converter
+{
+public:
+    Converter(std::istream & input, std::ostream & output) : mInput(input), mWriter(output) {}
+
+    CHIP_ERROR Convert()
+    {
+        uint8_t header[kFileHeaderSize];
+        VerifyOrReturnError(Read(header, sizeof(header)), CHIP_ERROR_INVALID_FILE_IDENTIFIER);
+        VerifyOrReturnError(memcmp(header, kFileMagic, sizeof(kFileMagic)) == 0, CHIP_ERROR_INVALID_FILE_IDENTIFIER);
+        VerifyOrReturnError(Encoding::LittleEndian::Get16(header + 8) == kFileFormatVersion, CHIP_ERROR_VERSION_MISMATCH);
+        VerifyOrReturnError(Encoding::LittleEndian::Get16(header + 10) == kRecordSize, CHIP_ERROR_VERSION_MISMATCH);
+
+        mWriter.Start();
+
+        uint8_t buffer[kRecordSize];
+        while (Read(buffer, sizeof(buffer)))
+        {
+            Record record;
+            record.Decode(buffer);
+            if (record.kind == RecordKind::kString)
+            {
+                VerifyOrReturnError(ReadString(record), CHIP_ERROR_INVALID_ARGUMENT);
+                continue;
+            }
+            ConvertRecord(record);
+        }
+
+        mWriter.Finish();
+        return CHIP_NO_ERROR;
+    }
+
+private:
+    bool Read(uint8_t * buffer, size_t size)
+    {
+        mInput.read(reinterpret_cast<char *>(buffer), static_cast<std::streamsize>(size));
+        return static_cast<size_t>(mInput.gcount()) == size;
+    }
+
+    bool ReadString(const Record & record)
+    {
+        const uint32_t length = record.ArgUInt32();
+        VerifyOrReturnValue(record.label != kNoStringId && length <= kMaxStringLength, false);
+
+        std::string & value = mStrings[record.label];
+        value.resize(length);
+        mInput.read(&value[0], static_cast<std::streamsize>(length));
+
+        // A string cut short is the end of a truncated trace, not an error
+        return true;
+    }
+
+    const std::string & String(uint32_t id)
+    {
+        static const std::string kUnknown = "<unknown>";
+        auto it                           = mStrings.find(id);
+        return (it == mStrings.end()) ? kUnknown : it->second;
+    }
+
+    void ConvertRecord(const Record & record)
+    {
+        switch (record.kind)
+        {
+        case RecordKind::kBegin:
+            mWriter.StartEvent(record, "B", String(record.label), String(record.ArgUInt32()));
+            break;
+        case RecordKind::kEnd:
+            mWriter.StartEvent(record, "E", String(record.label), String(record.ArgUInt32()));
+            break;
+        case RecordKind::kInstant:
+            mWriter.StartEvent(record, "i", String(record.label), String(record.ArgUInt32()));
+            mWriter.Arg("s", "\"t\"");
+            break;
+        case RecordKind::kCounter: {
+            const std::string & label = String(record.label);
+            mWriter.StartEvent(record, "C", label, "Counter");
+            mWriter.StartArgs();
+            mWriter.Arg("count", ++mCounters[label], true);
+            mWriter.EndArgs();
+            break;
+        }
+        case RecordKind::kMetricBegin:
+        case RecordKind::kMetricEnd:
+        case RecordKind::kMetricInstant:
+            ConvertMetric(record);
+            break;
+        case RecordKind::kMessageSend:
+        case RecordKind::kMessageReceived:
+            ConvertMessage(record);
+            break;
+        case RecordKind::kDropped:
+            mWriter.StartEvent(record, "i", "Dropped events", "Tracing");
+            mWriter.Arg("s", "\"t\"");
+            mWriter.StartArgs();
+            mWriter.Arg("count", record.ArgUInt32(), true);
+            mWriter.EndArgs();
+            break;
+        default:
+            // Unknown records are skipped, so newer writers stay readable
+            return;
+        }
+        mWriter.EndEvent();
+    }
+
+    void ConvertMetric(const Record & record)
+    {
+        // Metric begin/end pairs are not guaranteed to nest, so they are reported as async events
+        switch (record.kind)
+        {
+        case RecordKind::kMetricBegin:
+            mWriter.StartEvent(record, "b", String(record.label), "Metric");
+            mWriter.Arg("id", record.label);
+            break;
+        case RecordKind::kMetricEnd:
+            mWriter.StartEvent(record, "e", String(record.label), "Metric");
+            mWriter.Arg("id", record.label);
+            break;
+        default:
+            mWriter.StartEvent(record, "i", String(record.label), "Metric");
+            mWriter.Arg("s", "\"t\"");
+            break;
+        }
+
+        using ValueType = MetricEvent::Value::Type;
+        switch (static_cast<ValueType>(record.aux))
+        {
+        case ValueType::kInt32:
+            mWriter.StartArgs();
+            mWriter.Arg("value", static_cast<int32_t>(record.ArgUInt32()), true);
+            mWriter.EndArgs();
+            break;
+        case ValueType::kUInt32:
+            mWriter.StartArgs();
+            mWriter.Arg("value", record.ArgUInt32(), true);
+            mWriter.EndArgs();
+            break;
+        case ValueType::kChipErrorCode:
+            mWriter.StartArgs();
+            mWriter.HexArg("error", record.ArgUInt32(), true);
+            mWriter.EndArgs();
+            break;
+        default:
+            break;
+        }
+    }
+
+    void ConvertMessage(const Record & record)
+    {
+        MessageArgs args;
+        args.Decode(record.args);
+
+        mWriter.StartEvent(record, "i", String(record.label), "Messaging");
+        mWriter.Arg("s", "\"t\"");
+        mWriter.StartArgs();
+        mWriter.Arg("messageType", std::string("\"") + MessageTypeName(record.aux) + "\"", true)
+            .HexArg("protocolId", args.protocolId)
+            .Arg("opcode", static_cast<unsigned>(args.messageType))
+            .Arg("exchangeId", args.exchangeId)
+            .Arg("sessionId", args.sessionId)
+            .Arg("initiator", (args.flags & MessageArgs::kFlagInitiator) ? "true" : "false")
+            .Arg("needsAck", (args.flags & MessageArgs::kFlagNeedsAck) ? "true" : "false")
+            .Arg("size", args.payloadSize);
+        mWriter.EndArgs();
+    }
+
+    std::istream & mInput;
+    ChromeTraceWriter mWriter;
+    std::unordered_map<uint32_t, std::string> mStrings;
+    std::unordered_map<std::string, uint64_t> mCounters;
+};
+
+} // namespace
+
+CHIP_ERROR ConvertToChromeTrace(std::istream & input, std::ostream & output)
+{
+    return Converter(input, output).Convert();
+}
+
+} // namespace Binary
+} // namespace Tracing
+} // namespace chip
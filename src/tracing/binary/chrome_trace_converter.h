@@ -0,0 +1,41 @@
+/*
+ *
+ *    Copyright (c) 2024 Project CHIP Authors
+ *    All rights reserved.
+ *
+ *    Licensed under the Apache License, Version 2.0 (the "License");
+ *    you may not use this file except in compliance with the License.
+ *    You may obtain a copy of the License at
+ *
+ *        http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *    Unless required by applicable law or agreed to in writing, software
+ *    distributed under the License is distributed on an "AS IS" BASIS,
+ *    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *    See the License for the specific language governing permissions and
+ *    limitations under the License.
+ */
+#pragma once
+
+#include <lib/core/CHIPError.h>
+
+#include <istream>
+#include <ostream>
+
+namespace chip {
+namespace Tracing {
+namespace Binary {
+
+/// Converts a trace written by BinaryBackend to the Chrome trace event JSON
+/// format, as loaded by chrome://tracing or https://ui.perfetto.dev
+///
+/// A trace cut short (e.g. because the traced process crashed) is converted
+/// up to its last complete record.
+///
+/// Returns CHIP_ERROR_INVALID_FILE_IDENTIFIER if the input is not a binary
+/// trace and CHIP_ERROR_VERSION_MISMATCH for unsupported format versions.
+CHIP_ERROR ConvertToChromeTrace(std::istream & input, std::ostream & output);
+
+} // namespace Binary
+} // namespace Tracing
+} // namespace chip
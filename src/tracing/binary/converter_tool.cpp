@@ -0,0 +1,75 @@
+/*
+ *
+ *    Copyright (c) 2024 Project CHIP Authors
+ *    All rights reserved.
+ *
+ *    Licensed under the Apache License, Version 2.0 (the "License");
+ *    you may not use this file except in compliance with the License.
+ *    You may obtain a copy of the License at
+ *
+ *        http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *    Unless required by applicable law or agreed to in writing, software
+ *    distributed under the License is distributed on an "AS IS" BASIS,
+ *    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *    See the License for the specific language governing permissions and
+ *    limitations under the License.
+ */
+
+#include <tracing/binary/chrome_trace_converter.h>
+
+#include <stdio.h>
+
+#include <fstream>
+
+namespace {
+
+// clang-format off
+const char * const sHelp =
+    "Usage: chip-binary-trace-converter <input> <output>\n"
+    "\n"
+    "Converts a binary trace (written via --trace-to binary:<path>) to a Chrome\n"
+    "trace event JSON file, viewable in chrome://tracing or https://ui.perfetto.dev\n"
+    "\n";
+// clang-format on
+
+} // namespace
+
+extern "C" int main(int argc, const char ** argv)
+{
+    if (argc != 3)
+    {
+        fputs(sHelp, stderr);
+        return -1;
+    }
+
+    std::ifstream input(argv[1], std::ios_base::in | std::ios_base::binary);
+    if (!input)
+    {
+        fprintf(stderr, "Failed to open %s\n", argv[1]);
+        return -1;
+    }
+
+    std::ofstream output(argv[2], std::ios_base::out | std::ios_base::trunc);
+    if (!output)
+    {
+        fprintf(stderr, "Failed to open %s\n", argv[2]);
+        return -1;
+    }
+
+    CHIP_ERROR err = chip::Tracing::Binary::ConvertToChromeTrace(input, output);
+    if (err != CHIP_NO_ERROR)
+    {
+        fprintf(stderr, "Failed to convert %s: %" CHIP_ERROR_FORMAT "\n", argv[1], err.Format());
+        return -1;
+    }
+
+    output.flush();
+    if (!output)
+    {
+        fprintf(stderr, "Failed to write %s\n", argv[2]);
+        return -1;
+    }
+
+    return 0;
+}
@@ -72,11 +72,41 @@ constexpr MetricKey kMetricDeviceCASESessionSigma2Resume = "core_dev_case_sessio
 // CASE Session SigmaFinished
 constexpr MetricKey kMetricDeviceCASESessionSigmaFinished = "core_dev_case_session_sigma_finished";
 
+// Bulk CASE session establishment, until every peer connected or failed
+constexpr MetricKey kMetricCASESessionBulkConnect = "core_case_session_bulk_connect";
+
+// Time a PASE session step spent on the Matter thread, in microseconds
+constexpr MetricKey kMetricPASESessionEventLoopTime = "core_pase_session_event_loop_time";
+
 // MRP Retry Counter
 constexpr MetricKey kMetricDeviceRMPRetryCount = "core_dev_rmp_retry_count";
 
 // Subscription setup
 constexpr MetricKey kMetricDeviceSubscriptionSetup = "core_dev_subscription_setup";
 
+// Reporting engine run pass, value is its duration in microseconds
+constexpr MetricKey kMetricReportingEngineRun = "core_im_reporting_run";
+
+// ReadHandlers serviced by a reporting engine run pass
+constexpr MetricKey kMetricReportingEngineReadHandlersServiced = "core_im_reporting_read_handlers_serviced";
+
+// Building and sending a single report (message), begin/end with the resulting error
+constexpr MetricKey kMetricReportingEngineBuildReport = "core_im_reporting_build_report";
+
+// Attribute paths expanded while building a single report
+constexpr MetricKey kMetricReportingEngineAttributePaths = "core_im_reporting_attribute_paths";
+
+// Size of a single report payload in bytes
+constexpr MetricKey kMetricReportingEngineReportBytes = "core_im_reporting_report_bytes";
+
+// Report sent with more chunks to follow
+constexpr MetricKey kMetricReportingEngineChunkedReport = "core_im_reporting_chunked_report";
+
+// Attribute path inserted into a full dirty set, forcing existing paths to be merged
+constexpr MetricKey kMetricReportingEngineDirtySetOverflow = "core_im_reporting_dirty_set_overflow";
+
+// Time from an attribute change to the start of the subscription report including it, in milliseconds
+constexpr MetricKey kMetricReportingEngineReportLatency = "core_im_reporting_report_latency";
+
 } // namespace Tracing
 } // namespace chip
@@ -0,0 +1,137 @@
+/*
+ *
+ *    Copyright (c) 2024 Project CHIP Authors
+ *    All rights reserved.
+ *
+ *    Licensed under the Apache License, Version 2.0 (the "License");
+ *    you may not use this file except in compliance with the License.
+ *    You may obtain a copy of the License at
+ *
+ *        http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *    Unless required by applicable law or agreed to in writing, software
+ *    distributed under the License is distributed on an "AS IS" BASIS,
+ *    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *    See the License for the specific language governing permissions and
+ *    limitations under the License.
+ */
+
+#include <tracing/metrics/histogram.h>
+
+#include <lib/support/CodeUtils.h>
+
+namespace chip {
+namespace Tracing {
+namespace Metrics {
+
+namespace {
+
+unsigned HighestBit(uint32_t value)
+{
+    unsigned bit = 0;
+    while (value >>= 1)
+    {
+        bit++;
+    }
+    return bit;
+}
+
+/// Upper bound of the bucket holding the value of the given (1-based) rank
+uint32_t ValueAtRank(const uint32_t * buckets, uint64_t rank)
+{
+    uint64_t seen = 0;
+    for (size_t i = 0; i < Histogram::kBucketCount; i++)
+    {
+        seen += buckets[i];
+        if (seen >= rank)
+        {
+            return Histogram::BucketUpperBound(i);
+        }
+    }
+    return UINT32_MAX;
+}
+
+uint32_t Percentile(const uint32_t * buckets, uint64_t count, uint32_t perMille, const HistogramSnapshot & snapshot)
+{
+    // Rank of the percentile, rounded up so that e.g. p99 of 10 values is the largest one
+    const uint64_t rank  = (count * perMille + 999) / 1000;
+    const uint32_t value = ValueAtRank(buckets, rank == 0 ? 1 : rank);
+
+    // Bucket bounds may be outside the range of values actually recorded
+    if (value > snapshot.max)
+    {
+        return snapshot.max;
+    }
+    return (value < snapshot.min) ? snapshot.min : value;
+}
+
+} // namespace
+
+size_t Histogram::BucketIndex(uint32_t value)
+{
+    if (value < kSubBucketCount)
+    {
+        return value;
+    }
+
+    const unsigned highestBit = HighestBit(value);
+    const unsigned shift      = highestBit - kSubBucketBits;
+    return (highestBit - kSubBucketBits + 1) * kSubBucketCount + ((value >> shift) & (kSubBucketCount - 1));
+}
+
+uint32_t Histogram::BucketUpperBound(size_t index)
+{
+    if (index < kSubBucketCount)
+    {
+        return static_cast<uint32_t>(index);
+    }
+
+    const unsigned highestBit = static_cast<unsigned>(index / kSubBucketCount) + kSubBucketBits - 1;
+    const unsigned shift      = highestBit - kSubBucketBits;
+    const uint64_t lowerBound = (uint64_t(1) << highestBit) | (uint64_t(index % kSubBucketCount) << shift);
+    return static_cast<uint32_t>(lowerBound + (uint64_t(1) << shift) - 1);
+}
+
+void Histogram::Record(uint32_t value)
+{
+    mBuckets[BucketIndex(value)].fetch_add(1, std::memory_order_relaxed);
+    mSum.fetch_add(value, std::memory_order_relaxed);
+
+    uint32_t current = mMin.load(std::memory_order_relaxed);
+    while (value < current && !mMin.compare_exchange_weak(current, value, std::memory_order_relaxed))
+    {
+    }
+
+    current = mMax.load(std::memory_order_relaxed);
+    while (value > current && !mMax.compare_exchange_weak(current, value, std::memory_order_relaxed))
+    {
+    }
+}
+
+void Histogram::Snapshot(HistogramSnapshot & snapshot) const
+{
+    uint32_t buckets[kBucketCount];
+    uint64_t count = 0;
+    for (size_t i = 0; i < kBucketCount; i++)
+    {
+        buckets[i] = mBuckets[i].load(std::memory_order_relaxed);
+        count += buckets[i];
+    }
+
+    snapshot = HistogramSnapshot();
+    VerifyOrReturn(count > 0);
+
+    // Use the bucket total as count, so that percentiles are consistent with it
+    snapshot.count = count;
+    snapshot.sum   = mSum.load(std::memory_order_relaxed);
+    snapshot.min   = mMin.load(std::memory_order_relaxed);
+    snapshot.max   = mMax.load(std::memory_order_relaxed);
+    snapshot.p50   = Percentile(buckets, count, 500, snapshot);
+    snapshot.p90   = Percentile(buckets, count, 900, snapshot);
+    snapshot.p99   = Percentile(buckets, count, 990, snapshot);
+    snapshot.p999  = Percentile(buckets, count, 999, snapshot);
+}
+
+} // namespace Metrics
+} // namespace Tracing
+} // namespace chip
@@ -0,0 +1,73 @@
+/*
+ *
+ *    Copyright (c) 2024 Project CHIP Authors
+ *    All rights reserved.
+ *
+ *    Licensed under the Apache License, Version 2.0 (the "License");
+ *    you may not use this file except in compliance with the License.
+ *    You may obtain a copy of the License at
+ *
+ *        http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *    Unless required by applicable law or agreed to in writing, software
+ *    distributed under the License is distributed on an "AS IS" BASIS,
+ *    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *    See the License for the specific language governing permissions and
+ *    limitations under the License.
+ */
+#pragma once
+
+#include <atomic>
+#include <stddef.h>
+#include <stdint.h>
+
+namespace chip {
+namespace Tracing {
+namespace Metrics {
+
+/// Point-in-time summary of a Histogram
+struct HistogramSnapshot
+{
+    uint64_t count = 0;
+    uint64_t sum   = 0;
+    uint32_t min   = 0;
+    uint32_t max   = 0;
+    uint32_t p50   = 0;
+    uint32_t p90   = 0;
+    uint32_t p99   = 0;
+    uint32_t p999  = 0;
+};
+
+/// Lock-free histogram of 32-bit values with log-linear (HDR style) buckets.
+///
+/// Values below 2^kSubBucketBits are counted exactly. Larger values are
+/// counted in buckets whose width is at most 1/2^kSubBucketBits of the value,
+/// so reported percentiles are within 6.25% of the recorded values.
+///
+/// Record may be called concurrently from any thread. Snapshots taken while
+/// values are recorded may be slightly inconsistent (e.g. count vs sum).
+class Histogram
+{
+public:
+    static constexpr unsigned kSubBucketBits = 4;
+    static constexpr size_t kSubBucketCount  = 1u << kSubBucketBits;
+    static constexpr size_t kBucketCount     = (32 - kSubBucketBits + 1) * kSubBucketCount;
+
+    void Record(uint32_t value);
+    void Snapshot(HistogramSnapshot & snapshot) const;
+
+    static size_t BucketIndex(uint32_t value);
+
+    /// Largest value counted in the given bucket
+    static uint32_t BucketUpperBound(size_t index);
+
+private:
+    std::atomic<uint32_t> mBuckets[kBucketCount] = {};
+    std::atomic<uint64_t> mSum{ 0 };
+    std::atomic<uint32_t> mMin{ UINT32_MAX };
+    std::atomic<uint32_t> mMax{ 0 };
+};
+
+} // namespace Metrics
+} // namespace Tracing
+} // namespace chip
@@ -0,0 +1,257 @@
+/*
+ *
+ *    Copyright (c) 2024 Project CHIP Authors
+ *    All rights reserved.
+ *
+ *    Licensed under the Apache License, Version 2.0 (the "License");
+ *    you may not use this file except in compliance with the License.
+ *    You may obtain a copy of the License at
+ *
+ *        http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *    Unless required by applicable law or agreed to in writing, software
+ *    distributed under the License is distributed on an "AS IS" BASIS,
+ *    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *    See the License for the specific language governing permissions and
+ *    limitations under the License.
+ */
+
+#include <tracing/metrics/metrics_backend.h>
+
+#include <lib/support/CodeUtils.h>
+#include <tracing/metric_event.h>
+
+#include <chrono>
+#include <string.h>
+
+namespace chip {
+namespace Tracing {
+namespace Metrics {
+
+namespace {
+
+uint64_t MonotonicTimestampUs()
+{
+    return static_cast<uint64_t>(
+        std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now().time_since_epoch()).count());
+}
+
+size_t HashKey(MetricKey key)
+{
+    // Keys are string literals: drop the low bits, which vary little between them
+    const uintptr_t value = reinterpret_cast<uintptr_t>(key);
+    return static_cast<size_t>((value >> 3) ^ (value >> 11));
+}
+
+} // namespace
+
+class MetricsBackend::Metric
+{
+public:
+    Metric(MetricKey key) : mKey(key) {}
+
+    MetricKey Key() const { return mKey; }
+
+    void Begin() { mBeginUs.store(MonotonicTimestampUs(), std::memory_order_relaxed); }
+
+    void End()
+    {
+        mEvents.fetch_add(1, std::memory_order_relaxed);
+
+        // Zero marks "no pending begin": a begin at time 0 would only lose its duration
+        const uint64_t begin = mBeginUs.exchange(0, std::memory_order_relaxed);
+        VerifyOrReturn(begin != 0);
+
+        const uint64_t duration = MonotonicTimestampUs() - begin;
+        mDurationsUs.Record(duration > UINT32_MAX ? UINT32_MAX : static_cast<uint32_t>(duration));
+    }
+
+    void Instant() { mEvents.fetch_add(1, std::memory_order_relaxed); }
+
+    void RecordValue(int64_t value)
+    {
+        mValue.store(value, std::memory_order_relaxed);
+        mHasValue.store(true, std::memory_order_relaxed);
+        mValues.Record(value < 0 ? 0 : (value > UINT32_MAX ? UINT32_MAX : static_cast<uint32_t>(value)));
+    }
+
+    void RecordError(uint32_t error)
+    {
+        if (error != CHIP_NO_ERROR.AsInteger())
+        {
+            mErrors.fetch_add(1, std::memory_order_relaxed);
+        }
+    }
+
+    void Snapshot(MetricSnapshot & snapshot) const
+    {
+        snapshot.key      = mKey;
+        snapshot.events   = mEvents.load(std::memory_order_relaxed);
+        snapshot.errors   = mErrors.load(std::memory_order_relaxed);
+        snapshot.hasValue = mHasValue.load(std::memory_order_relaxed);
+        snapshot.value    = mValue.load(std::memory_order_relaxed);
+        mValues.Snapshot(snapshot.values);
+        mDurationsUs.Snapshot(snapshot.durationsUs);
+    }
+
+private:
+    const MetricKey mKey;
+    std::atomic<uint64_t> mEvents{ 0 };
+    std::atomic<uint64_t> mErrors{ 0 };
+    std::atomic<uint64_t> mBeginUs{ 0 };
+    std::atomic<int64_t> mValue{ 0 };
+    std::atomic<bool> mHasValue{ false };
+    Histogram mValues;
+    Histogram mDurationsUs;
+};
+
+MetricsBackend::MetricsBackend() = default;
+
+MetricsBackend::~MetricsBackend() = default;
+
+MetricsBackend::Metric * MetricsBackend::Find(MetricKey key)
+{
+    const size_t start = HashKey(key);
+    for (size_t i = 0; i < kSlotCount; i++)
+    {
+        Slot & slot                = mSlots[(start + i) % kSlotCount];
+        const char * const slotKey = slot.key.load(std::memory_order_acquire);
+        if (slotKey == key)
+        {
+            return slot.metric.load(std::memory_order_relaxed);
+        }
+        if (slotKey == nullptr)
+        {
+            break;
+        }
+    }
+    return Insert(key);
+}
+
+MetricsBackend::Metric * MetricsBackend::Insert(MetricKey key)
+{
+    std::lock_guard<std::mutex> lock(mInsertMutex);
+
+    // Look for the key again (another thread may have inserted it), and for a free slot
+    const size_t start = HashKey(key);
+    Slot * freeSlot    = nullptr;
+    for (size_t i = 0; i < kSlotCount; i++)
+    {
+        Slot & slot                = mSlots[(start + i) % kSlotCount];
+        const char * const slotKey = slot.key.load(std::memory_order_relaxed);
+        if (slotKey == key)
+        {
+            return slot.metric.load(std::memory_order_relaxed);
+        }
+        if (slotKey == nullptr)
+        {
+            freeSlot = &slot;
+            break;
+        }
+    }
+
+    // The same key string may be seen at different addresses
+    Metric * metric    = nullptr;
+    const size_t count = mMetricCount.load(std::memory_order_relaxed);
+    for (size_t i = 0; i < count; i++)
+    {
+        if (strcmp(mMetrics[i]->Key(), key) == 0)
+        {
+            metric = mMetrics[i].get();
+            break;
+        }
+    }
+
+    if (metric == nullptr && count < kMaxMetrics)
+    {
+        mMetrics[count] = std::make_unique<Metric>(key);
+        metric          = mMetrics[count].get();
+        mMetricCount.store(count + 1, std::memory_order_release);
+    }
+
+    // Keys that could not be tracked get a slot too, without a metric: no metric is added once kMaxMetrics is reached,
+    // so their later events are counted as overflow by Find() without taking the lock.
+    if (freeSlot != nullptr)
+    {
+        freeSlot->metric.store(metric, std::memory_order_relaxed);
+        freeSlot->key.store(key, std::memory_order_release);
+    }
+
+    return metric;
+}
+
+void MetricsBackend::TraceCounter(const char * label)
+{
+    Metric * metric = Find(label);
+    if (metric == nullptr)
+    {
+        mOverflowCount.fetch_add(1, std::memory_order_relaxed);
+        return;
+    }
+    metric->Instant();
+}
+
+void MetricsBackend::LogMetricEvent(const MetricEvent & event)
+{
+    Metric * metric = Find(event.key());
+    if (metric == nullptr)
+    {
+        mOverflowCount.fetch_add(1, std::memory_order_relaxed);
+        return;
+    }
+
+    switch (event.type())
+    {
+    case MetricEvent::Type::kBeginEvent:
+        metric->Begin();
+        break;
+    case MetricEvent::Type::kEndEvent:
+        metric->End();
+        break;
+    case MetricEvent::Type::kInstantEvent:
+    default:
+        metric->Instant();
+        break;
+    }
+
+    using ValueType = MetricEvent::Value::Type;
+    switch (event.ValueType())
+    {
+    case ValueType::kInt32:
+        metric->RecordValue(event.ValueInt32());
+        break;
+    case ValueType::kUInt32:
+        metric->RecordValue(event.ValueUInt32());
+        break;
+    case ValueType::kChipErrorCode:
+        metric->RecordError(event.ValueErrorCode());
+        break;
+    default:
+        break;
+    }
+}
+
+CHIP_ERROR MetricsBackend::GetSnapshot(size_t index, MetricSnapshot & snapshot) const
+{
+    VerifyOrReturnError(index < MetricCount(), CHIP_ERROR_NOT_FOUND);
+    mMetrics[index]->Snapshot(snapshot);
+    return CHIP_NO_ERROR;
+}
+
+CHIP_ERROR MetricsBackend::GetSnapshot(MetricKey key, MetricSnapshot & snapshot) const
+{
+    const size_t count = MetricCount();
+    for (size_t i = 0; i < count; i++)
+    {
+        if (strcmp(mMetrics[i]->Key(), key) == 0)
+        {
+            mMetrics[i]->Snapshot(snapshot);
+            return CHIP_NO_ERROR;
+        }
+    }
+    return CHIP_ERROR_NOT_FOUND;
+}
+
+} // namespace Metrics
+} // namespace Tracing
+} // namespace chip
@@ -0,0 +1,119 @@
+/*
+ *
+ *    Copyright (c) 2024 Project CHIP Authors
+ *    All rights reserved.
+ *
+ *    Licensed under the Apache License, Version 2.0 (the "License");
+ *    you may not use this file except in compliance with the License.
+ *    You may obtain a copy of the License at
+ *
+ *        http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *    Unless required by applicable law or agreed to in writing, software
+ *    distributed under the License is distributed on an "AS IS" BASIS,
+ *    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *    See the License for the specific language governing permissions and
+ *    limitations under the License.
+ */
+#pragma once
+
+#include <lib/core/CHIPError.h>
+#include <tracing/backend.h>
+#include <tracing/metric_keys.h>
+#include <tracing/metrics/histogram.h>
+
+#include <atomic>
+#include <memory>
+#include <mutex>
+
+namespace chip {
+namespace Tracing {
+namespace Metrics {
+
+/// Point-in-time values of a single metric
+struct MetricSnapshot
+{
+    MetricKey key = nullptr;
+
+    /// Instant and end events, plus MATTER_TRACE_COUNTER calls for the key
+    uint64_t events = 0;
+
+    /// Events carrying a CHIP_ERROR other than CHIP_NO_ERROR
+    uint64_t errors = 0;
+
+    /// Last integer value logged for the key (gauge), if any
+    bool hasValue = false;
+    int64_t value = 0;
+
+    /// Integer values logged for the key. Negative values are counted as 0.
+    HistogramSnapshot values;
+
+    /// Time between begin and end events of the key, in microseconds
+    HistogramSnapshot durationsUs;
+};
+
+/// A Backend that aggregates MetricEvents (MATTER_LOG_METRIC*) and trace
+/// counters into per-key counters, gauges and histograms that can be read
+/// at any time, e.g. to export them (see prometheus_exporter.h).
+///
+/// Recording is lock-free: metrics are found through a hash table keyed by
+/// MetricKey pointer, and only the first event seen for a given pointer
+/// takes a lock (to create the metric, to alias it when the same key
+/// string lives at another address, or to remember that the key is not
+/// tracked because kMaxMetrics was reached).
+///
+/// Durations are measured from the most recent begin event of the same key.
+/// MetricEvent carries no instance id, so overlapping begin/end pairs of one
+/// key (e.g. concurrent CASE sessions) are not told apart: each end event is
+/// paired with the latest unmatched begin, and end events without a begin are
+/// only counted.
+///
+/// Keys MUST be constant strings (as already required for all tracing labels).
+class MetricsBackend : public ::chip::Tracing::Backend
+{
+public:
+    static constexpr size_t kMaxMetrics = 64;
+
+    MetricsBackend();
+    ~MetricsBackend();
+
+    /// Number of metrics seen so far. Metrics are never removed, so indexes
+    /// below this count stay valid.
+    size_t MetricCount() const { return mMetricCount.load(std::memory_order_acquire); }
+
+    CHIP_ERROR GetSnapshot(size_t index, MetricSnapshot & snapshot) const;
+    CHIP_ERROR GetSnapshot(MetricKey key, MetricSnapshot & snapshot) const;
+
+    /// Events that were not recorded because kMaxMetrics was reached
+    uint64_t OverflowCount() const { return mOverflowCount.load(std::memory_order_relaxed); }
+
+    void TraceCounter(const char * label) override;
+    void LogMetricEvent(const MetricEvent & event) override;
+
+private:
+    class Metric;
+
+    struct Slot
+    {
+        std::atomic<const char *> key{ nullptr };
+        // Null for keys seen after kMaxMetrics was reached
+        std::atomic<Metric *> metric{ nullptr };
+    };
+
+    // Room for every metric plus aliases, kept sparse for short probes
+    static constexpr size_t kSlotCount = 4 * kMaxMetrics;
+
+    Metric * Find(MetricKey key);
+    Metric * Insert(MetricKey key);
+
+    Slot mSlots[kSlotCount];
+
+    std::mutex mInsertMutex;
+    std::unique_ptr<Metric> mMetrics[kMaxMetrics];
+    std::atomic<size_t> mMetricCount{ 0 };
+    std::atomic<uint64_t> mOverflowCount{ 0 };
+};
+
+} // namespace Metrics
+} // namespace Tracing
+} // namespace chip
@@ -0,0 +1,293 @@
+/*
+ *
+ *    Copyright (c) 2024 Project CHIP Authors
+ *    All rights reserved.
+ *
+ *    Licensed under the Apache License, Version 2.0 (the "License");
+ *    you may not use this file except in compliance with the License.
+ *    You may obtain a copy of the License at
+ *
+ *        http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *    Unless required by applicable law or agreed to in writing, software
+ *    distributed under the License is distributed on an "AS IS" BASIS,
+ *    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *    See the License for the specific language governing permissions and
+ *    limitations under the License.
+ */
+
+#include <tracing/metrics/prometheus_exporter.h>
+
+#include <lib/support/CodeUtils.h>
+#include <lib/support/EnforceFormat.h>
+#include <lib/support/logging/CHIPLogging.h>
+#include <system/SystemError.h>
+
+#include <ctype.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <inttypes.h>
+#include <poll.h>
+#include <stdarg.h>
+#include <stdio.h>
+#include <string.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+namespace chip {
+namespace Tracing {
+namespace Metrics {
+
+namespace {
+
+/// Metric names may only contain [a-zA-Z0-9_:]
+std::string MetricName(MetricKey key)
+{
+    std::string name = "matter_";
+    for (const char * c = key; *c != '\0'; c++)
+    {
+        const bool valid = isalnum(static_cast<unsigned char>(*c)) || *c == '_' || *c == ':';
+        name += valid ? *c : '_';
+    }
+    return name;
+}
+
+void AppendLine(std::string & output, const char * format, ...) ENFORCE_FORMAT(2, 3);
+
+void AppendLine(std::string & output, const char * format, ...)
+{
+    char line[256];
+
+    va_list args;
+    va_start(args, format);
+    vsnprintf(line, sizeof(line), format, args);
+    va_end(args);
+
+    output += line;
+    output += '\n';
+}
+
+void AppendSummary(std::string & output, const std::string & name, const HistogramSnapshot & histogram, double scale)
+{
+    AppendLine(output, "# TYPE %s summary", name.c_str());
+    AppendLine(output, "%s{quantile=\"0.5\"} %.9g", name.c_str(), histogram.p50 * scale);
+    AppendLine(output, "%s{quantile=\"0.9\"} %.9g", name.c_str(), histogram.p90 * scale);
+    AppendLine(output, "%s{quantile=\"0.99\"} %.9g", name.c_str(), histogram.p99 * scale);
+    AppendLine(output, "%s{quantile=\"0.999\"} %.9g", name.c_str(), histogram.p999 * scale);
+    AppendLine(output, "%s_sum %.9g", name.c_str(), static_cast<double>(histogram.sum) * scale);
+    AppendLine(output, "%s_count %" PRIu64, name.c_str(), histogram.count);
+}
+
+/// Writes all of `data` to a file (or, with `isSocket`, to a socket without raising SIGPIPE)
+bool WriteAll(int fd, const std::string & data, bool isSocket = false)
+{
+    size_t written = 0;
+    while (written < data.size())
+    {
+        const ssize_t result = isSocket ? send(fd, data.data() + written, data.size() - written, MSG_NOSIGNAL)
+                                        : write(fd, data.data() + written, data.size() - written);
+        if (result < 0 && errno == EINTR)
+        {
+            continue;
+        }
+        VerifyOrReturnValue(result > 0, false);
+        written += static_cast<size_t>(result);
+    }
+    return true;
+}
+
+} // namespace
+
+std::string FormatPrometheusText(const MetricsBackend & backend)
+{
+    std::string output;
+
+    const size_t count = backend.MetricCount();
+    for (size_t i = 0; i < count; i++)
+    {
+        MetricSnapshot snapshot;
+        if (backend.GetSnapshot(i, snapshot) != CHIP_NO_ERROR)
+        {
+            continue;
+        }
+
+        const std::string name = MetricName(snapshot.key);
+
+        AppendLine(output, "# TYPE %s_events_total counter", name.c_str());
+        AppendLine(output, "%s_events_total %" PRIu64, name.c_str(), snapshot.events);
+        AppendLine(output, "# TYPE %s_errors_total counter", name.c_str());
+        AppendLine(output, "%s_errors_total %" PRIu64, name.c_str(), snapshot.errors);
+
+        if (snapshot.hasValue)
+        {
+            AppendLine(output, "# TYPE %s_value gauge", name.c_str());
+            AppendLine(output, "%s_value %" PRId64, name.c_str(), snapshot.value);
+            AppendSummary(output, name + "_values", snapshot.values, 1);
+        }
+
+        if (snapshot.durationsUs.count > 0)
+        {
+            AppendSummary(output, name + "_duration_seconds", snapshot.durationsUs, 1e-6);
+        }
+    }
+
+    return output;
+}
+
+CHIP_ERROR PrometheusExporter::StartFile(const char * path, std::chrono::milliseconds interval)
+{
+    Stop();
+
+    mPath     = path;
+    mInterval = interval;
+    ReturnErrorOnFailure(WriteFile());
+
+    mStop   = false;
+    mThread = std::thread(&PrometheusExporter::FileLoop, this);
+    return CHIP_NO_ERROR;
+}
+
+CHIP_ERROR PrometheusExporter::StartUnixSocket(const char * path)
+{
+    Stop();
+
+    sockaddr_un address = {};
+    address.sun_family  = AF_UNIX;
+    VerifyOrReturnError(strlen(path) < sizeof(address.sun_path), CHIP_ERROR_INVALID_ARGUMENT);
+    strncpy(address.sun_path, path, sizeof(address.sun_path) - 1);
+
+    VerifyOrReturnError(pipe(mWakeFds) == 0, CHIP_ERROR_POSIX(errno));
+
+    mPath          = path;
+    mSocketFd      = socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0);
+    CHIP_ERROR err = (mSocketFd < 0) ? CHIP_ERROR_POSIX(errno) : CHIP_NO_ERROR;
+
+    // Replace a socket left over by a previous run
+    unlink(path);
+    if (err == CHIP_NO_ERROR && bind(mSocketFd, reinterpret_cast<const sockaddr *>(&address), sizeof(address)) != 0)
+    {
+        err = CHIP_ERROR_POSIX(errno);
+    }
+    if (err == CHIP_NO_ERROR && listen(mSocketFd, 4) != 0)
+    {
+        err = CHIP_ERROR_POSIX(errno);
+    }
+
+    if (err != CHIP_NO_ERROR)
+    {
+        Stop();
+        return err;
+    }
+
+    mStop   = false;
+    mThread = std::thread(&PrometheusExporter::SocketLoop, this);
+    return CHIP_NO_ERROR;
+}
+
+void PrometheusExporter::Stop()
+{
+    if (mThread.joinable())
+    {
+        {
+            std::lock_guard<std::mutex> lock(mMutex);
+            mStop = true;
+        }
+        mCondition.notify_one();
+        if (mWakeFds[1] != kInvalidFd)
+        {
+            const char wake = 0;
+            IgnoreUnusedVariable(write(mWakeFds[1], &wake, 1));
+        }
+        mThread.join();
+    }
+
+    if (mSocketFd != kInvalidFd)
+    {
+        close(mSocketFd);
+        unlink(mPath.c_str());
+        mSocketFd = kInvalidFd;
+    }
+    for (int & fd : mWakeFds)
+    {
+        if (fd != kInvalidFd)
+        {
+            close(fd);
+            fd = kInvalidFd;
+        }
+    }
+}
+
+CHIP_ERROR PrometheusExporter::WriteFile()
+{
+    const std::string temporaryPath = mPath + ".tmp";
+
+    const int fd = open(temporaryPath.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+    VerifyOrReturnError(fd >= 0, CHIP_ERROR_POSIX(errno));
+
+    const bool written = WriteAll(fd, FormatPrometheusText(mBackend));
+    CHIP_ERROR err     = written ? CHIP_NO_ERROR : CHIP_ERROR_POSIX(errno);
+    close(fd);
+
+    if (err == CHIP_NO_ERROR && rename(temporaryPath.c_str(), mPath.c_str()) != 0)
+    {
+        err = CHIP_ERROR_POSIX(errno);
+    }
+    if (err != CHIP_NO_ERROR)
+    {
+        unlink(temporaryPath.c_str());
+    }
+    return err;
+}
+
+void PrometheusExporter::FileLoop()
+{
+    std::unique_lock<std::mutex> lock(mMutex);
+    bool stop = false;
+    while (!stop)
+    {
+        // Write once more when stopping, so the file has the final values
+        stop = mCondition.wait_for(lock, mInterval, [this] { return mStop; });
+
+        CHIP_ERROR err = WriteFile();
+        if (err != CHIP_NO_ERROR)
+        {
+            ChipLogError(Support, "Failed to write metrics to %s: %" CHIP_ERROR_FORMAT, mPath.c_str(), err.Format());
+        }
+    }
+}
+
+void PrometheusExporter::SocketLoop()
+{
+    while (true)
+    {
+        pollfd fds[2] = {
+            { mSocketFd, POLLIN, 0 },
+            { mWakeFds[0], POLLIN, 0 },
+        };
+        if (poll(fds, 2, -1) < 0 && errno != EINTR)
+        {
+            ChipLogError(Support, "Failed to wait for metrics clients: %s", strerror(errno));
+            return;
+        }
+
+        {
+            std::lock_guard<std::mutex> lock(mMutex);
+            VerifyOrReturn(!mStop);
+        }
+
+        if (fds[0].revents & POLLIN)
+        {
+            const int client = accept4(mSocketFd, nullptr, nullptr, SOCK_CLOEXEC);
+            if (client >= 0)
+            {
+                WriteAll(client, FormatPrometheusText(mBackend), true /* isSocket */);
+                close(client);
+            }
+        }
+    }
+}
+
+} // namespace Metrics
+} // namespace Tracing
+} // namespace chip
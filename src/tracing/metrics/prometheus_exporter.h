@@ -0,0 +1,92 @@
+/*
+ *
+ *    Copyright (c) 2024 Project CHIP Authors
+ *    All rights reserved.
+ *
+ *    Licensed under the Apache License, Version 2.0 (the "License");
+ *    you may not use this file except in compliance with the License.
+ *    You may obtain a copy of the License at
+ *
+ *        http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *    Unless required by applicable law or agreed to in writing, software
+ *    distributed under the License is distributed on an "AS IS" BASIS,
+ *    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *    See the License for the specific language governing permissions and
+ *    limitations under the License.
+ */
+#pragma once
+
+#include <lib/core/CHIPError.h>
+#include <tracing/metrics/metrics_backend.h>
+
+#include <chrono>
+#include <condition_variable>
+#include <mutex>
+#include <string>
+#include <thread>
+
+namespace chip {
+namespace Tracing {
+namespace Metrics {
+
+/// Formats all metrics of `backend` in the Prometheus text exposition format.
+///
+/// For a key "core_dev_case_session" this generates:
+///    matter_core_dev_case_session_events_total      (counter)
+///    matter_core_dev_case_session_errors_total      (counter)
+///    matter_core_dev_case_session_value             (gauge, if values were logged)
+///    matter_core_dev_case_session_values            (summary, if values were logged)
+///    matter_core_dev_case_session_duration_seconds  (summary, if begin/end pairs were logged)
+///
+/// where summaries report the 0.5, 0.9, 0.99 and 0.999 quantiles.
+std::string FormatPrometheusText(const MetricsBackend & backend);
+
+/// Exports the metrics of a MetricsBackend from a background thread, either
+/// by periodically rewriting a file (e.g. for the node exporter textfile
+/// collector) or by writing them to every client of a UNIX socket.
+///
+/// This class uses threads and POSIX file APIs and is NOT for use on
+/// embedded devices.
+class PrometheusExporter
+{
+public:
+    static constexpr std::chrono::milliseconds kDefaultFileInterval = std::chrono::seconds(10);
+
+    PrometheusExporter(const MetricsBackend & backend) : mBackend(backend) {}
+    ~PrometheusExporter() { Stop(); }
+
+    /// Writes the metrics to `path` every `interval`. The file is replaced
+    /// atomically, so readers never see a partial file.
+    CHIP_ERROR StartFile(const char * path, std::chrono::milliseconds interval = kDefaultFileInterval);
+
+    /// Writes the metrics to every client connecting to the UNIX socket at
+    /// `path` (e.g. `socat - UNIX-CONNECT:<path>`), then closes the connection.
+    CHIP_ERROR StartUnixSocket(const char * path);
+
+    /// Stops exporting. A file is written one last time.
+    void Stop();
+
+private:
+    static constexpr int kInvalidFd = -1;
+
+    CHIP_ERROR WriteFile();
+    void FileLoop();
+    void SocketLoop();
+
+    const MetricsBackend & mBackend;
+    std::string mPath;
+    std::chrono::milliseconds mInterval = kDefaultFileInterval;
+
+    std::thread mThread;
+    std::mutex mMutex;
+    std::condition_variable mCondition;
+    bool mStop = false;
+
+    int mSocketFd   = kInvalidFd;
+    int mWakeFds[2] = { kInvalidFd, kInvalidFd };
+};
+
+} // namespace Metrics
+} // namespace Tracing
+} // namespace chip
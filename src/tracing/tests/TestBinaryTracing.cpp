@@ -0,0 +1,264 @@
+/*
+ *    Copyright (c) 2024 Project CHIP Authors
+ *    All rights reserved.
+ *
+ *    Licensed under the Apache License, Version 2.0 (the "License");
+ *    you may not use this file except in compliance with the License.
+ *    You may obtain a copy of the License at
+ *
+ *        http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *    Unless required by applicable law or agreed to in writing, software
+ *    distributed under the License is distributed on an "AS IS" BASIS,
+ *    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *    See the License for the specific language governing permissions and
+ *    limitations under the License.
+ */
+#include <pw_unit_test/framework.h>
+
+#include <lib/core/StringBuilderAdapters.h>
+#include <lib/support/logging/CHIPLogging.h>
+#include <system/SystemClock.h>
+#include <tracing/binary/binary_tracing.h>
+#include <tracing/binary/chrome_trace_converter.h>
+#include <tracing/macros.h>
+#include <tracing/metric_event.h>
+#include <tracing/registry.h>
+
+#include <stdlib.h>
+#include <unistd.h>
+
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <thread>
+
+using namespace chip;
+using namespace chip::Tracing;
+
+namespace {
+
+/// A temporary file, removed when going out of scope
+class TemporaryFile
+{
+public:
+    TemporaryFile()
+    {
+        int fd = mkstemp(mPath);
+        if (fd >= 0)
+        {
+            close(fd);
+        }
+    }
+    ~TemporaryFile() { unlink(mPath); }
+
+    const char * Path() const { return mPath; }
+
+private:
+    char mPath[32] = "/tmp/binary_trace_XXXXXX";
+};
+
+std::string ConvertToJson(const char * path)
+{
+    std::ifstream input(path, std::ios_base::in | std::ios_base::binary);
+    std::stringstream output;
+    EXPECT_EQ(Binary::ConvertToChromeTrace(input, output), CHIP_NO_ERROR);
+    return output.str();
+}
+
+size_t CountOccurrences(const std::string & text, const std::string & pattern)
+{
+    size_t count = 0;
+    for (size_t pos = text.find(pattern); pos != std::string::npos; pos = text.find(pattern, pos + pattern.size()))
+    {
+        count++;
+    }
+    return count;
+}
+
+TEST(TestBinaryTracing, TestScopesAndInstants)
+{
+    TemporaryFile file;
+    Binary::BinaryBackend backend;
+
+    ASSERT_EQ(backend.OpenFile(file.Path()), CHIP_NO_ERROR);
+    {
+        ScopedRegistration scope(backend);
+
+        MATTER_TRACE_SCOPE("A", "Group");
+        {
+            MATTER_TRACE_SCOPE("B", "Group");
+            MATTER_TRACE_INSTANT("FOO", "Other");
+        }
+        MATTER_TRACE_COUNTER("Counter");
+        MATTER_TRACE_COUNTER("Counter");
+    }
+    backend.CloseFile();
+
+    std::string json = ConvertToJson(file.Path());
+    EXPECT_EQ(json.find("{\"traceEvents\":["), 0u);
+    EXPECT_EQ(CountOccurrences(json, "{\"name\":\"A\",\"cat\":\"Group\",\"ph\":\"B\""), 1u);
+    EXPECT_EQ(CountOccurrences(json, "{\"name\":\"A\",\"cat\":\"Group\",\"ph\":\"E\""), 1u);
+    EXPECT_EQ(CountOccurrences(json, "{\"name\":\"B\",\"cat\":\"Group\",\"ph\":\"B\""), 1u);
+    EXPECT_EQ(CountOccurrences(json, "{\"name\":\"B\",\"cat\":\"Group\",\"ph\":\"E\""), 1u);
+    EXPECT_EQ(CountOccurrences(json, "{\"name\":\"FOO\",\"cat\":\"Other\",\"ph\":\"i\""), 1u);
+    EXPECT_EQ(CountOccurrences(json, "\"args\":{\"count\":1}"), 1u);
+    EXPECT_EQ(CountOccurrences(json, "\"args\":{\"count\":2}"), 1u);
+    EXPECT_EQ(backend.DroppedEventCount(), 0u);
+
+    // Nesting is preserved within a thread
+    EXPECT_LT(json.find("\"name\":\"B\",\"cat\":\"Group\",\"ph\":\"E\""), json.find("\"name\":\"A\",\"cat\":\"Group\",\"ph\":\"E\""));
+}
+
+TEST(TestBinaryTracing, TestMetrics)
+{
+    TemporaryFile file;
+    Binary::BinaryBackend backend;
+
+    ASSERT_EQ(backend.OpenFile(file.Path()), CHIP_NO_ERROR);
+    backend.LogMetricEvent(MetricEvent(MetricEvent::Type::kBeginEvent, "metric"));
+    backend.LogMetricEvent(MetricEvent(MetricEvent::Type::kEndEvent, "metric", CHIP_ERROR_INTERNAL));
+    backend.LogMetricEvent(MetricEvent(MetricEvent::Type::kInstantEvent, "signed", static_cast<int32_t>(-5)));
+    backend.LogMetricEvent(MetricEvent(MetricEvent::Type::kInstantEvent, "unsigned", static_cast<uint32_t>(123)));
+    backend.CloseFile();
+
+    std::string json = ConvertToJson(file.Path());
+    EXPECT_EQ(CountOccurrences(json, "{\"name\":\"metric\",\"cat\":\"Metric\",\"ph\":\"b\""), 1u);
+    EXPECT_EQ(CountOccurrences(json, "{\"name\":\"metric\",\"cat\":\"Metric\",\"ph\":\"e\""), 1u);
+    EXPECT_EQ(CountOccurrences(json, "\"args\":{\"error\":\"0x000000AC\"}"), 1u);
+    EXPECT_EQ(CountOccurrences(json, "\"args\":{\"value\":-5}"), 1u);
+    EXPECT_EQ(CountOccurrences(json, "\"args\":{\"value\":123}"), 1u);
+}
+
+TEST(TestBinaryTracing, TestMultipleThreads)
+{
+    constexpr int kEventsPerThread = 1000;
+
+    TemporaryFile file;
+    Binary::BinaryBackend backend;
+
+    ASSERT_EQ(backend.OpenFile(file.Path()), CHIP_NO_ERROR);
+
+    auto traceEvents = [&backend]() {
+        for (int i = 0; i < kEventsPerThread; i++)
+        {
+            backend.TraceBegin("Work", "Thread");
+            backend.TraceEnd("Work", "Thread");
+        }
+    };
+    std::thread first(traceEvents);
+    std::thread second(traceEvents);
+    first.join();
+    second.join();
+
+    backend.CloseFile();
+
+    std::string json = ConvertToJson(file.Path());
+    EXPECT_EQ(backend.DroppedEventCount(), 0u);
+    EXPECT_EQ(CountOccurrences(json, "\"ph\":\"B\""), 2u * kEventsPerThread);
+    EXPECT_EQ(CountOccurrences(json, "\"ph\":\"E\""), 2u * kEventsPerThread);
+    EXPECT_EQ(CountOccurrences(json, "\"tid\":0}"), 2u * kEventsPerThread);
+    EXPECT_EQ(CountOccurrences(json, "\"tid\":1}"), 2u * kEventsPerThread);
+}
+
+TEST(TestBinaryTracing, TestDroppedEvents)
+{
+    TemporaryFile file;
+
+    // Small buffer that is not flushed while tracing
+    Binary::BinaryBackend backend(4, std::chrono::hours(1));
+
+    ASSERT_EQ(backend.OpenFile(file.Path()), CHIP_NO_ERROR);
+    for (int i = 0; i < 10; i++)
+    {
+        backend.TraceInstant("Event", "Group");
+    }
+    backend.CloseFile();
+
+    EXPECT_EQ(backend.DroppedEventCount(), 6u);
+
+    std::string json = ConvertToJson(file.Path());
+    EXPECT_EQ(CountOccurrences(json, "\"name\":\"Event\""), 4u);
+    EXPECT_EQ(CountOccurrences(json, "{\"name\":\"Dropped events\",\"cat\":\"Tracing\""), 1u);
+    EXPECT_EQ(CountOccurrences(json, "\"args\":{\"count\":6}"), 1u);
+}
+
+TEST(TestBinaryTracing, TestNoOutputWhenClosed)
+{
+    TemporaryFile file;
+    Binary::BinaryBackend backend;
+
+    backend.TraceInstant("Before", "Group");
+    ASSERT_EQ(backend.OpenFile(file.Path()), CHIP_NO_ERROR);
+    backend.TraceInstant("During", "Group");
+    backend.CloseFile();
+    backend.TraceInstant("After", "Group");
+
+    std::string json = ConvertToJson(file.Path());
+    EXPECT_EQ(CountOccurrences(json, "\"name\":\"Before\""), 0u);
+    EXPECT_EQ(CountOccurrences(json, "\"name\":\"During\""), 1u);
+    EXPECT_EQ(CountOccurrences(json, "\"name\":\"After\""), 0u);
+}
+
+TEST(TestBinaryTracing, TestConverterErrors)
+{
+    std::stringstream output;
+
+    std::stringstream empty;
+    EXPECT_EQ(Binary::ConvertToChromeTrace(empty, output), CHIP_ERROR_INVALID_FILE_IDENTIFIER);
+
+    std::stringstream notATrace("[{\"event\": \"TraceBegin\"}]");
+    EXPECT_EQ(Binary::ConvertToChromeTrace(notATrace, output), CHIP_ERROR_INVALID_FILE_IDENTIFIER);
+
+    std::string newerVersion("MTRTRACE\x02\x00\x20\x00\x00\x00\x00\x00", Binary::kFileHeaderSize);
+    std::stringstream newer(newerVersion);
+    EXPECT_EQ(Binary::ConvertToChromeTrace(newer, output), CHIP_ERROR_VERSION_MISMATCH);
+}
+
+// Cost of one MATTER_TRACE_SCOPE (a begin and an end event) in each state of the backend. Timings depend on the host,
+// so they are only logged.
+TEST(TestBinaryTracing, TestScopeCost)
+{
+    constexpr uint32_t kScopes = 50000;
+
+    auto nanosecondsPerScope = []() {
+        const auto startTime = System::SystemClock().GetMonotonicMicroseconds64();
+        for (uint32_t i = 0; i < kScopes; i++)
+        {
+            MATTER_TRACE_SCOPE("Scope", "Benchmark");
+        }
+        const auto elapsed = System::SystemClock().GetMonotonicMicroseconds64() - startTime;
+        return static_cast<unsigned>(elapsed.count() * 1000 / kScopes);
+    };
+
+    const unsigned unregistered = nanosecondsPerScope();
+
+    unsigned notRecording;
+    {
+        Binary::BinaryBackend backend;
+        ScopedRegistration scope(backend);
+        notRecording = nanosecondsPerScope();
+    }
+
+    unsigned recording;
+    {
+        TemporaryFile file;
+
+        // Large enough for every event, so that the flusher does not need to keep up
+        Binary::BinaryBackend backend(2 * kScopes);
+
+        ASSERT_EQ(backend.OpenFile(file.Path()), CHIP_NO_ERROR);
+        {
+            ScopedRegistration scope(backend);
+            recording = nanosecondsPerScope();
+        }
+        backend.CloseFile();
+
+        EXPECT_EQ(backend.DroppedEventCount(), 0u);
+    }
+
+    ChipLogProgress(Test, "MATTER_TRACE_SCOPE: %u ns without backend, %u ns with the backend not recording, %u ns recording",
+                    unregistered, notRecording, recording);
+}
+
+} // namespace
@@ -0,0 +1,369 @@
+/*
+ *    Copyright (c) 2024 Project CHIP Authors
+ *    All rights reserved.
+ *
+ *    Licensed under the Apache License, Version 2.0 (the "License");
+ *    you may not use this file except in compliance with the License.
+ *    You may obtain a copy of the License at
+ *
+ *        http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *    Unless required by applicable law or agreed to in writing, software
+ *    distributed under the License is distributed on an "AS IS" BASIS,
+ *    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *    See the License for the specific language governing permissions and
+ *    limitations under the License.
+ */
+#include <pw_unit_test/framework.h>
+
+#include <lib/core/StringBuilderAdapters.h>
+#include <tracing/metric_event.h>
+#include <tracing/metric_macros.h>
+#include <tracing/metrics/histogram.h>
+#include <tracing/metrics/metrics_backend.h>
+#include <tracing/metrics/prometheus_exporter.h>
+#include <tracing/registry.h>
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace chip;
+using namespace chip::Tracing;
+using namespace chip::Tracing::Metrics;
+
+namespace {
+
+constexpr MetricKey kTestKey      = "test_metric";
+constexpr MetricKey kOtherTestKey = "test.other-metric";
+
+std::string ReadSocket(const char * path)
+{
+    std::string result;
+
+    const int fd = socket(AF_UNIX, SOCK_STREAM, 0);
+    EXPECT_GE(fd, 0);
+    if (fd < 0)
+    {
+        return result;
+    }
+
+    sockaddr_un address = {};
+    address.sun_family  = AF_UNIX;
+    strncpy(address.sun_path, path, sizeof(address.sun_path) - 1);
+    EXPECT_EQ(connect(fd, reinterpret_cast<const sockaddr *>(&address), sizeof(address)), 0);
+
+    char buffer[512];
+    ssize_t read_bytes;
+    while ((read_bytes = read(fd, buffer, sizeof(buffer))) > 0)
+    {
+        result.append(buffer, static_cast<size_t>(read_bytes));
+    }
+    close(fd);
+    return result;
+}
+
+TEST(TestMetricsBackend, TestHistogramBuckets)
+{
+    // Small values are exact
+    for (uint32_t value = 0; value < Histogram::kSubBucketCount; value++)
+    {
+        EXPECT_EQ(Histogram::BucketIndex(value), value);
+        EXPECT_EQ(Histogram::BucketUpperBound(value), value);
+    }
+
+    // Every value falls within its bucket, and buckets are ordered
+    const uint32_t values[] = { 16, 17, 31, 32, 33, 100, 1000, 12345, 1u << 20, (1u << 31) - 1, 1u << 31, UINT32_MAX };
+    for (uint32_t value : values)
+    {
+        const size_t index = Histogram::BucketIndex(value);
+        ASSERT_LT(index, Histogram::kBucketCount);
+        EXPECT_GE(Histogram::BucketUpperBound(index), value);
+        EXPECT_LT(Histogram::BucketUpperBound(index - 1), value);
+
+        // Bucket width is bounded relative to the value
+        EXPECT_LE(Histogram::BucketUpperBound(index) - value, value / Histogram::kSubBucketCount);
+    }
+    EXPECT_EQ(Histogram::BucketIndex(UINT32_MAX), Histogram::kBucketCount - 1);
+    EXPECT_EQ(Histogram::BucketUpperBound(Histogram::kBucketCount - 1), UINT32_MAX);
+}
+
+TEST(TestMetricsBackend, TestHistogramPercentiles)
+{
+    Histogram histogram;
+    HistogramSnapshot snapshot;
+
+    histogram.Snapshot(snapshot);
+    EXPECT_EQ(snapshot.count, 0u);
+    EXPECT_EQ(snapshot.p99, 0u);
+
+    for (uint32_t value = 1; value <= 1000; value++)
+    {
+        histogram.Record(value);
+    }
+    histogram.Snapshot(snapshot);
+
+    EXPECT_EQ(snapshot.count, 1000u);
+    EXPECT_EQ(snapshot.sum, 500500u);
+    EXPECT_EQ(snapshot.min, 1u);
+    EXPECT_EQ(snapshot.max, 1000u);
+
+    // Within the bucket precision of the exact percentiles
+    EXPECT_GE(snapshot.p50, 500u);
+    EXPECT_LE(snapshot.p50, 500u + 500u / Histogram::kSubBucketCount);
+    EXPECT_GE(snapshot.p90, 900u);
+    EXPECT_LE(snapshot.p90, 900u + 900u / Histogram::kSubBucketCount);
+    EXPECT_GE(snapshot.p99, 990u);
+    EXPECT_LE(snapshot.p99, 1000u);
+    EXPECT_EQ(snapshot.p999, 1000u);
+
+    // A single outlier shows up in p999 only
+    Histogram outlier;
+    for (int i = 0; i < 999; i++)
+    {
+        outlier.Record(10);
+    }
+    outlier.Record(1000000);
+    outlier.Snapshot(snapshot);
+    EXPECT_EQ(snapshot.p50, 10u);
+    EXPECT_EQ(snapshot.p99, 10u);
+    EXPECT_EQ(snapshot.p999, 10u);
+    EXPECT_EQ(snapshot.max, 1000000u);
+}
+
+TEST(TestMetricsBackend, TestCountersAndValues)
+{
+    MetricsBackend backend;
+    MetricSnapshot snapshot;
+
+    EXPECT_EQ(backend.GetSnapshot(kTestKey, snapshot), CHIP_ERROR_NOT_FOUND);
+    EXPECT_EQ(backend.GetSnapshot(size_t(0), snapshot), CHIP_ERROR_NOT_FOUND);
+
+    backend.LogMetricEvent(MetricEvent(MetricEvent::Type::kInstantEvent, kTestKey));
+    backend.TraceCounter(kTestKey);
+    backend.LogMetricEvent(MetricEvent(MetricEvent::Type::kInstantEvent, kTestKey, int32_t(-5)));
+    backend.LogMetricEvent(MetricEvent(MetricEvent::Type::kInstantEvent, kTestKey, uint32_t(20)));
+    backend.LogMetricEvent(MetricEvent(MetricEvent::Type::kInstantEvent, kTestKey, uint32_t(10)));
+    backend.LogMetricEvent(MetricEvent(MetricEvent::Type::kInstantEvent, kTestKey, CHIP_NO_ERROR));
+    backend.LogMetricEvent(MetricEvent(MetricEvent::Type::kInstantEvent, kTestKey, CHIP_ERROR_TIMEOUT));
+
+    EXPECT_EQ(backend.MetricCount(), 1u);
+    ASSERT_EQ(backend.GetSnapshot(kTestKey, snapshot), CHIP_NO_ERROR);
+    EXPECT_STREQ(snapshot.key, kTestKey);
+    EXPECT_EQ(snapshot.events, 7u);
+    EXPECT_EQ(snapshot.errors, 1u);
+    EXPECT_TRUE(snapshot.hasValue);
+    EXPECT_EQ(snapshot.value, 10);
+    EXPECT_EQ(snapshot.values.count, 3u);
+    EXPECT_EQ(snapshot.values.min, 0u);
+    EXPECT_EQ(snapshot.values.max, 20u);
+    EXPECT_EQ(snapshot.durationsUs.count, 0u);
+    EXPECT_EQ(backend.OverflowCount(), 0u);
+}
+
+TEST(TestMetricsBackend, TestDurations)
+{
+    MetricsBackend backend;
+    MetricSnapshot snapshot;
+
+    // An end event without a begin event is only counted
+    backend.LogMetricEvent(MetricEvent(MetricEvent::Type::kEndEvent, kTestKey));
+
+    backend.LogMetricEvent(MetricEvent(MetricEvent::Type::kBeginEvent, kTestKey));
+    std::this_thread::sleep_for(std::chrono::milliseconds(2));
+    backend.LogMetricEvent(MetricEvent(MetricEvent::Type::kEndEvent, kTestKey, CHIP_ERROR_INTERNAL));
+
+    ASSERT_EQ(backend.GetSnapshot(kTestKey, snapshot), CHIP_NO_ERROR);
+    EXPECT_EQ(snapshot.events, 2u);
+    EXPECT_EQ(snapshot.errors, 1u);
+    EXPECT_FALSE(snapshot.hasValue);
+    EXPECT_EQ(snapshot.durationsUs.count, 1u);
+    EXPECT_GE(snapshot.durationsUs.min, 2000u);
+}
+
+TEST(TestMetricsBackend, TestKeyAliases)
+{
+    MetricsBackend backend;
+    MetricSnapshot snapshot;
+
+    // The same key string at another address is the same metric
+    char alias[32];
+    strncpy(alias, kTestKey, sizeof(alias));
+
+    backend.TraceCounter(kTestKey);
+    backend.TraceCounter(alias);
+    backend.TraceCounter(alias);
+    backend.TraceCounter(kOtherTestKey);
+
+    EXPECT_EQ(backend.MetricCount(), 2u);
+    ASSERT_EQ(backend.GetSnapshot(kTestKey, snapshot), CHIP_NO_ERROR);
+    EXPECT_EQ(snapshot.events, 3u);
+    ASSERT_EQ(backend.GetSnapshot(kOtherTestKey, snapshot), CHIP_NO_ERROR);
+    EXPECT_EQ(snapshot.events, 1u);
+}
+
+TEST(TestMetricsBackend, TestOverflow)
+{
+    MetricsBackend backend;
+
+    std::vector<std::string> keys;
+    for (size_t i = 0; i < MetricsBackend::kMaxMetrics + 2; i++)
+    {
+        keys.push_back("key_" + std::to_string(i));
+    }
+    for (const std::string & key : keys)
+    {
+        backend.TraceCounter(key.c_str());
+    }
+
+    EXPECT_EQ(backend.MetricCount(), MetricsBackend::kMaxMetrics);
+    EXPECT_EQ(backend.OverflowCount(), 2u);
+
+    // Every later event of an untracked key is counted as overflow, and the key is never tracked
+    MetricSnapshot snapshot;
+    const std::string & untrackedKey = keys[MetricsBackend::kMaxMetrics];
+    for (int i = 0; i < 3; i++)
+    {
+        backend.TraceCounter(untrackedKey.c_str());
+        backend.LogMetricEvent(MetricEvent(MetricEvent::Type::kInstantEvent, untrackedKey.c_str(), static_cast<uint32_t>(i)));
+    }
+    EXPECT_EQ(backend.OverflowCount(), 8u);
+    EXPECT_EQ(backend.MetricCount(), MetricsBackend::kMaxMetrics);
+    EXPECT_EQ(backend.GetSnapshot(untrackedKey.c_str(), snapshot), CHIP_ERROR_NOT_FOUND);
+
+    // Known keys are still recorded, also when seen at another address
+    backend.TraceCounter(keys[0].c_str());
+    const std::string alias = keys[0];
+    backend.TraceCounter(alias.c_str());
+    backend.TraceCounter(alias.c_str());
+    ASSERT_EQ(backend.GetSnapshot(keys[0].c_str(), snapshot), CHIP_NO_ERROR);
+    EXPECT_EQ(snapshot.events, 4u);
+    EXPECT_EQ(backend.OverflowCount(), 8u);
+}
+
+TEST(TestMetricsBackend, TestConcurrentRecording)
+{
+    constexpr int kThreads = 4;
+    constexpr int kEvents  = 10000;
+
+    MetricsBackend backend;
+
+    std::vector<std::thread> threads;
+    for (int i = 0; i < kThreads; i++)
+    {
+        threads.emplace_back([&backend]() {
+            for (int j = 0; j < kEvents; j++)
+            {
+                backend.LogMetricEvent(MetricEvent(MetricEvent::Type::kInstantEvent, kTestKey, uint32_t(j)));
+                backend.TraceCounter(kOtherTestKey);
+            }
+        });
+    }
+    for (std::thread & thread : threads)
+    {
+        thread.join();
+    }
+
+    MetricSnapshot snapshot;
+    ASSERT_EQ(backend.GetSnapshot(kTestKey, snapshot), CHIP_NO_ERROR);
+    EXPECT_EQ(snapshot.events, uint64_t(kThreads * kEvents));
+    EXPECT_EQ(snapshot.values.count, uint64_t(kThreads * kEvents));
+    ASSERT_EQ(backend.GetSnapshot(kOtherTestKey, snapshot), CHIP_NO_ERROR);
+    EXPECT_EQ(snapshot.events, uint64_t(kThreads * kEvents));
+}
+
+TEST(TestMetricsBackend, TestRegisteredBackend)
+{
+    MetricsBackend backend;
+    {
+        ScopedRegistration scope(backend);
+        MATTER_LOG_METRIC(kTestKey, uint32_t(42));
+    }
+
+    MetricSnapshot snapshot;
+    ASSERT_EQ(backend.GetSnapshot(kTestKey, snapshot), CHIP_NO_ERROR);
+    EXPECT_EQ(snapshot.events, 1u);
+    EXPECT_EQ(snapshot.value, 42);
+}
+
+TEST(TestMetricsBackend, TestPrometheusText)
+{
+    MetricsBackend backend;
+    backend.LogMetricEvent(MetricEvent(MetricEvent::Type::kInstantEvent, kOtherTestKey, uint32_t(7)));
+    backend.LogMetricEvent(MetricEvent(MetricEvent::Type::kBeginEvent, kTestKey));
+    backend.LogMetricEvent(MetricEvent(MetricEvent::Type::kEndEvent, kTestKey, CHIP_ERROR_TIMEOUT));
+
+    const std::string text = FormatPrometheusText(backend);
+
+    // Names are sanitized
+    EXPECT_NE(text.find("# TYPE matter_test_other_metric_events_total counter\n"), std::string::npos);
+    EXPECT_NE(text.find("matter_test_other_metric_events_total 1\n"), std::string::npos);
+    EXPECT_NE(text.find("matter_test_other_metric_value 7\n"), std::string::npos);
+    EXPECT_NE(text.find("matter_test_other_metric_values{quantile=\"0.99\"} 7\n"), std::string::npos);
+    EXPECT_NE(text.find("matter_test_other_metric_values_count 1\n"), std::string::npos);
+    EXPECT_EQ(text.find("matter_test_other_metric_duration_seconds"), std::string::npos);
+
+    EXPECT_NE(text.find("matter_test_metric_events_total 1\n"), std::string::npos);
+    EXPECT_NE(text.find("matter_test_metric_errors_total 1\n"), std::string::npos);
+    EXPECT_NE(text.find("# TYPE matter_test_metric_duration_seconds summary\n"), std::string::npos);
+    EXPECT_NE(text.find("matter_test_metric_duration_seconds_count 1\n"), std::string::npos);
+    EXPECT_EQ(text.find("matter_test_metric_value "), std::string::npos);
+}
+
+TEST(TestMetricsBackend, TestExportToFile)
+{
+    char path[32] = "/tmp/metrics_XXXXXX";
+    const int fd  = mkstemp(path);
+    ASSERT_GE(fd, 0);
+    close(fd);
+
+    MetricsBackend backend;
+    backend.TraceCounter(kTestKey);
+
+    PrometheusExporter exporter(backend);
+    ASSERT_EQ(exporter.StartFile(path, std::chrono::milliseconds(10)), CHIP_NO_ERROR);
+
+    backend.TraceCounter(kTestKey);
+    exporter.Stop();
+
+    std::ifstream input(path);
+    std::stringstream contents;
+    contents << input.rdbuf();
+    EXPECT_EQ(contents.str(), FormatPrometheusText(backend));
+    EXPECT_NE(contents.str().find("matter_test_metric_events_total 2\n"), std::string::npos);
+
+    unlink(path);
+}
+
+TEST(TestMetricsBackend, TestExportToUnixSocket)
+{
+    char directory[32] = "/tmp/metrics_XXXXXX";
+    ASSERT_NE(mkdtemp(directory), nullptr);
+    const std::string path = std::string(directory) + "/metrics.sock";
+
+    MetricsBackend backend;
+    PrometheusExporter exporter(backend);
+    ASSERT_EQ(exporter.StartUnixSocket(path.c_str()), CHIP_NO_ERROR);
+
+    backend.TraceCounter(kTestKey);
+    EXPECT_NE(ReadSocket(path.c_str()).find("matter_test_metric_events_total 1\n"), std::string::npos);
+
+    backend.TraceCounter(kTestKey);
+    EXPECT_NE(ReadSocket(path.c_str()).find("matter_test_metric_events_total 2\n"), std::string::npos);
+
+    // The socket is removed when stopping
+    exporter.Stop();
+    EXPECT_NE(access(path.c_str(), F_OK), 0);
+    rmdir(directory);
+}
+
+} // namespace